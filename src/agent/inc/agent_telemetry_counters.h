@@ -28,6 +28,8 @@ typedef struct _MessagesCounter {
     uint32_t sentMessages;
     uint32_t smallMessages;
     uint32_t failedMessages;
+    uint32_t sentBytes;
+    uint32_t billedBytes;
 
 } MessageCounter;
 
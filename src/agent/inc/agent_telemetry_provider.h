@@ -8,6 +8,7 @@
 #include "macro_utils.h"
 
 #include "agent_telemetry_counters.h"
+#include "twin_configuration_defs.h"
 
 /**
  * All the result types of the agent telemetry provider functions
@@ -25,6 +26,19 @@ typedef enum _AgentQueueMeter {
     LOW_PRIORITY
 } AgentQueueMeter;
 
+/**
+ * The number of event types whose evictions are counted
+ */
+#define AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT 9
+
+/**
+ * The number of events of a single type which were evicted to make room for high priority events
+ */
+typedef struct _EvictedEventsCounter {
+    const char* eventType;
+    uint32_t evicted;
+} EvictedEventsCounter;
+
 /**
  * @brief initialize the agent telemetry provider.
  * 
@@ -60,5 +74,20 @@ MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetQueu
  */
 MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetMessageCounterData, MessageCounter*, counterData);
 
+/**
+ * @brief counts an event which was evicted from its queue, events of other types are ignored.
+ * 
+ * @param   eventType   the type of the evicted event.
+ */
+MOCKABLE_FUNCTION(, void, AgentTelemetryProvider_CountEvictedEvent, TwinConfigurationEventType, eventType);
+
+/**
+ * @brief returns the number of evicted events of every event type and resets the counters.
+ * 
+ * @param   counterData         Out param, an array of AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT counters
+ * 
+ * @return TELEMETRY_PROVIDER_OK on success, TELEMETRY_PROVIDER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AgentTelemetryProviderResult, AgentTelemetryProvider_GetEvictedEventsCounterData, EvictedEventsCounter*, counterData);
 
 #endif // AGENT_TELEMETRY_PROVIDER_H
\ No newline at end of file
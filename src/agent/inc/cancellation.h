@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CANCELLATION_H
+#define CANCELLATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The cancellation state of a single unit of work, e.g. a single run of a collector.
+ * The work is cancelled once its deadline passes or once it is cancelled explicitly from another thread.
+ */
+typedef struct _CancellationToken {
+
+    uint64_t deadline;
+    bool cancelled;
+
+} CancellationToken;
+
+/**
+ * @brief Initiates the token.
+ *
+ * @param   token       The token to initiate.
+ * @param   deadline    The monotonic time in milliseconds after which the work is cancelled, 0 for no deadline.
+ */
+void CancellationToken_Init(CancellationToken* token, uint64_t deadline);
+
+/**
+ * @brief Cancels the work of the token, safe to call from any thread.
+ *
+ * @param   token   The token to cancel.
+ */
+void CancellationToken_Cancel(CancellationToken* token);
+
+/**
+ * @brief Sets the token of the work the calling thread runs, so cancellation points deep in the work
+ *        can check it without passing it through every call.
+ *
+ * @param   token   The token, NULL once the work is done.
+ */
+void Cancellation_SetCurrentToken(CancellationToken* token);
+
+/**
+ * @brief A cancellation point, checks whether the work of the calling thread should stop.
+ *
+ * @return true if the current token was cancelled or its deadline passed, false otherwise or if there is no current token.
+ */
+MOCKABLE_FUNCTION(, bool, Cancellation_IsRequested);
+
+/**
+ * @brief Returns the time left until the deadline of the work of the calling thread.
+ *
+ * @return the time in milliseconds, 0 if the work was cancelled or UINT32_MAX if there is no deadline.
+ */
+MOCKABLE_FUNCTION(, uint32_t, Cancellation_GetRemainingTime);
+
+#endif //CANCELLATION_H
@@ -19,4 +19,15 @@
  */
 MOCKABLE_FUNCTION(, EventCollectorResult, AgentTelemetryCollector_GetEvents, SyncQueue*, queue);
 
+/**
+ * @brief reports a collector run which exceeded its time budget and was cancelled
+ * 
+ * @param   queue           The queue to insert the mesage to.
+ * @param   collectorName   The name of the collector.
+ * @param   timeBudget      The time budget of the run in milliseconds.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, AgentTelemetryCollector_AddTimeBudgetExceededEvent, SyncQueue*, queue, const char*, collectorName, uint32_t, timeBudget);
+
 #endif //AGENT_TELEMETRY_COLLECTOR_H
\ No newline at end of file
@@ -29,6 +29,8 @@ typedef struct _EventAggregatorConfiguration {
     const char* event_type;
     const char* event_name;
     const char* payload_schema_version;
+    // the payload field holding a port which the aggregation key may mask, NULL if the payload has none
+    const char* port_key;
 } EventAggregatorConfiguration;
 
 
@@ -51,10 +53,13 @@ MOCKABLE_FUNCTION(, void, EventAggregator_Deinit, EventAggregatorHandle, aggrega
 
 /**
  * @brief Aggregates an event payload
- *          Aggregation is based on payload equality
+ *          Aggregation is based on payload equality, after the aggregation key configured for the event type
+ *          is applied to the payload: fields out of the key are reset and the key fields are normalized
+ *          Once the configured number of distinct payloads is reached, the payload with the fewest hits
+ *          is evicted to make room and its hits are reported in a single event for all the evicted payloads
  * 
  * @param   aggregator          Handle to the aggregator
- * @param   eventPayload        The payload to aggregate
+ * @param   eventPayload        The payload to aggregate, changed in place by the aggregation key
  * 
  * @return EVENT_AGGREGATOR_OK on success, EVENT_AGGREGATOR_DISABLED if aggregation is disabled for
  * this aggregator iotEventType and EVENT_AGGREGATOR_EXCPETION otherwise.
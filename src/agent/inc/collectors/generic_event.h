@@ -12,7 +12,9 @@
 
 #include "json/json_object_writer.h"
 #include "json/json_array_writer.h"
+#include "json/json_stream_writer.h"
 
+#define GENERIC_EVENT_INITIAL_BUFFER_SIZE 1024
 
 typedef enum _EventCollectorResult {
     EVENT_COLLECTOR_OK,
@@ -59,4 +61,37 @@ MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_AddMetadataWithTimes, Jso
  */
 MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_AddPayload, JsonObjectWriterHandle, eventWriter, JsonArrayWriterHandle, payloadWriter);
 
+/**
+ * @brief writes generic metadata to a streamed event.
+ * 
+ * @param   eventWriter             The stream writer of the event, the event object must be open.
+ * @param   eventCategory           The category of the event.
+ * @param   eventName               The name of the event.
+ * @param   eventType               The type of the event.
+ * @param   eventPayloadVersion     The message schema version of the payload.
+ * @param   eventLocalTime          The time of the event.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_WriteMetadataWithTimes, JsonStreamWriter*, eventWriter, const char*, eventCategory, const char*, eventName, const char*, eventType, const char*, eventPayloadVersion, time_t*, eventLocalTime);
+
+/**
+ * @brief opens the payload array of a streamed event, the payloads are written to the array by the caller.
+ * 
+ * @param   eventWriter             The stream writer of the event, the event object must be open.
+ * @param   isEmpty                 Whether the payload array is going to be empty.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_BeginPayload, JsonStreamWriter*, eventWriter, bool, isEmpty);
+
+/**
+ * @brief closes the payload array of a streamed event.
+ * 
+ * @param   eventWriter             The stream writer of the event.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericEvent_EndPayload, JsonStreamWriter*, eventWriter);
+
 #endif //GENERIC_EVENT_H
\ No newline at end of file
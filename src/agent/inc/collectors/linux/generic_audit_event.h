@@ -10,13 +10,46 @@
 #include "umock_c_prod.h"
 
 #include "collectors/generic_event.h"
-#include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
+#include "os_utils/linux/audit/audit_control.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
 #include "os_utils/linux/audit/audit_search.h"
+#include "synchronized_queue.h"
+
+/**
+ * @brief typedef of a collector function which handles a single audit event of the audit dispatcher.
+ * 
+ * @param   auditSearch     The search positioned on the event.
+ * @param   queue           The queue to insert the mesages to.
+ * 
+ * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
+ */
+typedef EventCollectorResult (*AuditEventCollectorFunc)(AuditSearch* auditSearch, SyncQueue* queue);
+
+/**
+ * @brief typedef of a collector function which registers the handler of its events on the audit dispatcher.
+ * 
+ * @param   dispatcher  The audit dispatcher.
+ * @param   handler     The handler of the events.
+ * @param   context     The context of the handler.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+typedef EventCollectorResult (*AuditHandlerRegistrationFunc)(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context);
+
+/**
+ * @brief typedef of a collector function which replaces the audit exclusions of its syscalls.
+ * 
+ * @param   exclusions  The exclusions.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+typedef EventCollectorResult (*AuditExclusionsFunc)(const AuditControlExclusions* exclusions);
 
 /**
  * @brief Reads the string field from the audit search and writes it to the json writer.
  * 
- * @param   eventWriter             A handle to the writer of the event object.
+ * @param   eventWriter             The stream writer of the event payload.
  * @param   auditSearch             The audit search instance.
  * @param   auditField              The name of the field to read from the audo search.
  * @param   jsonKey                 The value of the json key to write to the writer.
@@ -24,12 +57,12 @@
  * 
  * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
  */
-MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleStringValue, JsonObjectWriterHandle, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleStringValue, JsonStreamWriter*, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
 
 /**
  * @brief Reads the interpret string field from the audit search and writes it to the json writer.
  * 
- * @param   eventWriter             A handle to the writer of the event object.
+ * @param   eventWriter             The stream writer of the event payload.
  * @param   auditSearch             The audit search instance.
  * @param   auditField              The name of the field to read from the audo search.
  * @param   jsonKey                 The value of the json key to write to the writer.
@@ -37,13 +70,13 @@ MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleStringValue, J
  * 
  * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
  */
-MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleInterpretStringValue, JsonObjectWriterHandle, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleInterpretStringValue, JsonStreamWriter*, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
 
 
 /**
  * @brief Reads the interger field from the audit search and writes it to the json writer.
  * 
- * @param   eventWriter             A handle to the writer of the event object.
+ * @param   eventWriter             The stream writer of the event payload.
  * @param   auditSearch             The audit search instance.
  * @param   auditField              The name of the field to read from the audo search.
  * @param   jsonKey                 The value of the json key to write to the writer.
@@ -51,6 +84,6 @@ MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleInterpretStrin
  * 
  * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
  */
-MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleIntValue, JsonObjectWriterHandle, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
+MOCKABLE_FUNCTION(, EventCollectorResult, GenericAuditEvent_HandleIntValue, JsonStreamWriter*, eventWriter, AuditSearch*, auditSearch, const char*, auditField, const char*, jsonKey, bool, isOptional);
 
 #endif //GENERIC_AUDIT_EVENT_H
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "umock_c_prod.h"
 
 #include "collectors/generic_event.h"
+#include "os_utils/linux/audit/audit_control.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
 #include "synchronized_queue.h"
 
 /**
@@ -32,4 +34,44 @@ MOCKABLE_FUNCTION(, EventCollectorResult, ProcessCreationCollector_Init);
  */
 MOCKABLE_FUNCTION(, void, ProcessCreationCollector_Deinit);
 
+/**
+ * @brief registers the handler of the process creation events on the audit dispatcher.
+ * 
+ * @param   dispatcher  The audit dispatcher.
+ * @param   handler     The handler of the events, which hands them to ProcessCreationCollector_HandleAuditEvent.
+ * @param   context     The context of the handler.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, ProcessCreationCollector_AddAuditHandler, AuditDispatcher*, dispatcher, AuditDispatcherEventHandler, handler, void*, context);
+
+/**
+ * @brief create a message for a single process creation event of the audit dispatcher and insert it into the queue.
+ * 
+ * @param   auditSearch     The search positioned on the event.
+ * @param   queue           The queue to insert the mesages to.
+ * 
+ * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, ProcessCreationCollector_HandleAuditEvent, AuditSearch*, auditSearch, SyncQueue*, queue);
+
+/**
+ * @brief insert the process creation events which were aggregated since the last time this function was called into the queue.
+ * Replaces ProcessCreationCollector_GetEvents while the audit events are dispatched.
+ * 
+ * @param   queue  The queue to insert the mesages to.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, ProcessCreationCollector_GetAggregatedEvents, SyncQueue*, queue);
+
+/**
+ * @brief replaces the audit exclusions of the process creation syscalls, so the kernel drops the excluded activity instead of auditing it.
+ * 
+ * @param   exclusions  The exclusions.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, ProcessCreationCollector_SetAuditExclusions, const AuditControlExclusions*, exclusions);
+
 #endif //PROCESS_CEATION_COLLECTOR_H
\ No newline at end of file
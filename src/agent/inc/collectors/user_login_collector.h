@@ -10,6 +10,7 @@
 #include "umock_c_prod.h"
 
 #include "collectors/generic_event.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
 #include "synchronized_queue.h"
 
 /**
@@ -22,4 +23,25 @@
  */
 MOCKABLE_FUNCTION(, EventCollectorResult, UserLoginCollector_GetEvents, SyncQueue*, queue);
 
+/**
+ * @brief registers the handler of the login events on the audit dispatcher.
+ * 
+ * @param   dispatcher  The audit dispatcher.
+ * @param   handler     The handler of the events, which hands them to UserLoginCollector_HandleAuditEvent.
+ * @param   context     The context of the handler.
+ * 
+ * @return EVENT_COLLECTOR_OK on success, EVENT_COLLECTOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, UserLoginCollector_AddAuditHandler, AuditDispatcher*, dispatcher, AuditDispatcherEventHandler, handler, void*, context);
+
+/**
+ * @brief create a message for a single login event of the audit dispatcher and insert it into the queue.
+ * 
+ * @param   auditSearch     The search positioned on the event.
+ * @param   queue           The queue to insert the mesages to.
+ * 
+ * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
+ */
+MOCKABLE_FUNCTION(, EventCollectorResult, UserLoginCollector_HandleAuditEvent, AuditSearch*, auditSearch, SyncQueue*, queue);
+
 #endif //USER_LOGIN_COLLECTOR_H
\ No newline at end of file
@@ -47,6 +47,31 @@ extern uint32_t DEFAULT_HIGH_PRIORITY_MESSAGE_FREQUENCY;
  */
 extern uint32_t DEFAULT_SNAPSHOT_FREQUENCY;
 
+/**
+ * Whether high priority events evict low priority events once the cache is full
+ */
+extern const bool DEFAULT_EVICT_LOW_PRIORITY_EVENTS;
+
+/**
+ * The longest time a single run of a collector may take before it is cancelled
+ */
+extern uint32_t DEFAULT_COLLECTOR_TIME_BUDGET;
+
+/**
+ * The amount of bytes the publisher may send in a single execution, once the first message was sent
+ */
+extern uint32_t DEFAULT_MAX_PUBLISHED_BYTES_PER_CYCLE;
+
+/**
+ * Whether security messages are compressed by default
+ */
+extern const bool DEFAULT_COMPRESS_MESSAGES;
+
+/**
+ * Whether security messages are encoded as CBOR instead of json by default
+ */
+extern const bool DEFAULT_ENCODE_MESSAGES_AS_CBOR;
+
 /**
  * Baseline custom checks enabled
  */
@@ -62,6 +87,21 @@ extern const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_PATH;
  */
 extern const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH;
 
+/**
+ * Comma separated executables whose audited syscalls are dropped by the kernel, none by default
+ */
+extern const char* DEFAULT_AUDIT_EXCLUDED_EXECUTABLES;
+
+/**
+ * Comma separated uids whose audited syscalls are dropped by the kernel, none by default
+ */
+extern const char* DEFAULT_AUDIT_EXCLUDED_UIDS;
+
+/**
+ * Comma separated auid ranges ("first-last" or a single auid) whose audited syscalls are dropped by the kernel, none by default
+ */
+extern const char* DEFAULT_AUDIT_EXCLUDED_AUID_RANGES;
+
 /**
  * The scheduler interval
  */
@@ -72,6 +112,11 @@ extern const uint32_t SCHEDULER_INTERVAL;
  */
 extern const uint32_t TWIN_UPDATE_SCHEDULER_INTERVAL;
 
+/**
+ * The number of preallocated slots in each of the lock-free event queues
+ */
+extern const uint32_t EVENT_QUEUE_CAPACITY;
+
 /**
  * The configuration file to load from
  */
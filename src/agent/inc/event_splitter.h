@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef EVENT_SPLITTER_H
+#define EVENT_SPLITTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+typedef enum _EventSplitterResult {
+
+    EVENT_SPLITTER_OK,
+    EVENT_SPLITTER_NOT_SPLITTABLE,
+    EVENT_SPLITTER_EXCEPTION
+
+} EventSplitterResult;
+
+/**
+ * @brief Receives a single event created by the splitter.
+ *
+ * @param   context     The context given to the splitter.
+ * @param   event       The serialized event, the callback takes ownership of it in any case.
+ * @param   eventSize   The size of the event, not including the null terminator.
+ *
+ * @return true on success, false otherwise. The splitter stops on failure.
+ */
+typedef bool (*EventSplitterCallback)(void* context, char* event, uint32_t eventSize);
+
+/**
+ * @brief Splits a serialized event into several events which are not larger than the given size.
+ *        The elements of the payload array are divided between the new events in their original order,
+ *        while the rest of the event is copied to each of them as is, except for the event id which is regenerated.
+ *        A single payload element which cannot fit into an event of the given size is dropped.
+ *
+ * @param   event           The serialized event.
+ * @param   eventSize       The size of the serialized event.
+ * @param   maxEventSize    The max size of every new event.
+ * @param   callback        Called with every new event, in order.
+ * @param   context         The context to pass to the callback.
+ *
+ * @return EVENT_SPLITTER_OK on success, EVENT_SPLITTER_NOT_SPLITTABLE if the event has no payload elements which fit the max size
+ *         or is not a valid event, EVENT_SPLITTER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, EventSplitterResult, EventSplitter_Split, const char*, event, uint32_t, eventSize, uint32_t, maxEventSize, EventSplitterCallback, callback, void*, context);
+
+#endif //EVENT_SPLITTER_H
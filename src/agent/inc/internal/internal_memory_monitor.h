@@ -21,6 +21,7 @@ typedef enum _MemoryMonitorResultValues {
 
 /**
  * @brief An internal mermoy monitor which should limit the cache size. This is used in the regular\synced memory monitor.
+ *        The accounting is lock-free, so it is safe to use from multiple threads.
  */
 MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_Init);
 
@@ -29,6 +30,14 @@ MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_Init);
  */
 MOCKABLE_FUNCTION(, void, InternalMemoryMonitor_Deinit);
 
+/**
+ * @brief Reads the memory limitation from the twin configuration. The limitation is cached, so this
+ *        should be called whenever the twin configuration changes.
+ * 
+ * @return MEMORY_MONITOR_OK on success or MEMORY_MONITOR_EXCEPTION if the configuration could not be read.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, InternalMemoryMonitor_UpdateLimit);
+
 /**
  * @brief Consume the given amount of bytes from the memory limitation.
  * 
@@ -18,6 +18,13 @@
  */
 MOCKABLE_FUNCTION(, time_t, TimeUtils_GetCurrentTime);
 
+/**
+ * @brief Returns the time of a monotonic clock, which is not affected by changes of the system time.
+ * 
+ * @return The monotonic time in milliseconds, meaningful only relative to another monotonic time.
+ */
+MOCKABLE_FUNCTION(, uint64_t, TimeUtils_GetMonotonicTimeInMilliseconds);
+
 /**
  * @brief Returns the diff between time beginning to time end, in milliseconds.
  * 
@@ -58,10 +58,12 @@ MOCKABLE_FUNCTION(, bool, IoTHubAdapter_Connect, IoTHubAdapter*, iotHubAdapter);
  * @param   iotHubAdapter   The adapter to send data with.
  * @param   data            The data to send.
  * @param   dataSize        The size of the data we want to send.
+ * @param   contentType     The content type of the data, NULL if the data is json.
+ * @param   contentEncoding The content encoding of the data, NULL if the data is not encoded.
  * 
  * @return true on success, false otherwise.
  */
-MOCKABLE_FUNCTION(, bool, IoTHubAdapter_SendMessageAsync, IoTHubAdapter*, iotHubAdapter, const void*, data, size_t, dataSize);
+MOCKABLE_FUNCTION(, bool, IoTHubAdapter_SendMessageAsync, IoTHubAdapter*, iotHubAdapter, const void*, data, size_t, dataSize, const char*, contentType, const char*, contentEncoding);
 
 /**
  * @brief Set reported properties to device twin module/
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CBOR_STREAM_WRITER_H
+#define CBOR_STREAM_WRITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "umock_c_prod.h"
+#include "macro_utils.h"
+
+#include "json/json_defs.h"
+
+#define CBOR_STREAM_WRITER_MAX_DEPTH 8
+
+/**
+ * An append-only writer of CBOR (RFC 7049) with the same logical model as the json stream writer.
+ * Objects and arrays are written with an indefinite length, so nothing is ever patched
+ * once it was appended, and strings are copied as is since CBOR needs no escaping.
+ */
+typedef struct _CborStreamWriter {
+
+    char* buffer;
+    uint32_t size;
+    uint32_t capacity;
+
+    uint32_t depth;
+    bool isArray[CBOR_STREAM_WRITER_MAX_DEPTH];
+
+} CborStreamWriter;
+
+/**
+ * @brief Initiates a new CBOR stream writer on a growable buffer owned by the writer.
+ *
+ * @param   writer              The writer instance.
+ * @param   initialCapacity     The initial size of the buffer, it is doubled whenever it runs out.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_Init, CborStreamWriter*, writer, uint32_t, initialCapacity);
+
+/**
+ * @brief Deinitiate the CBOR stream writer.
+ *
+ * @param   writer  The writer instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, CborStreamWriter_Deinit, CborStreamWriter*, writer);
+
+/**
+ * @brief Opens a new map, the CBOR equivalent of a json object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key of the new object, NULL for the root object and for array elements.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_BeginObject, CborStreamWriter*, writer, const char*, key);
+
+/**
+ * @brief Closes the current map.
+ *
+ * @param   writer  The writer instance.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_EndObject, CborStreamWriter*, writer);
+
+/**
+ * @brief Opens a new array.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key of the new array, NULL for the root array and for array elements.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_BeginArray, CborStreamWriter*, writer, const char*, key);
+
+/**
+ * @brief Closes the current array.
+ *
+ * @param   writer  The writer instance.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_EndArray, CborStreamWriter*, writer);
+
+/**
+ * @brief Write the key with the given string value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key, must be a valid UTF-8 string.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_WriteString, CborStreamWriter*, writer, const char*, key, const char*, value);
+
+/**
+ * @brief Write the key with the given int value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_WriteInt, CborStreamWriter*, writer, const char*, key, int, value);
+
+/**
+ * @brief Write the key with the given bool value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_WriteBool, CborStreamWriter*, writer, const char*, key, bool, value);
+
+/**
+ * @brief Write the key with an already serialized json value, which is converted to CBOR in a single pass.
+ *        Integers are written as CBOR integers and any other number as a double.
+ *        The writer is left as it was if the value is not valid json.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The serialized json value.
+ * @param   length  The length of the serialized value.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_WriteJson, CborStreamWriter*, writer, const char*, key, const char*, value, uint32_t, length);
+
+/**
+ * @brief Drops everything written after the given size, used to take back the last values written.
+ *        No container may have been opened or closed since the output had the given size.
+ *
+ * @param   writer  The writer instance.
+ * @param   size    The size to go back to.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_Truncate, CborStreamWriter*, writer, uint32_t, size);
+
+/**
+ * @brief Hands the completed CBOR over to the caller, who is responsible for freeing it.
+ *        The writer is empty afterwards.
+ *
+ * @param   writer  The writer instance.
+ * @param   output  Out param. The CBOR data item.
+ * @param   size    Out param. The size of the output.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, CborStreamWriter_Serialize, CborStreamWriter*, writer, char**, output, uint32_t*, size);
+
+#endif //CBOR_STREAM_WRITER_H
@@ -92,6 +92,16 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_WriteArray, JsonObjectWri
  */
 MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_Serialize, JsonObjectWriterHandle, writer, char**, output, uint32_t*, size);
 
+/**
+ * @brief Returns the size the given object would take once serialized, without serializing it.
+ * 
+ * @param   writer  The json writer instance.
+ * @param   size    Out param. The size of the serialized object.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure. 
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_GetSerializedSize, JsonObjectWriterHandle, writer, uint32_t*, size);
+
 /**
  * @brief Write the given object to this json object.
  * 
@@ -104,10 +114,10 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_Serialize, JsonObjectWrit
 MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_WriteObject, JsonObjectWriterHandle, writer, const char*, key, JsonObjectWriterHandle, object);
 
 /**
- * @brief Creates a newly allocated copy of the given object
+ * @brief Creates a newly allocated deep copy of the given object
  * 
- * @param   dst     Destination object
- * @param   key     The key to add.
+ * @param   dst     Out param. Destination object
+ * @param   src     The object to copy.
  * 
  * @return JSON_WRITER_OK on success, an indicative error in failure.
  */
@@ -123,6 +133,17 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_Copy, JsonObjectWriterHan
  */
 MOCKABLE_FUNCTION(, bool, JsonObjectWriter_Compare, JsonObjectWriterHandle, a, JsonObjectWriterHandle, b);
 
+/**
+ * @brief Computes a hash of the object content, objects which JsonObjectWriter_Compare finds equal have the same hash.
+ *        The order of the object members does not affect the hash.
+ * 
+ * @param   writer  The writer instance.
+ * @param   hash    Out param. The hash of the object.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_GetHash, JsonObjectWriterHandle, writer, uint32_t*, hash);
+
 /**
  * @brief Returns the number of items in this array.
  * 
@@ -143,6 +164,39 @@ MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_GetSize, JsonObjectWriter
  */
 MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_StepIn, JsonObjectWriterHandle, handle, const char*, key);
 
+/**
+ * @brief Returns the key of the item at the given index of this object.
+ * 
+ * @param   handle  The writer instance.
+ * @param   index   The index of the item, smaller than the size of the object.
+ * @param   key     Out param. The key of the item, owned by the writer.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_GetKeyAt, JsonObjectWriterHandle, handle, uint32_t, index, const char**, key);
+
+/**
+ * @brief Reads the string value of the given key.
+ * 
+ * @param   handle  The writer instance.
+ * @param   key     The key to read.
+ * @param   value   Out param. The value of the key, owned by the writer and valid until the key is written again.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_ReadString, JsonObjectWriterHandle, handle, const char*, key, const char**, value);
+
+/**
+ * @brief Resets the value of the given key to the empty value of its type, "" for strings, 0 for numbers
+ *        and false for booleans. Objects and arrays are left as they are.
+ * 
+ * @param   handle  The writer instance.
+ * @param   key     The key to reset.
+ * 
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonObjectWriter_ResetValue, JsonObjectWriterHandle, handle, const char*, key);
+
 
 
 #endif //JSON_OBJECT_WRITER_H
\ No newline at end of file
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef JSON_STREAM_WRITER_H
+#define JSON_STREAM_WRITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "umock_c_prod.h"
+#include "macro_utils.h"
+
+#include "json/json_defs.h"
+
+#define JSON_STREAM_WRITER_MAX_DEPTH 8
+
+/**
+ * An append-only json writer.
+ * Keys and values are escaped and appended directly to a single buffer instead of being
+ * allocated as a DOM, so the output is in the order the values were written and cannot be
+ * changed afterwards. Use the json object writer when the document needs mutation.
+ */
+typedef struct _JsonStreamWriter {
+
+    char* buffer;
+    uint32_t size;
+    uint32_t capacity;
+    bool isGrowable;
+
+    uint32_t depth;
+    bool isArray[JSON_STREAM_WRITER_MAX_DEPTH];
+    bool hasValues[JSON_STREAM_WRITER_MAX_DEPTH];
+
+} JsonStreamWriter;
+
+/**
+ * @brief Initiates a new json stream writer on a growable buffer owned by the writer.
+ *
+ * @param   writer              The writer instance.
+ * @param   initialCapacity     The initial size of the buffer, it is doubled whenever it runs out.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_Init, JsonStreamWriter*, writer, uint32_t, initialCapacity);
+
+/**
+ * @brief Initiates a new json stream writer on a caller supplied buffer.
+ *        Writes which do not fit in the buffer fail, the buffer is never reallocated.
+ *
+ * @param   writer      The writer instance.
+ * @param   buffer      The buffer to write to.
+ * @param   capacity    The size of the buffer, including the null terminator.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_InitWithBuffer, JsonStreamWriter*, writer, char*, buffer, uint32_t, capacity);
+
+/**
+ * @brief Deinitiate the json stream writer.
+ *
+ * @param   writer  The writer instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, JsonStreamWriter_Deinit, JsonStreamWriter*, writer);
+
+/**
+ * @brief Opens a new object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key of the new object, NULL for the root object and for array elements.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_BeginObject, JsonStreamWriter*, writer, const char*, key);
+
+/**
+ * @brief Closes the current object.
+ *
+ * @param   writer  The writer instance.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_EndObject, JsonStreamWriter*, writer);
+
+/**
+ * @brief Opens a new array.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key of the new array, NULL for the root array and for array elements.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_BeginArray, JsonStreamWriter*, writer, const char*, key);
+
+/**
+ * @brief Closes the current array.
+ *
+ * @param   writer  The writer instance.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_EndArray, JsonStreamWriter*, writer);
+
+/**
+ * @brief Write the key with the given string value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key, must be a valid UTF-8 string.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_WriteString, JsonStreamWriter*, writer, const char*, key, const char*, value);
+
+/**
+ * @brief Write the key with the given int value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_WriteInt, JsonStreamWriter*, writer, const char*, key, int, value);
+
+/**
+ * @brief Write the key with the given bool value to the current object.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The value of the new key.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_WriteBool, JsonStreamWriter*, writer, const char*, key, bool, value);
+
+/**
+ * @brief Write the key with an already serialized json value, the value is copied as is.
+ *        The value is not parsed nor validated, it must be a complete json value.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key to write, NULL when writing an array element.
+ * @param   value   The serialized json value.
+ * @param   length  The length of the serialized value.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_WriteRaw, JsonStreamWriter*, writer, const char*, key, const char*, value, uint32_t, length);
+
+/**
+ * @brief Returns the json written so far without copying it.
+ *        The output is owned by the writer and is valid until the next write.
+ *
+ * @param   writer  The writer instance.
+ * @param   output  Out param. The null terminated json.
+ * @param   size    Out param. The size of the json, not including the null terminator.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_GetOutput, JsonStreamWriter*, writer, const char**, output, uint32_t*, size);
+
+/**
+ * @brief Hands the completed json over to the caller, who is responsible for freeing it.
+ *        A growable buffer is handed over as is, a caller supplied buffer is copied.
+ *        The writer is empty afterwards.
+ *
+ * @param   writer  The writer instance.
+ * @param   output  Out param. The null terminated json.
+ * @param   size    Out param. The size of the json, not including the null terminator.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, JsonWriterResult, JsonStreamWriter_Serialize, JsonStreamWriter*, writer, char**, output, uint32_t*, size);
+
+#endif //JSON_STREAM_WRITER_H
@@ -10,6 +10,7 @@
 #include "macro_utils.h"
 
 #include "consts.h"
+#include "twin_configuration_defs.h"
 
 typedef enum _LocalConfigurationResultValues {
 
@@ -93,4 +94,62 @@ MOCKABLE_FUNCTION(, int32_t, LocalConfiguration_GetDiagnosticEventMinimumSeverit
  */
 MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetRemoteConfigurationObjectName);
 
+/**
+ * @brief returns the directory of the spill logs of the event queues
+ * 
+ * @return the spill directory, NULL if spilling is disabled
+ */
+MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetSpillDirectory);
+
+/**
+ * @brief returns the maximal size of the spill log of each event queue
+ * 
+ * @return the maximal spill log size in bytes
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetMaxSpillSize);
+
+/**
+ * @brief returns the part of the cache the high priority event queue may take
+ * 
+ * @return the budget in bytes, 0 if the queue is limited only by the cache size
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetHighPriorityQueueBudget);
+
+/**
+ * @brief returns the part of the cache the low priority event queue may take
+ * 
+ * @return the budget in bytes, 0 if the queue is limited only by the cache size
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetLowPriorityQueueBudget);
+
+/**
+ * @brief returns the interval of the collector of the given event type
+ * 
+ * @param   eventType   the event type of the collector
+ * 
+ * @return the interval in milliseconds, 0 if the collector uses the interval of its group (snapshot or triggered events)
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetCollectorInterval, TwinConfigurationEventType, eventType);
+
+/**
+ * @brief returns the random jitter which is added to the collector intervals, spreading the collections over time
+ * 
+ * @return the maximal jitter as a percentage of the interval
+ */
+MOCKABLE_FUNCTION(, uint32_t, LocalConfiguration_GetSchedulingJitterPercentage);
+
+/**
+ * @brief is the audit feed enabled? The audit collectors then handle the audit events as they arrive instead of scanning the audit logs.
+ * 
+ * @return whether the audit feed is enabled
+ */
+MOCKABLE_FUNCTION(, bool, LocalConfiguration_IsAuditFeedEnabled);
+
+/**
+ * @brief returns the path of the audispd socket which feeds the audit events
+ * 
+ * @return the socket path, NULL if the audit events are read from the audit netlink multicast group
+ */
+MOCKABLE_FUNCTION(, const char*, LocalConfiguration_GetAuditFeedSocketPath);
+
 #endif // LOCAL_CONFiG_H
\ No newline at end of file
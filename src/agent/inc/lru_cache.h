@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+// the sizes bound the entries, which are allocated by their actual length
+#define LRU_CACHE_MAX_KEY_SIZE PATH_MAX
+// the longest hex digest, sha512, with its algorithm prefix
+#define LRU_CACHE_MAX_VALUE_SIZE (sizeof("sha512:") + 128)
+
+typedef enum _LruCacheResultValues {
+
+    LRU_CACHE_OK,
+    LRU_CACHE_NOT_FOUND,
+    LRU_CACHE_EXCEPTION
+
+} LruCacheResultValues;
+
+typedef struct _LruCacheEntry {
+
+    char* key;
+    char* value;
+    // the next entry in the bucket of the key
+    int32_t nextInBucket;
+    // the neighbours of the entry in the recency list
+    int32_t newer;
+    int32_t older;
+
+} LruCacheEntry;
+
+/**
+ * A string to string cache of a bounded number of entries, the least recently used entry is evicted once it is full.
+ *
+ * The entry slots are preallocated and indexed by a chained hash table of the keys, the recency list links them from
+ * the newest to the oldest. The keys and values are copied to the heap. The cache can be saved to a file and is loaded back from it when initiated.
+ * The file is created readable only by the effective user. A symbolic link, or a file which is owned by another user or is
+ * accessible to other users, is neither loaded nor overwritten.
+ * A zeroed cache which was not initiated, or failed to initiate, is empty and can not be added to.
+ * The cache is not thread safe.
+ */
+typedef struct _LruCache {
+
+    LruCacheEntry* entries;
+    int32_t* buckets;
+    uint32_t bucketsCount;
+    uint32_t capacity;
+    uint32_t count;
+    int32_t newest;
+    int32_t oldest;
+    char* file;
+    bool isDirty;
+
+} LruCache;
+
+/**
+ * @brief Initiates the cache and loads the entries saved in the given file, if there are any.
+ *
+ * @param   cache       The cache instance we want to initiate.
+ * @param   capacity    The maximal number of entries.
+ * @param   file        The file of the cache, NULL for a cache which is not saved.
+ *
+ * @return LRU_CACHE_OK on success or LRU_CACHE_EXCEPTION upon failure, a missing or invalid file leaves the cache empty.
+ */
+MOCKABLE_FUNCTION(, LruCacheResultValues, LruCache_Init, LruCache*, cache, uint32_t, capacity, const char*, file);
+
+/**
+ * @brief Deinitiates the cache, the entries which were not saved are lost.
+ *
+ * @param   cache       The cache instance we want to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, LruCache_Deinit, LruCache*, cache);
+
+/**
+ * @brief Returns the value of the given key and marks the entry as the most recently used.
+ *
+ * @param   cache       The cache.
+ * @param   key         The key.
+ * @param   value       Out param. The value, valid until the cache is changed.
+ *
+ * @return LRU_CACHE_OK on success, LRU_CACHE_NOT_FOUND if the key is not in the cache.
+ */
+MOCKABLE_FUNCTION(, LruCacheResultValues, LruCache_Get, LruCache*, cache, const char*, key, const char**, value);
+
+/**
+ * @brief Adds or updates the value of the given key, evicting the least recently used entry if the cache is full.
+ *
+ * @param   cache       The cache.
+ * @param   key         The key, shorter than LRU_CACHE_MAX_KEY_SIZE.
+ * @param   value       The value, shorter than LRU_CACHE_MAX_VALUE_SIZE.
+ *
+ * @return LRU_CACHE_OK on success, LRU_CACHE_EXCEPTION if the key or the value are too long, they could not be copied
+ *         or the cache is not initiated.
+ */
+MOCKABLE_FUNCTION(, LruCacheResultValues, LruCache_Put, LruCache*, cache, const char*, key, const char*, value);
+
+/**
+ * @brief Saves the entries to the file of the cache, if they changed since they were last saved or loaded.
+ *
+ * @param   cache       The cache.
+ *
+ * @return LRU_CACHE_OK on success or LRU_CACHE_EXCEPTION upon failure.
+ */
+MOCKABLE_FUNCTION(, LruCacheResultValues, LruCache_Save, LruCache*, cache);
+
+/**
+ * @brief Returns the number of entries in the cache.
+ *
+ * @param   cache       The cache.
+ *
+ * @return the number of entries.
+ */
+MOCKABLE_FUNCTION(, uint32_t, LruCache_GetCount, LruCache*, cache);
+
+#endif //LRU_CACHE_H
@@ -20,6 +20,13 @@ MOCKABLE_FUNCTION(, bool, MemoryMonitor_Init);
  */
 MOCKABLE_FUNCTION(, void, MemoryMonitor_Deinit);
 
+/**
+ * @brief Refreshes the cached memory limitation from the twin configuration.
+ * 
+ * @return MEMORY_MONITOR_OK on success or MEMORY_MONITOR_EXCEPTION if the configuration could not be read.
+ */
+MOCKABLE_FUNCTION(, MemoryMonitorResultValues, MemoryMonitor_UpdateLimit);
+
 /**
  * @brief Consume the given amount of bytes from the memory limitation.
  * 
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MESSAGE_COMPRESSOR_H
+#define MESSAGE_COMPRESSOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zlib.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+/**
+ * The content encoding of a compressed message.
+ */
+#define MESSAGE_COMPRESSOR_CONTENT_ENCODING "gzip"
+
+typedef enum _MessageCompressorResult {
+
+    MESSAGE_COMPRESSOR_OK,
+    MESSAGE_COMPRESSOR_OUT_OF_SPACE,
+    MESSAGE_COMPRESSOR_EXCEPTION
+
+} MessageCompressorResult;
+
+/**
+ * A streaming gzip compressor into a buffer of a fixed size.
+ * The input is flushed on every append, so the size of the output so far is exact
+ * and the size of the complete message can be bounded before more data is appended.
+ */
+typedef struct _MessageCompressor {
+
+    z_stream stream;
+    char* buffer;
+    uint32_t capacity;
+
+} MessageCompressor;
+
+/**
+ * @brief Initiates a new compressor.
+ *
+ * @param   compressor  The compressor instance.
+ * @param   capacity    The max size of the compressed output.
+ *
+ * @return MESSAGE_COMPRESSOR_OK on success, an indicative error in failure.
+ */
+MOCKABLE_FUNCTION(, MessageCompressorResult, MessageCompressor_Init, MessageCompressor*, compressor, uint32_t, capacity);
+
+/**
+ * @brief Deinitiate the compressor.
+ *
+ * @param   compressor  The compressor instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, MessageCompressor_Deinit, MessageCompressor*, compressor);
+
+/**
+ * @brief Compresses the given data and flushes it to the output.
+ *
+ * @param   compressor  The compressor instance.
+ * @param   data        The data to compress.
+ * @param   size        The size of the data.
+ *
+ * @return MESSAGE_COMPRESSOR_OK on success, MESSAGE_COMPRESSOR_OUT_OF_SPACE if the output exceeds the capacity,
+ *         MESSAGE_COMPRESSOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, MessageCompressorResult, MessageCompressor_Append, MessageCompressor*, compressor, const char*, data, uint32_t, size);
+
+/**
+ * @brief Returns the amount of data which can surely be appended and finished without exceeding the capacity,
+ *        regardless of how well it compresses.
+ *
+ * @param   compressor  The compressor instance.
+ *
+ * @return the max size of the data to append.
+ */
+MOCKABLE_FUNCTION(, uint32_t, MessageCompressor_GetMaxAppendSize, MessageCompressor*, compressor);
+
+/**
+ * @brief Compresses the last piece of data, completes the gzip stream and hands it over to the caller,
+ *        who is responsible for freeing it.
+ *
+ * @param   compressor  The compressor instance.
+ * @param   data        The last data to compress.
+ * @param   size        The size of the data.
+ * @param   output      Out param. The compressed message.
+ * @param   outputSize  Out param. The size of the compressed message.
+ *
+ * @return MESSAGE_COMPRESSOR_OK on success, MESSAGE_COMPRESSOR_OUT_OF_SPACE if the output exceeds the capacity,
+ *         MESSAGE_COMPRESSOR_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, MessageCompressorResult, MessageCompressor_Finish, MessageCompressor*, compressor, const char*, data, uint32_t, size, char**, output, uint32_t*, outputSize);
+
+#endif //MESSAGE_COMPRESSOR_H
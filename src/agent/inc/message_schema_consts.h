@@ -106,11 +106,20 @@ extern const char* AGENT_TELEMETRY_DROPPED_EVENTS_KEY;
 extern const char* AGENT_TELEMETRY_QUEUE_EVENTS_KEY;
 extern const char* AGENT_TELEMETRY_DROPPED_EVENTS_NAME;
 extern const char* AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_KEY;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_NAME;
+extern const char* AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_EVENT_TYPE_KEY;
 extern const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME;
 extern const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION;
 extern const char* AGENT_TELEMETRY_MESSAGES_SENT_KEY;
 extern const char* AGENT_TELEMETRY_MESSAGES_FAILED_KEY;
 extern const char* AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY;
+extern const char* AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY;
+extern const char* AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_NAME;
+extern const char* AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_SCHEMA_VERSION;
+extern const char* AGENT_TELEMETRY_COLLECTOR_KEY;
+extern const char* AGENT_TELEMETRY_TIME_BUDGET_KEY;
 
 /* ===== Configuration Error Message Schema ====*/
 
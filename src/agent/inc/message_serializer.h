@@ -4,6 +4,9 @@
 #ifndef MESSAGE_SERIALIZER_H
 #define MESSAGE_SERIALIZER_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "macro_utils.h"
 #include "umock_c_prod.h"
 
@@ -19,16 +22,31 @@ typedef enum _MessageSerializerResultValues {
     
 } MessageSerializerResultValues;
 
+typedef enum _MessageSerializerEncoding {
+
+    MESSAGE_SERIALIZER_ENCODING_JSON,
+    MESSAGE_SERIALIZER_ENCODING_CBOR
+
+} MessageSerializerEncoding;
+
+/**
+ * The content type of a message encoded as CBOR.
+ */
+#define MESSAGE_SERIALIZER_CBOR_CONTENT_TYPE "application/cbor"
+
 
 /**
  * @brief Serialize all messages from the qiven queue.
  * 
  * @param   queues          array of queues to serialize events from, the method empties the queues in an orderd way
  * @param   len             The length of the queues array
+ * @param   encoding        The encoding of the message, json or CBOR with the same logical schema.
+ * @param   compress        Whether to gzip the message, the events are then packed by their compressed size.
  * @param   buffer          Out param. The buffer that will contain the data on success.
+ * @param   bufferSize      Out param. The size of the data, a compressed or CBOR message is not null terminated.
  *  
  * @return a buffer which represents tue serialization of the queue. In case of faliure NULL is returned.
  */
-MOCKABLE_FUNCTION(, MessageSerializerResultValues, MessageSerializer_CreateSecurityMessage, SyncQueue**, queues, uint32_t, len, void**, buffer);
+MOCKABLE_FUNCTION(, MessageSerializerResultValues, MessageSerializer_CreateSecurityMessage, SyncQueue**, queues, uint32_t, len, MessageSerializerEncoding, encoding, bool, compress, void**, buffer, uint32_t*, bufferSize);
 
 #endif //MESSAGE_SERIALIZER_H
\ No newline at end of file
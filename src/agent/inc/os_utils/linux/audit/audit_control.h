@@ -29,6 +29,21 @@ typedef enum _AuditControlResultValues {
     
 } AuditControlResultValues;
 
+/**
+ * The activity which is dropped by the kernel instead of being audited.
+ * Each list is comma separated, NULL or empty for none.
+ */
+typedef struct _AuditControlExclusions {
+
+    // the full paths of the executables of the excluded processes
+    const char* executables;
+    // the uids, or user names, of the excluded processes
+    const char* uids;
+    // the excluded login uids, either "first-last" ranges or single auids
+    const char* auidRanges;
+
+} AuditControlExclusions;
+
 extern const char AUDIT_CONTROL_ON_SUCCESS_FILTER[];
 extern const char AUDIT_CONTROL_TYPE_EXECVE[];
 extern const char AUDIT_CONTROL_TYPE_EXECVEAT[];
@@ -64,4 +79,28 @@ MOCKABLE_FUNCTION(, void, AuditControl_Deinit, AuditControl*, auditControl);
  */
 MOCKABLE_FUNCTION(, AuditControlResultValues, AuditControl_AddRule, AuditControl*, auditControl, const char**, msgTypeArray, size_t, msgTypeArraySize, const char*, extraFilter);
 
+/**
+ * @brief Replaces the exclusions of the given message types, the rules tagged with the given key are deleted
+ *        and a never rule is added ahead of the existing rules for each exclusion.
+ * 
+ * @param   auditControl        The audit instance.
+ * @param   msgTypeArray        The message type array of the excluded syscalls.
+ * @param   msgTypeArraySize    The message type array size of the excluded syscalls.
+ * @param   key                 The key which tags the exclusion rules, unique per caller.
+ * @param   exclusions          The exclusions.
+ * 
+ * @return AUDIT_CONTROL_OK on success or an appropriate error, the valid exclusions are applied even if others failed.
+ */
+MOCKABLE_FUNCTION(, AuditControlResultValues, AuditControl_SetExclusions, AuditControl*, auditControl, const char**, msgTypeArray, size_t, msgTypeArraySize, const char*, key, const AuditControlExclusions*, exclusions);
+
+/**
+ * @brief Deletes the exclusions which were set with the given key, so the kernel audits the excluded activity again.
+ * 
+ * @param   auditControl        The audit instance.
+ * @param   key                 The key which tags the exclusion rules.
+ * 
+ * @return AUDIT_CONTROL_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditControlResultValues, AuditControl_DeleteExclusions, AuditControl*, auditControl, const char*, key);
+
 #endif //AUDIT_CONTROL_H
\ No newline at end of file
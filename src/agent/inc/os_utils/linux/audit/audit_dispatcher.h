@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef AUDIT_DISPATCHER_H
+#define AUDIT_DISPATCHER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "os_utils/linux/audit/audit_search_utils.h"
+
+#define AUDIT_DISPATCHER_MAX_HANDLERS 8
+#define AUDIT_DISPATCHER_MAX_MESSAGE_TYPES 4
+
+typedef enum _AuditDispatcherResultValues {
+
+    AUDIT_DISPATCHER_OK,
+    AUDIT_DISPATCHER_EXCEPTION
+
+} AuditDispatcherResultValues;
+
+/**
+ * @brief Handles a single audit event.
+ *        The event is read with the AuditSearch accessors, the search is valid only during the call.
+ *
+ * @param   auditSearch     The search positioned on the event.
+ * @param   context         The context which was given upon registration.
+ */
+typedef void (*AuditDispatcherEventHandler)(AuditSearch* auditSearch, void* context);
+
+typedef struct _AuditDispatcherHandler {
+
+    AuditSearchCriteria searchCriteria;
+    const char* messageTypes[AUDIT_DISPATCHER_MAX_MESSAGE_TYPES];
+    uint32_t messageTypesCount;
+    AuditDispatcherEventHandler handler;
+    void* context;
+
+} AuditDispatcherHandler;
+
+/**
+ * Routes the audit events to the handlers whose search criteria they match.
+ *
+ * The audit logs are searched in a single pass for the events of all the handlers, under a single checkpoint,
+ * so the logs are opened and parsed once no matter how many handlers there are.
+ * The audit feed hands its events to the handlers the same way.
+ */
+typedef struct _AuditDispatcher {
+
+    AuditDispatcherHandler handlers[AUDIT_DISPATCHER_MAX_HANDLERS];
+    uint32_t handlersCount;
+    const char* checkpointFile;
+
+} AuditDispatcher;
+
+/**
+ * @brief Initiates the dispatcher.
+ *
+ * @param   dispatcher      The dispatcher instance we want to initiate.
+ * @param   checkpointFile  The path to the checkpoint of the audit log search, shared by all the handlers.
+ */
+MOCKABLE_FUNCTION(, void, AuditDispatcher_Init, AuditDispatcher*, dispatcher, const char*, checkpointFile);
+
+/**
+ * @brief Registers a handler for the events which match the given search criteria.
+ *        The events are matched like AuditSearch_InitMultipleSearchCriteria matches them in the audit logs.
+ *
+ * @param   dispatcher          The dispatcher instance.
+ * @param   searchCriteria      The search criteria to aply.
+ * @param   messageTypes        The array of types of the messages we want to handle.
+ * @param   messageTypesCount   Number of elements in the messageTypes array, at most AUDIT_DISPATCHER_MAX_MESSAGE_TYPES.
+ * @param   handler             The handler of the events.
+ * @param   context             The context of the handler.
+ *
+ * @return AUDIT_DISPATCHER_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditDispatcherResultValues, AuditDispatcher_AddHandler, AuditDispatcher*, dispatcher, AuditSearchCriteria, searchCriteria, const char**, messageTypes, uint32_t, messageTypesCount, AuditDispatcherEventHandler, handler, void*, context);
+
+/**
+ * @brief Hands the current event of the search to the handlers which match it.
+ *
+ * @param   dispatcher      The dispatcher instance.
+ * @param   auditSearch     The search positioned on the event.
+ */
+MOCKABLE_FUNCTION(, void, AuditDispatcher_Dispatch, AuditDispatcher*, dispatcher, AuditSearch*, auditSearch);
+
+/**
+ * @brief Searches the audit logs for the events of all the handlers since the checkpoint and dispatches them,
+ *        then moves the checkpoint.
+ *
+ * @param   dispatcher      The dispatcher instance.
+ *
+ * @return AUDIT_DISPATCHER_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditDispatcherResultValues, AuditDispatcher_Scan, AuditDispatcher*, dispatcher);
+
+/**
+ * @brief Moves the checkpoint of the audit log search to the given time, used once the events up to that time were handled otherwise.
+ *        The caller must have the privileges to write the checkpoint.
+ *
+ * @param   dispatcher      The dispatcher instance.
+ * @param   checkpointTime  The time of the checkpoint.
+ *
+ * @return AUDIT_DISPATCHER_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditDispatcherResultValues, AuditDispatcher_MoveCheckpoint, AuditDispatcher*, dispatcher, time_t, checkpointTime);
+
+#endif //AUDIT_DISPATCHER_H
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef AUDIT_FEED_H
+#define AUDIT_FEED_H
+
+#include <auparse.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "os_utils/linux/audit/audit_dispatcher.h"
+
+#define AUDIT_FEED_BUFFER_SIZE 8192
+
+typedef enum _AuditFeedResultValues {
+
+    AUDIT_FEED_OK,
+    AUDIT_FEED_EXCEPTION
+
+} AuditFeedResultValues;
+
+/**
+ * A real-time source of audit events.
+ *
+ * The feed reads the audit records as they are emitted, either from the socket of an audispd plugin (af_unix, string format)
+ * or from the audit netlink multicast group, and parses them incrementally with auparse.
+ * Every complete event is handed to the dispatcher, on the thread of the feed and under the lock of the feed,
+ * so holding the lock keeps the handlers of the dispatcher from running.
+ * The checkpoint of the dispatcher is moved along with the feed, so a later audit log search does not report the fed events again.
+ * Writing the checkpoint requires root privileges, so it is left to the owner of the feed and the thread of the feed never changes them.
+ */
+typedef struct _AuditFeed {
+
+    auparse_state_t* audit;
+    int socket;
+    bool isNetlink;
+    char buffer[AUDIT_FEED_BUFFER_SIZE];
+    char record[AUDIT_FEED_BUFFER_SIZE];
+    AuditDispatcher* dispatcher;
+    LOCK_HANDLE lock;
+    THREAD_HANDLE thread;
+    bool threadStarted;
+    bool continueRunning;
+    bool isRunning;
+    // the time up to which the source was read, the checkpoint is moved up to it
+    time_t feedTime;
+    time_t lastCheckpointTime;
+
+} AuditFeed;
+
+/**
+ * @brief Initiates the feed and connects to its source.
+ *
+ * @param   feed            The feed instance we want to initiate.
+ * @param   socketPath      The path of the audispd plugin socket, NULL to read the audit netlink multicast group.
+ * @param   dispatcher      The dispatcher of the events, its handlers must be registered before the feed starts.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditFeedResultValues, AuditFeed_Init, AuditFeed*, feed, const char*, socketPath, AuditDispatcher*, dispatcher);
+
+/**
+ * @brief Deinitiates the feed, stops its thread and closes its source.
+ *
+ * @param   feed    The feed instance we want to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, AuditFeed_Deinit, AuditFeed*, feed);
+
+/**
+ * @brief Starts the thread of the feed.
+ *
+ * @param   feed    The feed instance.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditFeedResultValues, AuditFeed_Start, AuditFeed*, feed);
+
+/**
+ * @brief Returns whether the feed still reads its source, the feed stops once its source is closed or fails.
+ *
+ * @param   feed    The feed instance.
+ *
+ * @return true if the feed is running, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, AuditFeed_IsRunning, AuditFeed*, feed);
+
+/**
+ * @brief Takes the lock of the feed, the events are not dispatched until it is released.
+ *
+ * @param   feed    The feed instance.
+ */
+MOCKABLE_FUNCTION(, void, AuditFeed_Lock, AuditFeed*, feed);
+
+/**
+ * @brief Releases the lock of the feed.
+ *
+ * @param   feed    The feed instance.
+ */
+MOCKABLE_FUNCTION(, void, AuditFeed_Unlock, AuditFeed*, feed);
+
+/**
+ * @brief Parses the given audit records and hands the events which they complete to the dispatcher.
+ *        Called by the thread of the feed with the lock taken.
+ *
+ * @param   feed    The feed instance.
+ * @param   data    The audit records in the string format, newline separated.
+ * @param   size    The size of the data.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditFeedResultValues, AuditFeed_Feed, AuditFeed*, feed, const char*, data, uint32_t, size);
+
+/**
+ * @brief Moves the checkpoint of the dispatcher up to the time the source was read, if it was read since the checkpoint was last moved.
+ *        Called by the owner of the feed with the lock taken.
+ *
+ * @param   feed    The feed instance.
+ */
+MOCKABLE_FUNCTION(, void, AuditFeed_MoveCheckpoint, AuditFeed*, feed);
+
+#endif //AUDIT_FEED_H
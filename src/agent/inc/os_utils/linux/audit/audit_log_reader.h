@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef AUDIT_LOG_READER_H
+#define AUDIT_LOG_READER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#define AUDIT_LOG_READER_MAX_FILES 10
+#define AUDIT_LOG_READER_MAX_PATH 256
+
+typedef enum _AuditLogReaderResultValues {
+
+    AUDIT_LOG_READER_OK,
+    AUDIT_LOG_READER_NOT_FOUND,
+    AUDIT_LOG_READER_EXCEPTION
+
+} AuditLogReaderResultValues;
+
+/**
+ * A position in the audit logs, the log file is identified by its inode so the position survives the rotation of the logs.
+ * A zero inode is no position.
+ */
+typedef struct _AuditLogPosition {
+
+    uint64_t inode;
+    uint64_t offset;
+
+} AuditLogPosition;
+
+typedef struct _AuditLogFile {
+
+    int fd;
+    uint64_t offset;
+    uint64_t end;
+
+} AuditLogFile;
+
+/**
+ * Reads the audit logs from a position onwards, as a single stream.
+ *
+ * The log file of the position is read from its offset, followed by the newer rotated logs and the active log.
+ * The files are read up to their size when the reader was opened, the active log up to its last complete line,
+ * so the end of the reader is the position of the next read.
+ */
+typedef struct _AuditLogReader {
+
+    AuditLogFile files[AUDIT_LOG_READER_MAX_FILES];
+    uint32_t filesCount;
+    uint32_t currentFile;
+    FILE* stream;
+    AuditLogPosition end;
+
+} AuditLogReader;
+
+/**
+ * @brief Opens the audit logs from the given position, or from the beginning of the oldest log if there is no position.
+ *        The rotated logs are looked up next to the active log, suffixed by their rotation number.
+ *
+ * @param   reader      The reader instance we want to open.
+ * @param   logFile     The path of the active audit log.
+ * @param   position    The position to read from.
+ *
+ * @return AUDIT_LOG_READER_OK on success, AUDIT_LOG_READER_NOT_FOUND if the log file of the position is gone or was truncated,
+ *         AUDIT_LOG_READER_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AuditLogReaderResultValues, AuditLogReader_Open, AuditLogReader*, reader, const char*, logFile, const AuditLogPosition*, position);
+
+/**
+ * @brief Closes the reader and its log files.
+ *
+ * @param   reader      The reader instance we want to close.
+ */
+MOCKABLE_FUNCTION(, void, AuditLogReader_Close, AuditLogReader*, reader);
+
+/**
+ * @brief Returns the current end of the active audit log, the position after its last complete line.
+ *
+ * @param   logFile     The path of the active audit log.
+ * @param   position    Out param. The end of the active audit log.
+ *
+ * @return AUDIT_LOG_READER_OK on success or an appropriate error.
+ */
+MOCKABLE_FUNCTION(, AuditLogReaderResultValues, AuditLogReader_GetLogEnd, const char*, logFile, AuditLogPosition*, position);
+
+#endif //AUDIT_LOG_READER_H
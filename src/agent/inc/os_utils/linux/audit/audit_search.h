@@ -13,6 +13,14 @@
 
 #include "os_utils/linux/audit/audit_search_utils.h"
 
+typedef struct _AuditSearchFilter {
+
+    AuditSearchCriteria searchCriteria;
+    const char** messageTypes;
+    uint32_t messageTypesCount;
+
+} AuditSearchFilter;
+
 /**
  * 
  * This is a generic iterator for searcing items in the audit logs using ausearch.
@@ -86,6 +94,18 @@ MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_Init, AuditSearch*, aud
  */
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_InitMultipleSearchCriteria, AuditSearch*, auditSearch, AuditSearchCriteria, searchCriteria, const char**, messageTypes, uint32_t, messageTypesCount, const char*, checkpointFile);
 
+/**
+ * @brief Initiates a new instance of audit search for the events which match any of the given filters.
+ * 
+ * @param   auditSearch         The audit instance we want to initiate.
+ * @param   filters             The array of filters, each with its own search criteria and message types.
+ * @param   filtersCount        Number of elements in the filters array.
+ * @param   checkpointFile      The path to a files which contains the last checkpoint of the search.
+ * 
+ * @return AUDIT_SEARCH_OK on success or an appropriate error. 
+ */
+MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_InitMultipleFilters, AuditSearch*, auditSearch, const AuditSearchFilter*, filters, uint32_t, filtersCount, const char*, checkpointFile);
+
 /**
  * @brief Deinitiate the given audit search instance.
  * 
@@ -99,6 +119,8 @@ MOCKABLE_FUNCTION(, void, AuditSearch_Deinit, AuditSearch*, auditSearch);
  * @param   auditSearch     The search instance.
  * 
  * @return AUDIT_SEARCH_HAS_MORE_DATA in case there is anoteher item, AUDIT_SEARCH_NO_MORE_DATA in case the search has finished or appropriate error. 
+ *         AUDIT_SEARCH_CANCELLED in case the work of the calling thread was cancelled, the checkpoint is then moved
+ *         to the current item only, so the next search resumes from there.
  */
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_GetNext, AuditSearch*, auditSearch);
 
@@ -146,7 +168,7 @@ MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_ReadString, AuditSearch
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_InterpretString, AuditSearch*, auditSearch, const char*, fieldName, const char**, output);
 
 /**
- * @brief Sets the checkoint to the search time.
+ * @brief Sets the checkoint to the end of the search, the position in the audit logs where the search stopped and the search time.
  * 
  * @param   auditSearch     The search instance.
  *
@@ -154,6 +176,29 @@ MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_InterpretString, AuditS
  */
 MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_SetCheckpoint, AuditSearch*, auditSearch);
 
+/**
+ * @brief Writes the given time to a checkpoint file, the next search which uses the file reports the events after that time.
+ *        The events of the second of the given time are reported again rather than lost.
+ * 
+ * @param   checkpointFile  The path to the checkpoint file.
+ * @param   checkpointTime  The time of the checkpoint.
+ *
+ * @return AUDIT_SEARCH_OK on success or an appropriate error. 
+ */
+MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_WriteCheckpoint, const char*, checkpointFile, time_t, checkpointTime);
+
+/**
+ * @brief Seeds a missing checkpoint file from the newest of the given checkpoint files of older versions,
+ *        which are removed once the checkpoint file exists, so the first search does not report their events again.
+ * 
+ * @param   checkpointFile              The path to the checkpoint file.
+ * @param   legacyCheckpointFiles       The paths to the checkpoint files of older versions.
+ * @param   legacyCheckpointFilesCount  The number of the checkpoint files of older versions.
+ *
+ * @return AUDIT_SEARCH_OK on success, or when there is nothing to seed, otherwise an appropriate error. 
+ */
+MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearch_MergeCheckpoints, const char*, checkpointFile, const char**, legacyCheckpointFiles, uint32_t, legacyCheckpointFilesCount);
+
 /**
  * @brief log all re records of the current event.
  * 
@@ -11,15 +11,78 @@
 #include "macro_utils.h"
 #include "umock_c_prod.h"
 
+#include "os_utils/linux/audit/audit_log_reader.h"
 #include "os_utils/process_info_handler.h"
 
+/**
+ * The checkpoint of a search, kept in the checkpoint file.
+ * The next search resumes the audit logs from the position, the time is used instead when the position is lost,
+ * and along with it when the search was cancelled and the events up to that time were reported already.
+ */
+typedef struct _AuditSearchCheckpoint {
+
+    time_t time;
+    AuditLogPosition position;
+    bool isTimeBound;
+
+} AuditSearchCheckpoint;
+
+#define AUDIT_SEARCH_INDEX_MAX_RECORDS 32
+#define AUDIT_SEARCH_INDEX_MAX_FIELDS 256
+#define AUDIT_SEARCH_INDEX_BUCKETS 512
+
+typedef struct _AuditSearchIndexField {
+
+    const char* name;
+    uint16_t recordNumber;
+    uint16_t fieldNumber;
+    // the next field with the same name, in a later record, -1 if there is none
+    int16_t next;
+
+} AuditSearchIndexField;
+
+typedef struct _AuditSearchIndexBucket {
+
+    // the first and the last fields with the name of the bucket, -1 for an empty bucket
+    int16_t first;
+    int16_t last;
+
+} AuditSearchIndexBucket;
+
+/**
+ * The index of the records and the fields of the current event.
+ *
+ * The index is built once per event, on the first lookup of a record or a field, and maps the record types
+ * and the field names to their positions, so the lookups do not walk the records of the event again.
+ * An event which exceeds the capacity of the index is indexed partially and the rest of it is looked up by auparse.
+ */
+typedef struct _AuditSearchIndex {
+
+    bool isBuilt;
+    bool isComplete;
+    uint32_t currentRecord;
+    uint32_t recordsCount;
+    int recordTypes[AUDIT_SEARCH_INDEX_MAX_RECORDS];
+    uint32_t fieldsCount;
+    AuditSearchIndexField fields[AUDIT_SEARCH_INDEX_MAX_FIELDS];
+    AuditSearchIndexBucket buckets[AUDIT_SEARCH_INDEX_BUCKETS];
+
+} AuditSearchIndex;
+
 typedef struct _AuditSearch {
 
     auparse_state_t* audit;
     char* checkpointFile;
     time_t searchTime;
     bool firstSearch;
+    bool keepCheckpoint;
     ProcessInfo processInfo;
+    // the active audit log, as configured for auditd
+    char logFile[AUDIT_LOG_READER_MAX_PATH];
+    AuditLogReader logReader;
+    AuditLogPosition startPosition;
+    AuditSearchCheckpoint checkpoint;
+    AuditSearchIndex index;
 
 } AuditSearch;
 
@@ -31,6 +94,7 @@ typedef enum _AuditSearchResultValues {
     AUDIT_SEARCH_NO_DATA,
     AUDIT_SEARCH_FIELD_DOES_NOT_EXIST,
     AUDIT_SEARCH_RECORD_DOES_NOT_EXIST,
+    AUDIT_SEARCH_CANCELLED,
     AUDIT_SEARCH_EXCEPTION
     
 } AuditSearchResultValues;
@@ -40,6 +104,28 @@ typedef enum _AuditSearchCriteria {
     AUDIT_SEARCH_CRITERIA_SYSCALL
 } AuditSearchCriteria;
 
+/**
+ * @brief Sets the search to point to the given record of its current event, the fields are read from this record onwards.
+ * 
+ * @param auditSearch   The search instance.
+ * @param recordNumber  The number of the record in the event, starting from 0.
+ * 
+ * @return AUDIT_SEARCH_OK on success, AUDIT_SEARCH_NO_DATA if the event does not have such a record or AUDIT_SEARCH_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearchUtils_GotoRecord, AuditSearch*, auditSearch, uint32_t, recordNumber);
+
+/**
+ * @brief Finds the first record with the given type in the current event of the search.
+ * 
+ * @param auditSearch   The search instance.
+ * @param recordType    The type of the wanted record.
+ * @param recordNumber  Out param. The number of the record in the event.
+ * 
+ * @return AUDIT_SEARCH_OK on success, AUDIT_SEARCH_RECORD_DOES_NOT_EXIST if the event does not contain a record
+ *         with the wanted type or AUDIT_SEARCH_EXCEPTION otherwise.
+ */
+MOCKABLE_FUNCTION(, AuditSearchResultValues, AuditSearchUtils_FindRecord, AuditSearch*, auditSearch, int, recordType, uint32_t*, recordNumber);
+
 /**
  * @brief Reads the givn field from the current search record as integer.
  * 
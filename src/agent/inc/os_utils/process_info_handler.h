@@ -12,7 +12,9 @@
 
 typedef struct _ProcessInfo {
 
+    // the effective user id of the process before any thread changed to root
     uid_t effectiveUid;
+    // whether this holder took a share of the root privileges
     bool wasSet;
 
 } ProcessInfo;
@@ -26,6 +28,7 @@ MOCKABLE_FUNCTION(, bool, ProcessInfoHandler_SwitchRealAndEffectiveUsers);
 
 /**
  * @brief Sets the current process privileges to root privileges.
+ *        The privileges are shared by all the threads, they are kept until the last holder resets them.
  * 
  * @param   processInfo     A process info stucrt. This struct should be used in case of reset.
  * 
@@ -34,7 +37,8 @@ MOCKABLE_FUNCTION(, bool, ProcessInfoHandler_SwitchRealAndEffectiveUsers);
 MOCKABLE_FUNCTION(, bool, ProcessInfoHandler_ChangeToRoot, ProcessInfo*, processInfo);
 
 /**
- * @brief Reset the process privileges to its origin.
+ * @brief Releases the root privileges of the holder, the process privileges are reset to their origin
+ *        once no other holder needs them.
  * 
  * @param   processInfo     A process info stucrt. The same one that was used in the ChangeToRoot function.
  * 
@@ -32,11 +32,33 @@ typedef struct _QueueItem
 {
     void* data;
     uint32_t dataSize;
+    uint32_t tag;
     void* nextItem;
     void* prevItem; 
     
 } QueueItem;
 
+/**
+ * The tag of an item which was pushed without one
+ */
+#define QUEUE_NO_TAG UINT32_MAX
+
+/**
+ * The memory charged for every item on top of its data, a list item and a pointer to it.
+ * Every queue backend charges the same, so the memory budget does not depend on the backend.
+ */
+#define QUEUE_ITEM_MEMORY_OVERHEAD (sizeof(QueueItem) + sizeof(QueueItem*))
+
+/**
+ * An item taken out of the queue by a batch pop
+ */
+typedef struct _QueueBatchItem
+{
+    void* data;
+    uint32_t dataSize;
+
+} QueueBatchItem;
+
 /**
  * A queue struct
  */
@@ -46,6 +68,7 @@ typedef struct _Queue
     QueueItem* lastItem;
     uint32_t numberOfElements;
     bool shouldSendLogs;
+    bool shouldCountDrops;
     SyncedCounter counter;
 } Queue;
 
@@ -83,10 +106,11 @@ MOCKABLE_FUNCTION(, void, Queue_Deinit, Queue*, queue);
  * @param   queue       The queue to push to
  * @param   data        The data to push to the queue
  * @param   dataSize    The size of the data we push into the queue
+ * @param   tag         A value which is kept along with the item (e.g. its type), QUEUE_NO_TAG for none
  * 
  * @return QUEUE_OK on success or an error code upon failure.
  */
-MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, data, uint32_t, dataSize);
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, data, uint32_t, dataSize, uint32_t, tag);
 
 /**
  * Pops an item from the beginning of the queue
@@ -94,10 +118,11 @@ MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, dat
  * @param   queue     The queue to push to
  * @param   data      out param containing the data of the item that was poped from the queue
  * @param   dataSize  out param containing the size of the data that was poped from the queue
+ * @param   tag       out param containing the tag the item was pushed with, may be NULL
  * 
  * @return QUEUE_OK on success or an error code upon failure.
  */
- MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopFront, Queue*, queue, void**, data, uint32_t*, dataSize);
+ MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopFront, Queue*, queue, void**, data, uint32_t*, dataSize, uint32_t*, tag);
 
 /**
  * Pops an item from the beginning of the queue only if the condition erturns true on this item.
@@ -112,6 +137,22 @@ MOCKABLE_FUNCTION(, QueueResultValues, Queue_PushBack, Queue*, queue, void*, dat
  */
 MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopFrontIf, Queue*, queue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
 
+/**
+ * Pops items from the beginning of the queue as long as their accumulated size stays below the byte budget.
+ * 
+ * @param   queue           The queue to pop from
+ * @param   byteBudget      The items are popped while the sum of their sizes is smaller than this budget.
+ * @param   itemOverhead    The amount of bytes added to the size of every item when checking the budget,
+ *                          e.g. the separator the item is going to be written with.
+ * @param   maxItems        The maximum number of items to pop, the capacity of the items array.
+ * @param   items           out param, the array which is filled with the popped items
+ * @param   itemsCount      out param, the number of items that were popped
+ * 
+ * @return QUEUE_OK if at least one item was popped, QUEUE_IS_EMPTY if the queue is empty
+ *         or QUEUE_CONDITION_FAILED if the first item does not fit the budget.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, Queue_PopFrontBatch, Queue*, queue, uint32_t, byteBudget, uint32_t, itemOverhead, uint32_t, maxItems, QueueBatchItem*, items, uint32_t*, itemsCount);
+
 /**
  * @brief returns the queue size
  * 
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef RING_BUFFER_QUEUE_H
+#define RING_BUFFER_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include "agent_telemetry_counters.h"
+#include "queue.h"
+
+/**
+ * A single preallocated slot of the ring buffer.
+ * The sequence number tells whether the slot is free for the producer of a given position
+ * (sequence == position) or holds an item ready for the consumer (sequence == position + 1).
+ */
+typedef struct _RingBufferQueueSlot {
+
+    uint32_t sequence;
+    void* data;
+    uint32_t dataSize;
+    uint32_t tag;
+
+} RingBufferQueueSlot;
+
+/**
+ * A bounded lock-free multi producer single consumer queue.
+ * Any number of threads may push concurrently, pops must be done by a single thread at a time.
+ */
+typedef struct _RingBufferQueue {
+
+    RingBufferQueueSlot* slots;
+    uint32_t capacity;
+    uint32_t mask;
+    uint32_t enqueuePosition;
+    uint32_t dequeuePosition;
+    // the number of published items, slots which were claimed but not published yet are not counted
+    uint32_t count;
+    bool shouldSendLogs;
+    bool shouldCountDrops;
+    SyncedCounter counter;
+
+} RingBufferQueue;
+
+/**
+ * @brief initiates the given queue and preallocates its slots.
+ *
+ * @param   queue               The queue to initiate.
+ * @param   shouldSendLogs      Whether the queue should send out logs.
+ * @param   capacity            The number of slots, rounded up to the next power of two.
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_Init, RingBufferQueue*, queue, bool, shouldSendLogs, uint32_t, capacity);
+
+/**
+ * @brief deinitiate the given queue (free its slots and the data left in them).
+ *
+ * @param   queue   The queue to deinitiate
+ */
+MOCKABLE_FUNCTION(, void, RingBufferQueue_Deinit, RingBufferQueue*, queue);
+
+/**
+ * @brief push an item to the end of the queue. Safe to call from multiple threads.
+ *
+ * @param   queue       The queue to push to
+ * @param   data        The data to push to the queue
+ * @param   dataSize    The size of the data we push into the queue
+ * @param   tag         A value which is kept along with the item (e.g. its type), QUEUE_NO_TAG for none
+ *
+ * @return QUEUE_OK on success, QUEUE_MAX_MEMORY_EXCEEDED if the memory limit was reached or the queue is full.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_PushBack, RingBufferQueue*, queue, void*, data, uint32_t, dataSize, uint32_t, tag);
+
+/**
+ * @brief Pops an item from the beginning of the queue. Must be called from the consumer thread only.
+ *
+ * @param   queue     The queue to pop from
+ * @param   data      out param containing the data of the item that was poped from the queue
+ * @param   dataSize  out param containing the size of the data that was poped from the queue
+ * @param   tag       out param containing the tag the item was pushed with, may be NULL
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_PopFront, RingBufferQueue*, queue, void**, data, uint32_t*, dataSize, uint32_t*, tag);
+
+/**
+ * @brief Pops an item from the beginning of the queue only if the condition returns true on this item.
+ *        Must be called from the consumer thread only.
+ *
+ * @param   queue               The queue to pop from
+ * @param   condition           A condition for poping the elements from the queue.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   data                out param containing the data of the item that was poped from the queue
+ * @param   dataSize            out param containing the size of the data that was poped from the queue
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_PopFrontIf, RingBufferQueue*, queue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
+
+/**
+ * @brief Pops items from the beginning of the queue as long as their accumulated size stays below the byte budget.
+ *        Must be called from the consumer thread only.
+ *
+ * @param   queue           The queue to pop from
+ * @param   byteBudget      The items are popped while the sum of their sizes is smaller than this budget.
+ * @param   itemOverhead    The amount of bytes added to the size of every item when checking the budget,
+ *                          e.g. the separator the item is going to be written with.
+ * @param   maxItems        The maximum number of items to pop, the capacity of the items array.
+ * @param   items           out param, the array which is filled with the popped items
+ * @param   itemsCount      out param, the number of items that were popped
+ *
+ * @return QUEUE_OK if at least one item was popped, QUEUE_IS_EMPTY if the queue is empty
+ *         or QUEUE_CONDITION_FAILED if the first item does not fit the budget.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_PopFrontBatch, RingBufferQueue*, queue, uint32_t, byteBudget, uint32_t, itemOverhead, uint32_t, maxItems, QueueBatchItem*, items, uint32_t*, itemsCount);
+
+/**
+ * @brief returns the number of published items in the queue. The value is a snapshot and may change concurrently.
+ *
+ * @param   queue   The queue whom size we want to get
+ * @param   size    Out param. The number of items in the queue.
+ *
+ * @return always returns QUEUE_OK.
+ */
+MOCKABLE_FUNCTION(, QueueResultValues, RingBufferQueue_GetSize, RingBufferQueue*, queue, uint32_t*, size);
+
+#endif //RING_BUFFER_QUEUE_H
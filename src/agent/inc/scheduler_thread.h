@@ -7,10 +7,21 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
 #include "azure_c_shared_utility/threadapi.h"
 
 typedef void (*SchedulerTask)(void* params);
 
+/**
+ * @brief Returns the time to wait before the next execution of the task.
+ * 
+ * @param   params  The parameters of the task.
+ * 
+ * @return the time in milliseconds, 0 to run the task again right away.
+ */
+typedef uint32_t (*SchedulerIntervalFunc)(void* params);
+
 typedef enum _SchedulerThreadState {
     SCHEDULER_THREAD_CREATED,
     SCHEDULER_THREAD_STARTED,
@@ -23,8 +34,12 @@ typedef struct _SchedulerThread {
     uint32_t schedulerInterval;
     SchedulerTask task;
     void* taskParam;
+    SchedulerIntervalFunc intervalFunc;
     bool continueRunning;
     SchedulerThreadState state;
+    LOCK_HANDLE wakeupLock;
+    COND_HANDLE wakeupCondition;
+    bool wakeupRequested;
 
 } SchedulerThread;
 
@@ -47,6 +62,15 @@ bool SchedulerThread_Init(SchedulerThread* scheduler, uint32_t schedulerInterval
  */
 void SchedulerThread_Deinit(SchedulerThread* scheduler);
 
+/**
+ * @brief Lets the task decide how long to wait before its next execution instead of the fixed scheduler interval,
+ *        e.g. until its next timer expires. Must be called before the scheduler is started.
+ * 
+ * @param   scheduler       The scheduler instance.
+ * @param   intervalFunc    The function which returns the time to wait, NULL for the fixed interval.
+ */
+void SchedulerThread_SetIntervalFunc(SchedulerThread* scheduler, SchedulerIntervalFunc intervalFunc);
+
 /**
  * @brief Starts the scheduler.
  * 
@@ -63,6 +87,14 @@ bool SchedulerThread_Start(SchedulerThread* scheduler);
  */
 void SchedulerThread_Stop(SchedulerThread* scheduler);
 
+/**
+ * @brief Wakes the scheduler up so the task runs without waiting for the rest of the interval.
+ *        Safe to call from any thread, wakeups which arrive before the task runs are coalesced.
+ * 
+ * @param   scheduler   The scheduler instance.
+ */
+void SchedulerThread_Wakeup(SchedulerThread* scheduler);
+
 /**
  * @brief returns the state of the thread (e.g. created\started\stopped).
  * 
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef SPILL_LOG_H
+#define SPILL_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/lock.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+typedef enum _SpillLogResultValues {
+
+    SPILL_LOG_OK,
+    SPILL_LOG_FULL,
+    SPILL_LOG_IS_EMPTY,
+    SPILL_LOG_EXCEPTION
+
+} SpillLogResultValues;
+
+/**
+ * A log of records kept in a memory-mapped file.
+ * Each record is stored as its size and tag followed by its data. Records are read back in the order they were
+ * appended. A record which does not fit the end of the file wraps around to its beginning, into the space
+ * of the records which were already read.
+ * The space of the file is reserved upfront so writing to the mapping never hits a full disk.
+ */
+typedef struct _SpillLog {
+
+    char* path;
+    int fileDescriptor;
+    uint8_t* segment;
+    uint32_t segmentSize;
+    uint32_t writeOffset;
+    uint32_t readOffset;
+    // set once the writing wrapped around to the beginning of the file ahead of the reading,
+    // the records which were written before that end at wrapOffset
+    bool isWrapped;
+    uint32_t wrapOffset;
+    uint32_t numberOfRecords;
+    LOCK_HANDLE lock;
+
+} SpillLog;
+
+/**
+ * @brief Creates the backing file of the log and maps it to memory.
+ *        An existing file is reused only if it is a regular file owned by the agent which other users can not access.
+ *
+ * @param   spillLog    The instance to initiate.
+ * @param   directory   The directory in which the backing file is created.
+ * @param   name        The name of the log, the backing file is named <name>.spill
+ * @param   maxSize     The size of the backing file in bytes, records are dropped once it is full.
+ *
+ * @return SPILL_LOG_OK on success or SPILL_LOG_EXCEPTION upon failure.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Init, SpillLog*, spillLog, const char*, directory, const char*, name, uint32_t, maxSize);
+
+/**
+ * @brief Unmaps the log and deletes its backing file, records which were not read are discarded.
+ *
+ * @param   spillLog    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, SpillLog_Deinit, SpillLog*, spillLog);
+
+/**
+ * @brief Appends a copy of the given data to the end of the log.
+ *
+ * @param   spillLog    The log to append to.
+ * @param   data        The data to append.
+ * @param   dataSize    The size of the data.
+ * @param   tag         A value which is kept along with the record (e.g. its type).
+ *
+ * @return SPILL_LOG_OK on success, SPILL_LOG_FULL if there is no room left for the record.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Append, SpillLog*, spillLog, const void*, data, uint32_t, dataSize, uint32_t, tag);
+
+/**
+ * @brief Copies the oldest record of the log without removing it.
+ *
+ * @param   spillLog    The log to read from.
+ * @param   data        Out param, a newly allocated copy of the record followed by a null byte. The caller must free it.
+ * @param   dataSize    Out param, the size of the record.
+ * @param   tag         Out param, the tag the record was appended with.
+ *
+ * @return SPILL_LOG_OK on success, SPILL_LOG_IS_EMPTY if there are no records or SPILL_LOG_EXCEPTION upon failure.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Peek, SpillLog*, spillLog, void**, data, uint32_t*, dataSize, uint32_t*, tag);
+
+/**
+ * @brief Removes the oldest record of the log.
+ *
+ * @param   spillLog    The log to remove from.
+ *
+ * @return SPILL_LOG_OK on success, SPILL_LOG_IS_EMPTY if there are no records.
+ */
+MOCKABLE_FUNCTION(, SpillLogResultValues, SpillLog_Remove, SpillLog*, spillLog);
+
+/**
+ * @brief Returns the number of records in the log. The value is a snapshot and may change concurrently.
+ *
+ * @param   spillLog    The log.
+ *
+ * @return the number of records.
+ */
+MOCKABLE_FUNCTION(, uint32_t, SpillLog_GetCount, SpillLog*, spillLog);
+
+#endif //SPILL_LOG_H
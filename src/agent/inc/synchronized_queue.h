@@ -11,6 +11,8 @@
 #include "umock_c_prod.h"
 
 #include "queue.h"
+#include "ring_buffer_queue.h"
+#include "spill_log.h"
 
 typedef enum _SyncQueueResultValues {
 
@@ -18,11 +20,61 @@ typedef enum _SyncQueueResultValues {
     
 } SyncQueueResultValues;
 
+/**
+ * The backend which holds the items of a synchronized queue
+ */
+typedef enum _SyncQueueType {
+
+    SYNC_QUEUE_LINKED_LIST,     // unbounded linked list guarded by a lock
+    SYNC_QUEUE_RING_BUFFER      // bounded lock-free ring buffer, multiple producers and a single consumer
+
+} SyncQueueType;
+
+/**
+ * @brief A callback which is called after a push leaves the queue holding at least the notification watermark.
+ * 
+ * @param   context     The context which was given upon registration.
+ */
+typedef void (*SyncQueueNotification)(void* context);
+
+/**
+ * @brief A callback which is called for every item that was evicted to make room for a pushed item.
+ *        The item is freed by the queue once the callback returns.
+ * 
+ * @param   context     The context which was given upon registration.
+ * @param   data        The evicted item.
+ * @param   dataSize    The size of the evicted item.
+ * @param   tag         The tag the evicted item was pushed with.
+ */
+typedef void (*SyncQueueEvictionCallback)(void* context, const void* data, uint32_t dataSize, uint32_t tag);
+
 typedef struct _SyncQueue {
 
+    SyncQueueType type;
     Queue queue; 
+    RingBufferQueue ringBufferQueue;
     LOCK_HANDLE lock;
 
+    uint32_t bytesInQueue;
+    uint32_t notificationWatermark;
+    SyncQueueNotification notification;
+    void* notificationContext;
+
+    bool spillEnabled;
+    SpillLog spillLog;
+
+    struct _SyncQueue* evictionQueue;
+    SyncQueueEvictionCallback evictionCallback;
+    void* evictionContext;
+    bool evictionEnabled;
+
+    uint32_t memoryBudget;
+    uint32_t memoryBudgetConsumed;
+
+    // items the consumer returned to the front of the queue, popped before the items of the backend
+    QueueItem* returnedItems;
+    uint32_t returnedItemsCount;
+
 } SyncQueue;
 
 /**
@@ -35,6 +87,18 @@ typedef struct _SyncQueue {
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_Init, SyncQueue*, syncQueue, bool, shouldSendLogs);
 
+/**
+ * @brief Initiate the queue with a preallocated lock-free ring buffer backend.
+ *        Pushing may be done from any thread, popping must be done from a single consumer thread.
+ * 
+ * @param   syncQueue           The instance to initiate.
+ * @param   shouldSendLogs      Whether this instance should send out logs.
+ * @param   capacity            The maximal number of items the queue can hold.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_InitRingBuffer, SyncQueue*, syncQueue, bool, shouldSendLogs, uint32_t, capacity);
+
 /**
  * @brief Deinitiate the given queue and free it memory
  * 
@@ -42,6 +106,53 @@ MOCKABLE_FUNCTION(, int, SyncQueue_Init, SyncQueue*, syncQueue, bool, shouldSend
  */
 MOCKABLE_FUNCTION(, void, SyncQueue_Deinit, SyncQueue*, syncQueue);
 
+/**
+ * @brief Spills the items which exceed the memory budget of the queue to a memory-mapped log on disk.
+ *        Once an item was spilled the following items are spilled as well, the spilled items are
+ *        moved back to the queue in batches and in their original order whenever its in-memory backend runs low.
+ * 
+ * @param   syncQueue   The instance to enable spilling for.
+ * @param   directory   The directory of the spill log.
+ * @param   name        The name of the spill log, unique per queue.
+ * @param   maxSize     The maximal size of the spill log in bytes.
+ * 
+ * @return QUEUE_OK on success or QUEUE_MEMORY_EXCEPTION if the spill log could not be created.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_EnableSpill, SyncQueue*, syncQueue, const char*, directory, const char*, name, uint32_t, maxSize);
+
+/**
+ * @brief Limits the memory the in-memory backend of the queue may take out of the shared memory limitation,
+ *        so a single queue can not starve the others. Must be called before the queue is used.
+ * 
+ * @param   syncQueue       The queue to limit.
+ * @param   maxSizeInBytes  The maximal number of bytes the queue holds in memory, including the bookkeeping of its items,
+ *                          0 for no limitation of its own.
+ */
+MOCKABLE_FUNCTION(, void, SyncQueue_SetMemoryBudget, SyncQueue*, syncQueue, uint32_t, maxSizeInBytes);
+
+/**
+ * @brief Sets the queue whose oldest items are evicted when a push to this queue exceeds the memory budget.
+ *        Eviction starts disabled, see SyncQueue_SetEvictionEnabled. Must be called before the queues are used.
+ *        Popping from a ring buffer eviction queue is serialized with a lock from now on, since the pushing
+ *        threads of this queue become its consumers as well.
+ * 
+ * @param   syncQueue       The queue which makes room for its items.
+ * @param   evictionQueue   The queue to evict items from.
+ * @param   onEvicted       A callback which is called for every evicted item, may be NULL.
+ * @param   context         The context to pass to the callback.
+ * 
+ * @return QUEUE_OK on success or SYNC_QUEUE_LOCK_EXCEPTION upon failure.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_SetEvictionQueue, SyncQueue*, syncQueue, SyncQueue*, evictionQueue, SyncQueueEvictionCallback, onEvicted, void*, context);
+
+/**
+ * @brief Enables or disables evicting items from the eviction queue (e.g. after a configuration change).
+ * 
+ * @param   syncQueue   The queue which makes room for its items.
+ * @param   enabled     Whether a push which exceeds the memory budget should evict items.
+ */
+MOCKABLE_FUNCTION(, void, SyncQueue_SetEvictionEnabled, SyncQueue*, syncQueue, bool, enabled);
+
 /**
  * @brief Push an item to the end of the queue
  * 
@@ -49,10 +160,39 @@ MOCKABLE_FUNCTION(, void, SyncQueue_Deinit, SyncQueue*, syncQueue);
  * @param   data        The data to push to the end of the queue.
  * @param   dataSize    The size of the data we want ot push to the queue.
  * 
- * @return QUEUE_OK on success or an error code upon failure.
+ * @return QUEUE_OK on success or an error code upon failure. If the item was spilled to disk the queue frees data.
+ *         If eviction is enabled and the item can be neither kept in memory nor spilled, the oldest items
+ *         of the eviction queue are dropped until the item fits the memory budget.
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_PushBack, SyncQueue*, syncQueue, void*, data, uint32_t, dataSize);
 
+/**
+ * @brief Push an item to the end of the queue along with a tag, which is handed to the eviction callback
+ *        if the item is evicted later on.
+ * 
+ * @param   syncQueue   The instance to push the item to.
+ * @param   data        The data to push to the end of the queue.
+ * @param   dataSize    The size of the data we want ot push to the queue.
+ * @param   tag         A value which is kept along with the item (e.g. its type), QUEUE_NO_TAG for none.
+ * 
+ * @return the same as SyncQueue_PushBack.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PushBackTagged, SyncQueue*, syncQueue, void*, data, uint32_t, dataSize, uint32_t, tag);
+
+/**
+ * @brief Returns items which the consumer popped to the front of the queue, ahead of all the other items
+ *        and in the given order. The items were accounted for when they were first pushed, so they are not
+ *        charged against the memory limitation again, never spilled nor evicted, and are not dropped for lack of memory.
+ *        Must be called from a consumer of the queue.
+ * 
+ * @param   syncQueue   The queue the items were popped from.
+ * @param   items       The items to return, the queue takes ownership of their data on success.
+ * @param   itemsCount  The number of items.
+ * 
+ * @return QUEUE_OK on success, or an error code upon failure in which case none of the items was returned.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PushFront, SyncQueue*, syncQueue, QueueBatchItem*, items, uint32_t, itemsCount);
+
 /**
  * @brief Pops an item from the beginning of the queue
  * 
@@ -77,14 +217,59 @@ MOCKABLE_FUNCTION(, int, SyncQueue_PopFront, SyncQueue*, syncQueue, void**, data
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_PopFrontIf, SyncQueue*, syncQueue, QueuePopCondition, condition, void*, conditionParams, void**, data, uint32_t*, dataSize);
 
+/**
+ * Pops as many items from the beginning of the queue as fit the byte budget, under a single lock acquisition.
+ * 
+ * @param   syncQueue       The queue to pop from
+ * @param   byteBudget      The items are popped while the sum of their sizes is smaller than this budget.
+ * @param   itemOverhead    The amount of bytes added to the size of every item when checking the budget,
+ *                          e.g. the separator the item is going to be written with.
+ * @param   maxItems        The maximum number of items to pop, the capacity of the items array.
+ * @param   items           out param, the array which is filled with the popped items
+ * @param   itemsCount      out param, the number of items that were popped
+ * 
+ * @return QUEUE_OK if at least one item was popped, QUEUE_IS_EMPTY if the queue is empty
+ *         or QUEUE_CONDITION_FAILED if the first item does not fit the budget.
+ */
+MOCKABLE_FUNCTION(, int, SyncQueue_PopFrontBatch, SyncQueue*, syncQueue, uint32_t, byteBudget, uint32_t, itemOverhead, uint32_t, maxItems, QueueBatchItem*, items, uint32_t*, itemsCount);
+
 /**
  * @brief Returns the queue size
  * 
  * @param   syncQueue   The queue whom size we want to get.
- * @param   size        Out param. The size of the queue.
+ * @param   size        Out param. The size of the queue, including the items which were spilled to disk
+ *                      and the items which were returned to its front.
  * 
  * @return always return QUEUE_OK.
  */
 MOCKABLE_FUNCTION(, int, SyncQueue_GetSize, SyncQueue*, syncQueue, uint32_t*, size);
 
+/**
+ * @brief Registers a callback which is called whenever a push leaves at least byteWatermark bytes in the queue.
+ *        The callback runs on the pushing thread and should only signal the consumer.
+ * 
+ * @param   syncQueue       The queue to watch.
+ * @param   byteWatermark   The number of queued bytes which triggers the notification.
+ * @param   notification    The callback, NULL to stop the notifications.
+ * @param   context         The context to pass to the callback.
+ */
+MOCKABLE_FUNCTION(, void, SyncQueue_SetNotification, SyncQueue*, syncQueue, uint32_t, byteWatermark, SyncQueueNotification, notification, void*, context);
+
+/**
+ * @brief Updates the watermark of an already registered notification (e.g. after a configuration change).
+ * 
+ * @param   syncQueue       The queue to watch.
+ * @param   byteWatermark   The number of queued bytes which triggers the notification.
+ */
+MOCKABLE_FUNCTION(, void, SyncQueue_SetNotificationWatermark, SyncQueue*, syncQueue, uint32_t, byteWatermark);
+
+/**
+ * @brief Returns the telemetry counter of the queue
+ * 
+ * @param   syncQueue   The queue whom counter we want to get.
+ * 
+ * @return the counter of the underlying queue.
+ */
+MOCKABLE_FUNCTION(, SyncedCounter*, SyncQueue_GetCounter, SyncQueue*, syncQueue);
+
 #endif //SYNCHRONIZED_QUEUE_H
\ No newline at end of file
@@ -5,17 +5,75 @@
 #define EVENT_MONITOR_TASK_H
 
 #include <stdbool.h>
-#include <time.h>
+#include <stdint.h>
 
+#include "cancellation.h"
+#include "collectors/collector.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
+#include "os_utils/linux/audit/audit_feed.h"
 #include "synchronized_queue.h"
+#include "timer_wheel.h"
+#include "twin_configuration_defs.h"
+#include "worker_pool.h"
+
+#define EVENT_MONITOR_TASK_MAX_COLLECTORS 16
+#define EVENT_MONITOR_TASK_PERIODIC_WORKERS 2
+#define EVENT_MONITOR_TASK_TRIGGERED_WORKERS 1
+
+struct _EventMonitorTask;
+struct _EventMonitorTaskAuditCollectorDefinition;
+
+/**
+ * A single collector and its timer.
+ * Collectors which share a collect function share the in-flight flag of the first of them,
+ * so a collect function never runs concurrently with itself.
+ * A run is cancelled once it exceeds the collector time budget.
+ * Audit collectors share a single search of the audit logs, run by the first of them on the shortest of their intervals.
+ * While the audit feed runs that search is skipped and the run only flushes what the feed collected.
+ */
+typedef struct _EventMonitorTaskCollector {
+
+    struct _EventMonitorTask* task;
+    const char* name;
+    TwinConfigurationEventType eventType;
+    EventCollectorFunc collectFunction;
+    bool isPeriodic;
+    uint32_t configuredInterval;
+    uint32_t interval;
+    TimerWheelEntry timer;
+    bool inFlight;
+    struct _EventMonitorTaskCollector* inFlightGuard;
+    CancellationToken cancellation;
+    uint32_t timeBudget;
+    bool running;
+    bool overrunReported;
+    const struct _EventMonitorTaskAuditCollectorDefinition* audit;
+
+} EventMonitorTaskCollector;
 
 typedef struct _EventMonitorTask {
-    
+
     SyncQueue* operationalEventsQueue;
     SyncQueue* highPriorityQueue;
     SyncQueue* lowPriorityQueue;
-    time_t lastPeriodicExecution;
-    time_t lastTriggeredExecution;
+    TimerWheel timerWheel;
+    WorkerPool periodicWorkers;
+    WorkerPool triggeredWorkers;
+    EventMonitorTaskCollector collectors[EVENT_MONITOR_TASK_MAX_COLLECTORS];
+    uint32_t collectorsCount;
+    uint32_t jitterPercentage;
+    uint32_t collectorTimeBudget;
+    unsigned int randomSeed;
+    AuditDispatcher auditDispatcher;
+    EventMonitorTaskCollector* auditLead;
+    AuditFeed auditFeed;
+    bool auditFeedStarted;
+    bool isAuditFed;
+    bool auditExclusionsApplied;
+    // the audit exclusions which were last applied
+    char* appliedAuditExcludedExecutables;
+    char* appliedAuditExcludedUids;
+    char* appliedAuditExcludedAuidRanges;
 
 } EventMonitorTask;
 
@@ -32,12 +90,25 @@ typedef struct _EventMonitorTask {
 bool EventMonitorTask_Init(EventMonitorTask* task, SyncQueue* highPriorityQueue, SyncQueue* lowPriorityQueue, SyncQueue* operationalEventsQueue);
 
 /**
- * @brief Executes the given task.
+ * @brief Executes the given task, hands every collector whose timer expired to the workers.
+ *        Triggered collectors have workers of their own, so periodic collectors can not delay them.
+ *        Runs which exceeded the collector time budget are cancelled and reported.
+ *        Audit collectors go back to the audit log search once the audit feed stops.
+ *        The audit exclusions of the twin are applied on the first execution and whenever they change.
  * 
  * @param   task    The instance of the task to execute.
  */
 void EventMonitorTask_Execute(EventMonitorTask* task);
 
+/**
+ * @brief Returns the time until the next collector is due or the next running collector exceeds its time budget.
+ * 
+ * @param   task    The instance of the task.
+ * 
+ * @return the time to wait in milliseconds.
+ */
+uint32_t EventMonitorTask_GetTimeToNextExecution(EventMonitorTask* task);
+
 /**
  * @brief Deinitiates the task
  * 
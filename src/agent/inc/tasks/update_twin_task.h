@@ -25,10 +25,19 @@ typedef struct _UpdateTwinTaskItem {
 
 } UpdateTwinTaskItem;
 
+/**
+ * @brief A callback which is called after a twin update was applied to the configuration.
+ * 
+ * @param   context     The context which was given upon registration.
+ */
+typedef void (*UpdateTwinTaskConfigurationListener)(void* context);
+
 typedef struct _UpdateTwinTask {
 
     SyncQueue* updateQueue;
     IoTHubAdapter* iothubClient;
+    UpdateTwinTaskConfigurationListener configurationListener;
+    void* configurationListenerContext;
 
 } UpdateTwinTask;
 
@@ -43,6 +52,15 @@ typedef struct _UpdateTwinTask {
  */
 MOCKABLE_FUNCTION(, bool, UpdateTwinTask_Init, UpdateTwinTask*, task, SyncQueue*, updateQueue, IoTHubAdapter*, client);
 
+/**
+ * @brief Sets a listener which is notified whenever the twin configuration changes.
+ * 
+ * @param   task        The task instance.
+ * @param   listener    The callback to call, NULL to remove the listener.
+ * @param   context     The context to pass to the callback.
+ */
+MOCKABLE_FUNCTION(, void, UpdateTwinTask_SetConfigurationListener, UpdateTwinTask*, task, UpdateTwinTaskConfigurationListener, listener, void*, context);
+
 /**
  * @brief Initiates the twin task itemfrom a given payload.
  * 
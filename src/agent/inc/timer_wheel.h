@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_NUMBER_OF_SLOTS 256
+
+/**
+ * @brief A callback which is called once the timer of an entry expires.
+ *        The entry is no longer scheduled when the callback runs, so it may schedule itself again,
+ *        but it must not schedule or cancel any other entry of the wheel.
+ *
+ * @param   context     The context which was given upon initialization of the entry.
+ */
+typedef void (*TimerWheelCallback)(void* context);
+
+typedef struct _TimerWheelEntry {
+
+    TimerWheelCallback callback;
+    void* context;
+    uint64_t expirationTick;
+    bool isScheduled;
+    struct _TimerWheelEntry* next;
+
+} TimerWheelEntry;
+
+/**
+ * A hashed timer wheel driven by a monotonic millisecond clock.
+ * Entries are hashed to a slot by their expiration tick, so advancing the wheel only visits the slots
+ * of the ticks which passed, regardless of how many entries are scheduled.
+ * The wheel is not thread safe, it should be owned by a single thread.
+ */
+typedef struct _TimerWheel {
+
+    TimerWheelEntry* slots[TIMER_WHEEL_NUMBER_OF_SLOTS];
+    uint32_t tickInMilliseconds;
+    uint64_t currentTick;
+
+} TimerWheel;
+
+/**
+ * @brief Initiates the timer wheel.
+ *
+ * @param   wheel                   The instance to initiate.
+ * @param   tickInMilliseconds      The resolution of the wheel, timers expire on a tick boundary.
+ * @param   now                     The current monotonic time in milliseconds.
+ */
+void TimerWheel_Init(TimerWheel* wheel, uint32_t tickInMilliseconds, uint64_t now);
+
+/**
+ * @brief Initiates a timer entry, the entry is owned by the caller and must outlive its scheduling.
+ *
+ * @param   entry       The entry to initiate.
+ * @param   callback    The callback to call once the timer expires.
+ * @param   context     The context to pass to the callback.
+ */
+void TimerWheel_InitEntry(TimerWheelEntry* entry, TimerWheelCallback callback, void* context);
+
+/**
+ * @brief Schedules the entry to expire after the given delay, relative to the last time the wheel was advanced.
+ *        An entry which is already scheduled is rescheduled.
+ *
+ * @param   wheel       The timer wheel.
+ * @param   entry       The entry to schedule.
+ * @param   delay       The delay in milliseconds, rounded up to a whole tick.
+ */
+void TimerWheel_Schedule(TimerWheel* wheel, TimerWheelEntry* entry, uint32_t delay);
+
+/**
+ * @brief Cancels the given entry, does nothing if the entry is not scheduled.
+ *
+ * @param   wheel       The timer wheel.
+ * @param   entry       The entry to cancel.
+ */
+void TimerWheel_Cancel(TimerWheel* wheel, TimerWheelEntry* entry);
+
+/**
+ * @brief Advances the wheel to the given time and calls the callbacks of all the expired entries.
+ *
+ * @param   wheel       The timer wheel.
+ * @param   now         The current monotonic time in milliseconds.
+ */
+void TimerWheel_Advance(TimerWheel* wheel, uint64_t now);
+
+/**
+ * @brief Returns the time until the next entry expires.
+ *
+ * @param   wheel       The timer wheel.
+ * @param   now         The current monotonic time in milliseconds.
+ *
+ * @return the time in milliseconds until the next expiration, 0 if an entry already expired
+ *         or UINT32_MAX if no entry is scheduled.
+ */
+uint32_t TimerWheel_GetTimeToNextExpiration(TimerWheel* wheel, uint64_t now);
+
+#endif //TIMER_WHEEL_H
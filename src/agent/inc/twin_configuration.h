@@ -87,6 +87,51 @@ MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetHighPriorityMe
  */
 MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetSnapshotFrequency, uint32_t*, snapshotFrequency);
 
+/**
+ * @brief   gets evictLowPriorityEvents from the twin configuration, thread safe
+ * 
+ * @param   evictLowPriorityEvents  out param
+ * 
+ * @return  TWIN_OK                 on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetEvictLowPriorityEvents, bool*, evictLowPriorityEvents);
+
+/**
+ * @brief   gets collectorTimeBudget from the twin configuration, thread safe
+ * 
+ * @param   collectorTimeBudget     out param
+ * 
+ * @return  TWIN_OK                 on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetCollectorTimeBudget, uint32_t*, collectorTimeBudget);
+
+/**
+ * @brief   gets maxPublishedBytesPerCycle from the twin configuration, thread safe
+ * 
+ * @param   maxPublishedBytesPerCycle   out param
+ * 
+ * @return  TWIN_OK                     on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetMaxPublishedBytesPerCycle, uint32_t*, maxPublishedBytesPerCycle);
+
+/**
+ * @brief   gets compressMessages from the twin configuration, thread safe
+ * 
+ * @param   compressMessages    out param
+ * 
+ * @return  TWIN_OK             on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetCompressMessages, bool*, compressMessages);
+
+/**
+ * @brief   gets encodeMessagesAsCbor from the twin configuration, thread safe
+ * 
+ * @param   encodeMessagesAsCbor    out param
+ * 
+ * @return  TWIN_OK                 on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetEncodeMessagesAsCbor, bool*, encodeMessagesAsCbor);
+
 /**
  * @brief   gets baselineCustomChecksEnabled from the twin configuration, thread safe
  * 
@@ -114,6 +159,33 @@ MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetBaselineCustom
  */
 MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetBaselineCustomChecksFileHash, char**, baselineCustomChecksFileHash);
 
+/**
+ * @brief   gets a copy of auditExcludedExecutables from the twin configuration, thread safe
+ * 
+ * @param   auditExcludedExecutables    out param, NULL if not set, to be freed by the caller
+ * 
+ * @return  TWIN_OK                     on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetAuditExcludedExecutables, char**, auditExcludedExecutables);
+
+/**
+ * @brief   gets a copy of auditExcludedUids from the twin configuration, thread safe
+ * 
+ * @param   auditExcludedUids   out param, NULL if not set, to be freed by the caller
+ * 
+ * @return  TWIN_OK             on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetAuditExcludedUids, char**, auditExcludedUids);
+
+/**
+ * @brief   gets a copy of auditExcludedAuidRanges from the twin configuration, thread safe
+ * 
+ * @param   auditExcludedAuidRanges     out param, NULL if not set, to be freed by the caller
+ * 
+ * @return  TWIN_OK                     on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfiguration_GetAuditExcludedAuidRanges, char**, auditExcludedAuidRanges);
+
 /**
  * @brief   gets serialized twin configuration
  * 
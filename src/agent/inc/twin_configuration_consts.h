@@ -10,6 +10,11 @@ extern const char* HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY;
 extern const char* MAX_LOCAL_CACHE_SIZE_KEY;
 extern const char* MAX_MESSAGE_SIZE_KEY;
 extern const char* SNAPSHOT_FREQUENCY_KEY;
+extern const char* EVICT_LOW_PRIORITY_EVENTS_KEY;
+extern const char* COLLECTOR_TIME_BUDGET_KEY;
+extern const char* MAX_PUBLISHED_BYTES_PER_CYCLE_KEY;
+extern const char* COMPRESS_MESSAGES_KEY;
+extern const char* ENCODE_MESSAGES_AS_CBOR_KEY;
 extern const char* HUB_RESOURCE_ID_KEY;
 extern const char* EVENT_PROPERTIES_KEY;
 
@@ -28,12 +33,23 @@ extern const char* OPERATIONAL_EVENT_KEY;
 /* ===== Event Aggregation Schema =====*/
 extern const char* PROCESS_CREATE_AGGREGATION_ENABLED_KEY;
 extern const char* PROCESS_CREATE_AGGREGATION_INTERVAL_KEY;
+extern const char* PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY;
+extern const char* PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY;
+extern const char* PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY;
 extern const char* CONNECTION_CREATE_AGGREGATION_ENABLED_KEY;
 extern const char* CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY;
+extern const char* CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY;
+extern const char* CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY;
+extern const char* CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY;
 
 /* ===== Baseline custom checks configuration =====*/
 extern const char* BASELINE_CUSTOM_CHECKS_ENABLED_KEY;
 extern const char* BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY;
 extern const char* BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY;
 
+/* ===== Audit exclusions configuration =====*/
+extern const char* AUDIT_EXCLUDED_EXECUTABLES_KEY;
+extern const char* AUDIT_EXCLUDED_UIDS_KEY;
+extern const char* AUDIT_EXCLUDED_AUID_RANGES_KEY;
+
 #endif //TWIN_CONFIGURATION_CONSTS_H
\ No newline at end of file
@@ -33,10 +33,18 @@ typedef struct _TwinConfigurationBundleStatus {
     TwinConfigurationStatus lowPriorityMessageFrequency;
     TwinConfigurationStatus highPriorityMessageFrequency;
     TwinConfigurationStatus snapshotFrequency;
+    TwinConfigurationStatus evictLowPriorityEvents;
+    TwinConfigurationStatus collectorTimeBudget;
+    TwinConfigurationStatus maxPublishedBytesPerCycle;
+    TwinConfigurationStatus compressMessages;
+    TwinConfigurationStatus encodeMessagesAsCbor;
     TwinConfigurationStatus eventPriorities;
     TwinConfigurationStatus baselineCustomChecksEnabled;
     TwinConfigurationStatus baselineCustomChecksFilePath;
     TwinConfigurationStatus baselineCustomChecksFileHash;
+    TwinConfigurationStatus auditExcludedExecutables;
+    TwinConfigurationStatus auditExcludedUids;
+    TwinConfigurationStatus auditExcludedAuidRanges;
  } TwinConfigurationBundleStatus;
 
  typedef enum _TwinConfigurationEventType {
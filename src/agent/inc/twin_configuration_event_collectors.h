@@ -11,6 +11,7 @@
 #include "twin_configuration_defs.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "json/json_object_reader.h"
 #include "json/json_object_writer.h"
@@ -24,6 +25,25 @@ typedef enum _TwinConfigurationEventPriority {
 
 } TwinConfigurationEventPriority;
 
+#define AGGREGATION_KEY_MAX_LENGTH 256
+
+/**
+ * The aggregation key of an event type: the payload fields which aggregated events must agree on,
+ * and the normalizers applied to these fields before events are compared.
+ */
+typedef struct _TwinConfigurationAggregationKey {
+
+    // comma separated top level payload fields, empty to aggregate on the whole payload
+    char fields[AGGREGATION_KEY_MAX_LENGTH];
+    // replace numeric command line arguments with a placeholder
+    bool stripNumericArguments;
+    // replace the rest of a path under /tmp or /var/tmp with a wildcard
+    bool collapseTempPaths;
+    // ports above this one are masked, 0 keeps all ports
+    uint32_t maskPortsAbove;
+
+} TwinConfigurationAggregationKey;
+
 /**
  * @brief initialize the global event priorities configuration with default values
  * 
@@ -84,4 +104,24 @@ MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_Ge
  */
 MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_GetAggregationInterval, TwinConfigurationEventType, eventType, uint32_t*, interval);
 
+/**
+ * @brief Returns the maximal number of distinct payloads aggregated for the wanted event type.
+ * 
+ * @param   eventType   The wanted event type.
+ * @param   maxEntries  Out param. The maximal number of distinct payloads.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_GetAggregationMaxEntries, TwinConfigurationEventType, eventType, uint32_t*, maxEntries);
+
+/**
+ * @brief Returns the aggregation key of the wanted event type.
+ * 
+ * @param   eventType   The wanted event type.
+ * @param   key         Out param. A copy of the aggregation key.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+MOCKABLE_FUNCTION(, TwinConfigurationResult, TwinConfigurationEventCollectors_GetAggregationKey, TwinConfigurationEventType, eventType, TwinConfigurationAggregationKey*, key);
+
 #endif //TWIN_CONFIGURATION_EVENT_COLLECTORS_H
\ No newline at end of file
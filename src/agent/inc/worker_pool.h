@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#define WORKER_POOL_MAX_WORKERS 4
+#define WORKER_POOL_MAX_PENDING_WORK 16
+
+/**
+ * @brief A unit of work which runs on one of the workers of the pool.
+ *
+ * @param   context     The context which was given upon submission.
+ */
+typedef void (*WorkerPoolWorkFunc)(void* context);
+
+typedef struct _WorkerPoolWork {
+
+    WorkerPoolWorkFunc work;
+    void* context;
+
+} WorkerPoolWork;
+
+/**
+ * A bounded pool of worker threads which run the submitted work in submission order.
+ * The pending work is held in a fixed size ring, submitting to a full pool fails instead of growing it.
+ */
+typedef struct _WorkerPool {
+
+    THREAD_HANDLE workers[WORKER_POOL_MAX_WORKERS];
+    uint32_t workersCount;
+    LOCK_HANDLE lock;
+    COND_HANDLE workAvailable;
+    WorkerPoolWork pendingWork[WORKER_POOL_MAX_PENDING_WORK];
+    uint32_t pendingWorkHead;
+    uint32_t pendingWorkCount;
+    bool continueRunning;
+
+} WorkerPool;
+
+/**
+ * @brief Initiates the pool and starts its workers.
+ *
+ * @param   pool            The instance to initiate.
+ * @param   workersCount    The number of workers, at most WORKER_POOL_MAX_WORKERS.
+ *
+ * @return true on success, false otherwise.
+ */
+MOCKABLE_FUNCTION(, bool, WorkerPool_Init, WorkerPool*, pool, uint32_t, workersCount);
+
+/**
+ * @brief Stops the workers and deinitiates the pool.
+ *        Blocks until the work which is already running finishes, pending work which did not start is dropped.
+ *
+ * @param   pool    The instance to deinitiate.
+ */
+MOCKABLE_FUNCTION(, void, WorkerPool_Deinit, WorkerPool*, pool);
+
+/**
+ * @brief Submits work to the pool, safe to call from any thread.
+ *
+ * @param   pool        The pool.
+ * @param   work        The work to run.
+ * @param   context     The context to pass to the work.
+ *
+ * @return true if the work was submitted, false if the pool is full or stopped.
+ */
+MOCKABLE_FUNCTION(, bool, WorkerPool_Submit, WorkerPool*, pool, WorkerPoolWorkFunc, work, void*, context);
+
+#endif //WORKER_POOL_H
@@ -4,6 +4,33 @@
 
 #include "agent_telemetry_provider.h"
 
+#include <string.h>
+
+#include "message_schema_consts.h"
+
+/*
+ * An event type whose evictions are counted
+ */
+typedef struct _EvictedEventType {
+    TwinConfigurationEventType type;
+    const char* const* name;
+} EvictedEventType;
+
+/*
+ * The event types whose evictions are counted, in reporting order
+ */
+static const EvictedEventType EVICTED_EVENT_TYPES[AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT] = {
+    { EVENT_TYPE_PROCESS_CREATE, &PROCESS_CREATION_NAME },
+    { EVENT_TYPE_CONNECTION_CREATE, &CONNECTION_CREATION_NAME },
+    { EVENT_TYPE_USER_LOGIN, &USER_LOGIN_NAME },
+    { EVENT_TYPE_LOCAL_USERS, &LOCAL_USERS_NAME },
+    { EVENT_TYPE_LISTENING_PORTS, &LISTENING_PORTS_NAME },
+    { EVENT_TYPE_FIREWALL_CONFIGURATION, &FIREWALL_RULES_NAME },
+    { EVENT_TYPE_SYSTEM_INFORMATION, &SYSTEM_INFORMATION_NAME },
+    { EVENT_TYPE_BASELINE, &BASELINE_NAME },
+    { EVENT_TYPE_DIAGNOSTIC, &DIAGNOSTIC_NAME }
+};
+
 /*
  * Agent telemetry provider object definition
  */
@@ -11,6 +38,7 @@ typedef struct _AgentTelemetryProvider {
     SyncedCounter* lowPriorityQueueCounter;
     SyncedCounter* highPriorityQueueCounter;
     SyncedCounter* iotHubCounter;
+    uint32_t evictedEvents[AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT];
 } AgentTelemetryProvider;
 
 /*
@@ -22,6 +50,7 @@ AgentTelemetryProviderResult AgentTelemetryProvider_Init(SyncedCounter* lowPrior
     agentTelemetryProvider.lowPriorityQueueCounter = lowPriorityQueueCounter;
     agentTelemetryProvider.highPriorityQueueCounter = highPriorityQueueCounter;
     agentTelemetryProvider.iotHubCounter = iotHubCounter;
+    memset(agentTelemetryProvider.evictedEvents, 0, sizeof(agentTelemetryProvider.evictedEvents));
     
     return TELEMETRY_PROVIDER_OK;
 }
@@ -64,6 +93,27 @@ AgentTelemetryProviderResult AgentTelemetryProvider_GetMessageCounterData(Messag
     counterData->failedMessages = data.messageCounter.failedMessages;
     counterData->smallMessages = data.messageCounter.smallMessages;
     counterData->sentMessages = data.messageCounter.sentMessages;
+    counterData->sentBytes = data.messageCounter.sentBytes;
+    counterData->billedBytes = data.messageCounter.billedBytes;
 cleanup:
     return result;
+}
+
+void AgentTelemetryProvider_CountEvictedEvent(TwinConfigurationEventType eventType) {
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        if (EVICTED_EVENT_TYPES[i].type == eventType) {
+            // called from the pushing threads of the event queues
+            __atomic_add_fetch(&agentTelemetryProvider.evictedEvents[i], 1, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+}
+
+AgentTelemetryProviderResult AgentTelemetryProvider_GetEvictedEventsCounterData(EvictedEventsCounter* counterData) {
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        counterData[i].eventType = *EVICTED_EVENT_TYPES[i].name;
+        counterData[i].evicted = __atomic_exchange_n(&agentTelemetryProvider.evictedEvents[i], 0, __ATOMIC_RELAXED);
+    }
+
+    return TELEMETRY_PROVIDER_OK;
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "cancellation.h"
+
+#include <stdlib.h>
+
+#include "internal/time_utils.h"
+
+/**
+ * The token of the work the thread runs
+ */
+static __thread CancellationToken* currentToken = NULL;
+
+void CancellationToken_Init(CancellationToken* token, uint64_t deadline) {
+    __atomic_store_n(&token->deadline, deadline, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&token->cancelled, false, __ATOMIC_SEQ_CST);
+}
+
+void CancellationToken_Cancel(CancellationToken* token) {
+    __atomic_store_n(&token->cancelled, true, __ATOMIC_SEQ_CST);
+}
+
+void Cancellation_SetCurrentToken(CancellationToken* token) {
+    currentToken = token;
+}
+
+bool Cancellation_IsRequested() {
+    return Cancellation_GetRemainingTime() == 0;
+}
+
+uint32_t Cancellation_GetRemainingTime() {
+    if (currentToken == NULL) {
+        return UINT32_MAX;
+    }
+
+    if (__atomic_load_n(&currentToken->cancelled, __ATOMIC_SEQ_CST)) {
+        return 0;
+    }
+
+    uint64_t deadline = __atomic_load_n(&currentToken->deadline, __ATOMIC_SEQ_CST);
+    if (deadline == 0) {
+        return UINT32_MAX;
+    }
+
+    uint64_t now = TimeUtils_GetMonotonicTimeInMilliseconds();
+    if (now >= deadline) {
+        return 0;
+    }
+
+    return deadline - now > UINT32_MAX - 1 ? UINT32_MAX - 1 : (uint32_t)(deadline - now);
+}
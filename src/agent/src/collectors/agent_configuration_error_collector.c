@@ -82,6 +82,38 @@ EventCollectorResult AgentConfigurationErrorCollector_GenerateTypeMismatchMessag
             goto cleanup;
         } 
     }
+    if (configurationBundleStatus->evictLowPriorityEvents == CONFIGURATION_TYPE_MISMATCH) {
+        if (Utils_ConcatenateToString(&msgBuffer, &size, format, EVICT_LOW_PRIORITY_EVENTS_KEY) == false){
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        } 
+    }
+    if (configurationBundleStatus->collectorTimeBudget == CONFIGURATION_TYPE_MISMATCH) {
+        if (Utils_ConcatenateToString(&msgBuffer, &size, format, COLLECTOR_TIME_BUDGET_KEY) == false){
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        } 
+    }
+    if (configurationBundleStatus->maxPublishedBytesPerCycle == CONFIGURATION_TYPE_MISMATCH) {
+        if (Utils_ConcatenateToString(&msgBuffer, &size, format, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY) == false){
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        } 
+    }
+
+    if (configurationBundleStatus->compressMessages == CONFIGURATION_TYPE_MISMATCH) {
+        if (Utils_ConcatenateToString(&msgBuffer, &size, format, COMPRESS_MESSAGES_KEY) == false){
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        } 
+    }
+
+    if (configurationBundleStatus->encodeMessagesAsCbor == CONFIGURATION_TYPE_MISMATCH) {
+        if (Utils_ConcatenateToString(&msgBuffer, &size, format, ENCODE_MESSAGES_AS_CBOR_KEY) == false){
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        } 
+    }
     if (configurationBundleStatus->eventPriorities == CONFIGURATION_TYPE_MISMATCH) {
         if (Utils_ConcatenateToString(&msgBuffer, &size, format, EVENT_PROPERTIES_KEY) == false){
             result = EVENT_COLLECTOR_EXCEPTION;
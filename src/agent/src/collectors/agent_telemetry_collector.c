@@ -44,6 +44,16 @@ EventCollectorResult AgentTelemetryCollector_AddDroppedEventsStatsPayload(QueueC
  */
 EventCollectorResult AgentTelemetryCollector_AddMessageStatisticsPayload(MessageCounter* counterData,JsonArrayWriterHandle payloadHandle);
 
+/*
+ * @brief creates new evicted events payload
+ * 
+ * @param   counterData            the counter data of a single event type
+ * @param   JsonArrayWriterHandle  payload handle, the payload will be written in this payload object
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsStatsPayload(EvictedEventsCounter* counterData, JsonArrayWriterHandle payloadHandle);
+
 /*
  * @brief creates new dropped event and push it to the queue
  * 
@@ -62,6 +72,15 @@ EventCollectorResult AgentTelemetryCollector_AddDroppedEventsEvent(SyncQueue* qu
  */
 EventCollectorResult AgentTelemetryCollector_AddMessageStatisticsEvent(SyncQueue* queue);
 
+/*
+ * @brief creates new evicted events statistics and push it to the queue, only if events were evicted
+ * 
+ * @param   queue       the queue to push the event to.
+ * 
+ * @return EVENT_COLLECTOR_OK for sucess
+ */
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsEvent(SyncQueue* queue);
+
 EventCollectorResult AgentTelemetryCollector_GetEvents(SyncQueue* priorityQueue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
@@ -75,6 +94,11 @@ EventCollectorResult AgentTelemetryCollector_GetEvents(SyncQueue* priorityQueue)
         goto cleanup;
     }
 
+    result = AgentTelemetryCollector_AddEvictedEventsEvent(priorityQueue);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
 cleanup:
     return result;
 }
@@ -201,6 +225,141 @@ cleanup:
     return result;
 }
 
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsEvent(SyncQueue* queue){
+    JsonObjectWriterHandle eventHandle = NULL;
+    JsonArrayWriterHandle payloadHandle = NULL;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    EvictedEventsCounter counterData[AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT] = {{0}};
+    if (AgentTelemetryProvider_GetEvictedEventsCounterData(counterData) != TELEMETRY_PROVIDER_OK){
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    uint32_t totalEvicted = 0;
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        totalEvicted += counterData[i].evicted;
+    }
+    if (totalEvicted == 0){
+        // evictions are rare, don't report an empty statistics event every period
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_Init(&eventHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddMetadata(eventHandle, EVENT_PERIODIC_CATEGORY, AGENT_TELEMETRY_EVICTED_EVENTS_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&payloadHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        if (counterData[i].evicted == 0){
+            continue;
+        }
+
+        result = AgentTelemetryCollector_AddEvictedEventsStatsPayload(&counterData[i], payloadHandle);
+        if (result != EVENT_COLLECTOR_OK){
+            goto cleanup;
+        }
+    }
+
+    result = GenericEvent_AddPayload(eventHandle, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_PushEvent(queue, eventHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadHandle != NULL){
+        JsonArrayWriter_Deinit(payloadHandle);
+    }
+
+    if (eventHandle != NULL){
+        JsonObjectWriter_Deinit(eventHandle);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddTimeBudgetExceededEvent(SyncQueue* queue, const char* collectorName, uint32_t timeBudget){
+    JsonObjectWriterHandle eventHandle = NULL;
+    JsonArrayWriterHandle payloadHandle = NULL;
+    JsonObjectWriterHandle payloadObject = NULL;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    if (JsonObjectWriter_Init(&eventHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddMetadata(eventHandle, EVENT_TRIGGERED_CATEGORY, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_SCHEMA_VERSION);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_Init(&payloadHandle) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_Init(&payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteString(payloadObject, AGENT_TELEMETRY_COLLECTOR_KEY, collectorName) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_TIME_BUDGET_KEY, timeBudget) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = GenericEvent_AddPayload(eventHandle, payloadHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+    result = AgentTelemetryCollector_PushEvent(queue, eventHandle);
+    if (result != EVENT_COLLECTOR_OK){
+        goto cleanup;
+    }
+
+cleanup:
+    if (payloadObject != NULL) {
+        JsonObjectWriter_Deinit(payloadObject);
+    }
+
+    if (payloadHandle != NULL){
+        JsonArrayWriter_Deinit(payloadHandle);
+    }
+
+    if (eventHandle != NULL){
+        JsonObjectWriter_Deinit(eventHandle);
+    }
+
+    return result;
+}
+
 EventCollectorResult AgentTelemetryCollector_PushEvent(SyncQueue* queue, JsonObjectWriterHandle eventHandle){
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     char* buffer = NULL;
@@ -280,12 +439,53 @@ EventCollectorResult AgentTelemetryCollector_AddMessageStatisticsPayload(Message
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+
+    uint32_t fillPercentage = 0;
+    if (counterData->billedBytes > 0) {
+        fillPercentage = (uint32_t)((uint64_t)counterData->sentBytes * 100 / counterData->billedBytes);
+    }
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY, fillPercentage) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
     
     if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
+cleanup:
+    if (payloadObject != NULL) {
+        JsonObjectWriter_Deinit(payloadObject);
+    }
+
+    return result;
+}
+
+EventCollectorResult AgentTelemetryCollector_AddEvictedEventsStatsPayload(EvictedEventsCounter* counterData, JsonArrayWriterHandle payloadHandle){
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonObjectWriterHandle payloadObject = NULL;
+
+    if (JsonObjectWriter_Init(&payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteString(payloadObject, AGENT_TELEMETRY_EVENT_TYPE_KEY, counterData->eventType) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_WriteInt(payloadObject, AGENT_TELEMETRY_EVICTED_EVENTS_KEY, counterData->evicted) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonArrayWriter_AddObject(payloadHandle, payloadObject) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
 cleanup:
     if (payloadObject != NULL) {
         JsonObjectWriter_Deinit(payloadObject);
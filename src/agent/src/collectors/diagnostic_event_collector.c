@@ -13,6 +13,7 @@
 #include "message_schema_consts.h"
 #include "os_utils/os_utils.h"
 #include "os_utils/correlation_manager.h"
+#include "twin_configuration_defs.h"
 #include "utils.h"
 
 /**
@@ -244,7 +245,7 @@ EventCollectorResult DiagnosticEventCollector_GetSingleEvent(DiagnosticEvent* ev
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(priorityQueue, buffer, bufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(priorityQueue, buffer, bufferSize, EVENT_TYPE_DIAGNOSTIC) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         free(buffer);
         goto cleanup;
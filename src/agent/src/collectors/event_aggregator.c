@@ -2,28 +2,66 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stdlib.h>
+#include <string.h>
 
-#include "azure_c_shared_utility/singlylinkedlist.h"
 #include "collectors/event_aggregator.h"
 #include "internal/time_utils_consts.h"
 #include "internal/time_utils.h"
 #include "logger.h"
+#include "memory_monitor.h"
 #include "message_schema_consts.h"
 #include "utils.h"
 
 typedef struct _AggregatedEventItem {
 
     JsonObjectWriterHandle json;
+    uint32_t hash;
     uint32_t hitCount;
+    // the most hits the payload could have had before it got its place in the aggregator
+    uint32_t hitCountError;
+    // the memory charged to the memory monitor for this event
+    uint32_t memorySize;
+    // the position of the event in the aggregator heap
+    uint32_t heapPosition;
+    // the events seen right before and right after this one
+    struct _AggregatedEventItem* previous;
+    struct _AggregatedEventItem* next;
 
 } AggregatedEventItem;
 
+/**
+ * The number of aggregated events the aggregator has room for initially, it is doubled whenever it runs out.
+ */
+#define EVENT_AGGREGATOR_INITIAL_CAPACITY 16
+
+/**
+ * The memory an aggregated event takes on top of its payload: the item, its place in the heap and its index slots.
+ */
+#define EVENT_AGGREGATOR_EVENT_OVERHEAD (sizeof(AggregatedEventItem) + 3 * sizeof(AggregatedEventItem*))
+
 struct _EventAggregator  {
     TwinConfigurationEventType iotEventType;
     char* event_type;
     char* event_name;
     char* payload_schema_version;
-    SINGLYLINKEDLIST_HANDLE aggregatedEvents;
+    char* port_key;
+    // the aggregated events in the order they were first seen, linked through the events themselves
+    AggregatedEventItem* firstEvent;
+    AggregatedEventItem* lastEvent;
+    // the aggregated events in a min-heap on their hits plus hit count error, the root is the next event to evict
+    AggregatedEventItem** aggregatedEvents;
+    uint32_t aggregatedEventsCount;
+    uint32_t aggregatedEventsCapacity;
+    // an open addressing table over the aggregated events, keyed by the payload hash, NULL marks an empty slot.
+    // it has twice as many slots as the events capacity so it is at most half full.
+    AggregatedEventItem** index;
+    uint32_t indexSize;
+    // once the aggregator is full, the event with the fewest hits makes room for a new one (space-saving).
+    // the evicted events are summed up in the "other" bucket.
+    uint32_t otherHitCount;
+    uint32_t otherEventsCount;
+    // the most hits an evicted event had, a payload seen again after it was evicted could have had as many
+    uint32_t maxEvictedHitCount;
     time_t lastAggregationTime;
 };
 
@@ -32,53 +70,208 @@ static const char* START_TIME_LOCAL_KEY = "StartTimeLocal";
 static const char* START_TIME_UTC_KEY = "StartTimeUtc";
 static const char* END_TIME_LOCAL_KEY = "EndTimeLocal";
 static const char* END_TIME_UTC_KEY = "EndTimeUtc";
+static const char* HIT_COUNT_ERROR_KEY = "HitCountError";
+static const char* EVICTED_EVENTS_KEY = "EvictedEvents";
+
+static const char AGGREGATION_KEY_FIELDS_SEPARATOR = ',';
+static const char NUMERIC_ARGUMENT_PLACEHOLDER = '#';
+static const char TEMP_PATH_WILDCARD = '*';
+static const char* TEMP_PATH_PREFIXES[] = { "/tmp/", "/var/tmp/" };
 
 typedef struct _EventAggregator EventAggregator;
 
 /**
- * @brief Search for an event in the aggregated events list, search is based on payload equality
+ * @brief Applies the aggregation key of the aggregator event type to the payload, so payloads which differ
+ *        only out of the key or in values the key normalizes end up equal
  * 
- * @param   list            Handle to the aggregated event list
- * @param   eventPayload    The payload to search
- * @param   outEvent        Out param, pointer to first match
+ * @param   aggregator      Handle to the aggregator
+ * @param   eventPayload    The payload, changed in place
  * 
  * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
  */
-AggregatedEventItem* EventAggregator_SearchEvent(SINGLYLINKEDLIST_HANDLE list, JsonObjectWriterHandle eventPayload);
+EventAggregatorResult EventAggregator_ApplyAggregationKey(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload);
+
+/**
+ * @brief Checks if the field is one of the aggregation key fields
+ * 
+ * @param   fields      The comma separated aggregation key fields
+ * @param   field       The field to look for
+ * 
+ * @return true if the field is part of the key
+ */
+bool EventAggregator_IsKeyField(const char* fields, const char* field);
 
 /**
- * @brief Adds new event to the aggregated event list
+ * @brief Normalizes a string field of the payload, word by word: numeric arguments are replaced with a
+ *        placeholder and paths under a temp directory are collapsed to the directory. Other fields are left as they are.
+ * 
+ * @param   key             The aggregation key
+ * @param   eventPayload    The payload
+ * @param   field           The field to normalize
+ * 
+ * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
+ */
+EventAggregatorResult EventAggregator_NormalizeString(const TwinConfigurationAggregationKey* key, JsonObjectWriterHandle eventPayload, const char* field);
+
+/**
+ * @brief Returns the length of the word up to and including its temp directory, the path may be the value of an option, e.g. --output=/tmp/file
+ * 
+ * @param   word        The word
+ * @param   wordLength  The length of the word
+ * 
+ * @return the length to keep of the word, 0 if the word is not a path under a temp directory
+ */
+uint32_t EventAggregator_GetTempPathLength(const char* word, uint32_t wordLength);
+
+/**
+ * @brief Masks the port of the payload if it is above the given port, like an inbound connection's remote port
+ * 
+ * @param   aggregator      Handle to the aggregator
+ * @param   eventPayload    The payload
+ * @param   maskPortsAbove  The highest port which is kept
+ * 
+ * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
+ */
+EventAggregatorResult EventAggregator_MaskPort(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t maskPortsAbove);
+
+/**
+ * @brief Search for an event in the aggregated events, search is based on the payload hash
+ *        and payloads are only compared when their hashes match
+ * 
+ * @param   aggregator      Handle to the aggregator
+ * @param   eventPayload    The payload to search
+ * @param   hash            The hash of the payload
+ * 
+ * @return the matching event, NULL if there is none
+ */
+AggregatedEventItem* EventAggregator_SearchEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t hash);
+
+/**
+ * @brief Adds new event to the aggregated events, evicting the event with the fewest hits
+ *        when the aggregator is full or the memory monitor has no room for the new event.
+ *        At most one event is evicted for the memory monitor, the new event is counted in
+ *        the "other" bucket if there is still no room for it.
  * 
  * @param   aggregator              Handle to the aggregator
  * @param   eventPayload            The new event payload
+ * @param   hash                    The hash of the payload
+ * @param   maxEvents               The maximal number of aggregated events
+ * 
+ * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
+ */
+EventAggregatorResult EventAggregator_AddNewEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t hash, uint32_t maxEvents);
+
+/**
+ * @brief Evicts the event with the fewest hits, counting its hits too if they are an estimate,
+ *        and moves its hits to the "other" bucket
+ * 
+ * @param   aggregator              Handle to the aggregator, must not be empty
+ */
+void EventAggregator_EvictEvent(EventAggregatorHandle aggregator);
+
+/**
+ * @brief Removes the event from the aggregator and deinits it, the other events keep their order
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   item                    The event to remove
+ */
+void EventAggregator_RemoveEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item);
+
+/**
+ * @brief Returns the most hits the event could have had, its hit count plus its hit count error
+ * 
+ * @param   item                    The event
+ * 
+ * @return the estimated hit count of the event
+ */
+uint64_t EventAggregator_GetEstimatedHitCount(const AggregatedEventItem* item);
+
+/**
+ * @brief Puts the event at the given position in the heap
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   item                    The event
+ * @param   position                The position in the heap
+ */
+void EventAggregator_SetHeapPosition(EventAggregatorHandle aggregator, AggregatedEventItem* item, uint32_t position);
+
+/**
+ * @brief Moves the event at the given position up the heap until its parent has no more hits than it has
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   position                The position of the event in the heap
+ */
+void EventAggregator_SiftUp(EventAggregatorHandle aggregator, uint32_t position);
+
+/**
+ * @brief Moves the event at the given position down the heap until its children have no fewer hits than it has
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   position                The position of the event in the heap
+ */
+void EventAggregator_SiftDown(EventAggregatorHandle aggregator, uint32_t position);
+
+/**
+ * @brief Doubles the room for aggregated events and rebuilds the index
+ * 
+ * @param   aggregator              Handle to the aggregator
  * 
  * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
  */
-EventAggregatorResult EventAggregator_AddNewEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload);
+EventAggregatorResult EventAggregator_Grow(EventAggregatorHandle aggregator);
+
+/**
+ * @brief Puts the event in the index
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   item                    The event
+ */
+void EventAggregator_IndexEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item);
+
+/**
+ * @brief Takes the event out of the index, shifting back the events that follow it
+ *        so every event can still be found without leaving a mark in its slot
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   item                    The event
+ */
+void EventAggregator_UnindexEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item);
 
 /**
- * @brief Adds aggregation metadata to the given payload
+ * @brief Adds aggregation metadata to the payload of the given event
  * 
- * @param   payload                 writer to add the metadata to
- * @param   hitCount                payload hit count
+ * @param   eventData               The event to add the metadata to
+ * @param   evictedEvents           The number of events the payload sums up, 0 for a regular aggregated event
  * @param   aggregationStartTime    aggregation start time
  * @param   aggregationEndTime      aggregation end time
  * 
  * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
  */
-EventAggregatorResult EventAggregator_AddAggregationMetadata(JsonObjectWriterHandle payload, uint32_t hitCount, time_t* aggregationStartTime, time_t* aggregationEndTime);
+EventAggregatorResult EventAggregator_AddAggregationMetadata(AggregatedEventItem* eventData, uint32_t evictedEvents, time_t* aggregationStartTime, time_t* aggregationEndTime);
 
 /**
  * @brief Creates a single aggregated event and push it to the queue
  * 
  * @param   aggregator              Handle to the aggregator
  * @param   eventData               A pointer to the event data (payload + hit count)
+ * @param   evictedEvents           The number of events the payload sums up, 0 for a regular aggregated event
  * @param   queue                   The queue to push the new event to
  * @param   aggregationEndTime      aggregation end time
  * 
  * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
  */
-EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregatorHandle aggregator, AggregatedEventItem* eventData, SyncQueue* queue, time_t* aggregationEndTime);
+EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregatorHandle aggregator, AggregatedEventItem* eventData, uint32_t evictedEvents, SyncQueue* queue, time_t* aggregationEndTime);
+
+/**
+ * @brief Creates an aggregated event for the "other" bucket, its payload holds only the aggregation metadata
+ * 
+ * @param   aggregator              Handle to the aggregator
+ * @param   queue                   The queue to push the new event to
+ * @param   aggregationEndTime      aggregation end time
+ * 
+ * @return EVENT_AGGREGATOR_OK on success or an error code upon failure
+ */
+EventAggregatorResult EventAggregator_CreateOtherAggregatedEvent(EventAggregatorHandle aggregator, SyncQueue* queue, time_t* aggregationEndTime);
 
 /**
  * @brief Creates aggregated events from all the events in the aggregator
@@ -137,11 +330,22 @@ EventAggregatorResult EventAggregator_Init(EventAggregatorHandle* aggregator, Ev
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
-    aggregatorObj->aggregatedEvents = singlylinkedlist_create();
+    if (configurtion->port_key != NULL && Utils_CreateStringCopy(&aggregatorObj->port_key, configurtion->port_key) != true) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
+    aggregatorObj->aggregatedEvents = malloc(EVENT_AGGREGATOR_INITIAL_CAPACITY * sizeof(AggregatedEventItem*));
     if (aggregatorObj->aggregatedEvents == NULL) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
+    aggregatorObj->aggregatedEventsCapacity = EVENT_AGGREGATOR_INITIAL_CAPACITY;
+    aggregatorObj->indexSize = 2 * EVENT_AGGREGATOR_INITIAL_CAPACITY;
+    aggregatorObj->index = calloc(aggregatorObj->indexSize, sizeof(AggregatedEventItem*));
+    if (aggregatorObj->index == NULL) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
 
     *aggregator = aggregatorObj;
 
@@ -163,9 +367,15 @@ void EventAggregator_Deinit(EventAggregatorHandle aggregator) {
     if (aggregator->event_name) {
         free(aggregator->event_name);
     }
+    if (aggregator->port_key) {
+        free(aggregator->port_key);
+    }
     if (aggregator->aggregatedEvents){
         EventAggregator_ClearAggregatedEvents(aggregator);
-        singlylinkedlist_destroy(aggregator->aggregatedEvents);
+        free(aggregator->aggregatedEvents);
+    }
+    if (aggregator->index) {
+        free(aggregator->index);
     }
         
     free(aggregator);
@@ -180,15 +390,30 @@ EventAggregatorResult EventAggregator_AggregateEvent(EventAggregatorHandle aggre
     if (isEnabled == false) {
         return EVENT_AGGREGATOR_DISABLED;
     }
+
+    result = EventAggregator_ApplyAggregationKey(aggregator, eventPayload);
+    if (result != EVENT_AGGREGATOR_OK) {
+        return result;
+    }
     
-    AggregatedEventItem* eventDataItem = EventAggregator_SearchEvent(aggregator->aggregatedEvents, eventPayload); 
-    if (eventDataItem == NULL) {
-        result = EventAggregator_AddNewEvent(aggregator, eventPayload);
-    } else {
+    uint32_t hash = 0;
+    if (JsonObjectWriter_GetHash(eventPayload, &hash) != JSON_WRITER_OK) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    AggregatedEventItem* eventDataItem = EventAggregator_SearchEvent(aggregator, eventPayload, hash); 
+    if (eventDataItem != NULL) {
         eventDataItem->hitCount += 1;
+        EventAggregator_SiftDown(aggregator, eventDataItem->heapPosition);
+        return EVENT_AGGREGATOR_OK;
     }
-    
-    return result;
+
+    uint32_t maxEvents = 0;
+    if (TwinConfigurationEventCollectors_GetAggregationMaxEntries(aggregator->iotEventType, &maxEvents) != TWIN_OK) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    return EventAggregator_AddNewEvent(aggregator, eventPayload, hash, maxEvents);
 }
 
 EventAggregatorResult EventAggregator_GetAggregatedEvents(EventAggregatorHandle aggregator, SyncQueue* queue) {
@@ -218,27 +443,168 @@ cleanup:
     return result;
 }
 
-bool EventAggregator_MatchEvent(LIST_ITEM_HANDLE list_item, const void* match_context) {
-    JsonObjectWriterHandle matchPayload = (JsonObjectWriterHandle)match_context;
-    AggregatedEventItem* currentItem = (AggregatedEventItem*)singlylinkedlist_item_get_value(list_item);
+EventAggregatorResult EventAggregator_ApplyAggregationKey(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload) {
+    TwinConfigurationAggregationKey key;
+    if (TwinConfigurationEventCollectors_GetAggregationKey(aggregator->iotEventType, &key) != TWIN_OK) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
 
-    if (currentItem == NULL || match_context == NULL) {
-        return false;
-    } else {
-        return JsonObjectWriter_Compare(currentItem->json, matchPayload);
-    }    
+    bool isWholePayload = key.fields[0] == '\0';
+    bool isNormalized = key.stripNumericArguments || key.collapseTempPaths;
+    if (isWholePayload == false || isNormalized) {
+        uint32_t size = 0;
+        if (JsonObjectWriter_GetSize(eventPayload, &size) != JSON_WRITER_OK) {
+            return EVENT_AGGREGATOR_EXCEPTION;
+        }
+
+        for (uint32_t i = 0; i < size; i++) {
+            const char* field = NULL;
+            if (JsonObjectWriter_GetKeyAt(eventPayload, i, &field) != JSON_WRITER_OK) {
+                return EVENT_AGGREGATOR_EXCEPTION;
+            }
+
+            if (isWholePayload == false && EventAggregator_IsKeyField(key.fields, field) == false) {
+                // the field is kept so aggregated events have the same shape as the events they stand for
+                if (JsonObjectWriter_ResetValue(eventPayload, field) != JSON_WRITER_OK) {
+                    return EVENT_AGGREGATOR_EXCEPTION;
+                }
+            } else if (isNormalized) {
+                EventAggregatorResult result = EventAggregator_NormalizeString(&key, eventPayload, field);
+                if (result != EVENT_AGGREGATOR_OK) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    if (key.maskPortsAbove > 0 && aggregator->port_key != NULL) {
+        return EventAggregator_MaskPort(aggregator, eventPayload, key.maskPortsAbove);
+    }
+
+    return EVENT_AGGREGATOR_OK;
 }
 
-AggregatedEventItem* EventAggregator_SearchEvent(SINGLYLINKEDLIST_HANDLE list, JsonObjectWriterHandle eventPayload) {
-    LIST_ITEM_HANDLE listItem = singlylinkedlist_find(list, EventAggregator_MatchEvent, eventPayload);
-    return listItem == NULL 
-            ? NULL
-            : (AggregatedEventItem*)singlylinkedlist_item_get_value(listItem);
+bool EventAggregator_IsKeyField(const char* fields, const char* field) {
+    size_t fieldLength = strlen(field);
+    const char* current = fields;
+    while (current != NULL) {
+        const char* next = strchr(current, AGGREGATION_KEY_FIELDS_SEPARATOR);
+        size_t currentLength = next == NULL ? strlen(current) : (size_t)(next - current);
+        if (Utils_AreStringsEqual(current, currentLength, field, fieldLength, true)) {
+            return true;
+        }
+
+        current = next == NULL ? NULL : next + 1;
+    }
+
+    return false;
 }
 
-EventAggregatorResult EventAggregator_AddNewEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload) {
+EventAggregatorResult EventAggregator_NormalizeString(const TwinConfigurationAggregationKey* key, JsonObjectWriterHandle eventPayload, const char* field) {
+    const char* value = NULL;
+    if (JsonObjectWriter_ReadString(eventPayload, field, &value) != JSON_WRITER_OK) {
+        // only strings are normalized
+        return EVENT_AGGREGATOR_OK;
+    }
+
+    // words are never longer once normalized
+    size_t valueLength = strlen(value);
+    char* normalized = malloc(valueLength + 1);
+    if (normalized == NULL) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    bool isChanged = false;
+    bool isFirstWord = true;
+    size_t length = 0;
+    const char* word = value;
+    while (*word != '\0') {
+        if (*word == ' ') {
+            normalized[length++] = *word++;
+            continue;
+        }
+
+        uint32_t wordLength = (uint32_t)strcspn(word, " ");
+        uint32_t tempPathLength = key->collapseTempPaths ? EventAggregator_GetTempPathLength(word, wordLength) : 0;
+        // the first word is the executable, only later words are arguments
+        if (key->stripNumericArguments && isFirstWord == false && strspn(word, "0123456789") == wordLength) {
+            normalized[length++] = NUMERIC_ARGUMENT_PLACEHOLDER;
+            isChanged = true;
+        } else if (tempPathLength > 0) {
+            memcpy(normalized + length, word, tempPathLength);
+            length += tempPathLength;
+            normalized[length++] = TEMP_PATH_WILDCARD;
+            isChanged = true;
+        } else {
+            memcpy(normalized + length, word, wordLength);
+            length += wordLength;
+        }
+
+        word += wordLength;
+        isFirstWord = false;
+    }
+    normalized[length] = '\0';
+
     EventAggregatorResult result = EVENT_AGGREGATOR_OK;
-    AggregatedEventItem* newItem = malloc(sizeof(AggregatedEventItem));
+    if (isChanged && JsonObjectWriter_WriteString(eventPayload, field, normalized) != JSON_WRITER_OK) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    free(normalized);
+    return result;
+}
+
+uint32_t EventAggregator_GetTempPathLength(const char* word, uint32_t wordLength) {
+    const char* optionValue = memchr(word, '=', wordLength);
+    uint32_t start = optionValue == NULL ? 0 : (uint32_t)(optionValue - word) + 1;
+
+    for (uint32_t i = 0; i < sizeof(TEMP_PATH_PREFIXES) / sizeof(TEMP_PATH_PREFIXES[0]); i++) {
+        uint32_t prefixLength = strlen(TEMP_PATH_PREFIXES[i]);
+        // a path is collapsed only if there is something under the temp directory
+        if (wordLength - start > prefixLength && Utils_IsPrefixOf(TEMP_PATH_PREFIXES[i], prefixLength, word + start, wordLength - start)) {
+            return start + prefixLength;
+        }
+    }
+
+    return 0;
+}
+
+EventAggregatorResult EventAggregator_MaskPort(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t maskPortsAbove) {
+    const char* value = NULL;
+    if (JsonObjectWriter_ReadString(eventPayload, aggregator->port_key, &value) != JSON_WRITER_OK || *value == '\0') {
+        // the port is already masked or was reset by the aggregation key
+        return EVENT_AGGREGATOR_OK;
+    }
+
+    int port = 0;
+    if (Utils_ConvertStringToInteger(value, 10, &port) == false || port < 0 || (uint32_t)port <= maskPortsAbove) {
+        return EVENT_AGGREGATOR_OK;
+    }
+
+    if (JsonObjectWriter_WriteInt(eventPayload, aggregator->port_key, 0) != JSON_WRITER_OK) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    return EVENT_AGGREGATOR_OK;
+}
+
+AggregatedEventItem* EventAggregator_SearchEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t hash) {
+    uint32_t mask = aggregator->indexSize - 1;
+    for (uint32_t slot = hash & mask; aggregator->index[slot] != NULL; slot = (slot + 1) & mask) {
+        AggregatedEventItem* currentItem = aggregator->index[slot];
+        if (currentItem->hash == hash && JsonObjectWriter_Compare(currentItem->json, eventPayload)) {
+            return currentItem;
+        }
+    }
+
+    return NULL;
+}
+
+EventAggregatorResult EventAggregator_AddNewEvent(EventAggregatorHandle aggregator, JsonObjectWriterHandle eventPayload, uint32_t hash, uint32_t maxEvents) {
+    EventAggregatorResult result = EVENT_AGGREGATOR_OK;
+    AggregatedEventItem* newItem = NULL;
+
+    newItem = malloc(sizeof(AggregatedEventItem));
     if (newItem == NULL) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
@@ -246,15 +612,71 @@ EventAggregatorResult EventAggregator_AddNewEvent(EventAggregatorHandle aggregat
 
     memset(newItem, 0, sizeof(AggregatedEventItem));
     newItem->hitCount = 1;
+    newItem->hash = hash;
     if (JsonObjectWriter_Copy(&newItem->json, eventPayload) != JSON_WRITER_OK) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
 
-    if (singlylinkedlist_add(aggregator->aggregatedEvents, newItem) == NULL) {
+    uint32_t payloadSize = 0;
+    if (JsonObjectWriter_GetSerializedSize(newItem->json, &payloadSize) != JSON_WRITER_OK) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
+    newItem->memorySize = payloadSize + EVENT_AGGREGATOR_EVENT_OVERHEAD;
+
+    // the aggregator holds more events than allowed only if the limit was lowered since they were added
+    bool isEvicted = false;
+    while (aggregator->aggregatedEventsCount > 0 && aggregator->aggregatedEventsCount >= maxEvents) {
+        EventAggregator_EvictEvent(aggregator);
+        isEvicted = true;
+    }
+
+    MemoryMonitorResultValues memoryResult = MEMORY_MONITOR_MEMORY_EXCEEDED;
+    if (aggregator->aggregatedEventsCount < maxEvents) {
+        memoryResult = MemoryMonitor_Consume(newItem->memorySize);
+        // a single event makes room under memory pressure, evicting more would flush the heavy hitters
+        // into the "other" bucket for payloads which may never be seen again
+        if (memoryResult == MEMORY_MONITOR_MEMORY_EXCEEDED && isEvicted == false && aggregator->aggregatedEventsCount > 0) {
+            EventAggregator_EvictEvent(aggregator);
+            memoryResult = MemoryMonitor_Consume(newItem->memorySize);
+        }
+    }
+
+    if (memoryResult == MEMORY_MONITOR_MEMORY_EXCEEDED) {
+        // there is no room for the event, count it and drop its payload
+        aggregator->otherHitCount += 1;
+        aggregator->otherEventsCount += 1;
+        AggregatedEventItem_Deinit(newItem);
+        newItem = NULL;
+        goto cleanup;
+    } else if (memoryResult != MEMORY_MONITOR_OK) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    newItem->hitCountError = aggregator->maxEvictedHitCount;
+
+    if (aggregator->aggregatedEventsCount == aggregator->aggregatedEventsCapacity) {
+        result = EventAggregator_Grow(aggregator);
+        if (result != EVENT_AGGREGATOR_OK) {
+            MemoryMonitor_Release(newItem->memorySize);
+            goto cleanup;
+        }
+    }
+
+    aggregator->aggregatedEventsCount++;
+    EventAggregator_SetHeapPosition(aggregator, newItem, aggregator->aggregatedEventsCount - 1);
+    EventAggregator_SiftUp(aggregator, newItem->heapPosition);
+    EventAggregator_IndexEvent(aggregator, newItem);
+
+    newItem->previous = aggregator->lastEvent;
+    if (aggregator->lastEvent != NULL) {
+        aggregator->lastEvent->next = newItem;
+    } else {
+        aggregator->firstEvent = newItem;
+    }
+    aggregator->lastEvent = newItem;
 
 cleanup:
     if (result != EVENT_AGGREGATOR_OK) {
@@ -264,8 +686,147 @@ cleanup:
     return result;
 }
 
-EventAggregatorResult EventAggregator_AddAggregationMetadata(JsonObjectWriterHandle payload, uint32_t hitCount, time_t* aggregationStartTime, time_t* aggregationEndTime) {
+void EventAggregator_EvictEvent(EventAggregatorHandle aggregator) {
+    AggregatedEventItem* evictedItem = aggregator->aggregatedEvents[0];
+    uint64_t minHitCount = EventAggregator_GetEstimatedHitCount(evictedItem);
+    aggregator->otherHitCount += evictedItem->hitCount;
+    aggregator->otherEventsCount += 1;
+    if (minHitCount > aggregator->maxEvictedHitCount) {
+        aggregator->maxEvictedHitCount = minHitCount > UINT32_MAX ? UINT32_MAX : (uint32_t)minHitCount;
+    }
+
+    MemoryMonitor_Release(evictedItem->memorySize);
+    EventAggregator_RemoveEvent(aggregator, evictedItem);
+}
+
+void EventAggregator_RemoveEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item) {
+    EventAggregator_UnindexEvent(aggregator, item);
+
+    if (item->previous != NULL) {
+        item->previous->next = item->next;
+    } else {
+        aggregator->firstEvent = item->next;
+    }
+    if (item->next != NULL) {
+        item->next->previous = item->previous;
+    } else {
+        aggregator->lastEvent = item->previous;
+    }
+
+    // the last event of the heap takes the place of the removed one
+    uint32_t position = item->heapPosition;
+    aggregator->aggregatedEventsCount--;
+    if (position < aggregator->aggregatedEventsCount) {
+        EventAggregator_SetHeapPosition(aggregator, aggregator->aggregatedEvents[aggregator->aggregatedEventsCount], position);
+        EventAggregator_SiftDown(aggregator, position);
+        EventAggregator_SiftUp(aggregator, position);
+    }
+
+    AggregatedEventItem_Deinit(item);
+}
+
+uint64_t EventAggregator_GetEstimatedHitCount(const AggregatedEventItem* item) {
+    return (uint64_t)item->hitCount + item->hitCountError;
+}
+
+void EventAggregator_SetHeapPosition(EventAggregatorHandle aggregator, AggregatedEventItem* item, uint32_t position) {
+    aggregator->aggregatedEvents[position] = item;
+    item->heapPosition = position;
+}
+
+void EventAggregator_SiftUp(EventAggregatorHandle aggregator, uint32_t position) {
+    AggregatedEventItem* item = aggregator->aggregatedEvents[position];
+    uint64_t hitCount = EventAggregator_GetEstimatedHitCount(item);
+    while (position > 0) {
+        uint32_t parent = (position - 1) / 2;
+        if (EventAggregator_GetEstimatedHitCount(aggregator->aggregatedEvents[parent]) <= hitCount) {
+            break;
+        }
+
+        EventAggregator_SetHeapPosition(aggregator, aggregator->aggregatedEvents[parent], position);
+        position = parent;
+    }
+    EventAggregator_SetHeapPosition(aggregator, item, position);
+}
+
+void EventAggregator_SiftDown(EventAggregatorHandle aggregator, uint32_t position) {
+    AggregatedEventItem* item = aggregator->aggregatedEvents[position];
+    uint64_t hitCount = EventAggregator_GetEstimatedHitCount(item);
+    while (true) {
+        uint32_t child = 2 * position + 1;
+        if (child >= aggregator->aggregatedEventsCount) {
+            break;
+        }
+        if (child + 1 < aggregator->aggregatedEventsCount
+            && EventAggregator_GetEstimatedHitCount(aggregator->aggregatedEvents[child + 1]) < EventAggregator_GetEstimatedHitCount(aggregator->aggregatedEvents[child])) {
+            child++;
+        }
+        if (EventAggregator_GetEstimatedHitCount(aggregator->aggregatedEvents[child]) >= hitCount) {
+            break;
+        }
+
+        EventAggregator_SetHeapPosition(aggregator, aggregator->aggregatedEvents[child], position);
+        position = child;
+    }
+    EventAggregator_SetHeapPosition(aggregator, item, position);
+}
+
+EventAggregatorResult EventAggregator_Grow(EventAggregatorHandle aggregator) {
+    uint32_t newCapacity = 2 * aggregator->aggregatedEventsCapacity;
+    AggregatedEventItem** newIndex = calloc(2 * newCapacity, sizeof(AggregatedEventItem*));
+    if (newIndex == NULL) {
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+
+    AggregatedEventItem** newEvents = realloc(aggregator->aggregatedEvents, newCapacity * sizeof(AggregatedEventItem*));
+    if (newEvents == NULL) {
+        free(newIndex);
+        return EVENT_AGGREGATOR_EXCEPTION;
+    }
+    aggregator->aggregatedEvents = newEvents;
+    aggregator->aggregatedEventsCapacity = newCapacity;
+
+    free(aggregator->index);
+    aggregator->index = newIndex;
+    aggregator->indexSize = 2 * newCapacity;
+
+    for (uint32_t i = 0; i < aggregator->aggregatedEventsCount; i++) {
+        EventAggregator_IndexEvent(aggregator, aggregator->aggregatedEvents[i]);
+    }
+
+    return EVENT_AGGREGATOR_OK;
+}
+
+void EventAggregator_IndexEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item) {
+    uint32_t mask = aggregator->indexSize - 1;
+    uint32_t slot = item->hash & mask;
+    while (aggregator->index[slot] != NULL) {
+        slot = (slot + 1) & mask;
+    }
+    aggregator->index[slot] = item;
+}
+
+void EventAggregator_UnindexEvent(EventAggregatorHandle aggregator, AggregatedEventItem* item) {
+    uint32_t mask = aggregator->indexSize - 1;
+    uint32_t slot = item->hash & mask;
+    while (aggregator->index[slot] != item) {
+        slot = (slot + 1) & mask;
+    }
+
+    for (uint32_t next = (slot + 1) & mask; aggregator->index[next] != NULL; next = (next + 1) & mask) {
+        uint32_t home = aggregator->index[next]->hash & mask;
+        // the event can fill the free slot only if the free slot is on its probe sequence
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            aggregator->index[slot] = aggregator->index[next];
+            slot = next;
+        }
+    }
+    aggregator->index[slot] = NULL;
+}
+
+EventAggregatorResult EventAggregator_AddAggregationMetadata(AggregatedEventItem* eventData, uint32_t evictedEvents, time_t* aggregationStartTime, time_t* aggregationEndTime) {
     EventAggregatorResult result = EVENT_AGGREGATOR_OK;
+    JsonObjectWriterHandle payload = eventData->json;
     const uint32_t bufferSize = MAX_TIME_AS_STRING_LENGTH + 1;
     char timeString[bufferSize];
     JsonObjectWriterHandle metadata = NULL;
@@ -281,7 +842,17 @@ EventAggregatorResult EventAggregator_AddAggregationMetadata(JsonObjectWriterHan
         metadata = payload;
     }
     
-    if (JsonObjectWriter_WriteInt(metadata, HIT_COUNT_KEY, hitCount) != JSON_WRITER_OK) {
+    if (JsonObjectWriter_WriteInt(metadata, HIT_COUNT_KEY, eventData->hitCount) != JSON_WRITER_OK) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (eventData->hitCountError > 0 && JsonObjectWriter_WriteInt(metadata, HIT_COUNT_ERROR_KEY, eventData->hitCountError) != JSON_WRITER_OK) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (evictedEvents > 0 && JsonObjectWriter_WriteInt(metadata, EVICTED_EVENTS_KEY, evictedEvents) != JSON_WRITER_OK) {
         result = EVENT_AGGREGATOR_EXCEPTION;
         goto cleanup;
     }
@@ -343,7 +914,7 @@ cleanup:
     return result;
 }
 
-EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregatorHandle aggregator, AggregatedEventItem* nodeData, SyncQueue* queue, time_t* aggregationEndTime) {
+EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregatorHandle aggregator, AggregatedEventItem* nodeData, uint32_t evictedEvents, SyncQueue* queue, time_t* aggregationEndTime) {
     EventAggregatorResult result = EVENT_AGGREGATOR_OK;
     JsonObjectWriterHandle event = NULL;
     JsonArrayWriterHandle payloads = NULL;
@@ -364,7 +935,7 @@ EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregato
         goto cleanup;
     }
 
-    result = EventAggregator_AddAggregationMetadata(nodeData->json, nodeData->hitCount, &aggregator->lastAggregationTime, aggregationEndTime);
+    result = EventAggregator_AddAggregationMetadata(nodeData, evictedEvents, &aggregator->lastAggregationTime, aggregationEndTime);
     if (result != EVENT_AGGREGATOR_OK){
         goto cleanup;
     }
@@ -385,7 +956,7 @@ EventAggregatorResult EventAggregator_CreateSingleAggregatedEvent(EventAggregato
         goto cleanup;
     }
     
-    QueueResultValues qResult = SyncQueue_PushBack(queue, output, outputSize);
+    QueueResultValues qResult = SyncQueue_PushBackTagged(queue, output, outputSize, aggregator->iotEventType);
     if (qResult == QUEUE_MAX_MEMORY_EXCEEDED) {
         Logger_Warning("Memory limit exceeded, dropping event");
         result = EVENT_AGGREGATOR_OK;
@@ -413,6 +984,27 @@ cleanup:
     return result;
 }
 
+EventAggregatorResult EventAggregator_CreateOtherAggregatedEvent(EventAggregatorHandle aggregator, SyncQueue* queue, time_t* aggregationEndTime) {
+    EventAggregatorResult result = EVENT_AGGREGATOR_OK;
+    AggregatedEventItem otherEvents;
+    memset(&otherEvents, 0, sizeof(AggregatedEventItem));
+    otherEvents.hitCount = aggregator->otherHitCount;
+
+    if (JsonObjectWriter_Init(&otherEvents.json) != JSON_WRITER_OK) {
+        result = EVENT_AGGREGATOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = EventAggregator_CreateSingleAggregatedEvent(aggregator, &otherEvents, aggregator->otherEventsCount, queue, aggregationEndTime);
+
+cleanup:
+    if (otherEvents.json != NULL) {
+        JsonObjectWriter_Deinit(otherEvents.json);
+    }
+
+    return result;
+}
+
 void AggregatedEventItem_Deinit(AggregatedEventItem* item) {
     if (item != NULL) {
         if (item->json != NULL) {
@@ -423,12 +1015,19 @@ void AggregatedEventItem_Deinit(AggregatedEventItem* item) {
 }
 
 EventAggregatorResult EventAggregator_ClearAggregatedEvents(EventAggregatorHandle aggregator) {
-    LIST_ITEM_HANDLE listItem = NULL;
-    while ((listItem = singlylinkedlist_get_head_item(aggregator->aggregatedEvents)) != NULL)
-    {
-        AggregatedEventItem* dataItem = (AggregatedEventItem*)singlylinkedlist_item_get_value(listItem);
-        AggregatedEventItem_Deinit(dataItem);
-        singlylinkedlist_remove(aggregator->aggregatedEvents, listItem);
+    for (uint32_t i = 0; i < aggregator->aggregatedEventsCount; i++) {
+        MemoryMonitor_Release(aggregator->aggregatedEvents[i]->memorySize);
+        AggregatedEventItem_Deinit(aggregator->aggregatedEvents[i]);
+    }
+    aggregator->aggregatedEventsCount = 0;
+    aggregator->firstEvent = NULL;
+    aggregator->lastEvent = NULL;
+    aggregator->otherHitCount = 0;
+    aggregator->otherEventsCount = 0;
+    aggregator->maxEvictedHitCount = 0;
+
+    if (aggregator->index != NULL) {
+        memset(aggregator->index, 0, aggregator->indexSize * sizeof(AggregatedEventItem*));
     }
 
     return EVENT_AGGREGATOR_OK;
@@ -436,19 +1035,17 @@ EventAggregatorResult EventAggregator_ClearAggregatedEvents(EventAggregatorHandl
 
 EventAggregatorResult EventAggregator_CreateAggregatedEvents(EventAggregatorHandle aggregator, time_t* aggregationEndTime, SyncQueue* queue) {
     EventAggregatorResult result = EVENT_AGGREGATOR_OK;
-    LIST_ITEM_HANDLE current = singlylinkedlist_get_head_item(aggregator->aggregatedEvents);
 
-    while (current != NULL) {
-        AggregatedEventItem* dataItem = (AggregatedEventItem*)singlylinkedlist_item_get_value(current);
-        if (dataItem != NULL) {
-            if (EventAggregator_CreateSingleAggregatedEvent(aggregator, dataItem, queue, aggregationEndTime) != EVENT_AGGREGATOR_OK) {
-                result = EVENT_AGGREGATOR_EXCEPTION;
-            }
-        } else {
+    for (AggregatedEventItem* item = aggregator->firstEvent; item != NULL; item = item->next) {
+        if (EventAggregator_CreateSingleAggregatedEvent(aggregator, item, 0, queue, aggregationEndTime) != EVENT_AGGREGATOR_OK) {
+            result = EVENT_AGGREGATOR_EXCEPTION;
+        }
+    }
+
+    if (aggregator->otherEventsCount > 0) {
+        if (EventAggregator_CreateOtherAggregatedEvent(aggregator, queue, aggregationEndTime) != EVENT_AGGREGATOR_OK) {
             result = EVENT_AGGREGATOR_EXCEPTION;
         }
-        
-        current = singlylinkedlist_get_next_item(current);        
     }
 
     if (EventAggregator_ClearAggregatedEvents(aggregator) != EVENT_AGGREGATOR_OK) {
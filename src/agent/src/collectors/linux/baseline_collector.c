@@ -140,7 +140,7 @@ EventCollectorResult BaselineCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(queue, messageBuffer, messageBufferSize, EVENT_TYPE_BASELINE) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
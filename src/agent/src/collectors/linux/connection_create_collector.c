@@ -9,8 +9,8 @@
 
 #include "collectors/event_aggregator.h"
 #include "collectors/linux/generic_audit_event.h"
-#include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "logger.h"
 #include "message_schema_consts.h"
 #include "os_utils/linux/audit/audit_control.h"
@@ -30,6 +30,7 @@ static const char* AUDIT_CONNECTION_CREATION_SYSCALLS[] = {
 };
 static uint32_t AUDIT_CONNECTION_CREATION_SYSCALLS_COUNT = sizeof(AUDIT_CONNECTION_CREATION_SYSCALLS) / sizeof(AUDIT_CONNECTION_CREATION_SYSCALLS[0]);
 static const char AUDIT_CONNECTION_CREATION_CHECKPOINT_FILE[] = "/var/tmp/connectionCreationCheckpoint";
+static const char AUDIT_CONNECTION_CREATION_EXCLUSIONS_KEY[] = "azure_iot_connection_exclusion";
 
 static const char AUDIT_CONNECTION_CREATION_EXECUTABLE[] = "exe";
 static const char AUDIT_CONNECTION_CREATION_CMD[] = "proctitle";
@@ -127,7 +128,7 @@ EventCollectorResult ConnectionCreateEventCollector_GetRemoteInformation(AuditSe
     return EVENT_COLLECTOR_OK;
 }
 
-EventCollectorResult ConnectionCreateEventCollector_GeneratePayload(AuditSearch* auditSearch, JsonObjectWriterHandle connectionCreationEventPayload) {
+EventCollectorResult ConnectionCreateEventCollector_GeneratePayload(AuditSearch* auditSearch, JsonStreamWriter* connectionCreationEventPayload) {
     const char* directionString = NULL;
     ConnectionDirection direction = CONNECTION_DIRECTION_OUTBOUND;
     EventCollectorResult result = EVENT_COLLECTOR_OK;
@@ -149,19 +150,23 @@ EventCollectorResult ConnectionCreateEventCollector_GeneratePayload(AuditSearch*
         return result;
     }
 
-    if (JsonObjectWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_PROTOCOL_KEY, SUPPORTED_PROTOCOL_TCP) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_BeginObject(connectionCreationEventPayload, NULL) != JSON_WRITER_OK) {
         return EVENT_COLLECTOR_EXCEPTION;
     }
 
-    if (JsonObjectWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_DIRECTION_KEY, directionString) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_PROTOCOL_KEY, SUPPORTED_PROTOCOL_TCP) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_DIRECTION_KEY, directionString) != JSON_WRITER_OK) {
         return EVENT_COLLECTOR_RECORD_HAS_ERRORS;
     }
 
-    if (JsonObjectWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, remoteAddress) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, remoteAddress) != JSON_WRITER_OK) {
         return EVENT_COLLECTOR_RECORD_HAS_ERRORS;
     }
 
-    if (JsonObjectWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_REMOTE_PORT_KEY, remotePort) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_WriteString(connectionCreationEventPayload, CONNECTION_CREATION_REMOTE_PORT_KEY, remotePort) != JSON_WRITER_OK) {
         return EVENT_COLLECTOR_RECORD_HAS_ERRORS;
     }
 
@@ -185,24 +190,44 @@ EventCollectorResult ConnectionCreateEventCollector_GeneratePayload(AuditSearch*
         return result;
     }
 
+    if (JsonStreamWriter_EndObject(connectionCreationEventPayload) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
     return EVENT_COLLECTOR_OK;
 }
 
 EventCollectorResult ConnectionCreationCollector_CreateEventForAggregation(AuditSearch* auditSearch, EventAggregatorHandle aggregator) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonStreamWriter payloadWriter;
+    bool payloadWriterInitialized = false;
     JsonObjectWriterHandle connectionCreateEventPayload = NULL;
+    const char* payload = NULL;
+    uint32_t payloadSize = 0;
     ConnectionDirection direction;
 
-    if (JsonObjectWriter_Init(&connectionCreateEventPayload) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Init(&payloadWriter, GENERIC_EVENT_INITIAL_BUFFER_SIZE) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+    payloadWriterInitialized = true;
 
-    result = ConnectionCreateEventCollector_GeneratePayload(auditSearch, connectionCreateEventPayload);
+    result = ConnectionCreateEventCollector_GeneratePayload(auditSearch, &payloadWriter);
     if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
+    // the aggregator keys on the payload, so it gets a mutable copy with the per connection fields zeroed
+    if (JsonStreamWriter_GetOutput(&payloadWriter, &payload, &payloadSize) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_InitFromString(&connectionCreateEventPayload, payload) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
     if (JsonObjectWriter_WriteInt(connectionCreateEventPayload, CONNECTION_CREATION_PROCESS_ID_KEY, 0) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
@@ -230,6 +255,10 @@ cleanup:
         JsonObjectWriter_Deinit(connectionCreateEventPayload);
     }
 
+    if (payloadWriterInitialized) {
+        JsonStreamWriter_Deinit(&payloadWriter);
+    }
+
     return result;
 }
 
@@ -237,15 +266,15 @@ cleanup:
 EventCollectorResult ConnectionCreateEventCollector_CreateSingleEvent(AuditSearch* auditSearch, SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
-    JsonObjectWriterHandle connectionCreationEvent = NULL;
-    JsonObjectWriterHandle connectionCreationEventPayload = NULL;
-    JsonArrayWriterHandle payloads = NULL;
+    JsonStreamWriter connectionCreationEvent;
+    bool connectionCreationEventInitialized = false;
     char* output = NULL;
 
-    if (JsonObjectWriter_Init(&connectionCreationEvent) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Init(&connectionCreationEvent, GENERIC_EVENT_INITIAL_BUFFER_SIZE) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+    connectionCreationEventInitialized = true;
 
     uint32_t eventTimeInSeconds = 0;
     if (AuditSearch_GetEventTime(auditSearch, &eventTimeInSeconds) != AUDIT_SEARCH_OK) {
@@ -254,48 +283,45 @@ EventCollectorResult ConnectionCreateEventCollector_CreateSingleEvent(AuditSearc
     }
     time_t eventTime = (time_t)eventTimeInSeconds;
 
-    if (GenericEvent_AddMetadataWithTimes(connectionCreationEvent, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
+    if (JsonStreamWriter_BeginObject(&connectionCreationEvent, NULL) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
-    if (JsonObjectWriter_Init(&connectionCreationEventPayload) != JSON_WRITER_OK) {
+    if (GenericEvent_WriteMetadataWithTimes(&connectionCreationEvent, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
-    result = ConnectionCreateEventCollector_GeneratePayload(auditSearch, connectionCreationEventPayload);
-    if (result == EVENT_COLLECTOR_RECORD_HAS_ERRORS) {
-        goto cleanup;
-    }
+    result = GenericEvent_BeginPayload(&connectionCreationEvent, false);
     if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    if (JsonArrayWriter_Init(&payloads) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+    result = ConnectionCreateEventCollector_GeneratePayload(auditSearch, &connectionCreationEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    if (JsonArrayWriter_AddObject(payloads, connectionCreationEventPayload) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+    result = GenericEvent_EndPayload(&connectionCreationEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    result = GenericEvent_AddPayload(connectionCreationEvent, payloads);
-    if (result != EVENT_COLLECTOR_OK) {
+    if (JsonStreamWriter_EndObject(&connectionCreationEvent) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(connectionCreationEvent, &output, &outputSize) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_OK;
+    if (JsonStreamWriter_Serialize(&connectionCreationEvent, &output, &outputSize) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
     Logger_Debug("Generated single connection event:\n%s", output);
 
-    QueueResultValues qResult = SyncQueue_PushBack(queue, output, outputSize);
+    QueueResultValues qResult = SyncQueue_PushBackTagged(queue, output, outputSize, EVENT_TYPE_CONNECTION_CREATE);
     if (qResult == QUEUE_MAX_MEMORY_EXCEEDED) {
         result = EVENT_COLLECTOR_OUT_OF_MEM;
         goto cleanup;
@@ -311,16 +337,8 @@ cleanup:
         }
     }
 
-    if (connectionCreationEventPayload != NULL) {
-        JsonObjectWriter_Deinit(connectionCreationEventPayload);
-    }
-
-    if (connectionCreationEvent != NULL) {
-        JsonObjectWriter_Deinit(connectionCreationEvent);
-    }
-
-    if (payloads != NULL) {
-        JsonArrayWriter_Deinit(payloads);
+    if (connectionCreationEventInitialized) {
+        JsonStreamWriter_Deinit(&connectionCreationEvent);
     }
 
     return result;
@@ -399,6 +417,35 @@ cleanup:
     return result;
 }
 
+EventCollectorResult ConnectionCreateEventCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    if (AuditDispatcher_AddHandler(dispatcher, AUDIT_SEARCH_CRITERIA_SYSCALL, AUDIT_CONNECTION_CREATION_SYSCALLS, AUDIT_CONNECTION_CREATION_SYSCALLS_COUNT, handler, context) != AUDIT_DISPATCHER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ConnectionCreateEventCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    bool aggregaionEnabled = false;
+    if (aggregatorInitialized == true && EventAggregator_IsAggregationEnabled(aggregator, &aggregaionEnabled) != EVENT_AGGREGATOR_OK) {
+        Logger_Error("Couldn't fetch IsAggregationEnabled for event aggregator");
+    }
+
+    if (aggregaionEnabled == true) {
+        return ConnectionCreationCollector_CreateEventForAggregation(auditSearch, aggregator);
+    }
+
+    return ConnectionCreateEventCollector_CreateSingleEvent(auditSearch, queue);
+}
+
+EventCollectorResult ConnectionCreateEventCollector_GetAggregatedEvents(SyncQueue* queue) {
+    if (aggregatorInitialized == true && EventAggregator_GetAggregatedEvents(aggregator, queue) != EVENT_AGGREGATOR_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
 EventCollectorResult ConnectionCreateEventCollector_Init() {
     AuditControl audit;
     bool auditInitiated = false;
@@ -421,6 +468,7 @@ EventCollectorResult ConnectionCreateEventCollector_Init() {
     aggregatorConfiguration.event_type = EVENT_TYPE_SECURITY_VALUE;
     aggregatorConfiguration.iotEventType = EVENT_TYPE_CONNECTION_CREATE;
     aggregatorConfiguration.payload_schema_version = CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION;
+    aggregatorConfiguration.port_key = CONNECTION_CREATION_REMOTE_PORT_KEY;
 
     if (EventAggregator_Init(&aggregator, &aggregatorConfiguration) != EVENT_AGGREGATOR_OK) {
         Logger_Error("Could not set initiate event aggregator");
@@ -435,11 +483,42 @@ cleanup:
     return result;
 }
 
+EventCollectorResult ConnectionCreateEventCollector_SetAuditExclusions(const AuditControlExclusions* exclusions) {
+    AuditControl audit;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    if (AuditControl_Init(&audit) != AUDIT_CONTROL_OK) {
+        Logger_Error("Could not init audit control instace.");
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    const char* connectionSyscalls[] = { AUDIT_CONTROL_TYPE_CONNECT, AUDIT_CONTROL_TYPE_ACCEPT };
+    if (AuditControl_SetExclusions(&audit, connectionSyscalls, 2, AUDIT_CONNECTION_CREATION_EXCLUSIONS_KEY, exclusions) != AUDIT_CONTROL_OK) {
+        Logger_Error("Could not set the audit exclusions of connect / accept.");
+        result = EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    AuditControl_Deinit(&audit);
+    return result;
+}
+
 void ConnectionCreateEventCollector_Deinit() {
+    AuditControl audit;
+
     if (aggregatorInitialized) {
         EventAggregator_Deinit(aggregator);
         aggregator = NULL;
     }
+
+    // the kernel would keep dropping the excluded activity once the agent is gone
+    if (AuditControl_Init(&audit) == AUDIT_CONTROL_OK) {
+        if (AuditControl_DeleteExclusions(&audit, AUDIT_CONNECTION_CREATION_EXCLUSIONS_KEY) != AUDIT_CONTROL_OK) {
+            Logger_Warning("Could not delete the audit exclusions of connect / accept.");
+        }
+        AuditControl_Deinit(&audit);
+    } else {
+        Logger_Warning("Could not init audit control instace.");
+    }
 }
 
 EventCollectorResult ConnectionCreationCollector_GetDirection(AuditSearch* auditSearch, ConnectionDirection* direction) {
@@ -12,6 +12,7 @@
 #include "os_utils/linux/iptables/iptables_iterator.h"
 #include "os_utils/linux/iptables/iptables_rules_iterator.h"
 #include "os_utils/process_info_handler.h"
+#include "twin_configuration_defs.h"
 #include "utils.h"
 
 #define BUFFER_MAX_SIZE 300
@@ -147,7 +148,7 @@ EventCollectorResult FirewallCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(queue, messageBuffer, messageBufferSize, EVENT_TYPE_FIREWALL_CONFIGURATION) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
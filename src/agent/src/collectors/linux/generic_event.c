@@ -83,4 +83,73 @@ EventCollectorResult GenericEvent_AddPayload(JsonObjectWriterHandle eventWriter,
     }
 
     return EVENT_COLLECTOR_OK;
-}
\ No newline at end of file
+}
+
+EventCollectorResult GenericEvent_WriteMetadataWithTimes(JsonStreamWriter* eventWriter, const char* eventCategory, const char* eventName, const char* eventType, const char* eventPayloadVersion, time_t* eventLocalTime) {
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_CATEGORY_KEY, eventCategory) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_TYPE_KEY, eventType) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_NAME_KEY, eventName) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_PAYLOAD_SCHEMA_VERSION_KEY, eventPayloadVersion) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    char eventId[EVENT_ID_SIZE] = "";
+    UNIQUEID_RESULT uuidResult = UniqueId_Generate(eventId, sizeof(eventId));
+    if (uuidResult != UNIQUEID_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_ID_KEY, eventId) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    char timeStr[MAX_TIME_AS_STRING_LENGTH];
+    uint32_t timeStrLength = MAX_TIME_AS_STRING_LENGTH;
+    memset(timeStr, 0, timeStrLength);
+
+    if (!TimeUtils_GetTimeAsString(eventLocalTime, timeStr, &timeStrLength)) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_LOCAL_TIMESTAMP_KEY, timeStr) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    timeStrLength = MAX_TIME_AS_STRING_LENGTH;
+    memset(timeStr, 0, timeStrLength);
+    if (!TimeUtils_GetLocalTimeAsUTCTimeAsString(eventLocalTime, timeStr, &timeStrLength)) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+    if (JsonStreamWriter_WriteString(eventWriter, EVENT_UTC_TIMESTAMP_KEY, timeStr) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult GenericEvent_BeginPayload(JsonStreamWriter* eventWriter, bool isEmpty) {
+    if (JsonStreamWriter_WriteBool(eventWriter, EVENT_IS_EMPTY_KEY, isEmpty) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginArray(eventWriter, PAYLOAD_KEY) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult GenericEvent_EndPayload(JsonStreamWriter* eventWriter) {
+    if (JsonStreamWriter_EndArray(eventWriter) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
@@ -14,6 +14,7 @@
 #include "message_schema_consts.h"
 #include "os_utils/listening_ports_iterator.h"
 #include "azure_c_shared_utility/map.h"
+#include "twin_configuration_defs.h"
 #include "utils.h"
 #include "consts.h"
 
@@ -411,7 +412,7 @@ EventCollectorResult ListeningPortCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(queue, messageBuffer, messageBufferSize, EVENT_TYPE_LISTENING_PORTS) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
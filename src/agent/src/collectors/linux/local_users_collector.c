@@ -11,6 +11,7 @@
 #include "message_schema_consts.h"
 #include "os_utils/groups_iterator.h"
 #include "os_utils/users_iterator.h"
+#include "twin_configuration_defs.h"
 #include "utils.h"
 
 
@@ -297,7 +298,7 @@ EventCollectorResult LocalUsersCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(queue, messageBuffer, messageBufferSize, EVENT_TYPE_LOCAL_USERS) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
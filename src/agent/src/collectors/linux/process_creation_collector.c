@@ -6,20 +6,22 @@
 #include <libaudit.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "collectors/event_aggregator.h"
 #include "collectors/generic_event.h"
 #include "collectors/linux/generic_audit_event.h"
-#include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "logger.h"
+#include "lru_cache.h"
 #include "message_schema_consts.h"
 #include "os_utils/linux/audit/audit_control.h"
 #include "os_utils/linux/audit/audit_search_record.h"
 #include "os_utils/linux/audit/audit_search.h"
+#include "os_utils/process_info_handler.h"
 #include "twin_configuration_defs.h"
 #include "utils.h"
-#include "azure_c_shared_utility/map.h"
 
 
 static const char AUDIT_PROCESS_CREATION_TYPE[] = "EXECVE";
@@ -27,6 +29,8 @@ static const char AUDIT_PROCESS_INTEGRITY_TYPE[] = "INTEGRITY_RULE";
 static const char* AUDIT_PROCESS_CREATION_TYPES[] = {AUDIT_PROCESS_CREATION_TYPE, AUDIT_PROCESS_INTEGRITY_TYPE};
 static uint32_t AUDIT_USER_CREATION_TYPES_COUNT = sizeof(AUDIT_PROCESS_CREATION_TYPES) / sizeof(AUDIT_PROCESS_CREATION_TYPES[0]);
 static const char AUDIT_PROCESS_CREATION_CHECKPOINT_FILE[] = "/var/tmp/processCreationCheckpoint";
+static const char PROCESS_CREATION_HASH_CACHE_FILE[] = "/var/tmp/processCreationHashCache";
+static const char PROCESS_CREATION_AUDIT_EXCLUSIONS_KEY[] = "azure_iot_process_exclusion";
 static const char AUDIT_PROCESS_CREATION_EXECUTEABLE[] = "exe";
 static const char AUDIT_PROCESS_CREATION_EXECUTEABLE_HASH[] = "hash";
 static const char AUDIT_PROCESS_CREATION_EXECUTEABLE_PATH[] = "file";
@@ -37,7 +41,14 @@ static const int AUDIT_EXECVE_RECORD_TYPE = 1309; //FIXME: we need to see that i
 static const char AUDIT_ARGC[] = "argc";
 
 #define AUDIT_MAX_PARAM_LEN 10
-static MAP_HANDLE executableHashMap = NULL;
+/*
+ * IMA measures an executable once per boot, so the hash of an executable which was evicted from the cache is
+ * not audited again. The entries are small, so the cache holds the executables of a busy device, and it is filled
+ * from the integrity events of the shared audit stream as they arrive. The executions reported without a hash are counted.
+ */
+#define PROCESS_CREATION_HASH_CACHE_CAPACITY 4096
+static LruCache executableHashCache;
+static uint32_t missingExecutableHashes = 0;
 static EventAggregatorHandle aggregator = NULL;
 static bool aggregatorInitialized = false;
 
@@ -49,17 +60,17 @@ static bool aggregatorInitialized = false;
  * 
  * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
  */
-EventCollectorResult ProcessCreationCollector_ReadCommandLine(AuditSearch* auditSearch, JsonObjectWriterHandle processEventPayload);
+EventCollectorResult ProcessCreationCollector_ReadCommandLine(AuditSearch* auditSearch, JsonStreamWriter* processEventPayload);
 
 /**
- * @brief Generates the payload for the process creation event.
+ * @brief Writes the payload object of the process creation event.
  * 
  * @param   auditSearch             The search instacne.
- * @param   processEventPayload     The event writer of the current process creation event.
+ * @param   processEventPayload     The stream writer to write the payload object to.
  * 
  * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
  */
-EventCollectorResult ProcessCreationCollector_GeneratePayload(AuditSearch* auditSearch, JsonObjectWriterHandle processEventPayload);
+EventCollectorResult ProcessCreationCollector_GeneratePayload(AuditSearch* auditSearch, JsonStreamWriter* processEventPayload);
 
 /**
  * @brief Generates a single process creation event and adds it to the queue.
@@ -82,21 +93,34 @@ EventCollectorResult ProcessCreationCollector_CreateSingleEvent(AuditSearch* aud
 EventCollectorResult ProcessCreationCollector_CreateEventForAgrregation(AuditSearch* auditSearch, EventAggregatorHandle aggregator);
 
 /**
- * @brief Populates the executables hash dictionary
+ * @brief Populates the executables hash cache from the whole audit trail
  * 
  * @return EVENT_COLLECTOR_OK on success.
  */
-EventCollectorResult ProcessCreationCollector_PopulateExecutableHashMap();
+EventCollectorResult ProcessCreationCollector_PopulateExecutableHashCache();
 
 /**
- * @brief Adds an entry to executable hash map. 
+ * @brief Adds an entry to executable hash cache. 
  *        In case that the key(executableName) exists it updates its value.
  * 
  * @param   auditSearch         The search audit.
  * 
  * @return EVENT_COLLECTOR_OK on success.
  */
-EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashMap(AuditSearch* auditSearch);
+EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashCache(AuditSearch* auditSearch);
+
+/**
+ * @brief Saves the executable hash cache, so the next run of the agent does not scan the audit trail again.
+ */
+void ProcessCreationCollector_SaveExecutableHashCache();
+
+/**
+ * @brief Adds the hash of an integrity event of the audit dispatcher to the executable hash cache.
+ *
+ * @param   auditSearch         The search positioned on the event.
+ * @param   context             Unused.
+ */
+void ProcessCreationCollector_OnIntegrityEvent(AuditSearch* auditSearch, void* context);
 
 EventCollectorResult ProcessCreationCollector_GetEvents(SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
@@ -164,22 +188,72 @@ cleanup:
         AuditSearch_Deinit(&auditSearch);
     }
 
+    ProcessCreationCollector_SaveExecutableHashCache();
+
     return result;
 }
 
-EventCollectorResult ProcessCreationCollector_GeneratePayload(AuditSearch* auditSearch, JsonObjectWriterHandle processEventPayload) {
+EventCollectorResult ProcessCreationCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    const char* processCreationTypes[] = { AUDIT_PROCESS_CREATION_TYPE };
+    const char* integrityTypes[] = { AUDIT_PROCESS_INTEGRITY_TYPE };
+
+    if (AuditDispatcher_AddHandler(dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, processCreationTypes, 1, handler, context) != AUDIT_DISPATCHER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    // the hashes come from the same checkpointed stream as the executions, so the cache fills as the executables are measured
+    if (AuditDispatcher_AddHandler(dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, integrityTypes, 1, ProcessCreationCollector_OnIntegrityEvent, NULL) != AUDIT_DISPATCHER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+void ProcessCreationCollector_OnIntegrityEvent(AuditSearch* auditSearch, void* context) {
+    if (ProcessCreationCollector_AddEntryToExecutableHashCache(auditSearch) != EVENT_COLLECTOR_OK) {
+        Logger_Debug("Failed to cache the hash of an integrity event.");
+    }
+}
+
+EventCollectorResult ProcessCreationCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    bool aggregaionEnabled = false;
+    if (aggregatorInitialized == true && EventAggregator_IsAggregationEnabled(aggregator, &aggregaionEnabled) != EVENT_AGGREGATOR_OK) {
+        Logger_Error("Couldn't fetch IsAggregationEnabled for event aggregator");
+    }
+
+    if (aggregaionEnabled == true) {
+        return ProcessCreationCollector_CreateEventForAgrregation(auditSearch, aggregator);
+    }
+
+    return ProcessCreationCollector_CreateSingleEvent(auditSearch, queue);
+}
+
+EventCollectorResult ProcessCreationCollector_GetAggregatedEvents(SyncQueue* queue) {
+    ProcessCreationCollector_SaveExecutableHashCache();
+
+    if (aggregatorInitialized == true && EventAggregator_GetAggregatedEvents(aggregator, queue) != EVENT_AGGREGATOR_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ProcessCreationCollector_GeneratePayload(AuditSearch* auditSearch, JsonStreamWriter* processEventPayload) {
     
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     const char* hash = NULL;
     const char* executable = NULL;
-    JsonObjectWriterHandle extraDetails = NULL;
 
     if (AuditSearch_InterpretString(auditSearch, AUDIT_PROCESS_CREATION_EXECUTEABLE, &executable) != AUDIT_SEARCH_OK){
         return EVENT_COLLECTOR_EXCEPTION;
     }
-    if (JsonObjectWriter_WriteString(processEventPayload, PROCESS_CREATION_EXECUTABLE_KEY, executable) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
+
+    if (JsonStreamWriter_BeginObject(processEventPayload, NULL) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(processEventPayload, PROCESS_CREATION_EXECUTABLE_KEY, executable) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
     }
 
     result = ProcessCreationCollector_ReadCommandLine(auditSearch, processEventPayload);
@@ -202,49 +276,65 @@ EventCollectorResult ProcessCreationCollector_GeneratePayload(AuditSearch* audit
         return result;
     }
 
-    result = ProcessCreationCollector_AddEntryToExecutableHashMap(auditSearch);
+    result = ProcessCreationCollector_AddEntryToExecutableHashCache(auditSearch);
     if (result != EVENT_COLLECTOR_OK){
         return result;
     }
 
-    hash = Map_GetValueFromKey(executableHashMap, executable);
-    hash = (hash != NULL) ? hash : "";
-    if (JsonObjectWriter_Init(&extraDetails) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
+    if (LruCache_Get(&executableHashCache, executable, &hash) != LRU_CACHE_OK) {
+        ++missingExecutableHashes;
+        Logger_Debug("The hash of %s is unknown, %u executions were reported without a hash", executable, missingExecutableHashes);
+        hash = "";
+    }
+    if (JsonStreamWriter_BeginObject(processEventPayload, EXTRA_DETAILS_KEY) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
     }
 
-    if (JsonObjectWriter_WriteString(extraDetails, PROCESS_CREATION_EXECUTABLE_HASH_KEY, hash) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
+    if (JsonStreamWriter_WriteString(processEventPayload, PROCESS_CREATION_EXECUTABLE_HASH_KEY, hash) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
     }
-    if (JsonObjectWriter_WriteObject(processEventPayload, EXTRA_DETAILS_KEY, extraDetails) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
+
+    if (JsonStreamWriter_EndObject(processEventPayload) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
     }
 
-cleanup:
-    if (extraDetails != NULL) {
-        JsonObjectWriter_Deinit(extraDetails);
-    }    
+    if (JsonStreamWriter_EndObject(processEventPayload) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
 
-    return result;
+    return EVENT_COLLECTOR_OK;
 }
 
 EventCollectorResult ProcessCreationCollector_CreateEventForAgrregation(AuditSearch* auditSearch, EventAggregatorHandle aggregator) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
+    JsonStreamWriter payloadWriter;
+    bool payloadWriterInitialized = false;
     JsonObjectWriterHandle processEventPayload = NULL;
-    
-    if (JsonObjectWriter_Init(&processEventPayload) != JSON_WRITER_OK) {
+    const char* payload = NULL;
+    uint32_t payloadSize = 0;
+
+    if (JsonStreamWriter_Init(&payloadWriter, GENERIC_EVENT_INITIAL_BUFFER_SIZE) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+    payloadWriterInitialized = true;
 
-    result = ProcessCreationCollector_GeneratePayload(auditSearch, processEventPayload);
+    result = ProcessCreationCollector_GeneratePayload(auditSearch, &payloadWriter);
     if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
+    // the aggregator keys on the payload, so it gets a mutable copy with the per process fields zeroed
+    if (JsonStreamWriter_GetOutput(&payloadWriter, &payload, &payloadSize) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (JsonObjectWriter_InitFromString(&processEventPayload, payload) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
+        goto cleanup;
+    }
+
     if (JsonObjectWriter_WriteInt(processEventPayload, PROCESS_CREATION_PROCESS_ID_KEY, 0) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
@@ -265,21 +355,25 @@ cleanup:
         JsonObjectWriter_Deinit(processEventPayload);
     }
 
+    if (payloadWriterInitialized) {
+        JsonStreamWriter_Deinit(&payloadWriter);
+    }
+
     return result;
 }
 
 EventCollectorResult ProcessCreationCollector_CreateSingleEvent(AuditSearch* auditSearch, SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
-    JsonObjectWriterHandle processEvent = NULL;
-    JsonObjectWriterHandle processEventPayload = NULL;
-    JsonArrayWriterHandle payloads = NULL;
+    JsonStreamWriter processEvent;
+    bool processEventInitialized = false;
     char* output = NULL;
     
-    if (JsonObjectWriter_Init(&processEvent) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Init(&processEvent, GENERIC_EVENT_INITIAL_BUFFER_SIZE) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+    processEventInitialized = true;
 
     uint32_t eventTimeInSeconds = 0;
     if (AuditSearch_GetEventTime(auditSearch, &eventTimeInSeconds) != AUDIT_SEARCH_OK) {
@@ -287,44 +381,44 @@ EventCollectorResult ProcessCreationCollector_CreateSingleEvent(AuditSearch* aud
         goto cleanup;
     }
     time_t eventTime = (time_t)eventTimeInSeconds;
-    
-    if (GenericEvent_AddMetadataWithTimes(processEvent, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
+
+    if (JsonStreamWriter_BeginObject(&processEvent, NULL) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
-
-    if (JsonObjectWriter_Init(&processEventPayload) != JSON_WRITER_OK) {
+    
+    if (GenericEvent_WriteMetadataWithTimes(&processEvent, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
-    result = ProcessCreationCollector_GeneratePayload(auditSearch, processEventPayload);
+    result = GenericEvent_BeginPayload(&processEvent, false);
     if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
-    
-    if (JsonArrayWriter_Init(&payloads) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+
+    result = ProcessCreationCollector_GeneratePayload(auditSearch, &processEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    if (JsonArrayWriter_AddObject(payloads, processEventPayload) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+    result = GenericEvent_EndPayload(&processEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    result = GenericEvent_AddPayload(processEvent, payloads); 
-    if (result != EVENT_COLLECTOR_OK) {
+    if (JsonStreamWriter_EndObject(&processEvent) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
     
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(processEvent, &output, &outputSize) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Serialize(&processEvent, &output, &outputSize) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
     
-    QueueResultValues qResult = SyncQueue_PushBack(queue, output, outputSize);
+    QueueResultValues qResult = SyncQueue_PushBackTagged(queue, output, outputSize, EVENT_TYPE_PROCESS_CREATE);
     if (qResult == QUEUE_MAX_MEMORY_EXCEEDED) {
         result = EVENT_COLLECTOR_OUT_OF_MEM;
         goto cleanup;
@@ -340,22 +434,14 @@ cleanup:
         }
     }
 
-    if (processEventPayload != NULL) {
-        JsonObjectWriter_Deinit(processEventPayload);
-    }
-
-    if (processEvent != NULL) {
-        JsonObjectWriter_Deinit(processEvent);
-    }
-
-    if (payloads != NULL) {
-        JsonArrayWriter_Deinit(payloads);
+    if (processEventInitialized) {
+        JsonStreamWriter_Deinit(&processEvent);
     }
 
     return result;
 }
 
-EventCollectorResult ProcessCreationCollector_ReadCommandLine(AuditSearch* auditSearch, JsonObjectWriterHandle processEventPayload) {
+EventCollectorResult ProcessCreationCollector_ReadCommandLine(AuditSearch* auditSearch, JsonStreamWriter* processEventPayload) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
     char* commandLineBuffer = NULL;
     if (AuditSearchRecord_Goto(auditSearch, AUDIT_EXECVE_RECORD_TYPE) != AUDIT_SEARCH_OK) {
@@ -400,7 +486,7 @@ EventCollectorResult ProcessCreationCollector_ReadCommandLine(AuditSearch* audit
         }
     }
 
-    if (JsonObjectWriter_WriteString(processEventPayload, PROCESS_CREATION_COMMAND_LINE_KEY, commandLineBuffer) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_WriteString(processEventPayload, PROCESS_CREATION_COMMAND_LINE_KEY, commandLineBuffer) != JSON_WRITER_OK) {
             result = EVENT_COLLECTOR_EXCEPTION;
             goto cleanup;
     }
@@ -412,17 +498,11 @@ cleanup:
     return result;
 }
 
-EventCollectorResult ProcessCreationCollector_PopulateExecutableHashMap() {
+EventCollectorResult ProcessCreationCollector_PopulateExecutableHashCache() {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
-    executableHashMap = Map_Create(NULL);
     bool auditSearchInitialize = false;
     AuditSearch auditSearch;
 
-    if (executableHashMap == NULL){
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
-    }
-
     if (AuditSearch_Init(&auditSearch, AUDIT_SEARCH_CRITERIA_TYPE, AUDIT_PROCESS_INTEGRITY_TYPE, NULL) != AUDIT_SEARCH_OK){
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
@@ -431,7 +511,7 @@ EventCollectorResult ProcessCreationCollector_PopulateExecutableHashMap() {
 
     AuditSearchResultValues hasNextResult = AuditSearch_GetNext(&auditSearch);
     while (hasNextResult == AUDIT_SEARCH_HAS_MORE_DATA) {
-        result = ProcessCreationCollector_AddEntryToExecutableHashMap(&auditSearch);
+        result = ProcessCreationCollector_AddEntryToExecutableHashCache(&auditSearch);
         if (result != EVENT_COLLECTOR_OK) {
             goto cleanup;
         }
@@ -446,7 +526,7 @@ cleanup:
 
 }
 
-EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashMap(AuditSearch* auditSearch) {
+EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashCache(AuditSearch* auditSearch) {
     AuditSearchResultValues result = AUDIT_SEARCH_OK;
     const char* executable = NULL;
     const char* hash = NULL;
@@ -457,28 +537,48 @@ EventCollectorResult ProcessCreationCollector_AddEntryToExecutableHashMap(AuditS
     }
     if (hash != NULL){
         char* Hash = NULL;
-        // hash value starts with "\"sha1:" and ends with "\"" so we want to clean those characters
-        if(!Utils_Substring(hash, &Hash, 6,1)){
+        // hash value is quoted and prefixed by its algorithm, e.g. "\"sha256:", so we want to clean those characters
+        const char* digest = strchr(hash, ':');
+        if (digest == NULL || !Utils_Substring(digest, &Hash, 1, 1)) {
             return EVENT_COLLECTOR_EXCEPTION;
         }
         result = AuditSearch_InterpretString(auditSearch, AUDIT_PROCESS_CREATION_EXECUTEABLE_PATH, &executable);
         if (result != AUDIT_SEARCH_OK && result != AUDIT_SEARCH_FIELD_DOES_NOT_EXIST) {
+            free(Hash);
             return EVENT_COLLECTOR_EXCEPTION;
         }
-        MAP_RESULT mapResult = Map_AddOrUpdate(executableHashMap, executable, Hash);
-        if (mapResult != MAP_OK && mapResult != MAP_KEYEXISTS){
-            result = EVENT_COLLECTOR_EXCEPTION;
+        // an executable whose path or hash do not fit the cache is reported without a hash
+        if (executable != NULL && LruCache_Put(&executableHashCache, executable, Hash) != LRU_CACHE_OK) {
+            Logger_Debug("Could not cache the hash of %s", executable);
         }
+        free(Hash);
     }
 
     return EVENT_COLLECTOR_OK;
 }
 
+void ProcessCreationCollector_SaveExecutableHashCache() {
+    ProcessInfo processInfo;
+
+    // the cache file is private to root, so other users can not plant hashes in it
+    if (!ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        Logger_Warning("Can not set privileges to root.");
+        return;
+    }
+
+    if (LruCache_Save(&executableHashCache) != LRU_CACHE_OK) {
+        Logger_Warning("Could not save the executable hash cache.");
+    }
+
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+}
+
 EventCollectorResult ProcessCreationCollector_Init() {
     AuditControl audit;
     bool auditInitiated = false;
     EventCollectorResult result = EVENT_COLLECTOR_OK;
-    size_t count = 0;
 
     if (AuditControl_Init(&audit) != AUDIT_CONTROL_OK) {
         Logger_Error("Could not init audit control instace.");
@@ -498,21 +598,29 @@ EventCollectorResult ProcessCreationCollector_Init() {
     aggregatorConfiguration.event_type = EVENT_TYPE_SECURITY_VALUE;
     aggregatorConfiguration.iotEventType = EVENT_TYPE_PROCESS_CREATE;
     aggregatorConfiguration.payload_schema_version = PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION;
+    aggregatorConfiguration.port_key = NULL;
     
     if (EventAggregator_Init(&aggregator, &aggregatorConfiguration) != EVENT_AGGREGATOR_OK) {
         Logger_Error("Could not set initiate event aggregator");
     }
 
     aggregatorInitialized = true;
-    if(ProcessCreationCollector_PopulateExecutableHashMap() != EVENT_COLLECTOR_OK){
+    // loaded while the audit control holds the root privileges, as the cache file is private to root
+    if (LruCache_Init(&executableHashCache, PROCESS_CREATION_HASH_CACHE_CAPACITY, PROCESS_CREATION_HASH_CACHE_FILE) != LRU_CACHE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
-    if (!(Utils_GetMapSize(executableHashMap, &count))){
-        result = EVENT_COLLECTOR_EXCEPTION;
-        goto cleanup;
+
+    // the saved cache already holds the hashes of the audit trail, it is scanned only on the first run
+    if (LruCache_GetCount(&executableHashCache) == 0) {
+        if (ProcessCreationCollector_PopulateExecutableHashCache() != EVENT_COLLECTOR_OK) {
+            result = EVENT_COLLECTOR_EXCEPTION;
+            goto cleanup;
+        }
+        ProcessCreationCollector_SaveExecutableHashCache();
     }
-    if (count == 0){
+
+    if (LruCache_GetCount(&executableHashCache) == 0){
         Logger_Error("Could not collect auditd integrity_rule events. It might happen if you haven't rebooted the machine after the agent installation.");
     }
 
@@ -524,12 +632,45 @@ cleanup:
     return result;
 }
 
+EventCollectorResult ProcessCreationCollector_SetAuditExclusions(const AuditControlExclusions* exclusions) {
+    AuditControl audit;
+    EventCollectorResult result = EVENT_COLLECTOR_OK;
+
+    if (AuditControl_Init(&audit) != AUDIT_CONTROL_OK) {
+        Logger_Error("Could not init audit control instace.");
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    const char* processSyscalls[] = {AUDIT_CONTROL_TYPE_EXECVE, AUDIT_CONTROL_TYPE_EXECVEAT};
+    if (AuditControl_SetExclusions(&audit, processSyscalls, 2, PROCESS_CREATION_AUDIT_EXCLUSIONS_KEY, exclusions) != AUDIT_CONTROL_OK) {
+        Logger_Error("Could not set the audit exclusions of execve.");
+        result = EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    AuditControl_Deinit(&audit);
+    return result;
+}
+
 void ProcessCreationCollector_Deinit() {
+    AuditControl audit;
+
     if (aggregatorInitialized) {
         EventAggregator_Deinit(aggregator);
         aggregator = NULL;
     }
-    if (executableHashMap != NULL){
-        Map_Destroy(executableHashMap);
+
+    // the kernel would keep dropping the excluded activity once the agent is gone
+    if (AuditControl_Init(&audit) == AUDIT_CONTROL_OK) {
+        if (AuditControl_DeleteExclusions(&audit, PROCESS_CREATION_AUDIT_EXCLUSIONS_KEY) != AUDIT_CONTROL_OK) {
+            Logger_Warning("Could not delete the audit exclusions of execve.");
+        }
+        AuditControl_Deinit(&audit);
+    } else {
+        Logger_Warning("Could not init audit control instace.");
+    }
+    ProcessCreationCollector_SaveExecutableHashCache();
+    LruCache_Deinit(&executableHashCache);
+    if (missingExecutableHashes > 0) {
+        Logger_Information("%u executions were reported without a hash", missingExecutableHashes);
     }
 }
\ No newline at end of file
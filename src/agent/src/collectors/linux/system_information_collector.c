@@ -10,6 +10,7 @@
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 /**
  * @brief write the memory info to the given json writer.
@@ -189,7 +190,7 @@ EventCollectorResult SystemInformationCollector_GetEvents(SyncQueue* queue) {
         goto cleanup;
     }
 
-    if (SyncQueue_PushBack(queue, messageBuffer, messageBufferSize) != QUEUE_OK) {
+    if (SyncQueue_PushBackTagged(queue, messageBuffer, messageBufferSize, EVENT_TYPE_SYSTEM_INFORMATION) != QUEUE_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
@@ -8,10 +8,10 @@
 
 #include "os_utils/linux/audit/audit_search.h"
 #include "collectors/linux/generic_audit_event.h"
-#include "json/json_array_writer.h"
-#include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "logger.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 #include "utils.h"
 
 static const char* AUDIT_USER_LOGIN_TYPES[] = {"USER_LOGIN", "USER_AUTH"};
@@ -29,14 +29,14 @@ static const char AUDIT_USER_LOGIN_NOT_A_REAL_REMOTE_ADDRESS[] = "?";
 static const char AUDIT_USER_LOGIN_OPERATION[] = "op";
 
 /**
- * @brief Generates the payload for the login event.
+ * @brief Writes the payload object of the login event.
  * 
  * @param   auditSearch               The search instacne.
- * @param   userLoginEventPayload     The event writer of the current login event.
+ * @param   userLoginEventPayload     The stream writer to write the payload object to.
  * 
  * @return EVENT_COLLECTOR_OK on success or the coressponind error on failure.
  */
-EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, JsonObjectWriterHandle userLoginEventPayload);
+EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, JsonStreamWriter* userLoginEventPayload);
 
 /**
  * @brief Generates a single login event and adds it to the queue.
@@ -101,11 +101,27 @@ cleanup:
     return result;
 }
 
-EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, JsonObjectWriterHandle userLoginEventPayload) {
+EventCollectorResult UserLoginCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    if (AuditDispatcher_AddHandler(dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, AUDIT_USER_LOGIN_TYPES, AUDIT_USER_LOGIN_TYPES_COUNT, handler, context) != AUDIT_DISPATCHER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult UserLoginCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    return UserLoginEvent_CreateSingleEvent(auditSearch, queue);
+}
+
+EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, JsonStreamWriter* userLoginEventPayload) {
     const char* auditStrValue = NULL;
     AuditSearchResultValues auditResult;
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
+    if (JsonStreamWriter_BeginObject(userLoginEventPayload, NULL) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
     result = GenericAuditEvent_HandleIntValue(userLoginEventPayload, auditSearch, AUDIT_USER_LOGIN_PROCESS_ID, USER_LOGIN_PROCESS_ID_KEY, false);
     if (result != EVENT_COLLECTOR_OK) {
         return result;
@@ -129,7 +145,7 @@ EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, Js
     auditResult = AuditSearch_ReadString(auditSearch, AUDIT_USER_LOGIN_REMOTE_ADDRESS, &auditStrValue);
     if (auditResult == AUDIT_SEARCH_OK) {
         if (!Utils_UnsafeAreStringsEqual(auditStrValue, AUDIT_USER_LOGIN_NOT_A_REAL_REMOTE_ADDRESS, false)) {
-            if (JsonObjectWriter_WriteString(userLoginEventPayload, USER_LOGIN_REMOTE_ADDRESS_KEY, auditStrValue) != JSON_WRITER_OK) {
+            if (JsonStreamWriter_WriteString(userLoginEventPayload, USER_LOGIN_REMOTE_ADDRESS_KEY, auditStrValue) != JSON_WRITER_OK) {
                 return EVENT_COLLECTOR_EXCEPTION;
             }
         }
@@ -143,11 +159,11 @@ EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, Js
     }
     
     if (Utils_UnsafeAreStringsEqual(auditStrValue, AUDIT_USER_LOGIN_RESULT_SUCCESS, false)) {
-        if (JsonObjectWriter_WriteString(userLoginEventPayload, USER_LOGIN_RESULT_KEY, USER_LOGIN_RESULT_SUCCESS_VALUE) != JSON_WRITER_OK) {
+        if (JsonStreamWriter_WriteString(userLoginEventPayload, USER_LOGIN_RESULT_KEY, USER_LOGIN_RESULT_SUCCESS_VALUE) != JSON_WRITER_OK) {
             return EVENT_COLLECTOR_EXCEPTION;
         }
     } else if (Utils_UnsafeAreStringsEqual(auditStrValue, AUDIT_USER_LOGIN_RESULT_FAILED, false)) {
-        if (JsonObjectWriter_WriteString(userLoginEventPayload, USER_LOGIN_RESULT_KEY, USER_LOGIN_RESULT_FAILED_VALUE) != JSON_WRITER_OK) {
+        if (JsonStreamWriter_WriteString(userLoginEventPayload, USER_LOGIN_RESULT_KEY, USER_LOGIN_RESULT_FAILED_VALUE) != JSON_WRITER_OK) {
             return EVENT_COLLECTOR_EXCEPTION;
         }
     } else {
@@ -155,21 +171,29 @@ EventCollectorResult UserLoginEvent_GeneratePayload(AuditSearch* auditSearch, Js
     }
 
     result = GenericAuditEvent_HandleStringValue(userLoginEventPayload, auditSearch, AUDIT_USER_LOGIN_OPERATION, USER_LOGIN_OPERATION_KEY, true);
-    return result;
+    if (result != EVENT_COLLECTOR_OK) {
+        return result;
+    }
+
+    if (JsonStreamWriter_EndObject(userLoginEventPayload) != JSON_WRITER_OK) {
+        return EVENT_COLLECTOR_EXCEPTION;
+    }
+
+    return EVENT_COLLECTOR_OK;
 }
 
 EventCollectorResult UserLoginEvent_CreateSingleEvent(AuditSearch* auditSearch, SyncQueue* queue) {
     EventCollectorResult result = EVENT_COLLECTOR_OK;
 
-    JsonObjectWriterHandle userLoginEvent = NULL;
-    JsonObjectWriterHandle userLoginEventPayload = NULL;
-    JsonArrayWriterHandle payloads = NULL;
+    JsonStreamWriter userLoginEvent;
+    bool userLoginEventInitialized = false;
     char* output = NULL;
     
-    if (JsonObjectWriter_Init(&userLoginEvent) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Init(&userLoginEvent, GENERIC_EVENT_INITIAL_BUFFER_SIZE) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
+    userLoginEventInitialized = true;
 
     uint32_t eventTimeInSeconds = 0;
     if (AuditSearch_GetEventTime(auditSearch, &eventTimeInSeconds) != AUDIT_SEARCH_OK) {
@@ -177,44 +201,44 @@ EventCollectorResult UserLoginEvent_CreateSingleEvent(AuditSearch* auditSearch,
         goto cleanup;
     }
     time_t eventTime = (time_t)eventTimeInSeconds;
-    
-    if (GenericEvent_AddMetadataWithTimes(userLoginEvent, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
+
+    if (JsonStreamWriter_BeginObject(&userLoginEvent, NULL) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
-
-    if (JsonObjectWriter_Init(&userLoginEventPayload) != JSON_WRITER_OK) {
+    
+    if (GenericEvent_WriteMetadataWithTimes(&userLoginEvent, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, &eventTime) != EVENT_COLLECTOR_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
 
-    result = UserLoginEvent_GeneratePayload(auditSearch, userLoginEventPayload);
+    result = GenericEvent_BeginPayload(&userLoginEvent, false);
     if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
-    
-    if (JsonArrayWriter_Init(&payloads) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+
+    result = UserLoginEvent_GeneratePayload(auditSearch, &userLoginEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    if (JsonArrayWriter_AddObject(payloads, userLoginEventPayload) != JSON_WRITER_OK) {
-        result = EVENT_COLLECTOR_EXCEPTION;
+    result = GenericEvent_EndPayload(&userLoginEvent);
+    if (result != EVENT_COLLECTOR_OK) {
         goto cleanup;
     }
 
-    result = GenericEvent_AddPayload(userLoginEvent, payloads); 
-    if (result != EVENT_COLLECTOR_OK) {
+    if (JsonStreamWriter_EndObject(&userLoginEvent) != JSON_WRITER_OK) {
+        result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
     
     uint32_t outputSize = 0;
-    if (JsonObjectWriter_Serialize(userLoginEvent, &output, &outputSize) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_Serialize(&userLoginEvent, &output, &outputSize) != JSON_WRITER_OK) {
         result = EVENT_COLLECTOR_EXCEPTION;
         goto cleanup;
     }
     
-    QueueResultValues qResult = SyncQueue_PushBack(queue, output, outputSize);
+    QueueResultValues qResult = SyncQueue_PushBackTagged(queue, output, outputSize, EVENT_TYPE_USER_LOGIN);
     if (qResult == QUEUE_MAX_MEMORY_EXCEEDED) {
         result = EVENT_COLLECTOR_OUT_OF_MEM;
         goto cleanup;
@@ -230,16 +254,8 @@ cleanup:
         }
     }
 
-    if (userLoginEventPayload != NULL) {
-        JsonObjectWriter_Deinit(userLoginEventPayload);
-    }
-
-    if (userLoginEvent != NULL) {
-        JsonObjectWriter_Deinit(userLoginEvent);
-    }
-
-    if (payloads != NULL) {
-        JsonArrayWriter_Deinit(payloads);
+    if (userLoginEventInitialized) {
+        JsonStreamWriter_Deinit(&userLoginEvent);
     }
 
     return result;
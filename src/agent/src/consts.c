@@ -21,16 +21,34 @@ uint32_t DEFAULT_HIGH_PRIORITY_MESSAGE_FREQUENCY = 7 * MILLISECONDS_IN_A_MINUTE;
 
 uint32_t DEFAULT_SNAPSHOT_FREQUENCY = 13 * MILLISECONDS_IN_AN_HOUR;
 
+const bool DEFAULT_EVICT_LOW_PRIORITY_EVENTS = true;
+
+uint32_t DEFAULT_COLLECTOR_TIME_BUDGET = 5 * MILLISECONDS_IN_A_MINUTE;
+
+uint32_t DEFAULT_MAX_PUBLISHED_BYTES_PER_CYCLE = 1024 * 1024; // 1MB
+
+const bool DEFAULT_COMPRESS_MESSAGES = false;
+
+const bool DEFAULT_ENCODE_MESSAGES_AS_CBOR = false;
+
 const bool DEFAULT_BASELINE_CUSTOM_CHECKS_ENABLED = false;
 
 const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_PATH = NULL;
 
 const char* DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH = NULL;
 
+const char* DEFAULT_AUDIT_EXCLUDED_EXECUTABLES = NULL;
+
+const char* DEFAULT_AUDIT_EXCLUDED_UIDS = NULL;
+
+const char* DEFAULT_AUDIT_EXCLUDED_AUID_RANGES = NULL;
+
 const uint32_t SCHEDULER_INTERVAL = 1 * 1000;
 
 const uint32_t TWIN_UPDATE_SCHEDULER_INTERVAL = 10 * 1000;
 
+const uint32_t EVENT_QUEUE_CAPACITY = 8 * 1024;
+
 const uint32_t MESSAGE_BILLING_MULTIPLE = 4 * 1024;
 
 const char CONFIGURATION_FILE[] = "/LocalConfiguration.json";
@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "event_splitter.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "azure_c_shared_utility/uniqueid.h"
+
+#include "logger.h"
+#include "message_schema_consts.h"
+
+/**
+ * The size of a generated event id, including the null terminator.
+ */
+#define EVENT_SPLITTER_ID_SIZE 37
+
+/**
+ * The positions of the parts of a serialized event which are changed by the splitter.
+ */
+typedef struct _EventLayout {
+
+    bool hasId;
+    uint32_t idStart;
+    uint32_t idEnd;
+
+    uint32_t payloadStart;
+    uint32_t payloadEnd;
+
+} EventLayout;
+
+/**
+ * @brief Advances the position past any whitespace.
+ *
+ * @param   json        The serialized json.
+ * @param   size        The size of the serialized json.
+ * @param   position    In-out param. The position to advance.
+ */
+static void EventSplitter_SkipWhitespace(const char* json, uint32_t size, uint32_t* position);
+
+/**
+ * @brief Advances the position past the string which starts at it.
+ *
+ * @param   json        The serialized json.
+ * @param   size        The size of the serialized json.
+ * @param   position    In-out param. The position of the opening quote, set to the position after the closing quote.
+ *
+ * @return true on success, false if the string is not terminated.
+ */
+static bool EventSplitter_SkipString(const char* json, uint32_t size, uint32_t* position);
+
+/**
+ * @brief Advances the position past the json value which starts at it.
+ *        Objects and arrays are skipped by their brackets and are not validated.
+ *
+ * @param   json        The serialized json.
+ * @param   size        The size of the serialized json.
+ * @param   position    In-out param. The position of the value, set to the position after it.
+ *
+ * @return true on success, false if the value is not terminated.
+ */
+static bool EventSplitter_SkipValue(const char* json, uint32_t size, uint32_t* position);
+
+/**
+ * @brief Finds the payload array and the id of the given event.
+ *
+ * @param   event       The serialized event.
+ * @param   eventSize   The size of the serialized event.
+ * @param   layout      Out param. The layout of the event.
+ *
+ * @return true if the event is an object with a payload array, false otherwise.
+ */
+static bool EventSplitter_ParseLayout(const char* event, uint32_t eventSize, EventLayout* layout);
+
+/**
+ * @brief Copies a range of the original event, replacing its id if the range contains it.
+ *
+ * @param   event       The serialized event.
+ * @param   from        The start of the range.
+ * @param   to          The end of the range, exclusive.
+ * @param   layout      The layout of the event.
+ * @param   newId       The id to write instead of the original one.
+ * @param   output      The buffer to copy to.
+ * @param   offset      In-out param. The position in the output to copy to, advanced by the copied size.
+ */
+static void EventSplitter_CopyRange(const char* event, uint32_t from, uint32_t to, const EventLayout* layout, const char* newId, char* output, uint32_t* offset);
+
+/**
+ * @brief Creates a new event with the given range of payload elements and hands it to the callback.
+ *
+ * @param   event           The serialized event.
+ * @param   eventSize       The size of the serialized event.
+ * @param   layout          The layout of the event.
+ * @param   elementsStart   The start of the payload elements range.
+ * @param   elementsEnd     The end of the payload elements range, exclusive.
+ * @param   callback        The callback to hand the event to.
+ * @param   context         The context of the callback.
+ *
+ * @return EVENT_SPLITTER_OK on success, EVENT_SPLITTER_EXCEPTION otherwise.
+ */
+static EventSplitterResult EventSplitter_EmitEvent(const char* event, uint32_t eventSize, const EventLayout* layout, uint32_t elementsStart, uint32_t elementsEnd, EventSplitterCallback callback, void* context);
+
+static void EventSplitter_SkipWhitespace(const char* json, uint32_t size, uint32_t* position) {
+    while (*position < size && isspace((unsigned char)json[*position])) {
+        (*position)++;
+    }
+}
+
+static bool EventSplitter_SkipString(const char* json, uint32_t size, uint32_t* position) {
+    uint32_t current = *position + 1;
+    while (current < size) {
+        if (json[current] == '\\') {
+            current += 2;
+        } else if (json[current] == '"') {
+            *position = current + 1;
+            return true;
+        } else {
+            current++;
+        }
+    }
+
+    return false;
+}
+
+static bool EventSplitter_SkipValue(const char* json, uint32_t size, uint32_t* position) {
+    uint32_t current = *position;
+    if (current >= size) {
+        return false;
+    }
+
+    if (json[current] == '"') {
+        return EventSplitter_SkipString(json, size, position);
+    }
+
+    if (json[current] == '{' || json[current] == '[') {
+        uint32_t depth = 0;
+        while (current < size) {
+            char c = json[current];
+            if (c == '"') {
+                if (!EventSplitter_SkipString(json, size, &current)) {
+                    return false;
+                }
+                continue;
+            }
+
+            if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                depth--;
+                if (depth == 0) {
+                    *position = current + 1;
+                    return true;
+                }
+            }
+            current++;
+        }
+
+        return false;
+    }
+
+    // a literal, a number, true, false or null
+    while (current < size && strchr(",}] \t\r\n", json[current]) == NULL) {
+        current++;
+    }
+    if (current == *position) {
+        return false;
+    }
+
+    *position = current;
+    return true;
+}
+
+static bool EventSplitter_ParseLayout(const char* event, uint32_t eventSize, EventLayout* layout) {
+    bool hasPayload = false;
+    uint32_t position = 0;
+    memset(layout, 0, sizeof(*layout));
+
+    EventSplitter_SkipWhitespace(event, eventSize, &position);
+    if (position >= eventSize || event[position] != '{') {
+        return false;
+    }
+    position++;
+
+    while (true) {
+        EventSplitter_SkipWhitespace(event, eventSize, &position);
+        if (position >= eventSize || event[position] != '"') {
+            return false;
+        }
+
+        const char* key = event + position + 1;
+        if (!EventSplitter_SkipString(event, eventSize, &position)) {
+            return false;
+        }
+        size_t keyLength = event + position - 1 - key;
+
+        EventSplitter_SkipWhitespace(event, eventSize, &position);
+        if (position >= eventSize || event[position] != ':') {
+            return false;
+        }
+        position++;
+        EventSplitter_SkipWhitespace(event, eventSize, &position);
+
+        uint32_t valueStart = position;
+        if (!EventSplitter_SkipValue(event, eventSize, &position)) {
+            return false;
+        }
+
+        if (event[valueStart] == '[' && keyLength == strlen(PAYLOAD_KEY) && memcmp(key, PAYLOAD_KEY, keyLength) == 0) {
+            layout->payloadStart = valueStart + 1;
+            layout->payloadEnd = position - 1;
+            hasPayload = true;
+        } else if (event[valueStart] == '"' && keyLength == strlen(EVENT_ID_KEY) && memcmp(key, EVENT_ID_KEY, keyLength) == 0) {
+            layout->idStart = valueStart + 1;
+            layout->idEnd = position - 1;
+            layout->hasId = true;
+        }
+
+        EventSplitter_SkipWhitespace(event, eventSize, &position);
+        if (position >= eventSize) {
+            return false;
+        }
+        if (event[position] == '}') {
+            break;
+        }
+        if (event[position] != ',') {
+            return false;
+        }
+        position++;
+    }
+
+    return hasPayload;
+}
+
+static void EventSplitter_CopyRange(const char* event, uint32_t from, uint32_t to, const EventLayout* layout, const char* newId, char* output, uint32_t* offset) {
+    if (layout->hasId && layout->idStart >= from && layout->idEnd <= to) {
+        memcpy(output + *offset, event + from, layout->idStart - from);
+        *offset += layout->idStart - from;
+        memcpy(output + *offset, newId, EVENT_SPLITTER_ID_SIZE - 1);
+        *offset += EVENT_SPLITTER_ID_SIZE - 1;
+        from = layout->idEnd;
+    }
+
+    memcpy(output + *offset, event + from, to - from);
+    *offset += to - from;
+}
+
+static EventSplitterResult EventSplitter_EmitEvent(const char* event, uint32_t eventSize, const EventLayout* layout, uint32_t elementsStart, uint32_t elementsEnd, EventSplitterCallback callback, void* context) {
+    char newId[EVENT_SPLITTER_ID_SIZE] = "";
+    uint32_t idSize = 0;
+    if (layout->hasId) {
+        if (UniqueId_Generate(newId, sizeof(newId)) != UNIQUEID_OK) {
+            Logger_Error("failed generating an id for a split event");
+            return EVENT_SPLITTER_EXCEPTION;
+        }
+        idSize = layout->idEnd - layout->idStart;
+    }
+
+    uint32_t newEventSize = eventSize - idSize + (layout->hasId ? EVENT_SPLITTER_ID_SIZE - 1 : 0) - (layout->payloadEnd - layout->payloadStart) + (elementsEnd - elementsStart);
+    char* newEvent = malloc(newEventSize + 1);
+    if (newEvent == NULL) {
+        Logger_Error("failed allocating a split event");
+        return EVENT_SPLITTER_EXCEPTION;
+    }
+
+    uint32_t offset = 0;
+    EventSplitter_CopyRange(event, 0, layout->payloadStart, layout, newId, newEvent, &offset);
+    memcpy(newEvent + offset, event + elementsStart, elementsEnd - elementsStart);
+    offset += elementsEnd - elementsStart;
+    EventSplitter_CopyRange(event, layout->payloadEnd, eventSize, layout, newId, newEvent, &offset);
+    newEvent[offset] = '\0';
+
+    // the callback owns the event from here on
+    if (!callback(context, newEvent, offset)) {
+        return EVENT_SPLITTER_EXCEPTION;
+    }
+
+    return EVENT_SPLITTER_OK;
+}
+
+EventSplitterResult EventSplitter_Split(const char* event, uint32_t eventSize, uint32_t maxEventSize, EventSplitterCallback callback, void* context) {
+    EventLayout layout;
+    if (!EventSplitter_ParseLayout(event, eventSize, &layout)) {
+        Logger_Warning("the event has no payload array and cannot be split");
+        return EVENT_SPLITTER_NOT_SPLITTABLE;
+    }
+
+    // the size of the event with an empty payload array and a regenerated id
+    uint32_t emptyEventSize = eventSize - (layout.payloadEnd - layout.payloadStart);
+    if (layout.hasId) {
+        emptyEventSize = emptyEventSize - (layout.idEnd - layout.idStart) + EVENT_SPLITTER_ID_SIZE - 1;
+    }
+    if (emptyEventSize >= maxEventSize) {
+        Logger_Warning("the metadata of the event alone exceeds the max event size");
+        return EVENT_SPLITTER_NOT_SPLITTABLE;
+    }
+    uint32_t maxElementsSize = maxEventSize - emptyEventSize;
+
+    uint32_t eventsCount = 0;
+    uint32_t droppedCount = 0;
+    uint32_t chunkStart = 0;
+    uint32_t chunkEnd = 0;
+    bool isChunkEmpty = true;
+    uint32_t position = layout.payloadStart;
+
+    EventSplitter_SkipWhitespace(event, layout.payloadEnd, &position);
+    while (position < layout.payloadEnd) {
+        uint32_t elementStart = position;
+        if (!EventSplitter_SkipValue(event, layout.payloadEnd, &position)) {
+            return EVENT_SPLITTER_NOT_SPLITTABLE;
+        }
+        uint32_t elementEnd = position;
+
+        EventSplitter_SkipWhitespace(event, layout.payloadEnd, &position);
+        if (position < layout.payloadEnd && event[position] == ',') {
+            position++;
+            EventSplitter_SkipWhitespace(event, layout.payloadEnd, &position);
+        }
+
+        if (!isChunkEmpty && elementEnd - chunkStart <= maxElementsSize) {
+            // the elements of a chunk are adjacent, so the chunk is copied together with its separators
+            chunkEnd = elementEnd;
+            continue;
+        }
+
+        if (!isChunkEmpty) {
+            if (EventSplitter_EmitEvent(event, eventSize, &layout, chunkStart, chunkEnd, callback, context) != EVENT_SPLITTER_OK) {
+                return EVENT_SPLITTER_EXCEPTION;
+            }
+            eventsCount++;
+            isChunkEmpty = true;
+        }
+
+        if (elementEnd - elementStart > maxElementsSize) {
+            droppedCount++;
+            continue;
+        }
+
+        chunkStart = elementStart;
+        chunkEnd = elementEnd;
+        isChunkEmpty = false;
+    }
+
+    if (!isChunkEmpty) {
+        if (EventSplitter_EmitEvent(event, eventSize, &layout, chunkStart, chunkEnd, callback, context) != EVENT_SPLITTER_OK) {
+            return EVENT_SPLITTER_EXCEPTION;
+        }
+        eventsCount++;
+    }
+
+    if (droppedCount > 0) {
+        Logger_Warning("dropped %u payload elements which exceed the max event size on their own", droppedCount);
+    }
+
+    if (eventsCount == 0) {
+        return EVENT_SPLITTER_NOT_SPLITTABLE;
+    }
+
+    return EVENT_SPLITTER_OK;
+}
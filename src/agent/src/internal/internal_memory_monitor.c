@@ -6,42 +6,60 @@
 #include "consts.h"
 #include "twin_configuration.h"
 
+/*
+ * Both values are accessed atomically, consuming and releasing memory never takes a lock.
+ * The limit is cached and refreshed only when the twin configuration changes.
+ */
 static uint32_t currentConsumptionInBytes;
 static uint32_t memoryLimitInBytes;
 
 void InternalMemoryMonitor_Init() {
-    memoryLimitInBytes = DEFAULT_MAX_LOCAL_CACHE_SIZE;
-    currentConsumptionInBytes = 0;
+    __atomic_store_n(&memoryLimitInBytes, DEFAULT_MAX_LOCAL_CACHE_SIZE, __ATOMIC_RELAXED);
+    __atomic_store_n(&currentConsumptionInBytes, 0, __ATOMIC_RELAXED);
 }
 
 void InternalMemoryMonitor_Deinit() {
-    currentConsumptionInBytes = 0;
-    memoryLimitInBytes = 0;
+    __atomic_store_n(&currentConsumptionInBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&memoryLimitInBytes, 0, __ATOMIC_RELAXED);
 }
 
-MemoryMonitorResultValues InternalMemoryMonitor_Consume(uint32_t size) {
-    if (TwinConfiguration_GetMaxLocalCacheSize(&memoryLimitInBytes) != TWIN_OK) {
+MemoryMonitorResultValues InternalMemoryMonitor_UpdateLimit() {
+    uint32_t maxLocalCacheSize = 0;
+    if (TwinConfiguration_GetMaxLocalCacheSize(&maxLocalCacheSize) != TWIN_OK) {
         return MEMORY_MONITOR_EXCEPTION;
     }
 
-    if (currentConsumptionInBytes + size > memoryLimitInBytes) {
-        return MEMORY_MONITOR_MEMORY_EXCEEDED;
-    }
+    __atomic_store_n(&memoryLimitInBytes, maxLocalCacheSize, __ATOMIC_RELAXED);
+    return MEMORY_MONITOR_OK;
+}
+
+MemoryMonitorResultValues InternalMemoryMonitor_Consume(uint32_t size) {
+    uint32_t limit = __atomic_load_n(&memoryLimitInBytes, __ATOMIC_RELAXED);
+    uint32_t current = __atomic_load_n(&currentConsumptionInBytes, __ATOMIC_RELAXED);
+
+    do {
+        if (size > limit || current > limit - size) {
+            return MEMORY_MONITOR_MEMORY_EXCEEDED;
+        }
+        // on failure current is reloaded with the value another thread stored, check the limit again
+    } while (!__atomic_compare_exchange_n(&currentConsumptionInBytes, &current, current + size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-    currentConsumptionInBytes += size;
     return MEMORY_MONITOR_OK;
 }
 
 MemoryMonitorResultValues InternalMemoryMonitor_Release(uint32_t size) {
-    if (size > currentConsumptionInBytes) {
-        return MEMORY_MONITOR_INVALID_RELEASE_SIZE;
-    }
+    uint32_t current = __atomic_load_n(&currentConsumptionInBytes, __ATOMIC_RELAXED);
+
+    do {
+        if (size > current) {
+            return MEMORY_MONITOR_INVALID_RELEASE_SIZE;
+        }
+    } while (!__atomic_compare_exchange_n(&currentConsumptionInBytes, &current, current - size, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-    currentConsumptionInBytes -= size;
     return MEMORY_MONITOR_OK;
 }
 
 MemoryMonitorResultValues InternalMemoryMonitor_CurrentConsumption(uint32_t* sizeInBytes) {
-    *sizeInBytes = currentConsumptionInBytes;
+    *sizeInBytes = __atomic_load_n(&currentConsumptionInBytes, __ATOMIC_RELAXED);
     return MEMORY_MONITOR_OK;
 }
@@ -16,6 +16,14 @@ time_t TimeUtils_GetCurrentTime() {
     return time(NULL);
 }
 
+uint64_t TimeUtils_GetMonotonicTimeInMilliseconds() {
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
+        return 0;
+    }
+    return (uint64_t)now.tv_sec * MILLISECONDS_IN_A_SECOND + (uint64_t)now.tv_nsec / 1000000;
+}
+
 int32_t TimeUtils_GetTimeDiff(time_t end, time_t beginning) {
     return (int32_t)(difftime(end, beginning) * 1000);
 }
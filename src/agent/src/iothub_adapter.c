@@ -93,10 +93,12 @@ static bool IoTHubAdapter_Reinit(IoTHubAdapter* iotHubAdapter, SyncQueue* twinUp
  * @param   iotHubAdapter   The adapter to send data with.
  * @param   data            The data to send.
  * @param   dataSize        The size of the data we want to send.
+ * @param   contentType     The content type of the data, NULL if the data is json.
+ * @param   contentEncoding The content encoding of the data, NULL if the data is not encoded.
  *
  * @return true on success, false otherwise.
  */
-static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize);
+static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding);
 
 static LOCK_HANDLE iotHubAdapterLock = NULL;
 
@@ -260,13 +262,13 @@ bool IoTHubAdapter_Connect(IoTHubAdapter* iotHubAdapter) {
     return false;
 }
 
-bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
+bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding) {
     if (iotHubAdapterLock == NULL || Lock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Send message failed. Could not acquire lock");
         return false;
     }
 
-    bool success = IoTHubAdapter_SendMessageAsync_Internal(iotHubAdapter, data, dataSize);
+    bool success = IoTHubAdapter_SendMessageAsync_Internal(iotHubAdapter, data, dataSize, contentType, contentEncoding);
 
     if (Unlock(iotHubAdapterLock) != LOCK_OK) {
         Logger_Error("Could not unlock IoTHubAdapter lock");
@@ -276,7 +278,7 @@ bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* da
     return success;
 }
 
-static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
+static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding) {
     bool success = true;
     IOTHUB_MESSAGE_HANDLE messageHandle = NULL;
 
@@ -313,6 +315,18 @@ static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter
         goto cleanup;
     }
 
+    if (contentType != NULL && IoTHubMessage_SetContentTypeSystemProperty(messageHandle, contentType) != IOTHUB_MESSAGE_OK) {
+        Logger_Warning("Failed to set the content type of the message");
+        success = false;
+        goto cleanup;
+    }
+
+    if (contentEncoding != NULL && IoTHubMessage_SetContentEncodingSystemProperty(messageHandle, contentEncoding) != IOTHUB_MESSAGE_OK) {
+        Logger_Warning("Failed to set the content encoding of the message");
+        success = false;
+        goto cleanup;
+    }
+
     if (IoTHubModuleClient_SendEventAsync(iotHubAdapter->moduleHandle, messageHandle, IoTHubAdapter_SendConfirmCallback, iotHubAdapter) != IOTHUB_CLIENT_OK) {
         Logger_Warning("Failed to hand over the message to IoTHubClient");
         success = false;
@@ -323,6 +337,10 @@ static bool IoTHubAdapter_SendMessageAsync_Internal(IoTHubAdapter* iotHubAdapter
         AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.smallMessages, 1);
     }
     AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.sentMessages, 1);
+    // messages are billed by whole chunks, the ratio between the two is how well the messages are packed
+    uint32_t billedChunks = (dataSize + MESSAGE_BILLING_MULTIPLE - 1) / MESSAGE_BILLING_MULTIPLE;
+    AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.sentBytes, dataSize);
+    AgentTelemetryCounter_IncreaseBy(&iotHubAdapter->messageCounter, &iotHubAdapter->messageCounter.counter.messageCounter.billedBytes, billedChunks * MESSAGE_BILLING_MULTIPLE);
     Logger_Debug("IoTHubClient accepted the message for delivery");
 
 cleanup:
@@ -0,0 +1,842 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "json/cbor_stream_writer.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CBOR_MAJOR_TYPE_UNSIGNED 0
+#define CBOR_MAJOR_TYPE_NEGATIVE 1
+#define CBOR_MAJOR_TYPE_TEXT 3
+#define CBOR_MAJOR_TYPE_ARRAY 4
+#define CBOR_MAJOR_TYPE_MAP 5
+
+#define CBOR_INDEFINITE_ARRAY 0x9F
+#define CBOR_INDEFINITE_MAP 0xBF
+#define CBOR_FALSE 0xF4
+#define CBOR_TRUE 0xF5
+#define CBOR_NULL 0xF6
+#define CBOR_DOUBLE 0xFB
+#define CBOR_BREAK 0xFF
+
+/**
+ * The max size of the head of a data item, the initial byte followed by a 64 bit argument.
+ */
+#define CBOR_MAX_HEAD_SIZE 9
+
+/**
+ * The max nesting of a json value written with CborStreamWriter_WriteJson.
+ */
+#define CBOR_STREAM_WRITER_MAX_JSON_DEPTH 32
+
+/**
+ * The max length of a json number which is not an integer.
+ */
+#define CBOR_STREAM_WRITER_MAX_NUMBER_LENGTH 64
+
+typedef struct _JsonCursor {
+
+    const char* current;
+    const char* end;
+
+} JsonCursor;
+
+/**
+ * @brief Makes sure the buffer has room for the given amount of bytes, reallocating it as needed.
+ *
+ * @param   writer  The writer instance.
+ * @param   length  The amount of bytes about to be appended.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_Reserve(CborStreamWriter* writer, uint32_t length);
+
+/**
+ * @brief Appends the given bytes to the buffer. Room must have been reserved in advance.
+ *
+ * @param   writer  The writer instance.
+ * @param   data    The bytes to append.
+ * @param   length  The amount of bytes to append.
+ */
+static void CborStreamWriter_Append(CborStreamWriter* writer, const void* data, uint32_t length);
+
+/**
+ * @brief Returns the size of the head of a data item with the given argument.
+ *
+ * @param   argument    The argument of the data item.
+ *
+ * @return the size of the head.
+ */
+static uint32_t CborStreamWriter_GetHeadSize(uint64_t argument);
+
+/**
+ * @brief Encodes the head of a data item, the major type and its argument, into the given output.
+ *
+ * @param   output      The output, must have room for the head.
+ * @param   majorType   The major type of the data item.
+ * @param   argument    The argument of the data item.
+ *
+ * @return the size of the head.
+ */
+static uint32_t CborStreamWriter_EncodeHead(unsigned char* output, uint8_t majorType, uint64_t argument);
+
+/**
+ * @brief Appends the head of a data item, reserving room for it.
+ *
+ * @param   writer      The writer instance.
+ * @param   majorType   The major type of the data item.
+ * @param   argument    The argument of the data item.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_AppendHead(CborStreamWriter* writer, uint8_t majorType, uint64_t argument);
+
+/**
+ * @brief Appends a text string, reserving room for it.
+ *
+ * @param   writer  The writer instance.
+ * @param   value   The string.
+ * @param   length  The length of the string.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_AppendText(CborStreamWriter* writer, const char* value, uint32_t length);
+
+/**
+ * @brief Appends a single byte, reserving room for it.
+ *
+ * @param   writer  The writer instance.
+ * @param   value   The byte.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_AppendByte(CborStreamWriter* writer, unsigned char value);
+
+/**
+ * @brief Validates the key fits the current container and appends it.
+ *
+ * @param   writer  The writer instance.
+ * @param   key     The key of the value, NULL for the root and for array elements.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_BeginValue(CborStreamWriter* writer, const char* key);
+
+/**
+ * @brief Opens a new container.
+ *
+ * @param   writer      The writer instance.
+ * @param   key         The key of the container.
+ * @param   isArray     Whether the container is an array or an object.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_BeginContainer(CborStreamWriter* writer, const char* key, bool isArray);
+
+/**
+ * @brief Closes the current container.
+ *
+ * @param   writer      The writer instance.
+ * @param   isArray     Whether the container is expected to be an array or an object.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_EndContainer(CborStreamWriter* writer, bool isArray);
+
+/**
+ * @brief Skips the json whitespace at the cursor.
+ *
+ * @param   cursor  The cursor.
+ */
+static void CborStreamWriter_SkipJsonWhitespace(JsonCursor* cursor);
+
+/**
+ * @brief Converts the json value at the cursor and advances the cursor past it.
+ *
+ * @param   writer  The writer instance.
+ * @param   cursor  The cursor.
+ * @param   depth   The nesting of the value.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_ConvertJsonValue(CborStreamWriter* writer, JsonCursor* cursor, uint32_t depth);
+
+/**
+ * @brief Converts the json object or array at the cursor and advances the cursor past it.
+ *
+ * @param   writer      The writer instance.
+ * @param   cursor      The cursor.
+ * @param   depth       The nesting of the container.
+ * @param   isArray     Whether the container is an array or an object.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_ConvertJsonContainer(CborStreamWriter* writer, JsonCursor* cursor, uint32_t depth, bool isArray);
+
+/**
+ * @brief Converts the json string at the cursor, unescaping it, and advances the cursor past it.
+ *
+ * @param   writer  The writer instance.
+ * @param   cursor  The cursor.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_ConvertJsonString(CborStreamWriter* writer, JsonCursor* cursor);
+
+/**
+ * @brief Converts the json number at the cursor and advances the cursor past it.
+ *
+ * @param   writer  The writer instance.
+ * @param   cursor  The cursor.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_ConvertJsonNumber(CborStreamWriter* writer, JsonCursor* cursor);
+
+/**
+ * @brief Converts the json literal at the cursor if it matches the given one and advances the cursor past it.
+ *
+ * @param   writer      The writer instance.
+ * @param   cursor      The cursor.
+ * @param   literal     The expected json literal.
+ * @param   value       The CBOR simple value to write.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult CborStreamWriter_ConvertJsonLiteral(CborStreamWriter* writer, JsonCursor* cursor, const char* literal, unsigned char value);
+
+/**
+ * @brief Decodes the escape sequence at the given position into UTF-8.
+ *
+ * @param   current     The position of the backslash, advanced past the escape sequence.
+ * @param   end         The end of the string.
+ * @param   output      The output, must have room for 4 bytes.
+ *
+ * @return the amount of bytes decoded, 0 if the escape sequence is not valid.
+ */
+static uint32_t CborStreamWriter_UnescapeJson(const char** current, const char* end, unsigned char* output);
+
+/**
+ * @brief Parses 4 hexadecimal digits.
+ *
+ * @param   current     The first digit.
+ * @param   end         The end of the input.
+ * @param   value       Out param. The parsed value.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool CborStreamWriter_ParseHex4(const char* current, const char* end, uint32_t* value);
+
+JsonWriterResult CborStreamWriter_Init(CborStreamWriter* writer, uint32_t initialCapacity) {
+    if (writer == NULL || initialCapacity == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->buffer = malloc(initialCapacity);
+    if (writer->buffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    writer->capacity = initialCapacity;
+
+    return JSON_WRITER_OK;
+}
+
+void CborStreamWriter_Deinit(CborStreamWriter* writer) {
+    if (writer == NULL) {
+        return;
+    }
+
+    if (writer->buffer != NULL) {
+        free(writer->buffer);
+    }
+    memset(writer, 0, sizeof(*writer));
+}
+
+JsonWriterResult CborStreamWriter_BeginObject(CborStreamWriter* writer, const char* key) {
+    return CborStreamWriter_BeginContainer(writer, key, false);
+}
+
+JsonWriterResult CborStreamWriter_EndObject(CborStreamWriter* writer) {
+    return CborStreamWriter_EndContainer(writer, false);
+}
+
+JsonWriterResult CborStreamWriter_BeginArray(CborStreamWriter* writer, const char* key) {
+    return CborStreamWriter_BeginContainer(writer, key, true);
+}
+
+JsonWriterResult CborStreamWriter_EndArray(CborStreamWriter* writer) {
+    return CborStreamWriter_EndContainer(writer, true);
+}
+
+JsonWriterResult CborStreamWriter_WriteString(CborStreamWriter* writer, const char* key, const char* value) {
+    if (value == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    size_t length = strlen(value);
+    if (length > UINT32_MAX || CborStreamWriter_BeginValue(writer, key) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    return CborStreamWriter_AppendText(writer, value, (uint32_t)length);
+}
+
+JsonWriterResult CborStreamWriter_WriteInt(CborStreamWriter* writer, const char* key, int value) {
+    if (CborStreamWriter_BeginValue(writer, key) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (value < 0) {
+        // a negative integer n is encoded as -1 - n
+        return CborStreamWriter_AppendHead(writer, CBOR_MAJOR_TYPE_NEGATIVE, (uint64_t)(-1 - (int64_t)value));
+    }
+
+    return CborStreamWriter_AppendHead(writer, CBOR_MAJOR_TYPE_UNSIGNED, (uint64_t)value);
+}
+
+JsonWriterResult CborStreamWriter_WriteBool(CborStreamWriter* writer, const char* key, bool value) {
+    if (CborStreamWriter_BeginValue(writer, key) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    return CborStreamWriter_AppendByte(writer, value ? CBOR_TRUE : CBOR_FALSE);
+}
+
+JsonWriterResult CborStreamWriter_WriteJson(CborStreamWriter* writer, const char* key, const char* value, uint32_t length) {
+    if (writer == NULL || value == NULL || length == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    JsonWriterResult result = JSON_WRITER_OK;
+    uint32_t originalSize = writer->size;
+    JsonCursor cursor = { value, value + length };
+
+    result = CborStreamWriter_BeginValue(writer, key);
+    if (result != JSON_WRITER_OK) {
+        goto cleanup;
+    }
+
+    result = CborStreamWriter_ConvertJsonValue(writer, &cursor, 0);
+    if (result != JSON_WRITER_OK) {
+        goto cleanup;
+    }
+
+    CborStreamWriter_SkipJsonWhitespace(&cursor);
+    if (cursor.current != cursor.end) {
+        result = JSON_WRITER_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (result != JSON_WRITER_OK) {
+        writer->size = originalSize;
+    }
+
+    return result;
+}
+
+JsonWriterResult CborStreamWriter_Truncate(CborStreamWriter* writer, uint32_t size) {
+    if (writer == NULL || size > writer->size) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    writer->size = size;
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult CborStreamWriter_Serialize(CborStreamWriter* writer, char** output, uint32_t* size) {
+    if (writer == NULL || output == NULL || size == NULL || writer->depth != 0 || writer->size == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *output = writer->buffer;
+    *size = writer->size;
+    writer->buffer = NULL;
+    writer->capacity = 0;
+    writer->size = 0;
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_Reserve(CborStreamWriter* writer, uint32_t length) {
+    uint64_t required = (uint64_t)writer->size + length;
+    if (required <= writer->capacity) {
+        return JSON_WRITER_OK;
+    }
+
+    if (required > UINT32_MAX) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    uint64_t newCapacity = writer->capacity > 0 ? writer->capacity : required;
+    while (newCapacity < required) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > UINT32_MAX) {
+        newCapacity = required;
+    }
+
+    char* newBuffer = realloc(writer->buffer, (size_t)newCapacity);
+    if (newBuffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    writer->buffer = newBuffer;
+    writer->capacity = (uint32_t)newCapacity;
+
+    return JSON_WRITER_OK;
+}
+
+static void CborStreamWriter_Append(CborStreamWriter* writer, const void* data, uint32_t length) {
+    memcpy(writer->buffer + writer->size, data, length);
+    writer->size += length;
+}
+
+static uint32_t CborStreamWriter_GetHeadSize(uint64_t argument) {
+    if (argument < 24) {
+        return 1;
+    } else if (argument <= UINT8_MAX) {
+        return 2;
+    } else if (argument <= UINT16_MAX) {
+        return 3;
+    } else if (argument <= UINT32_MAX) {
+        return 5;
+    }
+
+    return 9;
+}
+
+static uint32_t CborStreamWriter_EncodeHead(unsigned char* output, uint8_t majorType, uint64_t argument) {
+    uint32_t headSize = CborStreamWriter_GetHeadSize(argument);
+    uint8_t initialByte = (uint8_t)(majorType << 5);
+
+    switch (headSize) {
+        case 1:  output[0] = initialByte | (uint8_t)argument; break;
+        case 2:  output[0] = initialByte | 24; break;
+        case 3:  output[0] = initialByte | 25; break;
+        case 5:  output[0] = initialByte | 26; break;
+        default: output[0] = initialByte | 27; break;
+    }
+
+    // the argument follows in network byte order
+    for (uint32_t i = 1; i < headSize; ++i) {
+        output[i] = (unsigned char)(argument >> (8 * (headSize - 1 - i)));
+    }
+
+    return headSize;
+}
+
+static JsonWriterResult CborStreamWriter_AppendHead(CborStreamWriter* writer, uint8_t majorType, uint64_t argument) {
+    unsigned char head[CBOR_MAX_HEAD_SIZE];
+    uint32_t headSize = CborStreamWriter_EncodeHead(head, majorType, argument);
+
+    if (CborStreamWriter_Reserve(writer, headSize) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    CborStreamWriter_Append(writer, head, headSize);
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_AppendText(CborStreamWriter* writer, const char* value, uint32_t length) {
+    if (CborStreamWriter_AppendHead(writer, CBOR_MAJOR_TYPE_TEXT, length) != JSON_WRITER_OK ||
+        CborStreamWriter_Reserve(writer, length) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    CborStreamWriter_Append(writer, value, length);
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_AppendByte(CborStreamWriter* writer, unsigned char value) {
+    if (CborStreamWriter_Reserve(writer, 1) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    CborStreamWriter_Append(writer, &value, 1);
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_BeginValue(CborStreamWriter* writer, const char* key) {
+    if (writer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (writer->depth == 0) {
+        // a single root value
+        if (key != NULL || writer->size > 0) {
+            return JSON_WRITER_EXCEPTION;
+        }
+        return JSON_WRITER_OK;
+    }
+
+    if (writer->isArray[writer->depth - 1] != (key == NULL)) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (key != NULL) {
+        size_t keyLength = strlen(key);
+        if (keyLength > UINT32_MAX) {
+            return JSON_WRITER_EXCEPTION;
+        }
+        return CborStreamWriter_AppendText(writer, key, (uint32_t)keyLength);
+    }
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_BeginContainer(CborStreamWriter* writer, const char* key, bool isArray) {
+    if (writer == NULL || writer->depth >= CBOR_STREAM_WRITER_MAX_DEPTH) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (CborStreamWriter_BeginValue(writer, key) != JSON_WRITER_OK ||
+        CborStreamWriter_AppendByte(writer, isArray ? CBOR_INDEFINITE_ARRAY : CBOR_INDEFINITE_MAP) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    writer->isArray[writer->depth] = isArray;
+    ++writer->depth;
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_EndContainer(CborStreamWriter* writer, bool isArray) {
+    if (writer == NULL || writer->depth == 0 || writer->isArray[writer->depth - 1] != isArray) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (CborStreamWriter_AppendByte(writer, CBOR_BREAK) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    --writer->depth;
+
+    return JSON_WRITER_OK;
+}
+
+static void CborStreamWriter_SkipJsonWhitespace(JsonCursor* cursor) {
+    while (cursor->current < cursor->end &&
+           (*cursor->current == ' ' || *cursor->current == '\t' || *cursor->current == '\n' || *cursor->current == '\r')) {
+        ++cursor->current;
+    }
+}
+
+static JsonWriterResult CborStreamWriter_ConvertJsonValue(CborStreamWriter* writer, JsonCursor* cursor, uint32_t depth) {
+    CborStreamWriter_SkipJsonWhitespace(cursor);
+    if (cursor->current == cursor->end) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    switch (*cursor->current) {
+        case '{':
+            return CborStreamWriter_ConvertJsonContainer(writer, cursor, depth, false);
+        case '[':
+            return CborStreamWriter_ConvertJsonContainer(writer, cursor, depth, true);
+        case '"':
+            return CborStreamWriter_ConvertJsonString(writer, cursor);
+        case 't':
+            return CborStreamWriter_ConvertJsonLiteral(writer, cursor, "true", CBOR_TRUE);
+        case 'f':
+            return CborStreamWriter_ConvertJsonLiteral(writer, cursor, "false", CBOR_FALSE);
+        case 'n':
+            return CborStreamWriter_ConvertJsonLiteral(writer, cursor, "null", CBOR_NULL);
+        default:
+            return CborStreamWriter_ConvertJsonNumber(writer, cursor);
+    }
+}
+
+static JsonWriterResult CborStreamWriter_ConvertJsonContainer(CborStreamWriter* writer, JsonCursor* cursor, uint32_t depth, bool isArray) {
+    char closing = isArray ? ']' : '}';
+
+    if (depth >= CBOR_STREAM_WRITER_MAX_JSON_DEPTH) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (CborStreamWriter_AppendByte(writer, isArray ? CBOR_INDEFINITE_ARRAY : CBOR_INDEFINITE_MAP) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    // skip the opening
+    ++cursor->current;
+
+    CborStreamWriter_SkipJsonWhitespace(cursor);
+    if (cursor->current < cursor->end && *cursor->current == closing) {
+        ++cursor->current;
+        return CborStreamWriter_AppendByte(writer, CBOR_BREAK);
+    }
+
+    while (true) {
+        if (!isArray) {
+            CborStreamWriter_SkipJsonWhitespace(cursor);
+            if (cursor->current == cursor->end || *cursor->current != '"' ||
+                CborStreamWriter_ConvertJsonString(writer, cursor) != JSON_WRITER_OK) {
+                return JSON_WRITER_EXCEPTION;
+            }
+
+            CborStreamWriter_SkipJsonWhitespace(cursor);
+            if (cursor->current == cursor->end || *cursor->current != ':') {
+                return JSON_WRITER_EXCEPTION;
+            }
+            ++cursor->current;
+        }
+
+        if (CborStreamWriter_ConvertJsonValue(writer, cursor, depth + 1) != JSON_WRITER_OK) {
+            return JSON_WRITER_EXCEPTION;
+        }
+
+        CborStreamWriter_SkipJsonWhitespace(cursor);
+        if (cursor->current == cursor->end) {
+            return JSON_WRITER_EXCEPTION;
+        }
+
+        if (*cursor->current == closing) {
+            ++cursor->current;
+            return CborStreamWriter_AppendByte(writer, CBOR_BREAK);
+        } else if (*cursor->current != ',') {
+            return JSON_WRITER_EXCEPTION;
+        }
+        ++cursor->current;
+    }
+}
+
+static JsonWriterResult CborStreamWriter_ConvertJsonString(CborStreamWriter* writer, JsonCursor* cursor) {
+    const char* start = cursor->current + 1;
+    const char* current = start;
+    bool isEscaped = false;
+
+    // find the closing quote, an escaped string is never longer once unescaped
+    while (current < cursor->end && *current != '"') {
+        if (*current == '\\') {
+            isEscaped = true;
+            ++current;
+        }
+        ++current;
+    }
+    if (current >= cursor->end) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    uint32_t escapedLength = (uint32_t)(current - start);
+    cursor->current = current + 1;
+
+    if (!isEscaped) {
+        return CborStreamWriter_AppendText(writer, start, escapedLength);
+    }
+
+    // unescape right after room for the longest head the string may need, then move it next to its actual head
+    uint32_t maxHeadSize = CborStreamWriter_GetHeadSize(escapedLength);
+    if (CborStreamWriter_Reserve(writer, maxHeadSize + escapedLength) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    unsigned char* text = (unsigned char*)writer->buffer + writer->size + maxHeadSize;
+    uint32_t length = 0;
+    const char* end = start + escapedLength;
+    current = start;
+    while (current < end) {
+        if (*current == '\\') {
+            uint32_t decodedLength = CborStreamWriter_UnescapeJson(&current, end, text + length);
+            if (decodedLength == 0) {
+                return JSON_WRITER_EXCEPTION;
+            }
+            length += decodedLength;
+        } else {
+            text[length++] = (unsigned char)*current++;
+        }
+    }
+
+    unsigned char* head = (unsigned char*)writer->buffer + writer->size;
+    uint32_t headSize = CborStreamWriter_GetHeadSize(length);
+    memmove(head + headSize, text, length);
+    CborStreamWriter_EncodeHead(head, CBOR_MAJOR_TYPE_TEXT, length);
+    writer->size += headSize + length;
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_ConvertJsonNumber(CborStreamWriter* writer, JsonCursor* cursor) {
+    const char* start = cursor->current;
+    const char* current = start;
+    bool isNegative = false;
+    bool isInteger = true;
+    bool isOverflow = false;
+    uint64_t magnitude = 0;
+
+    if (*current == '-') {
+        isNegative = true;
+        ++current;
+    }
+
+    if (current == cursor->end || *current < '0' || *current > '9') {
+        return JSON_WRITER_EXCEPTION;
+    }
+    while (current < cursor->end && *current >= '0' && *current <= '9') {
+        uint64_t digit = (uint64_t)(*current - '0');
+        if (magnitude > (UINT64_MAX - digit) / 10) {
+            isOverflow = true;
+        } else {
+            magnitude = magnitude * 10 + digit;
+        }
+        ++current;
+    }
+
+    if (current < cursor->end && *current == '.') {
+        isInteger = false;
+        ++current;
+        if (current == cursor->end || *current < '0' || *current > '9') {
+            return JSON_WRITER_EXCEPTION;
+        }
+        while (current < cursor->end && *current >= '0' && *current <= '9') {
+            ++current;
+        }
+    }
+
+    if (current < cursor->end && (*current == 'e' || *current == 'E')) {
+        isInteger = false;
+        ++current;
+        if (current < cursor->end && (*current == '+' || *current == '-')) {
+            ++current;
+        }
+        if (current == cursor->end || *current < '0' || *current > '9') {
+            return JSON_WRITER_EXCEPTION;
+        }
+        while (current < cursor->end && *current >= '0' && *current <= '9') {
+            ++current;
+        }
+    }
+    cursor->current = current;
+
+    if (isInteger && !isOverflow) {
+        if (!isNegative || magnitude == 0) {
+            return CborStreamWriter_AppendHead(writer, CBOR_MAJOR_TYPE_UNSIGNED, magnitude);
+        }
+        // a negative integer n is encoded as -1 - n
+        return CborStreamWriter_AppendHead(writer, CBOR_MAJOR_TYPE_NEGATIVE, magnitude - 1);
+    }
+
+    // strtod needs a null terminated string
+    char number[CBOR_STREAM_WRITER_MAX_NUMBER_LENGTH];
+    uint32_t numberLength = (uint32_t)(current - start);
+    if (numberLength >= sizeof(number)) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    memcpy(number, start, numberLength);
+    number[numberLength] = '\0';
+
+    double value = strtod(number, NULL);
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned char encoded[CBOR_MAX_HEAD_SIZE];
+    encoded[0] = CBOR_DOUBLE;
+    for (uint32_t i = 1; i < sizeof(encoded); ++i) {
+        encoded[i] = (unsigned char)(bits >> (8 * (sizeof(encoded) - 1 - i)));
+    }
+
+    if (CborStreamWriter_Reserve(writer, sizeof(encoded)) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    CborStreamWriter_Append(writer, encoded, sizeof(encoded));
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult CborStreamWriter_ConvertJsonLiteral(CborStreamWriter* writer, JsonCursor* cursor, const char* literal, unsigned char value) {
+    size_t literalLength = strlen(literal);
+    if ((size_t)(cursor->end - cursor->current) < literalLength || memcmp(cursor->current, literal, literalLength) != 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    cursor->current += literalLength;
+
+    return CborStreamWriter_AppendByte(writer, value);
+}
+
+static uint32_t CborStreamWriter_UnescapeJson(const char** current, const char* end, unsigned char* output) {
+    const char* escape = *current + 1;
+    if (escape >= end) {
+        return 0;
+    }
+
+    char simple = 0;
+    switch (*escape) {
+        case '"':  simple = '"';  break;
+        case '\\': simple = '\\'; break;
+        case '/':  simple = '/';  break;
+        case 'b':  simple = '\b'; break;
+        case 'f':  simple = '\f'; break;
+        case 'n':  simple = '\n'; break;
+        case 'r':  simple = '\r'; break;
+        case 't':  simple = '\t'; break;
+        case 'u':  break;
+        default:   return 0;
+    }
+    if (simple != 0) {
+        output[0] = (unsigned char)simple;
+        *current = escape + 1;
+        return 1;
+    }
+
+    // \uXXXX, a code point above U+FFFF is escaped as a surrogate pair
+    uint32_t codePoint = 0;
+    if (!CborStreamWriter_ParseHex4(escape + 1, end, &codePoint)) {
+        return 0;
+    }
+    escape += 5;
+
+    if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+        uint32_t lowSurrogate = 0;
+        if (end - escape < 6 || escape[0] != '\\' || escape[1] != 'u' ||
+            !CborStreamWriter_ParseHex4(escape + 2, end, &lowSurrogate) || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+            return 0;
+        }
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+        escape += 6;
+    } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+        return 0;
+    }
+    *current = escape;
+
+    if (codePoint < 0x80) {
+        output[0] = (unsigned char)codePoint;
+        return 1;
+    } else if (codePoint < 0x800) {
+        output[0] = (unsigned char)(0xC0 | (codePoint >> 6));
+        output[1] = (unsigned char)(0x80 | (codePoint & 0x3F));
+        return 2;
+    } else if (codePoint < 0x10000) {
+        output[0] = (unsigned char)(0xE0 | (codePoint >> 12));
+        output[1] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+        output[2] = (unsigned char)(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+
+    output[0] = (unsigned char)(0xF0 | (codePoint >> 18));
+    output[1] = (unsigned char)(0x80 | ((codePoint >> 12) & 0x3F));
+    output[2] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+    output[3] = (unsigned char)(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+static bool CborStreamWriter_ParseHex4(const char* current, const char* end, uint32_t* value) {
+    if (end - current < 4) {
+        return false;
+    }
+
+    *value = 0;
+    for (uint32_t i = 0; i < 4; ++i) {
+        char digit = current[i];
+        *value <<= 4;
+        if (digit >= '0' && digit <= '9') {
+            *value |= (uint32_t)(digit - '0');
+        } else if (digit >= 'a' && digit <= 'f') {
+            *value |= (uint32_t)(digit - 'a' + 10);
+        } else if (digit >= 'A' && digit <= 'F') {
+            *value |= (uint32_t)(digit - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
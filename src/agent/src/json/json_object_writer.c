@@ -11,6 +11,34 @@
 
 static JsonWriterResult JsonObjectWriter_GetValueOfType(JsonObjectWriter* writer, const char* key, JSON_Value_Type type, JSON_Value ** outObject);
 
+/**
+ * The offset basis and the prime of the 32 bit FNV-1a hash.
+ */
+#define JSON_OBJECT_WRITER_HASH_OFFSET_BASIS 2166136261u
+#define JSON_OBJECT_WRITER_HASH_PRIME 16777619u
+
+/**
+ * @brief Mixes the given bytes into the hash with FNV-1a.
+ *
+ * @param   hash    The hash so far.
+ * @param   data    The bytes to mix.
+ * @param   size    The number of bytes.
+ *
+ * @return the new hash.
+ */
+static uint32_t JsonObjectWriter_HashBytes(uint32_t hash, const void* data, size_t size);
+
+/**
+ * @brief Computes a hash of the given value which is the same for any two values json_value_equals finds equal.
+ *        Object members are combined regardless of their order, and numbers are hashed by their integral part
+ *        since the comparison tolerates tiny differences.
+ *
+ * @param   value   The value to hash.
+ *
+ * @return the hash of the value.
+ */
+static uint32_t JsonObjectWriter_HashValue(const JSON_Value* value);
+
 JsonWriterResult JsonObjectWriter_Init(JsonObjectWriterHandle* writer) {
     JsonWriterResult result = JSON_WRITER_OK;
 
@@ -139,6 +167,19 @@ JsonWriterResult JsonObjectWriter_Serialize(JsonObjectWriterHandle writer, char*
     return JSON_WRITER_OK;
 }
 
+JsonWriterResult JsonObjectWriter_GetSerializedSize(JsonObjectWriterHandle writer, uint32_t* size) {
+    JsonObjectWriter* writerObj = (JsonObjectWriter*)writer;
+
+    // the size parson reports includes the null terminator, 0 means failure
+    size_t serializationSize = json_serialization_size(writerObj->rootValue);
+    if (serializationSize == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    *size = serializationSize - 1;
+
+    return JSON_WRITER_OK;
+}
+
 JsonWriterResult JsonObjectWriter_WriteObject(JsonObjectWriterHandle writer, const char* key, JsonObjectWriterHandle object) {
     JsonObjectWriter* rootObj = (JsonObjectWriter*)writer;
     JsonObjectWriter* objToAdd = (JsonObjectWriter*)object;
@@ -153,23 +194,35 @@ JsonWriterResult JsonObjectWriter_WriteObject(JsonObjectWriterHandle writer, con
 
 JsonWriterResult JsonObjectWriter_Copy(JsonObjectWriterHandle* dst, JsonObjectWriterHandle src) {
     JsonWriterResult result = JSON_WRITER_OK;
+    JsonObjectWriter* srcObj = (JsonObjectWriter*)src;
 
-    char* serializedSource = NULL;
-    uint32_t size = 0;
-    result = JsonObjectWriter_Serialize(src, &serializedSource, &size);
-    if (result != JSON_WRITER_OK) {
+    JsonObjectWriter* writerObj = malloc(sizeof(JsonObjectWriter));
+    if (writerObj == NULL) {
+        result = JSON_WRITER_EXCEPTION;
         goto cleanup;
     }
+    memset(writerObj, 0, sizeof(*writerObj));
+    writerObj->shouldFree = true;
 
-    result = JsonObjectWriter_InitFromString(dst, serializedSource);
-    if (result != JSON_WRITER_OK) {
+    writerObj->rootValue = json_value_deep_copy(srcObj->rootValue);
+    if (writerObj->rootValue == NULL) {
+        result = JSON_WRITER_EXCEPTION;
         goto cleanup;
     }
-    
-cleanup:
 
-    if (serializedSource != NULL) {
-        free(serializedSource);
+    writerObj->rootObject = json_value_get_object(writerObj->rootValue);
+    if (writerObj->rootObject == NULL) {
+        result = JSON_WRITER_EXCEPTION;
+        goto cleanup;
+    }
+
+    *dst = (JsonObjectWriterHandle)writerObj;
+
+cleanup:
+    if (result != JSON_WRITER_OK) {
+        if (writerObj != NULL) {
+            JsonObjectWriter_Deinit((JsonObjectWriterHandle)writerObj);
+        }
     }
     return result;
 }
@@ -181,6 +234,17 @@ bool JsonObjectWriter_Compare(JsonObjectWriterHandle a, JsonObjectWriterHandle b
     return json_value_equals(writerObjA->rootValue, writerObjB->rootValue);
 }
 
+JsonWriterResult JsonObjectWriter_GetHash(JsonObjectWriterHandle writer, uint32_t* hash) {
+    JsonObjectWriter* writerObj = (JsonObjectWriter*)writer;
+    if (writerObj == NULL || writerObj->rootValue == NULL || hash == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *hash = JsonObjectWriter_HashValue(writerObj->rootValue);
+
+    return JSON_WRITER_OK;
+}
+
 JsonWriterResult JsonObjectWriter_GetSize(JsonObjectWriterHandle handle, uint32_t* size) {
     JsonObjectWriter* writer = (JsonObjectWriter*)handle;
     *size = json_object_get_count(writer->rootObject);
@@ -204,6 +268,53 @@ JsonWriterResult JsonObjectWriter_StepIn(JsonObjectWriterHandle handle, const ch
     return JSON_WRITER_OK;
 }
 
+JsonWriterResult JsonObjectWriter_GetKeyAt(JsonObjectWriterHandle handle, uint32_t index, const char** key) {
+    JsonObjectWriter* writer = (JsonObjectWriter*)handle;
+    const char* name = json_object_get_name(writer->rootObject, index);
+    if (name == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *key = name;
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonObjectWriter_ReadString(JsonObjectWriterHandle handle, const char* key, const char** value) {
+    JsonObjectWriter* writer = (JsonObjectWriter*)handle;
+    JSON_Value* val = NULL;
+    JsonWriterResult result = JsonObjectWriter_GetValueOfType(writer, key, JSONString, &val);
+    if (result != JSON_WRITER_OK) {
+        return result;
+    }
+
+    const char* string = json_value_get_string(val);
+    if (string == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *value = string;
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonObjectWriter_ResetValue(JsonObjectWriterHandle handle, const char* key) {
+    JsonObjectWriter* writer = (JsonObjectWriter*)handle;
+    JSON_Value* value = json_object_dotget_value(writer->rootObject, key);
+    if (value == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    switch (json_value_get_type(value)) {
+        case JSONString:
+            return JsonObjectWriter_WriteString(handle, key, "");
+        case JSONNumber:
+            return JsonObjectWriter_WriteInt(handle, key, 0);
+        case JSONBoolean:
+            return JsonObjectWriter_WriteBool(handle, key, false);
+        default:
+            return JSON_WRITER_OK;
+    }
+}
+
 
 static JsonWriterResult JsonObjectWriter_GetValueOfType(JsonObjectWriter* writer, const char* key, JSON_Value_Type type, JSON_Value** outObject){
     if (json_object_dothas_value(writer->rootObject, key) != true){
@@ -222,4 +333,66 @@ static JsonWriterResult JsonObjectWriter_GetValueOfType(JsonObjectWriter* writer
 
     *outObject = value;
     return JSON_WRITER_OK;
+}
+
+static uint32_t JsonObjectWriter_HashBytes(uint32_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= JSON_OBJECT_WRITER_HASH_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t JsonObjectWriter_HashValue(const JSON_Value* value) {
+    uint32_t hash = JSON_OBJECT_WRITER_HASH_OFFSET_BASIS;
+    JSON_Value_Type type = json_value_get_type(value);
+    unsigned char typeByte = (unsigned char)type;
+    hash = JsonObjectWriter_HashBytes(hash, &typeByte, sizeof(typeByte));
+
+    switch (type) {
+        case JSONString: {
+            const char* string = json_value_get_string(value);
+            hash = JsonObjectWriter_HashBytes(hash, string, strlen(string));
+            break;
+        }
+        case JSONNumber: {
+            double number = json_value_get_number(value);
+            int64_t integral = (number > INT64_MIN && number < INT64_MAX) ? (int64_t)number : 0;
+            hash = JsonObjectWriter_HashBytes(hash, &integral, sizeof(integral));
+            break;
+        }
+        case JSONBoolean: {
+            unsigned char boolean = (unsigned char)json_value_get_boolean(value);
+            hash = JsonObjectWriter_HashBytes(hash, &boolean, sizeof(boolean));
+            break;
+        }
+        case JSONObject: {
+            const JSON_Object* object = json_value_get_object(value);
+            size_t count = json_object_get_count(object);
+            // members are summed so their order does not matter
+            uint32_t membersHash = 0;
+            for (size_t i = 0; i < count; i++) {
+                const char* name = json_object_get_name(object, i);
+                uint32_t memberHash = JsonObjectWriter_HashBytes(JSON_OBJECT_WRITER_HASH_OFFSET_BASIS, name, strlen(name));
+                uint32_t valueHash = JsonObjectWriter_HashValue(json_object_get_value_at(object, i));
+                membersHash += JsonObjectWriter_HashBytes(memberHash, &valueHash, sizeof(valueHash));
+            }
+            hash = JsonObjectWriter_HashBytes(hash, &membersHash, sizeof(membersHash));
+            break;
+        }
+        case JSONArray: {
+            const JSON_Array* array = json_value_get_array(value);
+            size_t count = json_array_get_count(array);
+            for (size_t i = 0; i < count; i++) {
+                uint32_t elementHash = JsonObjectWriter_HashValue(json_array_get_value(array, i));
+                hash = JsonObjectWriter_HashBytes(hash, &elementHash, sizeof(elementHash));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return hash;
 }
\ No newline at end of file
@@ -0,0 +1,448 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "json/json_stream_writer.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_STREAM_WRITER_MAX_INT_LENGTH 12
+
+static const char JSON_TRUE[] = "true";
+static const char JSON_FALSE[] = "false";
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+/**
+ * @brief Makes sure the buffer has room for the given amount of bytes and a null terminator.
+ *        A growable buffer is reallocated as needed, a caller supplied buffer is never reallocated.
+ *
+ * @param   writer  The writer instance.
+ * @param   length  The amount of bytes about to be appended.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult JsonStreamWriter_Reserve(JsonStreamWriter* writer, uint32_t length);
+
+/**
+ * @brief Appends the given bytes to the buffer. Room must have been reserved in advance.
+ *
+ * @param   writer  The writer instance.
+ * @param   data    The bytes to append.
+ * @param   length  The amount of bytes to append.
+ */
+static void JsonStreamWriter_Append(JsonStreamWriter* writer, const char* data, uint32_t length);
+
+/**
+ * @brief Calculates the length of the given string once escaped, validating it is a UTF-8 string.
+ *
+ * @param   value   The string to measure.
+ * @param   length  Out param. The escaped length, not including the quotes.
+ *
+ * @return true if the string is a valid UTF-8 string, false otherwise.
+ */
+static bool JsonStreamWriter_GetEscapedLength(const char* value, uint32_t* length);
+
+/**
+ * @brief Appends the given string, quoted and escaped. Room must have been reserved in advance.
+ *
+ * @param   writer  The writer instance.
+ * @param   value   The string to append.
+ */
+static void JsonStreamWriter_AppendEscaped(JsonStreamWriter* writer, const char* value);
+
+/**
+ * @brief Validates the key fits the current container, reserves room for the separator,
+ *        the key and the value and appends the separator and the key.
+ *
+ * @param   writer          The writer instance.
+ * @param   key             The key of the value, NULL for the root and for array elements.
+ * @param   valueLength     The length of the value that is about to be appended.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult JsonStreamWriter_BeginValue(JsonStreamWriter* writer, const char* key, uint32_t valueLength);
+
+/**
+ * @brief Opens a new container.
+ *
+ * @param   writer      The writer instance.
+ * @param   key         The key of the container.
+ * @param   isArray     Whether the container is an array or an object.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult JsonStreamWriter_BeginContainer(JsonStreamWriter* writer, const char* key, bool isArray);
+
+/**
+ * @brief Closes the current container.
+ *
+ * @param   writer      The writer instance.
+ * @param   isArray     Whether the container is expected to be an array or an object.
+ *
+ * @return JSON_WRITER_OK on success, an indicative error in failure.
+ */
+static JsonWriterResult JsonStreamWriter_EndContainer(JsonStreamWriter* writer, bool isArray);
+
+/**
+ * @brief Returns the length of the UTF-8 sequence at the start of the given string.
+ *
+ * @param   string  The string.
+ *
+ * @return the length of the sequence, 0 if the sequence is not a valid UTF-8 sequence.
+ */
+static uint32_t JsonStreamWriter_GetUtf8SequenceLength(const unsigned char* string);
+
+JsonWriterResult JsonStreamWriter_Init(JsonStreamWriter* writer, uint32_t initialCapacity) {
+    if (writer == NULL || initialCapacity == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->buffer = malloc(initialCapacity);
+    if (writer->buffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    writer->buffer[0] = '\0';
+    writer->capacity = initialCapacity;
+    writer->isGrowable = true;
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_InitWithBuffer(JsonStreamWriter* writer, char* buffer, uint32_t capacity) {
+    if (writer == NULL || buffer == NULL || capacity == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    writer->buffer = buffer;
+    writer->buffer[0] = '\0';
+    writer->capacity = capacity;
+    writer->isGrowable = false;
+
+    return JSON_WRITER_OK;
+}
+
+void JsonStreamWriter_Deinit(JsonStreamWriter* writer) {
+    if (writer == NULL) {
+        return;
+    }
+
+    if (writer->isGrowable && writer->buffer != NULL) {
+        free(writer->buffer);
+    }
+    memset(writer, 0, sizeof(*writer));
+}
+
+JsonWriterResult JsonStreamWriter_BeginObject(JsonStreamWriter* writer, const char* key) {
+    return JsonStreamWriter_BeginContainer(writer, key, false);
+}
+
+JsonWriterResult JsonStreamWriter_EndObject(JsonStreamWriter* writer) {
+    return JsonStreamWriter_EndContainer(writer, false);
+}
+
+JsonWriterResult JsonStreamWriter_BeginArray(JsonStreamWriter* writer, const char* key) {
+    return JsonStreamWriter_BeginContainer(writer, key, true);
+}
+
+JsonWriterResult JsonStreamWriter_EndArray(JsonStreamWriter* writer) {
+    return JsonStreamWriter_EndContainer(writer, true);
+}
+
+JsonWriterResult JsonStreamWriter_WriteString(JsonStreamWriter* writer, const char* key, const char* value) {
+    uint32_t valueLength = 0;
+    if (value == NULL || !JsonStreamWriter_GetEscapedLength(value, &valueLength)) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginValue(writer, key, valueLength + 2) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_AppendEscaped(writer, value);
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_WriteInt(JsonStreamWriter* writer, const char* key, int value) {
+    char valueString[JSON_STREAM_WRITER_MAX_INT_LENGTH];
+    int valueLength = snprintf(valueString, sizeof(valueString), "%d", value);
+    if (valueLength <= 0 || valueLength >= (int)sizeof(valueString)) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginValue(writer, key, (uint32_t)valueLength) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_Append(writer, valueString, (uint32_t)valueLength);
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_WriteBool(JsonStreamWriter* writer, const char* key, bool value) {
+    const char* valueString = value ? JSON_TRUE : JSON_FALSE;
+    uint32_t valueLength = (uint32_t)strlen(valueString);
+
+    if (JsonStreamWriter_BeginValue(writer, key, valueLength) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_Append(writer, valueString, valueLength);
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_WriteRaw(JsonStreamWriter* writer, const char* key, const char* value, uint32_t length) {
+    if (value == NULL || length == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginValue(writer, key, length) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_Append(writer, value, length);
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_GetOutput(JsonStreamWriter* writer, const char** output, uint32_t* size) {
+    if (writer == NULL || output == NULL || size == NULL || writer->depth != 0 || writer->size == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    *output = writer->buffer;
+    *size = writer->size;
+
+    return JSON_WRITER_OK;
+}
+
+JsonWriterResult JsonStreamWriter_Serialize(JsonStreamWriter* writer, char** output, uint32_t* size) {
+    if (writer == NULL || output == NULL || size == NULL || writer->depth != 0 || writer->size == 0) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (writer->isGrowable) {
+        *output = writer->buffer;
+        writer->buffer = NULL;
+        writer->capacity = 0;
+    } else {
+        *output = malloc(writer->size + 1);
+        if (*output == NULL) {
+            return JSON_WRITER_EXCEPTION;
+        }
+        memcpy(*output, writer->buffer, writer->size + 1);
+        writer->buffer[0] = '\0';
+    }
+    *size = writer->size;
+    writer->size = 0;
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult JsonStreamWriter_Reserve(JsonStreamWriter* writer, uint32_t length) {
+    uint64_t required = (uint64_t)writer->size + length + 1;
+    if (required <= writer->capacity) {
+        return JSON_WRITER_OK;
+    }
+
+    if (!writer->isGrowable || required > UINT32_MAX) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    uint64_t newCapacity = writer->capacity > 0 ? writer->capacity : required;
+    while (newCapacity < required) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > UINT32_MAX) {
+        newCapacity = required;
+    }
+
+    char* newBuffer = realloc(writer->buffer, (size_t)newCapacity);
+    if (newBuffer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    writer->buffer = newBuffer;
+    writer->capacity = (uint32_t)newCapacity;
+
+    return JSON_WRITER_OK;
+}
+
+static void JsonStreamWriter_Append(JsonStreamWriter* writer, const char* data, uint32_t length) {
+    memcpy(writer->buffer + writer->size, data, length);
+    writer->size += length;
+    writer->buffer[writer->size] = '\0';
+}
+
+static bool JsonStreamWriter_GetEscapedLength(const char* value, uint32_t* length) {
+    const unsigned char* current = (const unsigned char*)value;
+    uint64_t escapedLength = 0;
+
+    while (*current != '\0') {
+        if (*current == '"' || *current == '\\' || *current == '\b' || *current == '\f' ||
+            *current == '\n' || *current == '\r' || *current == '\t') {
+            escapedLength += 2;
+            ++current;
+        } else if (*current < 0x20) {
+            // \u00XX
+            escapedLength += 6;
+            ++current;
+        } else {
+            uint32_t sequenceLength = JsonStreamWriter_GetUtf8SequenceLength(current);
+            if (sequenceLength == 0) {
+                return false;
+            }
+            escapedLength += sequenceLength;
+            current += sequenceLength;
+        }
+    }
+
+    if (escapedLength > UINT32_MAX - 2) {
+        return false;
+    }
+    *length = (uint32_t)escapedLength;
+    return true;
+}
+
+static void JsonStreamWriter_AppendEscaped(JsonStreamWriter* writer, const char* value) {
+    const unsigned char* current = (const unsigned char*)value;
+    char* output = writer->buffer + writer->size;
+
+    *output++ = '"';
+    for (; *current != '\0'; ++current) {
+        switch (*current) {
+            case '"':  *output++ = '\\'; *output++ = '"';  break;
+            case '\\': *output++ = '\\'; *output++ = '\\'; break;
+            case '\b': *output++ = '\\'; *output++ = 'b';  break;
+            case '\f': *output++ = '\\'; *output++ = 'f';  break;
+            case '\n': *output++ = '\\'; *output++ = 'n';  break;
+            case '\r': *output++ = '\\'; *output++ = 'r';  break;
+            case '\t': *output++ = '\\'; *output++ = 't';  break;
+            default:
+                if (*current < 0x20) {
+                    *output++ = '\\';
+                    *output++ = 'u';
+                    *output++ = '0';
+                    *output++ = '0';
+                    *output++ = HEX_DIGITS[*current >> 4];
+                    *output++ = HEX_DIGITS[*current & 0xF];
+                } else {
+                    *output++ = (char)*current;
+                }
+                break;
+        }
+    }
+    *output++ = '"';
+
+    writer->size = (uint32_t)(output - writer->buffer);
+    writer->buffer[writer->size] = '\0';
+}
+
+static JsonWriterResult JsonStreamWriter_BeginValue(JsonStreamWriter* writer, const char* key, uint32_t valueLength) {
+    if (writer == NULL) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    bool needsSeparator = false;
+    if (writer->depth == 0) {
+        // a single root value
+        if (key != NULL || writer->size > 0) {
+            return JSON_WRITER_EXCEPTION;
+        }
+    } else {
+        if (writer->isArray[writer->depth - 1] != (key == NULL)) {
+            return JSON_WRITER_EXCEPTION;
+        }
+        needsSeparator = writer->hasValues[writer->depth - 1];
+    }
+
+    uint64_t length = (uint64_t)valueLength + (needsSeparator ? 1 : 0);
+    uint32_t keyLength = 0;
+    if (key != NULL) {
+        if (!JsonStreamWriter_GetEscapedLength(key, &keyLength)) {
+            return JSON_WRITER_EXCEPTION;
+        }
+        // "key":
+        length += (uint64_t)keyLength + 3;
+    }
+
+    if (length > UINT32_MAX || JsonStreamWriter_Reserve(writer, (uint32_t)length) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (needsSeparator) {
+        JsonStreamWriter_Append(writer, ",", 1);
+    }
+    if (key != NULL) {
+        JsonStreamWriter_AppendEscaped(writer, key);
+        JsonStreamWriter_Append(writer, ":", 1);
+    }
+    if (writer->depth > 0) {
+        writer->hasValues[writer->depth - 1] = true;
+    }
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult JsonStreamWriter_BeginContainer(JsonStreamWriter* writer, const char* key, bool isArray) {
+    if (writer == NULL || writer->depth >= JSON_STREAM_WRITER_MAX_DEPTH) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginValue(writer, key, 1) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_Append(writer, isArray ? "[" : "{", 1);
+
+    writer->isArray[writer->depth] = isArray;
+    writer->hasValues[writer->depth] = false;
+    ++writer->depth;
+
+    return JSON_WRITER_OK;
+}
+
+static JsonWriterResult JsonStreamWriter_EndContainer(JsonStreamWriter* writer, bool isArray) {
+    if (writer == NULL || writer->depth == 0 || writer->isArray[writer->depth - 1] != isArray) {
+        return JSON_WRITER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_Reserve(writer, 1) != JSON_WRITER_OK) {
+        return JSON_WRITER_EXCEPTION;
+    }
+    JsonStreamWriter_Append(writer, isArray ? "]" : "}", 1);
+    --writer->depth;
+
+    return JSON_WRITER_OK;
+}
+
+static uint32_t JsonStreamWriter_GetUtf8SequenceLength(const unsigned char* string) {
+    uint32_t length = 0;
+
+    if (string[0] < 0x80) {
+        return 1;
+    } else if (string[0] >= 0xC2 && string[0] <= 0xDF) {
+        length = 2;
+    } else if (string[0] >= 0xE0 && string[0] <= 0xEF) {
+        // overlong encodings and surrogates
+        if ((string[0] == 0xE0 && string[1] < 0xA0) || (string[0] == 0xED && string[1] >= 0xA0)) {
+            return 0;
+        }
+        length = 3;
+    } else if (string[0] >= 0xF0 && string[0] <= 0xF4) {
+        // overlong encodings and code points above U+10FFFF
+        if ((string[0] == 0xF0 && string[1] < 0x90) || (string[0] == 0xF4 && string[1] >= 0x90)) {
+            return 0;
+        }
+        length = 4;
+    } else {
+        return 0;
+    }
+
+    for (uint32_t i = 1; i < length; ++i) {
+        if ((string[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+
+    return length;
+}
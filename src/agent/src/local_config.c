@@ -20,6 +20,14 @@ static uint32_t connectionTimeout = 0;
 static int32_t systemLoggerMinimumSeverity = 0;
 static int32_t diagnosticEventMinimumSeverity = 0;
 static char* remoteConfigurationObjectName = NULL;
+static char* spillDirectory = NULL;
+static uint32_t maxSpillSize = 0;
+static uint32_t highPriorityQueueBudget = 0;
+static uint32_t lowPriorityQueueBudget = 0;
+static uint32_t collectorIntervals[EVENT_TYPE_OPERATIONAL_EVENT + 1] = { 0 };
+static uint32_t schedulingJitterPercentage = 0;
+static bool auditFeedEnabled = false;
+static char* auditFeedSocketPath = NULL;
 
 #define CONNECTION_STRING_SIZE 500
 #define KEY_SIZE 300
@@ -49,6 +57,41 @@ static const char LOCAL_CONFIG_LOGGING[] = "Logging";
 static const char LOCAL_CONFIG_LOGGING_SYSTEM_LOGGER_MINIMUM_SEVERITY[] = "SystemLoggerMinimumSeverity";
 static const char LOCAL_CONFIG_LOGGING_DIAGNOSTIC_EVENT_MINIMUM_SEVERITY[] = "DiagnoticEventMinimumSeverity";
 
+static const char LOCAL_CONFIG_SPILL[] = "Spill";
+static const char LOCAL_CONFIG_SPILL_DIRECTORY[] = "Directory";
+static const char LOCAL_CONFIG_SPILL_MAX_SIZE[] = "MaxSize";
+
+static const char LOCAL_CONFIG_QUEUE_BUDGETS[] = "QueueBudgets";
+static const char LOCAL_CONFIG_QUEUE_BUDGETS_HIGH_PRIORITY[] = "HighPriority";
+static const char LOCAL_CONFIG_QUEUE_BUDGETS_LOW_PRIORITY[] = "LowPriority";
+
+static const char LOCAL_CONFIG_SCHEDULING[] = "Scheduling";
+static const char LOCAL_CONFIG_SCHEDULING_JITTER_PERCENTAGE[] = "JitterPercentage";
+static const char LOCAL_CONFIG_SCHEDULING_INTERVALS[] = "Intervals";
+
+static const char LOCAL_CONFIG_AUDIT_FEED[] = "AuditFeed";
+static const char LOCAL_CONFIG_AUDIT_FEED_ENABLED[] = "Enabled";
+static const char LOCAL_CONFIG_AUDIT_FEED_SOCKET_PATH[] = "SocketPath";
+
+static const uint32_t DEFAULT_SCHEDULING_JITTER_PERCENTAGE = 10;
+static const uint32_t MAX_SCHEDULING_JITTER_PERCENTAGE = 100;
+
+typedef struct _LocalConfigurationCollectorIntervalKey {
+    TwinConfigurationEventType eventType;
+    const char* key;
+} LocalConfigurationCollectorIntervalKey;
+
+static const LocalConfigurationCollectorIntervalKey LOCAL_CONFIG_SCHEDULING_INTERVAL_KEYS[] = {
+    { EVENT_TYPE_BASELINE, "Baseline" },
+    { EVENT_TYPE_CONNECTION_CREATE, "ConnectionCreate" },
+    { EVENT_TYPE_FIREWALL_CONFIGURATION, "FirewallConfiguration" },
+    { EVENT_TYPE_LISTENING_PORTS, "ListeningPorts" },
+    { EVENT_TYPE_LOCAL_USERS, "LocalUsers" },
+    { EVENT_TYPE_PROCESS_CREATE, "ProcessCreate" },
+    { EVENT_TYPE_SYSTEM_INFORMATION, "SystemInformation" },
+    { EVENT_TYPE_USER_LOGIN, "UserLogin" }
+};
+
 /**
  * @brief   initializes the security module connection string using device authentication: certificate or sas token.
  * 
@@ -309,6 +352,105 @@ static void LocalConfiguration_InitLogger(JsonObjectReaderHandle jsonReader) {
     }
 }
 
+static void LocalConfiguration_InitSpill(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_SPILL) != JSON_READER_OK) {
+        Logger_Information("Could not find spill info in local config, events exceeding the cache are dropped");
+        return;
+    }
+
+    char* directory = NULL;
+    int32_t maxSize = 0;
+    if (JsonObjectReader_ReadString(jsonReader, LOCAL_CONFIG_SPILL_DIRECTORY, &directory) != JSON_READER_OK || strlen(directory) == 0) {
+        Logger_Information("Spill directory is not configured, events exceeding the cache are dropped");
+        goto cleanup;
+    }
+
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_SPILL_MAX_SIZE, &maxSize) != JSON_READER_OK || maxSize <= 0) {
+        Logger_Error("Failed reading spill max size from configuraiton file, events exceeding the cache are dropped");
+        goto cleanup;
+    }
+
+    if (Utils_CreateStringCopy(&spillDirectory, directory) == false) {
+        Logger_Error("Failed copying spill directory, events exceeding the cache are dropped");
+        goto cleanup;
+    }
+    maxSpillSize = (uint32_t)maxSize;
+
+cleanup:
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+static void LocalConfiguration_InitQueueBudgets(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_QUEUE_BUDGETS) != JSON_READER_OK) {
+        Logger_Information("Could not find queue budgets in local config, the event queues share the cache");
+        return;
+    }
+
+    int32_t budget = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_QUEUE_BUDGETS_HIGH_PRIORITY, &budget) == JSON_READER_OK && budget > 0) {
+        highPriorityQueueBudget = (uint32_t)budget;
+    }
+
+    budget = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_QUEUE_BUDGETS_LOW_PRIORITY, &budget) == JSON_READER_OK && budget > 0) {
+        lowPriorityQueueBudget = (uint32_t)budget;
+    }
+
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+static void LocalConfiguration_InitScheduling(JsonObjectReaderHandle jsonReader) {
+    schedulingJitterPercentage = DEFAULT_SCHEDULING_JITTER_PERCENTAGE;
+
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_SCHEDULING) != JSON_READER_OK) {
+        Logger_Information("Could not find scheduling info in local config, using default values");
+        return;
+    }
+
+    int32_t jitterPercentage = 0;
+    if (JsonObjectReader_ReadInt(jsonReader, LOCAL_CONFIG_SCHEDULING_JITTER_PERCENTAGE, &jitterPercentage) == JSON_READER_OK
+        && jitterPercentage >= 0 && (uint32_t)jitterPercentage <= MAX_SCHEDULING_JITTER_PERCENTAGE) {
+        schedulingJitterPercentage = (uint32_t)jitterPercentage;
+    }
+
+    // collectors which are missing from the intervals use the interval of their group
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_SCHEDULING_INTERVALS) == JSON_READER_OK) {
+        for (uint32_t i = 0; i < sizeof(LOCAL_CONFIG_SCHEDULING_INTERVAL_KEYS) / sizeof(LOCAL_CONFIG_SCHEDULING_INTERVAL_KEYS[0]); i++) {
+            uint32_t interval = 0;
+            if (JsonObjectReader_ReadTimeInMilliseconds(jsonReader, LOCAL_CONFIG_SCHEDULING_INTERVAL_KEYS[i].key, &interval) == JSON_READER_OK) {
+                collectorIntervals[LOCAL_CONFIG_SCHEDULING_INTERVAL_KEYS[i].eventType] = interval;
+            }
+        }
+        JsonObjectReader_StepOut(jsonReader);
+    }
+
+    JsonObjectReader_StepOut(jsonReader);
+}
+
+static void LocalConfiguration_InitAuditFeed(JsonObjectReaderHandle jsonReader) {
+    if (JsonObjectReader_StepIn(jsonReader, LOCAL_CONFIG_AUDIT_FEED) != JSON_READER_OK) {
+        Logger_Information("Could not find audit feed info in local config, the audit logs are scanned periodically");
+        return;
+    }
+
+    if (JsonObjectReader_ReadBool(jsonReader, LOCAL_CONFIG_AUDIT_FEED_ENABLED, &auditFeedEnabled) != JSON_READER_OK || !auditFeedEnabled) {
+        auditFeedEnabled = false;
+        goto cleanup;
+    }
+
+    // without a socket the feed listens to the audit netlink multicast group
+    char* socketPath = NULL;
+    if (JsonObjectReader_ReadString(jsonReader, LOCAL_CONFIG_AUDIT_FEED_SOCKET_PATH, &socketPath) == JSON_READER_OK && strlen(socketPath) > 0) {
+        if (Utils_CreateStringCopy(&auditFeedSocketPath, socketPath) == false) {
+            Logger_Error("Failed copying audit feed socket path, the audit logs are scanned periodically");
+            auditFeedEnabled = false;
+        }
+    }
+
+cleanup:
+    JsonObjectReader_StepOut(jsonReader);
+}
+
 LocalConfigurationResultValues LocalConfiguration_Init(){
     char* configurationFile = NULL;
     JsonObjectReaderHandle jsonReader = NULL;
@@ -392,6 +534,10 @@ LocalConfigurationResultValues LocalConfiguration_Init(){
         goto cleanup;
     }
 
+    LocalConfiguration_InitSpill(jsonReader);
+    LocalConfiguration_InitQueueBudgets(jsonReader);
+    LocalConfiguration_InitScheduling(jsonReader);
+    LocalConfiguration_InitAuditFeed(jsonReader);
     LocalConfiguration_InitLogger(jsonReader);
 
 cleanup:
@@ -438,6 +584,20 @@ void LocalConfiguration_Deinit() {
         free(agentId);
         agentId = NULL;
     }
+    if (spillDirectory != NULL) {
+        free(spillDirectory);
+        spillDirectory = NULL;
+    }
+    maxSpillSize = 0;
+    highPriorityQueueBudget = 0;
+    lowPriorityQueueBudget = 0;
+    memset(collectorIntervals, 0, sizeof(collectorIntervals));
+    schedulingJitterPercentage = 0;
+    auditFeedEnabled = false;
+    if (auditFeedSocketPath != NULL) {
+        free(auditFeedSocketPath);
+        auditFeedSocketPath = NULL;
+    }
 }
 
 const char* LocalConfiguration_GetConnectionString() {
@@ -470,4 +630,39 @@ uint32_t LocalConfiguration_GetConnectionTimeout() {
 
 const char* LocalConfiguration_GetRemoteConfigurationObjectName() {
     return remoteConfigurationObjectName;
+}
+
+const char* LocalConfiguration_GetSpillDirectory() {
+    return spillDirectory;
+}
+
+uint32_t LocalConfiguration_GetMaxSpillSize() {
+    return maxSpillSize;
+}
+
+uint32_t LocalConfiguration_GetHighPriorityQueueBudget() {
+    return highPriorityQueueBudget;
+}
+
+uint32_t LocalConfiguration_GetLowPriorityQueueBudget() {
+    return lowPriorityQueueBudget;
+}
+
+uint32_t LocalConfiguration_GetCollectorInterval(TwinConfigurationEventType eventType) {
+    if (eventType > EVENT_TYPE_OPERATIONAL_EVENT) {
+        return 0;
+    }
+    return collectorIntervals[eventType];
+}
+
+uint32_t LocalConfiguration_GetSchedulingJitterPercentage() {
+    return schedulingJitterPercentage;
+}
+
+bool LocalConfiguration_IsAuditFeedEnabled() {
+    return auditFeedEnabled;
+}
+
+const char* LocalConfiguration_GetAuditFeedSocketPath() {
+    return auditFeedSocketPath;
 }
\ No newline at end of file
@@ -0,0 +1,466 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "lru_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logger.h"
+#include "utils.h"
+
+#define LRU_CACHE_NONE -1
+#define LRU_CACHE_FILE_VERSION 2
+
+typedef struct _LruCacheFileHeader {
+
+    uint32_t version;
+    uint32_t count;
+
+} LruCacheFileHeader;
+
+// a record is followed by its key and value, without terminators
+typedef struct _LruCacheFileRecord {
+
+    uint32_t keyLength;
+    uint32_t valueLength;
+
+} LruCacheFileRecord;
+
+/**
+ * @brief Returns the bucket of the given key.
+ *
+ * @param   cache   The cache.
+ * @param   key     The key.
+ *
+ * @return the index of the bucket.
+ */
+static uint32_t LruCache_GetBucket(LruCache* cache, const char* key);
+
+/**
+ * @brief Finds the entry of the given key in its bucket.
+ *
+ * @param   cache   The cache.
+ * @param   key     The key.
+ * @param   bucket  The bucket of the key.
+ *
+ * @return the index of the entry or LRU_CACHE_NONE if the key is not in the cache.
+ */
+static int32_t LruCache_Find(LruCache* cache, const char* key, uint32_t bucket);
+
+/**
+ * @brief Removes the entry from the bucket of its key.
+ *
+ * @param   cache   The cache.
+ * @param   entry   The index of the entry.
+ */
+static void LruCache_RemoveFromBucket(LruCache* cache, int32_t entry);
+
+/**
+ * @brief Removes the entry from the recency list.
+ *
+ * @param   cache   The cache.
+ * @param   entry   The index of the entry.
+ */
+static void LruCache_Unlink(LruCache* cache, int32_t entry);
+
+/**
+ * @brief Adds the entry to the recency list as the most recently used one.
+ *
+ * @param   cache   The cache.
+ * @param   entry   The index of the entry.
+ */
+static void LruCache_LinkNewest(LruCache* cache, int32_t entry);
+
+/**
+ * @brief Opens the file of the cache, refusing a file other users could have planted or changed.
+ *
+ * @param   cache       The cache.
+ * @param   forWrite    Whether the file is opened to be rewritten, it is created if it does not exist.
+ * @param   file        Out param. The opened file.
+ *
+ * @return LRU_CACHE_OK on success, LRU_CACHE_NOT_FOUND if the file does not exist or LRU_CACHE_EXCEPTION otherwise.
+ */
+static LruCacheResultValues LruCache_OpenFile(LruCache* cache, bool forWrite, FILE** file);
+
+/**
+ * @brief Writes the entry to the file as a record.
+ *
+ * @param   file    The file.
+ * @param   entry   The entry.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool LruCache_WriteRecord(FILE* file, const LruCacheEntry* entry);
+
+/**
+ * @brief Reads the next record of the file and adds it to the cache.
+ *
+ * @param   cache   The cache.
+ * @param   file    The file.
+ *
+ * @return true on success, false if the file ended or the record is invalid.
+ */
+static bool LruCache_ReadRecord(LruCache* cache, FILE* file);
+
+/**
+ * @brief Loads the entries saved in the file of the cache, from the oldest to the newest.
+ *
+ * @param   cache   The cache.
+ */
+static void LruCache_Load(LruCache* cache);
+
+LruCacheResultValues LruCache_Init(LruCache* cache, uint32_t capacity, const char* file) {
+    LruCacheResultValues result = LRU_CACHE_OK;
+    memset(cache, 0, sizeof(*cache));
+    cache->newest = LRU_CACHE_NONE;
+    cache->oldest = LRU_CACHE_NONE;
+
+    if (capacity == 0) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+    cache->capacity = capacity;
+
+    // a power of two of at least the capacity, so the chains stay short
+    cache->bucketsCount = 1;
+    while (cache->bucketsCount < capacity) {
+        cache->bucketsCount <<= 1;
+    }
+
+    cache->entries = calloc(capacity, sizeof(LruCacheEntry));
+    cache->buckets = malloc(cache->bucketsCount * sizeof(int32_t));
+    if (cache->entries == NULL || cache->buckets == NULL) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+    memset(cache->buckets, 0xff, cache->bucketsCount * sizeof(int32_t));
+
+    if (file != NULL) {
+        if (!Utils_CreateStringCopy(&cache->file, file)) {
+            result = LRU_CACHE_EXCEPTION;
+            goto cleanup;
+        }
+        LruCache_Load(cache);
+    }
+
+cleanup:
+    if (result != LRU_CACHE_OK) {
+        LruCache_Deinit(cache);
+    }
+
+    return result;
+}
+
+void LruCache_Deinit(LruCache* cache) {
+    if (cache->entries != NULL) {
+        for (uint32_t i = 0; i < cache->count; ++i) {
+            free(cache->entries[i].key);
+            free(cache->entries[i].value);
+        }
+        free(cache->entries);
+        cache->entries = NULL;
+    }
+
+    if (cache->buckets != NULL) {
+        free(cache->buckets);
+        cache->buckets = NULL;
+    }
+
+    if (cache->file != NULL) {
+        free(cache->file);
+        cache->file = NULL;
+    }
+
+    cache->count = 0;
+}
+
+LruCacheResultValues LruCache_Get(LruCache* cache, const char* key, const char** value) {
+    if (cache->entries == NULL) {
+        return LRU_CACHE_NOT_FOUND;
+    }
+
+    int32_t entry = LruCache_Find(cache, key, LruCache_GetBucket(cache, key));
+    if (entry == LRU_CACHE_NONE) {
+        return LRU_CACHE_NOT_FOUND;
+    }
+
+    LruCache_Unlink(cache, entry);
+    LruCache_LinkNewest(cache, entry);
+    *value = cache->entries[entry].value;
+    return LRU_CACHE_OK;
+}
+
+LruCacheResultValues LruCache_Put(LruCache* cache, const char* key, const char* value) {
+    if (cache->entries == NULL) {
+        return LRU_CACHE_EXCEPTION;
+    }
+
+    if (strlen(key) >= LRU_CACHE_MAX_KEY_SIZE || strlen(value) >= LRU_CACHE_MAX_VALUE_SIZE) {
+        return LRU_CACHE_EXCEPTION;
+    }
+
+    uint32_t bucket = LruCache_GetBucket(cache, key);
+    int32_t entry = LruCache_Find(cache, key, bucket);
+    if (entry != LRU_CACHE_NONE) {
+        if (strcmp(cache->entries[entry].value, value) != 0) {
+            char* valueCopy = NULL;
+            if (!Utils_CreateStringCopy(&valueCopy, value)) {
+                return LRU_CACHE_EXCEPTION;
+            }
+            free(cache->entries[entry].value);
+            cache->entries[entry].value = valueCopy;
+            cache->isDirty = true;
+        }
+        LruCache_Unlink(cache, entry);
+        LruCache_LinkNewest(cache, entry);
+        return LRU_CACHE_OK;
+    }
+
+    // the copies are made first, so a failure does not evict an entry
+    char* keyCopy = NULL;
+    char* valueCopy = NULL;
+    if (!Utils_CreateStringCopy(&keyCopy, key) || !Utils_CreateStringCopy(&valueCopy, value)) {
+        free(keyCopy);
+        free(valueCopy);
+        return LRU_CACHE_EXCEPTION;
+    }
+
+    if (cache->count < cache->capacity) {
+        entry = (int32_t)cache->count++;
+    } else {
+        entry = cache->oldest;
+        LruCache_Unlink(cache, entry);
+        LruCache_RemoveFromBucket(cache, entry);
+        free(cache->entries[entry].key);
+        free(cache->entries[entry].value);
+    }
+
+    cache->entries[entry].key = keyCopy;
+    cache->entries[entry].value = valueCopy;
+    cache->entries[entry].nextInBucket = cache->buckets[bucket];
+    cache->buckets[bucket] = entry;
+    LruCache_LinkNewest(cache, entry);
+    cache->isDirty = true;
+
+    return LRU_CACHE_OK;
+}
+
+LruCacheResultValues LruCache_Save(LruCache* cache) {
+    LruCacheResultValues result = LRU_CACHE_OK;
+    FILE* file = NULL;
+
+    if (cache->file == NULL || !cache->isDirty) {
+        return LRU_CACHE_OK;
+    }
+
+    if (LruCache_OpenFile(cache, true, &file) != LRU_CACHE_OK) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+    LruCacheFileHeader header;
+    header.version = LRU_CACHE_FILE_VERSION;
+    header.count = cache->count;
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the oldest entry first, so loading the file back keeps the recency order
+    for (int32_t entry = cache->oldest; entry != LRU_CACHE_NONE; entry = cache->entries[entry].newer) {
+        if (!LruCache_WriteRecord(file, &cache->entries[entry])) {
+            result = LRU_CACHE_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+cleanup:
+    if (file != NULL && fclose(file) != 0) {
+        result = LRU_CACHE_EXCEPTION;
+    }
+
+    if (result == LRU_CACHE_OK) {
+        cache->isDirty = false;
+    } else {
+        Logger_Warning("Failed to save the cache to %s", cache->file);
+    }
+
+    return result;
+}
+
+uint32_t LruCache_GetCount(LruCache* cache) {
+    return cache->count;
+}
+
+static uint32_t LruCache_GetBucket(LruCache* cache, const char* key) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* c = key; *c != '\0'; ++c) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+
+    return hash & (cache->bucketsCount - 1);
+}
+
+static int32_t LruCache_Find(LruCache* cache, const char* key, uint32_t bucket) {
+    int32_t entry = cache->buckets[bucket];
+    while (entry != LRU_CACHE_NONE && strcmp(cache->entries[entry].key, key) != 0) {
+        entry = cache->entries[entry].nextInBucket;
+    }
+
+    return entry;
+}
+
+static void LruCache_RemoveFromBucket(LruCache* cache, int32_t entry) {
+    int32_t* current = &cache->buckets[LruCache_GetBucket(cache, cache->entries[entry].key)];
+    while (*current != entry) {
+        current = &cache->entries[*current].nextInBucket;
+    }
+
+    *current = cache->entries[entry].nextInBucket;
+}
+
+static void LruCache_Unlink(LruCache* cache, int32_t entry) {
+    LruCacheEntry* current = &cache->entries[entry];
+
+    if (current->newer != LRU_CACHE_NONE) {
+        cache->entries[current->newer].older = current->older;
+    } else {
+        cache->newest = current->older;
+    }
+
+    if (current->older != LRU_CACHE_NONE) {
+        cache->entries[current->older].newer = current->newer;
+    } else {
+        cache->oldest = current->newer;
+    }
+}
+
+static void LruCache_LinkNewest(LruCache* cache, int32_t entry) {
+    LruCacheEntry* current = &cache->entries[entry];
+    current->newer = LRU_CACHE_NONE;
+    current->older = cache->newest;
+
+    if (cache->newest != LRU_CACHE_NONE) {
+        cache->entries[cache->newest].newer = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+static LruCacheResultValues LruCache_OpenFile(LruCache* cache, bool forWrite, FILE** file) {
+    LruCacheResultValues result = LRU_CACHE_OK;
+    struct stat fileStat;
+    *file = NULL;
+
+    // the file may be in a directory other users can write to, so a symbolic link is not followed
+    int flags = forWrite ? O_WRONLY | O_CREAT : O_RDONLY;
+    int fd = open(cache->file, flags | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        result = errno == ENOENT ? LRU_CACHE_NOT_FOUND : LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+    // a file of another user, or one other users can change, is neither trusted nor overwritten
+    if (fstat(fd, &fileStat) != 0 ||
+        !S_ISREG(fileStat.st_mode) ||
+        fileStat.st_uid != geteuid() ||
+        (fileStat.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+        Logger_Warning("The cache file %s is not a private file of the agent", cache->file);
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+    // truncated only once the file is known to be ours
+    if (forWrite && ftruncate(fd, 0) != 0) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+    *file = fdopen(fd, forWrite ? "wb" : "rb");
+    if (*file == NULL) {
+        result = LRU_CACHE_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (result != LRU_CACHE_OK && fd >= 0) {
+        close(fd);
+    }
+
+    return result;
+}
+
+static bool LruCache_WriteRecord(FILE* file, const LruCacheEntry* entry) {
+    LruCacheFileRecord record;
+    record.keyLength = (uint32_t)strlen(entry->key);
+    record.valueLength = (uint32_t)strlen(entry->value);
+
+    return fwrite(&record, sizeof(record), 1, file) == 1 &&
+           fwrite(entry->key, 1, record.keyLength, file) == record.keyLength &&
+           fwrite(entry->value, 1, record.valueLength, file) == record.valueLength;
+}
+
+static bool LruCache_ReadRecord(LruCache* cache, FILE* file) {
+    LruCacheFileRecord record;
+    char key[LRU_CACHE_MAX_KEY_SIZE];
+    char value[LRU_CACHE_MAX_VALUE_SIZE];
+
+    if (fread(&record, sizeof(record), 1, file) != 1 ||
+        record.keyLength == 0 || record.keyLength >= sizeof(key) || record.valueLength >= sizeof(value)) {
+        return false;
+    }
+
+    if (fread(key, 1, record.keyLength, file) != record.keyLength ||
+        fread(value, 1, record.valueLength, file) != record.valueLength) {
+        return false;
+    }
+    key[record.keyLength] = '\0';
+    value[record.valueLength] = '\0';
+
+    // a terminator inside the key or the value means the file is corrupted
+    if (strlen(key) != record.keyLength || strlen(value) != record.valueLength) {
+        return false;
+    }
+
+    return LruCache_Put(cache, key, value) == LRU_CACHE_OK;
+}
+
+static void LruCache_Load(LruCache* cache) {
+    FILE* file = NULL;
+
+    LruCacheResultValues openResult = LruCache_OpenFile(cache, false, &file);
+    if (openResult != LRU_CACHE_OK) {
+        if (openResult != LRU_CACHE_NOT_FOUND) {
+            Logger_Warning("Failed to load the cache from %s", cache->file);
+        }
+        goto cleanup;
+    }
+
+    LruCacheFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.version != LRU_CACHE_FILE_VERSION) {
+        Logger_Warning("Ignoring the cache file %s of an unknown version", cache->file);
+        goto cleanup;
+    }
+
+    // the records are added from the oldest, so a file of more entries than the capacity keeps the newest ones
+    for (uint32_t i = 0; i < header.count; ++i) {
+        if (!LruCache_ReadRecord(cache, file)) {
+            Logger_Warning("The cache file %s is truncated or corrupted, %u entries were loaded", cache->file, cache->count);
+            break;
+        }
+    }
+    cache->isDirty = false;
+
+cleanup:
+    if (file != NULL) {
+        fclose(file);
+    }
+}
@@ -11,6 +11,10 @@ void MemoryMonitor_Deinit() {
     InternalMemoryMonitor_Deinit();
 }
 
+MemoryMonitorResultValues MemoryMonitor_UpdateLimit() {
+    return InternalMemoryMonitor_UpdateLimit();
+}
+
 MemoryMonitorResultValues MemoryMonitor_Consume(uint32_t sizeInBytes) {
     return InternalMemoryMonitor_Consume(sizeInBytes);
 }
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "message_compressor.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "logger.h"
+
+/**
+ * The window bits of a gzip stream, the default window size with the gzip wrapper.
+ */
+#define MESSAGE_COMPRESSOR_GZIP_WINDOW_BITS (15 + 16)
+
+/**
+ * The default memory level of zlib.
+ */
+#define MESSAGE_COMPRESSOR_MEMORY_LEVEL 8
+
+/**
+ * The max size of the empty block written by a flush, including the remaining bits of the previous block.
+ * An append is flushed once and is followed by the finishing block.
+ */
+#define MESSAGE_COMPRESSOR_FLUSH_OVERHEAD 6
+
+/**
+ * @brief Compresses the given data with the given flush mode into the output buffer.
+ *
+ * @param   compressor  The compressor instance.
+ * @param   data        The data to compress.
+ * @param   size        The size of the data.
+ * @param   flush       The flush mode of zlib.
+ *
+ * @return MESSAGE_COMPRESSOR_OK on success, MESSAGE_COMPRESSOR_OUT_OF_SPACE if the output exceeds the capacity,
+ *         MESSAGE_COMPRESSOR_EXCEPTION otherwise.
+ */
+static MessageCompressorResult MessageCompressor_Deflate(MessageCompressor* compressor, const char* data, uint32_t size, int flush);
+
+MessageCompressorResult MessageCompressor_Init(MessageCompressor* compressor, uint32_t capacity) {
+    memset(compressor, 0, sizeof(*compressor));
+
+    compressor->buffer = malloc(capacity);
+    if (compressor->buffer == NULL) {
+        Logger_Error("failed allocating the compression buffer");
+        return MESSAGE_COMPRESSOR_EXCEPTION;
+    }
+    compressor->capacity = capacity;
+
+    compressor->stream.zalloc = Z_NULL;
+    compressor->stream.zfree = Z_NULL;
+    compressor->stream.opaque = Z_NULL;
+    if (deflateInit2(&compressor->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MESSAGE_COMPRESSOR_GZIP_WINDOW_BITS, MESSAGE_COMPRESSOR_MEMORY_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK) {
+        Logger_Error("failed initializing the compression stream");
+        free(compressor->buffer);
+        compressor->buffer = NULL;
+        return MESSAGE_COMPRESSOR_EXCEPTION;
+    }
+
+    compressor->stream.next_out = (Bytef*)compressor->buffer;
+    compressor->stream.avail_out = capacity;
+
+    return MESSAGE_COMPRESSOR_OK;
+}
+
+void MessageCompressor_Deinit(MessageCompressor* compressor) {
+    deflateEnd(&compressor->stream);
+
+    if (compressor->buffer != NULL) {
+        free(compressor->buffer);
+        compressor->buffer = NULL;
+    }
+}
+
+static MessageCompressorResult MessageCompressor_Deflate(MessageCompressor* compressor, const char* data, uint32_t size, int flush) {
+    compressor->stream.next_in = (Bytef*)data;
+    compressor->stream.avail_in = size;
+
+    int result = deflate(&compressor->stream, flush);
+    if (result == Z_STREAM_ERROR) {
+        Logger_Error("failed compressing the message");
+        return MESSAGE_COMPRESSOR_EXCEPTION;
+    }
+
+    if (flush == Z_FINISH) {
+        return (result == Z_STREAM_END) ? MESSAGE_COMPRESSOR_OK : MESSAGE_COMPRESSOR_OUT_OF_SPACE;
+    }
+
+    // a full output buffer means the flush might not have completed
+    if (compressor->stream.avail_in > 0 || compressor->stream.avail_out == 0) {
+        return MESSAGE_COMPRESSOR_OUT_OF_SPACE;
+    }
+
+    return MESSAGE_COMPRESSOR_OK;
+}
+
+MessageCompressorResult MessageCompressor_Append(MessageCompressor* compressor, const char* data, uint32_t size) {
+    return MessageCompressor_Deflate(compressor, data, size, Z_SYNC_FLUSH);
+}
+
+uint32_t MessageCompressor_GetMaxAppendSize(MessageCompressor* compressor) {
+    uint32_t reserved = compressor->stream.total_out + 2 * MESSAGE_COMPRESSOR_FLUSH_OVERHEAD;
+    if (reserved >= compressor->capacity) {
+        return 0;
+    }
+    uint32_t available = compressor->capacity - reserved;
+
+    // the bound assumes the data does not compress at all, it also accounts for the whole gzip wrapper
+    // although its header was already written, so it is safe to use on a stream which has started
+    uint32_t size = available;
+    while (size > 0) {
+        uLong bound = deflateBound(&compressor->stream, size);
+        if (bound <= available) {
+            break;
+        }
+        size = (bound - available < size) ? size - (uint32_t)(bound - available) : 0;
+    }
+
+    return size;
+}
+
+MessageCompressorResult MessageCompressor_Finish(MessageCompressor* compressor, const char* data, uint32_t size, char** output, uint32_t* outputSize) {
+    MessageCompressorResult result = MessageCompressor_Deflate(compressor, data, size, Z_FINISH);
+    if (result != MESSAGE_COMPRESSOR_OK) {
+        return result;
+    }
+
+    *output = compressor->buffer;
+    *outputSize = compressor->stream.total_out;
+    compressor->buffer = NULL;
+
+    return MESSAGE_COMPRESSOR_OK;
+}
@@ -91,11 +91,20 @@ const char* AGENT_TELEMETRY_COLLECTED_EVENTS_KEY = "CollectedEvents";
 const char* AGENT_TELEMETRY_DROPPED_EVENTS_KEY = "DroppedEvents";
 const char* AGENT_TELEMETRY_DROPPED_EVENTS_NAME = "DroppedEventsStatistics";
 const char* AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_KEY = "EvictedEvents";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_NAME = "EvictedEventsStatistics";
+const char* AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_EVENT_TYPE_KEY = "EventType";
 const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME = "MessageStatistics";
 const char* AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION = "1.0";
 const char* AGENT_TELEMETRY_MESSAGES_FAILED_KEY = "TotalFailed";
 const char* AGENT_TELEMETRY_MESSAGES_SENT_KEY = "MessagesSent";
 const char* AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY = "MessagesUnder4KB";
+const char* AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY = "MessagesFillPercentage";
+const char* AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_NAME = "CollectorTimeBudgetExceeded";
+const char* AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_SCHEMA_VERSION = "1.0";
+const char* AGENT_TELEMETRY_COLLECTOR_KEY = "Collector";
+const char* AGENT_TELEMETRY_TIME_BUDGET_KEY = "TimeBudgetInMilliseconds";
 const char* AGENT_TELEMETRY_QUEUE_EVENTS_KEY = "Queue";
 
 const char* AGENT_CONFIGURATION_ERROR_CONFIGURATION_NAME_KEY = "ConfigurationName";
@@ -5,221 +5,534 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
-#include "json/json_array_writer.h"
-#include "json/json_object_writer.h"
+#include "event_splitter.h"
+#include "json/cbor_stream_writer.h"
+#include "json/json_stream_writer.h"
 #include "local_config.h"
 #include "logger.h"
+#include "message_compressor.h"
 #include "message_schema_consts.h"
 #include "twin_configuration.h"
 
+/**
+ * The state of a security message while events are added to it.
+ */
+typedef struct _SecurityMessage {
+
+    MessageSerializerEncoding encoding;
+    JsonStreamWriter writer;
+    CborStreamWriter cborWriter;
+    uint32_t maxMessageSize;
+    uint32_t eventsCount;
+
+    // the size of the uncompressed message as it is going to be sent, every event is accounted with its separator
+    uint32_t currentMessageSize;
+    uint32_t separatorSize;
+
+    bool isCompressed;
+    MessageCompressor compressor;
+    // the size of the output which was already handed to the compressor
+    uint32_t compressedSize;
+
+} SecurityMessage;
+
+/**
+ * The events created by the event splitter, returned to the front of the queue together once the split is done.
+ */
+typedef struct _SplitEvents {
+
+    QueueBatchItem* items;
+    uint32_t count;
+    uint32_t capacity;
+
+} SplitEvents;
+
 /**
  * @brief Handle adding events to the message from a single queue
  * 
- * @param   queue               Th queue to handle.
- * @param   eventsArray         The events array.
- * @param   currentMessageSize  Pointer to the current size of the security message.
- * @param   maxMessageSize      The max message size.
+ * @param   queue       Th queue to handle.
+ * @param   message     The message, its events array must be open.
  * 
- * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error. The value of the out param is undefined in case of failure.
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize);
+static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, SecurityMessage* message);
+
+/**
+ * @brief Returns the size of the events which can still be added to the message, every event is accounted with its separator.
+ *        A compressed message is accounted as if the events do not compress at all, so the message never exceeds the max
+ *        message size, while the events which were already added are accounted by their exact compressed size.
+ * 
+ * @param   message     The message.
+ * 
+ * @return the remaining size of the message.
+ */
+static uint32_t MessageSerializer_GetRemainingSize(SecurityMessage* message);
+
+/**
+ * @brief Returns the message written so far, in its encoding.
+ * 
+ * @param   message     The message.
+ * @param   size        Out param. The size of the output.
+ * 
+ * @return the output, owned by the writer of the message.
+ */
+static const char* MessageSerializer_GetOutput(SecurityMessage* message, uint32_t* size);
+
+/**
+ * @brief Hands the output written since the last call to the compressor, does nothing when the message is not compressed.
+ * 
+ * @param   message     The message.
+ * 
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_CompressPendingOutput(SecurityMessage* message);
+
+/**
+ * @brief Split the event at the head of the queue, which does not fit even into an empty message.
+ *        The split events take its place at the head of the queue in their original order, an event which cannot be split is dropped.
+ *        Otherwise such an event would stay at the head of the queue and block it forever.
+ * 
+ * @param   queue           The queue to handle.
+ * @param   maxEventSize    The max size of a single event in an empty message.
+ * 
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_SplitOversizedEvent(SyncQueue* queue, uint32_t maxEventSize);
+
+/**
+ * @brief Collect a split event, used as the callback of the event splitter.
+ * 
+ * @param   context     The split events to add the event to.
+ * @param   event       The split event, owned by the split events on success and freed otherwise.
+ * @param   eventSize   The size of the split event.
+ * 
+ * @return true on success, false otherwise.
+ */
+static bool MessageSerializer_PushSplitEvent(void* context, char* event, uint32_t eventSize);
 
 /**
  * @brief Generated the event list serialization.
  * 
  * @param    queues         The queues to take event from, the serializer create events from the first queue, than the second etc...  
  * @param    len            The length of the queues array            
- * @param    parentObj      The parent object which will hold the list of events.
+ * @param    message        The message, its events array must be open.
  * 
  * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue* queues[], uint32_t len, JsonObjectWriterHandle parentObj);
+static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue* queues[], uint32_t len, SecurityMessage* message);
 
 /**
- * @brief Serialize single event to the array.
+ * @brief Write the metadata of the message and open its events array.
  * 
- * @param   queue               The queue to pop the event from
- * @param   eventsArray         The array of events to add the new event to.
- * @param   currentMessageSize  Pointer to the current size of the security message.
- * @param   maxMessageSize      The maximum message size of the security message.
+ * @param   message     The message.
  * 
  * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
  */
-static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize);
+static MessageSerializerResultValues MessageSerializer_BeginMessage(SecurityMessage* message);
 
-typedef struct _SerializaerSizeLimits {
-    uint32_t currentMessageSize;
-    uint32_t maxMessageSize;
-} SerializaerSizeLimits;
+/**
+ * @brief Close the events array and the message.
+ * 
+ * @param   message     The message.
+ * 
+ * @return MESSAGE_SERIALIZER_OK on success, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_EndMessage(SecurityMessage* message);
 
 /**
- * @brief A message serializer size limitiation condition. Reutrn true if the data size + current size does not exceed the max size.
+ * @brief Copy a single serialized event to the events array of the message.
+ *        Events are serialized by the collectors before being queued, so a json message copies them as is
+ *        and a CBOR message converts them in a single pass, without parsing them into a document.
  * 
- * @param   data                The item
- * @param   size                The size of the item
- * @param   conditionParams     Struct of SerializaerSizeLimits
+ * @param   message     The message, its events array must be open.
+ * @param   data        The serialized event, as taken from the queue.
+ * @param   dataSize    The size of the serialized event.
+ * @param   maxSize     The max size the event may take in the message, including its separator.
+ * @param   addedSize   Out param. The size the event took in the message, including its separator.
  * 
- * @return true if (size + currentMessageSize) < maxMessageSize
+ * @return MESSAGE_SERIALIZER_OK on success, MESSAGE_SERIALIZER_MEMORY_EXCEEDED if the encoded event exceeds the max size,
+ *         in which case it is not added, otherwise the specific error.
+ */
+static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SecurityMessage* message, const char* data, uint32_t dataSize, uint32_t maxSize, uint32_t* addedSize);
+
+/**
+ * The maximal number of events taken out of a queue in a single batch.
+ */
+#define MESSAGE_SERIALIZER_BATCH_SIZE 64
+
+/**
+ * The size of the separator written between two events of the events array.
  */
-static bool sizeLimitationCondition(const void* data, uint32_t size, void* conditionParams) {
-    SerializaerSizeLimits* limits = (SerializaerSizeLimits*) conditionParams;
-    return ((limits->currentMessageSize + size) < limits->maxMessageSize);
+#define MESSAGE_SERIALIZER_EVENT_SEPARATOR_SIZE 1
+
+/**
+ * The size of the closing of the events array and of the message object, in both encodings.
+ */
+#define MESSAGE_SERIALIZER_ENVELOPE_CLOSING_SIZE 2
+
+static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SecurityMessage* message, const char* data, uint32_t dataSize, uint32_t maxSize, uint32_t* addedSize) {
+    if (message->encoding == MESSAGE_SERIALIZER_ENCODING_JSON) {
+        // the queue budget already made sure the event fits
+        if (JsonStreamWriter_WriteRaw(&message->writer, NULL, data, dataSize) != JSON_WRITER_OK) {
+            Logger_Error("error while appending the new event to the array");
+            return MESSAGE_SERIALIZER_EXCEPTION;
+        }
+        *addedSize = dataSize + message->separatorSize;
+        return MESSAGE_SERIALIZER_OK;
+    }
+
+    uint32_t previousSize = message->cborWriter.size;
+    if (CborStreamWriter_WriteJson(&message->cborWriter, NULL, data, dataSize) != JSON_WRITER_OK) {
+        Logger_Error("error while encoding the new event");
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+
+    // an event is almost always smaller as CBOR, yet long strings and fractions may take a few more bytes
+    *addedSize = message->cborWriter.size - previousSize;
+    if (*addedSize > maxSize) {
+        CborStreamWriter_Truncate(&message->cborWriter, previousSize);
+        return MESSAGE_SERIALIZER_MEMORY_EXCEEDED;
+    }
+
+    return MESSAGE_SERIALIZER_OK;
 }
 
-static MessageSerializerResultValues MessageSerializer_AddSingleEvent(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize) {
+static bool MessageSerializer_PushSplitEvent(void* context, char* event, uint32_t eventSize) {
+    SplitEvents* splitEvents = (SplitEvents*)context;
+
+    if (splitEvents->count == splitEvents->capacity) {
+        uint32_t capacity = (splitEvents->capacity == 0) ? 4 : splitEvents->capacity * 2;
+        QueueBatchItem* items = realloc(splitEvents->items, capacity * sizeof(QueueBatchItem));
+        if (items == NULL) {
+            Logger_Error("error while collecting a split event");
+            free(event);
+            return false;
+        }
+        splitEvents->items = items;
+        splitEvents->capacity = capacity;
+    }
+
+    splitEvents->items[splitEvents->count].data = event;
+    splitEvents->items[splitEvents->count].dataSize = eventSize;
+    splitEvents->count++;
+    return true;
+}
+
+static MessageSerializerResultValues MessageSerializer_SplitOversizedEvent(SyncQueue* queue, uint32_t maxEventSize) {
     MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
-    void* data = NULL;
-    uint32_t dataSize = 0;
-    JsonObjectWriterHandle eventWriter = NULL;
-    SerializaerSizeLimits limits;
-    limits.currentMessageSize = *currentMessageSize;
-    limits.maxMessageSize = maxMessageSize;
-    int queueResult = SyncQueue_PopFrontIf(queue, sizeLimitationCondition, &limits, &data, &dataSize);
+    void* event = NULL;
+    uint32_t eventSize = 0;
+    SplitEvents splitEvents = { NULL, 0, 0 };
+
+    int queueResult = SyncQueue_PopFront(queue, &event, &eventSize);
     if (queueResult == QUEUE_IS_EMPTY) {
-        result = MESSAGE_SERIALIZER_EMPTY;
-        goto cleanup;
-    } else if (queueResult == QUEUE_CONDITION_FAILED) {
-        result = MESSAGE_SERIALIZER_MEMORY_EXCEEDED;
+        // the event was evicted meanwhile
         goto cleanup;
     } else if (queueResult != QUEUE_OK) {
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
-    
-    if (JsonObjectWriter_InitFromString(&eventWriter, data) != JSON_WRITER_OK) {
-        Logger_Error("Error parsing event data as json");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
+
+    if (eventSize <= maxEventSize) {
+        // the head of the queue was replaced meanwhile, put the event back where it was
+        QueueBatchItem item = { event, eventSize };
+        if (SyncQueue_PushFront(queue, &item, 1) != QUEUE_OK) {
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+            goto cleanup;
+        }
+        event = NULL;
         goto cleanup;
     }
 
-    if (JsonArrayWriter_AddObject(eventsArray, eventWriter) != JSON_WRITER_OK) {
-        Logger_Error("error while appending the new event to the array");
+    EventSplitterResult splitResult = EventSplitter_Split(event, eventSize, maxEventSize, MessageSerializer_PushSplitEvent, &splitEvents);
+    if (splitResult == EVENT_SPLITTER_NOT_SPLITTABLE) {
+        Logger_Warning("dropping an event of %u bytes which exceeds the max message size", eventSize);
+    } else if (splitResult != EVENT_SPLITTER_OK) {
         result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
     }
-    *currentMessageSize += dataSize;
+
+    // the split events take the place of the original event at the head of the queue
+    if (splitEvents.count > 0) {
+        if (SyncQueue_PushFront(queue, splitEvents.items, splitEvents.count) != QUEUE_OK) {
+            Logger_Error("error while queueing the split events");
+            for (uint32_t i = 0; i < splitEvents.count; i++) {
+                free(splitEvents.items[i].data);
+            }
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+        }
+    }
 
 cleanup:
-    if (data != NULL) {
-        free(data);
+    if (event != NULL) {
+        free(event);
     }
 
-    if (eventWriter != NULL) {
-        JsonObjectWriter_Deinit(eventWriter);
+    if (splitEvents.items != NULL) {
+        free(splitEvents.items);
     }
 
     return result;
 }
 
-static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, JsonArrayWriterHandle eventsArray, uint32_t* currentMessageSize, uint32_t maxMessageSize) {
-    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+static uint32_t MessageSerializer_GetRemainingSize(SecurityMessage* message) {
+    if (!message->isCompressed) {
+        return (message->currentMessageSize < message->maxMessageSize) ? message->maxMessageSize - message->currentMessageSize : 0;
+    }
 
-    uint32_t queueSize = 0;
+    // the output which was not compressed yet and the closing of the message are still to be appended
+    uint32_t outputSize = 0;
+    MessageSerializer_GetOutput(message, &outputSize);
+    uint32_t reservedSize = outputSize - message->compressedSize + MESSAGE_SERIALIZER_ENVELOPE_CLOSING_SIZE;
+    uint32_t maxAppendSize = MessageCompressor_GetMaxAppendSize(&message->compressor);
 
-    if (SyncQueue_GetSize(queue, &queueSize) != QUEUE_OK) {
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+    return (reservedSize < maxAppendSize) ? maxAppendSize - reservedSize : 0;
+}
+
+static const char* MessageSerializer_GetOutput(SecurityMessage* message, uint32_t* size) {
+    if (message->encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) {
+        *size = message->cborWriter.size;
+        return message->cborWriter.buffer;
     }
 
-    while (queueSize > 0 && *currentMessageSize < maxMessageSize) {
-        result = MessageSerializer_AddSingleEvent(queue, eventsArray, currentMessageSize, maxMessageSize);
-        if (result == MESSAGE_SERIALIZER_MEMORY_EXCEEDED) {
-            result = MESSAGE_SERIALIZER_OK;
-            break;
-        } else if (result == MESSAGE_SERIALIZER_EMPTY) {
-            result = MESSAGE_SERIALIZER_OK;
+    *size = message->writer.size;
+    return message->writer.buffer;
+}
+
+static MessageSerializerResultValues MessageSerializer_CompressPendingOutput(SecurityMessage* message) {
+    if (!message->isCompressed) {
+        return MESSAGE_SERIALIZER_OK;
+    }
+
+    // the message is still open, so its output is taken from the buffer of the writer as is
+    uint32_t outputSize = 0;
+    const char* output = MessageSerializer_GetOutput(message, &outputSize);
+    if (MessageCompressor_Append(&message->compressor, output + message->compressedSize, outputSize - message->compressedSize) != MESSAGE_COMPRESSOR_OK) {
+        Logger_Error("error while compressing the security message");
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+    message->compressedSize = outputSize;
+
+    return MESSAGE_SERIALIZER_OK;
+}
+
+static MessageSerializerResultValues MessageSerializer_AddEventsFromQueue(SyncQueue* queue, SecurityMessage* message) {
+    MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+    QueueBatchItem batch[MESSAGE_SERIALIZER_BATCH_SIZE];
+    uint32_t batchCount = 0;
+    uint32_t i = 0;
+    bool isFull = false;
+
+    uint32_t remainingSize = MessageSerializer_GetRemainingSize(message);
+    while (remainingSize > 0 && !isFull) {
+        // the budget of the queue is exclusive, an event which fills the message exactly is still taken
+        int queueResult = SyncQueue_PopFrontBatch(queue, remainingSize + 1, message->separatorSize, MESSAGE_SERIALIZER_BATCH_SIZE, batch, &batchCount);
+        if (queueResult == QUEUE_CONDITION_FAILED && message->eventsCount == 0 && remainingSize > message->separatorSize) {
+            batchCount = 0;
+            if (MessageSerializer_SplitOversizedEvent(queue, remainingSize - message->separatorSize) != MESSAGE_SERIALIZER_OK) {
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+                goto cleanup;
+            }
+            continue;
+        } else if (queueResult == QUEUE_IS_EMPTY || queueResult == QUEUE_CONDITION_FAILED) {
             break;
-        } else if (result != MESSAGE_SERIALIZER_OK) {
+        } else if (queueResult != QUEUE_OK) {
+            batchCount = 0;
             result = MESSAGE_SERIALIZER_EXCEPTION;
             goto cleanup;
         }
 
-        if (SyncQueue_GetSize(queue, &queueSize) != QUEUE_OK) {
+        for (i = 0; i < batchCount; i++) {
+            uint32_t addedSize = 0;
+            MessageSerializerResultValues addResult = MessageSerializer_AddSingleEvent(message, batch[i].data, batch[i].dataSize, remainingSize, &addedSize);
+            if (addResult == MESSAGE_SERIALIZER_MEMORY_EXCEEDED && message->eventsCount == 0) {
+                Logger_Warning("dropping an event of %u bytes which exceeds the max message size once encoded", addedSize);
+                free(batch[i].data);
+                continue;
+            } else if (addResult == MESSAGE_SERIALIZER_MEMORY_EXCEEDED) {
+                isFull = true;
+                break;
+            } else if (addResult != MESSAGE_SERIALIZER_OK) {
+                result = MESSAGE_SERIALIZER_EXCEPTION;
+                goto cleanup;
+            }
+            message->currentMessageSize += addedSize;
+            remainingSize -= addedSize;
+            message->eventsCount++;
+            free(batch[i].data);
+        }
+
+        // the events which did not fit once encoded are returned to the head of the queue, to be sent first in the next message
+        if (i < batchCount && SyncQueue_PushFront(queue, batch + i, batchCount - i) != QUEUE_OK) {
+            Logger_Error("error while queueing the events which did not fit the message");
+            for (; i < batchCount; i++) {
+                free(batch[i].data);
+            }
+        }
+        i = batchCount;
+
+        if (MessageSerializer_CompressPendingOutput(message) != MESSAGE_SERIALIZER_OK) {
             result = MESSAGE_SERIALIZER_EXCEPTION;
             goto cleanup;
         }
+
+        if (batchCount < MESSAGE_SERIALIZER_BATCH_SIZE && message->encoding == MESSAGE_SERIALIZER_ENCODING_JSON && !message->isCompressed) {
+            // a json event takes exactly its queued size, so the queue was drained or the message is full
+            break;
+        }
+
+        // the events of a compressed or CBOR message usually take much less than they were accounted for,
+        // so the message is full only once the encoded size leaves no room
+        remainingSize = MessageSerializer_GetRemainingSize(message);
     }
 
 cleanup:
+    // free the events of the batch which were not added to the message
+    for (; i < batchCount; i++) {
+        free(batch[i].data);
+    }
+
     return result;
 }
 
-static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue** queues, uint32_t size, JsonObjectWriterHandle parentObj) { 
+static MessageSerializerResultValues MessageSerializer_GenerateEventList(SyncQueue** queues, uint32_t size, SecurityMessage* message) { 
     MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
-    JsonArrayWriterHandle eventsArray = NULL;
-    uint32_t currentMessageSize = 0;
-
-    if (size == 0){
-        goto cleanup;
+    // every event is accounted with a separator while the first one is written without,
+    // so the accounted size is the exact size of the message once it is closed
+    uint32_t outputSize = 0;
+    MessageSerializer_GetOutput(message, &outputSize);
+    message->currentMessageSize = outputSize + MESSAGE_SERIALIZER_ENVELOPE_CLOSING_SIZE - message->separatorSize;
+
+    if (MessageSerializer_CompressPendingOutput(message) != MESSAGE_SERIALIZER_OK) {
+        return MESSAGE_SERIALIZER_EXCEPTION;
     }
 
-    uint32_t maxMessageSize = 0;    
-    if (TwinConfiguration_GetMaxMessageSize(&maxMessageSize) != TWIN_OK) {
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+    for (int i = 0; i < size; i++){
+        if (MessageSerializer_AddEventsFromQueue(queues[i], message) != MESSAGE_SERIALIZER_OK) {
+            result = MESSAGE_SERIALIZER_PARTIAL;
+        }
     }
 
-    if (JsonArrayWriter_Init(&eventsArray) != JSON_WRITER_OK) {
-        Logger_Error("Error initializing the new events array");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+    if (message->eventsCount == 0) {
+        result = MESSAGE_SERIALIZER_EMPTY;
     }
 
-    for (int i = 0; i < size; i++){
-        if (currentMessageSize < maxMessageSize) {
-            if (MessageSerializer_AddEventsFromQueue(queues[i], eventsArray, &currentMessageSize, maxMessageSize) != MESSAGE_SERIALIZER_OK) {
-                result = MESSAGE_SERIALIZER_PARTIAL;
-            }
+    return result;
+}
+
+static MessageSerializerResultValues MessageSerializer_BeginMessage(SecurityMessage* message) {
+    if (message->encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) {
+        if (CborStreamWriter_BeginObject(&message->cborWriter, NULL) != JSON_WRITER_OK ||
+            CborStreamWriter_WriteString(&message->cborWriter, AGENT_VERSION_KEY, AGENT_VERSION) != JSON_WRITER_OK ||
+            CborStreamWriter_WriteString(&message->cborWriter, AGENT_ID_KEY, LocalConfiguration_GetAgentId()) != JSON_WRITER_OK ||
+            CborStreamWriter_WriteString(&message->cborWriter, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION) != JSON_WRITER_OK ||
+            CborStreamWriter_BeginArray(&message->cborWriter, EVENTS_KEY) != JSON_WRITER_OK) {
+            Logger_Error("Error encoding the security message metadata");
+            return MESSAGE_SERIALIZER_EXCEPTION;
         }
+        return MESSAGE_SERIALIZER_OK;
+    }
+
+    JsonStreamWriter* securityMessageWriter = &message->writer;
+    if (JsonStreamWriter_BeginObject(securityMessageWriter, NULL) != JSON_WRITER_OK) {
+        Logger_Error("Error initializing the security message writer");
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(securityMessageWriter, AGENT_VERSION_KEY, AGENT_VERSION) != JSON_WRITER_OK) {
+        Logger_Error("Error setting the agent version");
+        return MESSAGE_SERIALIZER_EXCEPTION;
     }
 
-    if (JsonObjectWriter_WriteArray(parentObj, EVENTS_KEY, eventsArray) != JSON_WRITER_OK) {
+    if (JsonStreamWriter_WriteString(securityMessageWriter, AGENT_ID_KEY, LocalConfiguration_GetAgentId()) != JSON_WRITER_OK) {
+        Logger_Error("Error setting the agent id");
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_WriteString(securityMessageWriter, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION) != JSON_WRITER_OK) {
+        Logger_Error("Error setting the message schema version");
+        return MESSAGE_SERIALIZER_EXCEPTION;
+    }
+
+    if (JsonStreamWriter_BeginArray(securityMessageWriter, EVENTS_KEY) != JSON_WRITER_OK) {
         Logger_Error("Error setting events array value to security message");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+        return MESSAGE_SERIALIZER_EXCEPTION;
     }
-    
-cleanup:
-    if (eventsArray != NULL) {
-        JsonArrayWriter_Deinit(eventsArray);
+
+    return MESSAGE_SERIALIZER_OK;
+}
+
+static MessageSerializerResultValues MessageSerializer_EndMessage(SecurityMessage* message) {
+    JsonWriterResult result = JSON_WRITER_OK;
+
+    if (message->encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) {
+        result = CborStreamWriter_EndArray(&message->cborWriter);
+        if (result == JSON_WRITER_OK) {
+            result = CborStreamWriter_EndObject(&message->cborWriter);
+        }
+    } else {
+        result = JsonStreamWriter_EndArray(&message->writer);
+        if (result == JSON_WRITER_OK) {
+            result = JsonStreamWriter_EndObject(&message->writer);
+        }
     }
-    if (currentMessageSize == 0) {
-        result = MESSAGE_SERIALIZER_EMPTY;
+
+    if (result != JSON_WRITER_OK) {
+        Logger_Error("Error closing the security message");
+        return MESSAGE_SERIALIZER_EXCEPTION;
     }
 
-    return result;
+    return MESSAGE_SERIALIZER_OK;
 }
 
-MessageSerializerResultValues MessageSerializer_CreateSecurityMessage(SyncQueue* queues[], uint32_t len, void** buffer) {
+MessageSerializerResultValues MessageSerializer_CreateSecurityMessage(SyncQueue* queues[], uint32_t len, MessageSerializerEncoding encoding, bool compress, void** buffer, uint32_t* bufferSize) {
     MessageSerializerResultValues result = MESSAGE_SERIALIZER_OK;
+    SecurityMessage securityMessage;
+    bool isWriterInitialized = false;
+    bool isCompressorInitialized = false;
 
-    JsonObjectWriterHandle securityMessageWriter = NULL;
-    if (JsonObjectWriter_Init(&securityMessageWriter) != JSON_WRITER_OK) {
-        Logger_Error("Error initializing the security message writer");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
-        goto cleanup;
+    if (len == 0) {
+        return MESSAGE_SERIALIZER_EMPTY;
     }
-    
-    if (JsonObjectWriter_WriteString(securityMessageWriter, AGENT_VERSION_KEY, AGENT_VERSION) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
+
+    memset(&securityMessage, 0, sizeof(securityMessage));
+    securityMessage.encoding = encoding;
+    securityMessage.isCompressed = compress;
+    // CBOR needs no separator between the items of an array
+    securityMessage.separatorSize = (encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) ? 0 : MESSAGE_SERIALIZER_EVENT_SEPARATOR_SIZE;
+
+    if (TwinConfiguration_GetMaxMessageSize(&securityMessage.maxMessageSize) != TWIN_OK) {
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
 
-    if (JsonObjectWriter_WriteString(securityMessageWriter, AGENT_ID_KEY, LocalConfiguration_GetAgentId()) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
+    // an uncompressed message never exceeds the max message size, so the buffer is allocated once
+    JsonWriterResult writerResult = (encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) ?
+        CborStreamWriter_Init(&securityMessage.cborWriter, securityMessage.maxMessageSize + 1) :
+        JsonStreamWriter_Init(&securityMessage.writer, securityMessage.maxMessageSize + 1);
+    if (writerResult != JSON_WRITER_OK) {
+        Logger_Error("Error initializing the security message writer");
         result = MESSAGE_SERIALIZER_EXCEPTION;
         goto cleanup;
     }
+    isWriterInitialized = true;
 
-    if (JsonObjectWriter_WriteString(securityMessageWriter, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION) != JSON_WRITER_OK) {
-        Logger_Error("Error setting the agent version");
-        result = MESSAGE_SERIALIZER_EXCEPTION;
+    if (compress) {
+        if (MessageCompressor_Init(&securityMessage.compressor, securityMessage.maxMessageSize) != MESSAGE_COMPRESSOR_OK) {
+            Logger_Error("Error initializing the security message compressor");
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+            goto cleanup;
+        }
+        isCompressorInitialized = true;
+    }
+
+    result = MessageSerializer_BeginMessage(&securityMessage);
+    if (result != MESSAGE_SERIALIZER_OK) {
         goto cleanup;
     }
 
-    result = MessageSerializer_GenerateEventList(queues, len, securityMessageWriter);
+    result = MessageSerializer_GenerateEventList(queues, len, &securityMessage);
     if (result == MESSAGE_SERIALIZER_EMPTY) {
         goto cleanup;
     }
@@ -228,16 +541,40 @@ MessageSerializerResultValues MessageSerializer_CreateSecurityMessage(SyncQueue*
         goto cleanup;
     }
 
-    uint32_t buffersize = 0;
-    if (JsonObjectWriter_Serialize(securityMessageWriter, (char**)buffer, &buffersize) != JSON_WRITER_OK) {
+    if (MessageSerializer_EndMessage(&securityMessage) != MESSAGE_SERIALIZER_OK) {
+        result = MESSAGE_SERIALIZER_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (compress) {
+        uint32_t outputSize = 0;
+        const char* output = MessageSerializer_GetOutput(&securityMessage, &outputSize);
+        if (MessageCompressor_Finish(&securityMessage.compressor, output + securityMessage.compressedSize, outputSize - securityMessage.compressedSize, (char**)buffer, bufferSize) != MESSAGE_COMPRESSOR_OK) {
+            Logger_Error("Error compressing the security message");
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+        }
+    } else if (encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) {
+        if (CborStreamWriter_Serialize(&securityMessage.cborWriter, (char**)buffer, bufferSize) != JSON_WRITER_OK) {
+            Logger_Error("Error serialing the security message");
+            result = MESSAGE_SERIALIZER_EXCEPTION;
+        }
+    } else if (JsonStreamWriter_Serialize(&securityMessage.writer, (char**)buffer, bufferSize) != JSON_WRITER_OK) {
         Logger_Error("Error serialing the security message");
         result = MESSAGE_SERIALIZER_EXCEPTION;
     }
 
 cleanup:
     
-    if (securityMessageWriter != NULL) {
-        JsonObjectWriter_Deinit(securityMessageWriter);
+    if (isCompressorInitialized) {
+        MessageCompressor_Deinit(&securityMessage.compressor);
+    }
+
+    if (isWriterInitialized) {
+        if (encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) {
+            CborStreamWriter_Deinit(&securityMessage.cborWriter);
+        } else {
+            JsonStreamWriter_Deinit(&securityMessage.writer);
+        }
     }
 
     if (result != MESSAGE_SERIALIZER_OK && result != MESSAGE_SERIALIZER_PARTIAL) {
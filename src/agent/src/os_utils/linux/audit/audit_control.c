@@ -6,11 +6,24 @@
 #include "logger.h"
 
 #include <auparse.h>
+#include <ctype.h>
 #include <libaudit.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/utsname.h>
 
+#define AUDIT_CONTROL_MAX_EXCLUSIONS 32
+#define AUDIT_CONTROL_MAX_EXCLUSION_FILTERS 2
+
+typedef enum _AuditControlExclusionType {
+
+    AUDIT_CONTROL_EXCLUDE_EXECUTABLE,
+    AUDIT_CONTROL_EXCLUDE_UID,
+    AUDIT_CONTROL_EXCLUDE_AUID_RANGE
+
+} AuditControlExclusionType;
+
 const char AUDIT_CONTROL_ON_SUCCESS_FILTER[] = "success=1";
 const char AUDIT_CONTROL_TYPE_EXECVE[] = "execve";
 const char AUDIT_CONTROL_TYPE_EXECVEAT[] = "execveat";
@@ -26,6 +39,68 @@ const char AUDIT_CONTROL_TYPE_ACCEPT[] = "accept";
  */
 static bool getCpuArchitectureFilter(char** cpuArchitectureFilter);
 
+/**
+ * @brief Deletes all the rules which are tagged with the given key.
+ * 
+ * @param   auditControl    The audit instance.
+ * @param   key             The key of the rules.
+ * 
+ * @return AUDIT_CONTROL_OK on success or an appropriate error.
+ */
+static AuditControlResultValues AuditControl_DeleteRules(AuditControl* auditControl, const char* key);
+
+/**
+ * @brief Checks whether the given rule, as listed by the kernel, is tagged with the given key.
+ * 
+ * @param   rule    The rule.
+ * @param   length  The length of the rule including its strings buffer.
+ * @param   key     The key.
+ * 
+ * @return true if the rule has the key.
+ */
+static bool AuditControl_RuleHasKey(const struct audit_rule_data* rule, size_t length, const char* key);
+
+/**
+ * @brief Adds a never rule for each entry of the given comma separated exclusion list.
+ *        Invalid entries, and the entries beyond AUDIT_CONTROL_MAX_EXCLUSIONS, are skipped.
+ * 
+ * @param   auditControl        The audit instance.
+ * @param   msgTypeArray        The message type array of the rules.
+ * @param   msgTypeArraySize    The message type array size of the rules.
+ * @param   key                 The key the rules are tagged with.
+ * @param   type                The type of the entries.
+ * @param   list                The exclusion list, NULL for none.
+ * 
+ * @return AUDIT_CONTROL_OK if all the entries were excluded or an appropriate error.
+ */
+static AuditControlResultValues AuditControl_AddExclusionRules(AuditControl* auditControl, const char** msgTypeArray, size_t msgTypeArraySize, const char* key, AuditControlExclusionType type, const char* list);
+
+/**
+ * @brief Builds the field filters which match a single exclusion entry, e.g. "auid>=1000" and "auid<=1999" for "1000-1999".
+ * 
+ * @param   type            The type of the entry.
+ * @param   entry           The entry.
+ * @param   filters         Out param. The filters, AUDIT_CONTROL_MAX_EXCLUSION_FILTERS at most, to be freed by the caller.
+ * @param   filtersCount    Out param. The number of filters.
+ * 
+ * @return true on success, false if the entry is invalid.
+ */
+static bool AuditControl_GetExclusionFilters(AuditControlExclusionType type, char* entry, char** filters, size_t* filtersCount);
+
+/**
+ * @brief Adds a rule which drops the given syscalls when all the given filters match, ahead of the existing rules.
+ * 
+ * @param   auditControl        The audit instance.
+ * @param   msgTypeArray        The message type array of the rule.
+ * @param   msgTypeArraySize    The message type array size of the rule.
+ * @param   key                 The key the rule is tagged with.
+ * @param   filters             The field filters of the rule.
+ * @param   filtersCount        The number of filters.
+ * 
+ * @return AUDIT_CONTROL_OK on success or an appropriate error.
+ */
+static AuditControlResultValues AuditControl_AddExclusionRule(AuditControl* auditControl, const char** msgTypeArray, size_t msgTypeArraySize, const char* key, char** filters, size_t filtersCount);
+
 AuditControlResultValues AuditControl_Init(AuditControl* auditControl) {
     AuditControlResultValues result = AUDIT_CONTROL_OK;
 
@@ -132,6 +207,279 @@ cleanup:
     return result;
 }
 
+AuditControlResultValues AuditControl_SetExclusions(AuditControl* auditControl, const char** msgTypeArray, size_t msgTypeArraySize, const char* key, const AuditControlExclusions* exclusions) {
+    AuditControlResultValues result = AUDIT_CONTROL_OK;
+
+    // the rules of the previous exclusions are replaced, including the ones left by an earlier run of the agent
+    if (AuditControl_DeleteRules(auditControl, key) != AUDIT_CONTROL_OK) {
+        Logger_Error("Could not delete the previous audit exclusions.");
+        return AUDIT_CONTROL_EXCEPTION;
+    }
+
+    if (AuditControl_AddExclusionRules(auditControl, msgTypeArray, msgTypeArraySize, key, AUDIT_CONTROL_EXCLUDE_EXECUTABLE, exclusions->executables) != AUDIT_CONTROL_OK) {
+        result = AUDIT_CONTROL_EXCEPTION;
+    }
+
+    if (AuditControl_AddExclusionRules(auditControl, msgTypeArray, msgTypeArraySize, key, AUDIT_CONTROL_EXCLUDE_UID, exclusions->uids) != AUDIT_CONTROL_OK) {
+        result = AUDIT_CONTROL_EXCEPTION;
+    }
+
+    if (AuditControl_AddExclusionRules(auditControl, msgTypeArray, msgTypeArraySize, key, AUDIT_CONTROL_EXCLUDE_AUID_RANGE, exclusions->auidRanges) != AUDIT_CONTROL_OK) {
+        result = AUDIT_CONTROL_EXCEPTION;
+    }
+
+    return result;
+}
+
+AuditControlResultValues AuditControl_DeleteExclusions(AuditControl* auditControl, const char* key) {
+    return AuditControl_DeleteRules(auditControl, key);
+}
+
+static AuditControlResultValues AuditControl_DeleteRules(AuditControl* auditControl, const char* key) {
+    AuditControlResultValues result = AUDIT_CONTROL_OK;
+    struct audit_rule_data** rules = NULL;
+    size_t rulesCount = 0;
+    struct audit_reply reply;
+    bool done = false;
+
+    if (audit_request_rules_list_data(auditControl->audit) <= 0) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the listed rules are copied, a reply is overwritten by the next one and the list must be drained before deleting
+    while (!done) {
+        if (audit_get_reply(auditControl->audit, &reply, GET_REPLY_BLOCKING, 0) <= 0) {
+            result = AUDIT_CONTROL_EXCEPTION;
+            goto cleanup;
+        }
+
+        if (reply.type == NLMSG_DONE) {
+            done = true;
+        } else if (reply.type == NLMSG_ERROR) {
+            if (reply.error->error != 0) {
+                result = AUDIT_CONTROL_EXCEPTION;
+                goto cleanup;
+            }
+        } else if (reply.type == AUDIT_LIST_RULES && AuditControl_RuleHasKey(reply.ruledata, (size_t)reply.len, key)) {
+            size_t length = sizeof(struct audit_rule_data) + reply.ruledata->buflen;
+            struct audit_rule_data** newRules = realloc(rules, (rulesCount + 1) * sizeof(struct audit_rule_data*));
+            if (newRules == NULL) {
+                result = AUDIT_CONTROL_EXCEPTION;
+                goto cleanup;
+            }
+            rules = newRules;
+
+            rules[rulesCount] = malloc(length);
+            if (rules[rulesCount] == NULL) {
+                result = AUDIT_CONTROL_EXCEPTION;
+                goto cleanup;
+            }
+            memcpy(rules[rulesCount], reply.ruledata, length);
+            rulesCount++;
+        }
+    }
+
+    for (size_t i = 0; i < rulesCount; i++) {
+        if (audit_delete_rule_data(auditControl->audit, rules[i], rules[i]->flags, rules[i]->action) <= 0) {
+            result = AUDIT_CONTROL_EXCEPTION;
+        }
+    }
+
+cleanup:
+    if (rules != NULL) {
+        for (size_t i = 0; i < rulesCount; i++) {
+            free(rules[i]);
+        }
+        free(rules);
+    }
+
+    return result;
+}
+
+static bool AuditControl_RuleHasKey(const struct audit_rule_data* rule, size_t length, const char* key) {
+    size_t keyLength = strlen(key);
+    size_t offset = 0;
+
+    if (length < sizeof(struct audit_rule_data) || length - sizeof(struct audit_rule_data) < rule->buflen) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < rule->field_count && i < AUDIT_MAX_FIELDS; i++) {
+        uint32_t field = rule->fields[i];
+        // the values of the string fields are their lengths, the strings follow each other in the buffer
+        bool isString = (field >= AUDIT_SUBJ_USER && field <= AUDIT_OBJ_LEV_HIGH && field != AUDIT_PPID) ||
+                        field == AUDIT_WATCH || field == AUDIT_DIR || field == AUDIT_FILTERKEY || field == AUDIT_EXE;
+        if (!isString) {
+            continue;
+        }
+
+        if (rule->values[i] > rule->buflen - offset) {
+            return false;
+        }
+
+        if (field == AUDIT_FILTERKEY && rule->values[i] == keyLength && memcmp(rule->buf + offset, key, keyLength) == 0) {
+            return true;
+        }
+        offset += rule->values[i];
+    }
+
+    return false;
+}
+
+static AuditControlResultValues AuditControl_AddExclusionRules(AuditControl* auditControl, const char** msgTypeArray, size_t msgTypeArraySize, const char* key, AuditControlExclusionType type, const char* list) {
+    AuditControlResultValues result = AUDIT_CONTROL_OK;
+    char* listCopy = NULL;
+    char* savePtr = NULL;
+    uint32_t exclusionsCount = 0;
+
+    if (list == NULL) {
+        return AUDIT_CONTROL_OK;
+    }
+
+    if (!Utils_CreateStringCopy(&listCopy, list)) {
+        return AUDIT_CONTROL_EXCEPTION;
+    }
+
+    for (char* entry = strtok_r(listCopy, ",", &savePtr); entry != NULL; entry = strtok_r(NULL, ",", &savePtr)) {
+        while (isspace((unsigned char)*entry)) {
+            entry++;
+        }
+        for (char* end = entry + strlen(entry); end > entry && isspace((unsigned char)end[-1]); end--) {
+            end[-1] = '\0';
+        }
+        if (*entry == '\0') {
+            continue;
+        }
+
+        if (exclusionsCount == AUDIT_CONTROL_MAX_EXCLUSIONS) {
+            Logger_Warning("Too many audit exclusions, ignoring %s and the ones after it.", entry);
+            result = AUDIT_CONTROL_EXCEPTION;
+            break;
+        }
+
+        char* filters[AUDIT_CONTROL_MAX_EXCLUSION_FILTERS] = { NULL };
+        size_t filtersCount = 0;
+        if (!AuditControl_GetExclusionFilters(type, entry, filters, &filtersCount)) {
+            Logger_Warning("Ignoring the invalid audit exclusion %s.", entry);
+            result = AUDIT_CONTROL_EXCEPTION;
+        } else if (AuditControl_AddExclusionRule(auditControl, msgTypeArray, msgTypeArraySize, key, filters, filtersCount) != AUDIT_CONTROL_OK) {
+            Logger_Warning("Could not exclude %s from audit.", entry);
+            result = AUDIT_CONTROL_EXCEPTION;
+        } else {
+            exclusionsCount++;
+        }
+
+        for (size_t i = 0; i < AUDIT_CONTROL_MAX_EXCLUSION_FILTERS; i++) {
+            if (filters[i] != NULL) {
+                free(filters[i]);
+            }
+        }
+    }
+
+    free(listCopy);
+    return result;
+}
+
+static bool AuditControl_GetExclusionFilters(AuditControlExclusionType type, char* entry, char** filters, size_t* filtersCount) {
+    *filtersCount = 0;
+
+    if (type == AUDIT_CONTROL_EXCLUDE_EXECUTABLE) {
+        if (entry[0] != '/') {
+            return false;
+        }
+        if (Utils_StringFormat("exe=%s", &filters[(*filtersCount)++], entry) != ACTION_OK) {
+            return false;
+        }
+    } else if (type == AUDIT_CONTROL_EXCLUDE_UID) {
+        // a user name is resolved by libaudit
+        if (Utils_StringFormat("uid=%s", &filters[(*filtersCount)++], entry) != ACTION_OK) {
+            return false;
+        }
+    } else {
+        char* last = strchr(entry, '-');
+        if (last == NULL) {
+            if (!Utils_IsStringNumeric(entry)) {
+                return false;
+            }
+            if (Utils_StringFormat("auid=%s", &filters[(*filtersCount)++], entry) != ACTION_OK) {
+                return false;
+            }
+        } else {
+            *last++ = '\0';
+            if (*entry == '\0' || *last == '\0' || !Utils_IsStringNumeric(entry) || !Utils_IsStringNumeric(last) ||
+                strtoul(entry, NULL, 10) > strtoul(last, NULL, 10)) {
+                return false;
+            }
+            if (Utils_StringFormat("auid>=%s", &filters[(*filtersCount)++], entry) != ACTION_OK ||
+                Utils_StringFormat("auid<=%s", &filters[(*filtersCount)++], last) != ACTION_OK) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static AuditControlResultValues AuditControl_AddExclusionRule(AuditControl* auditControl, const char** msgTypeArray, size_t msgTypeArraySize, const char* key, char** filters, size_t filtersCount) {
+    AuditControlResultValues result = AUDIT_CONTROL_OK;
+    struct audit_rule_data* rule = NULL;
+    char* keyFilter = NULL;
+    int flags = AUDIT_FILTER_EXIT & AUDIT_FILTER_MASK;
+
+    rule = calloc(1, sizeof(struct audit_rule_data));
+    if (rule == NULL) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (audit_rule_fieldpair_data(&rule, auditControl->cpuArchitectureFilter, flags) != 0) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+    for (size_t i = 0; i < msgTypeArraySize; i++) {
+        if (audit_rule_syscallbyname_data(rule, msgTypeArray[i]) < 0) {
+            result = AUDIT_CONTROL_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    for (size_t i = 0; i < filtersCount; i++) {
+        if (audit_rule_fieldpair_data(&rule, filters[i], flags) != 0) {
+            result = AUDIT_CONTROL_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    if (Utils_StringFormat("key=%s", &keyFilter, key) != ACTION_OK) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (audit_rule_fieldpair_data(&rule, keyFilter, flags) != 0) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the never rule is prepended, so the syscall is dropped before the always rules of the collectors match it
+    if (audit_add_rule_data(auditControl->audit, rule, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER) <= 0) {
+        result = AUDIT_CONTROL_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (keyFilter != NULL) {
+        free(keyFilter);
+    }
+
+    if (rule != NULL) {
+        free(rule);
+    }
+
+    return result;
+}
+
 static bool getCpuArchitectureFilter(char** cpuArchitectureFilter) {
     struct utsname utsnameBuffer = {0};
     if (cpuArchitectureFilter == NULL) {
@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/linux/audit/audit_dispatcher.h"
+
+#include <auparse.h>
+#include <string.h>
+
+#include "logger.h"
+#include "os_utils/linux/audit/audit_search.h"
+
+static const char AUDIT_DISPATCHER_SYSCALL_FIELD[] = "syscall";
+static const char AUDIT_DISPATCHER_EXECUTABLE_FIELD[] = "exe";
+static const char AUDIT_DISPATCHER_USER_AUTH_NAME[] = "USER_AUTH";
+// the USER_AUTH events of sudo are not logins, the audit log search skips them too
+static const char* AUDIT_DISPATCHER_SUDO_EXECUTABLES[] = {"/usr/bin/sudo", "/bin/sudo"};
+
+/**
+ * @brief Checks whether the current event matches the search criteria of the handler.
+ *
+ * @param   audit       The auparse instance, positioned on the event.
+ * @param   handler     The handler.
+ *
+ * @return true if the handler should handle the event, false otherwise.
+ */
+static bool AuditDispatcher_IsMatch(auparse_state_t* audit, const AuditDispatcherHandler* handler);
+
+/**
+ * @brief Checks whether the given type is one of the message types of the handler.
+ *
+ * @param   handler     The handler.
+ * @param   type        The message type or the syscall name.
+ *
+ * @return true if the type is one of the message types, false otherwise.
+ */
+static bool AuditDispatcher_IsMessageType(const AuditDispatcherHandler* handler, const char* type);
+
+/**
+ * @brief Checks whether the executable of the current record is sudo.
+ *
+ * @param   audit       The auparse instance, positioned on the record.
+ *
+ * @return true if the executable is sudo, false otherwise.
+ */
+static bool AuditDispatcher_IsSudo(auparse_state_t* audit);
+
+void AuditDispatcher_Init(AuditDispatcher* dispatcher, const char* checkpointFile) {
+    memset(dispatcher, 0, sizeof(*dispatcher));
+    dispatcher->checkpointFile = checkpointFile;
+}
+
+AuditDispatcherResultValues AuditDispatcher_AddHandler(AuditDispatcher* dispatcher, AuditSearchCriteria searchCriteria, const char** messageTypes, uint32_t messageTypesCount, AuditDispatcherEventHandler handler, void* context) {
+    if (dispatcher->handlersCount >= AUDIT_DISPATCHER_MAX_HANDLERS || messageTypesCount > AUDIT_DISPATCHER_MAX_MESSAGE_TYPES) {
+        return AUDIT_DISPATCHER_EXCEPTION;
+    }
+
+    AuditDispatcherHandler* dispatcherHandler = &dispatcher->handlers[dispatcher->handlersCount++];
+    dispatcherHandler->searchCriteria = searchCriteria;
+    memcpy(dispatcherHandler->messageTypes, messageTypes, messageTypesCount * sizeof(messageTypes[0]));
+    dispatcherHandler->messageTypesCount = messageTypesCount;
+    dispatcherHandler->handler = handler;
+    dispatcherHandler->context = context;
+
+    return AUDIT_DISPATCHER_OK;
+}
+
+void AuditDispatcher_Dispatch(AuditDispatcher* dispatcher, AuditSearch* auditSearch) {
+    for (uint32_t i = 0; i < dispatcher->handlersCount; i++) {
+        if (AuditDispatcher_IsMatch(auditSearch->audit, &dispatcher->handlers[i])) {
+            dispatcher->handlers[i].handler(auditSearch, dispatcher->handlers[i].context);
+        }
+    }
+}
+
+AuditDispatcherResultValues AuditDispatcher_Scan(AuditDispatcher* dispatcher) {
+    AuditDispatcherResultValues result = AUDIT_DISPATCHER_OK;
+    AuditSearchFilter filters[AUDIT_DISPATCHER_MAX_HANDLERS];
+    AuditSearch auditSearch;
+
+    if (dispatcher->handlersCount == 0) {
+        return AUDIT_DISPATCHER_OK;
+    }
+
+    for (uint32_t i = 0; i < dispatcher->handlersCount; i++) {
+        filters[i].searchCriteria = dispatcher->handlers[i].searchCriteria;
+        filters[i].messageTypes = dispatcher->handlers[i].messageTypes;
+        filters[i].messageTypesCount = dispatcher->handlers[i].messageTypesCount;
+    }
+
+    if (AuditSearch_InitMultipleFilters(&auditSearch, filters, dispatcher->handlersCount, dispatcher->checkpointFile) != AUDIT_SEARCH_OK) {
+        return AUDIT_DISPATCHER_EXCEPTION;
+    }
+
+    AuditSearchResultValues hasNextResult = AuditSearch_GetNext(&auditSearch);
+    while (hasNextResult == AUDIT_SEARCH_HAS_MORE_DATA) {
+        AuditDispatcher_Dispatch(dispatcher, &auditSearch);
+        hasNextResult = AuditSearch_GetNext(&auditSearch);
+    }
+
+    if (hasNextResult != AUDIT_SEARCH_NO_MORE_DATA) {
+        Logger_Information("Setting up checkpoint even though the audit search did not finish successfuly.");
+        result = AUDIT_DISPATCHER_EXCEPTION;
+    }
+
+    if (AuditSearch_SetCheckpoint(&auditSearch) != AUDIT_SEARCH_OK) {
+        result = AUDIT_DISPATCHER_EXCEPTION;
+    }
+    AuditSearch_Deinit(&auditSearch);
+
+    return result;
+}
+
+AuditDispatcherResultValues AuditDispatcher_MoveCheckpoint(AuditDispatcher* dispatcher, time_t checkpointTime) {
+    if (dispatcher->checkpointFile == NULL) {
+        return AUDIT_DISPATCHER_OK;
+    }
+
+    if (AuditSearch_WriteCheckpoint(dispatcher->checkpointFile, checkpointTime) != AUDIT_SEARCH_OK) {
+        return AUDIT_DISPATCHER_EXCEPTION;
+    }
+
+    return AUDIT_DISPATCHER_OK;
+}
+
+static bool AuditDispatcher_IsMatch(auparse_state_t* audit, const AuditDispatcherHandler* handler) {
+    if (handler->searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
+        // compare syscalls only by name, to avoid syscall number arch differences
+        if (auparse_first_record(audit) != 1 || auparse_find_field(audit, AUDIT_DISPATCHER_SYSCALL_FIELD) == NULL) {
+            return false;
+        }
+
+        const char* syscall = auparse_interpret_field(audit);
+        return syscall != NULL && AuditDispatcher_IsMessageType(handler, syscall);
+    }
+
+    for (int result = auparse_first_record(audit); result == 1; result = auparse_next_record(audit)) {
+        const char* type = auparse_get_type_name(audit);
+        if (type != NULL && AuditDispatcher_IsMessageType(handler, type)) {
+            return strcmp(type, AUDIT_DISPATCHER_USER_AUTH_NAME) != 0 || !AuditDispatcher_IsSudo(audit);
+        }
+    }
+
+    return false;
+}
+
+static bool AuditDispatcher_IsMessageType(const AuditDispatcherHandler* handler, const char* type) {
+    for (uint32_t i = 0; i < handler->messageTypesCount; i++) {
+        if (strcmp(handler->messageTypes[i], type) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool AuditDispatcher_IsSudo(auparse_state_t* audit) {
+    if (auparse_find_field(audit, AUDIT_DISPATCHER_EXECUTABLE_FIELD) == NULL) {
+        return false;
+    }
+
+    const char* executable = auparse_interpret_field(audit);
+    if (executable == NULL) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < sizeof(AUDIT_DISPATCHER_SUDO_EXECUTABLES) / sizeof(AUDIT_DISPATCHER_SUDO_EXECUTABLES[0]); i++) {
+        if (strcmp(executable, AUDIT_DISPATCHER_SUDO_EXECUTABLES[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,384 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "os_utils/linux/audit/audit_feed.h"
+
+#include <errno.h>
+#include <libaudit.h>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "internal/time_utils.h"
+#include "logger.h"
+#include "os_utils/process_info_handler.h"
+
+#ifndef AUDIT_NLGRP_READLOG
+#define AUDIT_NLGRP_READLOG 1
+#endif
+
+#define AUDIT_FEED_MAX_TYPE_NAME_LENGTH 32
+
+// the feed thread wakes up at least this often to check whether it should stop and to advance the feed time
+static const int AUDIT_FEED_POLL_TIMEOUT_IN_MILLISECONDS = 1000;
+
+/**
+ * @brief Connects to the socket of an audispd plugin.
+ *
+ * @param   feed            The feed instance.
+ * @param   socketPath      The path of the socket.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+static AuditFeedResultValues AuditFeed_ConnectToSocket(AuditFeed* feed, const char* socketPath);
+
+/**
+ * @brief Joins the audit netlink multicast group, which requires CAP_AUDIT_READ.
+ *
+ * @param   feed    The feed instance.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+static AuditFeedResultValues AuditFeed_JoinNetlinkGroup(AuditFeed* feed);
+
+/**
+ * @brief The main function of the feed thread, reads the source until the feed is stopped or the source is closed.
+ *
+ * @param   params  The feed.
+ *
+ * @return always 0.
+ */
+static int AuditFeed_ThreadMainFunc(void* params);
+
+/**
+ * @brief Reads the pending data of the source and feeds it to auparse.
+ *
+ * @param   feed    The feed instance.
+ *
+ * @return AUDIT_FEED_OK on success, AUDIT_FEED_EXCEPTION once the source is closed or fails.
+ */
+static AuditFeedResultValues AuditFeed_ReadSource(AuditFeed* feed);
+
+/**
+ * @brief Converts the pending netlink messages to audit records in the string format and feeds them to auparse.
+ *
+ * @param   feed    The feed instance.
+ * @param   size    The size of the received messages.
+ *
+ * @return AUDIT_FEED_OK on success or an appropriate error.
+ */
+static AuditFeedResultValues AuditFeed_FeedNetlinkMessages(AuditFeed* feed, uint32_t size);
+
+/**
+ * @brief The auparse callback, hands a complete event to the dispatcher.
+ *
+ * @param   audit       The auparse instance, positioned on the event.
+ * @param   eventType   The type of the callback.
+ * @param   userData    The feed.
+ */
+static void AuditFeed_OnEvent(auparse_state_t* audit, auparse_cb_event_t eventType, void* userData);
+
+AuditFeedResultValues AuditFeed_Init(AuditFeed* feed, const char* socketPath, AuditDispatcher* dispatcher) {
+    AuditFeedResultValues result = AUDIT_FEED_OK;
+
+    memset(feed, 0, sizeof(*feed));
+    feed->socket = -1;
+    feed->dispatcher = dispatcher;
+
+    feed->lock = Lock_Init();
+    if (feed->lock == NULL) {
+        result = AUDIT_FEED_EXCEPTION;
+        goto cleanup;
+    }
+
+    feed->audit = auparse_init(AUSOURCE_FEED, NULL);
+    if (feed->audit == NULL) {
+        Logger_Warning("Can not initiate auparse.");
+        result = AUDIT_FEED_EXCEPTION;
+        goto cleanup;
+    }
+    auparse_add_callback(feed->audit, AuditFeed_OnEvent, feed, NULL);
+
+    if (socketPath != NULL) {
+        result = AuditFeed_ConnectToSocket(feed, socketPath);
+    } else {
+        result = AuditFeed_JoinNetlinkGroup(feed);
+    }
+
+cleanup:
+    if (result != AUDIT_FEED_OK) {
+        AuditFeed_Deinit(feed);
+    }
+    return result;
+}
+
+void AuditFeed_Deinit(AuditFeed* feed) {
+    // once the feed stopped on its own the audit log search took over the checkpoint
+    bool wasRunning = AuditFeed_IsRunning(feed);
+    __atomic_store_n(&feed->continueRunning, false, __ATOMIC_SEQ_CST);
+    if (feed->threadStarted) {
+        int threadResult;
+        ThreadAPI_Join(feed->thread, &threadResult);
+        feed->threadStarted = false;
+    }
+
+    if (feed->audit != NULL) {
+        // the events which are still incomplete are handled before the feed goes away
+        if (wasRunning) {
+            AuditFeed_Lock(feed);
+            auparse_flush_feed(feed->audit);
+            __atomic_store_n(&feed->feedTime, TimeUtils_GetCurrentTime(), __ATOMIC_SEQ_CST);
+            AuditFeed_MoveCheckpoint(feed);
+            AuditFeed_Unlock(feed);
+        }
+        auparse_destroy(feed->audit);
+        feed->audit = NULL;
+    }
+
+    if (feed->socket >= 0) {
+        close(feed->socket);
+        feed->socket = -1;
+    }
+
+    if (feed->lock != NULL) {
+        Lock_Deinit(feed->lock);
+        feed->lock = NULL;
+    }
+}
+
+AuditFeedResultValues AuditFeed_Start(AuditFeed* feed) {
+    if (feed->threadStarted) {
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    feed->lastCheckpointTime = TimeUtils_GetCurrentTime();
+    feed->feedTime = feed->lastCheckpointTime;
+    __atomic_store_n(&feed->continueRunning, true, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&feed->isRunning, true, __ATOMIC_SEQ_CST);
+    if (ThreadAPI_Create(&feed->thread, AuditFeed_ThreadMainFunc, (void*)feed) != THREADAPI_OK) {
+        Logger_Error("Failed to start the audit feed thread.");
+        __atomic_store_n(&feed->isRunning, false, __ATOMIC_SEQ_CST);
+        return AUDIT_FEED_EXCEPTION;
+    }
+    feed->threadStarted = true;
+
+    return AUDIT_FEED_OK;
+}
+
+bool AuditFeed_IsRunning(AuditFeed* feed) {
+    return __atomic_load_n(&feed->isRunning, __ATOMIC_SEQ_CST);
+}
+
+void AuditFeed_Lock(AuditFeed* feed) {
+    if (Lock(feed->lock) != LOCK_OK) {
+        Logger_Error("Failed to lock the audit feed.");
+    }
+}
+
+void AuditFeed_Unlock(AuditFeed* feed) {
+    if (Unlock(feed->lock) != LOCK_OK) {
+        Logger_Error("Failed to unlock the audit feed.");
+    }
+}
+
+AuditFeedResultValues AuditFeed_Feed(AuditFeed* feed, const char* data, uint32_t size) {
+    if (auparse_feed(feed->audit, data, size) != 0) {
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    return AUDIT_FEED_OK;
+}
+
+static AuditFeedResultValues AuditFeed_ConnectToSocket(AuditFeed* feed, const char* socketPath) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        Logger_Error("The audit feed socket path is too long.");
+        return AUDIT_FEED_EXCEPTION;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    feed->socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (feed->socket < 0) {
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    ProcessInfo processInfo;
+    if (!ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        Logger_Warning("Can not set privileges to root.");
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    AuditFeedResultValues result = AUDIT_FEED_OK;
+    if (connect(feed->socket, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        Logger_Warning("Can not connect to the audit feed socket %s, errno: %d.", socketPath, errno);
+        result = AUDIT_FEED_EXCEPTION;
+    }
+
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+
+    return result;
+}
+
+static AuditFeedResultValues AuditFeed_JoinNetlinkGroup(AuditFeed* feed) {
+    struct sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1 << (AUDIT_NLGRP_READLOG - 1);
+
+    feed->isNetlink = true;
+    feed->socket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_AUDIT);
+    if (feed->socket < 0) {
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    ProcessInfo processInfo;
+    if (!ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        Logger_Warning("Can not set privileges to root.");
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    AuditFeedResultValues result = AUDIT_FEED_OK;
+    if (bind(feed->socket, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        Logger_Warning("Can not join the audit netlink multicast group, errno: %d.", errno);
+        result = AUDIT_FEED_EXCEPTION;
+    }
+
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+
+    return result;
+}
+
+static int AuditFeed_ThreadMainFunc(void* params) {
+    AuditFeed* feed = (AuditFeed*)params;
+    struct pollfd source = { .fd = feed->socket, .events = POLLIN, .revents = 0 };
+
+    while (__atomic_load_n(&feed->continueRunning, __ATOMIC_SEQ_CST)) {
+        int ready = poll(&source, 1, AUDIT_FEED_POLL_TIMEOUT_IN_MILLISECONDS);
+        if (ready < 0 && errno != EINTR) {
+            Logger_Error("Failed to poll the audit feed, errno: %d.", errno);
+            break;
+        }
+
+        if (ready > 0 && AuditFeed_ReadSource(feed) != AUDIT_FEED_OK) {
+            break;
+        }
+
+        // every event which was emitted by now was read
+        __atomic_store_n(&feed->feedTime, TimeUtils_GetCurrentTime(), __ATOMIC_SEQ_CST);
+    }
+
+    __atomic_store_n(&feed->isRunning, false, __ATOMIC_SEQ_CST);
+    return 0;
+}
+
+static AuditFeedResultValues AuditFeed_ReadSource(AuditFeed* feed) {
+    ssize_t size = recv(feed->socket, feed->buffer, sizeof(feed->buffer), 0);
+    if (size < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return AUDIT_FEED_OK;
+        }
+
+        // the kernel drops the messages which do not fit the socket buffer, the feed goes on with the next ones
+        if (feed->isNetlink && errno == ENOBUFS) {
+            Logger_Warning("The audit feed overflowed, audit events were lost.");
+            return AUDIT_FEED_OK;
+        }
+
+        Logger_Error("Failed to read the audit feed, errno: %d.", errno);
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    if (size == 0) {
+        Logger_Warning("The audit feed was closed.");
+        return AUDIT_FEED_EXCEPTION;
+    }
+
+    AuditFeed_Lock(feed);
+    AuditFeedResultValues result = feed->isNetlink ? AuditFeed_FeedNetlinkMessages(feed, (uint32_t)size) : AuditFeed_Feed(feed, feed->buffer, (uint32_t)size);
+    AuditFeed_Unlock(feed);
+
+    if (result != AUDIT_FEED_OK) {
+        Logger_Error("Failed to parse the audit feed.");
+    }
+
+    return result;
+}
+
+static AuditFeedResultValues AuditFeed_FeedNetlinkMessages(AuditFeed* feed, uint32_t size) {
+    int remaining = (int)size;
+    for (struct nlmsghdr* message = (struct nlmsghdr*)feed->buffer; NLMSG_OK(message, remaining); message = NLMSG_NEXT(message, remaining)) {
+        // the messages carry the record body only, its type is the type of the message
+        char typeName[AUDIT_FEED_MAX_TYPE_NAME_LENGTH] = "";
+        const char* type = audit_msg_type_to_name(message->nlmsg_type);
+        if (type == NULL) {
+            snprintf(typeName, sizeof(typeName), "UNKNOWN[%u]", message->nlmsg_type);
+            type = typeName;
+        }
+
+        int length = snprintf(feed->record, sizeof(feed->record), "type=%s msg=%.*s\n", type, (int)(message->nlmsg_len - NLMSG_HDRLEN), (const char*)NLMSG_DATA(message));
+        if (length < 0) {
+            return AUDIT_FEED_EXCEPTION;
+        }
+
+        if ((uint32_t)length >= sizeof(feed->record)) {
+            // a truncated record still ends the line, so the records which follow it are parsed correctly
+            length = sizeof(feed->record) - 1;
+            feed->record[length - 1] = '\n';
+        }
+
+        if (AuditFeed_Feed(feed, feed->record, (uint32_t)length) != AUDIT_FEED_OK) {
+            return AUDIT_FEED_EXCEPTION;
+        }
+    }
+
+    return AUDIT_FEED_OK;
+}
+
+static void AuditFeed_OnEvent(auparse_state_t* audit, auparse_cb_event_t eventType, void* userData) {
+    AuditFeed* feed = (AuditFeed*)userData;
+    if (eventType != AUPARSE_CB_EVENT_READY) {
+        return;
+    }
+
+    // the handlers read the event with the AuditSearch accessors
+    AuditSearch auditSearch;
+    memset(&auditSearch, 0, sizeof(auditSearch));
+    auditSearch.audit = audit;
+
+    AuditDispatcher_Dispatch(feed->dispatcher, &auditSearch);
+}
+
+void AuditFeed_MoveCheckpoint(AuditFeed* feed) {
+    time_t feedTime = __atomic_load_n(&feed->feedTime, __ATOMIC_SEQ_CST);
+    if (feedTime == feed->lastCheckpointTime) {
+        return;
+    }
+
+    // the privileges are shared with the other threads which hold them meanwhile
+    ProcessInfo processInfo;
+    if (!ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        Logger_Warning("Can not set privileges to root.");
+        return;
+    }
+
+    if (AuditDispatcher_MoveCheckpoint(feed->dispatcher, feedTime) != AUDIT_DISPATCHER_OK) {
+        Logger_Warning("Failed to move the audit checkpoint.");
+    } else {
+        feed->lastCheckpointTime = feedTime;
+    }
+
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+}
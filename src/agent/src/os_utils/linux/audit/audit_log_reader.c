@@ -0,0 +1,264 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#include "os_utils/linux/audit/audit_log_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+#define AUDIT_LOG_READER_BLOCK_SIZE 4096
+
+/**
+ * @brief Returns the path of the given rotation of the audit log.
+ *
+ * @param   logFile     The path of the active audit log.
+ * @param   rotation    The rotation number, 0 for the active log.
+ * @param   path        Out param. The path, at least AUDIT_LOG_READER_MAX_PATH long.
+ *
+ * @return true on success, false if the path is too long.
+ */
+static bool AuditLogReader_GetPath(const char* logFile, uint32_t rotation, char* path);
+
+/**
+ * @brief Opens a log file to be read from its beginning up to its current size.
+ *
+ * @param   path        The path of the log file.
+ * @param   file        Out param. The opened file.
+ * @param   inode       Out param. The inode of the file.
+ *
+ * @return AUDIT_LOG_READER_OK on success, AUDIT_LOG_READER_NOT_FOUND if the file does not exist, AUDIT_LOG_READER_EXCEPTION otherwise.
+ */
+static AuditLogReaderResultValues AuditLogReader_OpenFile(const char* path, AuditLogFile* file, uint64_t* inode);
+
+/**
+ * @brief Moves the end of the file back to its last complete line, a line which is still being written is left for the next read.
+ *
+ * @param   file    The file.
+ *
+ * @return AUDIT_LOG_READER_OK on success or an appropriate error.
+ */
+static AuditLogReaderResultValues AuditLogReader_FindLineEnd(AuditLogFile* file);
+
+/**
+ * @brief Reads the next bytes of the stream, from the current file or the ones after it.
+ *
+ * @param   cookie      The reader.
+ * @param   buffer      The buffer to read into.
+ * @param   size        The size of the buffer.
+ *
+ * @return the number of bytes read, 0 at the end of the stream or -1 on error.
+ */
+static ssize_t AuditLogReader_Read(void* cookie, char* buffer, size_t size);
+
+/**
+ * @brief Closes the log files of the stream.
+ *
+ * @param   cookie      The reader.
+ *
+ * @return 0.
+ */
+static int AuditLogReader_CloseStream(void* cookie);
+
+AuditLogReaderResultValues AuditLogReader_Open(AuditLogReader* reader, const char* logFile, const AuditLogPosition* position) {
+    AuditLogReaderResultValues result = AUDIT_LOG_READER_OK;
+    AuditLogFile files[AUDIT_LOG_READER_MAX_FILES];
+    uint32_t filesCount = 0;
+    uint64_t activeInode = 0;
+    bool found = false;
+
+    memset(reader, 0, sizeof(*reader));
+
+    // the active log first, then the rotated logs from the newest, until the log of the position
+    for (uint32_t rotation = 0; rotation < AUDIT_LOG_READER_MAX_FILES && !found; rotation++) {
+        char path[AUDIT_LOG_READER_MAX_PATH];
+        uint64_t inode = 0;
+        if (!AuditLogReader_GetPath(logFile, rotation, path)) {
+            result = AUDIT_LOG_READER_EXCEPTION;
+            goto cleanup;
+        }
+
+        result = AuditLogReader_OpenFile(path, &files[filesCount], &inode);
+        if (result == AUDIT_LOG_READER_NOT_FOUND && position->inode == 0 && rotation > 0) {
+            // no position, the oldest log was reached
+            result = AUDIT_LOG_READER_OK;
+            break;
+        } else if (result != AUDIT_LOG_READER_OK) {
+            goto cleanup;
+        }
+
+        filesCount++;
+        if (rotation == 0) {
+            activeInode = inode;
+        }
+        found = inode == position->inode;
+    }
+
+    if (position->inode == 0) {
+        // the logs beyond the max files are left unread
+        found = true;
+    }
+
+    if (!found) {
+        result = AUDIT_LOG_READER_NOT_FOUND;
+        goto cleanup;
+    }
+
+    AuditLogFile* positionFile = &files[filesCount - 1];
+    if (position->offset > positionFile->end) {
+        Logger_Debug("The audit log of the checkpoint was truncated.");
+        result = AUDIT_LOG_READER_NOT_FOUND;
+        goto cleanup;
+    }
+    positionFile->offset = position->offset;
+
+    result = AuditLogReader_FindLineEnd(&files[0]);
+    if (result != AUDIT_LOG_READER_OK) {
+        goto cleanup;
+    }
+
+    // the logs are read from the oldest to the active one
+    for (uint32_t i = 0; i < filesCount; i++) {
+        reader->files[i] = files[filesCount - 1 - i];
+    }
+    reader->filesCount = filesCount;
+    reader->end.inode = activeInode;
+    reader->end.offset = files[0].end;
+
+    cookie_io_functions_t functions = { AuditLogReader_Read, NULL, NULL, AuditLogReader_CloseStream };
+    reader->stream = fopencookie(reader, "r", functions);
+    if (reader->stream == NULL) {
+        result = AUDIT_LOG_READER_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (result != AUDIT_LOG_READER_OK) {
+        for (uint32_t i = 0; i < filesCount; i++) {
+            close(files[i].fd);
+        }
+        memset(reader, 0, sizeof(*reader));
+    }
+
+    return result;
+}
+
+void AuditLogReader_Close(AuditLogReader* reader) {
+    if (reader->stream != NULL) {
+        fclose(reader->stream);
+        reader->stream = NULL;
+    }
+}
+
+AuditLogReaderResultValues AuditLogReader_GetLogEnd(const char* logFile, AuditLogPosition* position) {
+    AuditLogFile file;
+    uint64_t inode = 0;
+
+    AuditLogReaderResultValues result = AuditLogReader_OpenFile(logFile, &file, &inode);
+    if (result != AUDIT_LOG_READER_OK) {
+        return result;
+    }
+
+    result = AuditLogReader_FindLineEnd(&file);
+    if (result == AUDIT_LOG_READER_OK) {
+        position->inode = inode;
+        position->offset = file.end;
+    }
+
+    close(file.fd);
+    return result;
+}
+
+static bool AuditLogReader_GetPath(const char* logFile, uint32_t rotation, char* path) {
+    int length = rotation == 0 ?
+        snprintf(path, AUDIT_LOG_READER_MAX_PATH, "%s", logFile) :
+        snprintf(path, AUDIT_LOG_READER_MAX_PATH, "%s.%u", logFile, rotation);
+
+    return length > 0 && length < AUDIT_LOG_READER_MAX_PATH;
+}
+
+static AuditLogReaderResultValues AuditLogReader_OpenFile(const char* path, AuditLogFile* file, uint64_t* inode) {
+    struct stat fileStat;
+
+    file->fd = open(path, O_RDONLY);
+    if (file->fd == -1) {
+        return errno == ENOENT ? AUDIT_LOG_READER_NOT_FOUND : AUDIT_LOG_READER_EXCEPTION;
+    }
+
+    if (fstat(file->fd, &fileStat) == -1) {
+        close(file->fd);
+        return AUDIT_LOG_READER_EXCEPTION;
+    }
+
+    file->offset = 0;
+    file->end = (uint64_t)fileStat.st_size;
+    *inode = (uint64_t)fileStat.st_ino;
+    return AUDIT_LOG_READER_OK;
+}
+
+static AuditLogReaderResultValues AuditLogReader_FindLineEnd(AuditLogFile* file) {
+    char block[AUDIT_LOG_READER_BLOCK_SIZE];
+    uint64_t blockEnd = file->end;
+
+    while (blockEnd > file->offset) {
+        uint64_t blockStart = blockEnd - file->offset > sizeof(block) ? blockEnd - sizeof(block) : file->offset;
+        ssize_t bytesRead = pread(file->fd, block, blockEnd - blockStart, (off_t)blockStart);
+        if (bytesRead != (ssize_t)(blockEnd - blockStart)) {
+            return AUDIT_LOG_READER_EXCEPTION;
+        }
+
+        char* lineEnd = memrchr(block, '\n', bytesRead);
+        if (lineEnd != NULL) {
+            file->end = blockStart + (lineEnd - block) + 1;
+            return AUDIT_LOG_READER_OK;
+        }
+        blockEnd = blockStart;
+    }
+
+    file->end = file->offset;
+    return AUDIT_LOG_READER_OK;
+}
+
+static ssize_t AuditLogReader_Read(void* cookie, char* buffer, size_t size) {
+    AuditLogReader* reader = (AuditLogReader*)cookie;
+
+    while (reader->currentFile < reader->filesCount) {
+        AuditLogFile* file = &reader->files[reader->currentFile];
+        uint64_t remaining = file->end - file->offset;
+        size_t count = remaining < size ? (size_t)remaining : size;
+        ssize_t bytesRead = count == 0 ? 0 : pread(file->fd, buffer, count, (off_t)file->offset);
+        if (bytesRead == -1) {
+            return -1;
+        }
+
+        // a file which was truncated since it was opened ends early
+        if (bytesRead == 0) {
+            reader->currentFile++;
+            continue;
+        }
+
+        file->offset += bytesRead;
+        return bytesRead;
+    }
+
+    return 0;
+}
+
+static int AuditLogReader_CloseStream(void* cookie) {
+    AuditLogReader* reader = (AuditLogReader*)cookie;
+
+    for (uint32_t i = 0; i < reader->filesCount; i++) {
+        close(reader->files[i].fd);
+    }
+    reader->filesCount = 0;
+    reader->currentFile = 0;
+
+    return 0;
+}
@@ -5,9 +5,12 @@
 
 #include <errno.h>
 #include <libaudit.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
+#include "cancellation.h"
 #include "internal/time_utils.h"
 #include "logger.h"
 #include "os_utils/file_utils.h"
@@ -17,6 +20,17 @@ static const char AUDIT_SEARCH_CRITERIA_TYPE_NAME[] = "type";
 static const char AUDIT_SEARCH_CRITERIA_SYSCALL_NAME[] = "syscall";
 static const char AUDIT_USER_AUTH_NAME[] = "USER_AUTH";
 static const char AUDIT_USER_AUTH_SEARECH_RULE[] = "(type r= USER_AUTH) && (exe i!= \"/usr/bin/sudo\") && (exe i!= \"/bin/sudo\")";
+static const char AUDIT_SEARCH_DEFAULT_LOG_FILE[] = "/var/log/audit/audit.log";
+static const char AUDIT_SEARCH_AUDITD_CONFIG_FILE[] = "/etc/audit/auditd.conf";
+static const char AUDIT_SEARCH_LOG_FILE_KEY[] = "log_file";
+
+/**
+ * @brief Reads the path of the active audit log from the log_file setting of auditd, as ausearch does.
+ *        The default path of auditd is used when the setting is missing or can not be read.
+ * 
+ * @param   logFile     Out param. The path of the active audit log, AUDIT_LOG_READER_MAX_PATH long.
+ */
+static void AuditSearch_ReadLogFile(char* logFile);
 
 /**
  * @brief Converts an enum to a string.
@@ -28,14 +42,47 @@ static const char AUDIT_USER_AUTH_SEARECH_RULE[] = "(type r= USER_AUTH) && (exe
 const char* AuditSearch_ConvertCriteriaToString(AuditSearchCriteria searchCriteria);
 
 /**
- * @brief Adds a timestamp checkpoint to the search.
+ * @brief Reads the checkpoint of the search from the checkpoint file.
  * 
  * @param   auditSearch     The search instance.
  * 
- * @return AUDIT_SEARCH_OKin case the checkpoint was added or the checkpoint file does not exist, otherwise AUDIT_SEARCH_EXCEPTION is returned.
+ * @return AUDIT_SEARCH_OK in case the checkpoint was read or the checkpoint file does not exist, otherwise AUDIT_SEARCH_EXCEPTION is returned.
+ */
+static AuditSearchResultValues AuditSearch_ReadCheckpoint(AuditSearch* auditSearch);
+
+/**
+ * @brief Initiates auparse on the audit logs from the position of the checkpoint,
+ *        or on all the audit logs if there is no position or the log of the position is gone.
+ * 
+ * @param   auditSearch     The search instance.
+ * 
+ * @return AUDIT_SEARCH_OK on success or an appropriate error.
+ */
+static AuditSearchResultValues AuditSearch_InitSource(AuditSearch* auditSearch);
+
+/**
+ * @brief Adds a timestamp checkpoint to the search, if the search is bound by the time of the checkpoint.
+ * 
+ * @param   auditSearch     The search instance.
+ * 
+ * @return AUDIT_SEARCH_OKin case the checkpoint was added or is not needed, otherwise AUDIT_SEARCH_EXCEPTION is returned.
  */
 AuditSearchResultValues AuditSearch_AddCheckpointToSearch(AuditSearch* auditSearch);
 
+/**
+ * @brief Sets the checkpoint of the search to the end of the audit logs which the search reads.
+ * 
+ * @param   auditSearch     The search instance.
+ */
+static void AuditSearch_InitNextCheckpoint(AuditSearch* auditSearch);
+
+/**
+ * @brief Moves the checkpoint of a cancelled search to the current event, so the events which were not visited are searched again.
+ * 
+ * @param   auditSearch     The search instance.
+ */
+static void AuditSearch_MoveCheckpointToCurrentEvent(AuditSearch* auditSearch);
+
 AuditSearchResultValues AuditSearch_Init(AuditSearch* auditSearch, AuditSearchCriteria searchCriteria, const char* messageType, const char* checkpointFile) {
     const char* oneMessageTypeType[1];
     oneMessageTypeType[0] = messageType;
@@ -43,6 +90,11 @@ AuditSearchResultValues AuditSearch_Init(AuditSearch* auditSearch, AuditSearchCr
 }
 
 AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* auditSearch, AuditSearchCriteria searchCriteria, const char** messageTypes, uint32_t messageTypesCount, const char* checkpointFile) {
+    AuditSearchFilter filter = { searchCriteria, messageTypes, messageTypesCount };
+    return AuditSearch_InitMultipleFilters(auditSearch, &filter, 1, checkpointFile);
+}
+
+AuditSearchResultValues AuditSearch_InitMultipleFilters(AuditSearch* auditSearch, const AuditSearchFilter* filters, uint32_t filtersCount, const char* checkpointFile) {
     
     memset(auditSearch, 0, sizeof(*auditSearch));
     auditSearch->firstSearch = true;
@@ -54,9 +106,21 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
         goto cleanup;
     }
 
-    auditSearch->audit = auparse_init(AUSOURCE_LOGS, NULL);
-    if (auditSearch->audit == NULL) {
-        Logger_Warning("Can not initiate auparse.");
+    AuditSearch_ReadLogFile(auditSearch->logFile);
+
+    if (checkpointFile != NULL) {
+        if (!(Utils_CreateStringCopy(&auditSearch->checkpointFile, checkpointFile))) {
+            result = AUDIT_SEARCH_EXCEPTION;
+            goto cleanup;
+        }
+
+        if (AuditSearch_ReadCheckpoint(auditSearch) != AUDIT_SEARCH_OK) {
+            result = AUDIT_SEARCH_EXCEPTION;
+            goto cleanup;
+        }
+    }
+
+    if (AuditSearch_InitSource(auditSearch) != AUDIT_SEARCH_OK) {
         result = AUDIT_SEARCH_EXCEPTION;
         goto cleanup;
     }
@@ -69,46 +133,42 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
      * the sub expressions (by the order of addition) and then the final op.
      * So basically we will get ((type1 || type2) || type3) && timestamp
      */
-    for (uint32_t i = 0; i < messageTypesCount; ++i) {
-        ausearch_rule_t currentRule = AUSEARCH_RULE_OR;
-        if (i == 0) {
-            currentRule = AUSEARCH_RULE_CLEAR;
-        }
-       /*
-        * We want to monitor only local login operations but auditd "USER_AUTH" type includes sudo commands too.
-        * The following expression makes sure to include only login operations and ignore sudo commands.
-        */
-        if (searchCriteria == AUDIT_SEARCH_CRITERIA_TYPE && strcmp(messageTypes[i], AUDIT_USER_AUTH_NAME) == 0) {
-            char *error = NULL;
-            const char *expression = AUDIT_USER_AUTH_SEARECH_RULE;
-            if (ausearch_add_expression(auditSearch->audit, expression, &error, currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
-            }
-        } else if (searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
-            // Compare syscalls only by name, to avoid syscall number arch differences 
-            if (ausearch_add_interpreted_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
-            }
-        } else {
-            if (ausearch_add_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
-                result = AUDIT_SEARCH_EXCEPTION;
-                goto cleanup;
+    // the filters are or'ed as well, an event which matches any of them is found once
+    ausearch_rule_t currentRule = AUSEARCH_RULE_CLEAR;
+    for (uint32_t j = 0; j < filtersCount; ++j) {
+        AuditSearchCriteria searchCriteria = filters[j].searchCriteria;
+        const char** messageTypes = filters[j].messageTypes;
+        for (uint32_t i = 0; i < filters[j].messageTypesCount; ++i) {
+           /*
+            * We want to monitor only local login operations but auditd "USER_AUTH" type includes sudo commands too.
+            * The following expression makes sure to include only login operations and ignore sudo commands.
+            */
+            if (searchCriteria == AUDIT_SEARCH_CRITERIA_TYPE && strcmp(messageTypes[i], AUDIT_USER_AUTH_NAME) == 0) {
+                char *error = NULL;
+                const char *expression = AUDIT_USER_AUTH_SEARECH_RULE;
+                if (ausearch_add_expression(auditSearch->audit, expression, &error, currentRule) == -1) {
+                    result = AUDIT_SEARCH_EXCEPTION;
+                    goto cleanup;
+                }
+            } else if (searchCriteria == AUDIT_SEARCH_CRITERIA_SYSCALL) {
+                // Compare syscalls only by name, to avoid syscall number arch differences 
+                if (ausearch_add_interpreted_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
+                    result = AUDIT_SEARCH_EXCEPTION;
+                    goto cleanup;
+                }
+            } else {
+                if (ausearch_add_item(auditSearch->audit, AuditSearch_ConvertCriteriaToString(searchCriteria), "=", messageTypes[i], currentRule) == -1) {
+                    result = AUDIT_SEARCH_EXCEPTION;
+                    goto cleanup;
+                }
             }
+            currentRule = AUSEARCH_RULE_OR;
         }
     }
     
-    if (checkpointFile != NULL){
-        if (!(Utils_CreateStringCopy(&auditSearch->checkpointFile, checkpointFile))) {
-            result = AUDIT_SEARCH_EXCEPTION;
-            goto cleanup;
-        }
-
-        if (AuditSearch_AddCheckpointToSearch(auditSearch) != AUDIT_SEARCH_OK) {
-            result = AUDIT_SEARCH_EXCEPTION;
-            goto cleanup;
-        }
+    if (checkpointFile != NULL && AuditSearch_AddCheckpointToSearch(auditSearch) != AUDIT_SEARCH_OK) {
+        result = AUDIT_SEARCH_EXCEPTION;
+        goto cleanup;
     }
 
     if (ausearch_set_stop(auditSearch->audit, AUSEARCH_STOP_EVENT) == -1) {
@@ -117,6 +177,9 @@ AuditSearchResultValues AuditSearch_InitMultipleSearchCriteria(AuditSearch* audi
     }
   
     auditSearch->searchTime = TimeUtils_GetCurrentTime();
+    if (checkpointFile != NULL) {
+        AuditSearch_InitNextCheckpoint(auditSearch);
+    }
 
 cleanup:
     if (result != AUDIT_SEARCH_OK) {
@@ -136,27 +199,122 @@ void AuditSearch_Deinit(AuditSearch* auditSearch) {
         auditSearch->audit = NULL;
     }
 
+    if (auditSearch->logReader.stream != NULL) {
+        AuditLogReader_Close(&auditSearch->logReader);
+    }
+
     if (!ProcessInfoHandler_Reset(&auditSearch->processInfo)) {
         Logger_Warning("Can not set privileges back to user.");
     }
 }
 
+static void AuditSearch_ReadLogFile(char* logFile) {
+    strcpy(logFile, AUDIT_SEARCH_DEFAULT_LOG_FILE);
+
+    FILE* config = fopen(AUDIT_SEARCH_AUDITD_CONFIG_FILE, "r");
+    if (config == NULL) {
+        return;
+    }
+
+    char line[AUDIT_LOG_READER_MAX_PATH + 64];
+    while (fgets(line, sizeof(line), config) != NULL) {
+        char* key = line + strspn(line, " \t");
+        size_t keyLength = strlen(AUDIT_SEARCH_LOG_FILE_KEY);
+        if (strncmp(key, AUDIT_SEARCH_LOG_FILE_KEY, keyLength) != 0) {
+            continue;
+        }
+
+        char* value = key + keyLength;
+        value += strspn(value, " \t");
+        if (*value != '=') {
+            continue;
+        }
+        value++;
+        value += strspn(value, " \t");
+        size_t valueLength = strcspn(value, " \t\r\n");
+        if (valueLength > 0 && valueLength < AUDIT_LOG_READER_MAX_PATH) {
+            memcpy(logFile, value, valueLength);
+            logFile[valueLength] = '\0';
+        }
+        break;
+    }
+
+    fclose(config);
+}
+
+static AuditSearchResultValues AuditSearch_ReadCheckpoint(AuditSearch* auditSearch) {
+    // checkpoints of older versions hold only the time, they are read as a checkpoint without a position
+    FileResults result = FileUtils_ReadFile(auditSearch->checkpointFile, &auditSearch->checkpoint, sizeof(auditSearch->checkpoint), true);
+    if (result != FILE_UTILS_OK) {
+        memset(&auditSearch->checkpoint, 0, sizeof(auditSearch->checkpoint));
+    }
+
+    return result == FILE_UTILS_ERROR ? AUDIT_SEARCH_EXCEPTION : AUDIT_SEARCH_OK;
+}
+
+static AuditSearchResultValues AuditSearch_InitSource(AuditSearch* auditSearch) {
+    if (auditSearch->checkpoint.position.inode != 0) {
+        if (AuditLogReader_Open(&auditSearch->logReader, auditSearch->logFile, &auditSearch->checkpoint.position) == AUDIT_LOG_READER_OK) {
+            auditSearch->audit = auparse_init(AUSOURCE_FILE_POINTER, auditSearch->logReader.stream);
+        } else {
+            Logger_Debug("The audit log of the checkpoint is gone, searching the audit logs by the checkpoint time.");
+            memset(&auditSearch->checkpoint.position, 0, sizeof(auditSearch->checkpoint.position));
+        }
+    }
+
+    if (auditSearch->checkpoint.position.inode == 0) {
+        // the logs are read from the oldest one up to where the reader ends, so the next search starts right after the last event read
+        AuditLogPosition noPosition = { 0, 0 };
+        if (AuditLogReader_Open(&auditSearch->logReader, auditSearch->logFile, &noPosition) == AUDIT_LOG_READER_OK) {
+            auditSearch->audit = auparse_init(AUSOURCE_FILE_POINTER, auditSearch->logReader.stream);
+        } else {
+            auditSearch->audit = auparse_init(AUSOURCE_LOGS, NULL);
+        }
+    }
+
+    if (auditSearch->audit == NULL) {
+        Logger_Warning("Can not initiate auparse.");
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    return AUDIT_SEARCH_OK;
+}
+
 AuditSearchResultValues AuditSearch_AddCheckpointToSearch(AuditSearch* auditSearch) {
-    time_t timeval;
-    FileResults result = FileUtils_ReadFile(auditSearch->checkpointFile, &timeval, sizeof(timeval), false);
-    if (result == FILE_UTILS_OK) {
-        if (ausearch_add_timestamp_item(auditSearch->audit, ">", timeval, 0, AUSEARCH_RULE_AND) == -1) {
-            return AUDIT_SEARCH_EXCEPTION;
-        } 
-    } else if (result == FILE_UTILS_ERROR ) {
+    const AuditSearchCheckpoint* checkpoint = &auditSearch->checkpoint;
+    // a search which resumes from the position needs the time only to skip what a cancelled search reported
+    if (checkpoint->time == 0 || (checkpoint->position.inode != 0 && !checkpoint->isTimeBound)) {
+        return AUDIT_SEARCH_OK;
+    }
+
+    if (ausearch_add_timestamp_item(auditSearch->audit, ">", checkpoint->time, 0, AUSEARCH_RULE_AND) == -1) {
         return AUDIT_SEARCH_EXCEPTION;
     }
+
     return AUDIT_SEARCH_OK;
 }
 
+static void AuditSearch_InitNextCheckpoint(AuditSearch* auditSearch) {
+    auditSearch->startPosition = auditSearch->checkpoint.position;
+    auditSearch->checkpoint.time = auditSearch->searchTime;
+    auditSearch->checkpoint.isTimeBound = false;
+
+    if (auditSearch->logReader.stream != NULL) {
+        auditSearch->checkpoint.position = auditSearch->logReader.end;
+    } else {
+        // auparse reads the logs past any end taken now, the next search goes by the time
+        memset(&auditSearch->checkpoint.position, 0, sizeof(auditSearch->checkpoint.position));
+    }
+}
+
 AuditSearchResultValues AuditSearch_GetNext(AuditSearch* auditSearch) {
     int result = 0;
 
+    if (Cancellation_IsRequested()) {
+        AuditSearch_MoveCheckpointToCurrentEvent(auditSearch);
+        return AUDIT_SEARCH_CANCELLED;
+    }
+
     if (!auditSearch->firstSearch) {
         result = auparse_next_event(auditSearch->audit);
         if (result == -1) {
@@ -169,6 +327,8 @@ AuditSearchResultValues AuditSearch_GetNext(AuditSearch* auditSearch) {
     }
 
     auditSearch->firstSearch = false;
+    // the index belongs to the previous event
+    auditSearch->index.isBuilt = false;
     result = ausearch_next_event(auditSearch->audit);
     if (result == -1) {
         return AUDIT_SEARCH_EXCEPTION;
@@ -181,14 +341,110 @@ AuditSearchResultValues AuditSearch_GetNext(AuditSearch* auditSearch) {
     return AUDIT_SEARCH_HAS_MORE_DATA;
 }
 
+static void AuditSearch_MoveCheckpointToCurrentEvent(AuditSearch* auditSearch) {
+    if (auditSearch->firstSearch) {
+        auditSearch->keepCheckpoint = true;
+        return;
+    }
+
+    const au_event_t* eventTime = auparse_get_timestamp(auditSearch->audit);
+    if (eventTime == NULL) {
+        auditSearch->keepCheckpoint = true;
+        return;
+    }
+
+    // the checkpoint excludes its own second, the rest of the events of the current second are reported again rather than lost
+    auditSearch->searchTime = eventTime->sec - 1;
+    // the next search reads the logs again from where this one started, skipping what it reported by the time
+    auditSearch->checkpoint.time = auditSearch->searchTime;
+    auditSearch->checkpoint.position = auditSearch->startPosition;
+    auditSearch->checkpoint.isTimeBound = true;
+}
+
 AuditSearchResultValues AuditSearch_SetCheckpoint(AuditSearch* auditSearch) {
-    if (FileUtils_WriteToFile(auditSearch->checkpointFile, &auditSearch->searchTime, sizeof(auditSearch->searchTime)) != FILE_UTILS_OK) {
+    if (auditSearch->keepCheckpoint) {
+        return AUDIT_SEARCH_OK;
+    }
+
+    if (FileUtils_WriteToFile(auditSearch->checkpointFile, &auditSearch->checkpoint, sizeof(auditSearch->checkpoint)) != FILE_UTILS_OK) {
+        return AUDIT_SEARCH_EXCEPTION; 
+    }
+
+    return AUDIT_SEARCH_OK;
+}
+
+AuditSearchResultValues AuditSearch_WriteCheckpoint(const char* checkpointFile, time_t checkpointTime) {
+    AuditSearchCheckpoint checkpoint;
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    // the end of the logs by now may already hold events after the given time, so the next search goes by the time,
+    // which excludes its own second, the rest of the events of that second are reported again rather than lost
+    checkpoint.time = checkpointTime - 1;
+
+    if (FileUtils_WriteToFile(checkpointFile, &checkpoint, sizeof(checkpoint)) != FILE_UTILS_OK) {
         return AUDIT_SEARCH_EXCEPTION; 
     }
 
     return AUDIT_SEARCH_OK;
 }
 
+AuditSearchResultValues AuditSearch_MergeCheckpoints(const char* checkpointFile, const char** legacyCheckpointFiles, uint32_t legacyCheckpointFilesCount) {
+    AuditSearchResultValues result = AUDIT_SEARCH_OK;
+    AuditSearchCheckpoint checkpoint;
+    AuditSearchCheckpoint newestCheckpoint;
+    bool isLegacyCheckpointFound = false;
+    memset(&newestCheckpoint, 0, sizeof(newestCheckpoint));
+
+    ProcessInfo processInfo;
+    if (!ProcessInfoHandler_ChangeToRoot(&processInfo)) {
+        Logger_Warning("Can not set privileges to root.");
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    FileResults fileResult = FileUtils_ReadFile(checkpointFile, &checkpoint, sizeof(checkpoint), true);
+    if (fileResult != FILE_UTILS_OK && fileResult != FILE_UTILS_FILE_NOT_FOUND) {
+        result = AUDIT_SEARCH_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (fileResult == FILE_UTILS_FILE_NOT_FOUND) {
+        for (uint32_t i = 0; i < legacyCheckpointFilesCount; i++) {
+            // checkpoints of older versions may hold only the time, they are read as a checkpoint without a position
+            memset(&checkpoint, 0, sizeof(checkpoint));
+            if (FileUtils_ReadFile(legacyCheckpointFiles[i], &checkpoint, sizeof(checkpoint), true) != FILE_UTILS_OK) {
+                continue;
+            }
+
+            if (!isLegacyCheckpointFound || checkpoint.time > newestCheckpoint.time) {
+                newestCheckpoint = checkpoint;
+                isLegacyCheckpointFound = true;
+            }
+        }
+
+        if (!isLegacyCheckpointFound) {
+            goto cleanup;
+        }
+
+        if (FileUtils_WriteToFile(checkpointFile, &newestCheckpoint, sizeof(newestCheckpoint)) != FILE_UTILS_OK) {
+            result = AUDIT_SEARCH_EXCEPTION;
+            goto cleanup;
+        }
+        Logger_Information("The audit checkpoint was seeded from the checkpoints of an older version.");
+    }
+
+    for (uint32_t i = 0; i < legacyCheckpointFilesCount; i++) {
+        if (unlink(legacyCheckpointFiles[i]) != 0 && errno != ENOENT) {
+            Logger_Warning("Can not remove the audit checkpoint %s, errno: %d.", legacyCheckpointFiles[i], errno);
+        }
+    }
+
+cleanup:
+    if (!ProcessInfoHandler_Reset(&processInfo)) {
+        Logger_Warning("Can not set privileges back to user.");
+    }
+
+    return result;
+}
+
 AuditSearchResultValues AuditSearch_GetEventTime(AuditSearch* auditSearch, uint32_t* timeInSeconds) {
     const au_event_t* eventTime = auparse_get_timestamp(auditSearch->audit);
     if (eventTime == NULL) {
@@ -200,33 +456,27 @@ AuditSearchResultValues AuditSearch_GetEventTime(AuditSearch* auditSearch, uint3
 }
 
 AuditSearchResultValues AuditSearch_ReadInt(AuditSearch* auditSearch, const char* fieldName, int* output) {
-    int result = auparse_first_record(auditSearch->audit);
-    if (result == -1) {
-        return AUDIT_SEARCH_EXCEPTION;
-    } else if (result == 0) {
-        return AUDIT_SEARCH_NO_DATA;
+    AuditSearchResultValues result = AuditSearchUtils_GotoRecord(auditSearch, 0);
+    if (result != AUDIT_SEARCH_OK) {
+        return result;
     }
 
     return AuditSearchUtils_ReadInt(auditSearch, fieldName, output);
 }
 
 AuditSearchResultValues AuditSearch_ReadString(AuditSearch* auditSearch, const char* fieldName, const char** output) {
-    int result = auparse_first_record(auditSearch->audit);
-    if (result == -1) {
-        return AUDIT_SEARCH_EXCEPTION;
-    } else if (result == 0) {
-        return AUDIT_SEARCH_NO_DATA;
+    AuditSearchResultValues result = AuditSearchUtils_GotoRecord(auditSearch, 0);
+    if (result != AUDIT_SEARCH_OK) {
+        return result;
     }
 
     return AuditSearchUtils_ReadString(auditSearch, fieldName, output);
 }
 
 AuditSearchResultValues AuditSearch_InterpretString(AuditSearch* auditSearch, const char* fieldName, const char** output) {
-    int result = auparse_first_record(auditSearch->audit);
-    if (result == -1) {
-        return AUDIT_SEARCH_EXCEPTION;
-    } else if (result == 0) {
-        return AUDIT_SEARCH_NO_DATA;
+    AuditSearchResultValues result = AuditSearchUtils_GotoRecord(auditSearch, 0);
+    if (result != AUDIT_SEARCH_OK) {
+        return result;
     }
     return AuditSearchUtils_InterpretString(auditSearch, fieldName, output);
 }
@@ -6,29 +6,13 @@
 #include <stdbool.h>
 
 AuditSearchResultValues AuditSearchRecord_Goto(AuditSearch* auditSearch, int wantedType) {
-    uint32_t numOfRecords = auparse_get_num_records(auditSearch->audit);
-    if (numOfRecords == 0) {
-        return AUDIT_SEARCH_EXCEPTION;
-    }
-
-    uint32_t index = 0;
-    bool found = false;
-    while (!found && index < numOfRecords) {
-        if (auparse_goto_record_num(auditSearch->audit, index) == 0) {
-            return AUDIT_SEARCH_EXCEPTION;
-        }
-
-        int currentType = auparse_get_type(auditSearch->audit);
-        if (currentType == 0) {
-            return AUDIT_SEARCH_EXCEPTION;
-        }
-        if (currentType == wantedType) {
-            return AUDIT_SEARCH_OK;
-        }
-        ++index;
+    uint32_t recordNumber = 0;
+    AuditSearchResultValues result = AuditSearchUtils_FindRecord(auditSearch, wantedType, &recordNumber);
+    if (result != AUDIT_SEARCH_OK) {
+        return result;
     }
 
-    return AUDIT_SEARCH_RECORD_DOES_NOT_EXIST;
+    return AuditSearchUtils_GotoRecord(auditSearch, recordNumber) == AUDIT_SEARCH_OK ? AUDIT_SEARCH_OK : AUDIT_SEARCH_EXCEPTION;
 }
 
 AuditSearchResultValues AuditSearchRecord_MaxRecordLength(AuditSearch* auditSearch, uint32_t* length) {
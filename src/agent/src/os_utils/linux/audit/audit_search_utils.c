@@ -4,6 +4,38 @@
 #include "os_utils/linux/audit/audit_search_utils.h"
 
 #include <errno.h>
+#include <string.h>
+
+#define AUDIT_SEARCH_INDEX_NONE -1
+
+/**
+ * @brief Builds the index of the current event, unless it was built already.
+ * 
+ * @param   auditSearch     The search instance.
+ * 
+ * @return AUDIT_SEARCH_OK on success, AUDIT_SEARCH_EXCEPTION otherwise.
+ */
+static AuditSearchResultValues AuditSearchUtils_BuildIndex(AuditSearch* auditSearch);
+
+/**
+ * @brief Adds the fields of the current record to the index, the index is marked incomplete once it is full.
+ * 
+ * @param   auditSearch     The search instance.
+ * @param   recordNumber    The number of the current record.
+ * 
+ * @return AUDIT_SEARCH_OK on success, AUDIT_SEARCH_EXCEPTION otherwise.
+ */
+static AuditSearchResultValues AuditSearchUtils_IndexRecord(AuditSearch* auditSearch, uint32_t recordNumber);
+
+/**
+ * @brief Returns the bucket of the given field name, an empty bucket if the name is not in the index.
+ * 
+ * @param   index       The index.
+ * @param   fieldName   The name of the field.
+ * 
+ * @return the bucket of the name.
+ */
+static AuditSearchIndexBucket* AuditSearchUtils_GetBucket(AuditSearchIndex* index, const char* fieldName);
 
 /**
  * @brief Search the given field in the current search record.
@@ -57,7 +89,85 @@ AuditSearchResultValues AuditSearchUtils_InterpretString(AuditSearch* auditSearc
     return AUDIT_SEARCH_OK;
 }
 
+AuditSearchResultValues AuditSearchUtils_GotoRecord(AuditSearch* auditSearch, uint32_t recordNumber) {
+    AuditSearchIndex* index = &auditSearch->index;
+    if (AuditSearchUtils_BuildIndex(auditSearch) != AUDIT_SEARCH_OK) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    if (index->isComplete && recordNumber >= index->recordsCount) {
+        return AUDIT_SEARCH_NO_DATA;
+    }
+
+    if (auparse_goto_record_num(auditSearch->audit, recordNumber) != 1) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    index->currentRecord = recordNumber;
+    return AUDIT_SEARCH_OK;
+}
+
+AuditSearchResultValues AuditSearchUtils_FindRecord(AuditSearch* auditSearch, int recordType, uint32_t* recordNumber) {
+    AuditSearchIndex* index = &auditSearch->index;
+    if (AuditSearchUtils_BuildIndex(auditSearch) != AUDIT_SEARCH_OK) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    for (uint32_t i = 0; i < index->recordsCount; ++i) {
+        if (index->recordTypes[i] == recordType) {
+            *recordNumber = i;
+            return AUDIT_SEARCH_OK;
+        }
+    }
+
+    if (index->isComplete) {
+        return AUDIT_SEARCH_RECORD_DOES_NOT_EXIST;
+    }
+
+    // the records past the capacity of the index
+    for (uint32_t i = index->recordsCount; auparse_goto_record_num(auditSearch->audit, i) == 1; ++i) {
+        int currentType = auparse_get_type(auditSearch->audit);
+        if (currentType == 0) {
+            return AUDIT_SEARCH_EXCEPTION;
+        }
+        if (currentType == recordType) {
+            *recordNumber = i;
+            return AUDIT_SEARCH_OK;
+        }
+    }
+
+    return AUDIT_SEARCH_RECORD_DOES_NOT_EXIST;
+}
+
 AuditSearchResultValues AuditSearchUtils_FindField(AuditSearch* auditSearch, const char* fieldName) {
+    AuditSearchIndex* index = &auditSearch->index;
+    if (AuditSearchUtils_BuildIndex(auditSearch) != AUDIT_SEARCH_OK) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    // the first field with the name, from the current record onwards
+    int16_t current = AuditSearchUtils_GetBucket(index, fieldName)->first;
+    while (current != AUDIT_SEARCH_INDEX_NONE && index->fields[current].recordNumber < index->currentRecord) {
+        current = index->fields[current].next;
+    }
+
+    if (current != AUDIT_SEARCH_INDEX_NONE) {
+        if (auparse_goto_record_num(auditSearch->audit, index->fields[current].recordNumber) != 1 ||
+            auparse_goto_field_num(auditSearch->audit, index->fields[current].fieldNumber) != 1) {
+            return AUDIT_SEARCH_EXCEPTION;
+        }
+        return AUDIT_SEARCH_OK;
+    }
+
+    if (index->isComplete) {
+        return AUDIT_SEARCH_FIELD_DOES_NOT_EXIST;
+    }
+
+    // the fields past the capacity of the index
+    if (auparse_goto_record_num(auditSearch->audit, index->currentRecord) != 1) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
     errno = 0;
     if (auparse_find_field(auditSearch->audit, fieldName) == NULL) {
         if (errno != 0) {
@@ -68,3 +178,95 @@ AuditSearchResultValues AuditSearchUtils_FindField(AuditSearch* auditSearch, con
 
     return AUDIT_SEARCH_OK;
 }
+
+static AuditSearchResultValues AuditSearchUtils_BuildIndex(AuditSearch* auditSearch) {
+    AuditSearchIndex* index = &auditSearch->index;
+    if (index->isBuilt) {
+        return AUDIT_SEARCH_OK;
+    }
+
+    index->isComplete = true;
+    index->currentRecord = 0;
+    index->recordsCount = 0;
+    index->fieldsCount = 0;
+    // all the bytes set makes every bucket empty
+    memset(index->buckets, 0xff, sizeof(index->buckets));
+
+    int result = auparse_first_record(auditSearch->audit);
+    while (result == 1 && index->isComplete) {
+        if (index->recordsCount == AUDIT_SEARCH_INDEX_MAX_RECORDS) {
+            index->isComplete = false;
+            break;
+        }
+
+        int recordType = auparse_get_type(auditSearch->audit);
+        if (recordType == 0) {
+            return AUDIT_SEARCH_EXCEPTION;
+        }
+
+        uint32_t recordNumber = index->recordsCount++;
+        index->recordTypes[recordNumber] = recordType;
+        if (AuditSearchUtils_IndexRecord(auditSearch, recordNumber) != AUDIT_SEARCH_OK) {
+            return AUDIT_SEARCH_EXCEPTION;
+        }
+
+        result = auparse_next_record(auditSearch->audit);
+    }
+
+    if (result == -1) {
+        return AUDIT_SEARCH_EXCEPTION;
+    }
+
+    index->isBuilt = true;
+    return AUDIT_SEARCH_OK;
+}
+
+static AuditSearchResultValues AuditSearchUtils_IndexRecord(AuditSearch* auditSearch, uint32_t recordNumber) {
+    AuditSearchIndex* index = &auditSearch->index;
+    uint32_t fieldNumber = 0;
+
+    for (int result = auparse_first_field(auditSearch->audit); result == 1; result = auparse_next_field(auditSearch->audit)) {
+        if (index->fieldsCount == AUDIT_SEARCH_INDEX_MAX_FIELDS) {
+            index->isComplete = false;
+            return AUDIT_SEARCH_OK;
+        }
+
+        const char* fieldName = auparse_get_field_name(auditSearch->audit);
+        if (fieldName == NULL) {
+            return AUDIT_SEARCH_EXCEPTION;
+        }
+
+        int16_t current = (int16_t)index->fieldsCount++;
+        AuditSearchIndexField* field = &index->fields[current];
+        field->name = fieldName;
+        field->recordNumber = (uint16_t)recordNumber;
+        field->fieldNumber = (uint16_t)fieldNumber++;
+        field->next = AUDIT_SEARCH_INDEX_NONE;
+
+        AuditSearchIndexBucket* bucket = AuditSearchUtils_GetBucket(index, fieldName);
+        if (bucket->first == AUDIT_SEARCH_INDEX_NONE) {
+            bucket->first = current;
+        } else {
+            index->fields[bucket->last].next = current;
+        }
+        bucket->last = current;
+    }
+
+    return AUDIT_SEARCH_OK;
+}
+
+static AuditSearchIndexBucket* AuditSearchUtils_GetBucket(AuditSearchIndex* index, const char* fieldName) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char* c = fieldName; *c != '\0'; ++c) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+
+    // linear probing, the buckets outnumber the fields so an empty bucket is always found
+    uint32_t i = hash & (AUDIT_SEARCH_INDEX_BUCKETS - 1);
+    while (index->buckets[i].first != AUDIT_SEARCH_INDEX_NONE && strcmp(index->fields[index->buckets[i].first].name, fieldName) != 0) {
+        i = (i + 1) & (AUDIT_SEARCH_INDEX_BUCKETS - 1);
+    }
+
+    return &index->buckets[i];
+}
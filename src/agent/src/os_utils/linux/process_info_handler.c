@@ -3,8 +3,19 @@
 
 #include "os_utils/process_info_handler.h"
 
+#include <pthread.h>
+#include <stdint.h>
 #include <unistd.h>
 
+/*
+ * seteuid changes the effective user of the whole process, not only of the calling thread.
+ * The threads which need root privileges share them, so they are dropped only once the last holder resets.
+ */
+static pthread_mutex_t privilegesMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t privilegesHolders = 0;
+static uid_t originalEffectiveUid = 0;
+static bool isOriginalEffectiveUidSaved = false;
+
 bool ProcessInfoHandler_SwitchRealAndEffectiveUsers() {
     if (setreuid(geteuid(), getuid()) < 0) {
         return false;
@@ -13,28 +24,59 @@ bool ProcessInfoHandler_SwitchRealAndEffectiveUsers() {
 }
 
 bool ProcessInfoHandler_ChangeToRoot(ProcessInfo* processInfo) {
-    
-    processInfo->effectiveUid = geteuid();
+    bool result = true;
     processInfo->wasSet = false;
-    if (processInfo->effectiveUid == 0) {
-        return true;
-    }
-    
-    if (seteuid(0) < 0) {
-        return false;
+
+    pthread_mutex_lock(&privilegesMutex);
+
+    if (privilegesHolders == 0) {
+        // the original user is kept until the privileges were dropped successfully
+        if (!isOriginalEffectiveUidSaved) {
+            originalEffectiveUid = geteuid();
+            isOriginalEffectiveUidSaved = true;
+        }
+
+        if (originalEffectiveUid != 0 && seteuid(0) < 0) {
+            result = false;
+            goto cleanup;
+        }
     }
+
+    ++privilegesHolders;
+    processInfo->effectiveUid = originalEffectiveUid;
     processInfo->wasSet = true;
 
-    return true;
+cleanup:
+    pthread_mutex_unlock(&privilegesMutex);
+    return result;
 }
 
 bool ProcessInfoHandler_Reset(ProcessInfo* processInfo) {
+    bool result = true;
     if (!processInfo->wasSet) {
         return true;
     }
-    if (seteuid(processInfo->effectiveUid) < 0) {
-        return false;
+
+    pthread_mutex_lock(&privilegesMutex);
+    processInfo->wasSet = false;
+
+    if (privilegesHolders == 0) {
+        goto cleanup;
     }
 
-    return true;
+    --privilegesHolders;
+    if (privilegesHolders > 0) {
+        // another thread still works with root privileges
+        goto cleanup;
+    }
+
+    if (originalEffectiveUid != 0 && seteuid(originalEffectiveUid) < 0) {
+        result = false;
+        goto cleanup;
+    }
+    isOriginalEffectiveUidSaved = false;
+
+cleanup:
+    pthread_mutex_unlock(&privilegesMutex);
+    return result;
 }
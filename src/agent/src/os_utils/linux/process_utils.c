@@ -1,44 +1,167 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#define _GNU_SOURCE
+
 #include "os_utils/process_utils.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
+#include <sys/types.h>
 #include <sys/wait.h>
+#include <unistd.h>
 
+#include "cancellation.h"
 #include "logger.h"
 
+/**
+ * The longest time to wait for output before checking for cancellation again
+ */
+static const uint32_t PROCESS_UTILS_POLL_INTERVAL_IN_MILLISECONDS = 500;
+
+/**
+ * @brief Waits until the child process writes output or the work of the calling thread is cancelled.
+ *
+ * @param   fd      The read end of the output pipe.
+ *
+ * @return true once there is output to read or the pipe was closed, false if cancelled or on error.
+ */
+static bool ProcessUtils_WaitForOutput(int fd);
+
+/**
+ * @brief Reads the output of the child process until it closes its output.
+ *
+ * @param   fd           The read end of the output pipe.
+ * @param   output       A output buffer to write the output.
+ * @param   outputSize   In out param, the size of the buffer and the amount of data written to it.
+ *
+ * @return true on success, false if the output does not fit the buffer, on cancellation or on error.
+ */
+static bool ProcessUtils_ReadOutput(int fd, char* output, uint32_t* outputSize);
+
 bool ProcessUtils_Execute(const char* command, char* output, uint32_t* outputSize) {
     bool success = true;
-    FILE* commandStream = NULL;
-    commandStream = popen(command, "r");
-    if (commandStream == NULL) {
+    int pipeFds[2] = { -1, -1 };
+    pid_t pid = -1;
+
+    // commands run concurrently from several workers, a child forked by another thread must not
+    // inherit the write end, or the output would not end before that unrelated child exits
+    if (pipe2(pipeFds, O_CLOEXEC) != 0) {
         success = false;
         goto cleanup;
     }
-    
-    clearerr(commandStream);
-    uint32_t originalSize = *outputSize;
-    *outputSize = fread(output, 1, *outputSize, commandStream);
-    if (ferror(commandStream) != 0) {
-        success = false;
-        goto cleanup;
+
+    // the same shell popen runs, but with the pid at hand so an overrunning child can be killed
+    pid = fork();
+    if (pid == 0) {
+        // a process group of its own, so the commands the shell forks can be killed along with it
+        setpgid(0, 0);
+        dup2(pipeFds[1], STDOUT_FILENO);
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+        _exit(127);
     }
 
-    // there is more data to read
-    if (originalSize == *outputSize && feof(commandStream) == 0) {
+    close(pipeFds[1]);
+    pipeFds[1] = -1;
+    if (pid < 0) {
         success = false;
         goto cleanup;
     }
+    // set from the parent as well, so the group exists even if the child did not get to run yet
+    setpgid(pid, pid);
+
+    success = ProcessUtils_ReadOutput(pipeFds[0], output, outputSize);
+    if (!success && Cancellation_IsRequested()) {
+        Logger_Warning("Excution of [%s] was cancelled.", command);
+        kill(-pid, SIGKILL);
+    }
 
 cleanup:
-    if (commandStream != NULL) {
-        int closeResult = pclose(commandStream);
-        if (closeResult != 0) {
-            Logger_Error("Excution of [%s] failed with return value of %d.", command, WEXITSTATUS(closeResult));
+    if (pipeFds[0] != -1) {
+        close(pipeFds[0]);
+    }
+
+    if (pipeFds[1] != -1) {
+        close(pipeFds[1]);
+    }
+
+    if (pid > 0) {
+        int status = 0;
+        pid_t waitResult;
+        while ((waitResult = waitpid(pid, &status, 0)) == -1 && errno == EINTR);
+
+        if (waitResult != pid) {
+            Logger_Error("Failed waiting for the excution of [%s] to end.", command);
+            success = false;
+        } else if (WIFSIGNALED(status)) {
+            Logger_Error("Excution of [%s] was terminated by signal %d.", command, WTERMSIG(status));
+            success = false;
+        } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            Logger_Error("Excution of [%s] failed with return value of %d.", command, WEXITSTATUS(status));
             success = false;
         }
     }
 
     return success;
-}
\ No newline at end of file
+}
+
+static bool ProcessUtils_WaitForOutput(int fd) {
+    struct pollfd pollFd = { .fd = fd, .events = POLLIN, .revents = 0 };
+
+    while (true) {
+        uint32_t timeout = Cancellation_GetRemainingTime();
+        if (timeout == 0) {
+            return false;
+        }
+
+        if (timeout > PROCESS_UTILS_POLL_INTERVAL_IN_MILLISECONDS) {
+            timeout = PROCESS_UTILS_POLL_INTERVAL_IN_MILLISECONDS;
+        }
+
+        int result = poll(&pollFd, 1, (int)timeout);
+        if (result > 0) {
+            return true;
+        }
+
+        if (result < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+static bool ProcessUtils_ReadOutput(int fd, char* output, uint32_t* outputSize) {
+    uint32_t originalSize = *outputSize;
+    *outputSize = 0;
+
+    while (true) {
+        if (!ProcessUtils_WaitForOutput(fd)) {
+            return false;
+        }
+
+        char extraByte;
+        bool bufferFull = *outputSize == originalSize;
+        ssize_t bytesRead = bufferFull ? read(fd, &extraByte, 1) : read(fd, output + *outputSize, originalSize - *outputSize);
+        if (bytesRead == 0) {
+            return true;
+        }
+
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // there is more data to read
+        if (bufferFull) {
+            return false;
+        }
+
+        *outputSize += (uint32_t)bytesRead;
+    }
+}
@@ -10,7 +10,7 @@
 
 static uint32_t Queue_CalculateItemSize(uint32_t dataSize) {
     // each item in the list has a struct cllocate for it, a pointer to this struct and the data size for the data itself
-    return dataSize + sizeof(QueueItem) + sizeof(QueueItem*);
+    return dataSize + QUEUE_ITEM_MEMORY_OVERHEAD;
 }
 
 QueueResultValues Queue_Init(Queue* queue, bool shouldSendLogs) {
@@ -18,6 +18,7 @@ QueueResultValues Queue_Init(Queue* queue, bool shouldSendLogs) {
     queue->firstItem = NULL;
     queue->lastItem = NULL;
     queue->shouldSendLogs = shouldSendLogs;
+    queue->shouldCountDrops = true;
     if (!AgentTelemetryCounter_Init(&(queue->counter))){
         return QUEUE_MEMORY_EXCEPTION;
     }
@@ -31,13 +32,13 @@ void Queue_Deinit(Queue* queue) {
     void* currentData;
     uint32_t currentDataSize;
     while (queue->numberOfElements > 0) {
-        if (Queue_PopFront(queue, &currentData, &currentDataSize) == QUEUE_OK) {
+        if (Queue_PopFront(queue, &currentData, &currentDataSize, NULL) == QUEUE_OK) {
             free(currentData);
         }
     }
 }
 
-QueueResultValues Queue_PushBack(Queue* queue, void* data, uint32_t dataSize) {
+QueueResultValues Queue_PushBack(Queue* queue, void* data, uint32_t dataSize, uint32_t tag) {
     int result = QUEUE_OK;
     bool memoryConsumed = false;
 
@@ -48,7 +49,9 @@ QueueResultValues Queue_PushBack(Queue* queue, void* data, uint32_t dataSize) {
                 Logger_Information("Max cache size exceeded"); 
             }
             result = QUEUE_MAX_MEMORY_EXCEEDED;
-            AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+            if (queue->shouldCountDrops) {
+                AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+            }
         }
         else if (result == MEMORY_MONITOR_EXCEPTION) {
             if (queue->shouldSendLogs) { 
@@ -68,6 +71,7 @@ QueueResultValues Queue_PushBack(Queue* queue, void* data, uint32_t dataSize) {
 
     newItem->data = data;
     newItem->dataSize = dataSize;
+    newItem->tag = tag;
     newItem->nextItem = NULL;
 
     if (queue->firstItem == NULL) {
@@ -92,7 +96,7 @@ cleanup:
     return result;
 }
 
-QueueResultValues Queue_PopFront(Queue* queue, void** data, uint32_t* dataSize) {
+QueueResultValues Queue_PopFront(Queue* queue, void** data, uint32_t* dataSize, uint32_t* tag) {
     if (queue->numberOfElements == 0) {
         return QUEUE_IS_EMPTY;
     }
@@ -100,6 +104,9 @@ QueueResultValues Queue_PopFront(Queue* queue, void** data, uint32_t* dataSize)
     QueueItem* item = queue->firstItem;
     *data = item->data;
     *dataSize = item->dataSize;
+    if (tag != NULL) {
+        *tag = item->tag;
+    }
 
     if (queue->firstItem->nextItem == NULL) {
         queue->firstItem = NULL;
@@ -125,7 +132,46 @@ QueueResultValues Queue_PopFrontIf(Queue* queue, QueuePopCondition condition, vo
     if (!condition(item->data, item->dataSize, extraParams)) {
         return QUEUE_CONDITION_FAILED;
     }
-    return Queue_PopFront(queue, data, dataSize);
+    return Queue_PopFront(queue, data, dataSize, NULL);
+}
+
+QueueResultValues Queue_PopFrontBatch(Queue* queue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount) {
+    *itemsCount = 0;
+    if (queue->numberOfElements == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    uint64_t takenBytes = 0;
+    uint32_t releasedMemory = 0;
+    while (queue->numberOfElements > 0 && *itemsCount < maxItems) {
+        QueueItem* item = queue->firstItem;
+        if (takenBytes + item->dataSize + itemOverhead >= byteBudget) {
+            break;
+        }
+
+        items[*itemsCount].data = item->data;
+        items[*itemsCount].dataSize = item->dataSize;
+        ++(*itemsCount);
+        takenBytes += item->dataSize + itemOverhead;
+        releasedMemory += Queue_CalculateItemSize(item->dataSize);
+
+        queue->firstItem = item->nextItem;
+        if (queue->firstItem == NULL) {
+            queue->lastItem = NULL;
+        } else {
+            queue->firstItem->prevItem = NULL;
+        }
+        --queue->numberOfElements;
+        free(item);
+    }
+
+    if (*itemsCount == 0) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    // release the memory of the whole batch at once
+    MemoryMonitor_Release(releasedMemory);
+    return QUEUE_OK;
 }
 
 QueueResultValues Queue_GetSize(Queue* queue, uint32_t* size) {
@@ -0,0 +1,251 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "ring_buffer_queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "logger.h"
+#include "memory_monitor.h"
+
+/**
+ * @brief Returns the memory charged for an item, the same as the list backend charges.
+ *
+ * @param   dataSize    The size of the data of the item.
+ *
+ * @return the memory charged for the item.
+ */
+static uint32_t RingBufferQueue_CalculateItemSize(uint32_t dataSize) {
+    return dataSize + QUEUE_ITEM_MEMORY_OVERHEAD;
+}
+
+/**
+ * @brief Rounds the given value up to the next power of two.
+ *
+ * @param   value   The value to round.
+ *
+ * @return the smallest power of two which is greater or equal to value.
+ */
+static uint32_t RingBufferQueue_RoundUpToPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+QueueResultValues RingBufferQueue_Init(RingBufferQueue* queue, bool shouldSendLogs, uint32_t capacity) {
+    memset(queue, 0, sizeof(*queue));
+    queue->shouldSendLogs = shouldSendLogs;
+    queue->shouldCountDrops = true;
+
+    if (capacity == 0 || capacity > (UINT32_MAX >> 1) + 1) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    queue->capacity = RingBufferQueue_RoundUpToPowerOfTwo(capacity);
+    queue->mask = queue->capacity - 1;
+    queue->slots = (RingBufferQueueSlot*)malloc(queue->capacity * sizeof(RingBufferQueueSlot));
+    if (queue->slots == NULL) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    for (uint32_t i = 0; i < queue->capacity; i++) {
+        queue->slots[i].sequence = i;
+        queue->slots[i].data = NULL;
+        queue->slots[i].dataSize = 0;
+        queue->slots[i].tag = QUEUE_NO_TAG;
+    }
+
+    if (!AgentTelemetryCounter_Init(&queue->counter)) {
+        free(queue->slots);
+        queue->slots = NULL;
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    return QUEUE_OK;
+}
+
+void RingBufferQueue_Deinit(RingBufferQueue* queue) {
+    if (queue->slots == NULL) {
+        return;
+    }
+
+    AgentTelemetryCounter_Deinit(&queue->counter);
+
+    void* currentData;
+    uint32_t currentDataSize;
+    while (RingBufferQueue_PopFront(queue, &currentData, &currentDataSize, NULL) == QUEUE_OK) {
+        free(currentData);
+    }
+
+    free(queue->slots);
+    queue->slots = NULL;
+}
+
+QueueResultValues RingBufferQueue_PushBack(RingBufferQueue* queue, void* data, uint32_t dataSize, uint32_t tag) {
+    QueueResultValues result = QUEUE_OK;
+    bool memoryConsumed = false;
+
+    MemoryMonitorResultValues memoryResult = MemoryMonitor_Consume(RingBufferQueue_CalculateItemSize(dataSize));
+    if (memoryResult != MEMORY_MONITOR_OK) {
+        if (memoryResult == MEMORY_MONITOR_MEMORY_EXCEEDED) {
+            if (queue->shouldSendLogs) {
+                Logger_Information("Max cache size exceeded");
+            }
+            result = QUEUE_MAX_MEMORY_EXCEEDED;
+            if (queue->shouldCountDrops) {
+                AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+            }
+        } else {
+            if (queue->shouldSendLogs) {
+                Logger_Error("critical memory exception");
+            }
+            result = QUEUE_MEMORY_EXCEPTION;
+        }
+        goto cleanup;
+    }
+    memoryConsumed = true;
+
+    RingBufferQueueSlot* slot = NULL;
+    uint32_t position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+    while (true) {
+        slot = &queue->slots[position & queue->mask];
+        uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(sequence - position);
+
+        if (diff == 0) {
+            // the slot is free for this position, try to claim it
+            if (__atomic_compare_exchange_n(&queue->enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the consumer did not release this slot yet, the queue is full
+            if (queue->shouldSendLogs) {
+                Logger_Information("Queue capacity exceeded");
+            }
+            result = QUEUE_MAX_MEMORY_EXCEEDED;
+            if (queue->shouldCountDrops) {
+                AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.dropped, 1);
+            }
+            goto cleanup;
+        } else {
+            // another producer claimed this position, reload and retry
+            position = __atomic_load_n(&queue->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->data = data;
+    slot->dataSize = dataSize;
+    slot->tag = tag;
+    // publish the item to the consumer
+    __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&queue->count, 1, __ATOMIC_RELEASE);
+
+cleanup:
+    if (result != QUEUE_OK && memoryConsumed) {
+        MemoryMonitor_Release(RingBufferQueue_CalculateItemSize(dataSize));
+    }
+
+    AgentTelemetryCounter_IncreaseBy(&queue->counter, &queue->counter.counter.queueCounter.collected, 1);
+    return result;
+}
+
+/**
+ * @brief Pops an item from the beginning of the queue if it meets the condition. Must be called from the consumer thread only.
+ *
+ * @param   queue               The queue to pop from.
+ * @param   condition           A condition the item has to meet, NULL for none.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   data                Out param. The popped data.
+ * @param   dataSize            Out param. The size of the popped data.
+ * @param   tag                 Out param. The tag the item was pushed with, may be NULL.
+ *
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+static QueueResultValues RingBufferQueue_PopFrontItem(RingBufferQueue* queue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize, uint32_t* tag) {
+    // only the consumer moves the dequeue position, no need for a compare and swap here
+    uint32_t position = __atomic_load_n(&queue->dequeuePosition, __ATOMIC_RELAXED);
+    RingBufferQueueSlot* slot = &queue->slots[position & queue->mask];
+    uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+
+    if ((int32_t)(sequence - (position + 1)) < 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    if (condition != NULL && !condition(slot->data, slot->dataSize, conditionParams)) {
+        return QUEUE_CONDITION_FAILED;
+    }
+
+    *data = slot->data;
+    *dataSize = slot->dataSize;
+    if (tag != NULL) {
+        *tag = slot->tag;
+    }
+    slot->data = NULL;
+    slot->dataSize = 0;
+
+    __atomic_store_n(&queue->dequeuePosition, position + 1, __ATOMIC_RELAXED);
+    // hand the slot back to the producers for the next lap
+    __atomic_store_n(&slot->sequence, position + queue->capacity, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&queue->count, 1, __ATOMIC_RELEASE);
+
+    MemoryMonitor_Release(RingBufferQueue_CalculateItemSize(*dataSize));
+    return QUEUE_OK;
+}
+
+QueueResultValues RingBufferQueue_PopFrontIf(RingBufferQueue* queue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+    return RingBufferQueue_PopFrontItem(queue, condition, conditionParams, data, dataSize, NULL);
+}
+
+QueueResultValues RingBufferQueue_PopFront(RingBufferQueue* queue, void** data, uint32_t* dataSize, uint32_t* tag) {
+    return RingBufferQueue_PopFrontItem(queue, NULL, NULL, data, dataSize, tag);
+}
+
+QueueResultValues RingBufferQueue_PopFrontBatch(RingBufferQueue* queue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount) {
+    *itemsCount = 0;
+    uint64_t budgetBytes = 0;
+    uint32_t releasedMemory = 0;
+    uint32_t position = __atomic_load_n(&queue->dequeuePosition, __ATOMIC_RELAXED);
+    QueueResultValues result = QUEUE_IS_EMPTY;
+
+    while (*itemsCount < maxItems) {
+        RingBufferQueueSlot* slot = &queue->slots[position & queue->mask];
+        uint32_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if ((int32_t)(sequence - (position + 1)) < 0) {
+            break;
+        }
+
+        if (budgetBytes + slot->dataSize + itemOverhead >= byteBudget) {
+            result = QUEUE_CONDITION_FAILED;
+            break;
+        }
+
+        items[*itemsCount].data = slot->data;
+        items[*itemsCount].dataSize = slot->dataSize;
+        ++(*itemsCount);
+        budgetBytes += slot->dataSize + itemOverhead;
+        releasedMemory += RingBufferQueue_CalculateItemSize(slot->dataSize);
+        slot->data = NULL;
+        slot->dataSize = 0;
+
+        __atomic_store_n(&slot->sequence, position + queue->capacity, __ATOMIC_RELEASE);
+        ++position;
+    }
+    __atomic_store_n(&queue->dequeuePosition, position, __ATOMIC_RELAXED);
+
+    if (*itemsCount == 0) {
+        return result;
+    }
+
+    __atomic_sub_fetch(&queue->count, *itemsCount, __ATOMIC_RELEASE);
+    // release the memory of the whole batch at once
+    MemoryMonitor_Release(releasedMemory);
+    return QUEUE_OK;
+}
+
+QueueResultValues RingBufferQueue_GetSize(RingBufferQueue* queue, uint32_t* size) {
+    // positions which a producer claimed but did not publish yet are not counted
+    *size = __atomic_load_n(&queue->count, __ATOMIC_ACQUIRE);
+    return QUEUE_OK;
+}
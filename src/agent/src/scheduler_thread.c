@@ -16,20 +16,55 @@
  */
 static int SchedulerThread_MainFunc(void* params);
 
+/**
+ * @brief Blocks until the scheduler interval passes or a wakeup is requested.
+ * 
+ * @param   scheduler  The scheduler instance.
+ */
+static void SchedulerThread_WaitForWakeup(SchedulerThread* scheduler);
+
 bool SchedulerThread_Init(SchedulerThread* scheduler, uint32_t schedulerInterval, SchedulerTask task, void* taskParam) {
     scheduler->threadHandle = NULL;
     scheduler->schedulerInterval = schedulerInterval;
     scheduler->task = task;
     scheduler->taskParam = taskParam;
+    scheduler->intervalFunc = NULL;
     scheduler->continueRunning = true;
     scheduler->state = SCHEDULER_THREAD_CREATED;
+    scheduler->wakeupRequested = false;
+    scheduler->wakeupCondition = NULL;
+
+    scheduler->wakeupLock = Lock_Init();
+    if (scheduler->wakeupLock == NULL) {
+        return false;
+    }
+
+    scheduler->wakeupCondition = Condition_Init();
+    if (scheduler->wakeupCondition == NULL) {
+        Lock_Deinit(scheduler->wakeupLock);
+        scheduler->wakeupLock = NULL;
+        return false;
+    }
+
     return true;
 }
 
 void SchedulerThread_Deinit(SchedulerThread* scheduler) {
+    if (scheduler->wakeupCondition != NULL) {
+        Condition_Deinit(scheduler->wakeupCondition);
+    }
+
+    if (scheduler->wakeupLock != NULL) {
+        Lock_Deinit(scheduler->wakeupLock);
+    }
+
     memset(scheduler, 0, sizeof(*scheduler));
 }
 
+void SchedulerThread_SetIntervalFunc(SchedulerThread* scheduler, SchedulerIntervalFunc intervalFunc) {
+    scheduler->intervalFunc = intervalFunc;
+}
+
 bool SchedulerThread_Start(SchedulerThread* scheduler) {
     if (scheduler->state != SCHEDULER_THREAD_CREATED) {
         return false;
@@ -51,17 +86,63 @@ static int SchedulerThread_MainFunc(void* params) {
     SchedulerThread* scheduler = (SchedulerThread*)(params);
 
     while(scheduler->continueRunning) {
+        // wakeups requested from here on will trigger another run
+        __atomic_store_n(&scheduler->wakeupRequested, false, __ATOMIC_SEQ_CST);
         Logger_SetCorrelation();
         scheduler->task(scheduler->taskParam);
-        ThreadAPI_Sleep(scheduler->schedulerInterval);
+        SchedulerThread_WaitForWakeup(scheduler);
     }
 
     scheduler->state = SCHEDULER_THREAD_STOPPED;
     return 0;
 }
 
+static void SchedulerThread_WaitForWakeup(SchedulerThread* scheduler) {
+    uint32_t interval = scheduler->schedulerInterval;
+    if (scheduler->intervalFunc != NULL) {
+        interval = scheduler->intervalFunc(scheduler->taskParam);
+        // a zero timeout waits forever
+        if (interval == 0) {
+            return;
+        }
+        if (interval > INT32_MAX) {
+            interval = INT32_MAX;
+        }
+    }
+
+    if (Lock(scheduler->wakeupLock) != LOCK_OK) {
+        ThreadAPI_Sleep(interval);
+        return;
+    }
+
+    // the flag is checked under the lock, a wakeup cannot be posted between the check and the wait
+    if (scheduler->continueRunning && !__atomic_load_n(&scheduler->wakeupRequested, __ATOMIC_SEQ_CST)) {
+        Condition_Wait(scheduler->wakeupCondition, scheduler->wakeupLock, interval);
+    }
+
+    Unlock(scheduler->wakeupLock);
+}
+
+void SchedulerThread_Wakeup(SchedulerThread* scheduler) {
+    if (scheduler->wakeupLock == NULL) {
+        return;
+    }
+
+    if (__atomic_exchange_n(&scheduler->wakeupRequested, true, __ATOMIC_SEQ_CST)) {
+        // a wakeup is already pending
+        return;
+    }
+
+    if (Lock(scheduler->wakeupLock) != LOCK_OK) {
+        return;
+    }
+    Condition_Post(scheduler->wakeupCondition);
+    Unlock(scheduler->wakeupLock);
+}
+
 void SchedulerThread_Stop(SchedulerThread* scheduler) {
     scheduler->continueRunning = false;
+    SchedulerThread_Wakeup(scheduler);
 }
 
 SchedulerThreadState SchedulerThread_GetState(SchedulerThread* scheduler) {
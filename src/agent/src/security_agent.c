@@ -13,6 +13,9 @@
 #include "os_utils/process_info_handler.h"
 #include "twin_configuration.h"
 
+static const char HIGH_PRIORITY_SPILL_LOG_NAME[] = "highPriorityEvents";
+static const char LOW_PRIORITY_SPILL_LOG_NAME[] = "lowPriorityEvents";
+
 /**
  * @brief Deinitiate the given queue only if the initiated flag is on.
  * 
@@ -31,6 +34,43 @@ void SecurityAgent_DeinitQueue(SyncQueue* queue, bool queueInitiated);
  */
 bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs);
 
+/**
+ * @brief Initiate the given queue with a lock-free ring buffer backend and change the flag accordingly.
+ * 
+ * @param   queue               The queue to initiate.
+ * @param   queueInitiated      Out param. A falg which indicates whether the queue was initiated.
+ * @param   shouldSendLogs      Whether the queue should send out logs.
+ * 
+ * @return true upon successful queue initialization, false otherwise.
+ */
+bool SecurityAgent_InitRingBufferQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs);
+
+/**
+ * @brief Spills the events which exceed the cache of the given queue to disk, if a spill directory is configured.
+ *        A failure to create the spill log is not fatal, the queue keeps dropping the exceeding events.
+ * 
+ * @param   queue   The queue.
+ * @param   name    The name of the spill log of the queue.
+ */
+void SecurityAgent_InitQueueSpill(SyncQueue* queue, const char* name);
+
+/**
+ * @brief Counts a low priority event which was evicted to make room for a high priority event.
+ * 
+ * @param   context     The agent instance.
+ * @param   data        The evicted event.
+ * @param   dataSize    The size of the evicted event.
+ * @param   tag         The type of the evicted event, QUEUE_NO_TAG if it was pushed without one.
+ */
+void SecurityAgent_OnEventEvicted(void* context, const void* data, uint32_t dataSize, uint32_t tag);
+
+/**
+ * @brief Applies the cache size and the eviction policy of the twin configuration to the event queues.
+ * 
+ * @param   agent    The agent instance.
+ */
+void SecurityAgent_UpdateCachePolicy(SecurityAgent* agent);
+
 /**
  * @brief Initiate all the queues of the agent.
  * 
@@ -63,10 +103,48 @@ bool SecurityAgent_ConnectAndUpdateConfiguration(SecurityAgent* agent);
  * @param   interval        The interval for teh scheduler.
  * @param   taskFunction    The function the scheduler should run.
  * @param   taskParam       The parameters for the given task.
+ * @param   intervalFunc    Returns the time to wait between the executions of the task, NULL for the fixed interval.
  * 
  * @return ture if the thread was created and started, false otherwise.
  */
-bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam);
+bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam, SchedulerIntervalFunc intervalFunc);
+
+/**
+ * @brief Registers the queue and configuration notifications which wake the scheduler threads up.
+ * 
+ * @param   agent    The agent instance.
+ * 
+ * @return true in case of success, false otherwise.
+ */
+bool SecurityAgent_StartNotifications(SecurityAgent* agent);
+
+/**
+ * @brief Unregisters the notifications, so no thread is woken up while the agent is torn down.
+ * 
+ * @param   agent    The agent instance.
+ */
+void SecurityAgent_StopNotifications(SecurityAgent* agent);
+
+/**
+ * @brief Wakes the publisher thread up. Called when an event queue reaches the size of a full message.
+ * 
+ * @param   context    The agent instance.
+ */
+void SecurityAgent_WakeupPublisher(void* context);
+
+/**
+ * @brief Wakes the twin updater thread up. Called when a twin payload is pushed to the twin updates queue.
+ * 
+ * @param   context    The agent instance.
+ */
+void SecurityAgent_WakeupTwinUpdater(void* context);
+
+/**
+ * @brief Applies a new twin configuration to the notification watermarks and wakes the publisher up.
+ * 
+ * @param   context    The agent instance.
+ */
+void SecurityAgent_OnConfigurationChanged(void* context);
 
 bool SecurityAgent_Init(SecurityAgent* agent) {
     bool success = true;
@@ -123,7 +201,7 @@ bool SecurityAgent_Init(SecurityAgent* agent) {
     agent->diagnosticEventCollectorInitiated = true;
     Logger_SetCorrelation();
 
-    if (AgentTelemetryProvider_Init(&agent->queues.lowPriorityEventQueue.queue.counter, &agent->queues.highPriorityEventQueue.queue.counter, &agent->iothubAdapter.messageCounter) != TELEMETRY_PROVIDER_OK){
+    if (AgentTelemetryProvider_Init(SyncQueue_GetCounter(&agent->queues.lowPriorityEventQueue), SyncQueue_GetCounter(&agent->queues.highPriorityEventQueue), &agent->iothubAdapter.messageCounter) != TELEMETRY_PROVIDER_OK){
         success = false;
         goto cleanup;
     }
@@ -143,6 +221,8 @@ cleanup:
 
 void SecurityAgent_Deinit(SecurityAgent* agent) {
 
+    SecurityAgent_StopNotifications(agent);
+
     SecurityAgent_StopAsyncTask(&agent->asyncPublisherTask);
     if (agent->asyncPublisherTask.taskInitiated) {
         EventPublisherTask_Deinit(&agent->publisherTask);
@@ -210,7 +290,7 @@ bool SecurityAgent_Start(SecurityAgent* agent) {
         return false;
     }
     agent->asyncPublisherTask.taskInitiated = true;
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncPublisherTask, SCHEDULER_INTERVAL, (SchedulerTask)EventPublisherTask_Execute, &agent->publisherTask)) {
+    if (!SecurityAgent_StartAsyncTask(&agent->asyncPublisherTask, SCHEDULER_INTERVAL, (SchedulerTask)EventPublisherTask_Execute, &agent->publisherTask, NULL)) {
         return false;
     }
 
@@ -218,12 +298,17 @@ bool SecurityAgent_Start(SecurityAgent* agent) {
     if (!EventMonitorTask_Init(&agent->monitorTask, &agent->queues.highPriorityEventQueue, &agent->queues.lowPriorityEventQueue, &agent->queues.operationalEventsQueue)) {
         return false;
     }
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncMonitorTask, SCHEDULER_INTERVAL, (SchedulerTask)EventMonitorTask_Execute, &agent->monitorTask)) {
+    // the monitor sleeps until the timer of its next collector expires
+    if (!SecurityAgent_StartAsyncTask(&agent->asyncMonitorTask, SCHEDULER_INTERVAL, (SchedulerTask)EventMonitorTask_Execute, &agent->monitorTask, (SchedulerIntervalFunc)EventMonitorTask_GetTimeToNextExecution)) {
         return false;
     }
 
     // start twin updater
-    if (!SecurityAgent_StartAsyncTask(&agent->asyncUpdateTwinTask, TWIN_UPDATE_SCHEDULER_INTERVAL, (SchedulerTask)UpdateTwinTask_Execute, &agent->updateTwinTask)) {
+    if (!SecurityAgent_StartAsyncTask(&agent->asyncUpdateTwinTask, TWIN_UPDATE_SCHEDULER_INTERVAL, (SchedulerTask)UpdateTwinTask_Execute, &agent->updateTwinTask, NULL)) {
+        return false;
+    }
+
+    if (!SecurityAgent_StartNotifications(agent)) {
         return false;
     }
     Logger_Information("ASC for IoT Agent initialized!");
@@ -253,6 +338,25 @@ bool SecurityAgent_InitQueue(SyncQueue* queue, bool* queueInitiated, bool should
     return true;
 }
 
+bool SecurityAgent_InitRingBufferQueue(SyncQueue* queue, bool* queueInitiated, bool shouldSendLogs) {
+    if (SyncQueue_InitRingBuffer(queue, shouldSendLogs, EVENT_QUEUE_CAPACITY) != QUEUE_OK) {
+        return false;
+    }
+    *queueInitiated = true;
+    return true;
+}
+
+void SecurityAgent_InitQueueSpill(SyncQueue* queue, const char* name) {
+    const char* spillDirectory = LocalConfiguration_GetSpillDirectory();
+    if (spillDirectory == NULL) {
+        return;
+    }
+
+    if (SyncQueue_EnableSpill(queue, spillDirectory, name, LocalConfiguration_GetMaxSpillSize()) != QUEUE_OK) {
+        Logger_Warning("Failed creating spill log %s, events exceeding the cache are dropped", name);
+    }
+}
+
 void SecurityAgent_DeinitQueue(SyncQueue* queue, bool queueInitiated) {
     if (queueInitiated) {
         SyncQueue_Deinit(queue);
@@ -260,19 +364,27 @@ void SecurityAgent_DeinitQueue(SyncQueue* queue, bool queueInitiated) {
 }
 
 bool SecurityAgent_InitAllQueues(SecurityAgent* agent) {
-    if (!SecurityAgent_InitQueue(&agent->queues.diagnosticEventQueue, &agent->queues.diagnosticEventQueueInitiated, false)) {
+    if (!SecurityAgent_InitRingBufferQueue(&agent->queues.diagnosticEventQueue, &agent->queues.diagnosticEventQueueInitiated, false)) {
+        return false;
+    }
+
+    if (!SecurityAgent_InitRingBufferQueue(&agent->queues.operationalEventsQueue, &agent->queues.operationalEventsQueueInitiated, true)) {
         return false;
     }
 
-    if (!SecurityAgent_InitQueue(&agent->queues.operationalEventsQueue, &agent->queues.operationalEventsQueueInitiated, true)) {
+    if (!SecurityAgent_InitRingBufferQueue(&agent->queues.highPriorityEventQueue, &agent->queues.highPriorityEventQueueInitiated, true)) {
         return false;
     }
+    SyncQueue_SetMemoryBudget(&agent->queues.highPriorityEventQueue, LocalConfiguration_GetHighPriorityQueueBudget());
+    SecurityAgent_InitQueueSpill(&agent->queues.highPriorityEventQueue, HIGH_PRIORITY_SPILL_LOG_NAME);
 
-    if (!SecurityAgent_InitQueue(&agent->queues.highPriorityEventQueue, &agent->queues.highPriorityEventQueueInitiated, true)) {
+    if (!SecurityAgent_InitRingBufferQueue(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPriorityEventQueueInitiated, true)) {
         return false;
     }
+    SyncQueue_SetMemoryBudget(&agent->queues.lowPriorityEventQueue, LocalConfiguration_GetLowPriorityQueueBudget());
+    SecurityAgent_InitQueueSpill(&agent->queues.lowPriorityEventQueue, LOW_PRIORITY_SPILL_LOG_NAME);
 
-    if (!SecurityAgent_InitQueue(&agent->queues.lowPriorityEventQueue, &agent->queues.lowPriorityEventQueueInitiated, true)) {
+    if (SyncQueue_SetEvictionQueue(&agent->queues.highPriorityEventQueue, &agent->queues.lowPriorityEventQueue, SecurityAgent_OnEventEvicted, agent) != QUEUE_OK) {
         return false;
     }
 
@@ -309,11 +421,12 @@ cleanup:
     return success;
 }
 
-bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam) {
+bool SecurityAgent_StartAsyncTask(SecurityAgentAsyncTask* asyncTask, uint32_t interval, SchedulerTask taskFunction, void* taskParam, SchedulerIntervalFunc intervalFunc) {
     if (!SchedulerThread_Init(&asyncTask->taskThread, interval, taskFunction, taskParam)) {
         return false;
     }
     asyncTask->taskThreadInitiated = true;
+    SchedulerThread_SetIntervalFunc(&asyncTask->taskThread, intervalFunc);
 
     if (!SchedulerThread_Start(&asyncTask->taskThread)) {
         Logger_Error("Error starting thread");
@@ -332,4 +445,83 @@ void SecurityAgent_StopAsyncTask(SecurityAgentAsyncTask* asyncTask) {
         }
         SchedulerThread_Deinit(&asyncTask->taskThread);
     }
-}
\ No newline at end of file
+}
+
+bool SecurityAgent_StartNotifications(SecurityAgent* agent) {
+    uint32_t maxMessageSize = 0;
+    if (TwinConfiguration_GetMaxMessageSize(&maxMessageSize) != TWIN_OK) {
+        return false;
+    }
+
+    // the publisher sends a message as soon as the queued events fill one
+    SyncQueue_SetNotification(&agent->queues.highPriorityEventQueue, maxMessageSize, SecurityAgent_WakeupPublisher, agent);
+    SyncQueue_SetNotification(&agent->queues.lowPriorityEventQueue, maxMessageSize, SecurityAgent_WakeupPublisher, agent);
+    // the twin updater handles every payload as soon as it arrives
+    SyncQueue_SetNotification(&agent->queues.twinUpdatesQueue, 1, SecurityAgent_WakeupTwinUpdater, agent);
+    UpdateTwinTask_SetConfigurationListener(&agent->updateTwinTask, SecurityAgent_OnConfigurationChanged, agent);
+    SecurityAgent_UpdateCachePolicy(agent);
+
+    return true;
+}
+
+void SecurityAgent_StopNotifications(SecurityAgent* agent) {
+    if (agent->asyncUpdateTwinTask.taskInitiated) {
+        UpdateTwinTask_SetConfigurationListener(&agent->updateTwinTask, NULL, NULL);
+    }
+
+    if (agent->queues.highPriorityEventQueueInitiated) {
+        SyncQueue_SetNotification(&agent->queues.highPriorityEventQueue, 0, NULL, NULL);
+        SyncQueue_SetEvictionEnabled(&agent->queues.highPriorityEventQueue, false);
+    }
+
+    if (agent->queues.lowPriorityEventQueueInitiated) {
+        SyncQueue_SetNotification(&agent->queues.lowPriorityEventQueue, 0, NULL, NULL);
+    }
+
+    if (agent->queues.twinUpdatesQueueInitiated) {
+        SyncQueue_SetNotification(&agent->queues.twinUpdatesQueue, 0, NULL, NULL);
+    }
+}
+
+void SecurityAgent_WakeupPublisher(void* context) {
+    SecurityAgent* agent = (SecurityAgent*)context;
+    SchedulerThread_Wakeup(&agent->asyncPublisherTask.taskThread);
+}
+
+void SecurityAgent_WakeupTwinUpdater(void* context) {
+    SecurityAgent* agent = (SecurityAgent*)context;
+    SchedulerThread_Wakeup(&agent->asyncUpdateTwinTask.taskThread);
+}
+
+void SecurityAgent_OnConfigurationChanged(void* context) {
+    SecurityAgent* agent = (SecurityAgent*)context;
+
+    uint32_t maxMessageSize = 0;
+    if (TwinConfiguration_GetMaxMessageSize(&maxMessageSize) == TWIN_OK) {
+        SyncQueue_SetNotificationWatermark(&agent->queues.highPriorityEventQueue, maxMessageSize);
+        SyncQueue_SetNotificationWatermark(&agent->queues.lowPriorityEventQueue, maxMessageSize);
+    }
+    SecurityAgent_UpdateCachePolicy(agent);
+
+    // the message frequencies and the snapshot frequency may have changed, let the publisher and the monitor reschedule
+    SchedulerThread_Wakeup(&agent->asyncPublisherTask.taskThread);
+    SchedulerThread_Wakeup(&agent->asyncMonitorTask.taskThread);
+}
+
+void SecurityAgent_OnEventEvicted(void* context, const void* data, uint32_t dataSize, uint32_t tag) {
+    if (tag != QUEUE_NO_TAG) {
+        AgentTelemetryProvider_CountEvictedEvent((TwinConfigurationEventType)tag);
+    }
+}
+
+void SecurityAgent_UpdateCachePolicy(SecurityAgent* agent) {
+    // the memory monitor caches the cache size, so pushing events never reads the twin configuration
+    if (MemoryMonitor_UpdateLimit() != MEMORY_MONITOR_OK) {
+        Logger_Warning("Failed to update the cache size, using the previous size");
+    }
+
+    bool evictLowPriorityEvents = false;
+    if (TwinConfiguration_GetEvictLowPriorityEvents(&evictLowPriorityEvents) == TWIN_OK) {
+        SyncQueue_SetEvictionEnabled(&agent->queues.highPriorityEventQueue, evictLowPriorityEvents);
+    }
+}
@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "spill_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+// the size of the record followed by its tag
+#define SPILL_LOG_RECORD_HEADER_SIZE (2 * sizeof(uint32_t))
+
+static const char SPILL_LOG_FILE_EXTENSION[] = ".spill";
+
+/**
+ * @brief Builds the path of the backing file of the log.
+ *
+ * @param   directory   The directory of the file.
+ * @param   name        The name of the log.
+ *
+ * @return a newly allocated path or NULL upon failure.
+ */
+static char* SpillLog_CreatePath(const char* directory, const char* name);
+
+/**
+ * @brief Opens the backing file of the log and empties it. A symbolic link is not followed and a file
+ *        which is not a private file of the agent is left as it is.
+ *
+ * @param   spillLog    The log, its path must be set.
+ *
+ * @return SPILL_LOG_OK on success or SPILL_LOG_EXCEPTION upon failure.
+ */
+static SpillLogResultValues SpillLog_OpenFile(SpillLog* spillLog);
+
+/**
+ * @brief Rewinds the log to the beginning of the file if all of its records were read.
+ *        Must be called under the lock.
+ *
+ * @param   spillLog    The log.
+ */
+static void SpillLog_RewindIfDrained(SpillLog* spillLog);
+
+/**
+ * @brief Finds room for a record of the given size, wrapping around to the beginning of the file
+ *        if the record does not fit its end. Must be called under the lock.
+ *
+ * @param   spillLog    The log.
+ * @param   recordSize  The size of the record, including its header.
+ *
+ * @return true if the record fits at the write offset, false if the log is full.
+ */
+static bool SpillLog_Reserve(SpillLog* spillLog, uint32_t recordSize);
+
+static char* SpillLog_CreatePath(const char* directory, const char* name) {
+    size_t pathSize = strlen(directory) + 1 + strlen(name) + sizeof(SPILL_LOG_FILE_EXTENSION);
+    char* path = malloc(pathSize);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    snprintf(path, pathSize, "%s/%s%s", directory, name, SPILL_LOG_FILE_EXTENSION);
+    return path;
+}
+
+static SpillLogResultValues SpillLog_OpenFile(SpillLog* spillLog) {
+    SpillLogResultValues result = SPILL_LOG_OK;
+    struct stat fileStat;
+
+    // the file may be in a directory other users can write to, so a symbolic link is not followed
+    int fd = open(spillLog->path, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        Logger_Error("could not open spill log %s, errno %d", spillLog->path, errno);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    // the events are written to a file of another user, or one other users can read or change, in no case
+    if (fstat(fd, &fileStat) != 0 ||
+        !S_ISREG(fileStat.st_mode) ||
+        fileStat.st_uid != geteuid() ||
+        (fileStat.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+        Logger_Warning("The spill log %s is not a private file of the agent", spillLog->path);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    // truncated only once the file is known to be ours
+    if (ftruncate(fd, 0) != 0) {
+        Logger_Error("could not truncate spill log %s", spillLog->path);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    spillLog->fileDescriptor = fd;
+
+cleanup:
+    if (result != SPILL_LOG_OK && fd >= 0) {
+        close(fd);
+    }
+
+    return result;
+}
+
+static void SpillLog_RewindIfDrained(SpillLog* spillLog) {
+    if (spillLog->numberOfRecords == 0) {
+        spillLog->readOffset = 0;
+        spillLog->writeOffset = 0;
+        spillLog->isWrapped = false;
+        spillLog->wrapOffset = 0;
+    }
+}
+
+static bool SpillLog_Reserve(SpillLog* spillLog, uint32_t recordSize) {
+    if (spillLog->isWrapped) {
+        // the records which were not read yet start at the read offset
+        return recordSize <= spillLog->readOffset - spillLog->writeOffset;
+    }
+
+    if (recordSize <= spillLog->segmentSize - spillLog->writeOffset) {
+        return true;
+    }
+
+    // the records which were already read left room at the beginning of the file
+    if (recordSize <= spillLog->readOffset) {
+        spillLog->wrapOffset = spillLog->writeOffset;
+        spillLog->writeOffset = 0;
+        spillLog->isWrapped = true;
+        return true;
+    }
+
+    return false;
+}
+
+SpillLogResultValues SpillLog_Init(SpillLog* spillLog, const char* directory, const char* name, uint32_t maxSize) {
+    SpillLogResultValues result = SPILL_LOG_OK;
+    memset(spillLog, 0, sizeof(*spillLog));
+    spillLog->fileDescriptor = -1;
+
+    if (maxSize <= SPILL_LOG_RECORD_HEADER_SIZE) {
+        Logger_Error("invalid spill log size %u", maxSize);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    spillLog->path = SpillLog_CreatePath(directory, name);
+    if (spillLog->path == NULL) {
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = SpillLog_OpenFile(spillLog);
+    if (result != SPILL_LOG_OK) {
+        goto cleanup;
+    }
+
+    // reserve the blocks upfront, a write to the mapping of a sparse file on a full disk would raise SIGBUS
+    if (posix_fallocate(spillLog->fileDescriptor, 0, maxSize) != 0) {
+        Logger_Error("could not reserve %u bytes for spill log %s", maxSize, spillLog->path);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    void* segment = mmap(NULL, maxSize, PROT_READ | PROT_WRITE, MAP_SHARED, spillLog->fileDescriptor, 0);
+    if (segment == MAP_FAILED) {
+        Logger_Error("could not map spill log %s", spillLog->path);
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+    spillLog->segment = (uint8_t*)segment;
+    spillLog->segmentSize = maxSize;
+
+    spillLog->lock = Lock_Init();
+    if (spillLog->lock == NULL) {
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+cleanup:
+    if (result != SPILL_LOG_OK) {
+        SpillLog_Deinit(spillLog);
+    }
+
+    return result;
+}
+
+void SpillLog_Deinit(SpillLog* spillLog) {
+    if (spillLog->lock != NULL) {
+        Lock_Deinit(spillLog->lock);
+        spillLog->lock = NULL;
+    }
+
+    if (spillLog->segment != NULL) {
+        munmap(spillLog->segment, spillLog->segmentSize);
+        spillLog->segment = NULL;
+    }
+
+    if (spillLog->fileDescriptor >= 0) {
+        // only a file the log opened is deleted, never one it refused
+        unlink(spillLog->path);
+        close(spillLog->fileDescriptor);
+        spillLog->fileDescriptor = -1;
+    }
+
+    if (spillLog->path != NULL) {
+        free(spillLog->path);
+        spillLog->path = NULL;
+    }
+
+    spillLog->numberOfRecords = 0;
+}
+
+SpillLogResultValues SpillLog_Append(SpillLog* spillLog, const void* data, uint32_t dataSize, uint32_t tag) {
+    if (Lock(spillLog->lock) != LOCK_OK) {
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    SpillLogResultValues result = SPILL_LOG_OK;
+    SpillLog_RewindIfDrained(spillLog);
+
+    if (dataSize > spillLog->segmentSize - SPILL_LOG_RECORD_HEADER_SIZE || !SpillLog_Reserve(spillLog, SPILL_LOG_RECORD_HEADER_SIZE + dataSize)) {
+        result = SPILL_LOG_FULL;
+        goto cleanup;
+    }
+
+    memcpy(spillLog->segment + spillLog->writeOffset, &dataSize, sizeof(uint32_t));
+    memcpy(spillLog->segment + spillLog->writeOffset + sizeof(uint32_t), &tag, sizeof(uint32_t));
+    memcpy(spillLog->segment + spillLog->writeOffset + SPILL_LOG_RECORD_HEADER_SIZE, data, dataSize);
+    spillLog->writeOffset += SPILL_LOG_RECORD_HEADER_SIZE + dataSize;
+    __atomic_store_n(&spillLog->numberOfRecords, spillLog->numberOfRecords + 1, __ATOMIC_RELEASE);
+
+cleanup:
+    Unlock(spillLog->lock);
+    return result;
+}
+
+SpillLogResultValues SpillLog_Peek(SpillLog* spillLog, void** data, uint32_t* dataSize, uint32_t* tag) {
+    if (Lock(spillLog->lock) != LOCK_OK) {
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    SpillLogResultValues result = SPILL_LOG_OK;
+    if (spillLog->numberOfRecords == 0) {
+        result = SPILL_LOG_IS_EMPTY;
+        goto cleanup;
+    }
+
+    uint32_t recordSize = 0;
+    memcpy(&recordSize, spillLog->segment + spillLog->readOffset, sizeof(uint32_t));
+
+    // the queued events are strings whose size does not include the terminating null, restore it
+    char* record = malloc(recordSize + 1);
+    if (record == NULL) {
+        result = SPILL_LOG_EXCEPTION;
+        goto cleanup;
+    }
+
+    memcpy(record, spillLog->segment + spillLog->readOffset + SPILL_LOG_RECORD_HEADER_SIZE, recordSize);
+    record[recordSize] = '\0';
+    memcpy(tag, spillLog->segment + spillLog->readOffset + sizeof(uint32_t), sizeof(uint32_t));
+    *data = record;
+    *dataSize = recordSize;
+
+cleanup:
+    Unlock(spillLog->lock);
+    return result;
+}
+
+SpillLogResultValues SpillLog_Remove(SpillLog* spillLog) {
+    if (Lock(spillLog->lock) != LOCK_OK) {
+        return SPILL_LOG_EXCEPTION;
+    }
+
+    SpillLogResultValues result = SPILL_LOG_OK;
+    if (spillLog->numberOfRecords == 0) {
+        result = SPILL_LOG_IS_EMPTY;
+        goto cleanup;
+    }
+
+    uint32_t recordSize = 0;
+    memcpy(&recordSize, spillLog->segment + spillLog->readOffset, sizeof(uint32_t));
+    spillLog->readOffset += SPILL_LOG_RECORD_HEADER_SIZE + recordSize;
+    if (spillLog->isWrapped && spillLog->readOffset == spillLog->wrapOffset) {
+        // the records before the wrap were all read, the next one is at the beginning of the file
+        spillLog->readOffset = 0;
+        spillLog->isWrapped = false;
+    }
+    __atomic_store_n(&spillLog->numberOfRecords, spillLog->numberOfRecords - 1, __ATOMIC_RELEASE);
+    SpillLog_RewindIfDrained(spillLog);
+
+cleanup:
+    Unlock(spillLog->lock);
+    return result;
+}
+
+uint32_t SpillLog_GetCount(SpillLog* spillLog) {
+    return __atomic_load_n(&spillLog->numberOfRecords, __ATOMIC_ACQUIRE);
+}
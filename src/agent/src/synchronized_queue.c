@@ -2,7 +2,553 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include "synchronized_queue.h"
 
+#include <stdlib.h>
+
+/**
+ * Spilled items are moved back once the in-memory backend holds fewer items than this, so the consumer
+ * does not wait for the backend to drain and the new items stop following the spilled ones sooner.
+ */
+#define SYNC_QUEUE_REFILL_LOW_WATERMARK 64
+
+/**
+ * The most spilled items moved back at once, so a single pop does not pay for refilling the whole backend.
+ */
+#define SYNC_QUEUE_REFILL_BATCH_SIZE 256
+
+/**
+ * @brief Resets the notification state of the queue.
+ * 
+ * @param   syncQueue   The queue.
+ */
+static void SyncQueue_InitNotification(SyncQueue* syncQueue);
+
+/**
+ * @brief Resets the eviction state of the queue.
+ * 
+ * @param   syncQueue   The queue.
+ */
+static void SyncQueue_InitEviction(SyncQueue* syncQueue);
+
+/**
+ * @brief Resets the returned items of the queue.
+ * 
+ * @param   syncQueue   The queue.
+ */
+static void SyncQueue_InitReturnedItems(SyncQueue* syncQueue);
+
+/**
+ * @brief Frees the returned items of the queue along with their data.
+ * 
+ * @param   syncQueue   The queue.
+ */
+static void SyncQueue_DeinitReturnedItems(SyncQueue* syncQueue);
+
+/**
+ * @brief Pops the first of the items which were returned to the front of the queue.
+ * 
+ * @param   syncQueue           The queue.
+ * @param   condition           A condition the item has to meet, NULL for none.
+ * @param   conditionParams     Extra parameters for the condition function.
+ * @param   data                Out param. The popped data.
+ * @param   dataSize            Out param. The size of the popped data.
+ * 
+ * @return QUEUE_OK on success, QUEUE_IS_EMPTY if there are no returned items or an error code upon failure.
+ */
+static int SyncQueue_PopReturnedItem(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize);
+
+/**
+ * @brief Pops as many of the items which were returned to the front of the queue as fit the byte budget.
+ * 
+ * @param   syncQueue       The queue.
+ * @param   byteBudget      The items are popped while the sum of their sizes is smaller than this budget.
+ * @param   itemOverhead    The amount of bytes added to the size of every item when checking the budget.
+ * @param   maxItems        The maximum number of items to pop.
+ * @param   items           Out param. The array which is filled with the popped items.
+ * @param   itemsCount      Out param. The number of items that were popped.
+ * @param   takenBudget     Out param. The part of the byte budget the popped items took.
+ * @param   isDrained       Out param. Whether no returned items are left.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+static int SyncQueue_PopReturnedBatch(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount, uint32_t* takenBudget, bool* isDrained);
+
+/**
+ * @brief Pops as many items from the in-memory backend of the queue as fit the byte budget.
+ * 
+ * @param   syncQueue       The queue.
+ * @param   byteBudget      The items are popped while the sum of their sizes is smaller than this budget.
+ * @param   itemOverhead    The amount of bytes added to the size of every item when checking the budget.
+ * @param   maxItems        The maximum number of items to pop.
+ * @param   items           Out param. The array which is filled with the popped items.
+ * @param   itemsCount      Out param. The number of items that were popped.
+ * 
+ * @return QUEUE_OK if at least one item was popped or an error code otherwise.
+ */
+static int SyncQueue_PopFrontBatchFromBackend(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount);
+
+/**
+ * @brief Accounts for a pushed item and notifies the registered callback if the watermark was reached.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   dataSize    The size of the pushed item.
+ */
+static void SyncQueue_OnPushed(SyncQueue* syncQueue, uint32_t dataSize);
+
+/**
+ * @brief Accounts for popped items.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   dataSize    The total size of the popped items.
+ * @param   itemsCount  The number of popped items.
+ */
+static void SyncQueue_OnPopped(SyncQueue* syncQueue, uint32_t dataSize, uint32_t itemsCount);
+
+/**
+ * @brief Sums the sizes of the items of a batch.
+ * 
+ * @param   items       The popped items.
+ * @param   itemsCount  The number of popped items.
+ * 
+ * @return the total size of the items.
+ */
+static uint32_t SyncQueue_GetBatchSize(QueueBatchItem* items, uint32_t itemsCount);
+
+/**
+ * @brief Returns the memory items take out of the budget of the queue, the same amount the memory monitor is charged with.
+ * 
+ * @param   dataSize    The total size of the data of the items.
+ * @param   itemsCount  The number of items.
+ * 
+ * @return the size of the data and of the bookkeeping of the items.
+ */
+static uint32_t SyncQueue_GetBudgetSize(uint32_t dataSize, uint32_t itemsCount);
+
+/**
+ * @brief Consumes the memory of a single item from the memory budget of the queue, if it has one.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   dataSize    The size of the item.
+ * 
+ * @return true if the item fits the budget, false otherwise.
+ */
+static bool SyncQueue_ConsumeBudget(SyncQueue* syncQueue, uint32_t dataSize);
+
+/**
+ * @brief Returns the memory of the given items to the memory budget of the queue, if it has one.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   dataSize    The total size of the items.
+ * @param   itemsCount  The number of items.
+ */
+static void SyncQueue_ReleaseBudget(SyncQueue* syncQueue, uint32_t dataSize, uint32_t itemsCount);
+
+/**
+ * @brief Pushes an item to the in-memory backend of the queue, within the memory budget of the queue.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   data        The data to push.
+ * @param   dataSize    The size of the data.
+ * @param   tag         The tag of the item.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+static int SyncQueue_PushToBackend(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag);
+
+/**
+ * @brief Returns the number of items in the in-memory backend of the queue.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   size        Out param. The number of items.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+static int SyncQueue_GetBackendSize(SyncQueue* syncQueue, uint32_t* size);
+
+/**
+ * @brief Appends an item to the spill log, the item is freed on success.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   data        The data to spill.
+ * @param   dataSize    The size of the data.
+ * @param   tag         The tag of the item.
+ * 
+ * @return QUEUE_OK on success or QUEUE_MAX_MEMORY_EXCEEDED if the spill log is full.
+ */
+static int SyncQueue_Spill(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag);
+
+/**
+ * @brief Moves a batch of spilled items back to the in-memory backend once it runs low, keeping their order.
+ *        Stops at the first item which does not fit the memory budget.
+ * 
+ * @param   syncQueue   The queue.
+ */
+static void SyncQueue_Refill(SyncQueue* syncQueue);
+
+/**
+ * @brief Serializes the consumers of a ring buffer backend, which has a lock only if another queue evicts from it.
+ * 
+ * @param   syncQueue   The queue.
+ * 
+ * @return LOCK_OK on success or an error code upon failure.
+ */
+static LOCK_RESULT SyncQueue_LockConsumer(SyncQueue* syncQueue);
+
+/**
+ * @brief Releases the lock which was taken by SyncQueue_LockConsumer.
+ * 
+ * @param   syncQueue   The queue.
+ * 
+ * @return LOCK_OK on success or an error code upon failure.
+ */
+static LOCK_RESULT SyncQueue_UnlockConsumer(SyncQueue* syncQueue);
+
+/**
+ * @brief Pops an item from the in-memory backend of the queue, without moving spilled items back.
+ * 
+ * @param   syncQueue   The queue.
+ * @param   data        Out param. The popped data.
+ * @param   dataSize    Out param. The size of the popped data.
+ * @param   tag         Out param. The tag of the popped item, may be NULL.
+ * 
+ * @return QUEUE_OK on success or an error code upon failure.
+ */
+static int SyncQueue_PopFrontFromBackend(SyncQueue* syncQueue, void** data, uint32_t* dataSize, uint32_t* tag);
+
+/**
+ * @brief Evicts the oldest items of the eviction queue until the given item fits the memory budget.
+ *        Items which were spilled to disk are not evicted, they do not take any memory.
+ * 
+ * @param   syncQueue   The queue to push to.
+ * @param   data        The data to push.
+ * @param   dataSize    The size of the data.
+ * @param   tag         The tag of the item.
+ * 
+ * @return QUEUE_OK if the item was pushed or QUEUE_MAX_MEMORY_EXCEEDED if there was nothing left to evict.
+ */
+static int SyncQueue_Evict(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag);
+
+static uint32_t SyncQueue_GetBatchSize(QueueBatchItem* items, uint32_t itemsCount) {
+    uint32_t batchSize = 0;
+    for (uint32_t i = 0; i < itemsCount; i++) {
+        batchSize += items[i].dataSize;
+    }
+    return batchSize;
+}
+
+static uint32_t SyncQueue_GetBudgetSize(uint32_t dataSize, uint32_t itemsCount) {
+    // the backends account every item with its bookkeeping, so many small items can not overdraw the shared limitation
+    return dataSize + itemsCount * QUEUE_ITEM_MEMORY_OVERHEAD;
+}
+
+static bool SyncQueue_ConsumeBudget(SyncQueue* syncQueue, uint32_t dataSize) {
+    if (syncQueue->memoryBudget == 0) {
+        return true;
+    }
+
+    uint32_t itemSize = SyncQueue_GetBudgetSize(dataSize, 1);
+    uint32_t consumed = __atomic_load_n(&syncQueue->memoryBudgetConsumed, __ATOMIC_RELAXED);
+    do {
+        if (itemSize > syncQueue->memoryBudget || consumed > syncQueue->memoryBudget - itemSize) {
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&syncQueue->memoryBudgetConsumed, &consumed, consumed + itemSize, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return true;
+}
+
+static void SyncQueue_ReleaseBudget(SyncQueue* syncQueue, uint32_t dataSize, uint32_t itemsCount) {
+    if (syncQueue->memoryBudget != 0) {
+        __atomic_sub_fetch(&syncQueue->memoryBudgetConsumed, SyncQueue_GetBudgetSize(dataSize, itemsCount), __ATOMIC_RELAXED);
+    }
+}
+
+static int SyncQueue_PushToBackend(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag) {
+    if (!SyncQueue_ConsumeBudget(syncQueue, dataSize)) {
+        // the queue used up its own share of the memory, account for it the same way the backend does
+        if (syncQueue->type == SYNC_QUEUE_RING_BUFFER && syncQueue->ringBufferQueue.shouldCountDrops) {
+            AgentTelemetryCounter_IncreaseBy(&syncQueue->ringBufferQueue.counter, &syncQueue->ringBufferQueue.counter.counter.queueCounter.dropped, 1);
+        } else if (syncQueue->type == SYNC_QUEUE_LINKED_LIST && syncQueue->queue.shouldCountDrops) {
+            AgentTelemetryCounter_IncreaseBy(&syncQueue->queue.counter, &syncQueue->queue.counter.counter.queueCounter.dropped, 1);
+        }
+        return QUEUE_MAX_MEMORY_EXCEEDED;
+    }
+
+    int result = QUEUE_OK;
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        result = RingBufferQueue_PushBack(&syncQueue->ringBufferQueue, data, dataSize, tag);
+    } else if (Lock(syncQueue->lock) != LOCK_OK) {
+        result = SYNC_QUEUE_LOCK_EXCEPTION;
+    } else {
+        result = Queue_PushBack(&syncQueue->queue, data, dataSize, tag);
+        if (Unlock(syncQueue->lock) != LOCK_OK) {
+            result = SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+    }
+
+    if (result != QUEUE_OK) {
+        SyncQueue_ReleaseBudget(syncQueue, dataSize, 1);
+    }
+    return result;
+}
+
+static int SyncQueue_GetBackendSize(SyncQueue* syncQueue, uint32_t* size) {
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        return RingBufferQueue_GetSize(&syncQueue->ringBufferQueue, size);
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }          
+    
+    QueueResultValues result = Queue_GetSize(&syncQueue->queue, size);
+                                
+    if (Unlock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return result;
+}
+
+static int SyncQueue_Spill(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag) {
+    if (SpillLog_Append(&syncQueue->spillLog, data, dataSize, tag) != SPILL_LOG_OK) {
+        return QUEUE_MAX_MEMORY_EXCEEDED;
+    }
+
+    free(data);
+    return QUEUE_OK;
+}
+
+static void SyncQueue_Refill(SyncQueue* syncQueue) {
+    if (!syncQueue->spillEnabled || SpillLog_GetCount(&syncQueue->spillLog) == 0) {
+        return;
+    }
+
+    uint32_t backendSize = 0;
+    if (SyncQueue_GetBackendSize(syncQueue, &backendSize) != QUEUE_OK || backendSize >= SYNC_QUEUE_REFILL_LOW_WATERMARK) {
+        return;
+    }
+
+    // new items are spilled as long as the log holds items, so the moved items stay ahead of them
+    void* data = NULL;
+    uint32_t dataSize = 0;
+    uint32_t tag = QUEUE_NO_TAG;
+    for (uint32_t i = 0; i < SYNC_QUEUE_REFILL_BATCH_SIZE && SpillLog_Peek(&syncQueue->spillLog, &data, &dataSize, &tag) == SPILL_LOG_OK; i++) {
+        if (SyncQueue_PushToBackend(syncQueue, data, dataSize, tag) != QUEUE_OK) {
+            free(data);
+            break;
+        }
+        SpillLog_Remove(&syncQueue->spillLog);
+    }
+}
+
+static LOCK_RESULT SyncQueue_LockConsumer(SyncQueue* syncQueue) {
+    if (syncQueue->lock == NULL) {
+        return LOCK_OK;
+    }
+    return Lock(syncQueue->lock);
+}
+
+static LOCK_RESULT SyncQueue_UnlockConsumer(SyncQueue* syncQueue) {
+    if (syncQueue->lock == NULL) {
+        return LOCK_OK;
+    }
+    return Unlock(syncQueue->lock);
+}
+
+static int SyncQueue_PopFrontFromBackend(SyncQueue* syncQueue, void** data, uint32_t* dataSize, uint32_t* tag) {
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        QueueResultValues result = RingBufferQueue_PopFront(&syncQueue->ringBufferQueue, data, dataSize, tag);
+
+        if (SyncQueue_UnlockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        if (result == QUEUE_OK) {
+            SyncQueue_OnPopped(syncQueue, *dataSize, 1);
+        }
+        return result;
+    }
+
+    if (Lock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }          
+    
+    QueueResultValues result = Queue_PopFront(&syncQueue->queue, data, dataSize, tag);
+                                
+    if (Unlock(syncQueue->lock) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    if (result == QUEUE_OK) {
+        SyncQueue_OnPopped(syncQueue, *dataSize, 1);
+    }
+    return result;
+}
+
+static int SyncQueue_Evict(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag) {
+    SyncQueue* evictionQueue = syncQueue->evictionQueue;
+
+    uint32_t itemSize = SyncQueue_GetBudgetSize(dataSize, 1);
+    uint32_t budgetConsumed = __atomic_load_n(&syncQueue->memoryBudgetConsumed, __ATOMIC_RELAXED);
+    if (syncQueue->memoryBudget != 0 && (itemSize > syncQueue->memoryBudget || budgetConsumed > syncQueue->memoryBudget - itemSize)) {
+        // evicting from another queue does not help if this queue used up its own budget
+        return QUEUE_MAX_MEMORY_EXCEEDED;
+    }
+
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        // evicting does not help if the ring buffer ran out of slots rather than memory
+        uint32_t size = 0;
+        RingBufferQueue_GetSize(&syncQueue->ringBufferQueue, &size);
+        if (size >= syncQueue->ringBufferQueue.capacity) {
+            return QUEUE_MAX_MEMORY_EXCEEDED;
+        }
+    }
+
+    int result = QUEUE_MAX_MEMORY_EXCEEDED;
+    while (result == QUEUE_MAX_MEMORY_EXCEEDED) {
+        void* evictedData = NULL;
+        uint32_t evictedDataSize = 0;
+        uint32_t evictedTag = QUEUE_NO_TAG;
+        if (SyncQueue_PopFrontFromBackend(evictionQueue, &evictedData, &evictedDataSize, &evictedTag) != QUEUE_OK) {
+            break;
+        }
+
+        SyncedCounter* counter = SyncQueue_GetCounter(evictionQueue);
+        AgentTelemetryCounter_IncreaseBy(counter, &counter->counter.queueCounter.dropped, 1);
+        if (syncQueue->evictionCallback != NULL) {
+            syncQueue->evictionCallback(syncQueue->evictionContext, evictedData, evictedDataSize, evictedTag);
+        }
+        free(evictedData);
+
+        result = SyncQueue_PushToBackend(syncQueue, data, dataSize, tag);
+    }
+
+    return result;
+}
+
+static void SyncQueue_InitNotification(SyncQueue* syncQueue) {
+    syncQueue->bytesInQueue = 0;
+    syncQueue->notificationWatermark = 0;
+    syncQueue->notification = NULL;
+    syncQueue->notificationContext = NULL;
+}
+
+static void SyncQueue_InitEviction(SyncQueue* syncQueue) {
+    syncQueue->evictionQueue = NULL;
+    syncQueue->evictionCallback = NULL;
+    syncQueue->evictionContext = NULL;
+    syncQueue->evictionEnabled = false;
+}
+
+static void SyncQueue_InitReturnedItems(SyncQueue* syncQueue) {
+    syncQueue->returnedItems = NULL;
+    syncQueue->returnedItemsCount = 0;
+}
+
+static void SyncQueue_DeinitReturnedItems(SyncQueue* syncQueue) {
+    while (syncQueue->returnedItems != NULL) {
+        QueueItem* item = syncQueue->returnedItems;
+        syncQueue->returnedItems = item->nextItem;
+        free(item->data);
+        free(item);
+    }
+    syncQueue->returnedItemsCount = 0;
+}
+
+static int SyncQueue_PopReturnedItem(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+    if (__atomic_load_n(&syncQueue->returnedItemsCount, __ATOMIC_RELAXED) == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    int result = QUEUE_OK;
+    QueueItem* item = syncQueue->returnedItems;
+    if (item == NULL) {
+        result = QUEUE_IS_EMPTY;
+    } else if (condition != NULL && !condition(item->data, item->dataSize, conditionParams)) {
+        result = QUEUE_CONDITION_FAILED;
+    } else {
+        *data = item->data;
+        *dataSize = item->dataSize;
+        syncQueue->returnedItems = item->nextItem;
+        __atomic_sub_fetch(&syncQueue->returnedItemsCount, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&syncQueue->bytesInQueue, item->dataSize, __ATOMIC_RELAXED);
+        free(item);
+    }
+
+    if (SyncQueue_UnlockConsumer(syncQueue) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return result;
+}
+
+static int SyncQueue_PopReturnedBatch(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount, uint32_t* takenBudget, bool* isDrained) {
+    *itemsCount = 0;
+    *takenBudget = 0;
+    *isDrained = true;
+    if (__atomic_load_n(&syncQueue->returnedItemsCount, __ATOMIC_RELAXED) == 0) {
+        return QUEUE_OK;
+    }
+
+    if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+
+    uint64_t budgetBytes = 0;
+    uint32_t takenBytes = 0;
+    while (syncQueue->returnedItems != NULL && *itemsCount < maxItems) {
+        QueueItem* item = syncQueue->returnedItems;
+        if (budgetBytes + item->dataSize + itemOverhead >= byteBudget) {
+            break;
+        }
+
+        items[*itemsCount].data = item->data;
+        items[*itemsCount].dataSize = item->dataSize;
+        ++(*itemsCount);
+        budgetBytes += item->dataSize + itemOverhead;
+        takenBytes += item->dataSize;
+
+        syncQueue->returnedItems = item->nextItem;
+        free(item);
+    }
+    *isDrained = syncQueue->returnedItems == NULL;
+    *takenBudget = (uint32_t)budgetBytes;
+    __atomic_sub_fetch(&syncQueue->returnedItemsCount, *itemsCount, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&syncQueue->bytesInQueue, takenBytes, __ATOMIC_RELAXED);
+
+    if (SyncQueue_UnlockConsumer(syncQueue) != LOCK_OK) {
+        return SYNC_QUEUE_LOCK_EXCEPTION;
+    }
+    return QUEUE_OK;
+}
+
+static void SyncQueue_OnPushed(SyncQueue* syncQueue, uint32_t dataSize) {
+    uint32_t bytesInQueue = __atomic_add_fetch(&syncQueue->bytesInQueue, dataSize, __ATOMIC_RELAXED);
+    SyncQueueNotification notification = __atomic_load_n(&syncQueue->notification, __ATOMIC_ACQUIRE);
+    if (notification != NULL && bytesInQueue >= __atomic_load_n(&syncQueue->notificationWatermark, __ATOMIC_RELAXED)) {
+        notification(syncQueue->notificationContext);
+    }
+}
+
+static void SyncQueue_OnPopped(SyncQueue* syncQueue, uint32_t dataSize, uint32_t itemsCount) {
+    __atomic_sub_fetch(&syncQueue->bytesInQueue, dataSize, __ATOMIC_RELAXED);
+    SyncQueue_ReleaseBudget(syncQueue, dataSize, itemsCount);
+}
+
 int SyncQueue_Init(SyncQueue* syncQueue, bool shouldSendLogs) {
+    syncQueue->type = SYNC_QUEUE_LINKED_LIST;
+    syncQueue->spillEnabled = false;
+    syncQueue->memoryBudget = 0;
+    syncQueue->memoryBudgetConsumed = 0;
+    SyncQueue_InitEviction(syncQueue);
+    SyncQueue_InitNotification(syncQueue);
+    SyncQueue_InitReturnedItems(syncQueue);
     QueueResultValues result = Queue_Init(&syncQueue->queue, shouldSendLogs);
     if (result != QUEUE_OK) {
         return result;
@@ -17,41 +563,198 @@ int SyncQueue_Init(SyncQueue* syncQueue, bool shouldSendLogs) {
     return QUEUE_OK;
 }
 
+int SyncQueue_InitRingBuffer(SyncQueue* syncQueue, bool shouldSendLogs, uint32_t capacity) {
+    syncQueue->type = SYNC_QUEUE_RING_BUFFER;
+    syncQueue->lock = NULL;
+    syncQueue->spillEnabled = false;
+    syncQueue->memoryBudget = 0;
+    syncQueue->memoryBudgetConsumed = 0;
+    SyncQueue_InitEviction(syncQueue);
+    SyncQueue_InitNotification(syncQueue);
+    SyncQueue_InitReturnedItems(syncQueue);
+    return RingBufferQueue_Init(&syncQueue->ringBufferQueue, shouldSendLogs, capacity);
+}
+
 void SyncQueue_Deinit(SyncQueue* syncQueue) {
-    Queue_Deinit(&syncQueue->queue);
+    SyncQueue_DeinitReturnedItems(syncQueue);
+
+    if (syncQueue->spillEnabled) {
+        SpillLog_Deinit(&syncQueue->spillLog);
+        syncQueue->spillEnabled = false;
+    }
+
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        RingBufferQueue_Deinit(&syncQueue->ringBufferQueue);
+    } else {
+        Queue_Deinit(&syncQueue->queue);
+    }
 
     if (syncQueue->lock != NULL) {
         Lock_Deinit(syncQueue->lock);
     }
 }
 
+int SyncQueue_EnableSpill(SyncQueue* syncQueue, const char* directory, const char* name, uint32_t maxSize) {
+    if (SpillLog_Init(&syncQueue->spillLog, directory, name, maxSize) != SPILL_LOG_OK) {
+        return QUEUE_MEMORY_EXCEPTION;
+    }
+
+    // the backend rejecting an item is not a drop anymore, the queue counts the items the spill log rejects
+    syncQueue->queue.shouldCountDrops = false;
+    syncQueue->ringBufferQueue.shouldCountDrops = false;
+    syncQueue->spillEnabled = true;
+    return QUEUE_OK;
+}
+
+void SyncQueue_SetMemoryBudget(SyncQueue* syncQueue, uint32_t maxSizeInBytes) {
+    syncQueue->memoryBudget = maxSizeInBytes;
+}
+
+int SyncQueue_SetEvictionQueue(SyncQueue* syncQueue, SyncQueue* evictionQueue, SyncQueueEvictionCallback onEvicted, void* context) {
+    if (evictionQueue->type == SYNC_QUEUE_RING_BUFFER && evictionQueue->lock == NULL) {
+        // the ring buffer supports a single consumer, the pushing threads of this queue are about to become consumers too
+        evictionQueue->lock = Lock_Init();
+        if (evictionQueue->lock == NULL) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+    }
+
+    // the backend rejecting an item is not a drop anymore, the queue counts the items it fails to make room for
+    syncQueue->queue.shouldCountDrops = false;
+    syncQueue->ringBufferQueue.shouldCountDrops = false;
+    syncQueue->evictionCallback = onEvicted;
+    syncQueue->evictionContext = context;
+    syncQueue->evictionQueue = evictionQueue;
+    return QUEUE_OK;
+}
+
+void SyncQueue_SetEvictionEnabled(SyncQueue* syncQueue, bool enabled) {
+    __atomic_store_n(&syncQueue->evictionEnabled, enabled, __ATOMIC_RELAXED);
+}
+
 int SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
-    if (Lock(syncQueue->lock) != LOCK_OK) {
-        return SYNC_QUEUE_LOCK_EXCEPTION;
+    return SyncQueue_PushBackTagged(syncQueue, data, dataSize, QUEUE_NO_TAG);
+}
+
+int SyncQueue_PushBackTagged(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag) {
+    int result = QUEUE_OK;
+
+    if (syncQueue->spillEnabled && SpillLog_GetCount(&syncQueue->spillLog) > 0) {
+        // keep the order, once items were spilled the new items follow them until all of them were moved back
+        result = SyncQueue_Spill(syncQueue, data, dataSize, tag);
+    } else {
+        result = SyncQueue_PushToBackend(syncQueue, data, dataSize, tag);
+        if (result == QUEUE_MAX_MEMORY_EXCEEDED && syncQueue->spillEnabled) {
+            result = SyncQueue_Spill(syncQueue, data, dataSize, tag);
+        }
     }
-    
-    QueueResultValues result = Queue_PushBack(&syncQueue->queue, data, dataSize);
-                                
-    if (Unlock(syncQueue->lock) != LOCK_OK) {
-        return SYNC_QUEUE_LOCK_EXCEPTION;
+
+    // a spilled item is only delayed while an evicted one is lost, so eviction is the last resort
+    // even though the item then overtakes the spilled items
+    if (result == QUEUE_MAX_MEMORY_EXCEEDED && syncQueue->evictionQueue != NULL && __atomic_load_n(&syncQueue->evictionEnabled, __ATOMIC_RELAXED)) {
+        result = SyncQueue_Evict(syncQueue, data, dataSize, tag);
+    }
+
+    if (result == QUEUE_OK) {
+        SyncQueue_OnPushed(syncQueue, dataSize);
+    } else if (result == QUEUE_MAX_MEMORY_EXCEEDED && (syncQueue->spillEnabled || syncQueue->evictionQueue != NULL)) {
+        // the backend does not count its drops in this case, the item was neither evicted for nor spilled
+        SyncedCounter* counter = SyncQueue_GetCounter(syncQueue);
+        AgentTelemetryCounter_IncreaseBy(counter, &counter->counter.queueCounter.dropped, 1);
     }
     return result;
 }
 
-int SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataSize) {
-    if (Lock(syncQueue->lock) != LOCK_OK) {
-        return SYNC_QUEUE_LOCK_EXCEPTION;
-    }          
-    
-    QueueResultValues result = Queue_PopFront(&syncQueue->queue, data, dataSize);
-                                
-    if (Unlock(syncQueue->lock) != LOCK_OK) {
+int SyncQueue_PushFront(SyncQueue* syncQueue, QueueBatchItem* items, uint32_t itemsCount) {
+    QueueItem* firstItem = NULL;
+    QueueItem* lastItem = NULL;
+    uint32_t returnedBytes = 0;
+
+    // the list is built before it is linked, so either all the items are returned or none of them
+    for (uint32_t i = 0; i < itemsCount; i++) {
+        QueueItem* item = (QueueItem*)malloc(sizeof(QueueItem));
+        if (item == NULL) {
+            while (firstItem != NULL) {
+                item = firstItem;
+                firstItem = item->nextItem;
+                free(item);
+            }
+            return QUEUE_MEMORY_EXCEPTION;
+        }
+
+        item->data = items[i].data;
+        item->dataSize = items[i].dataSize;
+        item->tag = QUEUE_NO_TAG;
+        item->nextItem = NULL;
+        item->prevItem = lastItem;
+        if (lastItem == NULL) {
+            firstItem = item;
+        } else {
+            lastItem->nextItem = item;
+        }
+        lastItem = item;
+        returnedBytes += items[i].dataSize;
+    }
+
+    if (firstItem == NULL) {
+        return QUEUE_OK;
+    }
+
+    if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+        while (firstItem != NULL) {
+            QueueItem* item = firstItem;
+            firstItem = item->nextItem;
+            free(item);
+        }
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }
-    return result;
+
+    lastItem->nextItem = syncQueue->returnedItems;
+    syncQueue->returnedItems = firstItem;
+    __atomic_add_fetch(&syncQueue->returnedItemsCount, itemsCount, __ATOMIC_RELAXED);
+    // back in the queue, yet not a new push, so the notification is not triggered
+    __atomic_add_fetch(&syncQueue->bytesInQueue, returnedBytes, __ATOMIC_RELAXED);
+
+    // the items belong to the queue now, the caller must not free them even if unlocking failed
+    (void)SyncQueue_UnlockConsumer(syncQueue);
+    return QUEUE_OK;
+}
+
+int SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataSize) {
+    int result = SyncQueue_PopReturnedItem(syncQueue, NULL, NULL, data, dataSize);
+    if (result != QUEUE_IS_EMPTY) {
+        return result;
+    }
+
+    SyncQueue_Refill(syncQueue);
+    return SyncQueue_PopFrontFromBackend(syncQueue, data, dataSize, NULL);
 }
 
 int SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+    int returnedResult = SyncQueue_PopReturnedItem(syncQueue, condition, conditionParams, data, dataSize);
+    if (returnedResult != QUEUE_IS_EMPTY) {
+        return returnedResult;
+    }
+
+    SyncQueue_Refill(syncQueue);
+
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        QueueResultValues result = RingBufferQueue_PopFrontIf(&syncQueue->ringBufferQueue, condition, conditionParams, data, dataSize);
+
+        if (SyncQueue_UnlockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        if (result == QUEUE_OK) {
+            SyncQueue_OnPopped(syncQueue, *dataSize, 1);
+        }
+        return result;
+    }
+
     if (Lock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }          
@@ -61,18 +764,106 @@ int SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void
     if (Unlock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }
+
+    if (result == QUEUE_OK) {
+        SyncQueue_OnPopped(syncQueue, *dataSize, 1);
+    }
     return result;
 }
 
-int SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
+int SyncQueue_PopFrontBatch(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount) {
+    uint32_t takenBudget = 0;
+    bool isDrained = true;
+    int result = SyncQueue_PopReturnedBatch(syncQueue, byteBudget, itemOverhead, maxItems, items, itemsCount, &takenBudget, &isDrained);
+    if (result != QUEUE_OK) {
+        return result;
+    }
+
+    uint32_t returnedCount = *itemsCount;
+    if (returnedCount == 0 && isDrained) {
+        return SyncQueue_PopFrontBatchFromBackend(syncQueue, byteBudget, itemOverhead, maxItems, items, itemsCount);
+    }
+
+    if (!isDrained || returnedCount == maxItems) {
+        // the items of the backend are queued behind the returned items which are left
+        return (returnedCount > 0) ? QUEUE_OK : QUEUE_CONDITION_FAILED;
+    }
+
+    uint32_t backendCount = 0;
+    result = SyncQueue_PopFrontBatchFromBackend(syncQueue, byteBudget - takenBudget, itemOverhead, maxItems - returnedCount, items + returnedCount, &backendCount);
+    if (result == QUEUE_OK) {
+        *itemsCount = returnedCount + backendCount;
+    } else if (returnedCount > 0) {
+        // the returned items were popped in any case
+        result = QUEUE_OK;
+    }
+
+    return result;
+}
+
+static int SyncQueue_PopFrontBatchFromBackend(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount) {
+    SyncQueue_Refill(syncQueue);
+
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        if (SyncQueue_LockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        QueueResultValues result = RingBufferQueue_PopFrontBatch(&syncQueue->ringBufferQueue, byteBudget, itemOverhead, maxItems, items, itemsCount);
+
+        if (SyncQueue_UnlockConsumer(syncQueue) != LOCK_OK) {
+            return SYNC_QUEUE_LOCK_EXCEPTION;
+        }
+
+        if (result == QUEUE_OK) {
+            SyncQueue_OnPopped(syncQueue, SyncQueue_GetBatchSize(items, *itemsCount), *itemsCount);
+        }
+        return result;
+    }
+
     if (Lock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
-    }          
-    
-    QueueResultValues result = Queue_GetSize(&syncQueue->queue, size);
-                                
+    }
+
+    QueueResultValues result = Queue_PopFrontBatch(&syncQueue->queue, byteBudget, itemOverhead, maxItems, items, itemsCount);
+
     if (Unlock(syncQueue->lock) != LOCK_OK) {
         return SYNC_QUEUE_LOCK_EXCEPTION;
     }
+
+    if (result == QUEUE_OK) {
+        SyncQueue_OnPopped(syncQueue, SyncQueue_GetBatchSize(items, *itemsCount), *itemsCount);
+    }
+    return result;
+}
+
+int SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
+    int result = SyncQueue_GetBackendSize(syncQueue, size);
+    if (result == QUEUE_OK && syncQueue->spillEnabled) {
+        *size += SpillLog_GetCount(&syncQueue->spillLog);
+    }
+    if (result == QUEUE_OK) {
+        *size += __atomic_load_n(&syncQueue->returnedItemsCount, __ATOMIC_RELAXED);
+    }
     return result;
-}
\ No newline at end of file
+}
+
+SyncedCounter* SyncQueue_GetCounter(SyncQueue* syncQueue) {
+    if (syncQueue->type == SYNC_QUEUE_RING_BUFFER) {
+        return &syncQueue->ringBufferQueue.counter;
+    }
+
+    return &syncQueue->queue.counter;
+}
+
+void SyncQueue_SetNotification(SyncQueue* syncQueue, uint32_t byteWatermark, SyncQueueNotification notification, void* context) {
+    __atomic_store_n(&syncQueue->notification, NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&syncQueue->notificationWatermark, byteWatermark, __ATOMIC_RELAXED);
+    syncQueue->notificationContext = context;
+    // publish the callback last so pushing threads never see it with a stale context
+    __atomic_store_n(&syncQueue->notification, notification, __ATOMIC_RELEASE);
+}
+
+void SyncQueue_SetNotificationWatermark(SyncQueue* syncQueue, uint32_t byteWatermark) {
+    __atomic_store_n(&syncQueue->notificationWatermark, byteWatermark, __ATOMIC_RELAXED);
+}
@@ -5,6 +5,8 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "collectors/agent_configuration_error_collector.h"
 #include "collectors/agent_telemetry_collector.h"
@@ -13,34 +15,214 @@
 #include "collectors/diagnostic_event_collector.h"
 #include "collectors/firewall_collector.h"
 #include "collectors/linux/baseline_collector.h"
+#include "collectors/linux/generic_audit_event.h"
 #include "collectors/listening_ports_collector.h"
 #include "collectors/local_users_collector.h"
 #include "collectors/process_creation_collector.h"
 #include "collectors/system_information_collector.h"
 #include "collectors/user_login_collector.h"
+#include "consts.h"
 #include "internal/time_utils.h"
 #include "local_config.h"
 #include "logger.h"
+#include "os_utils/linux/audit/audit_search.h"
 #include "twin_configuration_event_collectors.h"
 #include "twin_configuration.h"
 
+static const uint32_t TIMER_WHEEL_TICK_IN_MILLISECONDS = 100;
+static const char AUDIT_CHECKPOINT_FILE[] = "/var/tmp/auditCheckpoint";
+// the checkpoints of the audit collectors before they shared the audit log search
+static const char* AUDIT_LEGACY_CHECKPOINT_FILES[] = {
+    "/var/tmp/processCreationCheckpoint",
+    "/var/tmp/userLoginCheckpoint",
+    "/var/tmp/connectionCreationCheckpoint"
+};
+
+typedef struct _EventMonitorTaskCollectorDefinition {
+    const char* name;
+    TwinConfigurationEventType eventType;
+    EventCollectorFunc collectFunction;
+    bool isPeriodic;
+} EventMonitorTaskCollectorDefinition;
+
+/**
+ * Periodic collectors run every snapshot frequency, triggered collectors every triggered events interval,
+ * unless the local configuration sets an interval of their own.
+ */
+static const EventMonitorTaskCollectorDefinition EVENT_MONITOR_TASK_COLLECTORS[] = {
+    { "telemetry", EVENT_TYPE_OPERATIONAL_EVENT, AgentTelemetryCollector_GetEvents, true },
+    { "local users", EVENT_TYPE_LOCAL_USERS, LocalUsersCollector_GetEvents, true },
+    { "system info", EVENT_TYPE_SYSTEM_INFORMATION, SystemInformationCollector_GetEvents, true },
+    { "listening ports", EVENT_TYPE_LISTENING_PORTS, ListeningPortCollector_GetEvents, true },
+    { "firewall configuration", EVENT_TYPE_FIREWALL_CONFIGURATION, FirewallCollector_GetEvents, true },
+    { "baseline events", EVENT_TYPE_BASELINE, BaselineCollector_GetEvents, true },
+    { "periodic diagnostic events", EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents, true },
+    { "configuration error events", EVENT_TYPE_OPERATIONAL_EVENT, AgentConfigurationErrorCollector_GetEvents, false },
+    { "process create", EVENT_TYPE_PROCESS_CREATE, ProcessCreationCollector_GetEvents, false },
+    { "login", EVENT_TYPE_USER_LOGIN, UserLoginCollector_GetEvents, false },
+    { "connection create", EVENT_TYPE_CONNECTION_CREATE, ConnectionCreateEventCollector_GetEvents, false },
+    { "triggered diagnostic events", EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents, false }
+};
+
+typedef struct _EventMonitorTaskAuditCollectorDefinition {
+    EventCollectorFunc collectFunction;
+    AuditHandlerRegistrationFunc addHandlerFunction;
+    AuditEventCollectorFunc handleEventFunction;
+    EventCollectorFunc flushFunction;
+    AuditExclusionsFunc setExclusionsFunction;
+} EventMonitorTaskAuditCollectorDefinition;
+
+/**
+ * The collectors which search the audit logs, matched by their collect function.
+ * They get their events from the shared audit dispatcher, either by its audit log search or by the audit feed,
+ * and their runs call the flush function, if there is one.
+ * The collectors of syscalls have a set exclusions function, which drops the excluded activity in the kernel.
+ */
+static const EventMonitorTaskAuditCollectorDefinition EVENT_MONITOR_TASK_AUDIT_COLLECTORS[] = {
+    { ProcessCreationCollector_GetEvents, ProcessCreationCollector_AddAuditHandler, ProcessCreationCollector_HandleAuditEvent, ProcessCreationCollector_GetAggregatedEvents, ProcessCreationCollector_SetAuditExclusions },
+    { UserLoginCollector_GetEvents, UserLoginCollector_AddAuditHandler, UserLoginCollector_HandleAuditEvent, NULL, NULL },
+    { ConnectionCreateEventCollector_GetEvents, ConnectionCreateEventCollector_AddAuditHandler, ConnectionCreateEventCollector_HandleAuditEvent, ConnectionCreateEventCollector_GetAggregatedEvents, ConnectionCreateEventCollector_SetAuditExclusions }
+};
+
 /**
- * @brief Monitors all the periodic events in the system.
+ * @brief Hands a collector to its workers once its timer expires and schedules its next run.
+ *        The run is skipped if the previous run of the collect function did not finish yet.
+ * 
+ * @param   context     The collector.
+ */
+static void EventMonitorTask_OnCollectorTimer(void* context);
+
+/**
+ * @brief Runs a collector on a worker.
+ * 
+ * @param   context     The collector.
+ */
+static void EventMonitorTask_RunCollector(void* context);
+
+/**
+ * @brief Cancels and reports the running collectors which exceeded their time budget.
+ * 
+ * @param   task    The monitor task.
+ * @param   now     The current monotonic time in milliseconds.
+ */
+static void EventMonitorTask_CheckTimeBudgets(EventMonitorTask* task, uint64_t now);
+
+/**
+ * @brief Returns the time until the first running collector exceeds its time budget.
  * 
  * @param   task    The monitor task.
+ * @param   now     The current monotonic time in milliseconds.
+ * 
+ * @return the time in milliseconds, UINT32_MAX if no running collector has a deadline.
+ */
+static uint32_t EventMonitorTask_GetTimeToNextDeadline(EventMonitorTask* task, uint64_t now);
+
+/**
+ * @brief (Re)schedules the collectors whose interval changed since they were scheduled.
+ * 
+ * @param   task                The monitor task.
+ * @param   periodicFrequency   The interval of the periodic collectors.
+ * @param   triggeredInterval   The interval of the triggered collectors.
+ */
+static void EventMonitorTask_UpdateSchedules(EventMonitorTask* task, uint32_t periodicFrequency, uint32_t triggeredInterval);
+
+/**
+ * @brief Returns a random jitter for the given interval, so the collectors do not run in lockstep
+ *        on a single device nor across devices.
+ * 
+ * @param   task        The monitor task.
+ * @param   interval    The interval of the collector.
+ * 
+ * @return a random delay between 0 and the jitter percentage of the interval.
+ */
+static uint32_t EventMonitorTask_GetJitter(EventMonitorTask* task, uint32_t interval);
+
+/**
+ * @brief Returns the queue of the given event type by its priority.
+ * 
+ * @param   task        The monitor task.
+ * @param   eventType   The type of the event.
+ * @param   queue       Out param. The queue of the event type, NULL if the event type is off.
  * 
  * @return true on success, false otherwise.
  */
-static bool EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task);
+static bool EventMonitorTask_GetQueue(EventMonitorTask* task, TwinConfigurationEventType eventType, SyncQueue** queue);
+
+/**
+ * @brief Returns the interval of the given collector.
+ * 
+ * @param   collector           The collector.
+ * @param   periodicFrequency   The interval of the periodic collectors.
+ * @param   triggeredInterval   The interval of the triggered collectors.
+ * 
+ * @return the interval in milliseconds.
+ */
+static uint32_t EventMonitorTask_GetInterval(const EventMonitorTaskCollector* collector, uint32_t periodicFrequency, uint32_t triggeredInterval);
 
 /**
- * @brief Monitors all the triggered events in the system.
+ * @brief Registers the audit collectors on the audit dispatcher.
  * 
  * @param   task    The monitor task.
  * 
  * @return true on success, false otherwise.
  */
-static bool EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task);
+static bool EventMonitorTask_InitAuditDispatcher(EventMonitorTask* task);
+
+/**
+ * @brief Runs all the audit collectors, called on the run of the first of them.
+ *        The audit logs are searched once for all of them, unless the audit feed hands them their events.
+ * 
+ * @param   task    The monitor task.
+ */
+static void EventMonitorTask_RunAuditCollectors(EventMonitorTask* task);
+
+/**
+ * @brief Starts the audit feed, which then hands the events to the audit dispatcher instead of the audit log search.
+ *        The audit collectors keep searching the audit logs if the feed can not start.
+ * 
+ * @param   task    The monitor task.
+ */
+static void EventMonitorTask_StartAuditFeed(EventMonitorTask* task);
+
+/**
+ * @brief Moves the audit collectors back to the audit log search once the audit feed stopped.
+ * 
+ * @param   task    The monitor task.
+ */
+static void EventMonitorTask_CheckAuditFeed(EventMonitorTask* task);
+
+/**
+ * @brief Applies the audit exclusions of the twin configuration if they changed since they were last applied.
+ *        Exclusions which fail to apply are retried only once the twin changes them.
+ * 
+ * @param   task    The monitor task.
+ */
+static void EventMonitorTask_UpdateAuditExclusions(EventMonitorTask* task);
+
+/**
+ * @brief Compares a list of the audit exclusions which was applied to its current value.
+ * 
+ * @param   applied     The applied list, NULL for none.
+ * @param   current     The current list, NULL for none.
+ * 
+ * @return true if both lists hold the same exclusions, an empty list is the same as none.
+ */
+static bool EventMonitorTask_IsAuditExclusionUnchanged(const char* applied, const char* current);
+
+/**
+ * @brief Frees the copies of the audit exclusions which were last applied.
+ * 
+ * @param   task    The monitor task.
+ */
+static void EventMonitorTask_FreeAppliedAuditExclusions(EventMonitorTask* task);
+
+/**
+ * @brief Hands an audit event to its collector, called by the audit dispatcher.
+ * 
+ * @param   auditSearch     The search positioned on the event.
+ * @param   context         The collector.
+ */
+static void EventMonitorTask_OnAuditEvent(AuditSearch* auditSearch, void* context);
 
 /**
  * @brief Monitor a singke event type.
@@ -70,124 +252,489 @@ bool EventMonitorTask_Init(EventMonitorTask* task, SyncQueue* highPriorityQueue,
     task->operationalEventsQueue = operationalEventsQueue;
     task->highPriorityQueue = highPriorityQueue;
     task->lowPriorityQueue = lowPriorityQueue;
-    task->lastPeriodicExecution = 0;
-    task->lastTriggeredExecution = 0;
 
-    return EventMonitorTask_InitCollectors();
+    uint64_t now = TimeUtils_GetMonotonicTimeInMilliseconds();
+    TimerWheel_Init(&task->timerWheel, TIMER_WHEEL_TICK_IN_MILLISECONDS, now);
+    task->jitterPercentage = LocalConfiguration_GetSchedulingJitterPercentage();
+    task->randomSeed = (unsigned int)(now ^ (uint64_t)getpid());
+    task->collectorTimeBudget = DEFAULT_COLLECTOR_TIME_BUDGET;
+
+    task->collectorsCount = 0;
+    task->auditLead = NULL;
+    for (uint32_t i = 0; i < sizeof(EVENT_MONITOR_TASK_COLLECTORS) / sizeof(EVENT_MONITOR_TASK_COLLECTORS[0]) && i < EVENT_MONITOR_TASK_MAX_COLLECTORS; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[task->collectorsCount++];
+        collector->task = task;
+        collector->name = EVENT_MONITOR_TASK_COLLECTORS[i].name;
+        collector->eventType = EVENT_MONITOR_TASK_COLLECTORS[i].eventType;
+        collector->collectFunction = EVENT_MONITOR_TASK_COLLECTORS[i].collectFunction;
+        collector->isPeriodic = EVENT_MONITOR_TASK_COLLECTORS[i].isPeriodic;
+        collector->configuredInterval = LocalConfiguration_GetCollectorInterval(collector->eventType);
+        // nothing is scheduled until the intervals are known
+        collector->interval = 0;
+        TimerWheel_InitEntry(&collector->timer, EventMonitorTask_OnCollectorTimer, collector);
+
+        collector->inFlight = false;
+        collector->inFlightGuard = collector;
+        CancellationToken_Init(&collector->cancellation, 0);
+        collector->timeBudget = 0;
+        collector->running = false;
+        collector->overrunReported = false;
+        collector->audit = NULL;
+        for (uint32_t j = 0; j < sizeof(EVENT_MONITOR_TASK_AUDIT_COLLECTORS) / sizeof(EVENT_MONITOR_TASK_AUDIT_COLLECTORS[0]); j++) {
+            if (EVENT_MONITOR_TASK_AUDIT_COLLECTORS[j].collectFunction == collector->collectFunction) {
+                collector->audit = &EVENT_MONITOR_TASK_AUDIT_COLLECTORS[j];
+                break;
+            }
+        }
+        if (collector->audit != NULL && task->auditLead == NULL) {
+            task->auditLead = collector;
+        }
+        for (uint32_t j = 0; j + 1 < task->collectorsCount; j++) {
+            if (task->collectors[j].collectFunction == collector->collectFunction) {
+                collector->inFlightGuard = &task->collectors[j];
+                break;
+            }
+        }
+    }
+
+    if (!WorkerPool_Init(&task->triggeredWorkers, EVENT_MONITOR_TASK_TRIGGERED_WORKERS)) {
+        return false;
+    }
+
+    if (!WorkerPool_Init(&task->periodicWorkers, EVENT_MONITOR_TASK_PERIODIC_WORKERS)) {
+        WorkerPool_Deinit(&task->triggeredWorkers);
+        return false;
+    }
+
+    if (!EventMonitorTask_InitCollectors()) {
+        WorkerPool_Deinit(&task->periodicWorkers);
+        WorkerPool_Deinit(&task->triggeredWorkers);
+        return false;
+    }
+
+    if (!EventMonitorTask_InitAuditDispatcher(task)) {
+        EventMonitorTask_DeinitCollectors();
+        WorkerPool_Deinit(&task->periodicWorkers);
+        WorkerPool_Deinit(&task->triggeredWorkers);
+        return false;
+    }
+
+    task->auditFeedStarted = false;
+    task->isAuditFed = false;
+    task->auditExclusionsApplied = false;
+    task->appliedAuditExcludedExecutables = NULL;
+    task->appliedAuditExcludedUids = NULL;
+    task->appliedAuditExcludedAuidRanges = NULL;
+    if (LocalConfiguration_IsAuditFeedEnabled()) {
+        EventMonitorTask_StartAuditFeed(task);
+    }
+
+    return true;
 }
 
 void EventMonitorTask_Deinit(EventMonitorTask* task) {
+    // wait for the running collectors before the queues and the collectors go away
+    WorkerPool_Deinit(&task->periodicWorkers);
+    WorkerPool_Deinit(&task->triggeredWorkers);
+
+    // the feed hands its last events to the collectors, so it goes before them
+    if (task->auditFeedStarted) {
+        AuditFeed_Deinit(&task->auditFeed);
+        task->auditFeedStarted = false;
+    }
+
     task->highPriorityQueue = NULL;
     task->lowPriorityQueue = NULL;
 
     EventMonitorTask_DeinitCollectors();
+    EventMonitorTask_FreeAppliedAuditExclusions(task);
+    task->auditExclusionsApplied = false;
 }
 
 void EventMonitorTask_Execute(EventMonitorTask* task) {
+    uint64_t now = TimeUtils_GetMonotonicTimeInMilliseconds();
+    EventMonitorTask_CheckTimeBudgets(task, now);
+    if (task->auditFeedStarted) {
+        EventMonitorTask_CheckAuditFeed(task);
+    }
+    TimerWheel_Advance(&task->timerWheel, now);
 
     uint32_t periodicFrequency = 0;
     if (TwinConfiguration_GetSnapshotFrequency(&periodicFrequency) != TWIN_OK) {
         return;
     }
-    
-    time_t currentTime = TimeUtils_GetCurrentTime();
-    // time is in seconds so we convert it to milliseconds here
-    uint32_t timeDiff = TimeUtils_GetTimeDiff(currentTime, task->lastPeriodicExecution);
 
-    if (timeDiff >= periodicFrequency) {
-        task->lastPeriodicExecution = currentTime;
-        EventMonitorTask_MonitorPeriodicEvents(task);
+    uint32_t collectorTimeBudget = 0;
+    if (TwinConfiguration_GetCollectorTimeBudget(&collectorTimeBudget) == TWIN_OK) {
+        __atomic_store_n(&task->collectorTimeBudget, collectorTimeBudget, __ATOMIC_SEQ_CST);
+    }
+
+    EventMonitorTask_UpdateAuditExclusions(task);
+    EventMonitorTask_UpdateSchedules(task, periodicFrequency, LocalConfiguration_GetTriggeredEventInterval());
+}
+
+uint32_t EventMonitorTask_GetTimeToNextExecution(EventMonitorTask* task) {
+    uint64_t now = TimeUtils_GetMonotonicTimeInMilliseconds();
+    uint32_t timeToNextExecution = TimerWheel_GetTimeToNextExpiration(&task->timerWheel, now);
+    uint32_t timeToNextDeadline = EventMonitorTask_GetTimeToNextDeadline(task, now);
+    if (timeToNextDeadline < timeToNextExecution) {
+        timeToNextExecution = timeToNextDeadline;
+    }
+
+    if (timeToNextExecution == UINT32_MAX) {
+        // nothing is scheduled before the twin configuration arrives
+        return SCHEDULER_INTERVAL;
+    }
+    return timeToNextExecution;
+}
+
+static void EventMonitorTask_OnCollectorTimer(void* context) {
+    EventMonitorTaskCollector* collector = (EventMonitorTaskCollector*)context;
+    EventMonitorTask* task = collector->task;
+
+    // the interval is measured between the starts of the runs, so a slow run does not push the next ones
+    TimerWheel_Schedule(&task->timerWheel, &collector->timer, collector->interval + EventMonitorTask_GetJitter(task, collector->interval));
+
+    if (__atomic_exchange_n(&collector->inFlightGuard->inFlight, true, __ATOMIC_SEQ_CST)) {
+        Logger_Debug("Skip %s, the previous collection did not finish yet.", collector->name);
+        return;
+    }
+
+    WorkerPool* workers = collector->isPeriodic ? &task->periodicWorkers : &task->triggeredWorkers;
+    if (!WorkerPool_Submit(workers, EventMonitorTask_RunCollector, collector)) {
+        Logger_Warning("Failed to submit %s to the workers.", collector->name);
+        __atomic_store_n(&collector->inFlightGuard->inFlight, false, __ATOMIC_SEQ_CST);
     }
+}
+
+static void EventMonitorTask_RunCollector(void* context) {
+    EventMonitorTaskCollector* collector = (EventMonitorTaskCollector*)context;
+
+    collector->timeBudget = __atomic_load_n(&collector->task->collectorTimeBudget, __ATOMIC_SEQ_CST);
+    // a zero budget does not bound the run
+    uint64_t deadline = collector->timeBudget == 0 ? 0 : TimeUtils_GetMonotonicTimeInMilliseconds() + collector->timeBudget;
+    CancellationToken_Init(&collector->cancellation, deadline);
+    collector->overrunReported = false;
+    __atomic_store_n(&collector->running, true, __ATOMIC_SEQ_CST);
+    Cancellation_SetCurrentToken(&collector->cancellation);
 
-    timeDiff = TimeUtils_GetTimeDiff(currentTime, task->lastTriggeredExecution);
-    if (timeDiff >= LocalConfiguration_GetTriggeredEventInterval()) {
-        task->lastTriggeredExecution = currentTime;
-        EventMonitorTask_MonitorTriggeredEvents(task);
+    Logger_Debug("Collect %s.", collector->name);
+    if (collector->audit != NULL) {
+        EventMonitorTask_RunAuditCollectors(collector->task);
+    } else {
+        EventMonitorTask_MonitorSingleEvents(collector->task, collector->eventType, collector->collectFunction);
     }
+
+    Cancellation_SetCurrentToken(NULL);
+    __atomic_store_n(&collector->running, false, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&collector->inFlightGuard->inFlight, false, __ATOMIC_SEQ_CST);
 }
 
-static bool EventMonitorTask_MonitorPeriodicEvents(EventMonitorTask* task) {
-    //FIXME: add all periodic events
-    Logger_Debug("Collect telemetry");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_OPERATIONAL_EVENT, AgentTelemetryCollector_GetEvents)){
-        return false;
+static void EventMonitorTask_CheckTimeBudgets(EventMonitorTask* task, uint64_t now) {
+    for (uint32_t i = 0; i < task->collectorsCount; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[i];
+        if (!__atomic_load_n(&collector->running, __ATOMIC_SEQ_CST) || collector->overrunReported) {
+            continue;
+        }
+
+        uint64_t deadline = __atomic_load_n(&collector->cancellation.deadline, __ATOMIC_SEQ_CST);
+        if (deadline == 0 || now < deadline) {
+            continue;
+        }
+
+        // the collector stops at its next cancellation point, its worker is not blocked any longer than that
+        collector->overrunReported = true;
+        CancellationToken_Cancel(&collector->cancellation);
+        Logger_Warning("Collection of %s exceeded its time budget, cancelling it.", collector->name);
+
+        if (AgentTelemetryCollector_AddTimeBudgetExceededEvent(task->operationalEventsQueue, collector->name, collector->timeBudget) != EVENT_COLLECTOR_OK) {
+            Logger_Error("Failed to report the time budget overrun of %s.", collector->name);
+        }
     }
+}
 
-    Logger_Debug("Collect local users.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_LOCAL_USERS, LocalUsersCollector_GetEvents)) {
-        return false;
+static uint32_t EventMonitorTask_GetTimeToNextDeadline(EventMonitorTask* task, uint64_t now) {
+    uint32_t timeToNextDeadline = UINT32_MAX;
+    for (uint32_t i = 0; i < task->collectorsCount; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[i];
+        if (!__atomic_load_n(&collector->running, __ATOMIC_SEQ_CST) || collector->overrunReported) {
+            continue;
+        }
+
+        uint64_t deadline = __atomic_load_n(&collector->cancellation.deadline, __ATOMIC_SEQ_CST);
+        if (deadline == 0) {
+            continue;
+        }
+
+        if (deadline <= now) {
+            return 0;
+        }
+
+        if (deadline - now < timeToNextDeadline) {
+            timeToNextDeadline = (uint32_t)(deadline - now);
+        }
     }
 
-    Logger_Debug("Collect system info.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_SYSTEM_INFORMATION, SystemInformationCollector_GetEvents)) {
-        return false;
+    return timeToNextDeadline;
+}
+
+static void EventMonitorTask_UpdateSchedules(EventMonitorTask* task, uint32_t periodicFrequency, uint32_t triggeredInterval) {
+    for (uint32_t i = 0; i < task->collectorsCount; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[i];
+        uint32_t interval = EventMonitorTask_GetInterval(collector, periodicFrequency, triggeredInterval);
+        if (collector->audit != NULL) {
+            // the first audit collector runs all of them, as often as the most frequent of them
+            if (collector != task->auditLead) {
+                continue;
+            }
+
+            for (uint32_t j = 0; j < task->collectorsCount; j++) {
+                uint32_t auditInterval = EventMonitorTask_GetInterval(&task->collectors[j], periodicFrequency, triggeredInterval);
+                if (task->collectors[j].audit != NULL && auditInterval < interval) {
+                    interval = auditInterval;
+                }
+            }
+        }
+
+        if (interval == collector->interval) {
+            continue;
+        }
+
+        // the first run is spread within the jitter only, so a starting agent collects right away
+        uint32_t delay = EventMonitorTask_GetJitter(task, interval);
+        if (collector->timer.isScheduled) {
+            delay += interval;
+        }
+
+        collector->interval = interval;
+        TimerWheel_Schedule(&task->timerWheel, &collector->timer, delay);
     }
+}
 
-    Logger_Debug("Collect listening ports.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_LISTENING_PORTS, ListeningPortCollector_GetEvents)) {
-        return false;
+static uint32_t EventMonitorTask_GetInterval(const EventMonitorTaskCollector* collector, uint32_t periodicFrequency, uint32_t triggeredInterval) {
+    if (collector->configuredInterval != 0) {
+        return collector->configuredInterval;
     }
 
-    Logger_Debug("Collect firewall configuration.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_FIREWALL_CONFIGURATION, FirewallCollector_GetEvents)) {
-        return false;
+    return collector->isPeriodic ? periodicFrequency : triggeredInterval;
+}
+
+static uint32_t EventMonitorTask_GetJitter(EventMonitorTask* task, uint32_t interval) {
+    uint64_t maxJitter = (uint64_t)interval * task->jitterPercentage / 100;
+    // the interval and the jitter are added up, keep the sum within range
+    if (maxJitter > UINT32_MAX - interval) {
+        maxJitter = UINT32_MAX - interval;
     }
 
-    Logger_Debug("Collect baseline events.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_BASELINE, BaselineCollector_GetEvents)) {
-        return false;
+    if (maxJitter == 0) {
+        return 0;
     }
 
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents)) {
+    return (uint32_t)((uint64_t)rand_r(&task->randomSeed) % (maxJitter + 1));
+}
+
+static bool EventMonitorTask_GetQueue(EventMonitorTask* task, TwinConfigurationEventType eventType, SyncQueue** queue) {
+    TwinConfigurationEventPriority priority = 0;
+
+    if (TwinConfigurationEventCollectors_GetPriority(eventType, &priority) != TWIN_OK) {
         return false;
     }
 
+    *queue = NULL;
+    if (priority == EVENT_PRIORITY_OPERATIONAL){
+        *queue = task->operationalEventsQueue;
+    } else if (priority == EVENT_PRIORITY_HIGH) {
+        *queue = task->highPriorityQueue;
+    } else if (priority == EVENT_PRIORITY_LOW) {
+        *queue = task->lowPriorityQueue;
+    }
+
     return true;
 }
 
-static bool EventMonitorTask_MonitorTriggeredEvents(EventMonitorTask* task) {
-    //FIXME: add all triggered events
-    Logger_Debug("Collect configuration error events");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_OPERATIONAL_EVENT, AgentConfigurationErrorCollector_GetEvents)) {
-        return false;
+static bool EventMonitorTask_InitAuditDispatcher(EventMonitorTask* task) {
+    if (AuditSearch_MergeCheckpoints(AUDIT_CHECKPOINT_FILE, AUDIT_LEGACY_CHECKPOINT_FILES, sizeof(AUDIT_LEGACY_CHECKPOINT_FILES) / sizeof(AUDIT_LEGACY_CHECKPOINT_FILES[0])) != AUDIT_SEARCH_OK) {
+        Logger_Warning("Failed to merge the audit checkpoints of an older version.");
+    }
+    AuditDispatcher_Init(&task->auditDispatcher, AUDIT_CHECKPOINT_FILE);
+
+    for (uint32_t i = 0; i < task->collectorsCount; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[i];
+        // collectors which share a collect function share their events as well
+        if (collector->audit == NULL || collector->inFlightGuard != collector) {
+            continue;
+        }
+
+        if (collector->audit->addHandlerFunction(&task->auditDispatcher, EventMonitorTask_OnAuditEvent, collector) != EVENT_COLLECTOR_OK) {
+            Logger_Error("Failed to register %s on the audit dispatcher.", collector->name);
+            return false;
+        }
     }
 
-    Logger_Debug("Collect process create.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_PROCESS_CREATE, ProcessCreationCollector_GetEvents)) {
-        return false;
+    return true;
+}
+
+static void EventMonitorTask_RunAuditCollectors(EventMonitorTask* task) {
+    // the feed does not hand events to the collectors while they run
+    if (task->auditFeedStarted) {
+        AuditFeed_Lock(&task->auditFeed);
     }
 
-    Logger_Debug("Collect login.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_USER_LOGIN, UserLoginCollector_GetEvents)) {
-        return false;
+    if (!task->isAuditFed && AuditDispatcher_Scan(&task->auditDispatcher) != AUDIT_DISPATCHER_OK) {
+        Logger_Debug("The audit log search did not finish successfully.");
     }
 
-    Logger_Debug("Collect connection create.");
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_CONNECTION_CREATE, ConnectionCreateEventCollector_GetEvents)) {
-        return false;
+    for (uint32_t i = 0; i < task->collectorsCount; i++) {
+        EventMonitorTaskCollector* collector = &task->collectors[i];
+        if (collector->audit == NULL || collector->inFlightGuard != collector || collector->audit->flushFunction == NULL) {
+            continue;
+        }
+
+        EventMonitorTask_MonitorSingleEvents(task, collector->eventType, collector->audit->flushFunction);
     }
 
-    if (!EventMonitorTask_MonitorSingleEvents(task, EVENT_TYPE_DIAGNOSTIC, DiagnosticEventCollector_GetEvents)) {
-        return false;
+    if (task->auditFeedStarted) {
+        // the checkpoint is written here rather than by the feed, so the feed thread never changes the privileges
+        if (task->isAuditFed) {
+            AuditFeed_MoveCheckpoint(&task->auditFeed);
+        }
+        AuditFeed_Unlock(&task->auditFeed);
     }
+}
 
-    return true;
+static void EventMonitorTask_StartAuditFeed(EventMonitorTask* task) {
+    if (AuditFeed_Init(&task->auditFeed, LocalConfiguration_GetAuditFeedSocketPath(), &task->auditDispatcher) != AUDIT_FEED_OK) {
+        Logger_Warning("Failed to connect to the audit feed, keep searching the audit logs.");
+        return;
+    }
+
+    if (AuditFeed_Start(&task->auditFeed) != AUDIT_FEED_OK) {
+        Logger_Warning("Failed to start the audit feed, keep searching the audit logs.");
+        AuditFeed_Deinit(&task->auditFeed);
+        return;
+    }
+
+    task->auditFeedStarted = true;
+    task->isAuditFed = true;
+    Logger_Information("Audit events are fed by the audit feed.");
+}
+
+static void EventMonitorTask_CheckAuditFeed(EventMonitorTask* task) {
+    if (AuditFeed_IsRunning(&task->auditFeed)) {
+        return;
+    }
+
+    AuditFeed_Lock(&task->auditFeed);
+    bool wasFed = task->isAuditFed;
+    task->isAuditFed = false;
+    AuditFeed_Unlock(&task->auditFeed);
+
+    if (wasFed) {
+        Logger_Warning("The audit feed stopped, going back to searching the audit logs.");
+    }
+}
+
+static void EventMonitorTask_UpdateAuditExclusions(EventMonitorTask* task) {
+    char* executables = NULL;
+    char* uids = NULL;
+    char* auidRanges = NULL;
+    AuditControlExclusions exclusions;
+
+    if (TwinConfiguration_GetAuditExcludedExecutables(&executables) != TWIN_OK ||
+        TwinConfiguration_GetAuditExcludedUids(&uids) != TWIN_OK ||
+        TwinConfiguration_GetAuditExcludedAuidRanges(&auidRanges) != TWIN_OK) {
+        goto cleanup;
+    }
+
+    // the first application also replaces the exclusions left by an earlier run of the agent
+    if (task->auditExclusionsApplied &&
+        EventMonitorTask_IsAuditExclusionUnchanged(task->appliedAuditExcludedExecutables, executables) &&
+        EventMonitorTask_IsAuditExclusionUnchanged(task->appliedAuditExcludedUids, uids) &&
+        EventMonitorTask_IsAuditExclusionUnchanged(task->appliedAuditExcludedAuidRanges, auidRanges)) {
+        goto cleanup;
+    }
+
+    exclusions.executables = executables;
+    exclusions.uids = uids;
+    exclusions.auidRanges = auidRanges;
+    // the collectors take root through AuditControl_Init, which holds the shared privileges of ProcessInfoHandler,
+    // so a collector which runs meanwhile keeps its own privileges
+    for (uint32_t i = 0; i < sizeof(EVENT_MONITOR_TASK_AUDIT_COLLECTORS) / sizeof(EVENT_MONITOR_TASK_AUDIT_COLLECTORS[0]); i++) {
+        AuditExclusionsFunc setExclusionsFunction = EVENT_MONITOR_TASK_AUDIT_COLLECTORS[i].setExclusionsFunction;
+        if (setExclusionsFunction != NULL && setExclusionsFunction(&exclusions) != EVENT_COLLECTOR_OK) {
+            Logger_Warning("Failed to apply some of the audit exclusions.");
+        }
+    }
+
+    // the task keeps the lists, so they are not freed on cleanup
+    EventMonitorTask_FreeAppliedAuditExclusions(task);
+    task->appliedAuditExcludedExecutables = executables;
+    task->appliedAuditExcludedUids = uids;
+    task->appliedAuditExcludedAuidRanges = auidRanges;
+    executables = NULL;
+    uids = NULL;
+    auidRanges = NULL;
+    task->auditExclusionsApplied = true;
+
+cleanup:
+    if (executables != NULL) {
+        free(executables);
+    }
+
+    if (uids != NULL) {
+        free(uids);
+    }
+
+    if (auidRanges != NULL) {
+        free(auidRanges);
+    }
+}
+
+static bool EventMonitorTask_IsAuditExclusionUnchanged(const char* applied, const char* current) {
+    return strcmp(applied != NULL ? applied : "", current != NULL ? current : "") == 0;
+}
+
+static void EventMonitorTask_FreeAppliedAuditExclusions(EventMonitorTask* task) {
+    if (task->appliedAuditExcludedExecutables != NULL) {
+        free(task->appliedAuditExcludedExecutables);
+        task->appliedAuditExcludedExecutables = NULL;
+    }
+
+    if (task->appliedAuditExcludedUids != NULL) {
+        free(task->appliedAuditExcludedUids);
+        task->appliedAuditExcludedUids = NULL;
+    }
+
+    if (task->appliedAuditExcludedAuidRanges != NULL) {
+        free(task->appliedAuditExcludedAuidRanges);
+        task->appliedAuditExcludedAuidRanges = NULL;
+    }
+}
+
+static void EventMonitorTask_OnAuditEvent(AuditSearch* auditSearch, void* context) {
+    EventMonitorTaskCollector* collector = (EventMonitorTaskCollector*)context;
+
+    SyncQueue* queue = NULL;
+    if (!EventMonitorTask_GetQueue(collector->task, collector->eventType, &queue) || queue == NULL) {
+        return;
+    }
+
+    EventCollectorResult result = collector->audit->handleEventFunction(auditSearch, queue);
+    if (result == EVENT_COLLECTOR_EXCEPTION || result == EVENT_COLLECTOR_RECORD_HAS_ERRORS) {
+        Logger_Debug("Failed to handle an audit event of %s.", collector->name);
+    }
 }
 
 static bool EventMonitorTask_MonitorSingleEvents(EventMonitorTask* task, TwinConfigurationEventType eventType, EventCollectorFunc collectFunction) {
-    TwinConfigurationEventPriority priority = 0;
+    SyncQueue* queue = NULL;
 
-    if (TwinConfigurationEventCollectors_GetPriority(eventType, &priority) != TWIN_OK) {
+    if (!EventMonitorTask_GetQueue(task, eventType, &queue)) {
         return false;
     }
 
     EventCollectorResult result = EVENT_COLLECTOR_OK;
-    if (priority == EVENT_PRIORITY_OPERATIONAL){
-        result = collectFunction(task->operationalEventsQueue);
-    } else if (priority == EVENT_PRIORITY_HIGH) {
-        result = collectFunction(task->highPriorityQueue);
-    } else if (priority == EVENT_PRIORITY_LOW) {
-        result = collectFunction(task->lowPriorityQueue);
+    if (queue != NULL) {
+        result = collectFunction(queue);
     }
 
     if (result == EVENT_COLLECTOR_OK) {
@@ -9,20 +9,40 @@
 #include "internal/time_utils.h"
 #include "logger.h"
 #include "memory_monitor.h"
+#include "message_compressor.h"
 #include "message_serializer.h"
 #include "twin_configuration.h"
 
 /**
- * @brief Dequeue all the events in the queue and send them to the hub
+ * @brief Dequeue the events in the queue and send them to the hub.
+ *        Messages are sent until the main queue is empty or the published bytes limit is reached,
+ *        a single message is always sent if the main queue has events.
+ * 
+ * @param   task                The task instance.
+ * @param   mainQueue           The main message queue.
+ * @param   paddingQueue        A queue to add messages from in case the main queue does not have enough data.
+ * @param   maxPublishedBytes   The amount of bytes which may be published in the current execution.
+ * @param   encoding            The encoding of the messages.
+ * @param   compress            Whether to compress the messages.
+ * @param   publishedBytes      In out param. The amount of bytes published in the current execution.
+ * 
+ * @return true on success, false otherwise.
+ */
+bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, uint32_t maxPublishedBytes, MessageSerializerEncoding encoding, bool compress, uint64_t* publishedBytes);
+
+/**
+ * @brief Create a single message out of the given queues and send it to the hub.
  * 
  * @param   task            The task instance.
  * @param   mainQueue       The main message queue.
  * @param   paddingQueue    A queue to add messages from in case the main queue does not have enough data.
+ * @param   encoding        The encoding of the message.
+ * @param   compress        Whether to compress the message.
+ * @param   messageSize     Out param. The size of the message sent, 0 if there were no events to send.
  * 
  * @return true on success, false otherwise.
  */
-
-bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue);
+static bool EventPublisherTask_SendSingleMessage(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, MessageSerializerEncoding encoding, bool compress, uint32_t* messageSize);
 
 bool EventPublisherTask_Init(EventPublisherTask* task, SyncQueue* highPriorityEventQueue, SyncQueue* lowPriorityEventQueue, SyncQueue* operationalEventsQueue, IoTHubAdapter* iothubAdapter) {
     task->operationalEventsQueue = operationalEventsQueue;
@@ -57,17 +77,35 @@ void EventPublisherTask_Execute(EventPublisherTask* task) {
         return;
     }
     
+    uint32_t maxPublishedBytes = 0;
+    if (TwinConfiguration_GetMaxPublishedBytesPerCycle(&maxPublishedBytes) != TWIN_OK) {
+        return;
+    }
+    
+    bool compressMessages = false;
+    if (TwinConfiguration_GetCompressMessages(&compressMessages) != TWIN_OK) {
+        return;
+    }
+
+    bool encodeMessagesAsCbor = false;
+    if (TwinConfiguration_GetEncodeMessagesAsCbor(&encodeMessagesAsCbor) != TWIN_OK) {
+        return;
+    }
+    MessageSerializerEncoding encoding = encodeMessagesAsCbor ? MESSAGE_SERIALIZER_ENCODING_CBOR : MESSAGE_SERIALIZER_ENCODING_JSON;
+    
     uint32_t currentMemoryConsumption = 0;
     if (MemoryMonitor_CurrentConsumption(&currentMemoryConsumption) != MEMORY_MONITOR_OK) {
         return;
     }
 
     time_t currentTime = TimeUtils_GetCurrentTime();
+    // the limit is shared by all the queues sent in this execution
+    uint64_t publishedBytes = 0;
 
     if (currentMemoryConsumption > maxMessageSize) {
         // If we got to the max message size in the queue, we are sending the message as high priority even if there
         // weren't any actual high priority events
-        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue, maxPublishedBytes, encoding, compressMessages, &publishedBytes);
         task->highPriorityQueueLastExecution = currentTime;
     }
 
@@ -76,41 +114,70 @@ void EventPublisherTask_Execute(EventPublisherTask* task) {
     uint32_t lowPriorityQueueTimeDiff = TimeUtils_GetTimeDiff(currentTime, task->lowPriorityQueueLastExecution);
     
     if (highPriorityQueueTimeDiff > highPriorityQueueFrequency) {
-        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->highPriorityEventQueue, task->lowPriorityEventQueue, maxPublishedBytes, encoding, compressMessages, &publishedBytes);
         task->highPriorityQueueLastExecution = currentTime;
     }
     
     if (lowPriorityQueueTimeDiff > lowPriorityQueueFrequency) {
-        EventPublisherTask_SendEvents(task, task->lowPriorityEventQueue, task->highPriorityEventQueue);
+        EventPublisherTask_SendEvents(task, task->lowPriorityEventQueue, task->highPriorityEventQueue, maxPublishedBytes, encoding, compressMessages, &publishedBytes);
         task->lowPriorityQueueLastExecution = currentTime;
     }
 }
 
-bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue) {
-    void* buffer = NULL;
-    bool result = true;
-
+bool EventPublisherTask_SendEvents(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, uint32_t maxPublishedBytes, MessageSerializerEncoding encoding, bool compress, uint64_t* publishedBytes) {
     uint32_t queueSize = 0;
     if (SyncQueue_GetSize(mainQueue, &queueSize) != QUEUE_OK){
         return false;
     }
 
-    if (queueSize == 0){
-        return true;
+    bool isFirstMessage = true;
+    while (queueSize > 0 && (isFirstMessage || *publishedBytes < maxPublishedBytes)) {
+        isFirstMessage = false;
+
+        uint32_t messageSize = 0;
+        if (!EventPublisherTask_SendSingleMessage(task, mainQueue, paddingQueue, encoding, compress, &messageSize)) {
+            return false;
+        }
+
+        if (messageSize == 0) {
+            // the events left in the queue do not fit in a message
+            break;
+        }
+        *publishedBytes += messageSize;
+
+        if (SyncQueue_GetSize(mainQueue, &queueSize) != QUEUE_OK){
+            return false;
+        }
     }
 
+    return true;
+}
+
+static bool EventPublisherTask_SendSingleMessage(EventPublisherTask* task, SyncQueue* mainQueue, SyncQueue* paddingQueue, MessageSerializerEncoding encoding, bool compress, uint32_t* messageSize) {
+    void* buffer = NULL;
+    uint32_t size = 0;
+    bool result = true;
+    *messageSize = 0;
+
     SyncQueue* queuesOrder[] = {task->operationalEventsQueue, mainQueue, paddingQueue};
-    MessageSerializerResultValues serializationResult = MessageSerializer_CreateSecurityMessage(queuesOrder, 3, &buffer);
+    MessageSerializerResultValues serializationResult = MessageSerializer_CreateSecurityMessage(queuesOrder, 3, encoding, compress, &buffer, &size);
+    if (serializationResult == MESSAGE_SERIALIZER_EMPTY) {
+        return true;
+    }
+
     if (serializationResult != MESSAGE_SERIALIZER_OK && serializationResult != MESSAGE_SERIALIZER_PARTIAL) {
         return false;
     }
 
     if (buffer != NULL) {
-        uint32_t size = strlen(buffer);
-        if (!IoTHubAdapter_SendMessageAsync(task->iothubAdapter, buffer, size)) {
+        const char* contentType = (encoding == MESSAGE_SERIALIZER_ENCODING_CBOR) ? MESSAGE_SERIALIZER_CBOR_CONTENT_TYPE : NULL;
+        const char* contentEncoding = compress ? MESSAGE_COMPRESSOR_CONTENT_ENCODING : NULL;
+        if (!IoTHubAdapter_SendMessageAsync(task->iothubAdapter, buffer, size, contentType, contentEncoding)) {
                 //FIXME: do we want to stop sedning message in this case?
                 result = false;
                 Logger_Error("error sending a message to the hub");
+        } else {
+            *messageSize = size;
         }
         
         free(buffer);
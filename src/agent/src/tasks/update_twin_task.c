@@ -21,9 +21,16 @@ static bool UpdateTwinTask_UpdateTwinReportedProperties(IoTHubAdapter* iothubCli
 bool UpdateTwinTask_Init(UpdateTwinTask* task, SyncQueue* updateQueue, IoTHubAdapter* client) {
     task->updateQueue = updateQueue;
     task->iothubClient = client;
+    task->configurationListener = NULL;
+    task->configurationListenerContext = NULL;
     return true;
 }
 
+void UpdateTwinTask_SetConfigurationListener(UpdateTwinTask* task, UpdateTwinTaskConfigurationListener listener, void* context) {
+    task->configurationListenerContext = context;
+    task->configurationListener = listener;
+}
+
 void UpdateTwinTask_Deinit(UpdateTwinTask* task) {
     void* currentData;
     uint32_t currentDataSize;
@@ -51,8 +58,6 @@ cleanup:
 }
 
 void UpdateTwinTask_Execute(UpdateTwinTask* task) {
-    //FIXME: we need to have a select for the queue?
-
     bool success = true;
     UpdateTwinTaskItem* workItem = NULL;
 
@@ -93,6 +98,8 @@ void UpdateTwinTask_Execute(UpdateTwinTask* task) {
         if (updateResult != TWIN_PARSE_EXCEPTION) {
             goto cleanup; // else configuration is valid
         }
+    } else if (task->configurationListener != NULL) {
+        task->configurationListener(task->configurationListenerContext);
     }
 
     if (UpdateTwinTask_UpdateTwinReportedProperties(task->iothubClient) == false) {
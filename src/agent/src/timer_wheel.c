@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "timer_wheel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TIMER_WHEEL_SLOTS_MASK (TIMER_WHEEL_NUMBER_OF_SLOTS - 1)
+
+/**
+ * @brief Appends the entry to the slot of its expiration tick, entries of the same slot expire in scheduling order.
+ *
+ * @param   wheel   The timer wheel.
+ * @param   entry   The entry to append.
+ */
+static void TimerWheel_AppendToSlot(TimerWheel* wheel, TimerWheelEntry* entry);
+
+static void TimerWheel_AppendToSlot(TimerWheel* wheel, TimerWheelEntry* entry) {
+    TimerWheelEntry** current = &wheel->slots[entry->expirationTick & TIMER_WHEEL_SLOTS_MASK];
+    while (*current != NULL) {
+        current = &(*current)->next;
+    }
+
+    entry->next = NULL;
+    *current = entry;
+}
+
+void TimerWheel_Init(TimerWheel* wheel, uint32_t tickInMilliseconds, uint64_t now) {
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->tickInMilliseconds = tickInMilliseconds == 0 ? 1 : tickInMilliseconds;
+    wheel->currentTick = now / wheel->tickInMilliseconds;
+}
+
+void TimerWheel_InitEntry(TimerWheelEntry* entry, TimerWheelCallback callback, void* context) {
+    entry->callback = callback;
+    entry->context = context;
+    entry->expirationTick = 0;
+    entry->isScheduled = false;
+    entry->next = NULL;
+}
+
+void TimerWheel_Schedule(TimerWheel* wheel, TimerWheelEntry* entry, uint32_t delay) {
+    TimerWheel_Cancel(wheel, entry);
+
+    uint64_t delayInTicks = ((uint64_t)delay + wheel->tickInMilliseconds - 1) / wheel->tickInMilliseconds;
+    // the current tick was already processed, the earliest expiration is the next one
+    if (delayInTicks == 0) {
+        delayInTicks = 1;
+    }
+
+    entry->expirationTick = wheel->currentTick + delayInTicks;
+    entry->isScheduled = true;
+    TimerWheel_AppendToSlot(wheel, entry);
+}
+
+void TimerWheel_Cancel(TimerWheel* wheel, TimerWheelEntry* entry) {
+    if (!entry->isScheduled) {
+        return;
+    }
+
+    TimerWheelEntry** current = &wheel->slots[entry->expirationTick & TIMER_WHEEL_SLOTS_MASK];
+    while (*current != NULL) {
+        if (*current == entry) {
+            *current = entry->next;
+            break;
+        }
+        current = &(*current)->next;
+    }
+
+    entry->next = NULL;
+    entry->isScheduled = false;
+}
+
+void TimerWheel_Advance(TimerWheel* wheel, uint64_t now) {
+    uint64_t targetTick = now / wheel->tickInMilliseconds;
+    if (targetTick <= wheel->currentTick) {
+        return;
+    }
+
+    // after a long stall every slot is visited once, there is no point in going around the wheel again
+    uint64_t ticksToProcess = targetTick - wheel->currentTick;
+    if (ticksToProcess > TIMER_WHEEL_NUMBER_OF_SLOTS) {
+        ticksToProcess = TIMER_WHEEL_NUMBER_OF_SLOTS;
+    }
+
+    // detach all the expired entries first, so the callbacks are free to schedule entries again
+    TimerWheelEntry* expiredHead = NULL;
+    TimerWheelEntry** expiredTail = &expiredHead;
+    for (uint64_t i = 1; i <= ticksToProcess; i++) {
+        TimerWheelEntry** current = &wheel->slots[(wheel->currentTick + i) & TIMER_WHEEL_SLOTS_MASK];
+        while (*current != NULL) {
+            TimerWheelEntry* entry = *current;
+            if (entry->expirationTick > targetTick) {
+                // the entry expires in one of the next rounds of the wheel
+                current = &entry->next;
+                continue;
+            }
+
+            *current = entry->next;
+            entry->next = NULL;
+            *expiredTail = entry;
+            expiredTail = &entry->next;
+        }
+    }
+    wheel->currentTick = targetTick;
+
+    while (expiredHead != NULL) {
+        TimerWheelEntry* entry = expiredHead;
+        expiredHead = entry->next;
+        entry->next = NULL;
+        entry->isScheduled = false;
+        entry->callback(entry->context);
+    }
+}
+
+uint32_t TimerWheel_GetTimeToNextExpiration(TimerWheel* wheel, uint64_t now) {
+    bool found = false;
+    uint64_t nextExpirationTick = 0;
+    for (uint32_t i = 0; i < TIMER_WHEEL_NUMBER_OF_SLOTS; i++) {
+        for (TimerWheelEntry* entry = wheel->slots[i]; entry != NULL; entry = entry->next) {
+            if (!found || entry->expirationTick < nextExpirationTick) {
+                nextExpirationTick = entry->expirationTick;
+                found = true;
+            }
+        }
+    }
+
+    if (!found) {
+        return UINT32_MAX;
+    }
+
+    uint64_t nextExpiration = nextExpirationTick * wheel->tickInMilliseconds;
+    if (nextExpiration <= now) {
+        return 0;
+    }
+
+    uint64_t timeToNextExpiration = nextExpiration - now;
+    return timeToNextExpiration > UINT32_MAX ? UINT32_MAX : (uint32_t)timeToNextExpiration;
+}
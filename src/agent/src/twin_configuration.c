@@ -26,11 +26,20 @@ typedef struct _TwinConfiguration {
     uint32_t lowPriorityMessageFrequency;
     uint32_t highPriorityMessageFrequency;
     uint32_t snapshotFrequency;
+    bool evictLowPriorityEvents;
+    uint32_t collectorTimeBudget;
+    uint32_t maxPublishedBytesPerCycle;
+    bool compressMessages;
+    bool encodeMessagesAsCbor;
     
     bool baselineCustomChecksEnabled;
     char* baselineCustomChecksFilePath;
     char* baselineCustomChecksFileHash;
 
+    char* auditExcludedExecutables;
+    char* auditExcludedUids;
+    char* auditExcludedAuidRanges;
+
     LOCK_HANDLE lock;
 } TwinConfiguration;
 
@@ -80,6 +89,17 @@ static TwinConfigurationResult TwinConfiguration_GetFieldBool(bool* value, bool
  */
 static TwinConfigurationResult TwinConfiguration_GetFieldString(char** value, char* field);
 
+/**
+ * @brief   copies the value of a given twin configuration in a thread safe manner (currently using a lock),
+ *          the copy stays valid once the twin is updated
+ * 
+ * @param   value       out param: a copy of the value, NULL if the value is not set, to be freed by the caller
+ * @param   field       the field of the twin, read under the lock
+ * 
+ * @return  TWIN_OK     on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfiguration_CopyFieldString(char** value, char* const* field);
+
 TwinConfigurationResult TwinConfiguration_Init();
 
 TwinConfigurationResult TwinConfiguration_DeepCopy(TwinConfiguration* dest, TwinConfiguration* src);
@@ -104,6 +124,11 @@ TwinConfigurationResult TwinConfiguration_Init() {
     twinConfiguration.lowPriorityMessageFrequency = DEFAULT_LOW_PRIORITY_MESSAGE_FREQUENCY;
     twinConfiguration.highPriorityMessageFrequency = DEFAULT_HIGH_PRIORITY_MESSAGE_FREQUENCY;
     twinConfiguration.snapshotFrequency = DEFAULT_SNAPSHOT_FREQUENCY;
+    twinConfiguration.evictLowPriorityEvents = DEFAULT_EVICT_LOW_PRIORITY_EVENTS;
+    twinConfiguration.collectorTimeBudget = DEFAULT_COLLECTOR_TIME_BUDGET;
+    twinConfiguration.maxPublishedBytesPerCycle = DEFAULT_MAX_PUBLISHED_BYTES_PER_CYCLE;
+    twinConfiguration.compressMessages = DEFAULT_COMPRESS_MESSAGES;
+    twinConfiguration.encodeMessagesAsCbor = DEFAULT_ENCODE_MESSAGES_AS_CBOR;
 
     twinConfiguration.baselineCustomChecksEnabled = DEFAULT_BASELINE_CUSTOM_CHECKS_ENABLED;
     if (Utils_DuplicateString(&twinConfiguration.baselineCustomChecksFilePath, DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_PATH) == ACTION_MEMORY_EXCEPTION) {
@@ -115,6 +140,21 @@ TwinConfigurationResult TwinConfiguration_Init() {
         returnValue = TWIN_MEMORY_EXCEPTION;
         goto cleanup;
     }
+
+    if (Utils_DuplicateString(&twinConfiguration.auditExcludedExecutables, DEFAULT_AUDIT_EXCLUDED_EXECUTABLES) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (Utils_DuplicateString(&twinConfiguration.auditExcludedUids, DEFAULT_AUDIT_EXCLUDED_UIDS) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (Utils_DuplicateString(&twinConfiguration.auditExcludedAuidRanges, DEFAULT_AUDIT_EXCLUDED_AUID_RANGES) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
     twinConfigurationObjectName = LocalConfiguration_GetRemoteConfigurationObjectName();
 
     returnValue = TwinConfigurationEventCollectors_Init();
@@ -141,6 +181,11 @@ TwinConfigurationResult TwinConfiguration_DeepCopy(TwinConfiguration* dest, Twin
     dest->lowPriorityMessageFrequency = src->lowPriorityMessageFrequency;
     dest->highPriorityMessageFrequency = src->highPriorityMessageFrequency;
     dest->snapshotFrequency = src->snapshotFrequency;
+    dest->evictLowPriorityEvents = src->evictLowPriorityEvents;
+    dest->collectorTimeBudget = src->collectorTimeBudget;
+    dest->maxPublishedBytesPerCycle = src->maxPublishedBytesPerCycle;
+    dest->compressMessages = src->compressMessages;
+    dest->encodeMessagesAsCbor = src->encodeMessagesAsCbor;
 
     dest->baselineCustomChecksEnabled = src->baselineCustomChecksEnabled;
 
@@ -154,6 +199,21 @@ TwinConfigurationResult TwinConfiguration_DeepCopy(TwinConfiguration* dest, Twin
         goto cleanup;
     }
 
+    if (Utils_DuplicateString(&(dest->auditExcludedExecutables), src->auditExcludedExecutables) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (Utils_DuplicateString(&(dest->auditExcludedUids), src->auditExcludedUids) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
+
+    if (Utils_DuplicateString(&(dest->auditExcludedAuidRanges), src->auditExcludedAuidRanges) == ACTION_MEMORY_EXCEPTION) {
+        returnValue = TWIN_MEMORY_EXCEPTION;
+        goto cleanup;
+    }
+
 cleanup:
     return returnValue;
 }
@@ -168,6 +228,21 @@ void TwinConfiguration_SafeDeinit() {
         free(twinConfiguration.baselineCustomChecksFileHash);
         memcpy(&twinConfiguration.baselineCustomChecksFileHash, &DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH, sizeof(char*));
     }
+
+    if (twinConfiguration.auditExcludedExecutables != NULL) {
+        free(twinConfiguration.auditExcludedExecutables);
+        memcpy(&twinConfiguration.auditExcludedExecutables, &DEFAULT_AUDIT_EXCLUDED_EXECUTABLES, sizeof(char*));
+    }
+
+    if (twinConfiguration.auditExcludedUids != NULL) {
+        free(twinConfiguration.auditExcludedUids);
+        memcpy(&twinConfiguration.auditExcludedUids, &DEFAULT_AUDIT_EXCLUDED_UIDS, sizeof(char*));
+    }
+
+    if (twinConfiguration.auditExcludedAuidRanges != NULL) {
+        free(twinConfiguration.auditExcludedAuidRanges);
+        memcpy(&twinConfiguration.auditExcludedAuidRanges, &DEFAULT_AUDIT_EXCLUDED_AUID_RANGES, sizeof(char*));
+    }
 }
 
 void TwinConfiguration_Deinit() {
@@ -279,6 +354,26 @@ TwinConfigurationResult TwinConfiguration_GetSnapshotFrequency(uint32_t* snapsho
     return TwinConfiguration_GetFieldInteger(snapshotFrequency, twinConfiguration.snapshotFrequency);
 }
 
+TwinConfigurationResult TwinConfiguration_GetEvictLowPriorityEvents(bool* evictLowPriorityEvents) {
+    return TwinConfiguration_GetFieldBool(evictLowPriorityEvents, twinConfiguration.evictLowPriorityEvents);
+}
+
+TwinConfigurationResult TwinConfiguration_GetCollectorTimeBudget(uint32_t* collectorTimeBudget) {
+    return TwinConfiguration_GetFieldInteger(collectorTimeBudget, twinConfiguration.collectorTimeBudget);
+}
+
+TwinConfigurationResult TwinConfiguration_GetMaxPublishedBytesPerCycle(uint32_t* maxPublishedBytesPerCycle) {
+    return TwinConfiguration_GetFieldInteger(maxPublishedBytesPerCycle, twinConfiguration.maxPublishedBytesPerCycle);
+}
+
+TwinConfigurationResult TwinConfiguration_GetCompressMessages(bool* compressMessages) {
+    return TwinConfiguration_GetFieldBool(compressMessages, twinConfiguration.compressMessages);
+}
+
+TwinConfigurationResult TwinConfiguration_GetEncodeMessagesAsCbor(bool* encodeMessagesAsCbor) {
+    return TwinConfiguration_GetFieldBool(encodeMessagesAsCbor, twinConfiguration.encodeMessagesAsCbor);
+}
+
 TwinConfigurationResult TwinConfiguration_GetBaselineCustomChecksEnabled(bool* baselineCustomChecksEnabled) {
     return TwinConfiguration_GetFieldBool(baselineCustomChecksEnabled, twinConfiguration.baselineCustomChecksEnabled);
 }
@@ -291,6 +386,18 @@ TwinConfigurationResult TwinConfiguration_GetBaselineCustomChecksFileHash(char**
     return TwinConfiguration_GetFieldString(baselineCustomChecksFileHash, twinConfiguration.baselineCustomChecksFileHash);
 }
 
+TwinConfigurationResult TwinConfiguration_GetAuditExcludedExecutables(char** auditExcludedExecutables) {
+    return TwinConfiguration_CopyFieldString(auditExcludedExecutables, &twinConfiguration.auditExcludedExecutables);
+}
+
+TwinConfigurationResult TwinConfiguration_GetAuditExcludedUids(char** auditExcludedUids) {
+    return TwinConfiguration_CopyFieldString(auditExcludedUids, &twinConfiguration.auditExcludedUids);
+}
+
+TwinConfigurationResult TwinConfiguration_GetAuditExcludedAuidRanges(char** auditExcludedAuidRanges) {
+    return TwinConfiguration_CopyFieldString(auditExcludedAuidRanges, &twinConfiguration.auditExcludedAuidRanges);
+}
+
 static TwinConfigurationResult TwinConfiguration_SetSingleUintValueFromJsonOrDefault(uint32_t* value, uint32_t defaultValue, JsonObjectReaderHandle reader, const char* key, bool isTime, TwinConfigurationStatus* outStatus) {
     *outStatus = CONFIGURATION_OK;
     TwinConfigurationResult result;
@@ -390,6 +497,46 @@ static TwinConfigurationResult TwinConfiguration_ExtractConfiguration(JsonObject
         goto cleanup;
     }
 
+    currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->evictLowPriorityEvents), DEFAULT_EVICT_LOW_PRIORITY_EVENTS, jsonReader, EVICT_LOW_PRIORITY_EVENTS_KEY, &(parsingResult->evictLowPriorityEvents));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleUintValueFromJsonOrDefault(&(newConfiguration->collectorTimeBudget), DEFAULT_COLLECTOR_TIME_BUDGET, jsonReader, COLLECTOR_TIME_BUDGET_KEY, true, &(parsingResult->collectorTimeBudget));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleUintValueFromJsonOrDefault(&(newConfiguration->maxPublishedBytesPerCycle), DEFAULT_MAX_PUBLISHED_BYTES_PER_CYCLE, jsonReader, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, false, &(parsingResult->maxPublishedBytesPerCycle));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->compressMessages), DEFAULT_COMPRESS_MESSAGES, jsonReader, COMPRESS_MESSAGES_KEY, &(parsingResult->compressMessages));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->encodeMessagesAsCbor), DEFAULT_ENCODE_MESSAGES_AS_CBOR, jsonReader, ENCODE_MESSAGES_AS_CBOR_KEY, &(parsingResult->encodeMessagesAsCbor));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
     currentKeyResult = TwinConfiguration_SetSingleBoolValueFromJsonOrDefault(&(newConfiguration->baselineCustomChecksEnabled), DEFAULT_BASELINE_CUSTOM_CHECKS_ENABLED, jsonReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, &(parsingResult->baselineCustomChecksEnabled));
     if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
         result = currentKeyResult;
@@ -414,6 +561,30 @@ static TwinConfigurationResult TwinConfiguration_ExtractConfiguration(JsonObject
         goto cleanup;
     }
 
+    currentKeyResult = TwinConfiguration_SetSingleStringValueFromJsonOrDefault(&(newConfiguration->auditExcludedExecutables), DEFAULT_AUDIT_EXCLUDED_EXECUTABLES, jsonReader, AUDIT_EXCLUDED_EXECUTABLES_KEY, &(parsingResult->auditExcludedExecutables));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleStringValueFromJsonOrDefault(&(newConfiguration->auditExcludedUids), DEFAULT_AUDIT_EXCLUDED_UIDS, jsonReader, AUDIT_EXCLUDED_UIDS_KEY, &(parsingResult->auditExcludedUids));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
+    currentKeyResult = TwinConfiguration_SetSingleStringValueFromJsonOrDefault(&(newConfiguration->auditExcludedAuidRanges), DEFAULT_AUDIT_EXCLUDED_AUID_RANGES, jsonReader, AUDIT_EXCLUDED_AUID_RANGES_KEY, &(parsingResult->auditExcludedAuidRanges));
+    if (currentKeyResult == TWIN_PARSE_EXCEPTION) {
+        result = currentKeyResult;
+    } else if (currentKeyResult != TWIN_OK) {
+        result = currentKeyResult;
+        goto cleanup;
+    }
+
 cleanup:
     return result;
 }
@@ -460,6 +631,28 @@ static TwinConfigurationResult TwinConfiguration_GetFieldString(char** value, ch
     return TWIN_OK;
 }
 
+static TwinConfigurationResult TwinConfiguration_CopyFieldString(char** value, char* const* field) {
+    TwinConfigurationResult result = TWIN_OK;
+
+    if (Lock(twinConfiguration.lock) != LOCK_OK) {
+        return TWIN_LOCK_EXCEPTION;
+    }
+
+    if (Utils_DuplicateString(value, *field) != ACTION_OK) {
+        result = TWIN_MEMORY_EXCEPTION;
+    }
+
+    if (Unlock(twinConfiguration.lock) != LOCK_OK) {
+        if (*value != NULL) {
+            free(*value);
+            *value = NULL;
+        }
+        return TWIN_LOCK_EXCEPTION;
+    }
+
+    return result;
+}
+
 void TwinConfiguration_GetLastTwinUpdateData(TwinConfigurationUpdateResult* outResult) {
     if (outResult == NULL) {
         return;
@@ -529,6 +722,36 @@ TwinConfigurationResult TwinConfiguration_GetSerializedTwinConfiguration(char**
         goto cleanup;
     }
 
+    result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, EVICT_LOW_PRIORITY_EVENTS_KEY, twinConfiguration.evictLowPriorityEvents);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    if (TimeUtils_MillisecondsToISO8601DurationString(twinConfiguration.collectorTimeBudget, timeSpan, sizeof(timeSpan)) == false) {
+        result = TWIN_EXCEPTION;
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(configurationObject, COLLECTOR_TIME_BUDGET_KEY, timeSpan);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteUintConfigurationToJson(configurationObject, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, twinConfiguration.maxPublishedBytesPerCycle);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, COMPRESS_MESSAGES_KEY, twinConfiguration.compressMessages);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, ENCODE_MESSAGES_AS_CBOR_KEY, twinConfiguration.encodeMessagesAsCbor);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
     result = TwinConfigurationUtils_WriteBoolConfigurationToJson(configurationObject, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, twinConfiguration.baselineCustomChecksEnabled);
     if (result != TWIN_OK) {
         goto cleanup;
@@ -544,6 +767,21 @@ TwinConfigurationResult TwinConfiguration_GetSerializedTwinConfiguration(char**
         goto cleanup;
     }
 
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(configurationObject, AUDIT_EXCLUDED_EXECUTABLES_KEY, twinConfiguration.auditExcludedExecutables);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(configurationObject, AUDIT_EXCLUDED_UIDS_KEY, twinConfiguration.auditExcludedUids);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(configurationObject, AUDIT_EXCLUDED_AUID_RANGES_KEY, twinConfiguration.auditExcludedAuidRanges);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
     result = TwinConfigurationEventCollectors_GetPrioritiesJson(configurationObject);
     if (result != TWIN_OK){
         goto cleanup;
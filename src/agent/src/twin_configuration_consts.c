@@ -5,7 +5,11 @@
 #define EVENT_PRIO_PREFIX "eventPriority"
 #define EVENT_AGG_ENABLED_PREFIX "aggregationEnabled"
 #define EVENT_AGG_INTERVAL_PREFIX "aggregationInterval"
+#define EVENT_AGG_MAX_ENTRIES_PREFIX "aggregationMaxEntries"
+#define EVENT_AGG_KEY_FIELDS_PREFIX "aggregationKeyFields"
+#define EVENT_AGG_KEY_NORMALIZERS_PREFIX "aggregationKeyNormalizers"
 #define BASELINE_CUSTOM_CHECKS_PREFIX "baselineCustomChecks"
+#define AUDIT_EXCLUDED_PREFIX "auditExcluded"
 
 /* ===== Twin configuration Schema =====*/
 const char* LOW_PRIORITY_MESSAGE_FREQUENCY_KEY = "lowPriorityMessageFrequency";
@@ -13,6 +17,11 @@ const char* HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY = "highPriorityMessageFrequency"
 const char* MAX_LOCAL_CACHE_SIZE_KEY = "maxLocalCacheSizeInBytes";
 const char* MAX_MESSAGE_SIZE_KEY = "maxMessageSizeInBytes";
 const char* SNAPSHOT_FREQUENCY_KEY = "snapshotFrequency";
+const char* EVICT_LOW_PRIORITY_EVENTS_KEY = "evictLowPriorityEvents";
+const char* COLLECTOR_TIME_BUDGET_KEY = "collectorTimeBudget";
+const char* MAX_PUBLISHED_BYTES_PER_CYCLE_KEY = "maxPublishedBytesPerCycle";
+const char* COMPRESS_MESSAGES_KEY = "compressMessages";
+const char* ENCODE_MESSAGES_AS_CBOR_KEY = "encodeMessagesAsCbor";
 const char* HUB_RESOURCE_ID_KEY = "hubResourceId";
 const char* EVENT_PROPERTIES_KEY = "eventPriorities";
 
@@ -31,10 +40,21 @@ const char* OPERATIONAL_EVENT_KEY = EVENT_PRIO_PREFIX"Operational";
 /* ===== Event Aggregation Schema =====*/
 const char* PROCESS_CREATE_AGGREGATION_ENABLED_KEY = EVENT_AGG_ENABLED_PREFIX"ProcessCreate";
 const char* PROCESS_CREATE_AGGREGATION_INTERVAL_KEY = EVENT_AGG_INTERVAL_PREFIX"ProcessCreate";
+const char* PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY = EVENT_AGG_MAX_ENTRIES_PREFIX"ProcessCreate";
+const char* PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY = EVENT_AGG_KEY_FIELDS_PREFIX"ProcessCreate";
+const char* PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY = EVENT_AGG_KEY_NORMALIZERS_PREFIX"ProcessCreate";
 const char* CONNECTION_CREATE_AGGREGATION_ENABLED_KEY = EVENT_AGG_ENABLED_PREFIX"ConnectionCreate";
 const char* CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY = EVENT_AGG_INTERVAL_PREFIX"ConnectionCreate";
+const char* CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY = EVENT_AGG_MAX_ENTRIES_PREFIX"ConnectionCreate";
+const char* CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY = EVENT_AGG_KEY_FIELDS_PREFIX"ConnectionCreate";
+const char* CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY = EVENT_AGG_KEY_NORMALIZERS_PREFIX"ConnectionCreate";
 
 /* ===== Baseline custom checks configuration =====*/
 const char* BASELINE_CUSTOM_CHECKS_ENABLED_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"Enabled";
 const char* BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"FilePath";
-const char* BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"FileHash";
\ No newline at end of file
+const char* BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY = BASELINE_CUSTOM_CHECKS_PREFIX"FileHash";
+
+/* ===== Audit exclusions configuration =====*/
+const char* AUDIT_EXCLUDED_EXECUTABLES_KEY = AUDIT_EXCLUDED_PREFIX"Executables";
+const char* AUDIT_EXCLUDED_UIDS_KEY = AUDIT_EXCLUDED_PREFIX"Uids";
+const char* AUDIT_EXCLUDED_AUID_RANGES_KEY = AUDIT_EXCLUDED_PREFIX"AuidRanges";
\ No newline at end of file
@@ -3,7 +3,10 @@
 
 #include "twin_configuration_event_collectors.h"
 
+#include <ctype.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "azure_c_shared_utility/lock.h"
 
@@ -16,6 +19,12 @@ static const char* PRIORITY_HIGH = "high";
 static const char* PRIORITY_LOW = "low";
 static const char* PRIORITY_OFF = "off";
 
+static const char* NORMALIZER_STRIP_NUMERIC_ARGUMENTS = "stripNumericArguments";
+static const char* NORMALIZER_COLLAPSE_TEMP_PATHS = "collapseTempPaths";
+static const char* NORMALIZER_MASK_PORTS_ABOVE = "maskPortsAbove";
+static const char NORMALIZERS_SEPARATOR = ',';
+static const char NORMALIZER_VALUE_SEPARATOR = ':';
+
 static const TwinConfigurationEventPriority PROCESS_CREATE_DEFAULT_PRIORITY = EVENT_PRIORITY_LOW;
 static const TwinConfigurationEventPriority LISTENING_PORTS_DEFAULT_PRIORITY = EVENT_PRIORITY_HIGH;
 static const TwinConfigurationEventPriority SYSTEM_INFORMATION_DEFAULT_PRIORITY = EVENT_PRIORITY_LOW;
@@ -31,6 +40,8 @@ static const bool PROCESS_CREATE_AGGREGATION_ENABLED = true;
 static const bool CONNECTION_CREATE_AGGREGATION_ENABLED = true;
 static const uint32_t PROCESS_CREATE_AGGREGATION_INTERVAL = MILLISECONDS_IN_AN_HOUR;
 static const uint32_t CONNECTION_CREATE_AGGREGATION_INTERVAL = MILLISECONDS_IN_AN_HOUR;
+static const uint32_t PROCESS_CREATE_AGGREGATION_MAX_ENTRIES = 500;
+static const uint32_t CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES = 500;
 
 typedef struct _TwinConfigurationEventCollectors {
     TwinConfigurationEventPriority processCreatePriority;
@@ -47,7 +58,10 @@ typedef struct _TwinConfigurationEventCollectors {
     bool connectionCreateAggregationEnabled;
     uint32_t processCreateAggregationInterval;
     uint32_t connectionCreateAggregationInterval;
-
+    uint32_t processCreateAggregationMaxEntries;
+    uint32_t connectionCreateAggregationMaxEntries;
+    TwinConfigurationAggregationKey processCreateAggregationKey;
+    TwinConfigurationAggregationKey connectionCreateAggregationKey;
 
     LOCK_HANDLE lock;
     bool isLocked;
@@ -100,6 +114,61 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleBoolVal
  */
 static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintTimeValue(JsonObjectReaderHandle propertiesReader, const char* key, uint32_t* field, uint32_t defaultValue);
 
+/**
+ * @brief Set a single uint32_t value which is not a time value
+ * 
+ * @param   propertiesReader    The json reader of the preperties.
+ * @param   key                 The event key in the json.
+ * @param   field               The field of uint32_t type
+ * @param   defaultValue        The dafult value for this field.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintValue(JsonObjectReaderHandle propertiesReader, const char* key, uint32_t* field, uint32_t defaultValue);
+
+/**
+ * @brief Set the aggregation key of a single event type, an unset key aggregates on the whole payload.
+ * 
+ * @param   propertiesReader    The json reader of the preperties.
+ * @param   fieldsKey           The key of the aggregation key fields in the json.
+ * @param   normalizersKey      The key of the aggregation key normalizers in the json.
+ * @param   field               The aggregation key field.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleAggregationKey(JsonObjectReaderHandle propertiesReader, const char* fieldsKey, const char* normalizersKey, TwinConfigurationAggregationKey* field);
+
+/**
+ * @brief Parses a comma separated list of aggregation key normalizers.
+ * 
+ * @param   str     The normalizers, e.g. "stripNumericArguments,collapseTempPaths,maskPortsAbove:32767".
+ * @param   key     Out param. The aggregation key to set the normalizers on.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_ParseAggregationNormalizers(const char* str, TwinConfigurationAggregationKey* key);
+
+/**
+ * @brief Writes the normalizers of the aggregation key in the format they are configured in.
+ * 
+ * @param   key         The aggregation key.
+ * @param   buffer      Out param. The normalizers.
+ * @param   bufferSize  The size of the buffer.
+ * 
+ * @return TWIN_OK on success or an error code upon failure
+ */
+static TwinConfigurationResult TwinConfigurationEventCollectors_AggregationNormalizersAsString(const TwinConfigurationAggregationKey* key, char* buffer, uint32_t bufferSize);
+
+/**
+ * @brief Copies a string without its white spaces.
+ * 
+ * @param   src         The string to copy.
+ * @param   dest        Out param. The copy.
+ * @param   destSize    The size of dest.
+ * 
+ * @return true on success, false if dest is too small.
+ */
+static bool TwinConfigurationEventCollectors_CopyWithoutSpaces(const char* src, char* dest, uint32_t destSize);
 
 /**
  * @brief returns the enum type representing this value.
@@ -161,6 +230,10 @@ TwinConfigurationResult TwinConfigurationEventCollectors_Init() {
     eventPriorities.processCreateAggregationInterval = PROCESS_CREATE_AGGREGATION_INTERVAL;
     eventPriorities.connectionCreateAggregationEnabled = CONNECTION_CREATE_AGGREGATION_ENABLED;
     eventPriorities.connectionCreateAggregationInterval = CONNECTION_CREATE_AGGREGATION_INTERVAL;
+    eventPriorities.processCreateAggregationMaxEntries = PROCESS_CREATE_AGGREGATION_MAX_ENTRIES;
+    eventPriorities.connectionCreateAggregationMaxEntries = CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES;
+    memset(&eventPriorities.processCreateAggregationKey, 0, sizeof(TwinConfigurationAggregationKey));
+    memset(&eventPriorities.connectionCreateAggregationKey, 0, sizeof(TwinConfigurationAggregationKey));
 
     return TWIN_OK;
 }
@@ -278,6 +351,60 @@ cleanup:
     return result;
 }
 
+TwinConfigurationResult TwinConfigurationEventCollectors_GetAggregationMaxEntries(TwinConfigurationEventType eventType, uint32_t* maxEntries) {
+    TwinConfigurationResult result = TWIN_OK;
+    if (TwinConfigurationEventCollectors_Lock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+        goto cleanup;
+    }
+
+    switch (eventType) {
+        case EVENT_TYPE_PROCESS_CREATE:
+            *maxEntries = eventPriorities.processCreateAggregationMaxEntries;
+            break;
+        case EVENT_TYPE_CONNECTION_CREATE:
+            *maxEntries = eventPriorities.connectionCreateAggregationMaxEntries;
+            break;
+        default:
+            result = TWIN_EXCEPTION;
+            break;
+    }
+    
+cleanup:
+    if (TwinConfigurationEventCollectors_Unlock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+    }
+    
+    return result;
+}
+
+TwinConfigurationResult TwinConfigurationEventCollectors_GetAggregationKey(TwinConfigurationEventType eventType, TwinConfigurationAggregationKey* key) {
+    TwinConfigurationResult result = TWIN_OK;
+    if (TwinConfigurationEventCollectors_Lock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+        goto cleanup;
+    }
+
+    switch (eventType) {
+        case EVENT_TYPE_PROCESS_CREATE:
+            memcpy(key, &eventPriorities.processCreateAggregationKey, sizeof(TwinConfigurationAggregationKey));
+            break;
+        case EVENT_TYPE_CONNECTION_CREATE:
+            memcpy(key, &eventPriorities.connectionCreateAggregationKey, sizeof(TwinConfigurationAggregationKey));
+            break;
+        default:
+            result = TWIN_EXCEPTION;
+            break;
+    }
+    
+cleanup:
+    if (TwinConfigurationEventCollectors_Unlock() == false) {
+        result = TWIN_LOCK_EXCEPTION;
+    }
+    
+    return result;
+}
+
 TwinConfigurationResult  TwinConfigurationEventCollectors_GetPrioritiesJson(JsonObjectWriterHandle prioritiesJson){
     TwinConfigurationResult result = TWIN_OK;
     if (TwinConfigurationEventCollectors_Lock() == false) {
@@ -361,6 +488,16 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetValues(JsonOb
         goto cleanup;
     }
 
+    result = TwinConfigurationEventCollectors_SetSingleUintValue(propertiesReader, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, &(newPriorities.processCreateAggregationMaxEntries), PROCESS_CREATE_AGGREGATION_MAX_ENTRIES);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSingleAggregationKey(propertiesReader, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, &(newPriorities.processCreateAggregationKey));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
     result = TwinConfigurationEventCollectors_SetSingleBoolValue(propertiesReader, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, &(newPriorities.connectionCreateAggregationEnabled), CONNECTION_CREATE_AGGREGATION_ENABLED);
     if (result != TWIN_OK) {
         goto cleanup;
@@ -371,6 +508,16 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetValues(JsonOb
         goto cleanup;
     }
 
+    result = TwinConfigurationEventCollectors_SetSingleUintValue(propertiesReader, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, &(newPriorities.connectionCreateAggregationMaxEntries), CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_SetSingleAggregationKey(propertiesReader, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, &(newPriorities.connectionCreateAggregationKey));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
 cleanup:
     if (result == TWIN_OK){
         newPriorities.lock = eventPriorities.lock;
@@ -422,6 +569,124 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintTim
     return result;
 }
 
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleUintValue(JsonObjectReaderHandle propertiesReader, const char* key, uint32_t* field, uint32_t defaultValue) {
+    TwinConfigurationResult result = TwinConfigurationUtils_GetConfigurationUintValueFromJson(propertiesReader, key, field);
+    if (result == TWIN_CONF_NOT_EXIST) {
+        *field = defaultValue;
+        result = TWIN_OK;
+    }
+    
+    return result;
+}
+
+static TwinConfigurationResult TwinConfigurationEventCollectors_SetSingleAggregationKey(JsonObjectReaderHandle propertiesReader, const char* fieldsKey, const char* normalizersKey, TwinConfigurationAggregationKey* field) {
+    char* strValue = NULL;
+    memset(field, 0, sizeof(TwinConfigurationAggregationKey));
+
+    TwinConfigurationResult result = TwinConfigurationUtils_GetConfigurationStringValueFromJson(propertiesReader, fieldsKey, &strValue);
+    if (result == TWIN_OK) {
+        if (TwinConfigurationEventCollectors_CopyWithoutSpaces(strValue, field->fields, sizeof(field->fields)) == false) {
+            return TWIN_PARSE_EXCEPTION;
+        }
+    } else if (result != TWIN_CONF_NOT_EXIST) {
+        return result;
+    }
+
+    result = TwinConfigurationUtils_GetConfigurationStringValueFromJson(propertiesReader, normalizersKey, &strValue);
+    if (result == TWIN_CONF_NOT_EXIST) {
+        return TWIN_OK;
+    } else if (result != TWIN_OK) {
+        return result;
+    }
+
+    return TwinConfigurationEventCollectors_ParseAggregationNormalizers(strValue, field);
+}
+
+static TwinConfigurationResult TwinConfigurationEventCollectors_ParseAggregationNormalizers(const char* str, TwinConfigurationAggregationKey* key) {
+    char normalizers[AGGREGATION_KEY_MAX_LENGTH] = "";
+    if (TwinConfigurationEventCollectors_CopyWithoutSpaces(str, normalizers, sizeof(normalizers)) == false) {
+        return TWIN_PARSE_EXCEPTION;
+    }
+
+    char* normalizer = normalizers;
+    while (normalizer != NULL) {
+        char* next = strchr(normalizer, NORMALIZERS_SEPARATOR);
+        if (next != NULL) {
+            *next = '\0';
+            next++;
+        }
+
+        // allow empty entries, e.g. a trailing separator
+        if (*normalizer == '\0') {
+            normalizer = next;
+            continue;
+        }
+
+        char* value = strchr(normalizer, NORMALIZER_VALUE_SEPARATOR);
+        if (value != NULL) {
+            *value = '\0';
+            value++;
+        }
+
+        if (value == NULL && Utils_UnsafeAreStringsEqual(normalizer, NORMALIZER_STRIP_NUMERIC_ARGUMENTS, false)) {
+            key->stripNumericArguments = true;
+        } else if (value == NULL && Utils_UnsafeAreStringsEqual(normalizer, NORMALIZER_COLLAPSE_TEMP_PATHS, false)) {
+            key->collapseTempPaths = true;
+        } else if (value != NULL && Utils_UnsafeAreStringsEqual(normalizer, NORMALIZER_MASK_PORTS_ABOVE, false)) {
+            int port = 0;
+            if (*value == '\0' || Utils_IsStringNumeric(value) == false || Utils_ConvertStringToInteger(value, 10, &port) == false 
+                || port <= 0 || port > UINT16_MAX) {
+                return TWIN_PARSE_EXCEPTION;
+            }
+            key->maskPortsAbove = (uint32_t)port;
+        } else {
+            return TWIN_PARSE_EXCEPTION;
+        }
+
+        normalizer = next;
+    }
+
+    return TWIN_OK;
+}
+
+static TwinConfigurationResult TwinConfigurationEventCollectors_AggregationNormalizersAsString(const TwinConfigurationAggregationKey* key, char* buffer, uint32_t bufferSize) {
+    int length = snprintf(buffer, bufferSize, "%s%s%s%s%s",
+                    key->stripNumericArguments ? NORMALIZER_STRIP_NUMERIC_ARGUMENTS : "",
+                    key->stripNumericArguments && key->collapseTempPaths ? "," : "",
+                    key->collapseTempPaths ? NORMALIZER_COLLAPSE_TEMP_PATHS : "",
+                    (key->stripNumericArguments || key->collapseTempPaths) && key->maskPortsAbove > 0 ? "," : "",
+                    key->maskPortsAbove > 0 ? NORMALIZER_MASK_PORTS_ABOVE : "");
+    if (length < 0 || (uint32_t)length >= bufferSize) {
+        return TWIN_EXCEPTION;
+    }
+
+    if (key->maskPortsAbove > 0) {
+        int valueLength = snprintf(buffer + length, bufferSize - length, "%c%u", NORMALIZER_VALUE_SEPARATOR, key->maskPortsAbove);
+        if (valueLength < 0 || (uint32_t)valueLength >= bufferSize - length) {
+            return TWIN_EXCEPTION;
+        }
+    }
+
+    return TWIN_OK;
+}
+
+static bool TwinConfigurationEventCollectors_CopyWithoutSpaces(const char* src, char* dest, uint32_t destSize) {
+    uint32_t length = 0;
+    for (; *src != '\0'; src++) {
+        if (isspace((unsigned char)*src)) {
+            continue;
+        }
+
+        if (length + 1 >= destSize) {
+            return false;
+        }
+        dest[length++] = *src;
+    }
+
+    dest[length] = '\0';
+    return true;
+}
+
 static TwinConfigurationResult TwinConfigurationEventCollectors_PriorityAsEnum(const char* str, TwinConfigurationEventPriority* priority) {
     if (Utils_UnsafeAreStringsEqual(str, PRIORITY_HIGH, false)) {
         *priority = EVENT_PRIORITY_HIGH;
@@ -566,6 +831,27 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SafeGetPrioritie
         goto cleanup;
     }
 
+    result = TwinConfigurationUtils_WriteUintConfigurationToJson(prioritiesJson, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, eventPriorities.processCreateAggregationMaxEntries);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, eventPriorities.processCreateAggregationKey.fields);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    char normalizers[AGGREGATION_KEY_MAX_LENGTH] = "";
+    result = TwinConfigurationEventCollectors_AggregationNormalizersAsString(&eventPriorities.processCreateAggregationKey, normalizers, sizeof(normalizers));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, normalizers);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
     result = TwinConfigurationUtils_WriteBoolConfigurationToJson(prioritiesJson, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, eventPriorities.connectionCreateAggregationEnabled);
     if (result != TWIN_OK) {
         goto cleanup;
@@ -581,6 +867,26 @@ static TwinConfigurationResult TwinConfigurationEventCollectors_SafeGetPrioritie
         goto cleanup;
     }
 
+    result = TwinConfigurationUtils_WriteUintConfigurationToJson(prioritiesJson, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, eventPriorities.connectionCreateAggregationMaxEntries);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, eventPriorities.connectionCreateAggregationKey.fields);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationEventCollectors_AggregationNormalizersAsString(&eventPriorities.connectionCreateAggregationKey, normalizers, sizeof(normalizers));
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
+    result = TwinConfigurationUtils_WriteStringConfigurationToJson(prioritiesJson, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, normalizers);
+    if (result != TWIN_OK) {
+        goto cleanup;
+    }
+
 
 cleanup:
     return result;
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include "worker_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "logger.h"
+
+/**
+ * @brief The main function of a worker, runs the pending work until the pool is stopped.
+ *
+ * @param   params  The pool of the worker.
+ *
+ * @return always 0.
+ */
+static int WorkerPool_WorkerMainFunc(void* params);
+
+/**
+ * @brief Blocks until work is pending or the pool is stopped, and takes the first pending work.
+ *
+ * @param   pool    The pool.
+ * @param   work    Out param. The work to run.
+ *
+ * @return true if work was taken, false if the worker should exit.
+ */
+static bool WorkerPool_TakeWork(WorkerPool* pool, WorkerPoolWork* work);
+
+bool WorkerPool_Init(WorkerPool* pool, uint32_t workersCount) {
+    memset(pool, 0, sizeof(*pool));
+    if (workersCount == 0 || workersCount > WORKER_POOL_MAX_WORKERS) {
+        return false;
+    }
+
+    pool->continueRunning = true;
+    pool->lock = Lock_Init();
+    if (pool->lock == NULL) {
+        goto cleanup;
+    }
+
+    pool->workAvailable = Condition_Init();
+    if (pool->workAvailable == NULL) {
+        goto cleanup;
+    }
+
+    for (uint32_t i = 0; i < workersCount; i++) {
+        if (ThreadAPI_Create(&pool->workers[i], WorkerPool_WorkerMainFunc, (void*)pool) != THREADAPI_OK) {
+            Logger_Error("Failed to start worker %u.", i);
+            goto cleanup;
+        }
+        pool->workersCount++;
+    }
+
+    return true;
+
+cleanup:
+    WorkerPool_Deinit(pool);
+    return false;
+}
+
+void WorkerPool_Deinit(WorkerPool* pool) {
+    if (pool->lock != NULL && Lock(pool->lock) == LOCK_OK) {
+        pool->continueRunning = false;
+        // a post wakes a single waiting worker
+        for (uint32_t i = 0; i < pool->workersCount; i++) {
+            Condition_Post(pool->workAvailable);
+        }
+        Unlock(pool->lock);
+    }
+
+    for (uint32_t i = 0; i < pool->workersCount; i++) {
+        int result;
+        ThreadAPI_Join(pool->workers[i], &result);
+    }
+
+    if (pool->workAvailable != NULL) {
+        Condition_Deinit(pool->workAvailable);
+    }
+
+    if (pool->lock != NULL) {
+        Lock_Deinit(pool->lock);
+    }
+
+    memset(pool, 0, sizeof(*pool));
+}
+
+bool WorkerPool_Submit(WorkerPool* pool, WorkerPoolWorkFunc work, void* context) {
+    if (pool->lock == NULL || Lock(pool->lock) != LOCK_OK) {
+        return false;
+    }
+
+    bool submitted = false;
+    if (pool->continueRunning && pool->pendingWorkCount < WORKER_POOL_MAX_PENDING_WORK) {
+        uint32_t tail = (pool->pendingWorkHead + pool->pendingWorkCount) % WORKER_POOL_MAX_PENDING_WORK;
+        pool->pendingWork[tail].work = work;
+        pool->pendingWork[tail].context = context;
+        pool->pendingWorkCount++;
+        Condition_Post(pool->workAvailable);
+        submitted = true;
+    }
+
+    Unlock(pool->lock);
+    return submitted;
+}
+
+static int WorkerPool_WorkerMainFunc(void* params) {
+    WorkerPool* pool = (WorkerPool*)params;
+    WorkerPoolWork work;
+
+    while (WorkerPool_TakeWork(pool, &work)) {
+        Logger_SetCorrelation();
+        work.work(work.context);
+    }
+
+    return 0;
+}
+
+static bool WorkerPool_TakeWork(WorkerPool* pool, WorkerPoolWork* work) {
+    if (Lock(pool->lock) != LOCK_OK) {
+        return false;
+    }
+
+    // a zero timeout waits until a post
+    while (pool->continueRunning && pool->pendingWorkCount == 0) {
+        Condition_Wait(pool->workAvailable, pool->lock, 0);
+    }
+
+    bool taken = false;
+    if (pool->continueRunning) {
+        *work = pool->pendingWork[pool->pendingWorkHead];
+        pool->pendingWorkHead = (pool->pendingWorkHead + 1) % WORKER_POOL_MAX_PENDING_WORK;
+        pool->pendingWorkCount--;
+        taken = true;
+    }
+
+    Unlock(pool->lock);
+    return taken;
+}
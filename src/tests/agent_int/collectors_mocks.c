@@ -2,8 +2,10 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include "collectors/generic_event.h"
+#include "os_utils/linux/audit/audit_feed.h"
 #include "synchronized_queue.h"
 #include "test_defs.h"
+#include "twin_configuration_defs.h"
 
 const char PROCESS_CREATE_MOCKED_MESSAGE_1[] = "{\"Category\": \"Triggered\", \"IsOperational\": false, \"Name\": \"ProcessCreate\", \"PayloadSchemaVersion\": \"1.0\", \"Id\":  \"08c2c0c1-007b-4388-88b3-0809888bc4e7\", \"TimestampLocal\": \"2018-12-25 07:15:57UTC\", \"TimestampUTC\": \"2018-12-25 07:15:57GMT\", \"Payload\": [ { \"Executable\": \"/usr/sbin/nscd\", \"CommandLine\": \"worker_nscd 0\", \"UserId\": 112, \"ProcessId\": 7273, \"ParentProcessId\": 1365 } ] }";
 const char PROCESS_CREATE_MOCKED_MESSAGE_2[] = "{\"Category\": \"Triggered\", \"IsOperational\": false, \"Name\": \"ProcessCreate\", \"PayloadSchemaVersion\": \"1.0\", \"Id\": \"a639f185-fc1f-45da-8e3b-5565fa6098c9\", \"TimestampLocal\": \"2018-12-25 07:15:48UTC\", \"TimestampUTC\": \"2018-12-25 07:15:48GMT\", \"Payload\": [ { \"Executable\": \"/bin/dash\", \"CommandLine\": \"/bin/sh -c iptables --version\", \"UserId\": 0, \"ProcessId\": 7258, \"ParentProcessId\": 1923 } ] }";
@@ -16,13 +18,13 @@ uint32_t listeningPortsMessageCounter = 0;
 
 EventCollectorResult ProcessCreationCollector_GetEvents(SyncQueue* queue) {
     if (processCreateMessageCounter == 0) {
-        SyncQueue_PushBack(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_1), strlen(PROCESS_CREATE_MOCKED_MESSAGE_1) + 1);
+        SyncQueue_PushBackTagged(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_1), strlen(PROCESS_CREATE_MOCKED_MESSAGE_1) + 1, EVENT_TYPE_PROCESS_CREATE);
         processCreateMessageCounter++;
     } else if (processCreateMessageCounter == 1) {
-        SyncQueue_PushBack(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_2), strlen(PROCESS_CREATE_MOCKED_MESSAGE_2));
+        SyncQueue_PushBackTagged(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_2), strlen(PROCESS_CREATE_MOCKED_MESSAGE_2), EVENT_TYPE_PROCESS_CREATE);
         processCreateMessageCounter++;
     } else if (processCreateMessageCounter == 2) {
-        SyncQueue_PushBack(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_3), strlen(PROCESS_CREATE_MOCKED_MESSAGE_3));
+        SyncQueue_PushBackTagged(queue, strdup(PROCESS_CREATE_MOCKED_MESSAGE_3), strlen(PROCESS_CREATE_MOCKED_MESSAGE_3), EVENT_TYPE_PROCESS_CREATE);
         processCreateMessageCounter++;
     }
     return EVENT_COLLECTOR_OK;
@@ -30,10 +32,10 @@ EventCollectorResult ProcessCreationCollector_GetEvents(SyncQueue* queue) {
 
 EventCollectorResult ListeningPortCollector_GetEvents(SyncQueue* queue) {
     if (listeningPortsMessageCounter == 0) {
-        SyncQueue_PushBack(queue, strdup(LISTENING_PORTS_MESSAGE_1), strlen(LISTENING_PORTS_MESSAGE_1));
+        SyncQueue_PushBackTagged(queue, strdup(LISTENING_PORTS_MESSAGE_1), strlen(LISTENING_PORTS_MESSAGE_1), EVENT_TYPE_LISTENING_PORTS);
         listeningPortsMessageCounter++;
     } else if (listeningPortsMessageCounter == 1) {
-        SyncQueue_PushBack(queue, strdup(LISTENING_PORTS_MESSAGE_2), strlen(LISTENING_PORTS_MESSAGE_2));
+        SyncQueue_PushBackTagged(queue, strdup(LISTENING_PORTS_MESSAGE_2), strlen(LISTENING_PORTS_MESSAGE_2), EVENT_TYPE_LISTENING_PORTS);
         listeningPortsMessageCounter++;
     }
     return EVENT_COLLECTOR_OK;
@@ -47,6 +49,10 @@ EventCollectorResult AgentTelemetryCollector_GetEvents(SyncQueue* queue) {
     return EVENT_COLLECTOR_OK;
 }
 
+EventCollectorResult AgentTelemetryCollector_AddTimeBudgetExceededEvent(SyncQueue* queue, const char* collectorName, uint32_t timeBudget) {
+    return EVENT_COLLECTOR_OK;
+}
+
 EventCollectorResult BaselineCollector_GetEvents(SyncQueue* queue) {
     return EVENT_COLLECTOR_OK;
 }
@@ -92,4 +98,61 @@ EventCollectorResult ConnectionCreateEventCollector_Init() {
 
 void ProcessCreationCollector_Deinit() { }
 
-void ConnectionCreateEventCollector_Deinit() { }
\ No newline at end of file
+void ConnectionCreateEventCollector_Deinit() { }
+
+EventCollectorResult ProcessCreationCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ProcessCreationCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ProcessCreationCollector_GetAggregatedEvents(SyncQueue* queue) {
+    // the scan of the audit logs hands the events to the collector, which then flushes them
+    return ProcessCreationCollector_GetEvents(queue);
+}
+
+EventCollectorResult ConnectionCreateEventCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ConnectionCreateEventCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult ConnectionCreateEventCollector_GetAggregatedEvents(SyncQueue* queue) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult UserLoginCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    return EVENT_COLLECTOR_OK;
+}
+
+EventCollectorResult UserLoginCollector_HandleAuditEvent(AuditSearch* auditSearch, SyncQueue* queue) {
+    return EVENT_COLLECTOR_OK;
+}
+
+void AuditDispatcher_Init(AuditDispatcher* dispatcher, const char* checkpointFile) { }
+
+AuditDispatcherResultValues AuditDispatcher_Scan(AuditDispatcher* dispatcher) {
+    return AUDIT_DISPATCHER_OK;
+}
+
+AuditFeedResultValues AuditFeed_Init(AuditFeed* feed, const char* socketPath, AuditDispatcher* dispatcher) {
+    return AUDIT_FEED_EXCEPTION;
+}
+
+void AuditFeed_Deinit(AuditFeed* feed) { }
+
+AuditFeedResultValues AuditFeed_Start(AuditFeed* feed) {
+    return AUDIT_FEED_EXCEPTION;
+}
+
+bool AuditFeed_IsRunning(AuditFeed* feed) {
+    return false;
+}
+
+void AuditFeed_Lock(AuditFeed* feed) { }
+
+void AuditFeed_Unlock(AuditFeed* feed) { }
\ No newline at end of file
@@ -37,7 +37,7 @@ cleanup:
     return success;
 }
 
-bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize) {
+bool IoTHubAdapter_SendMessageAsync(IoTHubAdapter* iotHubAdapter, const void* data, size_t dataSize, const char* contentType, const char* contentEncoding) {
 
     if (Lock(sentMessages.lock) != LOCK_OK) {
         return false;
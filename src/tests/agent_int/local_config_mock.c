@@ -25,4 +25,12 @@ uint32_t LocalConfiguration_GetTriggeredEventInterval() {
 
 const char* LocalConfiguration_GetRemoteConfigurationObjectName() {
     return "ms_iotn:urn_azureiot_Security_SecurityAgentConfiguration";
-}
\ No newline at end of file
+}
+
+bool LocalConfiguration_IsAuditFeedEnabled() {
+    return false;
+}
+
+const char* LocalConfiguration_GetAuditFeedSocketPath() {
+    return NULL;
+}
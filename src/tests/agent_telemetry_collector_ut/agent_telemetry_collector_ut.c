@@ -109,6 +109,15 @@ void setupAddMessageStatisticsPayloadAddExpectSuccess(){
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_SENT_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FAILED_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+}
+
+void setupAddEvictedEventsPayloadAddExpectSuccess(const char* eventType){
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_EVENT_TYPE_KEY, eventType)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_EVICTED_EVENTS_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 }
@@ -139,7 +148,9 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsExpectSuccess)
     setupAddMessageStatisticsPayloadAddExpectSuccess();
     setupPushEventExpectSuccess(&queue);
     setupCleanUpExpectSuccess();    
-    
+
+    //no evicted events, no event
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictedEventsCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
     
     EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -189,6 +200,7 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_SENT_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FAILED_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY, IGNORED_NUM_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
@@ -199,10 +211,12 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictedEventsCounterData(IGNORED_PTR_ARG)).SetFailReturn(!TELEMETRY_PROVIDER_OK);
+
     umock_c_negative_tests_snapshot();
     int count = umock_c_negative_tests_call_count();
     for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
-        if (i == 9 || i == 16 || i == 20 || i == 21 || i == 31 || i == 35 || i == 36) {
+        if (i == 9 || i == 16 || i == 20 || i == 21 || i == 32 || i == 36 || i == 37) {
             // skip deinit since they don't have a fail return
             continue;
         }
@@ -215,4 +229,114 @@ TEST_FUNCTION(AgentTelemetryProvider_GetEventsFail)
     umock_c_negative_tests_deinit();
 }
 
+TEST_FUNCTION(AgentTelemetryProvider_GetEvents_EventsEvicted_ExpectEvictedEventsStatistics)
+{
+    SyncQueue queue = {NULL};
+    EvictedEventsCounter counterData[AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT] = {{0}};
+    counterData[0].eventType = PROCESS_CREATION_NAME;
+    counterData[0].evicted = 3;
+    counterData[1].eventType = CONNECTION_CREATION_NAME;
+    counterData[1].evicted = 0;
+    counterData[2].eventType = USER_LOGIN_NAME;
+    counterData[2].evicted = 1;
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_DROPPED_EVENTS_NAME, AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION);
+    setupAddDroppedEventsPayloadAddExpectSuccess(HIGH_PRIORITY);
+    setupAddDroppedEventsPayloadAddExpectSuccess(LOW_PRIORITY);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME, AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION);
+    setupAddMessageStatisticsPayloadAddExpectSuccess();
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    //only the event types which were evicted are reported
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictedEventsCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(counterData, sizeof(counterData));
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_EVICTED_EVENTS_NAME, AGENT_TELEMETRY_EVICTED_EVENTS_SCHEMA_VERSION);
+    setupAddEvictedEventsPayloadAddExpectSuccess(PROCESS_CREATION_NAME);
+    setupAddEvictedEventsPayloadAddExpectSuccess(USER_LOGIN_NAME);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AgentTelemetryProvider_GetEvents_MessagesSent_ExpectFillPercentageOfBilledBytes)
+{
+    SyncQueue queue = {NULL};
+    MessageCounter counterData = {0};
+    counterData.sentMessages = 2;
+    counterData.sentBytes = 6144;
+    counterData.billedBytes = 8192;
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_DROPPED_EVENTS_NAME, AGENT_TELEMETRY_DROPPED_EVENTS_SCHEMA_VERSION);
+    setupAddDroppedEventsPayloadAddExpectSuccess(HIGH_PRIORITY);
+    setupAddDroppedEventsPayloadAddExpectSuccess(LOW_PRIORITY);
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    setupEventInitExpectSuccess(AGENT_TELEMETRY_MESSAGE_STATISTICS_NAME, AGENT_TELEMETRY_MESSAGE_STATISTICS_SCHEMA_VERSION);
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMessageCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counterData, sizeof(counterData));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_SENT_KEY, 2)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FAILED_KEY, 0)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_UNDER_4KB_KEY, 0)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_MESSAGES_FILL_PERCENTAGE_KEY, 75)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    setupPushEventExpectSuccess(&queue);
+    setupCleanUpExpectSuccess();
+
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictedEventsCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
+
+    EventCollectorResult result = AgentTelemetryCollector_GetEvents(&queue);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AgentTelemetryCollector_AddTimeBudgetExceededEvent_ExpectSuccess)
+{
+    SyncQueue queue = {NULL};
+
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(GenericEvent_AddMetadata(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_SCHEMA_VERSION)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_KEY, "process create")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_TIME_BUDGET_KEY, 60000)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    setupPushEventExpectSuccess(&queue);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    setupCleanUpExpectSuccess();
+
+    EventCollectorResult result = AgentTelemetryCollector_AddTimeBudgetExceededEvent(&queue, "process create", 60000);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AgentTelemetryCollector_AddTimeBudgetExceededEvent_PushFailed_ExpectFailure)
+{
+    SyncQueue queue = {NULL};
+
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(GenericEvent_AddMetadata(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_NAME, EVENT_TYPE_OPERATIONAL_VALUE, AGENT_TELEMETRY_TIME_BUDGET_EXCEEDED_SCHEMA_VERSION)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, AGENT_TELEMETRY_COLLECTOR_KEY, "login")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, AGENT_TELEMETRY_TIME_BUDGET_KEY, 1000)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&queue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_MEMORY_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
+    setupCleanUpExpectSuccess();
+
+    EventCollectorResult result = AgentTelemetryCollector_AddTimeBudgetExceededEvent(&queue, "login", 1000);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(agent_telemetry_collector_ut)
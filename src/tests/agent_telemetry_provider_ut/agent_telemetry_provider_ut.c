@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#include <string.h>
+
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
 #include "umock_c.h"
@@ -11,6 +13,7 @@
 #undef ENABLE_MOCKS
 
 #include "agent_telemetry_provider.h"
+#include "message_schema_consts.h"
 
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -39,6 +42,8 @@ bool getCounterData(SyncedCounter* counter, Counter* counterData){
         counterData->messageCounter.sentMessages = 3;
         counterData->messageCounter.smallMessages = 1;
         counterData->messageCounter.failedMessages = 2;
+        counterData->messageCounter.sentBytes = 5000;
+        counterData->messageCounter.billedBytes = 8192;
     } 
 
     return true;
@@ -110,6 +115,8 @@ TEST_FUNCTION(AgentTelemetryProvider_GetMessageCounterDataExpectSucess)
     ASSERT_ARE_EQUAL(int, 3, counterData.sentMessages);
     ASSERT_ARE_EQUAL(int, 2, counterData.failedMessages);
     ASSERT_ARE_EQUAL(int, 1, counterData.smallMessages);
+    ASSERT_ARE_EQUAL(int, 5000, counterData.sentBytes);
+    ASSERT_ARE_EQUAL(int, 8192, counterData.billedBytes);
 }
 
 TEST_FUNCTION(AgentTelemetryProvider_GetlowPrioQueueCounterDataExpectFail)
@@ -124,6 +131,43 @@ TEST_FUNCTION(AgentTelemetryProvider_GetlowPrioQueueCounterDataExpectFail)
     ASSERT_ARE_EQUAL(int, 3, counterData.sentMessages);
     ASSERT_ARE_EQUAL(int, 2, counterData.failedMessages);
     ASSERT_ARE_EQUAL(int, 1, counterData.smallMessages);
+    ASSERT_ARE_EQUAL(int, 5000, counterData.sentBytes);
+    ASSERT_ARE_EQUAL(int, 8192, counterData.billedBytes);
+}
+
+TEST_FUNCTION(AgentTelemetryProvider_CountEvictedEvent_ExpectCountedPerEventType)
+{
+    EvictedEventsCounter counterData[AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT];
+
+    AgentTelemetryProviderResult result = AgentTelemetryProvider_Init(&lowPrioCounter, &highPrioCounter, &iothubCounter);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+
+    AgentTelemetryProvider_CountEvictedEvent(EVENT_TYPE_PROCESS_CREATE);
+    AgentTelemetryProvider_CountEvictedEvent(EVENT_TYPE_PROCESS_CREATE);
+    AgentTelemetryProvider_CountEvictedEvent(EVENT_TYPE_BASELINE);
+    // operational events are not counted
+    AgentTelemetryProvider_CountEvictedEvent(EVENT_TYPE_OPERATIONAL_EVENT);
+
+    result = AgentTelemetryProvider_GetEvictedEventsCounterData(counterData);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+
+    uint32_t totalEvicted = 0;
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        if (strcmp(counterData[i].eventType, PROCESS_CREATION_NAME) == 0) {
+            ASSERT_ARE_EQUAL(int, 2, counterData[i].evicted);
+        } else if (strcmp(counterData[i].eventType, BASELINE_NAME) == 0) {
+            ASSERT_ARE_EQUAL(int, 1, counterData[i].evicted);
+        }
+        totalEvicted += counterData[i].evicted;
+    }
+    ASSERT_ARE_EQUAL(int, 3, totalEvicted);
+
+    // the counters are reset once they are read
+    result = AgentTelemetryProvider_GetEvictedEventsCounterData(counterData);
+    ASSERT_ARE_EQUAL(int, TELEMETRY_PROVIDER_OK, result);
+    for (uint32_t i = 0; i < AGENT_TELEMETRY_EVICTED_EVENT_TYPES_COUNT; i++) {
+        ASSERT_ARE_EQUAL(int, 0, counterData[i].evicted);
+    }
 }
 
 END_TEST_SUITE(agent_telemetry_provider_ut)
\ No newline at end of file
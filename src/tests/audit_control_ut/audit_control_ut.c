@@ -37,6 +37,41 @@ int Mocked_uname(struct utsname* buf) {
     return 0;
 }
 
+static const char EXCLUSIONS_KEY[] = "exclusions";
+
+/**
+ * The rules listed by the mocked kernel, each one is tagged with a single key
+ */
+#define MAX_LISTED_RULES 2
+static const char* mockedListedRuleKeys[MAX_LISTED_RULES];
+static uint32_t mockedListedRulesCount = 0;
+static uint32_t mockedNextListedRule = 0;
+static char mockedListedRule[sizeof(struct audit_rule_data) + AUDIT_MAX_KEY_LEN];
+
+int Mocked_audit_get_reply(int fd, struct audit_reply* rep, int block, int peek) {
+    if (mockedNextListedRule == mockedListedRulesCount) {
+        rep->type = NLMSG_DONE;
+        return 1;
+    }
+
+    const char* key = mockedListedRuleKeys[mockedNextListedRule++];
+    struct audit_rule_data* rule = (struct audit_rule_data*)mockedListedRule;
+    memset(mockedListedRule, 0, sizeof(mockedListedRule));
+    rule->flags = AUDIT_FILTER_EXIT;
+    rule->action = AUDIT_NEVER;
+    rule->field_count = 2;
+    rule->fields[0] = AUDIT_UID;
+    rule->fields[1] = AUDIT_FILTERKEY;
+    rule->values[1] = strlen(key);
+    rule->buflen = strlen(key);
+    memcpy(rule->buf, key, strlen(key));
+
+    rep->type = AUDIT_LIST_RULES;
+    rep->ruledata = rule;
+    rep->len = sizeof(struct audit_rule_data) + rule->buflen;
+    return rep->len;
+}
+
 BEGIN_TEST_SUITE(audit_control_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -53,11 +88,13 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(AuditControlResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(long int, long);
     REGISTER_GLOBAL_MOCK_HOOK(uname, Mocked_uname);
+    REGISTER_GLOBAL_MOCK_HOOK(audit_get_reply, Mocked_audit_get_reply);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
     REGISTER_GLOBAL_MOCK_HOOK(uname, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(audit_get_reply, NULL);
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
      
@@ -66,6 +103,8 @@ TEST_SUITE_CLEANUP(suite_cleanup)
 TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
+    mockedListedRulesCount = 0;
+    mockedNextListedRule = 0;
 }
 
 TEST_FUNCTION(AuditControl_Init_ExpectSuccess)
@@ -207,4 +246,130 @@ TEST_FUNCTION(AuditControl_AddRule_Expectfailure)
     umock_c_negative_tests_deinit();
 }
 
+TEST_FUNCTION(AuditControl_SetExclusions_ExpectNeverRulePerExclusion)
+{
+    AuditControl audit;
+    audit.audit = 7;
+    audit.cpuArchitectureFilter = "arch=b64";
+    int flags = AUDIT_FILTER_EXIT & AUDIT_FILTER_MASK;
+
+    STRICT_EXPECTED_CALL(audit_request_rules_list_data(audit.audit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "arch=b64", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_syscallbyname_data(IGNORED_PTR_ARG, "msg")).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "exe=/usr/bin/noisy", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "key=exclusions", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_add_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER)).SetReturn(1);
+
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "arch=b64", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_syscallbyname_data(IGNORED_PTR_ARG, "msg")).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "uid=0", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "key=exclusions", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_add_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER)).SetReturn(1);
+
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "arch=b64", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_syscallbyname_data(IGNORED_PTR_ARG, "msg")).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "auid>=1000", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "auid<=1999", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "key=exclusions", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_add_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER)).SetReturn(1);
+
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "arch=b64", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_syscallbyname_data(IGNORED_PTR_ARG, "msg")).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "auid=5", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "key=exclusions", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_add_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER)).SetReturn(1);
+
+    const char* testSyscalls[] = {"msg"};
+    AuditControlExclusions exclusions = { "/usr/bin/noisy", " 0 ", "1000-1999,5" };
+    AuditControlResultValues result = AuditControl_SetExclusions(&audit, testSyscalls, 1, EXCLUSIONS_KEY, &exclusions);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_CONTROL_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditControl_SetExclusions_PreviousExclusions_ExpectOnlyRulesOfKeyDeleted)
+{
+    AuditControl audit;
+    audit.audit = 7;
+    audit.cpuArchitectureFilter = "arch=b64";
+    mockedListedRuleKeys[0] = "other";
+    mockedListedRuleKeys[1] = EXCLUSIONS_KEY;
+    mockedListedRulesCount = 2;
+
+    STRICT_EXPECTED_CALL(audit_request_rules_list_data(audit.audit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_delete_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT, AUDIT_NEVER)).SetReturn(1);
+
+    const char* testSyscalls[] = {"msg"};
+    AuditControlExclusions exclusions = { NULL, "", NULL };
+    AuditControlResultValues result = AuditControl_SetExclusions(&audit, testSyscalls, 1, EXCLUSIONS_KEY, &exclusions);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_CONTROL_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditControl_SetExclusions_InvalidExclusions_ExpectSkippedAndFailure)
+{
+    AuditControl audit;
+    audit.audit = 7;
+    audit.cpuArchitectureFilter = "arch=b64";
+    int flags = AUDIT_FILTER_EXIT & AUDIT_FILTER_MASK;
+
+    STRICT_EXPECTED_CALL(audit_request_rules_list_data(audit.audit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "arch=b64", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_syscallbyname_data(IGNORED_PTR_ARG, "msg")).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "auid=7", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_rule_fieldpair_data(IGNORED_PTR_ARG, "key=exclusions", flags)).SetReturn(0);
+    STRICT_EXPECTED_CALL(audit_add_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT | AUDIT_FILTER_PREPEND, AUDIT_NEVER)).SetReturn(1);
+
+    const char* testSyscalls[] = {"msg"};
+    AuditControlExclusions exclusions = { "relative/path", NULL, "9-3,-5,abc,7" };
+    AuditControlResultValues result = AuditControl_SetExclusions(&audit, testSyscalls, 1, EXCLUSIONS_KEY, &exclusions);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_CONTROL_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditControl_SetExclusions_ListRulesFailed_ExpectNoRulesAdded)
+{
+    AuditControl audit;
+    audit.audit = 7;
+    audit.cpuArchitectureFilter = "arch=b64";
+
+    STRICT_EXPECTED_CALL(audit_request_rules_list_data(audit.audit)).SetReturn(-1);
+
+    const char* testSyscalls[] = {"msg"};
+    AuditControlExclusions exclusions = { "/usr/bin/noisy", NULL, NULL };
+    AuditControlResultValues result = AuditControl_SetExclusions(&audit, testSyscalls, 1, EXCLUSIONS_KEY, &exclusions);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_CONTROL_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditControl_DeleteExclusions_ExpectOnlyRulesOfKeyDeleted)
+{
+    AuditControl audit;
+    audit.audit = 7;
+    mockedListedRuleKeys[0] = EXCLUSIONS_KEY;
+    mockedListedRuleKeys[1] = "other";
+    mockedListedRulesCount = 2;
+
+    STRICT_EXPECTED_CALL(audit_request_rules_list_data(audit.audit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_get_reply(audit.audit, IGNORED_PTR_ARG, GET_REPLY_BLOCKING, 0));
+    STRICT_EXPECTED_CALL(audit_delete_rule_data(audit.audit, IGNORED_PTR_ARG, AUDIT_FILTER_EXIT, AUDIT_NEVER)).SetReturn(1);
+
+    AuditControlResultValues result = AuditControl_DeleteExclusions(&audit, EXCLUSIONS_KEY);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_CONTROL_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(audit_control_ut)
@@ -12,4 +12,7 @@ MOCKABLE_FUNCTION(, void, audit_close, int, fd);
 MOCKABLE_FUNCTION(, int, audit_rule_syscallbyname_data, struct audit_rule_data*, rule, const char*, scall);
 MOCKABLE_FUNCTION(, int, audit_rule_fieldpair_data, struct audit_rule_data**, rulep, const char*, pair, int, flags);
 MOCKABLE_FUNCTION(, int, audit_add_rule_data, int, fd, struct audit_rule_data*, rule, int, flags, int, action);
+MOCKABLE_FUNCTION(, int, audit_delete_rule_data, int, fd, struct audit_rule_data*, rule, int, flags, int, action);
+MOCKABLE_FUNCTION(, int, audit_request_rules_list_data, int, fd);
+MOCKABLE_FUNCTION(, int, audit_get_reply, int, fd, struct audit_reply*, rep, int, block, int, peek);
 MOCKABLE_FUNCTION(, int, uname, struct utsname*, buf);
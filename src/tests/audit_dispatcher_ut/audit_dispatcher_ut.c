@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "audit_mocks.h"
+#include "os_utils/linux/audit/audit_search.h"
+#undef ENABLE_MOCKS
+
+#include "os_utils/linux/audit/audit_dispatcher.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char CHECKPOINT_FILE[] = "/tmp/audit_dispatcher_ut_checkpoint";
+static const char* PROCESS_TYPES[] = {"EXECVE", "INTEGRITY_RULE"};
+static const char* LOGIN_TYPES[] = {"USER_LOGIN", "USER_AUTH"};
+static const char* CONNECTION_SYSCALLS[] = {"connect", "accept"};
+
+static auparse_state_t* mockedAudit;
+static uint32_t handledEvents[2];
+static AuditSearch* handledSearch;
+static AuditSearchFilter searchedFilters[AUDIT_DISPATCHER_MAX_HANDLERS];
+
+AuditSearchResultValues Mocked_AuditSearch_InitMultipleFilters(AuditSearch* auditSearch, const AuditSearchFilter* filters, uint32_t filtersCount, const char* checkpointFile) {
+    memcpy(searchedFilters, filters, filtersCount * sizeof(filters[0]));
+    auditSearch->audit = mockedAudit;
+    return AUDIT_SEARCH_OK;
+}
+
+static void OnEvent(AuditSearch* auditSearch, void* context) {
+    handledEvents[*(uint32_t*)context]++;
+    handledSearch = auditSearch;
+}
+
+BEGIN_TEST_SUITE(audit_dispatcher_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, long);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditSearchResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditSearchCriteria, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_InitMultipleFilters, Mocked_AuditSearch_InitMultipleFilters);
+    REGISTER_GLOBAL_MOCK_RETURN(AuditSearch_SetCheckpoint, AUDIT_SEARCH_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(AuditSearch_WriteCheckpoint, AUDIT_SEARCH_OK);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_InitMultipleFilters, NULL);
+
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    mockedAudit = (auparse_state_t*)0x1;
+    memset(handledEvents, 0, sizeof(handledEvents));
+    handledSearch = NULL;
+    memset(searchedFilters, 0, sizeof(searchedFilters));
+}
+
+TEST_FUNCTION(AuditDispatcher_AddHandlerOverLimits_ExpectFailure)
+{
+    AuditDispatcher dispatcher;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+
+    const char* tooManyTypes[AUDIT_DISPATCHER_MAX_MESSAGE_TYPES + 1] = {"a", "b", "c", "d", "e"};
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_EXCEPTION, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, tooManyTypes, AUDIT_DISPATCHER_MAX_MESSAGE_TYPES + 1, OnEvent, NULL));
+
+    for (uint32_t i = 0; i < AUDIT_DISPATCHER_MAX_HANDLERS; i++) {
+        ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, PROCESS_TYPES, 2, OnEvent, NULL));
+    }
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_EXCEPTION, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, PROCESS_TYPES, 2, OnEvent, NULL));
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_MAX_HANDLERS, dispatcher.handlersCount);
+}
+
+TEST_FUNCTION(AuditDispatcher_Dispatch_ExpectOnlyMatchingHandlersCalled)
+{
+    AuditDispatcher dispatcher;
+    AuditSearch auditSearch;
+    uint32_t processContext = 0;
+    uint32_t connectionContext = 1;
+    auditSearch.audit = mockedAudit;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, PROCESS_TYPES, 2, OnEvent, &processContext));
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_SYSCALL, CONNECTION_SYSCALLS, 2, OnEvent, &connectionContext));
+
+    // the execve record is the second record of the event
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_type_name(mockedAudit)).SetReturn("SYSCALL");
+    STRICT_EXPECTED_CALL(auparse_next_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_type_name(mockedAudit)).SetReturn("EXECVE");
+    // the syscall is compared by its name
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, "syscall")).SetReturn("59");
+    STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn("execve");
+
+    AuditDispatcher_Dispatch(&dispatcher, &auditSearch);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, handledEvents[processContext]);
+    ASSERT_ARE_EQUAL(int, 0, handledEvents[connectionContext]);
+    ASSERT_ARE_EQUAL(void_ptr, &auditSearch, handledSearch);
+}
+
+TEST_FUNCTION(AuditDispatcher_DispatchSyscall_ExpectHandlerCalled)
+{
+    AuditDispatcher dispatcher;
+    AuditSearch auditSearch;
+    uint32_t connectionContext = 1;
+    auditSearch.audit = mockedAudit;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_SYSCALL, CONNECTION_SYSCALLS, 2, OnEvent, &connectionContext));
+
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, "syscall")).SetReturn("42");
+    STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn("connect");
+
+    AuditDispatcher_Dispatch(&dispatcher, &auditSearch);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, handledEvents[connectionContext]);
+}
+
+TEST_FUNCTION(AuditDispatcher_DispatchSudoUserAuth_ExpectNotHandled)
+{
+    AuditDispatcher dispatcher;
+    AuditSearch auditSearch;
+    uint32_t loginContext = 0;
+    auditSearch.audit = mockedAudit;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, LOGIN_TYPES, 2, OnEvent, &loginContext));
+
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_type_name(mockedAudit)).SetReturn("USER_AUTH");
+    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, "exe")).SetReturn("\"/usr/bin/sudo\"");
+    STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn("/usr/bin/sudo");
+
+    AuditDispatcher_Dispatch(&dispatcher, &auditSearch);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, handledEvents[loginContext]);
+}
+
+TEST_FUNCTION(AuditDispatcher_Scan_ExpectSinglePassForAllHandlers)
+{
+    AuditDispatcher dispatcher;
+    uint32_t processContext = 0;
+    uint32_t connectionContext = 1;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, PROCESS_TYPES, 2, OnEvent, &processContext));
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_SYSCALL, CONNECTION_SYSCALLS, 2, OnEvent, &connectionContext));
+
+    STRICT_EXPECTED_CALL(AuditSearch_InitMultipleFilters(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, CHECKPOINT_FILE));
+    // a connect event
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_type_name(mockedAudit)).SetReturn("SYSCALL");
+    STRICT_EXPECTED_CALL(auparse_next_record(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, "syscall")).SetReturn("42");
+    STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn("connect");
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
+    STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_Scan(&dispatcher));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, handledEvents[processContext]);
+    ASSERT_ARE_EQUAL(int, 1, handledEvents[connectionContext]);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_CRITERIA_TYPE, searchedFilters[0].searchCriteria);
+    ASSERT_ARE_EQUAL(int, 2, searchedFilters[0].messageTypesCount);
+    ASSERT_ARE_EQUAL(char_ptr, "EXECVE", searchedFilters[0].messageTypes[0]);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_CRITERIA_SYSCALL, searchedFilters[1].searchCriteria);
+    ASSERT_ARE_EQUAL(char_ptr, "connect", searchedFilters[1].messageTypes[0]);
+}
+
+TEST_FUNCTION(AuditDispatcher_ScanFailed_ExpectCheckpointSet)
+{
+    AuditDispatcher dispatcher;
+    uint32_t processContext = 0;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, PROCESS_TYPES, 2, OnEvent, &processContext));
+
+    STRICT_EXPECTED_CALL(AuditSearch_InitMultipleFilters(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1, CHECKPOINT_FILE));
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_EXCEPTION);
+    STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_EXCEPTION, AuditDispatcher_Scan(&dispatcher));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditDispatcher_ScanWithoutHandlers_ExpectNoSearch)
+{
+    AuditDispatcher dispatcher;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_Scan(&dispatcher));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditDispatcher_MoveCheckpoint_ExpectCheckpointWritten)
+{
+    AuditDispatcher dispatcher;
+    AuditDispatcher_Init(&dispatcher, CHECKPOINT_FILE);
+
+    STRICT_EXPECTED_CALL(AuditSearch_WriteCheckpoint(CHECKPOINT_FILE, 1000));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_DISPATCHER_OK, AuditDispatcher_MoveCheckpoint(&dispatcher, 1000));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(audit_dispatcher_ut)
@@ -0,0 +1,13 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include <auparse.h>
+
+MOCKABLE_FUNCTION(, int, auparse_first_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_next_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_get_type_name, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_find_field, auparse_state_t*, au, const char*, name);
+MOCKABLE_FUNCTION(, const char*, auparse_interpret_field, auparse_state_t*, au);
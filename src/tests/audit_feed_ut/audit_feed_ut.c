@@ -0,0 +1,254 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "audit_mocks.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#include "internal/time_utils.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
+#include "os_utils/process_info_handler.h"
+#undef ENABLE_MOCKS
+
+#include "os_utils/linux/audit/audit_feed.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char SOCKET_PATH[] = "/tmp/audit_feed_ut.sock";
+static const char MISSING_SOCKET_PATH[] = "/tmp/audit_feed_ut_missing.sock";
+static const char RECORDS[] = "type=SYSCALL msg=audit(1.000:1): syscall=59\ntype=EXECVE msg=audit(1.000:1): argc=1\ntype=EOE msg=audit(1.000:1):\n";
+
+static auparse_state_t* mockedAudit;
+static LOCK_HANDLE mockedLock;
+static auparse_callback_ptr mockedCallback;
+static void* mockedCallbackData;
+static int listeningSocket = -1;
+static AuditDispatcher dispatcher;
+
+void Mocked_auparse_add_callback(auparse_state_t* au, auparse_callback_ptr callback, void* user_data, user_destroy user_destroy_func) {
+    mockedCallback = callback;
+    mockedCallbackData = user_data;
+}
+
+int Mocked_auparse_feed(auparse_state_t* au, const char* data, size_t data_len) {
+    // the records complete a single event
+    mockedCallback(au, AUPARSE_CB_EVENT_READY, mockedCallbackData);
+    return 0;
+}
+
+static void ListenOnSocket() {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, SOCKET_PATH);
+
+    unlink(SOCKET_PATH);
+    listeningSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_IS_TRUE(listeningSocket >= 0);
+    ASSERT_ARE_EQUAL(int, 0, bind(listeningSocket, (struct sockaddr*)&address, sizeof(address)));
+    ASSERT_ARE_EQUAL(int, 0, listen(listeningSocket, 1));
+}
+
+static void InitFeedForTests(AuditFeed* feed) {
+    ListenOnSocket();
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockedLock);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_FEED, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(auparse_add_callback(mockedAudit, IGNORED_PTR_ARG, feed, NULL));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_FEED_OK, AuditFeed_Init(feed, SOCKET_PATH, &dispatcher));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+}
+
+BEGIN_TEST_SUITE(audit_feed_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
+    REGISTER_UMOCK_ALIAS_TYPE(ausource_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(auparse_callback_ptr, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(user_destroy, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(size_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(time_t, long);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherResultValues, int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_add_callback, Mocked_auparse_add_callback);
+    REGISTER_GLOBAL_MOCK_HOOK(auparse_feed, Mocked_auparse_feed);
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    mockedAudit = (auparse_state_t*)0x1;
+    mockedLock = (LOCK_HANDLE)0x2;
+    mockedCallback = NULL;
+    mockedCallbackData = NULL;
+    memset(&dispatcher, 0, sizeof(dispatcher));
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    if (listeningSocket >= 0) {
+        close(listeningSocket);
+        listeningSocket = -1;
+        unlink(SOCKET_PATH);
+    }
+}
+
+TEST_FUNCTION(AuditFeed_InitSocket_ExpectSuccess)
+{
+    AuditFeed feed;
+    InitFeedForTests(&feed);
+
+    ASSERT_ARE_EQUAL(void_ptr, mockedAudit, feed.audit);
+    ASSERT_IS_TRUE(feed.socket >= 0);
+    ASSERT_IS_FALSE(feed.isNetlink);
+    ASSERT_IS_FALSE(AuditFeed_IsRunning(&feed));
+    ASSERT_IS_NOT_NULL(mockedCallback);
+
+    // a feed which never ran does not move the checkpoints
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockedLock));
+
+    AuditFeed_Deinit(&feed);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, -1, feed.socket);
+}
+
+TEST_FUNCTION(AuditFeed_InitSocketNotListening_ExpectFailure)
+{
+    AuditFeed feed;
+    unlink(MISSING_SOCKET_PATH);
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockedLock);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_FEED, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(auparse_add_callback(mockedAudit, IGNORED_PTR_ARG, &feed, NULL));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockedLock));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_FEED_EXCEPTION, AuditFeed_Init(&feed, MISSING_SOCKET_PATH, &dispatcher));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(feed.audit);
+    ASSERT_ARE_EQUAL(int, -1, feed.socket);
+}
+
+TEST_FUNCTION(AuditFeed_InitAuparseFailed_ExpectFailure)
+{
+    AuditFeed feed;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockedLock);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_FEED, NULL)).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockedLock));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_FEED_EXCEPTION, AuditFeed_Init(&feed, SOCKET_PATH, &dispatcher));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditFeed_Feed_ExpectEventDispatched)
+{
+    AuditFeed feed;
+    InitFeedForTests(&feed);
+    ASSERT_ARE_EQUAL(void_ptr, &dispatcher, feed.dispatcher);
+
+    STRICT_EXPECTED_CALL(auparse_feed(mockedAudit, RECORDS, sizeof(RECORDS) - 1)).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditDispatcher_Dispatch(&dispatcher, IGNORED_PTR_ARG));
+
+    ASSERT_ARE_EQUAL(int, AUDIT_FEED_OK, AuditFeed_Feed(&feed, RECORDS, sizeof(RECORDS) - 1));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditFeed_Deinit(&feed);
+}
+
+TEST_FUNCTION(AuditFeed_MoveCheckpoint_SourceRead_ExpectCheckpointMovedOnce)
+{
+    AuditFeed feed;
+    InitFeedForTests(&feed);
+    feed.lastCheckpointTime = 100;
+    feed.feedTime = 110;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(AuditDispatcher_MoveCheckpoint(&dispatcher, 110)).SetReturn(AUDIT_DISPATCHER_OK);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    AuditFeed_MoveCheckpoint(&feed);
+    // the source was not read since, the privileges are not taken again
+    AuditFeed_MoveCheckpoint(&feed);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 110, feed.lastCheckpointTime);
+
+    AuditFeed_Deinit(&feed);
+}
+
+TEST_FUNCTION(AuditFeed_MoveCheckpoint_WriteFailed_ExpectRetried)
+{
+    AuditFeed feed;
+    InitFeedForTests(&feed);
+    feed.lastCheckpointTime = 100;
+    feed.feedTime = 110;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(AuditDispatcher_MoveCheckpoint(&dispatcher, 110)).SetReturn(AUDIT_DISPATCHER_EXCEPTION);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(AuditDispatcher_MoveCheckpoint(&dispatcher, 110)).SetReturn(AUDIT_DISPATCHER_OK);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    AuditFeed_MoveCheckpoint(&feed);
+    ASSERT_ARE_EQUAL(int, 100, feed.lastCheckpointTime);
+    AuditFeed_MoveCheckpoint(&feed);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 110, feed.lastCheckpointTime);
+
+    AuditFeed_Deinit(&feed);
+}
+
+END_TEST_SUITE(audit_feed_ut)
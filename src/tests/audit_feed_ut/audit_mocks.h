@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "macro_utils.h"
+#include "umock_c_prod.h"
+
+#include <auparse.h>
+
+MOCKABLE_FUNCTION(, auparse_state_t*, auparse_init, ausource_t, source, const void*, b)
+MOCKABLE_FUNCTION(, void, auparse_add_callback, auparse_state_t*, au, auparse_callback_ptr, callback, void*, user_data, user_destroy, user_destroy_func);
+MOCKABLE_FUNCTION(, int, auparse_feed, auparse_state_t*, au, const char*, data, size_t, data_len);
+MOCKABLE_FUNCTION(, int, auparse_flush_feed, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, void, auparse_destroy, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, audit_msg_type_to_name, int, msg_type);
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_bool.h"
+
+#include "os_utils/linux/audit/audit_log_reader.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char AUDIT_LOG_PATH[] = "/tmp/audit_log_reader_ut.log";
+static const char ROTATED_AUDIT_LOG_PATH[] = "/tmp/audit_log_reader_ut.log.1";
+static const char FIRST_RECORD[] = "type=SYSCALL msg=audit(1.000:1): syscall=59\n";
+static const char SECOND_RECORD[] = "type=SYSCALL msg=audit(2.000:2): syscall=59\n";
+static const char THIRD_RECORD[] = "type=SYSCALL msg=audit(3.000:3): syscall=59\n";
+
+static void WriteLog(const char* path, const char* mode, const char* content) {
+    FILE* file = fopen(path, mode);
+    ASSERT_IS_NOT_NULL(file);
+    ASSERT_ARE_EQUAL(int, strlen(content), fwrite(content, 1, strlen(content), file));
+    fclose(file);
+}
+
+static uint64_t GetInode(const char* path) {
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(path, &fileStat));
+    return (uint64_t)fileStat.st_ino;
+}
+
+static void ReadAll(AuditLogReader* reader, char* buffer, size_t size) {
+    size_t length = fread(buffer, 1, size - 1, reader->stream);
+    buffer[length] = '\0';
+}
+
+BEGIN_TEST_SUITE(audit_log_reader_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    unlink(AUDIT_LOG_PATH);
+    unlink(ROTATED_AUDIT_LOG_PATH);
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    unlink(AUDIT_LOG_PATH);
+    unlink(ROTATED_AUDIT_LOG_PATH);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_ExpectReadFromOffset)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    WriteLog(AUDIT_LOG_PATH, "a", SECOND_RECORD);
+
+    AuditLogPosition position = { GetInode(AUDIT_LOG_PATH), strlen(FIRST_RECORD) };
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_OK, result);
+
+    char buffer[1024];
+    ReadAll(&reader, buffer, sizeof(buffer));
+    ASSERT_ARE_EQUAL(char_ptr, SECOND_RECORD, buffer);
+    ASSERT_ARE_EQUAL(int, position.inode, reader.end.inode);
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_RECORD) + strlen(SECOND_RECORD), reader.end.offset);
+
+    AuditLogReader_Close(&reader);
+    ASSERT_IS_NULL(reader.stream);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_LogRotated_ExpectReadAcrossLogs)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    WriteLog(AUDIT_LOG_PATH, "a", SECOND_RECORD);
+    AuditLogPosition position = { GetInode(AUDIT_LOG_PATH), strlen(FIRST_RECORD) };
+
+    ASSERT_ARE_EQUAL(int, 0, rename(AUDIT_LOG_PATH, ROTATED_AUDIT_LOG_PATH));
+    WriteLog(AUDIT_LOG_PATH, "w", THIRD_RECORD);
+
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, reader.filesCount);
+
+    char expected[1024];
+    snprintf(expected, sizeof(expected), "%s%s", SECOND_RECORD, THIRD_RECORD);
+    char buffer[1024];
+    ReadAll(&reader, buffer, sizeof(buffer));
+    ASSERT_ARE_EQUAL(char_ptr, expected, buffer);
+
+    // the next read starts at the end of the active log
+    ASSERT_ARE_EQUAL(int, GetInode(AUDIT_LOG_PATH), reader.end.inode);
+    ASSERT_ARE_EQUAL(int, strlen(THIRD_RECORD), reader.end.offset);
+
+    AuditLogReader_Close(&reader);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_NoPosition_ExpectReadFromOldestLog)
+{
+    WriteLog(ROTATED_AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    WriteLog(AUDIT_LOG_PATH, "w", SECOND_RECORD);
+
+    AuditLogPosition position = { 0, 0 };
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, reader.filesCount);
+
+    char expected[1024];
+    snprintf(expected, sizeof(expected), "%s%s", FIRST_RECORD, SECOND_RECORD);
+    char buffer[1024];
+    ReadAll(&reader, buffer, sizeof(buffer));
+    ASSERT_ARE_EQUAL(char_ptr, expected, buffer);
+    ASSERT_ARE_EQUAL(int, GetInode(AUDIT_LOG_PATH), reader.end.inode);
+    ASSERT_ARE_EQUAL(int, strlen(SECOND_RECORD), reader.end.offset);
+
+    AuditLogReader_Close(&reader);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_NoPositionNoLog_ExpectNotFound)
+{
+    AuditLogPosition position = { 0, 0 };
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_NOT_FOUND, result);
+    ASSERT_IS_NULL(reader.stream);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_PartialLine_ExpectLineLeftForNextRead)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    WriteLog(AUDIT_LOG_PATH, "a", "type=SYSCALL msg=audit(2.000:2)");
+
+    AuditLogPosition position = { GetInode(AUDIT_LOG_PATH), 0 };
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_OK, result);
+
+    char buffer[1024];
+    ReadAll(&reader, buffer, sizeof(buffer));
+    ASSERT_ARE_EQUAL(char_ptr, FIRST_RECORD, buffer);
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_RECORD), reader.end.offset);
+
+    AuditLogReader_Close(&reader);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_LogGone_ExpectNotFound)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    AuditLogPosition position = { GetInode(AUDIT_LOG_PATH) + 1, 0 };
+
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_NOT_FOUND, result);
+    ASSERT_IS_NULL(reader.stream);
+}
+
+TEST_FUNCTION(AuditLogReader_Open_LogTruncated_ExpectNotFound)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    AuditLogPosition position = { GetInode(AUDIT_LOG_PATH), strlen(FIRST_RECORD) + 1 };
+
+    AuditLogReader reader;
+    AuditLogReaderResultValues result = AuditLogReader_Open(&reader, AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_NOT_FOUND, result);
+    ASSERT_IS_NULL(reader.stream);
+}
+
+TEST_FUNCTION(AuditLogReader_GetLogEnd_ExpectEndOfLastLine)
+{
+    WriteLog(AUDIT_LOG_PATH, "w", FIRST_RECORD);
+    WriteLog(AUDIT_LOG_PATH, "a", "type=SYSCALL");
+
+    AuditLogPosition position;
+    AuditLogReaderResultValues result = AuditLogReader_GetLogEnd(AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_OK, result);
+    ASSERT_ARE_EQUAL(int, GetInode(AUDIT_LOG_PATH), position.inode);
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_RECORD), position.offset);
+}
+
+TEST_FUNCTION(AuditLogReader_GetLogEnd_NoLog_ExpectNotFound)
+{
+    AuditLogPosition position;
+    AuditLogReaderResultValues result = AuditLogReader_GetLogEnd(AUDIT_LOG_PATH, &position);
+    ASSERT_ARE_EQUAL(int, AUDIT_LOG_READER_NOT_FOUND, result);
+}
+
+END_TEST_SUITE(audit_log_reader_ut)
@@ -62,12 +62,10 @@ TEST_FUNCTION(AuditSearchRecord_Goto_ExpectSuccess)
 {
     AuditSearch search;
     search.audit = mockedAudit;
+    uint32_t recordNumber = 1;
 
-    STRICT_EXPECTED_CALL(auparse_get_num_records(mockedAudit)).SetReturn(2);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
-    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(10);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
-    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(11);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_FindRecord(&search, 11, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK).CopyOutArgumentBuffer_recordNumber(&recordNumber, sizeof(recordNumber));
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, recordNumber)).SetReturn(AUDIT_SEARCH_OK);
 
     AuditSearchResultValues result = AuditSearchRecord_Goto(&search, 11);
 
@@ -80,11 +78,7 @@ TEST_FUNCTION(AuditSearchRecord_Goto_RecordNotFound_ExpectSuccess)
     AuditSearch search;
     search.audit = mockedAudit;
 
-    STRICT_EXPECTED_CALL(auparse_get_num_records(mockedAudit)).SetReturn(2);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
-    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(10);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
-    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(11);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_FindRecord(&search, 12, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_RECORD_DOES_NOT_EXIST);
 
     AuditSearchResultValues result = AuditSearchRecord_Goto(&search, 12);
 
@@ -92,12 +86,12 @@ TEST_FUNCTION(AuditSearchRecord_Goto_RecordNotFound_ExpectSuccess)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(AuditSearchRecord_Goto_GetRecordNumFailed_ExpectFailure)
+TEST_FUNCTION(AuditSearchRecord_Goto_FindRecordFailed_ExpectFailure)
 {
     AuditSearch search;
     search.audit = mockedAudit;
 
-    STRICT_EXPECTED_CALL(auparse_get_num_records(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_FindRecord(&search, 12, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_EXCEPTION);
 
     AuditSearchResultValues result = AuditSearchRecord_Goto(&search, 12);
 
@@ -105,14 +99,14 @@ TEST_FUNCTION(AuditSearchRecord_Goto_GetRecordNumFailed_ExpectFailure)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(AuditSearchRecord_Goto_GetTypeFailed_ExpectFailure)
+TEST_FUNCTION(AuditSearchRecord_Goto_GotoRecordFailed_ExpectFailure)
 {
     AuditSearch search;
     search.audit = mockedAudit;
+    uint32_t recordNumber = 0;
 
-    STRICT_EXPECTED_CALL(auparse_get_num_records(mockedAudit)).SetReturn(2);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
-    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_FindRecord(&search, 12, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK).CopyOutArgumentBuffer_recordNumber(&recordNumber, sizeof(recordNumber));
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, recordNumber)).SetReturn(AUDIT_SEARCH_NO_DATA);
 
     AuditSearchResultValues result = AuditSearchRecord_Goto(&search, 12);
 
@@ -120,21 +114,6 @@ TEST_FUNCTION(AuditSearchRecord_Goto_GetTypeFailed_ExpectFailure)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(AuditSearchRecord_Goto_GotoRecordNumFailed_ExpectFailure)
-{
-    AuditSearch search;
-    search.audit = mockedAudit;
-
-    STRICT_EXPECTED_CALL(auparse_get_num_records(mockedAudit)).SetReturn(2);
-    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(0);
-
-    AuditSearchResultValues result = AuditSearchRecord_Goto(&search, 12);
-
-    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_EXCEPTION, result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-}
-
-
 TEST_FUNCTION(AuditSearchRecord_ReadInt_ExpectSuccess)
 {
     AuditSearch search;
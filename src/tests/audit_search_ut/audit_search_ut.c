@@ -11,8 +11,10 @@
 
 #define ENABLE_MOCKS
 #include "audit_mocks.h"
+#include "cancellation.h"
 #include "internal/time_utils.h"
 #include "os_utils/file_utils.h"
+#include "os_utils/linux/audit/audit_log_reader.h"
 #include "os_utils/linux/audit/audit_search_utils.h"
 #include "os_utils/process_info_handler.h"
 #undef ENABLE_MOCKS
@@ -36,17 +38,54 @@ static const char* CHECKPOINT_PATH = "xyz";
 static time_t MOCKED_SEARCH_TIME;
 static time_t TIME_IN_FILE;
 static auparse_state_t* mockedAudit;
+static AuditSearchCheckpoint CHECKPOINT_IN_FILE;
+static const AuditLogPosition LOG_END_POSITION = { 7, 4096 };
+static FILE* MOCKED_LOG_STREAM = (FILE*)0x2;
 
 FileResults Mocked_FileUtils_ReadFile_SetBufferToTime(const char* filename, void* data, uint32_t readCount, bool maxCount) {
     memcpy(data, &TIME_IN_FILE, sizeof(TIME_IN_FILE));
     return FILE_UTILS_OK;
 }
 
+FileResults Mocked_FileUtils_ReadFile_SetBufferToCheckpoint(const char* filename, void* data, uint32_t readCount, bool maxCount) {
+    memcpy(data, &CHECKPOINT_IN_FILE, sizeof(CHECKPOINT_IN_FILE));
+    return FILE_UTILS_OK;
+}
+
+static const char* LEGACY_CHECKPOINT_PATHS[] = { "/tmp/audit_search_ut_legacy1", "/tmp/audit_search_ut_legacy2", "/tmp/audit_search_ut_legacy3" };
+static AuditSearchCheckpoint writtenCheckpoint;
+
+FileResults Mocked_FileUtils_ReadFile_LegacyCheckpoints(const char* filename, void* data, uint32_t readCount, bool maxCount) {
+    if (strcmp(filename, LEGACY_CHECKPOINT_PATHS[0]) == 0) {
+        // a checkpoint of a version which kept only the time
+        memcpy(data, &TIME_IN_FILE, sizeof(TIME_IN_FILE));
+        return FILE_UTILS_OK;
+    } else if (strcmp(filename, LEGACY_CHECKPOINT_PATHS[1]) == 0) {
+        memcpy(data, &CHECKPOINT_IN_FILE, sizeof(CHECKPOINT_IN_FILE));
+        return FILE_UTILS_OK;
+    }
+
+    return FILE_UTILS_FILE_NOT_FOUND;
+}
+
+FileResults Mocked_FileUtils_WriteToFile_SaveCheckpoint(const char* filename, const void* data, uint32_t dataSize) {
+    memcpy(&writtenCheckpoint, data, sizeof(writtenCheckpoint));
+    return FILE_UTILS_OK;
+}
+
+AuditLogReaderResultValues Mocked_AuditLogReader_Open(AuditLogReader* reader, const char* logFile, const AuditLogPosition* position) {
+    memset(reader, 0, sizeof(*reader));
+    reader->stream = MOCKED_LOG_STREAM;
+    reader->end = LOG_END_POSITION;
+    return AUDIT_LOG_READER_OK;
+}
+
 void InitAuditSearchFotTests(AuditSearch* search) {
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search->processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
     AuditSearchResultValues result = AuditSearch_Init(search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
@@ -73,12 +112,17 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(austop_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(ausearch_rule_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditLogReaderResultValues, int);
 
     struct tm tmpTime = {0, 0, 13, 14, 2, 118 }; 
     MOCKED_SEARCH_TIME = mktime(&tmpTime);
 
     struct tm tmpTime2 = {0, 0, 20, 7, 1, 118 }; 
     TIME_IN_FILE = mktime(&tmpTime);
+
+    CHECKPOINT_IN_FILE.time = TIME_IN_FILE;
+    CHECKPOINT_IN_FILE.position.inode = 7;
+    CHECKPOINT_IN_FILE.position.offset = 1024;
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -99,9 +143,10 @@ TEST_FUNCTION(AuditSearch_InitType_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
 
@@ -121,9 +166,10 @@ TEST_FUNCTION(AuditSearch_InitSysCall_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_interpreted_item(mockedAudit, "syscall", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
 
@@ -143,9 +189,10 @@ TEST_FUNCTION(AuditSearch_Init_WithCheckpoint_ExpectSuccess)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false));
     STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
@@ -165,6 +212,118 @@ TEST_FUNCTION(AuditSearch_Init_WithCheckpoint_ExpectSuccess)
     AuditSearch_Deinit(&search);
 }
 
+TEST_FUNCTION(AuditSearch_Init_WithPositionCheckpoint_ExpectReadFromPosition)
+{
+    AuditSearch search;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_FILE_POINTER, MOCKED_LOG_STREAM)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpoint);
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLogReader_Open, Mocked_AuditLogReader_Open);
+
+    AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLogReader_Open, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, mockedAudit, search.audit);
+    // the next search starts where the reader ends
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.inode, search.checkpoint.position.inode);
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.offset, search.checkpoint.position.offset);
+    ASSERT_IS_FALSE(search.checkpoint.isTimeBound);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(AuditLogReader_Close(&search.logReader));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(&search.processInfo)).SetReturn(true);
+
+    AuditSearch_Deinit(&search);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearch_Init_PositionCheckpointLogGone_ExpectSearchByTime)
+{
+    AuditSearch search;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToCheckpoint);
+
+    AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(void_ptr, mockedAudit, search.audit);
+    ASSERT_ARE_EQUAL(int, 0, search.checkpoint.position.inode);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_Init_NoPositionCheckpoint_ExpectAllLogsReadAndEndKept)
+{
+    AuditSearch search;
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_FILE_POINTER, MOCKED_LOG_STREAM)).SetReturn(mockedAudit);
+    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_add_timestamp_item(mockedAudit, ">", TIME_IN_FILE, 0, AUSEARCH_RULE_AND)).SetReturn(0);
+    STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_SetBufferToTime);
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLogReader_Open, Mocked_AuditLogReader_Open);
+
+    AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(AuditLogReader_Open, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    // the next search starts right after what this one reads, not at the end of the logs by the time it is done
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.inode, search.checkpoint.position.inode);
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.offset, search.checkpoint.position.offset);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_WriteCheckpoint_ExpectTimeOnlyCheckpoint)
+{
+    memset(&writtenCheckpoint, 0xff, sizeof(writtenCheckpoint));
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_WriteToFile, Mocked_FileUtils_WriteToFile_SaveCheckpoint);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)));
+
+    AuditSearchResultValues result = AuditSearch_WriteCheckpoint(CHECKPOINT_PATH, MOCKED_SEARCH_TIME);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_WriteToFile, NULL);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, MOCKED_SEARCH_TIME - 1, writtenCheckpoint.time);
+    ASSERT_ARE_EQUAL(int, 0, writtenCheckpoint.position.inode);
+}
+
 TEST_FUNCTION(AuditSearch_Init_ChangeToRootFailed_ExpectFailure)
 {
     AuditSearch search;
@@ -185,10 +344,7 @@ TEST_FUNCTION(AuditSearch_Init_ReadTimeFailed_ExpectFailure)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
-    STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
-    STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_ERROR);
-    STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_ERROR);
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(&search.processInfo)).SetReturn(true);
 
     AuditSearchResultValues result = AuditSearch_Init(&search, AUDIT_SEARCH_CRITERIA_TYPE, MESSAGE_TYPE, CHECKPOINT_PATH);
@@ -206,9 +362,10 @@ TEST_FUNCTION(AuditSearch_Init_AuditFunctionFailed_ExpectFailure)
     AuditSearch search;
 
     STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(&search.processInfo)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(AuditLogReader_Open(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_LOG_READER_NOT_FOUND);
     STRICT_EXPECTED_CALL(auparse_init(AUSOURCE_LOGS, NULL)).SetReturn(mockedAudit);
     STRICT_EXPECTED_CALL(ausearch_add_item(mockedAudit, "type", "=", MESSAGE_TYPE, AUSEARCH_RULE_CLEAR)).SetReturn(0);
-    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(time_t), false)).SetReturn(FILE_UTILS_FILE_NOT_FOUND);
     STRICT_EXPECTED_CALL(ausearch_set_stop(mockedAudit, AUSEARCH_STOP_EVENT)).SetReturn(-1);
     STRICT_EXPECTED_CALL(auparse_destroy(mockedAudit));
     STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(&search.processInfo)).SetReturn(true);
@@ -242,12 +399,16 @@ TEST_FUNCTION(AuditSearch_GetNext_ExpectSuccess)
 {
     AuditSearch search;
     InitAuditSearchFotTests(&search);
+    search.index.isBuilt = true;
 
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
 
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, result);
+    // the index of the previous event is dropped
+    ASSERT_IS_FALSE(search.index.isBuilt);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     AuditSearch_Deinit(&search);
@@ -274,6 +435,7 @@ TEST_FUNCTION(AuditSearch_GetNext_NoMatches_ExpectSuccess)
     AuditSearch search;
     InitAuditSearchFotTests(&search);
 
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(0);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
@@ -289,7 +451,9 @@ TEST_FUNCTION(AuditSearch_GetNextGetNext_ExpectSuccess)
     AuditSearch search;
     InitAuditSearchFotTests(&search);
 
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(1);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
 
@@ -309,7 +473,9 @@ TEST_FUNCTION(AuditSearch_GetNextGetNext_NoMoreData_ExpectSuccess)
     AuditSearch search;
     InitAuditSearchFotTests(&search);
 
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(auparse_next_event(mockedAudit)).SetReturn(0);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
@@ -328,6 +494,7 @@ TEST_FUNCTION(AuditSearch_GetNext_AuditFunctionFailed_ExpectFailure)
     AuditSearch search;
     InitAuditSearchFotTests(&search);
 
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
     STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(-1);
 
     AuditSearchResultValues result = AuditSearch_GetNext(&search);
@@ -338,11 +505,63 @@ TEST_FUNCTION(AuditSearch_GetNext_AuditFunctionFailed_ExpectFailure)
     AuditSearch_Deinit(&search);
 }
 
+TEST_FUNCTION(AuditSearch_GetNext_CancelledBeforeFirstEvent_ExpectCheckpointKept)
+{
+    AuditSearch search;
+    InitAuditSearchFotTests(&search);
+
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(true);
+
+    AuditSearchResultValues result = AuditSearch_GetNext(&search);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_CANCELLED, result);
+
+    // nothing was visited, the next search starts from the previous checkpoint
+    result = AuditSearch_SetCheckpoint(&search);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
+TEST_FUNCTION(AuditSearch_GetNext_Cancelled_ExpectCheckpointAtCurrentEvent)
+{
+    AuditSearch search;
+    InitAuditSearchFotTests(&search);
+
+    au_event_t currentEventTime;
+    currentEventTime.sec = 5183;
+
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
+    STRICT_EXPECTED_CALL(ausearch_next_event(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(true);
+    STRICT_EXPECTED_CALL(auparse_get_timestamp(mockedAudit)).SetReturn(&currentEventTime);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(FILE_UTILS_OK);
+
+    AuditSearchResultValues result = AuditSearch_GetNext(&search);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_HAS_MORE_DATA, result);
+
+    result = AuditSearch_GetNext(&search);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_CANCELLED, result);
+
+    result = AuditSearch_SetCheckpoint(&search);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    // the checkpoint excludes its own second, so the rest of the events of the current second are searched again
+    ASSERT_ARE_EQUAL(int, currentEventTime.sec - 1, search.searchTime);
+    // the search was not read to its end, the next one starts from the same position and skips by time what was reported
+    ASSERT_IS_TRUE(search.checkpoint.isTimeBound);
+    ASSERT_ARE_EQUAL(int, currentEventTime.sec - 1, search.checkpoint.time);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    AuditSearch_Deinit(&search);
+}
+
 TEST_FUNCTION(AuditSearch_SetCheckpoint_ExpectSuccess)
 {
     AuditSearch search;
     InitAuditSearchFotTests(&search);
-    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(MOCKED_SEARCH_TIME))).SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(FILE_UTILS_OK);
 
     AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
 
@@ -356,7 +575,7 @@ TEST_FUNCTION(AuditSearch_SetCheckpoint_WriteFailed_ExpectFailure)
 {
     AuditSearch search;
     InitAuditSearchFotTests(&search);
-    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(MOCKED_SEARCH_TIME))).SetReturn(!FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint))).SetReturn(!FILE_UTILS_OK);
 
     AuditSearchResultValues result = AuditSearch_SetCheckpoint(&search);
 
@@ -409,7 +628,7 @@ TEST_FUNCTION(AuditSearch_ReadInt_ExpectSuccess)
     const char* fieldName = "djdjd";
     int output = 0;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearchUtils_ReadInt(&search, fieldName, &output)).SetReturn(AUDIT_SEARCH_OK);
 
     AuditSearchResultValues result = AuditSearch_ReadInt(&search, fieldName, &output);
@@ -428,7 +647,7 @@ TEST_FUNCTION(AuditSearch_ReadInt_AuditFunctionFailed_ExpectFailure)
     const char* fieldName = "djdjd";
     int output = 0;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(-1);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_EXCEPTION);
 
     AuditSearchResultValues result = AuditSearch_ReadInt(&search, fieldName, &output);
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_EXCEPTION, result);
@@ -445,7 +664,7 @@ TEST_FUNCTION(AuditSearch_ReadString_ExpectSuccess)
     const char* fieldName = "djdjd";
     const char* output = 0;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearchUtils_ReadString(&search, fieldName, &output)).SetReturn(AUDIT_SEARCH_OK);
 
     AuditSearchResultValues result = AuditSearch_ReadString(&search, fieldName, &output);
@@ -464,7 +683,7 @@ TEST_FUNCTION(AuditSearch_ReadString_FieldDoesNotExist_ExpectSuccess)
     const char* fieldName = "djdjd";
     const char* output = 0;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearchUtils_ReadString(&search, fieldName, &output)).SetReturn(AUDIT_SEARCH_FIELD_DOES_NOT_EXIST);
 
     AuditSearchResultValues result = AuditSearch_ReadString(&search, fieldName, &output);
@@ -483,7 +702,7 @@ TEST_FUNCTION(AuditSearch_InterpretString_ExpectSuccess)
     const char* fieldName = "djdjd";
     const char* output = NULL;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);    
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearchUtils_InterpretString(&search, fieldName, &output)).SetReturn(AUDIT_SEARCH_OK);
 
     AuditSearchResultValues result = AuditSearch_InterpretString(&search, fieldName, &output);
@@ -501,7 +720,7 @@ TEST_FUNCTION(AuditSearch_InterpretString_NoData_ExpectSuccess)
     const char* fieldName = "djdjd";
     const char* output = NULL;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_NO_DATA);
 
     AuditSearchResultValues result = AuditSearch_InterpretString(&search, fieldName, &output);
 
@@ -518,7 +737,7 @@ TEST_FUNCTION(AuditSearch_InterpretString_Failed_ExpectSuccess)
     const char* fieldName = "djdjd";
     const char* output = NULL;
 
-    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(AuditSearchUtils_GotoRecord(&search, 0)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearchUtils_InterpretString(&search, fieldName, &output)).SetReturn(AUDIT_SEARCH_EXCEPTION);
 
     AuditSearchResultValues result = AuditSearch_InterpretString(&search, fieldName, &output);
@@ -529,4 +748,46 @@ TEST_FUNCTION(AuditSearch_InterpretString_Failed_ExpectSuccess)
     AuditSearch_Deinit(&search);
 }
 
+TEST_FUNCTION(AuditSearch_MergeCheckpoints_CheckpointMissing_ExpectSeededFromNewestLegacyCheckpoint)
+{
+    TIME_IN_FILE = 100;
+    CHECKPOINT_IN_FILE.time = 200;
+    CHECKPOINT_IN_FILE.position = LOG_END_POSITION;
+    CHECKPOINT_IN_FILE.isTimeBound = false;
+    memset(&writtenCheckpoint, 0, sizeof(writtenCheckpoint));
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, Mocked_FileUtils_ReadFile_LegacyCheckpoints);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_WriteToFile, Mocked_FileUtils_WriteToFile_SaveCheckpoint);
+
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    for (uint32_t i = 0; i < 3; i++) {
+        STRICT_EXPECTED_CALL(FileUtils_ReadFile(LEGACY_CHECKPOINT_PATHS[i], IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true));
+    }
+    STRICT_EXPECTED_CALL(FileUtils_WriteToFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint)));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    AuditSearchResultValues result = AuditSearch_MergeCheckpoints(CHECKPOINT_PATH, LEGACY_CHECKPOINT_PATHS, 3);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 200, writtenCheckpoint.time);
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.inode, writtenCheckpoint.position.inode);
+    ASSERT_ARE_EQUAL(int, LOG_END_POSITION.offset, writtenCheckpoint.position.offset);
+
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_ReadFile, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(FileUtils_WriteToFile, NULL);
+}
+
+TEST_FUNCTION(AuditSearch_MergeCheckpoints_CheckpointExists_ExpectKept)
+{
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(FileUtils_ReadFile(CHECKPOINT_PATH, IGNORED_PTR_ARG, sizeof(AuditSearchCheckpoint), true)).SetReturn(FILE_UTILS_OK);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    AuditSearchResultValues result = AuditSearch_MergeCheckpoints(CHECKPOINT_PATH, LEGACY_CHECKPOINT_PATHS, 3);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(audit_search_ut)
@@ -10,3 +10,11 @@ MOCKABLE_FUNCTION(, const char*, auparse_find_field, auparse_state_t*, au, const
 MOCKABLE_FUNCTION(, int, auparse_get_field_int, auparse_state_t*, au);
 MOCKABLE_FUNCTION(, const char*, auparse_get_field_str, auparse_state_t*, au);
 MOCKABLE_FUNCTION(, const char*, auparse_interpret_field, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_first_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_next_record, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_goto_record_num, auparse_state_t*, au, unsigned int, num);
+MOCKABLE_FUNCTION(, int, auparse_get_type, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_first_field, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_next_field, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, const char*, auparse_get_field_name, auparse_state_t*, au);
+MOCKABLE_FUNCTION(, int, auparse_goto_field_num, auparse_state_t*, au, unsigned int, num);
@@ -9,6 +9,8 @@
 #include "umocktypes_charptr.h"
 #include "umock_c_negative_tests.h"
 
+#include <string.h>
+
 #define ENABLE_MOCKS
 #include "audit_mocks.h"
 #include "os_utils/process_info_handler.h"
@@ -29,6 +31,32 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 
 static auparse_state_t* mockedAudit;
 
+#define EVENT_RECORDS_COUNT 2
+#define EVENT_FIELDS_COUNT 3
+static const int EVENT_RECORD_TYPES[EVENT_RECORDS_COUNT] = { 1300, 1309 };
+static const char* EVENT_FIELDS[EVENT_RECORDS_COUNT][EVENT_FIELDS_COUNT] = {
+    { "syscall", "pid", "exe" },
+    { "argc", "a0", "pid" }
+};
+
+static void InitSearchForTests(AuditSearch* search) {
+    memset(search, 0, sizeof(*search));
+    search->audit = mockedAudit;
+}
+
+static void ExpectEventIndexed() {
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    for (uint32_t i = 0; i < EVENT_RECORDS_COUNT; ++i) {
+        STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(EVENT_RECORD_TYPES[i]);
+        STRICT_EXPECTED_CALL(auparse_first_field(mockedAudit)).SetReturn(1);
+        for (uint32_t j = 0; j < EVENT_FIELDS_COUNT; ++j) {
+            STRICT_EXPECTED_CALL(auparse_get_field_name(mockedAudit)).SetReturn(EVENT_FIELDS[i][j]);
+            STRICT_EXPECTED_CALL(auparse_next_field(mockedAudit)).SetReturn(j + 1 < EVENT_FIELDS_COUNT ? 1 : 0);
+        }
+        STRICT_EXPECTED_CALL(auparse_next_record(mockedAudit)).SetReturn(i + 1 < EVENT_RECORDS_COUNT ? 1 : 0);
+    }
+}
+
 BEGIN_TEST_SUITE(audit_search_utils_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -62,51 +90,69 @@ TEST_FUNCTION_INITIALIZE(method_init)
 TEST_FUNCTION(AuditSearchUtils_ReadInt_ExpectSuccess)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
 
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
     int expectedValue = 7;
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(auparseFindFieldReturnValue);
+    ExpectEventIndexed();
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 1)).SetReturn(1);
     STRICT_EXPECTED_CALL(auparse_get_field_int(mockedAudit)).SetReturn(expectedValue);
 
     int output = 0;
-    AuditSearchResultValues result = AuditSearchUtils_ReadInt(&search, fieldName, &output);
+    AuditSearchResultValues result = AuditSearchUtils_ReadInt(&search, "pid", &output);
 
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
     ASSERT_ARE_EQUAL(int, expectedValue, output);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(AuditSearchUtils_ReadInt_AuditFunctionFailed_ExpectFailure)
+TEST_FUNCTION(AuditSearchUtils_ReadInt_FieldDoesNotExist_ExpectFailure)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
 
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
-    int expectedValue = 7;
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(NULL);
+    ExpectEventIndexed();
 
     int output = 0;
-    AuditSearchResultValues result = AuditSearchUtils_ReadInt(&search, fieldName, &output);
+    AuditSearchResultValues result = AuditSearchUtils_ReadInt(&search, "djdjd", &output);
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_FIELD_DOES_NOT_EXIST, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(AuditSearchUtils_ReadInt_IndexBuilt_ExpectEventNotWalkedAgain)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    ExpectEventIndexed();
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_field_int(mockedAudit)).SetReturn(59);
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_field_int(mockedAudit)).SetReturn(1);
+
+    int output = 0;
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, AuditSearchUtils_ReadInt(&search, "syscall", &output));
+    ASSERT_ARE_EQUAL(int, 59, output);
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, AuditSearchUtils_ReadInt(&search, "argc", &output));
+    ASSERT_ARE_EQUAL(int, 1, output);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(AuditSearchUtils_ReadString_ExpectSuccess)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
 
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
     const char* expectedValue = "this is a value";
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(auparseFindFieldReturnValue);
+    ExpectEventIndexed();
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 2)).SetReturn(1);
     STRICT_EXPECTED_CALL(auparse_get_field_str(mockedAudit)).SetReturn(expectedValue);
 
     const char* output = 0;
-    AuditSearchResultValues result = AuditSearchUtils_ReadString(&search, fieldName, &output);
+    AuditSearchResultValues result = AuditSearchUtils_ReadString(&search, "exe", &output);
 
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, expectedValue, output);
@@ -116,15 +162,12 @@ TEST_FUNCTION(AuditSearchUtils_ReadString_ExpectSuccess)
 TEST_FUNCTION(AuditSearchUtils_ReadString_FieldDoesNotExist_ExpectSuccess)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
 
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
-    const char* expectedValue = "this is a value";
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(NULL);
+    ExpectEventIndexed();
 
     const char* output = 0;
-    AuditSearchResultValues result = AuditSearchUtils_ReadString(&search, fieldName, &output);
+    AuditSearchResultValues result = AuditSearchUtils_ReadString(&search, "djdjd", &output);
 
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_FIELD_DOES_NOT_EXIST, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -133,16 +176,16 @@ TEST_FUNCTION(AuditSearchUtils_ReadString_FieldDoesNotExist_ExpectSuccess)
 TEST_FUNCTION(AuditSearchUtils_InterpretString_ExpectSuccess)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
     
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
     const char* expectedValue = "this is a value";
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(auparseFindFieldReturnValue);
+    ExpectEventIndexed();
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 1)).SetReturn(1);
     STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn(expectedValue);
 
     const char* output = NULL;
-    AuditSearchResultValues result = AuditSearchUtils_InterpretString(&search, fieldName, &output);
+    AuditSearchResultValues result = AuditSearchUtils_InterpretString(&search, "a0", &output);
 
     ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, expectedValue, output);
@@ -152,15 +195,18 @@ TEST_FUNCTION(AuditSearchUtils_InterpretString_ExpectSuccess)
 TEST_FUNCTION(AuditSearchUtils_InterpretString_Fail_ExpectFailue)
 {
     AuditSearch search;
-    search.audit = mockedAudit;
+    InitSearchForTests(&search);
 
-    const char* fieldName = "djdjd";
-    const char* auparseFindFieldReturnValue = "dummy";
     const char* expectedValue = "this is a value";
 
+    // the index is built once, by the first lookup
+    ExpectEventIndexed();
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, AuditSearchUtils_GotoRecord(&search, 0));
+
     umock_c_negative_tests_init();
 
-    STRICT_EXPECTED_CALL(auparse_find_field(mockedAudit, fieldName)).SetReturn(auparseFindFieldReturnValue).SetFailReturn(NULL);
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1).SetFailReturn(0);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 1)).SetReturn(1).SetFailReturn(0);
     STRICT_EXPECTED_CALL(auparse_interpret_field(mockedAudit)).SetReturn(expectedValue).SetFailReturn(NULL);
     
     umock_c_negative_tests_snapshot();
@@ -170,9 +216,90 @@ TEST_FUNCTION(AuditSearchUtils_InterpretString_Fail_ExpectFailue)
         umock_c_negative_tests_fail_call(i);
 
         const char* output = 0;
-        AuditSearchResultValues result = AuditSearchUtils_InterpretString(&search, fieldName, &output);
+        AuditSearchResultValues result = AuditSearchUtils_InterpretString(&search, "a0", &output);
         ASSERT_ARE_NOT_EQUAL(int, AUDIT_SEARCH_OK, result);
     }
+
+    umock_c_negative_tests_deinit();
+}
+
+TEST_FUNCTION(AuditSearchUtils_GotoRecord_ExpectFieldsReadFromRecord)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    ExpectEventIndexed();
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_record_num(mockedAudit, 1)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_goto_field_num(mockedAudit, 2)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_field_int(mockedAudit)).SetReturn(5183);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, AuditSearchUtils_GotoRecord(&search, 1));
+
+    // the pid of the first record is skipped
+    int output = 0;
+    AuditSearchResultValues result = AuditSearchUtils_ReadInt(&search, "pid", &output);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(int, 5183, output);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearchUtils_GotoRecord_NoSuchRecord_ExpectNoData)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    ExpectEventIndexed();
+
+    AuditSearchResultValues result = AuditSearchUtils_GotoRecord(&search, EVENT_RECORDS_COUNT);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_NO_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearchUtils_GotoRecord_IndexFailed_ExpectFailure)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    STRICT_EXPECTED_CALL(auparse_first_record(mockedAudit)).SetReturn(1);
+    STRICT_EXPECTED_CALL(auparse_get_type(mockedAudit)).SetReturn(0);
+
+    AuditSearchResultValues result = AuditSearchUtils_GotoRecord(&search, 0);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_EXCEPTION, result);
+    ASSERT_IS_FALSE(search.index.isBuilt);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearchUtils_FindRecord_ExpectSuccess)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    ExpectEventIndexed();
+
+    uint32_t recordNumber = 0;
+    AuditSearchResultValues result = AuditSearchUtils_FindRecord(&search, EVENT_RECORD_TYPES[1], &recordNumber);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, recordNumber);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(AuditSearchUtils_FindRecord_RecordNotFound_ExpectSuccess)
+{
+    AuditSearch search;
+    InitSearchForTests(&search);
+
+    ExpectEventIndexed();
+
+    uint32_t recordNumber = 0;
+    AuditSearchResultValues result = AuditSearchUtils_FindRecord(&search, 1327, &recordNumber);
+
+    ASSERT_ARE_EQUAL(int, AUDIT_SEARCH_RECORD_DOES_NOT_EXIST, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 END_TEST_SUITE(audit_search_utils_ut)
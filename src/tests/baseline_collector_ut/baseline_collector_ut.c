@@ -195,7 +195,7 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_BASELINE)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -255,7 +255,7 @@ TEST_FUNCTION(BaselineCollector_GetEvents_ExpectFailure)
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_BASELINE)).SetFailReturn(!QUEUE_OK);
 
     // no fail case
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
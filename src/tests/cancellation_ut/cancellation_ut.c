@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "internal/time_utils.h"
+#undef ENABLE_MOCKS
+
+#include "cancellation.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+BEGIN_TEST_SUITE(cancellation_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(uint64_t, unsigned long long);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    Cancellation_SetCurrentToken(NULL);
+}
+
+TEST_FUNCTION(Cancellation_NoCurrentToken_ExpectNeverCancelled)
+{
+    ASSERT_IS_FALSE(Cancellation_IsRequested());
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, Cancellation_GetRemainingTime());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Cancellation_NoDeadline_ExpectNotCancelled)
+{
+    CancellationToken token;
+    CancellationToken_Init(&token, 0);
+    Cancellation_SetCurrentToken(&token);
+
+    ASSERT_IS_FALSE(Cancellation_IsRequested());
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, Cancellation_GetRemainingTime());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Cancellation_BeforeDeadline_ExpectRemainingTime)
+{
+    CancellationToken token;
+    CancellationToken_Init(&token, 1000);
+    Cancellation_SetCurrentToken(&token);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(400);
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(999);
+
+    ASSERT_ARE_EQUAL(uint32_t, 600, Cancellation_GetRemainingTime());
+    ASSERT_IS_FALSE(Cancellation_IsRequested());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Cancellation_DeadlinePassed_ExpectCancelled)
+{
+    CancellationToken token;
+    CancellationToken_Init(&token, 1000);
+    Cancellation_SetCurrentToken(&token);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(1000);
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(1500);
+
+    ASSERT_IS_TRUE(Cancellation_IsRequested());
+    ASSERT_ARE_EQUAL(uint32_t, 0, Cancellation_GetRemainingTime());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Cancellation_TokenCancelled_ExpectCancelledWithoutReadingTheClock)
+{
+    CancellationToken token;
+    CancellationToken_Init(&token, 1000);
+    Cancellation_SetCurrentToken(&token);
+
+    CancellationToken_Cancel(&token);
+
+    ASSERT_IS_TRUE(Cancellation_IsRequested());
+    ASSERT_ARE_EQUAL(uint32_t, 0, Cancellation_GetRemainingTime());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(Cancellation_TokenReinitiated_ExpectNotCancelled)
+{
+    CancellationToken token;
+    CancellationToken_Init(&token, 0);
+    CancellationToken_Cancel(&token);
+
+    CancellationToken_Init(&token, 0);
+    Cancellation_SetCurrentToken(&token);
+
+    ASSERT_IS_FALSE(Cancellation_IsRequested());
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(cancellation_ut)
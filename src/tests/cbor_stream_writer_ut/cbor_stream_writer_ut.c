@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+
+#include "json/cbor_stream_writer.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void AssertOutput(CborStreamWriter* writer, const char* expected, uint32_t expectedSize) {
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Serialize(writer, &output, &size));
+    ASSERT_ARE_EQUAL(int, expectedSize, size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, output, size));
+    free(output);
+}
+
+BEGIN_TEST_SUITE(cbor_stream_writer_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(CborStreamWriter_WriteNestedValues_ExpectSuccess)
+{
+    CborStreamWriter writer;
+    // start small so the buffer has to grow
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Init(&writer, 4));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteString(&writer, "str", "value"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteInt(&writer, "min", INT32_MIN));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteBool(&writer, "bool", false));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginArray(&writer, "arr"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteBool(&writer, "t", true));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteInt(&writer, NULL, 3));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginArray(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginObject(&writer, "empty"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndObject(&writer));
+
+    static const char expected[] =
+        "\xBF"
+        "\x63" "str" "\x65" "value"
+        "\x63" "min" "\x3A\x7F\xFF\xFF\xFF"
+        "\x64" "bool" "\xF4"
+        "\x63" "arr" "\x9F" "\xBF" "\x61" "t" "\xF5" "\xFF" "\x03" "\x9F\xFF" "\xFF"
+        "\x65" "empty" "\xBF\xFF"
+        "\xFF";
+    AssertOutput(&writer, expected, sizeof(expected) - 1);
+
+    CborStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborStreamWriter_KeyDoesNotMatchContainer_ExpectFailure)
+{
+    CborStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Init(&writer, 64));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_BeginObject(&writer, "root"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteInt(&writer, NULL, 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginArray(&writer, "arr"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteInt(&writer, "key", 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_EndObject(&writer));
+
+    // the message is not complete yet
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_Serialize(&writer, &output, &size));
+
+    CborStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborStreamWriter_WriteJson_ExpectJsonTranscoded)
+{
+    CborStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Init(&writer, 4));
+
+    static const char json[] = " { \"s\" : \"a\\n\\u00e9\\ud83d\\ude00\", \"n\":-5, \"big\":4294967296, \"f\":1.5, \"l\":[true, false, null], \"o\":{} } ";
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteJson(&writer, "event", json, sizeof(json) - 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndObject(&writer));
+
+    static const char expected[] =
+        "\xBF"
+        "\x65" "event" "\xBF"
+        "\x61" "s" "\x68" "a\n" "\xC3\xA9" "\xF0\x9F\x98\x80"
+        "\x61" "n" "\x24"
+        "\x63" "big" "\x1B\x00\x00\x00\x01\x00\x00\x00\x00"
+        "\x61" "f" "\xFB\x3F\xF8\x00\x00\x00\x00\x00\x00"
+        "\x61" "l" "\x9F\xF5\xF4\xF6\xFF"
+        "\x61" "o" "\xBF\xFF"
+        "\xFF"
+        "\xFF";
+    AssertOutput(&writer, expected, sizeof(expected) - 1);
+
+    CborStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborStreamWriter_WriteJson_InvalidJson_ExpectWriterUnchanged)
+{
+    CborStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Init(&writer, 64));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginArray(&writer, NULL));
+    uint32_t size = writer.size;
+
+    // unterminated container, trailing data, bad escape, bad literal and a lone surrogate
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteJson(&writer, NULL, "{\"a\":[1,2", 9));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteJson(&writer, NULL, "{} {}", 5));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteJson(&writer, NULL, "\"\\x\"", 4));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteJson(&writer, NULL, "[tru]", 5));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_WriteJson(&writer, NULL, "\"\\ud83d\"", 8));
+    ASSERT_ARE_EQUAL(int, size, writer.size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndArray(&writer));
+    AssertOutput(&writer, "\x9F\xFF", 2);
+
+    CborStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(CborStreamWriter_Truncate_ExpectLastValueDropped)
+{
+    CborStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Init(&writer, 64));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_BeginArray(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteInt(&writer, NULL, 1));
+    uint32_t size = writer.size;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_WriteJson(&writer, NULL, "[2]", 3));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, CborStreamWriter_Truncate(&writer, writer.size + 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_Truncate(&writer, size));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, CborStreamWriter_EndArray(&writer));
+    AssertOutput(&writer, "\x9F\x01\xFF", 3);
+
+    CborStreamWriter_Deinit(&writer);
+}
+
+END_TEST_SUITE(cbor_stream_writer_ut)
@@ -17,6 +17,7 @@
 #include "collectors/linux/generic_audit_event.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "synchronized_queue.h"
 #undef ENABLE_MOCKS
 
@@ -110,6 +111,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(Architecture, int);
     REGISTER_UMOCK_ALIAS_TYPE(EventAggregatorHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(EventAggregatorResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditControlResultValues, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_InterpretString, Mocked_AuditSearch_InterpretString);
     REGISTER_GLOBAL_MOCK_HOOK(EventAggregator_IsAggregationEnabled, Mocked_EventAggregator_IsAggregationEnabled);
@@ -141,21 +143,26 @@ TEST_FUNCTION(ConnectionCreateEventCollector_GetEventsWithInetConnection_Aggrega
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_SYSCALL, IGNORED_PTR_ARG, 2, "/var/tmp/connectionCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "saddr", IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, "192.168.50.241")).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, "53")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, "192.168.50.241")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, "53")).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "exe", CONNECTION_CREATION_EXECUTABLE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "proctitle", CONNECTION_CREATION_COMMAND_LINE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", CONNECTION_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", CONNECTION_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
+    STRICT_EXPECTED_CALL(JsonStreamWriter_GetOutput(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, CONNECTION_CREATION_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(EventAggregator_AggregateEvent(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
@@ -177,21 +184,26 @@ TEST_FUNCTION(ConnectionCreateEventCollector_GetEventsWithInetConnection_Aggrega
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_SYSCALL, IGNORED_PTR_ARG, 2, "/var/tmp/connectionCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "saddr", IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, "192.168.50.241")).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, "53")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, "192.168.50.241")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, "53")).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "exe", CONNECTION_CREATION_EXECUTABLE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "proctitle", CONNECTION_CREATION_COMMAND_LINE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", CONNECTION_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", CONNECTION_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
+    STRICT_EXPECTED_CALL(JsonStreamWriter_GetOutput(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, CONNECTION_CREATION_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(EventAggregator_AggregateEvent(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_AGGREGATOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
@@ -210,30 +222,33 @@ void TestGetEvents_ExpectSuccess(char* hexInputString, char* ipAddress, char* po
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_SYSCALL, IGNORED_PTR_ARG, 2, "/var/tmp/connectionCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     saddrHex = hexInputString;
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "saddr", IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, ipAddress)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, port)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_PROTOCOL_KEY, "tcp")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_DIRECTION_KEY, CONNECTION_CREATION_DIRECTION_OUTBOUND_NAME)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_ADDRESS_KEY, ipAddress)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, CONNECTION_CREATION_REMOTE_PORT_KEY, port)).SetReturn(JSON_WRITER_OK);
 
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "exe", CONNECTION_CREATION_EXECUTABLE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "proctitle", CONNECTION_CREATION_COMMAND_LINE_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", CONNECTION_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", CONNECTION_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_CONNECTION_CREATE)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
@@ -266,14 +281,16 @@ TEST_FUNCTION(ConnectionCreateEventCollector_GetEventsWitUnknownConnection_Aggre
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     saddrHex = hexNonInet;
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "saddr", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
@@ -296,21 +313,23 @@ TEST_FUNCTION(ConnectionCreateEventCollector_GetEvents_AggregationDisabled_Expec
     
     // This does not have a fail valie since it is important for the flow. Skip this on negative tests
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_AGGREGATOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, CONNECTION_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, CONNECTION_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetFailReturn(!EVENT_COLLECTOR_OK);
 
     // if we fail in a single record, we still continue
     saddrHex = hexNonInet;
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_RECORD_HAS_ERRORS);
 
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_CONNECTION_CREATE)).SetFailReturn(!QUEUE_OK);
+    // This does not have a fail valie since it is importatn for the flow. Skip this on negative tests
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     // This does not have a fail valie since it is importatn for the flow. Skip this on negative tests
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
@@ -324,7 +343,7 @@ TEST_FUNCTION(ConnectionCreateEventCollector_GetEvents_AggregationDisabled_Expec
         umock_c_negative_tests_reset();
         umock_c_negative_tests_fail_call(i);
 
-        if (i == 1 || i == 13 || i == 15) {
+        if (i == 1 || i == 13 || i == 14 || i == 16) {
             // skip on the non-SetFailReturn calls
             continue;
         }
@@ -350,4 +369,28 @@ TEST_FUNCTION(ConnectionCreateEventCollector_Init_ExpectSuccess)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(ConnectionCreateEventCollector_SetAuditExclusions_AuditControlFailed_ExpectFailure)
+{
+    AuditControlExclusions exclusions = { NULL, "0", NULL };
+
+    STRICT_EXPECTED_CALL(AuditControl_Init(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditControl_SetExclusions(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, "azure_iot_connection_exclusion", &exclusions)).SetReturn(AUDIT_CONTROL_EXCEPTION);
+    STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = ConnectionCreateEventCollector_SetAuditExclusions(&exclusions);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(ConnectionCreateEventCollector_Deinit_ExpectExclusionsDeleted)
+{
+    STRICT_EXPECTED_CALL(EventAggregator_Deinit(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditControl_Init(IGNORED_PTR_ARG)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(AuditControl_DeleteExclusions(IGNORED_PTR_ARG, "azure_iot_connection_exclusion")).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
+
+    ConnectionCreateEventCollector_Deinit();
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(connection_create_collector_ut)
@@ -23,6 +23,7 @@
 
 #include "collectors/diagnostic_event_collector.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -188,7 +189,7 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectSuccess)
         STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
         STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-        STRICT_EXPECTED_CALL(SyncQueue_PushBack(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+        STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_DIAGNOSTIC));
     }
 
     EventCollectorResult result = DiagnosticEventCollector_GetEvents(&priorityQueue);
@@ -247,7 +248,7 @@ TEST_FUNCTION(DiagnosticEventCollector_GetEvents_ExpectFailures)
     STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL (JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(JSON_WRITER_EXCEPTION);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&priorityQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_DIAGNOSTIC)).SetFailReturn(!QUEUE_OK);
 
     umock_c_negative_tests_snapshot();
 
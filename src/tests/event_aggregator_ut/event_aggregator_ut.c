@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include <stdint.h>
+#include <string.h>
 
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
@@ -11,6 +12,7 @@
 #include "json/json_object_writer.h"
 
 #define ENABLE_MOCKS
+#include "memory_monitor.h"
 #include "synchronized_queue.h"
 #include "twin_configuration_event_collectors.h"
 #undef ENABLE_MOCKS
@@ -32,11 +34,18 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
 static bool isAggregationEnabled = false;
 static TwinConfigurationEventType tested_event_type = EVENT_TYPE_PROCESS_CREATE;
 static uint32_t aggregationInterval = MILLISECONDS_IN_AN_HOUR;
+static uint32_t aggregationMaxEntries = 500;
+static TwinConfigurationAggregationKey aggregationKey;
+static uint32_t memoryLimit = UINT32_MAX;
+static uint32_t memoryConsumption = 0;
 static const char* jsonPayload1 = "{ \"p1\" : \"v1\", \"p2\" : \"v2\" }"; 
 static const char* jsonPayload2 = "{ \"p1\" : \"v3\", \"p2\" : \"v4\" }"; 
+static const char* jsonPayload1Reordered = "{ \"p2\" : \"v2\", \"p1\" : \"v1\" }"; 
 static JsonObjectWriterHandle payload1Handle;
 static JsonObjectWriterHandle payload2Handle;
 static uint32_t msgCounter = 0;
+static const char* expectedHitCount = NULL;
+static char pushedEvents[65536];
 static EventAggregatorHandle aggregatorUnderTest;
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetAggregationEnabled(TwinConfigurationEventType eventType, bool* isEnabled) {
@@ -49,7 +58,35 @@ TwinConfigurationResult Mocked_TwinConfiguration_GetAggregationInterval(TwinConf
     return TWIN_OK;
 }
 
-int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
+TwinConfigurationResult Mocked_TwinConfiguration_GetAggregationMaxEntries(TwinConfigurationEventType eventType, uint32_t* maxEntries) {
+    *maxEntries = aggregationMaxEntries;
+    return TWIN_OK;
+}
+
+TwinConfigurationResult Mocked_TwinConfiguration_GetAggregationKey(TwinConfigurationEventType eventType, TwinConfigurationAggregationKey* key) {
+    memcpy(key, &aggregationKey, sizeof(TwinConfigurationAggregationKey));
+    return TWIN_OK;
+}
+
+MemoryMonitorResultValues Mocked_MemoryMonitor_Consume(uint32_t sizeInBytes) {
+    if (sizeInBytes > memoryLimit - memoryConsumption) {
+        return MEMORY_MONITOR_MEMORY_EXCEEDED;
+    }
+    memoryConsumption += sizeInBytes;
+    return MEMORY_MONITOR_OK;
+}
+
+MemoryMonitorResultValues Mocked_MemoryMonitor_Release(uint32_t sizeInBytes) {
+    ASSERT_IS_TRUE(sizeInBytes <= memoryConsumption);
+    memoryConsumption -= sizeInBytes;
+    return MEMORY_MONITOR_OK;
+}
+
+int Mocked_SyncQueue_PushBackTagged(SyncQueue* syncQueue, void* data, uint32_t dataSize, uint32_t tag) {
+    if (expectedHitCount != NULL) {
+        ASSERT_IS_NOT_NULL(strstr(data, expectedHitCount));
+    }
+    strncat(pushedEvents, data, sizeof(pushedEvents) - strlen(pushedEvents) - 1);
     if (data != NULL) {
         free(data);
     }
@@ -63,7 +100,8 @@ void InitAggregator(EventAggregatorHandle* aggregator) {
         .iotEventType = EVENT_TYPE_PROCESS_CREATE,
         .event_type = "SomeType",
         .event_name = "SomeName",
-        .payload_schema_version = "ver"
+        .payload_schema_version = "ver",
+        .port_key = "Port"
     };
     
     EventAggregatorResult result = EventAggregator_Init(aggregator, &configuration);
@@ -84,11 +122,16 @@ TEST_SUITE_INITIALIZE(suite_init)
     umocktypes_bool_register_types();
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationEventType, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, int);
 
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationEnabled, Mocked_TwinConfiguration_GetAggregationEnabled);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationInterval, Mocked_TwinConfiguration_GetAggregationInterval);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationMaxEntries, Mocked_TwinConfiguration_GetAggregationMaxEntries);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationKey, Mocked_TwinConfiguration_GetAggregationKey);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_Consume, Mocked_MemoryMonitor_Consume);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_Release, Mocked_MemoryMonitor_Release);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBackTagged, Mocked_SyncQueue_PushBackTagged);
 
     JsonObjectWriter_InitFromString(&payload1Handle, jsonPayload1);
     JsonObjectWriter_InitFromString(&payload2Handle, jsonPayload2);
@@ -102,7 +145,11 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationEnabled, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationInterval, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationMaxEntries, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetAggregationKey, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_Consume, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_Release, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBackTagged, NULL);
 
     JsonObjectWriter_Deinit(payload2Handle);
     JsonObjectWriter_Deinit(payload1Handle);
@@ -110,6 +157,12 @@ TEST_SUITE_CLEANUP(suite_cleanup)
 
 TEST_FUNCTION_INITIALIZE(method_init)
 {
+    expectedHitCount = NULL;
+    pushedEvents[0] = '\0';
+    aggregationMaxEntries = 500;
+    memset(&aggregationKey, 0, sizeof(TwinConfigurationAggregationKey));
+    memoryLimit = UINT32_MAX;
+    memoryConsumption = 0;
     InitAggregator(&aggregatorUnderTest);
     umock_c_reset_all_calls();
 }
@@ -235,4 +288,298 @@ TEST_FUNCTION(EventAggregator_FunctionalTest) {
     ASSERT_ARE_EQUAL(int, 2, msgCounter);
 }
 
+TEST_FUNCTION(EventAggregator_AggregateEvent_MembersInDifferentOrder_ExpectSingleEvent) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    JsonObjectWriterHandle reorderedHandle = NULL;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&reorderedHandle, jsonPayload1Reordered));
+
+    EventAggregatorResult result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+    result = EventAggregator_AggregateEvent(aggregatorUnderTest, reorderedHandle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+
+    SyncQueue queue;
+    msgCounter = 0;
+    expectedHitCount = "\"HitCount\":2";
+    result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 1, msgCounter);
+
+    JsonObjectWriter_Deinit(reorderedHandle);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_ManyDistinctPayloads_ExpectEventPerPayload) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    const uint32_t payloadsCount = 100;
+
+    // enough payloads for the aggregator to grow, each is aggregated twice
+    for (uint32_t i = 0; i < 2 * payloadsCount; i++) {
+        char json[64] = "";
+        snprintf(json, sizeof(json), "{ \"Id\" : %u, \"Name\" : \"name%u\" }", i % payloadsCount, i % payloadsCount);
+        JsonObjectWriterHandle payloadHandle = NULL;
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&payloadHandle, json));
+
+        EventAggregatorResult result = EventAggregator_AggregateEvent(aggregatorUnderTest, payloadHandle);
+        ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+
+        JsonObjectWriter_Deinit(payloadHandle);
+    }
+
+    SyncQueue queue;
+    msgCounter = 0;
+    expectedHitCount = "\"HitCount\":2";
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, payloadsCount, msgCounter);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_MaxEntriesReached_ExpectLeastHitEventEvicted) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    aggregationMaxEntries = 2;
+    JsonObjectWriterHandle payload3Handle = NULL;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&payload3Handle, "{ \"p1\" : \"v5\" }"));
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle));
+    }
+    for (int i = 0; i < 2; i++) {
+        ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload2Handle));
+    }
+    // payload2 has the fewest hits and makes room for payload3
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload3Handle));
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle));
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    // payload1, payload3 and the other bucket holding payload2
+    ASSERT_ARE_EQUAL(int, 3, msgCounter);
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"HitCount\":4"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"HitCount\":1,\"HitCountError\":2"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"HitCount\":2,\"EvictedEvents\":1"));
+    ASSERT_IS_NULL(strstr(pushedEvents, "\"v3\""));
+    ASSERT_ARE_EQUAL(int, 0, memoryConsumption);
+
+    JsonObjectWriter_Deinit(payload3Handle);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_MemoryExceeded_ExpectEventsCountedInOtherEvent) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    memoryLimit = 0;
+
+    EventAggregatorResult result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+    result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload2Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+
+    SyncQueue queue;
+    msgCounter = 0;
+    expectedHitCount = "\"HitCount\":2,\"EvictedEvents\":2";
+    result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 1, msgCounter);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_MemoryExceededWithFullAggregator_ExpectSingleEventEvicted) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    char largeJson[512] = "";
+    snprintf(largeJson, sizeof(largeJson), "{ \"p1\" : \"%0400d\" }", 0);
+    JsonObjectWriterHandle largePayloadHandle = NULL;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&largePayloadHandle, largeJson));
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle));
+    }
+    for (int i = 0; i < 2; i++) {
+        ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payload2Handle));
+    }
+    // the memory monitor is full and the large payload does not fit even if both events are evicted
+    memoryLimit = memoryConsumption;
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, largePayloadHandle));
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    // payload2 was evicted for the large payload, payload1 is kept
+    ASSERT_ARE_EQUAL(int, 2, msgCounter);
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"v1\",\"p2\":\"v2\",\"ExtraDetails\":{\"HitCount\":3"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"HitCount\":3,\"EvictedEvents\":2"));
+    ASSERT_IS_NULL(strstr(pushedEvents, "\"v3\""));
+    ASSERT_ARE_EQUAL(int, 0, memoryConsumption);
+
+    JsonObjectWriter_Deinit(largePayloadHandle);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_ExpectMemoryChargedUntilEventsCreated) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+
+    EventAggregatorResult result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+    uint32_t singleEventConsumption = memoryConsumption;
+    ASSERT_IS_TRUE(singleEventConsumption > 0);
+
+    result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload1Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+    ASSERT_ARE_EQUAL(int, singleEventConsumption, memoryConsumption);
+
+    result = EventAggregator_AggregateEvent(aggregatorUnderTest, payload2Handle);
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, result);
+    ASSERT_IS_TRUE(memoryConsumption > singleEventConsumption);
+
+    SyncQueue queue;
+    result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 0, memoryConsumption);
+}
+
+static void AggregateJson(const char* json) {
+    JsonObjectWriterHandle payloadHandle = NULL;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_InitFromString(&payloadHandle, json));
+    ASSERT_ARE_EQUAL(int, EVENT_AGGREGATOR_OK, EventAggregator_AggregateEvent(aggregatorUnderTest, payloadHandle));
+    JsonObjectWriter_Deinit(payloadHandle);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_KeyFields_ExpectFieldsOutOfKeyIgnored) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    strcpy(aggregationKey.fields, "p1,p3");
+
+    AggregateJson("{ \"p1\" : \"v1\", \"p2\" : \"v2\", \"p3\" : 1 }");
+    AggregateJson("{ \"p1\" : \"v1\", \"p2\" : \"v3\", \"p3\" : 1 }");
+    AggregateJson("{ \"p1\" : \"v1\", \"p2\" : \"v3\", \"p3\" : 2 }");
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 2, msgCounter);
+    // fields out of the key are kept, but empty
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"p2\":\"\",\"p3\":1,\"ExtraDetails\":{\"HitCount\":2"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"p2\":\"\",\"p3\":2,\"ExtraDetails\":{\"HitCount\":1"));
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_EventEvicted_ExpectFirstSeenOrderKept) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    aggregationMaxEntries = 3;
+
+    AggregateJson("{ \"p1\" : \"first\" }");
+    for (int i = 0; i < 2; i++) {
+        AggregateJson("{ \"p1\" : \"second\" }");
+        AggregateJson("{ \"p1\" : \"third\" }");
+    }
+    // the first event has the fewest hits and makes room for the fourth
+    AggregateJson("{ \"p1\" : \"fourth\" }");
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_IS_NULL(strstr(pushedEvents, "\"first\""));
+    char* second = strstr(pushedEvents, "\"second\"");
+    char* third = strstr(pushedEvents, "\"third\"");
+    char* fourth = strstr(pushedEvents, "\"fourth\"");
+    ASSERT_IS_NOT_NULL(second);
+    ASSERT_IS_NOT_NULL(third);
+    ASSERT_IS_NOT_NULL(fourth);
+    ASSERT_IS_TRUE(second < third);
+    ASSERT_IS_TRUE(third < fourth);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_ManyEventsEvicted_ExpectFewestHitsEvictedAndFirstSeenOrderKept) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    const uint32_t payloadsCount = 50;
+    aggregationMaxEntries = payloadsCount;
+    char json[64] = "";
+
+    // even payloads are seen twice, odd payloads once
+    for (uint32_t i = 0; i < payloadsCount; i++) {
+        snprintf(json, sizeof(json), "{ \"Id\" : %u }", i);
+        AggregateJson(json);
+        if (i % 2 == 0) {
+            AggregateJson(json);
+        }
+    }
+    // every new payload makes room by evicting an odd payload
+    for (uint32_t i = 0; i < payloadsCount / 2; i++) {
+        snprintf(json, sizeof(json), "{ \"Id\" : %u }", 100 + i);
+        AggregateJson(json);
+    }
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, payloadsCount + 1, msgCounter);
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"HitCount\":25,\"EvictedEvents\":25"));
+
+    char* previous = pushedEvents;
+    for (uint32_t i = 0; i < payloadsCount; i++) {
+        snprintf(json, sizeof(json), "\"Id\":%u,", i);
+        char* current = strstr(pushedEvents, json);
+        if (i % 2 == 1) {
+            ASSERT_IS_NULL(current);
+            continue;
+        }
+        ASSERT_IS_NOT_NULL(current);
+        ASSERT_IS_TRUE(previous < current);
+        previous = current;
+    }
+    for (uint32_t i = 0; i < payloadsCount / 2; i++) {
+        snprintf(json, sizeof(json), "\"Id\":%u,\"ExtraDetails\":{\"HitCount\":1,\"HitCountError\":1", 100 + i);
+        char* current = strstr(pushedEvents, json);
+        ASSERT_IS_NOT_NULL(current);
+        ASSERT_IS_TRUE(previous < current);
+        previous = current;
+    }
+    ASSERT_ARE_EQUAL(int, 0, memoryConsumption);
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_KeyNormalizers_ExpectNormalizedPayloadsAggregated) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    aggregationKey.stripNumericArguments = true;
+    aggregationKey.collapseTempPaths = true;
+
+    AggregateJson("{ \"CommandLine\" : \"cc -j 8 -o /tmp/cc1.o --dir=/var/tmp/a\" }");
+    AggregateJson("{ \"CommandLine\" : \"cc -j 16 -o /tmp/cc2.o --dir=/var/tmp/b\" }");
+    // the executable is not an argument
+    AggregateJson("{ \"CommandLine\" : \"1 -j 16 -o /tmp/cc2.o --dir=/var/tmp/b\" }");
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 2, msgCounter);
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"cc -j # -o \\/tmp\\/* --dir=\\/var\\/tmp\\/*\",\"ExtraDetails\":{\"HitCount\":2"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"1 -j # -o \\/tmp\\/* --dir=\\/var\\/tmp\\/*\",\"ExtraDetails\":{\"HitCount\":1"));
+}
+
+TEST_FUNCTION(EventAggregator_AggregateEvent_MaskPortsAbove_ExpectHighPortsAggregated) {
+    isAggregationEnabled = true;
+    aggregationInterval = 0;
+    aggregationKey.maskPortsAbove = 32767;
+
+    AggregateJson("{ \"Port\" : \"51234\" }");
+    AggregateJson("{ \"Port\" : \"40000\" }");
+    AggregateJson("{ \"Port\" : \"443\" }");
+
+    SyncQueue queue;
+    msgCounter = 0;
+    EventAggregatorResult result = EventAggregator_GetAggregatedEvents(aggregatorUnderTest, &queue);
+    ASSERT_ARE_EQUAL(int, result, EVENT_AGGREGATOR_OK);
+    ASSERT_ARE_EQUAL(int, 2, msgCounter);
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"Port\":0,\"ExtraDetails\":{\"HitCount\":2"));
+    ASSERT_IS_NOT_NULL(strstr(pushedEvents, "\"Port\":\"443\",\"ExtraDetails\":{\"HitCount\":1"));
+}
+
 END_TEST_SUITE(event_aggregator_ut)
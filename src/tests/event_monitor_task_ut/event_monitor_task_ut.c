@@ -1,10 +1,13 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
 #include "umock_c.h"
+#include "umocktypes_bool.h"
 #include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
@@ -22,11 +25,16 @@
 #include "collectors/user_login_collector.h"
 #include "internal/time_utils.h"
 #include "local_config.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
+#include "os_utils/linux/audit/audit_feed.h"
+#include "os_utils/linux/audit/audit_search.h"
 #include "synchronized_queue.h"
 #include "twin_configuration_event_collectors.h"
 #include "twin_configuration.h"
+#include "worker_pool.h"
 #undef ENABLE_MOCKS
 
+#include "consts.h"
 #include "tasks/event_monitor_task.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -39,18 +47,51 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
     ASSERT_FAIL(temp_str);
 }
 
-const uint32_t mockedSnapshotFrequiency = 10;
+#define NUMBER_OF_COLLECTORS 12
+
+const uint32_t mockedSnapshotFrequiency = 1000;
+const uint32_t mockedTriggeredInterval = 2000;
+static uint32_t mockedBaselineInterval = 0;
+static uint32_t mockedCollectorTimeBudget = 0;
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetSnapshotFrequency(uint32_t* snapshotFrequency) {
     *snapshotFrequency = mockedSnapshotFrequiency;
     return TWIN_OK;
 }
 
+TwinConfigurationResult Mocked_TwinConfiguration_GetCollectorTimeBudget(uint32_t* collectorTimeBudget) {
+    // no budget by default, so the runs do not read the clock
+    *collectorTimeBudget = mockedCollectorTimeBudget;
+    return TWIN_OK;
+}
+
 TwinConfigurationResult Mocked_TwinConfigurationEventCollectors_GetPriority(TwinConfigurationEventType eventType, TwinConfigurationEventPriority* priority){
     *priority = eventType == EVENT_TYPE_OPERATIONAL_EVENT ? EVENT_PRIORITY_OPERATIONAL : EVENT_PRIORITY_HIGH;
     return TWIN_OK;
 }
 
+uint32_t Mocked_LocalConfiguration_GetCollectorInterval(TwinConfigurationEventType eventType) {
+    return eventType == EVENT_TYPE_BASELINE ? mockedBaselineInterval : 0;
+}
+
+static bool mockedRunSubmittedWork = true;
+static AuditDispatcherEventHandler mockedProcessCreationAuditHandler = NULL;
+static void* mockedProcessCreationAuditContext = NULL;
+
+EventCollectorResult Mocked_ProcessCreationCollector_AddAuditHandler(AuditDispatcher* dispatcher, AuditDispatcherEventHandler handler, void* context) {
+    mockedProcessCreationAuditHandler = handler;
+    mockedProcessCreationAuditContext = context;
+    return EVENT_COLLECTOR_OK;
+}
+
+bool Mocked_WorkerPool_Submit(WorkerPool* pool, WorkerPoolWorkFunc work, void* context) {
+    // the work runs right away, unless the test keeps it in flight
+    if (mockedRunSubmittedWork) {
+        work(context);
+    }
+    return true;
+}
+
 int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSize) {
     if (data != NULL) {
         free(data);
@@ -59,6 +100,110 @@ int Mocked_SyncQueue_PushBack(SyncQueue* syncQueue, void* data, uint32_t dataSiz
     return QUEUE_OK;
 }
 
+static void ExpectAuditHandlersAdded(EventMonitorTask* task) {
+    STRICT_EXPECTED_CALL(AuditSearch_MergeCheckpoints(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 3)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditDispatcher_Init(&task->auditDispatcher, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_AddAuditHandler(&task->auditDispatcher, IGNORED_PTR_ARG, &task->collectors[8]));
+    STRICT_EXPECTED_CALL(UserLoginCollector_AddAuditHandler(&task->auditDispatcher, IGNORED_PTR_ARG, &task->collectors[9])).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_AddAuditHandler(&task->auditDispatcher, IGNORED_PTR_ARG, &task->collectors[10])).SetReturn(EVENT_COLLECTOR_OK);
+}
+
+static void InitTask(EventMonitorTask* task, SyncQueue* highPriorityQueue, SyncQueue* lowPriorityQueue, SyncQueue* operationalEventsQueue, uint32_t jitterPercentage) {
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetSchedulingJitterPercentage()).SetReturn(jitterPercentage);
+    for (uint32_t i = 0; i < NUMBER_OF_COLLECTORS; i++) {
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorInterval(IGNORED_NUM_ARG));
+    }
+
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task->triggeredWorkers, EVENT_MONITOR_TASK_TRIGGERED_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task->periodicWorkers, EVENT_MONITOR_TASK_PERIODIC_WORKERS));
+
+    // init collectors
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectAuditHandlersAdded(task);
+    STRICT_EXPECTED_CALL(LocalConfiguration_IsAuditFeedEnabled()).SetReturn(false);
+    bool result = EventMonitorTask_Init(task, highPriorityQueue, lowPriorityQueue, operationalEventsQueue);
+    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+}
+
+static void ExpectPeriodicCollectors(EventMonitorTask* task, SyncQueue* highPriorityQueue, SyncQueue* operationalEventsQueue) {
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCollector_GetEvents(operationalEventsQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LOCAL_USERS, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalUsersCollector_GetEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_SYSTEM_INFORMATION, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SystemInformationCollector_GetEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LISTENING_PORTS, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ListeningPortCollector_GetEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_FIREWALL_CONFIGURATION, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(FirewallCollector_GetEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_BASELINE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(BaselineCollector_GetEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(highPriorityQueue));
+}
+
+static void ExpectTriggeredCollectors(EventMonitorTask* task, SyncQueue* highPriorityQueue, SyncQueue* operationalEventsQueue) {
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AgentConfigurationErrorCollector_GetEvents(operationalEventsQueue));
+
+    // a single run searches the audit logs for all the audit collectors
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditDispatcher_Scan(&task->auditDispatcher));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_GetAggregatedEvents(highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_CONNECTION_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_GetAggregatedEvents(highPriorityQueue));
+
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task->triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(highPriorityQueue));
+}
+
+/**
+ * The audit exclusions are applied on the first execution only, as long as they do not change
+ */
+static void ExpectSchedulesUpdated(bool firstExecution) {
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCollectorTimeBudget(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedExecutables(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedUids(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedAuidRanges(IGNORED_PTR_ARG));
+    if (firstExecution) {
+        STRICT_EXPECTED_CALL(ProcessCreationCollector_SetAuditExclusions(IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_SetAuditExclusions(IGNORED_PTR_ARG));
+    }
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(mockedTriggeredInterval);
+}
+
+/**
+ * Runs the first execution, which only schedules the collectors
+ */
+static void ScheduleCollectors(EventMonitorTask* task) {
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    ExpectSchedulesUpdated(true);
+    EventMonitorTask_Execute(task);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+}
+
 BEGIN_TEST_SUITE(event_monitor_task_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -69,26 +214,47 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_IS_NOT_NULL(test_serialize_mutex);
 
     umock_c_init(on_umock_c_error);
+    umocktypes_bool_register_types();
     umocktypes_charptr_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(uint64_t, unsigned long long);
     REGISTER_UMOCK_ALIAS_TYPE(int32_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(time_t, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationEventType, int);
-
+    REGISTER_UMOCK_ALIAS_TYPE(EventCollectorResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(WorkerPoolWorkFunc, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditFeedResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditSearchResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(const char**, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherEventHandler, void*);
+
+    REGISTER_GLOBAL_MOCK_RETURN(WorkerPool_Init, true);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetSnapshotFrequency, Mocked_TwinConfiguration_GetSnapshotFrequency);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetCollectorTimeBudget, Mocked_TwinConfiguration_GetCollectorTimeBudget);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetPriority, Mocked_TwinConfigurationEventCollectors_GetPriority);
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetCollectorInterval, Mocked_LocalConfiguration_GetCollectorInterval);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, Mocked_SyncQueue_PushBack);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_Submit, Mocked_WorkerPool_Submit);
+    REGISTER_GLOBAL_MOCK_HOOK(ProcessCreationCollector_AddAuditHandler, Mocked_ProcessCreationCollector_AddAuditHandler);
+    REGISTER_GLOBAL_MOCK_RETURN(AuditFeed_Init, AUDIT_FEED_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(AuditFeed_Start, AUDIT_FEED_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(AuditFeed_IsRunning, true);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
 {
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetSnapshotFrequency, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetCollectorTimeBudget, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationEventCollectors_GetPriority, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(LocalConfiguration_GetCollectorInterval, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushBack, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(WorkerPool_Submit, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(ProcessCreationCollector_AddAuditHandler, NULL);
 
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
@@ -98,6 +264,11 @@ TEST_SUITE_CLEANUP(suite_cleanup)
 TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
+    mockedBaselineInterval = 0;
+    mockedCollectorTimeBudget = 0;
+    mockedRunSubmittedWork = true;
+    mockedProcessCreationAuditHandler = NULL;
+    mockedProcessCreationAuditContext = NULL;
 }
 
 TEST_FUNCTION(EventMonitorTask_Init_ExpectSuccess)
@@ -107,17 +278,16 @@ TEST_FUNCTION(EventMonitorTask_Init_ExpectSuccess)
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 10);
 
     ASSERT_ARE_EQUAL(void_ptr, &operationalEventsQueue, task.operationalEventsQueue);
     ASSERT_ARE_EQUAL(void_ptr, &highPriorityQueue, task.highPriorityQueue);
     ASSERT_ARE_EQUAL(void_ptr, &lowPriorityQueue, task.lowPriorityQueue);
-    ASSERT_ARE_EQUAL(uint32_t, 0, task.lastPeriodicExecution);
-    ASSERT_ARE_EQUAL(uint32_t, 0, task.lastTriggeredExecution);
+    ASSERT_ARE_EQUAL(uint32_t, 10, task.jitterPercentage);
+    ASSERT_ARE_EQUAL(uint32_t, NUMBER_OF_COLLECTORS, task.collectorsCount);
+    for (uint32_t i = 0; i < task.collectorsCount; i++) {
+        ASSERT_IS_FALSE(task.collectors[i].timer.isScheduled);
+    }
 
     EventMonitorTask_Deinit(&task);
 }
@@ -129,11 +299,7 @@ TEST_FUNCTION(EventMonitorTask_Deinit_ExpectSuccess)
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
 
     EventMonitorTask_Deinit(&task);
     
@@ -141,47 +307,62 @@ TEST_FUNCTION(EventMonitorTask_Deinit_ExpectSuccess)
     ASSERT_IS_NULL(task.lowPriorityQueue);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteGetSnapshotFrequencyFailed_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_ExecuteGetSnapshotFrequencyFailed_ExpectNothingScheduled)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
 
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(1000);
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG)).SetReturn(TWIN_EXCEPTION);
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(1000);
     
     EventMonitorTask_Execute(&task);
+    // keep polling until the twin configuration arrives
+    ASSERT_ARE_EQUAL(uint32_t, SCHEDULER_INTERVAL, EventMonitorTask_GetTimeToNextExecution(&task));
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteTimeoutDidNotPass_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_ExecuteFirstTime_ExpectScheduledWithoutCollecting)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
 
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    ExpectSchedulesUpdated(true);
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+
+    EventMonitorTask_Execute(&task);
+    // without jitter every collector runs on the next tick
+    ASSERT_ARE_EQUAL(uint32_t, 100, EventMonitorTask_GetTimeToNextExecution(&task));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventMonitorTask_Deinit(&task);
+}
 
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(100);
+TEST_FUNCTION(EventMonitorTask_ExecuteTimeoutDidNotPass_ExpectNoCollection)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+    ScheduleCollectors(&task);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(99);
+    ExpectSchedulesUpdated(false);
 
     EventMonitorTask_Execute(&task);
 
@@ -190,102 +371,377 @@ TEST_FUNCTION(EventMonitorTask_ExecuteTimeoutDidNotPass_ExpectSuccess)
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteSnapshotTimeout_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_Execute_AuditExclusionsChanged_ExpectExclusionsReapplied)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
-    uint32_t triggeredInterval = 20;
 
-    // init collectors
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+    ScheduleCollectors(&task);
+
+    // the copies of the twin configuration are freed by the task
+    char* uids = malloc(sizeof("0,1000"));
+    char* sameUids = malloc(sizeof("0,1000"));
+    ASSERT_IS_NOT_NULL(uids);
+    ASSERT_IS_NOT_NULL(sameUids);
+    strcpy(uids, "0,1000");
+    strcpy(sameUids, "0,1000");
 
-    // check periodic events interval
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(99);
     STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(mockedSnapshotFrequiency * 10);
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCollectorTimeBudget(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedExecutables(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedUids(IGNORED_PTR_ARG)).CopyOutArgumentBuffer_auditExcludedUids(&uids, sizeof(uids));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedAuidRanges(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_SetAuditExclusions(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_SetAuditExclusions(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(mockedTriggeredInterval);
+
+    // the failed exclusions are not retried until the twin changes them again
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(99);
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCollectorTimeBudget(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedExecutables(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedUids(IGNORED_PTR_ARG)).CopyOutArgumentBuffer_auditExcludedUids(&sameUids, sizeof(sameUids));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetAuditExcludedAuidRanges(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(mockedTriggeredInterval);
 
-    // all periodic collectors
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(AgentTelemetryCollector_GetEvents(&operationalEventsQueue));
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LOCAL_USERS, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(LocalUsersCollector_GetEvents(&highPriorityQueue));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_SYSTEM_INFORMATION, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SystemInformationCollector_GetEvents(&highPriorityQueue));
+    EventMonitorTask_Deinit(&task);
+}
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_LISTENING_PORTS, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(ListeningPortCollector_GetEvents(&highPriorityQueue));
+TEST_FUNCTION(EventMonitorTask_Execute_ExpectEachGroupOnItsOwnInterval)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_FIREWALL_CONFIGURATION, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(FirewallCollector_GetEvents(&highPriorityQueue));
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+    ScheduleCollectors(&task);
+
+    // first run of all the collectors
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100);
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectTriggeredCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectSchedulesUpdated(false);
+
+    // the periodic collectors are due after the snapshot frequency
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedSnapshotFrequiency);
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectSchedulesUpdated(false);
 
+    // the triggered collectors are due after the triggered events interval
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedTriggeredInterval);
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectTriggeredCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectSchedulesUpdated(false);
+
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventMonitorTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventMonitorTask_Execute_CollectorIntervalConfigured_ExpectCollectorOnItsOwnInterval)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    mockedBaselineInterval = 300;
+
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+    ScheduleCollectors(&task);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100);
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectTriggeredCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectSchedulesUpdated(false);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedBaselineInterval);
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.periodicWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_BASELINE, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(BaselineCollector_GetEvents(&highPriorityQueue));
+    ExpectSchedulesUpdated(false);
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(&highPriorityQueue));
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventMonitorTask_Deinit(&task);
+}
 
-    // check triggered events interval
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(triggeredInterval / 2);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(triggeredInterval);
+TEST_FUNCTION(EventMonitorTask_Init_WorkerPoolInitFailed_ExpectFailure)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetSchedulingJitterPercentage()).SetReturn(0);
+    for (uint32_t i = 0; i < NUMBER_OF_COLLECTORS; i++) {
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorInterval(IGNORED_NUM_ARG));
+    }
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.triggeredWorkers, EVENT_MONITOR_TASK_TRIGGERED_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.periodicWorkers, EVENT_MONITOR_TASK_PERIODIC_WORKERS)).SetReturn(false);
+    STRICT_EXPECTED_CALL(WorkerPool_Deinit(&task.triggeredWorkers));
+
+    ASSERT_IS_FALSE(EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(EventMonitorTask_Execute_CollectionInFlight_ExpectCollectionSkipped)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+    ScheduleCollectors(&task);
+    mockedRunSubmittedWork = false;
+
+    // the triggered diagnostic events share the collect function with the periodic ones which are still in flight,
+    // the login and connection create collectors run along with the process create one
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100);
+    for (uint32_t i = 0; i < NUMBER_OF_COLLECTORS - 3; i++) {
+        STRICT_EXPECTED_CALL(WorkerPool_Submit(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    }
+    ExpectSchedulesUpdated(false);
+
+    // none of the periodic collections finished
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedSnapshotFrequiency);
+    ExpectSchedulesUpdated(false);
 
+    EventMonitorTask_Execute(&task);
     EventMonitorTask_Execute(&task);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (uint32_t i = 0; i < task.collectorsCount; i++) {
+        if (task.collectors[i].audit != NULL && &task.collectors[i] != task.auditLead) {
+            ASSERT_IS_FALSE(task.collectors[i].inFlightGuard->inFlight);
+            continue;
+        }
+        ASSERT_IS_TRUE(task.collectors[i].inFlightGuard->inFlight);
+    }
 
     EventMonitorTask_Deinit(&task);
 }
 
-TEST_FUNCTION(EventMonitorTask_ExecuteTriggeredTimeout_ExpectSuccess)
+TEST_FUNCTION(EventMonitorTask_ExecuteWithJitter_ExpectFirstRunSpreadWithinJitter)
 {
     EventMonitorTask task;
     SyncQueue operationalEventsQueue;
     SyncQueue highPriorityQueue;
     SyncQueue lowPriorityQueue;
-    uint32_t triggeredInterval = 20;
 
-    // init collectors
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 10);
+    ScheduleCollectors(&task);
+
+    for (uint32_t i = 0; i < task.collectorsCount; i++) {
+        // the first audit collector runs the others
+        if (task.collectors[i].audit != NULL && &task.collectors[i] != task.auditLead) {
+            ASSERT_IS_FALSE(task.collectors[i].timer.isScheduled);
+            continue;
+        }
+
+        uint32_t interval = task.collectors[i].isPeriodic ? mockedSnapshotFrequiency : mockedTriggeredInterval;
+        ASSERT_IS_TRUE(task.collectors[i].timer.isScheduled);
+        ASSERT_ARE_EQUAL(uint32_t, interval, task.collectors[i].interval);
+        // expiration ticks of 100 milliseconds, the first tick is the earliest
+        ASSERT_IS_TRUE(task.collectors[i].timer.expirationTick >= 1);
+        ASSERT_IS_TRUE(task.collectors[i].timer.expirationTick * 100 <= interval / 10 + 100);
+    }
+
+    EventMonitorTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventMonitorTask_Execute_CollectorTimeBudgetExceeded_ExpectCancelledAndReportedOnce)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    InitTask(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, 0);
+
+    // a process create run which started at 100 with a budget of 500
+    EventMonitorTaskCollector* collector = &task.collectors[8];
+    ASSERT_ARE_EQUAL(char_ptr, "process create", collector->name);
+    CancellationToken_Init(&collector->cancellation, 600);
+    collector->timeBudget = 500;
+    collector->running = true;
+
+    // the monitor wakes up by the deadline even though nothing is scheduled yet
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100);
+    ASSERT_ARE_EQUAL(uint32_t, 500, EventMonitorTask_GetTimeToNextExecution(&task));
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(600);
+    STRICT_EXPECTED_CALL(AgentTelemetryCollector_AddTimeBudgetExceededEvent(&operationalEventsQueue, "process create", 500)).SetReturn(EVENT_COLLECTOR_OK);
+    ExpectSchedulesUpdated(true);
+
+    // still running, but it was reported already
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(650);
+    ExpectSchedulesUpdated(false);
+
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(collector->overrunReported);
+
+    // the cancellation points of the run see the cancellation
+    Cancellation_SetCurrentToken(&collector->cancellation);
+    ASSERT_IS_TRUE(Cancellation_IsRequested());
+    Cancellation_SetCurrentToken(NULL);
+
+    collector->running = false;
+    EventMonitorTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventMonitorTask_Init_AddAuditHandlerFailed_ExpectFailure)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetSchedulingJitterPercentage()).SetReturn(0);
+    for (uint32_t i = 0; i < NUMBER_OF_COLLECTORS; i++) {
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorInterval(IGNORED_NUM_ARG));
+    }
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.triggeredWorkers, EVENT_MONITOR_TASK_TRIGGERED_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.periodicWorkers, EVENT_MONITOR_TASK_PERIODIC_WORKERS));
     STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
     STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
-    bool result = EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue);
-    ASSERT_IS_TRUE(result);
+    STRICT_EXPECTED_CALL(AuditSearch_MergeCheckpoints(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 3)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditDispatcher_Init(&task.auditDispatcher, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_AddAuditHandler(&task.auditDispatcher, IGNORED_PTR_ARG, &task.collectors[8]));
+    STRICT_EXPECTED_CALL(UserLoginCollector_AddAuditHandler(&task.auditDispatcher, IGNORED_PTR_ARG, &task.collectors[9])).SetReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_Deinit());
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Deinit());
+    STRICT_EXPECTED_CALL(WorkerPool_Deinit(&task.periodicWorkers));
+    STRICT_EXPECTED_CALL(WorkerPool_Deinit(&task.triggeredWorkers));
 
-    // check periodic events interval
-    STRICT_EXPECTED_CALL(TwinConfiguration_GetSnapshotFrequency(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0);
+    ASSERT_IS_FALSE(EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue));
 
-    // check triggered events interval
-    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(triggeredInterval * 10);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetTriggeredEventInterval()).SetReturn(triggeredInterval);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    // all collectors
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(AgentConfigurationErrorCollector_GetEvents(&operationalEventsQueue));
+TEST_FUNCTION(EventMonitorTask_AuditFeedEnabled_ExpectAuditCollectorsFedUntilFeedStops)
+{
+    EventMonitorTask task;
+    SyncQueue operationalEventsQueue;
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetSchedulingJitterPercentage()).SetReturn(0);
+    for (uint32_t i = 0; i < NUMBER_OF_COLLECTORS; i++) {
+        STRICT_EXPECTED_CALL(LocalConfiguration_GetCollectorInterval(IGNORED_NUM_ARG));
+    }
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.triggeredWorkers, EVENT_MONITOR_TASK_TRIGGERED_WORKERS));
+    STRICT_EXPECTED_CALL(WorkerPool_Init(&task.periodicWorkers, EVENT_MONITOR_TASK_PERIODIC_WORKERS));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_Init());
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_Init());
+    ExpectAuditHandlersAdded(&task);
+    STRICT_EXPECTED_CALL(LocalConfiguration_IsAuditFeedEnabled()).SetReturn(true);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAuditFeedSocketPath()).SetReturn(NULL);
+    STRICT_EXPECTED_CALL(AuditFeed_Init(&task.auditFeed, NULL, &task.auditDispatcher));
+    STRICT_EXPECTED_CALL(AuditFeed_Start(&task.auditFeed));
 
+    ASSERT_IS_TRUE(EventMonitorTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(task.auditFeedStarted);
+    ASSERT_IS_TRUE(task.isAuditFed);
+    umock_c_reset_all_calls();
+
+    // the dispatched events go to the queue of their collector
+    AuditSearch auditSearch;
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(ProcessCreationCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_HandleAuditEvent(&auditSearch, &highPriorityQueue));
+    ASSERT_IS_NOT_NULL(mockedProcessCreationAuditHandler);
+    mockedProcessCreationAuditHandler(&auditSearch, mockedProcessCreationAuditContext);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_USER_LOGIN, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(UserLoginCollector_GetEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditFeed_IsRunning(&task.auditFeed));
+    ExpectSchedulesUpdated(true);
+    EventMonitorTask_Execute(&task);
+    umock_c_reset_all_calls();
 
+    // while the feed runs the audit collectors only flush what the feed collected
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100);
+    STRICT_EXPECTED_CALL(AuditFeed_IsRunning(&task.auditFeed));
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AgentConfigurationErrorCollector_GetEvents(&operationalEventsQueue));
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditFeed_Lock(&task.auditFeed));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_GetAggregatedEvents(&highPriorityQueue));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_CONNECTION_CREATE, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_GetEvents(&highPriorityQueue));
-
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_GetAggregatedEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(AuditFeed_MoveCheckpoint(&task.auditFeed));
+    STRICT_EXPECTED_CALL(AuditFeed_Unlock(&task.auditFeed));
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(&highPriorityQueue));
+    ExpectSchedulesUpdated(false);
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedSnapshotFrequiency);
+    STRICT_EXPECTED_CALL(AuditFeed_IsRunning(&task.auditFeed));
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    ExpectSchedulesUpdated(false);
+
+    // the feed stopped, the audit logs are searched again
+    STRICT_EXPECTED_CALL(TimeUtils_GetMonotonicTimeInMilliseconds()).SetReturn(100 + mockedTriggeredInterval);
+    STRICT_EXPECTED_CALL(AuditFeed_IsRunning(&task.auditFeed)).SetReturn(false);
+    STRICT_EXPECTED_CALL(AuditFeed_Lock(&task.auditFeed));
+    STRICT_EXPECTED_CALL(AuditFeed_Unlock(&task.auditFeed));
+    ExpectPeriodicCollectors(&task, &highPriorityQueue, &operationalEventsQueue);
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_OPERATIONAL_EVENT, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AgentConfigurationErrorCollector_GetEvents(&operationalEventsQueue));
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditFeed_Lock(&task.auditFeed));
+    STRICT_EXPECTED_CALL(AuditDispatcher_Scan(&task.auditDispatcher));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_PROCESS_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessCreationCollector_GetAggregatedEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_CONNECTION_CREATE, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ConnectionCreateEventCollector_GetAggregatedEvents(&highPriorityQueue));
+    STRICT_EXPECTED_CALL(AuditFeed_Unlock(&task.auditFeed));
+    STRICT_EXPECTED_CALL(WorkerPool_Submit(&task.triggeredWorkers, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPriority(EVENT_TYPE_DIAGNOSTIC, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(DiagnosticEventCollector_GetEvents(&highPriorityQueue));
+    ExpectSchedulesUpdated(false);
 
+    EventMonitorTask_Execute(&task);
+    EventMonitorTask_Execute(&task);
     EventMonitorTask_Execute(&task);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_FALSE(task.isAuditFed);
 
+    STRICT_EXPECTED_CALL(AuditFeed_Deinit(&task.auditFeed));
     EventMonitorTask_Deinit(&task);
+    ASSERT_IS_FALSE(task.auditFeedStarted);
 }
 
 END_TEST_SUITE(event_monitor_task_ut)
@@ -17,6 +17,7 @@
 #include "twin_configuration.h"
 #undef ENABLE_MOCKS
 
+#include "message_compressor.h"
 #include "tasks/event_publisher_task.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -32,21 +33,39 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
-MessageSerializerResultValues Mocked_MessageSerializer_CreateSecurityMessage(SyncQueue** queues, uint32_t size, void** buffer) {
+static SyncQueue operationalEventsQueue;
+static SyncQueue highPriorityQueue;
+static SyncQueue lowPriorityQueue;
+
+static uint32_t mockedHighPriorityQueueSize = 0;
+static uint32_t mockedLowPriorityQueueSize = 0;
+static int mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+
+static uint32_t* GetMockedQueueSize(SyncQueue* queue) {
+    return (queue == &lowPriorityQueue) ? &mockedLowPriorityQueueSize : &mockedHighPriorityQueueSize;
+}
+
+MessageSerializerResultValues Mocked_MessageSerializer_CreateSecurityMessage(SyncQueue** queues, uint32_t size, MessageSerializerEncoding encoding, bool compress, void** buffer, uint32_t* bufferSize) {
+    // every message takes a single event out of the main queue
+    uint32_t* mainQueueSize = GetMockedQueueSize(queues[1]);
+    if (*mainQueueSize == 0) {
+        return MESSAGE_SERIALIZER_EMPTY;
+    }
+    --(*mainQueueSize);
+
     *buffer = strdup("a");
+    *bufferSize = 1;
     return MESSAGE_SERIALIZER_OK;
 }
-static uint32_t mockedSyncQueueGetSizesize = 0;
-static int mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
 
 int Mocked_SyncQueue_GetSize(SyncQueue* queue, uint32_t* size){
-    *size = mockedSyncQueueGetSizesize;
+    *size = *GetMockedQueueSize(queue);
     return mockedSyncQueueGetSizeReturnValue;
 }
 
 static uint32_t mockedCurrentMemoryConsumption = 0;
 static uint32_t mockedMaxMessageSize = 0;
-
+static uint32_t mockedMaxPublishedBytesPerCycle = 0;
 
 MemoryMonitorResultValues Mocked_MemoryMonitor_CurrentConsumption(uint32_t* size) {
     *size = mockedCurrentMemoryConsumption;
@@ -58,6 +77,11 @@ TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* max
     return TWIN_OK;
 }
 
+TwinConfigurationResult Mocked_TwinConfiguration_GetMaxPublishedBytesPerCycle(uint32_t* maxPublishedBytesPerCycle) {
+    *maxPublishedBytesPerCycle = mockedMaxPublishedBytesPerCycle;
+    return TWIN_OK;
+}
+
 BEGIN_TEST_SUITE(event_publisher_task_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -73,6 +97,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     umocktypes_charptr_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerEncoding, int);
     REGISTER_UMOCK_ALIAS_TYPE(TwinConfigurationResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
 
@@ -86,7 +111,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateSecurityMessage, Mocked_MessageSerializer_CreateSecurityMessage);
     REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, Mocked_MemoryMonitor_CurrentConsumption);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, Mocked_TwinConfiguration_GetMaxMessageSize);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxPublishedBytesPerCycle, Mocked_TwinConfiguration_GetMaxPublishedBytesPerCycle);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
+    REGISTER_GLOBAL_MOCK_RETURN(IoTHubAdapter_SendMessageAsync, true);
 
 }
 
@@ -95,6 +122,7 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     REGISTER_GLOBAL_MOCK_HOOK(MessageSerializer_CreateSecurityMessage, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(MemoryMonitor_CurrentConsumption, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxPublishedBytesPerCycle, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
 
     umock_c_deinit();
@@ -108,13 +136,14 @@ TEST_FUNCTION_INITIALIZE(method_init)
     // the default behavior  is that we haven't passed the maxMessageSize
     mockedCurrentMemoryConsumption = 0;
     mockedMaxMessageSize = mockedCurrentMemoryConsumption + 10;
+    mockedMaxPublishedBytesPerCycle = 100;
+    // a single event in each queue
+    mockedHighPriorityQueueSize = 1;
+    mockedLowPriorityQueueSize = 1;
 }
 
 TEST_FUNCTION(EventPublisherTask_Init_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -134,9 +163,6 @@ TEST_FUNCTION(EventPublisherTask_Init_ExpectSuccess)
 
 TEST_FUNCTION(EventPublisherTask_Deinit_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -160,9 +186,6 @@ TEST_FUNCTION(EventPublisherTask_Deinit_ExpectSuccess)
 
 TEST_FUNCTION(EventPublisherTask_ExecuteTimeoutsDidNotPass_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -174,6 +197,9 @@ TEST_FUNCTION(EventPublisherTask_ExecuteTimeoutsDidNotPass_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
@@ -188,9 +214,6 @@ TEST_FUNCTION(EventPublisherTask_ExecuteTimeoutsDidNotPass_ExpectSuccess)
 
 TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -202,14 +225,18 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_Exp
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     EventPublisherTask_Execute(&task);
 
@@ -220,9 +247,6 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeout_Exp
 
 TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -234,14 +258,18 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_Exp
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     EventPublisherTask_Execute(&task);
 
@@ -252,9 +280,6 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueDidNotTimeoutLowQueueTimeout_Exp
 
 TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueTimeout_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;    
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -266,18 +291,23 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueTimeout_ExpectSuc
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // low priority queue
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     EventPublisherTask_Execute(&task);
 
@@ -288,9 +318,6 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueTimeout_ExpectSuc
 
 TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeoutCeateSecurityMessageFailed_ExpectFailure)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -302,6 +329,9 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeoutCeat
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
@@ -309,7 +339,7 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeoutCeat
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&highPriorityQueue, &lowPriorityQueue};
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(MESSAGE_SERIALIZER_EXCEPTION);
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(MESSAGE_SERIALIZER_EXCEPTION);
     
     EventPublisherTask_Execute(&task);
 
@@ -320,9 +350,6 @@ TEST_FUNCTION(EventPublisherTask_ExecuteHigQueueTimeoutLowQueueDidNotTimeoutCeat
 
 TEST_FUNCTION(EventPublisherTask_Execute_MaxMessageSizeExceeded_ExpectSuccess)
 {
-    SyncQueue operationalEventsQueue;
-    SyncQueue highPriorityQueue;
-    SyncQueue lowPriorityQueue;
     IoTHubAdapter adapter;
     EventPublisherTask task;
 
@@ -333,17 +360,20 @@ TEST_FUNCTION(EventPublisherTask_Execute_MaxMessageSizeExceeded_ExpectSuccess)
 
     mockedCurrentMemoryConsumption = 10;
     mockedMaxMessageSize = 5;
-    mockedSyncQueueGetSizesize = 1;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
     STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&highPriorityQueue, &lowPriorityQueue};
-    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // high priority queue
     STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
@@ -355,4 +385,194 @@ TEST_FUNCTION(EventPublisherTask_Execute_MaxMessageSizeExceeded_ExpectSuccess)
     EventPublisherTask_Deinit(&task);
 }
 
+TEST_FUNCTION(EventPublisherTask_Execute_HighQueueHasBacklog_ExpectQueueDrainedInSingleExecution)
+{
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityQueueSize = 3;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    // a message is sent for every event until the queue is empty
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    for (int i = 0; i < 3; i++) {
+        STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+        STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    }
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, mockedHighPriorityQueueSize);
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_Execute_PublishedBytesLimitReached_ExpectDrainStopped)
+{
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    // every message is a single byte
+    mockedMaxPublishedBytesPerCycle = 2;
+    mockedHighPriorityQueueSize = 3;
+    mockedLowPriorityQueueSize = 3;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    for (int i = 0; i < 2; i++) {
+        STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+        STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    }
+
+    // the limit was reached, the low priority queue still gets a single message
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&lowPriorityQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&lowPriorityQueue, IGNORED_PTR_ARG));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, mockedHighPriorityQueueSize);
+    ASSERT_ARE_EQUAL(int, 2, mockedLowPriorityQueueSize);
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_Execute_SendMessageFailed_ExpectDrainStopped)
+{
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityQueueSize = 3;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, NULL)).SetReturn(false);
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_Execute_CompressionEnabled_ExpectCompressedMessageSent)
+{
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+    const bool compressMessages = true;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityQueueSize = 1;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG)).CopyOutArgumentBuffer_compressMessages(&compressMessages, sizeof(compressMessages));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    // the serializer compresses the message and the adapter marks it with the content encoding
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_JSON, true, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, NULL, MESSAGE_COMPRESSOR_CONTENT_ENCODING));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
+TEST_FUNCTION(EventPublisherTask_Execute_CborEncodingEnabled_ExpectCborMessageSent)
+{
+    IoTHubAdapter adapter;
+    EventPublisherTask task;
+    const bool encodeMessagesAsCbor = true;
+
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    bool result = EventPublisherTask_Init(&task, &highPriorityQueue, &lowPriorityQueue, &operationalEventsQueue, &adapter);
+    ASSERT_IS_TRUE(result);
+
+    mockedHighPriorityQueueSize = 1;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetHighPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetLowPriorityMessageFrequency(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxPublishedBytesPerCycle(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetCompressMessages(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetEncodeMessagesAsCbor(IGNORED_PTR_ARG)).CopyOutArgumentBuffer_encodeMessagesAsCbor(&encodeMessagesAsCbor, sizeof(encodeMessagesAsCbor));
+    STRICT_EXPECTED_CALL(MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime());
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(10); // high priority queue
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeDiff(IGNORED_NUM_ARG, IGNORED_NUM_ARG)).SetReturn(0); // low priority queue
+
+    // the serializer encodes the message as CBOR and the adapter marks it with the content type
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageSerializer_CreateSecurityMessage(IGNORED_PTR_ARG, IGNORED_NUM_ARG, MESSAGE_SERIALIZER_ENCODING_CBOR, false, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SendMessageAsync(&adapter, IGNORED_PTR_ARG, 1, MESSAGE_SERIALIZER_CBOR_CONTENT_TYPE, NULL));
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&highPriorityQueue, IGNORED_PTR_ARG));
+
+    EventPublisherTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    EventPublisherTask_Deinit(&task);
+}
+
 END_TEST_SUITE(event_publisher_task_ut)
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/uniqueid.h"
+#undef ENABLE_MOCKS
+
+#include "event_splitter.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+#define EVENT_PREFIX "{\"Category\":\"Periodic\",\"Id\":\""
+#define EVENT_INFIX "\",\"Payload\":["
+#define EVENT_SUFFIX "],\"IsEmpty\":false}"
+#define ORIGINAL_ID "00000000-0000-0000-0000-000000000000"
+#define NEW_ID "df7e6af8-0c12-44db-a2b8-eaa19ea712af"
+
+static const char EVENT[] = EVENT_PREFIX ORIGINAL_ID EVENT_INFIX "{\"a\":\"1\"},{\"b\":\"2\"},{\"c\":\"3\"}" EVENT_SUFFIX;
+static const char EXPECTED_FIRST_EVENT[] = EVENT_PREFIX NEW_ID EVENT_INFIX "{\"a\":\"1\"},{\"b\":\"2\"}" EVENT_SUFFIX;
+static const char EXPECTED_SECOND_EVENT[] = EVENT_PREFIX NEW_ID EVENT_INFIX "{\"c\":\"3\"}" EVENT_SUFFIX;
+
+#define MAX_SPLIT_EVENTS 8
+static char* splitEvents[MAX_SPLIT_EVENTS];
+static uint32_t splitEventsCount = 0;
+static bool callbackResult = true;
+
+UNIQUEID_RESULT Mocked_UniqueId_Generate(char* uid, size_t len) {
+    ASSERT_ARE_EQUAL(int, sizeof(NEW_ID), len);
+    memcpy(uid, NEW_ID, len);
+    return UNIQUEID_OK;
+}
+
+static bool Test_SplitCallback(void* context, char* event, uint32_t eventSize) {
+    ASSERT_ARE_EQUAL(void_ptr, &splitEventsCount, context);
+    ASSERT_ARE_EQUAL(int, strlen(event), eventSize);
+    ASSERT_IS_TRUE(splitEventsCount < MAX_SPLIT_EVENTS);
+
+    splitEvents[splitEventsCount++] = event;
+    return callbackResult;
+}
+
+BEGIN_TEST_SUITE(event_splitter_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    REGISTER_UMOCK_ALIAS_TYPE(UNIQUEID_RESULT, int);
+    REGISTER_GLOBAL_MOCK_HOOK(UniqueId_Generate, Mocked_UniqueId_Generate);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    REGISTER_GLOBAL_MOCK_HOOK(UniqueId_Generate, NULL);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    splitEventsCount = 0;
+    callbackResult = true;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    for (uint32_t i = 0; i < splitEventsCount; i++) {
+        free(splitEvents[i]);
+    }
+}
+
+TEST_FUNCTION(EventSplitter_Split_PayloadExceedsMaxSize_ExpectEventsWithSameMetadata)
+{
+    STRICT_EXPECTED_CALL(UniqueId_Generate(IGNORED_PTR_ARG, sizeof(NEW_ID)));
+    STRICT_EXPECTED_CALL(UniqueId_Generate(IGNORED_PTR_ARG, sizeof(NEW_ID)));
+
+    EventSplitterResult result = EventSplitter_Split(EVENT, strlen(EVENT), strlen(EXPECTED_FIRST_EVENT), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 2, splitEventsCount);
+    ASSERT_ARE_EQUAL(char_ptr, EXPECTED_FIRST_EVENT, splitEvents[0]);
+    ASSERT_ARE_EQUAL(char_ptr, EXPECTED_SECOND_EVENT, splitEvents[1]);
+}
+
+TEST_FUNCTION(EventSplitter_Split_ElementsWithEscapedStrings_ExpectElementsKept)
+{
+    static const char event[] = EVENT_PREFIX ORIGINAL_ID EVENT_INFIX "{\"a\":\"],\\\"}\"}, {\"b\":[1,{\"c\":2}]}" EVENT_SUFFIX;
+    static const char expectedFirst[] = EVENT_PREFIX NEW_ID EVENT_INFIX "{\"a\":\"],\\\"}\"}" EVENT_SUFFIX;
+    static const char expectedSecond[] = EVENT_PREFIX NEW_ID EVENT_INFIX "{\"b\":[1,{\"c\":2}]}" EVENT_SUFFIX;
+
+    EventSplitterResult result = EventSplitter_Split(event, strlen(event), strlen(expectedSecond), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, splitEventsCount);
+    ASSERT_ARE_EQUAL(char_ptr, expectedFirst, splitEvents[0]);
+    ASSERT_ARE_EQUAL(char_ptr, expectedSecond, splitEvents[1]);
+}
+
+TEST_FUNCTION(EventSplitter_Split_ElementExceedsMaxSize_ExpectElementDropped)
+{
+    static const char event[] = EVENT_PREFIX ORIGINAL_ID EVENT_INFIX "{\"a\":\"1\"},{\"b\":\"this element is too large\"},{\"c\":\"3\"}" EVENT_SUFFIX;
+    static const char expected[] = EVENT_PREFIX NEW_ID EVENT_INFIX "{\"a\":\"1\"}" EVENT_SUFFIX;
+
+    EventSplitterResult result = EventSplitter_Split(event, strlen(event), strlen(expected), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, splitEventsCount);
+    ASSERT_ARE_EQUAL(char_ptr, expected, splitEvents[0]);
+    ASSERT_ARE_EQUAL(char_ptr, EXPECTED_SECOND_EVENT, splitEvents[1]);
+}
+
+TEST_FUNCTION(EventSplitter_Split_MetadataExceedsMaxSize_ExpectNotSplittable)
+{
+    static const char emptyEvent[] = EVENT_PREFIX NEW_ID EVENT_INFIX EVENT_SUFFIX;
+
+    EventSplitterResult result = EventSplitter_Split(EVENT, strlen(EVENT), strlen(emptyEvent), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_NOT_SPLITTABLE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, splitEventsCount);
+}
+
+TEST_FUNCTION(EventSplitter_Split_NoPayloadArray_ExpectNotSplittable)
+{
+    static const char event[] = "{\"Category\":\"Periodic\",\"Payload\":\"[1,2]\"}";
+
+    EventSplitterResult result = EventSplitter_Split(event, strlen(event), 10, Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_NOT_SPLITTABLE, result);
+    ASSERT_ARE_EQUAL(int, 0, splitEventsCount);
+}
+
+TEST_FUNCTION(EventSplitter_Split_MalformedEvent_ExpectNotSplittable)
+{
+    static const char event[] = "{\"Category\":\"Periodic\",\"Payload\":[{\"a\":1},{\"b\":";
+
+    EventSplitterResult result = EventSplitter_Split(event, strlen(event), 10, Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_NOT_SPLITTABLE, result);
+    ASSERT_ARE_EQUAL(int, 0, splitEventsCount);
+}
+
+TEST_FUNCTION(EventSplitter_Split_CallbackFailed_ExpectFailure)
+{
+    callbackResult = false;
+
+    EventSplitterResult result = EventSplitter_Split(EVENT, strlen(EVENT), strlen(EXPECTED_FIRST_EVENT), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(int, 1, splitEventsCount);
+}
+
+TEST_FUNCTION(EventSplitter_Split_GenerateIdFailed_ExpectFailure)
+{
+    STRICT_EXPECTED_CALL(UniqueId_Generate(IGNORED_PTR_ARG, sizeof(NEW_ID))).SetReturn(UNIQUEID_ERROR);
+
+    EventSplitterResult result = EventSplitter_Split(EVENT, strlen(EVENT), strlen(EXPECTED_FIRST_EVENT), Test_SplitCallback, &splitEventsCount);
+
+    ASSERT_ARE_EQUAL(int, EVENT_SPLITTER_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, splitEventsCount);
+}
+
+END_TEST_SUITE(event_splitter_ut)
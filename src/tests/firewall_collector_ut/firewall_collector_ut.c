@@ -21,6 +21,7 @@
 
 #include "collectors/firewall_collector.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -202,7 +203,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_FIREWALL_CONFIGURATION)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -227,7 +228,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_NoIptables_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_FIREWALL_CONFIGURATION)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
@@ -290,7 +291,7 @@ TEST_FUNCTION(FirewallCollector_GetEvents_ExpectFailure)
 
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_FIREWALL_CONFIGURATION)).SetFailReturn(!QUEUE_OK);
 
     // no fail return
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
@@ -10,7 +10,7 @@
 
 #define ENABLE_MOCKS
 #include "os_utils/linux/audit/audit_search.h"
-#include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/linux/generic_audit_event.h"
@@ -28,7 +28,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 
 static char* MOCKED_STRING_VALUE = "I'm sorry, the old Taylor can't come to the phone right now";
 static int MOCKED_INT_VALUE = 29;
-static JsonObjectWriterHandle MOCKED_JSON_WRITER = (JsonObjectWriterHandle)0x1;
+static JsonStreamWriter* MOCKED_JSON_WRITER = (JsonStreamWriter*)0x1;
 static AuditSearch MOCKED_AUDIT_SEARCH;
 static const char* READ_FIELD_NAME = "field";
 static const char* WRITE_JSON_KEY = "json key";
@@ -63,7 +63,6 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(AuditSearchResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*)
 
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_ReadString, Mocked_AuditSearch_ReadString);
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_InterpretString, Mocked_AuditSearch_InterpretString);
@@ -88,7 +87,7 @@ TEST_FUNCTION_INITIALIZE(method_init)
 TEST_FUNCTION(GenericAuditEvent_HandleStringValue_ExpectSuccess)
 {
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_OK);
 
     EventCollectorResult result = GenericAuditEvent_HandleStringValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -107,7 +106,7 @@ TEST_FUNCTION(GenericAuditEvent_HandleStringValue_ReadFailed_ExpectFailure)
 TEST_FUNCTION(GenericAuditEvent_HandleStringValue_WriteFailed_ExpectFailure)
 {
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
 
     EventCollectorResult result = GenericAuditEvent_HandleStringValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
@@ -130,7 +129,7 @@ TEST_FUNCTION(GenericAuditEvent_HandleStringValue_FieldDoesNotExist_ExpectSucces
 TEST_FUNCTION(GenericAuditEvent_HandleInterpretStringValue_ExpectSuccess)
 {
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_OK);
 
     EventCollectorResult result = GenericAuditEvent_HandleInterpretStringValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -149,7 +148,7 @@ TEST_FUNCTION(GenericAuditEvent_HandleInterpretStringValue_ReadFailed_ExpectFail
 TEST_FUNCTION(GenericAuditEvent_HandleInterpretStringValue_WriteFailed_ExpectFailure)
 {
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_STRING_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
 
     EventCollectorResult result = GenericAuditEvent_HandleInterpretStringValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
@@ -172,7 +171,7 @@ TEST_FUNCTION(GenericAuditEvent_HandleInterpretStringValue_FieldDoesNotExist_Exp
 TEST_FUNCTION(GenericAuditEvent_HandleIntValue_ExpectSuccess)
 {
     STRICT_EXPECTED_CALL(AuditSearch_ReadInt(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_INT_VALUE)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteInt(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_INT_VALUE)).SetReturn(JSON_WRITER_OK);
 
     EventCollectorResult result = GenericAuditEvent_HandleIntValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -191,7 +190,7 @@ TEST_FUNCTION(GenericAuditEvent_HandleIntValue_ReadFailed_ExpectFailure)
 TEST_FUNCTION(GenericAuditEvent_HandleIntValue_WriteFailed_ExpectFailure)
 {
     STRICT_EXPECTED_CALL(AuditSearch_ReadInt(&MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_INT_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteInt(MOCKED_JSON_WRITER, WRITE_JSON_KEY, MOCKED_INT_VALUE)).SetReturn(JSON_WRITER_EXCEPTION);
 
     EventCollectorResult result = GenericAuditEvent_HandleIntValue(MOCKED_JSON_WRITER, &MOCKED_AUDIT_SEARCH, READ_FIELD_NAME, WRITE_JSON_KEY, true);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
@@ -14,6 +14,7 @@
 #include "internal/time_utils.h"
 #include "json/json_object_writer.h"
 #include "json/json_array_writer.h"
+#include "json/json_stream_writer.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/generic_event.h"
@@ -28,6 +29,7 @@ static const char utcTimeStr[] = "2019-03-13T08:04:45+0000";
 
 static JsonObjectWriterHandle mockHandle = (JsonObjectWriterHandle)0x1;
 static JsonArrayWriterHandle mockPayload = (JsonArrayWriterHandle) 0x10;
+static JsonStreamWriter* mockStreamWriter = (JsonStreamWriter*) 0x100;
 static const char eventCategory[] = "Abc";
 static const char eventType[] = "myType";
 static const char eventName[] = "Mnb Sdf";
@@ -102,6 +104,32 @@ void GenericEvent_AddPayload_SetFailExpectedValues(bool isEmpty){
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockHandle, PAYLOAD_KEY, mockPayload)).SetFailReturn(!JSON_WRITER_OK);
 }
 
+void GenericEvent_WriteMetadataWithTimes_SetExpectedValues() {
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_CATEGORY_KEY, eventCategory)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_TYPE_KEY, eventType)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_NAME_KEY, eventName)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_PAYLOAD_SCHEMA_VERSION_KEY, eventVersion)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(UniqueId_Generate(IGNORED_PTR_ARG, 37));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_ID_KEY, GUID)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeAsString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_LOCAL_TIMESTAMP_KEY, localTimeStr)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(TimeUtils_GetLocalTimeAsUTCTimeAsString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_UTC_TIMESTAMP_KEY, utcTimeStr)).SetReturn(JSON_WRITER_OK);
+}
+
+void GenericEvent_WriteMetadataWithTimes_SetFailExpectedValues() {
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_CATEGORY_KEY, eventCategory)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_TYPE_KEY, eventType)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_NAME_KEY, eventName)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_PAYLOAD_SCHEMA_VERSION_KEY, eventVersion)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(UniqueId_Generate(IGNORED_PTR_ARG, 37)).SetFailReturn(UNIQUEID_ERROR);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_ID_KEY, GUID)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(TimeUtils_GetTimeAsString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(false);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_LOCAL_TIMESTAMP_KEY, localTimeStr)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(TimeUtils_GetLocalTimeAsUTCTimeAsString(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(false);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(mockStreamWriter, EVENT_UTC_TIMESTAMP_KEY, utcTimeStr)).SetFailReturn(!JSON_WRITER_OK);
+}
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     char temp_str[256];
@@ -261,5 +289,67 @@ TEST_FUNCTION(GenericEvent_AddEmptyPayload_ExpectFail)
     umock_c_negative_tests_deinit();
 }
 
+TEST_FUNCTION(GenericEvent_WriteMetadataWithTimes_ExpectSuccess)
+{
+    time_t eventTime;
+    GenericEvent_WriteMetadataWithTimes_SetExpectedValues();
+
+    EventCollectorResult result = GenericEvent_WriteMetadataWithTimes(mockStreamWriter, eventCategory, eventName, eventType, eventVersion, &eventTime);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(GenericEvent_WriteMetadataWithTimes_ExpectFailure)
+{
+    umock_c_negative_tests_init();
+
+    time_t eventTime;
+    GenericEvent_WriteMetadataWithTimes_SetFailExpectedValues();
+
+    umock_c_negative_tests_snapshot();
+
+    for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
+        umock_c_negative_tests_reset();
+        umock_c_negative_tests_fail_call(i);
+
+        EventCollectorResult result = GenericEvent_WriteMetadataWithTimes(mockStreamWriter, eventCategory, eventName, eventType, eventVersion, &eventTime);
+        ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    }
+    umock_c_negative_tests_deinit();
+}
+
+TEST_FUNCTION(GenericEvent_BeginAndEndPayload_ExpectSuccess)
+{
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteBool(mockStreamWriter, EVENT_IS_EMPTY_KEY, false)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginArray(mockStreamWriter, PAYLOAD_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndArray(mockStreamWriter)).SetReturn(JSON_WRITER_OK);
+
+    EventCollectorResult result = GenericEvent_BeginPayload(mockStreamWriter, false);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    result = GenericEvent_EndPayload(mockStreamWriter);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(GenericEvent_BeginPayload_ExpectFailure)
+{
+    umock_c_negative_tests_init();
+
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteBool(mockStreamWriter, EVENT_IS_EMPTY_KEY, true)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginArray(mockStreamWriter, PAYLOAD_KEY)).SetFailReturn(!JSON_WRITER_OK);
+
+    umock_c_negative_tests_snapshot();
+
+    for (int i = 0; i < umock_c_negative_tests_call_count(); i++) {
+        umock_c_negative_tests_reset();
+        umock_c_negative_tests_fail_call(i);
+
+        EventCollectorResult result = GenericEvent_BeginPayload(mockStreamWriter, true);
+        ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, result);
+    }
+    umock_c_negative_tests_deinit();
+}
 
 END_TEST_SUITE(generic_event_ut)
\ No newline at end of file
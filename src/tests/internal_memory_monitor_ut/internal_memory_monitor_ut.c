@@ -4,6 +4,7 @@
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
 #include "umock_c.h"
+#include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
 #include "twin_configuration.h"
@@ -38,6 +39,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_IS_NOT_NULL(test_serialize_mutex);
 
     umock_c_init(on_umock_c_error);
+    umocktypes_charptr_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
@@ -64,6 +66,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Consume_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -75,6 +78,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Consume_TwoItems_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -89,19 +93,58 @@ TEST_FUNCTION(InternalMemoryMonitor_Consume_MemoryExceeded_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(15);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, result);
 
     InternalMemoryMonitor_Deinit();
 }
 
-TEST_FUNCTION(InternalMemoryMonitor_Consume_TwinFailed_ExpectFailure)
+TEST_FUNCTION(InternalMemoryMonitor_UpdateLimit_TwinFailed_ExpectLimitKept)
 {
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
+
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG)).SetReturn(!TWIN_OK);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, InternalMemoryMonitor_UpdateLimit());
+
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(15);
-    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, result);
+
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_Consume_LimitCached_ExpectTwinNotRead)
+{
+    InternalMemoryMonitor_Init();
+    mockedMaxLocalCacheSize = 10;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(4));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(6));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(1));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Release(10));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    InternalMemoryMonitor_Deinit();
+}
+
+TEST_FUNCTION(InternalMemoryMonitor_Consume_SizeAboveLimit_ExpectNoOverflow)
+{
+    InternalMemoryMonitor_Init();
+    mockedMaxLocalCacheSize = 10;
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
+
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_Consume(5));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_MEMORY_EXCEEDED, InternalMemoryMonitor_Consume(UINT32_MAX));
+
+    uint32_t size = 0;
+    InternalMemoryMonitor_CurrentConsumption(&size);
+    ASSERT_ARE_EQUAL(int, 5, size);
 
     InternalMemoryMonitor_Deinit();
 }
@@ -111,6 +154,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -127,6 +171,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_TwoItems_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
 
@@ -141,6 +186,7 @@ TEST_FUNCTION(InternalMemoryMonitor_Release_InvalidSize_ExpectFailure)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
 
     MemoryMonitorResultValues result = InternalMemoryMonitor_Release(5);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_INVALID_RELEASE_SIZE, result);
@@ -153,6 +199,7 @@ TEST_FUNCTION(InternalMemoryMonitor_CurrentConsumption_ExpectSuccess)
     InternalMemoryMonitor_Init();
     mockedMaxLocalCacheSize = 10;
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxLocalCacheSize(IGNORED_PTR_ARG));
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, InternalMemoryMonitor_UpdateLimit());
 
     MemoryMonitorResultValues result = InternalMemoryMonitor_Consume(7);
     ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_OK, result);
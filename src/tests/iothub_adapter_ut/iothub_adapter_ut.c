@@ -333,10 +333,100 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_ExpectSuccess)
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
-    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend));
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL);
+    ASSERT_IS_TRUE(result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);   
+}
+
+TEST_FUNCTION(IoTHubAdapter_SendMessageAsyncWithContentEncoding_ExpectEncodingSet)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    
+    ASSERT_IS_TRUE(result);
+    
+    char* dataToSend = "This is a message";
+    IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
+    STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetContentEncodingSystemProperty(mockedMessageHandle, "gzip")).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, "gzip");
+    ASSERT_IS_TRUE(result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    IoTHubAdapter_Deinit(&adapter);   
+}
+
+TEST_FUNCTION(IoTHubAdapter_SendMessageAsyncWithContentType_ExpectTypeSet)
+{
+    IoTHubAdapter adapter;
+    SyncQueue queue;
+
+    IOTHUB_MODULE_CLIENT_HANDLE mockHandle = (IOTHUB_MODULE_CLIENT_HANDLE)0x1;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(MOCKED_LOCK);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetConnectionString()).SetReturn("");
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_CreateFromConnectionString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(mockHandle);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetOption(mockHandle, OPTION_LOG_TRACE, IGNORED_PTR_ARG)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetConnectionStatusCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SetModuleTwinCallback(mockHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_Init(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    
+    bool result = IoTHubAdapter_Init(&adapter, &queue);
+    
+    ASSERT_IS_TRUE(result);
+    
+    char* dataToSend = "This is a message";
+    IOTHUB_MESSAGE_HANDLE mockedMessageHandle = (IOTHUB_MESSAGE_HANDLE)(0x2);
+    STRICT_EXPECTED_CALL(Lock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(LocalConfiguration_UseDps()).SetReturn(false);
+    STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(mockedMessageHandle);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetAsSecurityMessage(mockedMessageHandle)).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubMessage_SetContentTypeSystemProperty(mockedMessageHandle, "application/cbor")).SetReturn(IOTHUB_MESSAGE_OK);
+    STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
+    STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
+    STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
+
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), "application/cbor", NULL);
     ASSERT_IS_TRUE(result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -374,10 +464,12 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageSentCallback_ExpectSucce
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter)).SetReturn(IOTHUB_CLIENT_OK);
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
-    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend));
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL);
     ASSERT_IS_TRUE(result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -415,10 +507,12 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CallMessageConfirmationCallback_Exp
     STRICT_EXPECTED_CALL(IoTHubModuleClient_SendEventAsync(mockHandle, mockedMessageHandle, IGNORED_PTR_ARG, &adapter));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, strlen(dataToSend)));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, MESSAGE_BILLING_MULTIPLE));
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
-    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend));
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL);
     ASSERT_IS_TRUE(result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -454,7 +548,7 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_CreateMessageFromBytesFailed_Expect
     STRICT_EXPECTED_CALL(IoTHubMessage_CreateFromByteArray(dataToSend, strlen(dataToSend))).SetReturn(NULL);
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
     
-    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend));
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL);
     ASSERT_IS_FALSE(result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -491,7 +585,7 @@ TEST_FUNCTION(IoTHubAdapter_SendMessageAsync_SetAsSecurityMessageFailed_ExpectFa
     STRICT_EXPECTED_CALL(IoTHubMessage_Destroy(mockedMessageHandle));
     STRICT_EXPECTED_CALL(Unlock(MOCKED_LOCK)).SetReturn(LOCK_OK);
 
-    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend));
+    result = IoTHubAdapter_SendMessageAsync(&adapter, dataToSend, strlen(dataToSend), NULL, NULL);
     ASSERT_IS_FALSE(result);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -34,6 +34,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(JSON_Status, int);
+    REGISTER_UMOCK_ALIAS_TYPE(JSON_Value_Type, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 }
 
@@ -395,4 +396,136 @@ TEST_FUNCTION(JsonObjectWriter_SerializeFailed_ExpectFailure)
     JsonObjectWriter_Deinit(writer);
 }
 
+TEST_FUNCTION(JsonObjectWriter_GetSerializedSize_ExpectSuccess)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    STRICT_EXPECTED_CALL(json_serialization_size(writer.rootValue)).SetReturn(4);
+
+    uint32_t size = 0;
+    JsonWriterResult result = JsonObjectWriter_GetSerializedSize((JsonObjectWriterHandle)&writer, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    ASSERT_ARE_EQUAL(int, 3, size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_GetSerializedSizeFailed_ExpectFailure)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    STRICT_EXPECTED_CALL(json_serialization_size(writer.rootValue)).SetReturn(0);
+
+    uint32_t size = 0;
+    JsonWriterResult result = JsonObjectWriter_GetSerializedSize((JsonObjectWriterHandle)&writer, &size);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_Copy_ExpectDeepCopy)
+{
+    JsonObjectWriter source = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    JsonObjectWriterHandle copy = NULL;
+    JSON_Value* valuePtr = (JSON_Value*)0x3;
+    STRICT_EXPECTED_CALL(json_value_deep_copy(source.rootValue)).SetReturn(valuePtr);
+    JSON_Object* objectPtr = (JSON_Object*)0x4;
+    STRICT_EXPECTED_CALL(json_value_get_object(valuePtr)).SetReturn(objectPtr);
+
+    JsonWriterResult result = JsonObjectWriter_Copy(&copy, (JsonObjectWriterHandle)&source);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    JsonObjectWriter* copyObj = (JsonObjectWriter*)copy;
+    ASSERT_ARE_EQUAL(void_ptr, valuePtr, copyObj->rootValue);
+    ASSERT_ARE_EQUAL(void_ptr, objectPtr, copyObj->rootObject);
+    ASSERT_IS_TRUE(copyObj->shouldFree);
+
+    // the copy owns its value
+    STRICT_EXPECTED_CALL(json_value_free(valuePtr));
+    JsonObjectWriter_Deinit(copy);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_Copy_DeepCopyFailed_ExpectFailure)
+{
+    JsonObjectWriter source = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    JsonObjectWriterHandle copy = NULL;
+    STRICT_EXPECTED_CALL(json_value_deep_copy(source.rootValue)).SetReturn(NULL);
+
+    JsonWriterResult result = JsonObjectWriter_Copy(&copy, (JsonObjectWriterHandle)&source);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, result);
+    ASSERT_IS_NULL(copy);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_GetKeyAt_ExpectSuccess)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    STRICT_EXPECTED_CALL(json_object_get_name(writer.rootObject, 1)).SetReturn("key");
+    STRICT_EXPECTED_CALL(json_object_get_name(writer.rootObject, 2)).SetReturn(NULL);
+
+    const char* key = NULL;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_GetKeyAt((JsonObjectWriterHandle)&writer, 1, &key));
+    ASSERT_ARE_EQUAL(char_ptr, "key", key);
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonObjectWriter_GetKeyAt((JsonObjectWriterHandle)&writer, 2, &key));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_ReadString_ExpectSuccess)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    JSON_Value* valuePtr = (JSON_Value*)0x3;
+    STRICT_EXPECTED_CALL(json_object_dothas_value(writer.rootObject, "key")).SetReturn(true);
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "key")).SetReturn(valuePtr);
+    STRICT_EXPECTED_CALL(json_value_get_type(valuePtr)).SetReturn(JSONString);
+    STRICT_EXPECTED_CALL(json_value_get_string(valuePtr)).SetReturn("value");
+
+    const char* value = NULL;
+    JsonWriterResult result = JsonObjectWriter_ReadString((JsonObjectWriterHandle)&writer, "key", &value);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "value", value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_ReadString_NotAString_ExpectFailure)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    JSON_Value* valuePtr = (JSON_Value*)0x3;
+    STRICT_EXPECTED_CALL(json_object_dothas_value(writer.rootObject, "key")).SetReturn(true);
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "key")).SetReturn(valuePtr);
+    STRICT_EXPECTED_CALL(json_value_get_type(valuePtr)).SetReturn(JSONNumber);
+
+    const char* value = NULL;
+    JsonWriterResult result = JsonObjectWriter_ReadString((JsonObjectWriterHandle)&writer, "key", &value);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, result);
+    ASSERT_IS_NULL(value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(JsonObjectWriter_ResetValue_ExpectEmptyValueOfSameType)
+{
+    JsonObjectWriter writer = {(JSON_Value*)0x1, (JSON_Object*)0x2, true};
+    JSON_Value* stringPtr = (JSON_Value*)0x3;
+    JSON_Value* numberPtr = (JSON_Value*)0x4;
+    JSON_Value* objectPtr = (JSON_Value*)0x5;
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "string")).SetReturn(stringPtr);
+    STRICT_EXPECTED_CALL(json_value_get_type(stringPtr)).SetReturn(JSONString);
+    STRICT_EXPECTED_CALL(json_object_set_string(writer.rootObject, "string", "")).SetReturn(JSONSuccess);
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "number")).SetReturn(numberPtr);
+    STRICT_EXPECTED_CALL(json_value_get_type(numberPtr)).SetReturn(JSONNumber);
+    STRICT_EXPECTED_CALL(json_object_set_number(writer.rootObject, "number", 0)).SetReturn(JSONSuccess);
+    // objects are left as they are
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "object")).SetReturn(objectPtr);
+    STRICT_EXPECTED_CALL(json_value_get_type(objectPtr)).SetReturn(JSONObject);
+    STRICT_EXPECTED_CALL(json_object_dotget_value(writer.rootObject, "missing")).SetReturn(NULL);
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_ResetValue((JsonObjectWriterHandle)&writer, "string"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_ResetValue((JsonObjectWriterHandle)&writer, "number"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonObjectWriter_ResetValue((JsonObjectWriterHandle)&writer, "object"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonObjectWriter_ResetValue((JsonObjectWriterHandle)&writer, "missing"));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(json_object_writer_ut)
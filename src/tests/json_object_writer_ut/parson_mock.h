@@ -14,12 +14,22 @@ MOCKABLE_FUNCTION(, JSON_Status, json_object_set_number, JSON_Object*, object, c
 MOCKABLE_FUNCTION(, JSON_Status, json_object_set_value, JSON_Object*, object, const char*, name, JSON_Value*, value);
 MOCKABLE_FUNCTION(, JSON_Status, json_object_set_boolean, JSON_Object*, object, const char*, name, int, boolean);
 MOCKABLE_FUNCTION(, char *, json_serialize_to_string, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, size_t, json_serialization_size, const JSON_Value*, value);
 MOCKABLE_FUNCTION(, JSON_Value*, json_parse_string, const char*, string);
 MOCKABLE_FUNCTION(, int, json_value_equals, const JSON_Value*, a, const JSON_Value*, b);
 MOCKABLE_FUNCTION(, size_t, json_object_get_count, const JSON_Object*, object);
 MOCKABLE_FUNCTION(, int, json_object_dothas_value, const JSON_Object*, object, const char*, key);
 MOCKABLE_FUNCTION(, JSON_Value*, json_object_dotget_value, const JSON_Object*, object, const char*, key);
 MOCKABLE_FUNCTION(, JSON_Value_Type, json_value_get_type, const JSON_Value*, object);
+MOCKABLE_FUNCTION(, JSON_Value*, json_value_deep_copy, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, JSON_Array*, json_value_get_array, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, const char*, json_value_get_string, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, double, json_value_get_number, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, int, json_value_get_boolean, const JSON_Value*, value);
+MOCKABLE_FUNCTION(, const char*, json_object_get_name, const JSON_Object*, object, size_t, index);
+MOCKABLE_FUNCTION(, JSON_Value*, json_object_get_value_at, const JSON_Object*, object, size_t, index);
+MOCKABLE_FUNCTION(, size_t, json_array_get_count, const JSON_Array*, array);
+MOCKABLE_FUNCTION(, JSON_Value*, json_array_get_value, const JSON_Array*, array, size_t, index);
 
 
 
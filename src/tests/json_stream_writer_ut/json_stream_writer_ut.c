@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+
+#include "json/json_stream_writer.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static void AssertOutput(JsonStreamWriter* writer, const char* expected) {
+    const char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_GetOutput(writer, &output, &size));
+    ASSERT_ARE_EQUAL(char_ptr, expected, output);
+    ASSERT_ARE_EQUAL(int, strlen(expected), size);
+}
+
+BEGIN_TEST_SUITE(json_stream_writer_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(JsonStreamWriter_WriteNestedValues_ExpectSuccess)
+{
+    JsonStreamWriter writer;
+    // start small so the buffer has to grow
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 4));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteString(&writer, "str", "value"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteInt(&writer, "min", INT32_MIN));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteBool(&writer, "bool", false));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, "arr"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteBool(&writer, "t", true));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteInt(&writer, NULL, 3));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, "empty"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+
+    AssertOutput(&writer, "{\"str\":\"value\",\"min\":-2147483648,\"bool\":false,\"arr\":[{\"t\":true},3,[]],\"empty\":{}}");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_WriteString_EscapesValues_ExpectSuccess)
+{
+    JsonStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 64));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteString(&writer, "a\"b", "\\\b\f\n\r\t\x01/\xC3\xA9"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+
+    AssertOutput(&writer, "{\"a\\\"b\":\"\\\\\\b\\f\\n\\r\\t\\u0001/\xC3\xA9\"}");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_WriteString_InvalidUtf8_ExpectFailure)
+{
+    JsonStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 64));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+
+    // truncated sequence, invalid lead byte and overlong encoding
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteString(&writer, "k", "\xC3"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteString(&writer, "k", "\xFF"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteString(&writer, "k", "\xC0\xAF"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteString(&writer, "\xC3", "v"));
+
+    // failed writes leave nothing behind
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+    AssertOutput(&writer, "{}");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_KeyDoesNotMatchContainer_ExpectFailure)
+{
+    JsonStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 64));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_BeginObject(&writer, "root"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteInt(&writer, NULL, 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, "arr"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteInt(&writer, "key", 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_EndObject(&writer));
+
+    // only a single root value is allowed
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_BeginObject(&writer, NULL));
+
+    AssertOutput(&writer, "{\"arr\":[]}");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_MaxDepth_ExpectFailure)
+{
+    JsonStreamWriter writer;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 64));
+
+    for (int i = 0; i < JSON_STREAM_WRITER_MAX_DEPTH; i++) {
+        ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, NULL));
+    }
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_BeginArray(&writer, NULL));
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_GetOutput_IncompleteJson_ExpectFailure)
+{
+    JsonStreamWriter writer;
+    const char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 64));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_GetOutput(&writer, &output, &size));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_GetOutput(&writer, &output, &size));
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_WriteRaw_ExpectSuccess)
+{
+    JsonStreamWriter writer;
+    const char serializedEvent[] = "{\"a\":1}";
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 8));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, "events"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteRaw(&writer, NULL, serializedEvent, sizeof(serializedEvent) - 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteRaw(&writer, NULL, serializedEvent, sizeof(serializedEvent) - 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteRaw(&writer, NULL, serializedEvent, 0));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndArray(&writer));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteRaw(&writer, "raw", "[]", 2));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+
+    AssertOutput(&writer, "{\"events\":[{\"a\":1},{\"a\":1}],\"raw\":[]}");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_InitWithBuffer_Overflow_ExpectFailure)
+{
+    JsonStreamWriter writer;
+    char buffer[8];
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_InitWithBuffer(&writer, buffer, sizeof(buffer)));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginObject(&writer, NULL));
+    // {"ab":"c"} does not fit, {"a":1} fits exactly with the null terminator
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_EXCEPTION, JsonStreamWriter_WriteString(&writer, "ab", "c"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteInt(&writer, "a", 1));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndObject(&writer));
+    ASSERT_ARE_EQUAL(char_ptr, "{\"a\":1}", buffer);
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_Serialize_ExpectSuccess)
+{
+    JsonStreamWriter writer;
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Init(&writer, 2));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_BeginArray(&writer, NULL));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteString(&writer, NULL, "a"));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_EndArray(&writer));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Serialize(&writer, &output, &size));
+    ASSERT_ARE_EQUAL(char_ptr, "[\"a\"]", output);
+    ASSERT_ARE_EQUAL(int, 5, size);
+    free(output);
+
+    // the writer can be reused once the output was handed over
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteBool(&writer, NULL, true));
+    AssertOutput(&writer, "true");
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+TEST_FUNCTION(JsonStreamWriter_SerializeWithBuffer_ExpectSuccess)
+{
+    JsonStreamWriter writer;
+    char buffer[16];
+    char* output = NULL;
+    uint32_t size = 0;
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_InitWithBuffer(&writer, buffer, sizeof(buffer)));
+
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_WriteInt(&writer, NULL, 42));
+    ASSERT_ARE_EQUAL(int, JSON_WRITER_OK, JsonStreamWriter_Serialize(&writer, &output, &size));
+
+    ASSERT_ARE_NOT_EQUAL(void_ptr, buffer, output);
+    ASSERT_ARE_EQUAL(char_ptr, "42", output);
+    ASSERT_ARE_EQUAL(int, 2, size);
+    free(output);
+
+    JsonStreamWriter_Deinit(&writer);
+}
+
+END_TEST_SUITE(json_stream_writer_ut)
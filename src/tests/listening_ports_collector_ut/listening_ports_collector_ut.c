@@ -24,6 +24,7 @@
 
 #include "collectors/listening_ports_collector.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -172,7 +173,7 @@ TEST_FUNCTION(ListeningPortCollector_GetEvents_ExpectSuccess)
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_LISTENING_PORTS)).SetReturn(QUEUE_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(IGNORED_PTR_ARG));
 
     EventCollectorResult result = ListeningPortCollector_GetEvents(&mockedQueue);
@@ -226,7 +227,7 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_ExpectFailure)
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_LISTENING_PORTS)).SetFailReturn(!QUEUE_OK);
 
     umock_c_negative_tests_snapshot();
 
@@ -123,6 +123,19 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateSecurityModuleKeyAuthenticat
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
 
     STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Spill"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "MaxSize", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "QueueBudgets"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "HighPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "LowPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Scheduling"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "JitterPercentage", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Intervals")).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "AuditFeed")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
@@ -166,6 +179,19 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceKeyAuthentication_Expe
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
 
     STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Spill"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "MaxSize", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "QueueBudgets"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "HighPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "LowPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Scheduling"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "JitterPercentage", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Intervals")).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "AuditFeed")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
@@ -211,6 +237,19 @@ TEST_FUNCTION(LocalConfiguration_InitJsonAndValidateDeviceCertificateAuthenticat
     STRICT_EXPECTED_CALL(Utils_CreateStringCopy(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(true);
 
     STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Spill"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(IGNORED_PTR_ARG, "Directory", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "MaxSize", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "QueueBudgets"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "HighPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "LowPriority", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Scheduling"));
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "JitterPercentage", IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Intervals")).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepOut(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "AuditFeed")).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(JsonObjectReader_StepIn(IGNORED_PTR_ARG, "Logging"));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "SystemLoggerMinimumSeverity", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(IGNORED_PTR_ARG, "DiagnoticEventMinimumSeverity", IGNORED_PTR_ARG));
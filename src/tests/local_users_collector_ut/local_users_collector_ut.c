@@ -20,6 +20,7 @@
 
 #include "collectors/local_users_collector.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -171,7 +172,7 @@ TEST_FUNCTION(LocalUsersCollector_GetEvents_ExpectSuccess)
     STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
 
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_LOCAL_USERS)).SetReturn(QUEUE_OK);
 
     STRICT_EXPECTED_CALL(UsersIterator_Deinit(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(IGNORED_PTR_ARG));
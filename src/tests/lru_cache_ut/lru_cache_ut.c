@@ -0,0 +1,296 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_bool.h"
+
+#include "lru_cache.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char CACHE_FILE_PATH[] = "/tmp/lru_cache_ut.cache";
+static const char CACHE_LINK_TARGET_PATH[] = "/tmp/lru_cache_ut.target";
+
+static void AssertValue(LruCache* cache, const char* key, const char* expectedValue) {
+    const char* value = NULL;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Get(cache, key, &value));
+    ASSERT_ARE_EQUAL(char_ptr, expectedValue, value);
+}
+
+static void AssertNotFound(LruCache* cache, const char* key) {
+    const char* value = NULL;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_NOT_FOUND, LruCache_Get(cache, key, &value));
+}
+
+BEGIN_TEST_SUITE(lru_cache_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    unlink(CACHE_FILE_PATH);
+    unlink(CACHE_LINK_TARGET_PATH);
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    unlink(CACHE_FILE_PATH);
+    unlink(CACHE_LINK_TARGET_PATH);
+}
+
+TEST_FUNCTION(LruCache_Put_ExpectValueUpdated)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 4, NULL));
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "/bin/ls", "aaaa"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "/bin/ls", "bbbb"));
+
+    AssertValue(&cache, "/bin/ls", "bbbb");
+    AssertNotFound(&cache, "/bin/cat");
+    ASSERT_ARE_EQUAL(int, 1, LruCache_GetCount(&cache));
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Put_CacheFull_ExpectLeastRecentlyUsedEvicted)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, NULL));
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "b", "2"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "c", "3"));
+    // a is used again, so b is the least recently used one
+    AssertValue(&cache, "a", "1");
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "d", "4"));
+
+    ASSERT_ARE_EQUAL(int, 3, LruCache_GetCount(&cache));
+    AssertNotFound(&cache, "b");
+    AssertValue(&cache, "a", "1");
+    AssertValue(&cache, "c", "3");
+    AssertValue(&cache, "d", "4");
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Put_ManyEntries_ExpectOnlyNewestKept)
+{
+    LruCache cache;
+    char key[16];
+    char value[16];
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 16, NULL));
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        snprintf(value, sizeof(value), "value%d", i);
+        ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, key, value));
+    }
+
+    ASSERT_ARE_EQUAL(int, 16, LruCache_GetCount(&cache));
+    AssertNotFound(&cache, "key983");
+    for (int i = 984; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        snprintf(value, sizeof(value), "value%d", i);
+        AssertValue(&cache, key, value);
+    }
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Put_ValueTooLong_ExpectFailure)
+{
+    LruCache cache;
+    char value[LRU_CACHE_MAX_VALUE_SIZE + 1];
+    memset(value, 'a', sizeof(value) - 1);
+    value[sizeof(value) - 1] = '\0';
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 4, NULL));
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_EXCEPTION, LruCache_Put(&cache, "a", value));
+    ASSERT_ARE_EQUAL(int, 0, LruCache_GetCount(&cache));
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Save_ExpectEntriesLoadedInRecencyOrder)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 0, LruCache_GetCount(&cache));
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "b", "2"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "c", "3"));
+    AssertValue(&cache, "a", "1");
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 3, LruCache_GetCount(&cache));
+    ASSERT_IS_FALSE(cache.isDirty);
+
+    // b is still the least recently used entry after the reload
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "d", "4"));
+    AssertNotFound(&cache, "b");
+    AssertValue(&cache, "a", "1");
+    AssertValue(&cache, "c", "3");
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Save_LongestEntries_ExpectEntriesLoaded)
+{
+    char key[LRU_CACHE_MAX_KEY_SIZE];
+    memset(key, 'k', sizeof(key) - 1);
+    key[sizeof(key) - 1] = '\0';
+    char value[LRU_CACHE_MAX_VALUE_SIZE];
+    memset(value, 'f', sizeof(value) - 1);
+    memcpy(value, "sha512:", strlen("sha512:"));
+    value[sizeof(value) - 1] = '\0';
+
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, key, value));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", ""));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 2, LruCache_GetCount(&cache));
+    AssertValue(&cache, key, value);
+    AssertValue(&cache, "a", "");
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Init_FileLargerThanCapacity_ExpectNewestEntriesLoaded)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "b", "2"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "c", "3"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 2, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 2, LruCache_GetCount(&cache));
+    AssertNotFound(&cache, "a");
+    AssertValue(&cache, "b", "2");
+    AssertValue(&cache, "c", "3");
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Init_InvalidFile_ExpectEmptyCache)
+{
+    FILE* file = fopen(CACHE_FILE_PATH, "w");
+    ASSERT_IS_NOT_NULL(file);
+    fputs("not a cache", file);
+    fclose(file);
+    ASSERT_ARE_EQUAL(int, 0, chmod(CACHE_FILE_PATH, S_IRUSR | S_IWUSR));
+
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 0, LruCache_GetCount(&cache));
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_Save_ExpectPrivateFile)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(CACHE_FILE_PATH, &fileStat));
+    ASSERT_ARE_EQUAL(int, geteuid(), fileStat.st_uid);
+    ASSERT_ARE_EQUAL(int, S_IRUSR | S_IWUSR, fileStat.st_mode & 0777);
+}
+
+TEST_FUNCTION(LruCache_FileAccessibleToOthers_ExpectNotLoadedNorSaved)
+{
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+    ASSERT_ARE_EQUAL(int, 0, chmod(CACHE_FILE_PATH, 0666));
+
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, 0, LruCache_GetCount(&cache));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "b", "2"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_EXCEPTION, LruCache_Save(&cache));
+    ASSERT_IS_TRUE(cache.isDirty);
+
+    LruCache_Deinit(&cache);
+}
+
+TEST_FUNCTION(LruCache_FileIsSymbolicLink_ExpectLinkNotFollowed)
+{
+    FILE* file = fopen(CACHE_LINK_TARGET_PATH, "w");
+    ASSERT_IS_NOT_NULL(file);
+    fputs("target", file);
+    fclose(file);
+    ASSERT_ARE_EQUAL(int, 0, symlink(CACHE_LINK_TARGET_PATH, CACHE_FILE_PATH));
+
+    LruCache cache;
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Init(&cache, 3, CACHE_FILE_PATH));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_EXCEPTION, LruCache_Save(&cache));
+    LruCache_Deinit(&cache);
+
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(CACHE_LINK_TARGET_PATH, &fileStat));
+    ASSERT_ARE_EQUAL(int, strlen("target"), fileStat.st_size);
+}
+
+TEST_FUNCTION(LruCache_NotInitiated_ExpectEmptyCache)
+{
+    LruCache cache;
+    memset(&cache, 0, sizeof(cache));
+
+    AssertNotFound(&cache, "a");
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_EXCEPTION, LruCache_Put(&cache, "a", "1"));
+    ASSERT_ARE_EQUAL(int, LRU_CACHE_OK, LruCache_Save(&cache));
+
+    LruCache_Deinit(&cache);
+}
+
+END_TEST_SUITE(lru_cache_ut)
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+
+#include "message_compressor.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+#define TEST_CAPACITY 256
+#define GZIP_WINDOW_BITS (15 + 16)
+
+static const char FIRST_CHUNK[] = "{\"Events\":[{\"a\":\"1\"},{\"a\":\"1\"},";
+static const char SECOND_CHUNK[] = "{\"a\":\"1\"},{\"a\":\"1\"}";
+static const char LAST_CHUNK[] = "]}";
+
+static MessageCompressor compressor;
+static char* output = NULL;
+static uint32_t outputSize = 0;
+
+static uint32_t Inflate(const char* compressed, uint32_t compressedSize, char* decompressed, uint32_t decompressedSize) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    ASSERT_ARE_EQUAL(int, Z_OK, inflateInit2(&stream, GZIP_WINDOW_BITS));
+
+    stream.next_in = (Bytef*)compressed;
+    stream.avail_in = compressedSize;
+    stream.next_out = (Bytef*)decompressed;
+    stream.avail_out = decompressedSize;
+    ASSERT_ARE_EQUAL(int, Z_STREAM_END, inflate(&stream, Z_FINISH));
+
+    uint32_t size = stream.total_out;
+    inflateEnd(&stream);
+    return size;
+}
+
+static void FillIncompressible(char* data, uint32_t size) {
+    uint32_t state = 12345;
+    for (uint32_t i = 0; i < size; i++) {
+        state = state * 1103515245 + 12345;
+        data[i] = (char)(state >> 16);
+    }
+}
+
+BEGIN_TEST_SUITE(message_compressor_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, MessageCompressor_Init(&compressor, TEST_CAPACITY));
+    output = NULL;
+    outputSize = 0;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    MessageCompressor_Deinit(&compressor);
+    if (output != NULL) {
+        free(output);
+    }
+}
+
+TEST_FUNCTION(MessageCompressor_Finish_SeveralAppends_ExpectGzipOfAllData)
+{
+    char expected[TEST_CAPACITY] = "";
+    char decompressed[TEST_CAPACITY] = "";
+    snprintf(expected, sizeof(expected), "%s%s%s", FIRST_CHUNK, SECOND_CHUNK, LAST_CHUNK);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, MessageCompressor_Append(&compressor, FIRST_CHUNK, strlen(FIRST_CHUNK)));
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, MessageCompressor_Append(&compressor, SECOND_CHUNK, strlen(SECOND_CHUNK)));
+    MessageCompressorResult result = MessageCompressor_Finish(&compressor, LAST_CHUNK, strlen(LAST_CHUNK), &output, &outputSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, result);
+    ASSERT_IS_NOT_NULL(output);
+    uint32_t decompressedSize = Inflate(output, outputSize, decompressed, sizeof(decompressed) - 1);
+    ASSERT_ARE_EQUAL(int, strlen(expected), decompressedSize);
+    ASSERT_ARE_EQUAL(char_ptr, expected, decompressed);
+}
+
+TEST_FUNCTION(MessageCompressor_GetMaxAppendSize_IncompressibleData_ExpectCapacityNotExceeded)
+{
+    char data[TEST_CAPACITY];
+    char decompressed[TEST_CAPACITY];
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, MessageCompressor_Append(&compressor, FIRST_CHUNK, strlen(FIRST_CHUNK)));
+    uint32_t maxAppendSize = MessageCompressor_GetMaxAppendSize(&compressor);
+    ASSERT_IS_TRUE(maxAppendSize > 0);
+    ASSERT_IS_TRUE(maxAppendSize < TEST_CAPACITY);
+
+    FillIncompressible(data, maxAppendSize);
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, MessageCompressor_Append(&compressor, data, maxAppendSize));
+    MessageCompressorResult result = MessageCompressor_Finish(&compressor, NULL, 0, &output, &outputSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OK, result);
+    ASSERT_IS_TRUE(outputSize <= TEST_CAPACITY);
+    uint32_t decompressedSize = Inflate(output, outputSize, decompressed, sizeof(decompressed));
+    ASSERT_ARE_EQUAL(int, strlen(FIRST_CHUNK) + maxAppendSize, decompressedSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(data, decompressed + strlen(FIRST_CHUNK), maxAppendSize));
+}
+
+TEST_FUNCTION(MessageCompressor_Append_ExceedsCapacity_ExpectOutOfSpace)
+{
+    char data[2 * TEST_CAPACITY];
+    FillIncompressible(data, sizeof(data));
+
+    MessageCompressorResult result = MessageCompressor_Append(&compressor, data, sizeof(data));
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OUT_OF_SPACE, result);
+    ASSERT_ARE_EQUAL(int, 0, MessageCompressor_GetMaxAppendSize(&compressor));
+}
+
+TEST_FUNCTION(MessageCompressor_Finish_ExceedsCapacity_ExpectOutOfSpace)
+{
+    char data[2 * TEST_CAPACITY];
+    FillIncompressible(data, sizeof(data));
+
+    MessageCompressorResult result = MessageCompressor_Finish(&compressor, data, sizeof(data), &output, &outputSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_COMPRESSOR_OUT_OF_SPACE, result);
+    ASSERT_IS_NULL(output);
+}
+
+END_TEST_SUITE(message_compressor_ut)
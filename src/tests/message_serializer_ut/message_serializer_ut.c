@@ -7,15 +7,15 @@
 #include "umock_c.h"
 #include "umocktypes_charptr.h"
 
-
 #define ENABLE_MOCKS
-#include "json/json_array_writer.h"
-#include "json/json_object_writer.h"
+#include "event_splitter.h"
 #include "local_config.h"
+#include "message_compressor.h"
 #include "synchronized_queue.h"
 #include "twin_configuration.h"
 #undef ENABLE_MOCKS
 
+#include "consts.h"
 #include "json/json_defs.h"
 #include "local_config.h"
 #include "message_schema_consts.h"
@@ -32,6 +32,7 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
 }
 
 static const char DUMMY_JSON[] =  "{ \"test\" : \"yes\", \"a\" : \"b\"}";
+static const char OVERSIZED_JSON[] = "{ \"Payload\" : [] }";
 static SyncQueue mainQueue;
 static SyncQueue paddingQueue;
 
@@ -39,10 +40,10 @@ static uint32_t mainQueueMockedSyncQueueGetSizeMainSize = 0;
 static uint32_t paddingQueueMockedSyncQueueGetSizeSize = 0;
 static int mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
 static int mockedSyncQueuePopFrontReturnValue = QUEUE_OK;
+static bool isMainQueueHeadOversized = false;
+static uint32_t mockedSplitEventsCount = 0;
 static uint32_t mockedGetMaxSizeValue = 0;
 static TwinConfigurationResult mockedGetMaxSizeReturnValue = TWIN_OK;
-static JsonObjectWriterHandle mockedObjectWriterHandle = (JsonObjectWriterHandle)0x1;
-static JsonArrayWriterHandle mockedArrayWriterHandle = (JsonArrayWriterHandle)0x2;
 static char TEST_AGENT_ID[] = "ea05af2d-7397-4a1b-9ec7-3dc15e762a69";
 
 int Mocked_SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) { 
@@ -55,23 +56,72 @@ int Mocked_SyncQueue_GetSize(SyncQueue* syncQueue, uint32_t* size) {
     return mockedSyncQueueGetSizeReturnValue;
 }
 
-int Mocked_SyncQueue_PopFrontIf(SyncQueue* syncQueue, QueuePopCondition condition, void* conditionParams, void** data, uint32_t* dataSize) {
+int Mocked_SyncQueue_PopFrontBatch(SyncQueue* syncQueue, uint32_t byteBudget, uint32_t itemOverhead, uint32_t maxItems, QueueBatchItem* items, uint32_t* itemsCount) {
+    *itemsCount = 0;
     if (mockedSyncQueuePopFrontReturnValue != QUEUE_OK) {
         return mockedSyncQueuePopFrontReturnValue;
     }
 
-    if (!condition(NULL, strlen(DUMMY_JSON), conditionParams)) {
+    if (syncQueue == &mainQueue && isMainQueueHeadOversized) {
         return QUEUE_CONDITION_FAILED;
     }
 
-    *data = strdup(DUMMY_JSON);
-    *dataSize = strlen(DUMMY_JSON);
-    if (syncQueue == &mainQueue) {
-        mainQueueMockedSyncQueueGetSizeMainSize--;
-    } else {
-        paddingQueueMockedSyncQueueGetSizeSize--;
+    uint32_t* queueSize = (syncQueue == &mainQueue) ? &mainQueueMockedSyncQueueGetSizeMainSize : &paddingQueueMockedSyncQueueGetSizeSize;
+    if (*queueSize == 0) {
+        return QUEUE_IS_EMPTY;
+    }
+
+    uint32_t takenBytes = 0;
+    while (*queueSize > 0 && *itemsCount < maxItems && takenBytes + strlen(DUMMY_JSON) + itemOverhead < byteBudget) {
+        items[*itemsCount].data = strdup(DUMMY_JSON);
+        items[*itemsCount].dataSize = strlen(DUMMY_JSON);
+        takenBytes += strlen(DUMMY_JSON) + itemOverhead;
+        ++(*itemsCount);
+        --(*queueSize);
+    }
+
+    return (*itemsCount == 0) ? QUEUE_CONDITION_FAILED : QUEUE_OK;
+}
+
+int Mocked_SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataSize) {
+    isMainQueueHeadOversized = false;
+    *data = strdup(OVERSIZED_JSON);
+    // the reported size is what makes the event oversized, not its content
+    *dataSize = mockedGetMaxSizeValue;
+    return QUEUE_OK;
+}
+
+int Mocked_SyncQueue_PushFront(SyncQueue* syncQueue, QueueBatchItem* items, uint32_t itemsCount) {
+    for (uint32_t i = 0; i < itemsCount; i++) {
+        ASSERT_ARE_EQUAL(int, strlen(DUMMY_JSON), items[i].dataSize);
+        ASSERT_ARE_EQUAL(char_ptr, DUMMY_JSON, items[i].data);
+        free(items[i].data);
+        mainQueueMockedSyncQueueGetSizeMainSize++;
+    }
+    return QUEUE_OK;
+}
+
+EventSplitterResult Mocked_EventSplitter_Split(const char* event, uint32_t eventSize, uint32_t maxEventSize, EventSplitterCallback callback, void* context) {
+    for (uint32_t i = 0; i < mockedSplitEventsCount; i++) {
+        if (!callback(context, strdup(DUMMY_JSON), strlen(DUMMY_JSON))) {
+            return EVENT_SPLITTER_EXCEPTION;
+        }
     }
-    return mockedSyncQueuePopFrontReturnValue;
+
+    return mockedSplitEventsCount > 0 ? EVENT_SPLITTER_OK : EVENT_SPLITTER_NOT_SPLITTABLE;
+}
+
+static const char COMPRESSED_MESSAGE[] = "compressed";
+static uint32_t mockedMaxAppendSize = 0;
+
+uint32_t Mocked_MessageCompressor_GetMaxAppendSize(MessageCompressor* compressor) {
+    return mockedMaxAppendSize;
+}
+
+MessageCompressorResult Mocked_MessageCompressor_Finish(MessageCompressor* compressor, const char* data, uint32_t size, char** output, uint32_t* outputSize) {
+    *output = strdup(COMPRESSED_MESSAGE);
+    *outputSize = strlen(COMPRESSED_MESSAGE);
+    return MESSAGE_COMPRESSOR_OK;
 }
 
 TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* maxMessageSize) {
@@ -82,19 +132,65 @@ TwinConfigurationResult Mocked_TwinConfiguration_GetMaxMessageSize(uint32_t* max
     return mockedGetMaxSizeReturnValue;
 }
 
-JsonWriterResult Mocked_JsonObjectWriter_Init_SetWriterToNotNull(JsonObjectWriterHandle* writer) {
-    *writer = mockedObjectWriterHandle;
-    return JSON_WRITER_OK;
+static uint32_t BuildExpectedMessage(char* expected, uint32_t expectedSize, uint32_t eventsCount) {
+    int length = snprintf(expected, expectedSize, "{\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":\"%s\",\"%s\":[",
+        AGENT_VERSION_KEY, AGENT_VERSION, AGENT_ID_KEY, TEST_AGENT_ID, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION, EVENTS_KEY);
+    for (uint32_t i = 0; i < eventsCount; i++) {
+        length += snprintf(expected + length, expectedSize - length, "%s%s", i == 0 ? "" : ",", DUMMY_JSON);
+    }
+    length += snprintf(expected + length, expectedSize - length, "]}");
+
+    return length;
 }
 
-JsonWriterResult Mocked_JsonObjectWriter_InitFromString_SetWriterToNotNull(JsonObjectWriterHandle* writer, const char* json) {
-    *writer = mockedObjectWriterHandle;
-    return JSON_WRITER_OK;
+static uint32_t GetMessageSize(uint32_t eventsCount) {
+    char expected[1024] = "";
+    return BuildExpectedMessage(expected, sizeof(expected), eventsCount);
 }
 
-JsonWriterResult Mocked_JsonArrayWriter_Init_SetWriterToNotNull(JsonArrayWriterHandle* writer) {
-    *writer = mockedArrayWriterHandle;
-    return JSON_WRITER_OK;
+static void AssertMessage(const char* message, uint32_t eventsCount) {
+    char expected[1024] = "";
+    BuildExpectedMessage(expected, sizeof(expected), eventsCount);
+
+    ASSERT_ARE_EQUAL(char_ptr, expected, message);
+}
+
+static uint32_t AppendCborText(char* expected, uint32_t length, const char* text) {
+    uint32_t textLength = strlen(text);
+    if (textLength < 24) {
+        expected[length++] = (char)(0x60 + textLength);
+    } else {
+        expected[length++] = (char)0x78;
+        expected[length++] = (char)textLength;
+    }
+    memcpy(expected + length, text, textLength);
+    return length + textLength;
+}
+
+static uint32_t BuildExpectedCborMessage(char* expected, uint32_t eventsCount) {
+    uint32_t length = 0;
+    expected[length++] = (char)0xBF;
+    length = AppendCborText(expected, length, AGENT_VERSION_KEY);
+    length = AppendCborText(expected, length, AGENT_VERSION);
+    length = AppendCborText(expected, length, AGENT_ID_KEY);
+    length = AppendCborText(expected, length, TEST_AGENT_ID);
+    length = AppendCborText(expected, length, MESSAGE_SCHEMA_VERSION_KEY);
+    length = AppendCborText(expected, length, DEFAULT_MESSAGE_SCHEMA_VERSION);
+    length = AppendCborText(expected, length, EVENTS_KEY);
+    expected[length++] = (char)0x9F;
+    for (uint32_t i = 0; i < eventsCount; i++) {
+        // DUMMY_JSON as a CBOR map
+        expected[length++] = (char)0xBF;
+        length = AppendCborText(expected, length, "test");
+        length = AppendCborText(expected, length, "yes");
+        length = AppendCborText(expected, length, "a");
+        length = AppendCborText(expected, length, "b");
+        expected[length++] = (char)0xFF;
+    }
+    expected[length++] = (char)0xFF;
+    expected[length++] = (char)0xFF;
+
+    return length;
 }
 
 BEGIN_TEST_SUITE(message_serializer_ut)
@@ -111,19 +207,22 @@ TEST_SUITE_INITIALIZE(suite_init)
     umocktypes_charptr_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(MessageSerializerEncoding, int);
     REGISTER_UMOCK_ALIAS_TYPE(QueuePopCondition, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(EventSplitterResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(EventSplitterCallback, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(MessageCompressorResult, int);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, Mocked_SyncQueue_GetSize);
-    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFrontIf, Mocked_SyncQueue_PopFrontIf);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFrontBatch, Mocked_SyncQueue_PopFrontBatch);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, Mocked_SyncQueue_PopFront);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushFront, Mocked_SyncQueue_PushFront);
+    REGISTER_GLOBAL_MOCK_HOOK(EventSplitter_Split, Mocked_EventSplitter_Split);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageCompressor_GetMaxAppendSize, Mocked_MessageCompressor_GetMaxAppendSize);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageCompressor_Finish, Mocked_MessageCompressor_Finish);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, Mocked_TwinConfiguration_GetMaxMessageSize);
     REGISTER_GLOBAL_MOCK_RETURN(LocalConfiguration_GetAgentId, TEST_AGENT_ID);
-
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Init, Mocked_JsonObjectWriter_Init_SetWriterToNotNull);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_InitFromString, Mocked_JsonObjectWriter_InitFromString_SetWriterToNotNull);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonArrayWriter_Init, Mocked_JsonArrayWriter_Init_SetWriterToNotNull);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -133,169 +232,390 @@ TEST_SUITE_CLEANUP(suite_cleanup)
      
 
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_GetSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFrontBatch, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PopFront, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(SyncQueue_PushFront, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(EventSplitter_Split, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageCompressor_GetMaxAppendSize, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(MessageCompressor_Finish, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfiguration_GetMaxMessageSize, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_Init, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonObjectWriter_InitFromString, NULL);
-    REGISTER_GLOBAL_MOCK_HOOK(JsonArrayWriter_Init, NULL);
 }
 
 TEST_FUNCTION_INITIALIZE(method_init)
 {
     umock_c_reset_all_calls();
+    mockedSyncQueuePopFrontReturnValue = QUEUE_OK;
+    mockedGetMaxSizeReturnValue = TWIN_OK;
+    isMainQueueHeadOversized = false;
+    mockedSplitEventsCount = 0;
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueIsEmpty_ExpectSuccess)
 {
     char* buffer = NULL;
+    uint32_t bufferSize = 0;
     mainQueueMockedSyncQueueGetSizeMainSize = 1;
     paddingQueueMockedSyncQueueGetSizeSize = 0;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
-
-    mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) + 1;
-
-    // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+    mockedGetMaxSizeValue = GetMessageSize(2);
 
     // initial settings
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    // write the beginning of the message
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
 
     // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
-    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
 
     ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    AssertMessage(buffer, 1);
+
+    free(buffer);
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueHasDataMaxMessageSizeReached_ExpectSuccess)
 {
     char* buffer = NULL;
+    uint32_t bufferSize = 0;
     mainQueueMockedSyncQueueGetSizeMainSize = 1;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
-
     paddingQueueMockedSyncQueueGetSizeSize = 1;
+    mockedGetMaxSizeValue = GetMessageSize(2) - 1;
 
-    mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) + 1;
+    // initial settings
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-     // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    // write the beginning of the message
     STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+
+    // write all elements fron main queue
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // the event of the padding queue does not fit in the message, only a single byte is missing for it
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, strlen(DUMMY_JSON) + 1, 1, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(4);
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, paddingQueueMockedSyncQueueGetSizeSize);
+    AssertMessage(buffer, 1);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_EventsFillMaxMessageSize_ExpectMessageOfMaxSize)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 1;
+    paddingQueueMockedSyncQueueGetSizeSize = 2;
+    mockedGetMaxSizeValue = GetMessageSize(2);
 
     // initial settings
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    // write the beginning of the message
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
 
     // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-
-    // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    // a single event of the padding queue fills the message, the queue is not visited again
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
-    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
 
     ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, paddingQueueMockedSyncQueueGetSizeSize);
+    ASSERT_ARE_EQUAL(int, mockedGetMaxSizeValue, strlen(buffer));
+    AssertMessage(buffer, 2);
+
+    free(buffer);
 }
 
 TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasDataPaddingQueueHasData_ExpectSuccess)
 {
     char* buffer = NULL;
+    uint32_t bufferSize = 0;
     mainQueueMockedSyncQueueGetSizeMainSize = 1;
-    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
-
     paddingQueueMockedSyncQueueGetSizeSize = 1;
+    mockedGetMaxSizeValue = GetMessageSize(3);
 
-    mockedGetMaxSizeReturnValue = TWIN_OK;
-    mockedGetMaxSizeValue = strlen(DUMMY_JSON) * 3;
+    // initial settings
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
     // write the beginning of the message
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_VERSION_KEY, AGENT_VERSION)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, AGENT_ID_KEY, TEST_AGENT_ID)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(mockedObjectWriterHandle, MESSAGE_SCHEMA_VERSION_KEY, DEFAULT_MESSAGE_SCHEMA_VERSION)).SetReturn(JSON_WRITER_OK);
+
+    // write all elements fron main queue
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // write all elements fron padding queue
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    AssertMessage(buffer, 2);
+
+    // freeing local buffer
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHasSeveralEvents_ExpectSingleBatchPop)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 3;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    mockedGetMaxSizeValue = GetMessageSize(4);
 
     // initial settings
-    //STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
 
-    // write to the array
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG));
+    // write the beginning of the message
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
 
-    // write all elements fron main queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&mainQueue, IGNORED_PTR_ARG));
+    // all the events of the main queue are taken out in a single batch
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, GetMessageSize(4) - GetMessageSize(0) + 2, 1, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(4);
 
-    // write all elements fron padding queue
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(SyncQueue_PopFrontIf(&paddingQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, DUMMY_JSON));
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(mockedArrayWriterHandle, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
-    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&paddingQueue, IGNORED_PTR_ARG));
-
-    // writes the array and serialize
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteArray(mockedObjectWriterHandle, EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Deinit(mockedArrayWriterHandle));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(mockedObjectWriterHandle, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Deinit(mockedObjectWriterHandle));
+    // the message is not full, try the padding queue
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, strlen(DUMMY_JSON) + 2, 1, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(4);
 
     SyncQueue* queues[] = {&mainQueue, &paddingQueue};
-    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, (void**)&buffer);
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
 
     ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSyncQueueGetSizeMainSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    AssertMessage(buffer, 3);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHeadIsOversized_ExpectEventSplit)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 0;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    isMainQueueHeadOversized = true;
+    mockedSplitEventsCount = 2;
+    mockedGetMaxSizeValue = GetMessageSize(4);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+
+    // the head of the main queue does not fit even into an empty message
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(EventSplitter_Split(IGNORED_PTR_ARG, GetMessageSize(4), GetMessageSize(4) - GetMessageSize(0), IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    // the split events are returned together to the head of the main queue
+    STRICT_EXPECTED_CALL(SyncQueue_PushFront(&mainQueue, IGNORED_PTR_ARG, 2));
+
+    // the split events are taken from the main queue into the same message
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSyncQueueGetSizeMainSize);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    AssertMessage(buffer, 2);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_MainQueueHeadIsOversizedAndNotSplittable_ExpectEventDropped)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 0;
+    paddingQueueMockedSyncQueueGetSizeSize = 1;
+    isMainQueueHeadOversized = true;
+    mockedSplitEventsCount = 0;
+    mockedGetMaxSizeValue = GetMessageSize(4);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&mainQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(EventSplitter_Split(IGNORED_PTR_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // the event is dropped and no longer blocks the queue
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    AssertMessage(buffer, 1);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_Compressed_ExpectEventsPackedByCompressedSize)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 3;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    // the uncompressed events exceed the max message size, they fit once compressed
+    mockedGetMaxSizeValue = GetMessageSize(1);
+    mockedMaxAppendSize = GetMessageSize(4);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageCompressor_Init(IGNORED_PTR_ARG, GetMessageSize(1)));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(MessageCompressor_Append(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+
+    // a compressed message keeps taking events as long as their compressed size leaves room for more
+    STRICT_EXPECTED_CALL(MessageCompressor_GetMaxAppendSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageCompressor_Append(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 3 * (strlen(DUMMY_JSON) + 1) - 1));
+    STRICT_EXPECTED_CALL(MessageCompressor_GetMaxAppendSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(MessageCompressor_GetMaxAppendSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    // the closing of the message is compressed last
+    STRICT_EXPECTED_CALL(MessageCompressor_Finish(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(MessageCompressor_Deinit(IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, true, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSyncQueueGetSizeMainSize);
+    ASSERT_ARE_EQUAL(char_ptr, COMPRESSED_MESSAGE, buffer);
+    ASSERT_ARE_EQUAL(int, strlen(COMPRESSED_MESSAGE), bufferSize);
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_CborEncoding_ExpectEventsTranscodedToCbor)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 3;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    mockedGetMaxSizeValue = GetMessageSize(3);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+
+    // the events are taken out as json and transcoded into the message, which has no separators
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    // the encoded events leave room in the message, so the queue is checked again until it is drained
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_CBOR, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSyncQueueGetSizeMainSize);
+
+    char expected[1024];
+    uint32_t expectedSize = BuildExpectedCborMessage(expected, 3);
+    ASSERT_ARE_EQUAL(int, expectedSize, bufferSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, buffer, expectedSize));
+    ASSERT_IS_TRUE(bufferSize < GetMessageSize(3));
 
-    // freeing local buffer
     free(buffer);
 }
 
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_CborEventsExceedJsonSize_ExpectMessageFilledByEncodedSize)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 5;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    // as json only 3 events fit the message, all 5 fit once encoded as CBOR
+    mockedGetMaxSizeValue = GetMessageSize(3);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+
+    // every batch is limited by the json size of the events, the message takes more as long as the encoded size leaves room
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, 0, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).IgnoreArgument(2).IgnoreArgument(4);
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_CBOR, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, mainQueueMockedSyncQueueGetSizeMainSize);
+
+    char expected[1024];
+    uint32_t expectedSize = BuildExpectedCborMessage(expected, 5);
+    ASSERT_ARE_EQUAL(int, expectedSize, bufferSize);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, buffer, expectedSize));
+    ASSERT_IS_TRUE(bufferSize <= GetMessageSize(3));
+
+    free(buffer);
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_QueuesAreEmpty_ExpectEmpty)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 0;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    mockedGetMaxSizeValue = GetMessageSize(4);
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(LocalConfiguration_GetAgentId());
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&mainQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFrontBatch(&paddingQueue, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_EMPTY, result);
+    ASSERT_IS_NULL(buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(MessageSerializer_CreateSecurityMessage_GetMaxMessageSizeFailed_ExpectFailure)
+{
+    char* buffer = NULL;
+    uint32_t bufferSize = 0;
+    mainQueueMockedSyncQueueGetSizeMainSize = 1;
+    paddingQueueMockedSyncQueueGetSizeSize = 0;
+    mockedGetMaxSizeReturnValue = TWIN_EXCEPTION;
+
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetMaxMessageSize(IGNORED_PTR_ARG));
+
+    SyncQueue* queues[] = {&mainQueue, &paddingQueue};
+    MessageSerializerResultValues result = MessageSerializer_CreateSecurityMessage(queues, 2, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&buffer, &bufferSize);
+
+    ASSERT_ARE_EQUAL(int, MESSAGE_SERIALIZER_EXCEPTION, result);
+    ASSERT_IS_NULL(buffer);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(message_serializer_ut)
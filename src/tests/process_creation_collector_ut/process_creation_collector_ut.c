@@ -12,14 +12,17 @@
 #define ENABLE_MOCKS
 #include "collectors/generic_event.h"
 #include "os_utils/linux/audit/audit_control.h"
+#include "os_utils/linux/audit/audit_dispatcher.h"
 #include "os_utils/linux/audit/audit_search.h"
 #include "os_utils/linux/audit/audit_search_record.h"
 #include "collectors/linux/generic_audit_event.h"
 #include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "synchronized_queue.h"
 #include "collectors/event_aggregator.h"
-#include "azure_c_shared_utility/map.h"
+#include "lru_cache.h"
+#include "os_utils/process_info_handler.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/process_creation_collector.h"
@@ -64,13 +67,6 @@ EventAggregatorResult Mocked_EventAggregator_IsAggregationEnabled(EventAggregato
 
     return EVENT_AGGREGATOR_OK;
 }
-MAP_HANDLE Mocked_Map_Create(MAP_FILTER_CALLBACK mapFilterFunc) {
-    return (MAP_HANDLE)0x5;
-}
-MAP_RESULT Mocked_Map_GetInternals(MAP_HANDLE handle, const char*const** keys, const char*const** values, size_t* count){
-    *count = 1;
-    return MAP_OK;
-}
 
 void VailidateCommandLine() {
     STRICT_EXPECTED_CALL(AuditSearchRecord_Goto(IGNORED_PTR_ARG, 1309)).SetReturn(AUDIT_SEARCH_OK);
@@ -78,7 +74,7 @@ void VailidateCommandLine() {
     STRICT_EXPECTED_CALL(AuditSearchRecord_ReadInt(IGNORED_PTR_ARG, "argc", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearchRecord_InterpretString(IGNORED_PTR_ARG, "a0", IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearchRecord_InterpretString(IGNORED_PTR_ARG, "a1", IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_COMMAND_LINE_KEY, "ab ab")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_COMMAND_LINE_KEY, "ab ab")).SetReturn(JSON_WRITER_OK);
 }
 
 BEGIN_TEST_SUITE(process_creation_collector_ut)
@@ -107,15 +103,14 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(EventAggregatorHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(EventAggregatorResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(AuditControlResultValues, int);
-    REGISTER_UMOCK_ALIAS_TYPE(MAP_HANDLE, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(MAP_FILTER_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LruCacheResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherEventHandler, void*);
 
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearchRecord_MaxRecordLength, Mocked_AuditSearchRecord_MaxRecordLength);
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearchRecord_ReadInt, Mocked_AuditSearchRecord_ReadInt);
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearchRecord_InterpretString, Mocked_AuditSearchRecord_InterpretString);
     REGISTER_GLOBAL_MOCK_HOOK(EventAggregator_IsAggregationEnabled, Mocked_EventAggregator_IsAggregationEnabled);
-    REGISTER_GLOBAL_MOCK_HOOK(Map_Create, Mocked_Map_Create);
-    REGISTER_GLOBAL_MOCK_HOOK(Map_GetInternals, Mocked_Map_GetInternals);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -144,34 +139,40 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_ExpectSucce
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
     VailidateCommandLine();
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(NULL);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, "")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_PROCESS_CREATE)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
 
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
 
     EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -186,29 +187,37 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationEnabled_ExpectSucces
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, "/var/tmp/processCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
     VailidateCommandLine();
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(NULL);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, "")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(JsonStreamWriter_GetOutput(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, PROCESS_CREATION_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, PROCESS_CREATION_PARENT_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(EventAggregator_AggregateEvent(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
 
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
 
     EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -223,26 +232,34 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationEnabled_FailOnAggreg
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, "/var/tmp/processCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
     VailidateCommandLine();
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(NULL);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, "")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(JsonStreamWriter_GetOutput(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonObjectWriter_InitFromString(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, PROCESS_CREATION_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteInt(IGNORED_PTR_ARG, PROCESS_CREATION_PARENT_PROCESS_ID_KEY, 0));
     STRICT_EXPECTED_CALL(EventAggregator_AggregateEvent(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_AGGREGATOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
 
     EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -258,40 +275,46 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_BadRecord_E
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
     STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
 
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
     VailidateCommandLine();
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(Map_GetValueFromKey(IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(NULL);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, "")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_PROCESS_CREATE)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     // another record - the uncomplete record
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
 
     VailidateCommandLine();
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_RECORD_HAS_ERRORS);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     // no more records
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
@@ -299,6 +322,9 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_BadRecord_E
     STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
 
     EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
     ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
@@ -313,19 +339,20 @@ TEST_FUNCTION(ProcessCreationCollector_GetEvents_AggregationDisabled_ExpectFailu
 
     STRICT_EXPECTED_CALL(AuditSearch_Init(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, "EXECVE", "/var/tmp/processCreationCheckpoint")).SetFailReturn(!AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
 
     // we can't have a fail return to all fields since the negative tests count on the fact that 0 is the value of success
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleInterpretStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "exe", PROCESS_CREATION_EXECUTABLE_KEY, false)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
 
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_PROCESS_CREATE)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_OK);
@@ -351,11 +378,15 @@ TEST_FUNCTION(ProcessCreationCollector_Init_ExpectSuccess)
 
     STRICT_EXPECTED_CALL(AuditControl_AddRule(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, NULL)).SetReturn(AUDIT_CONTROL_OK);
     STRICT_EXPECTED_CALL(EventAggregator_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_AGGREGATOR_OK);
-    STRICT_EXPECTED_CALL(Map_Create(IGNORED_PTR_ARG)).SetReturn((MAP_HANDLE)0x01);
-    STRICT_EXPECTED_CALL(AuditSearch_Init(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE,IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(LruCache_Init(IGNORED_PTR_ARG, 4096, "/var/tmp/processCreationHashCache")).SetReturn(LRU_CACHE_OK);
+    STRICT_EXPECTED_CALL(LruCache_GetCount(IGNORED_PTR_ARG)).SetReturn(0);
+    STRICT_EXPECTED_CALL(AuditSearch_Init(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, "INTEGRITY_RULE", NULL)).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(Map_GetInternals(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_OK);
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_GetCount(IGNORED_PTR_ARG)).SetReturn(0);
     STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
 
     EventCollectorResult result = ProcessCreationCollector_Init();
@@ -363,4 +394,150 @@ TEST_FUNCTION(ProcessCreationCollector_Init_ExpectSuccess)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(ProcessCreationCollector_Init_CacheLoaded_ExpectNoAuditTrailScan)
+{
+    STRICT_EXPECTED_CALL(AuditControl_Init(IGNORED_PTR_ARG)).SetReturn(AUDIT_CONTROL_OK);
+
+    STRICT_EXPECTED_CALL(AuditControl_AddRule(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, NULL)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(EventAggregator_Init(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_AGGREGATOR_OK);
+    STRICT_EXPECTED_CALL(LruCache_Init(IGNORED_PTR_ARG, 4096, "/var/tmp/processCreationHashCache")).SetReturn(LRU_CACHE_OK);
+    STRICT_EXPECTED_CALL(LruCache_GetCount(IGNORED_PTR_ARG)).SetReturn(3);
+    STRICT_EXPECTED_CALL(LruCache_GetCount(IGNORED_PTR_ARG)).SetReturn(3);
+    STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = ProcessCreationCollector_Init();
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(ProcessCreationCollector_GeneratePayload_HashCached_ExpectHashWritten)
+{
+    SyncQueue mockedQueue;
+    isAggregationEnabled = false;
+    const char* cachedHash = "0123456789abcdef0123456789abcdef01234567";
+
+    STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, "/var/tmp/processCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
+    STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    VailidateCommandLine();
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, "hash", IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_FIELD_DOES_NOT_EXIST);
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG))
+        .CopyOutArgumentBuffer_value(&cachedHash, sizeof(cachedHash))
+        .SetReturn(LRU_CACHE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, cachedHash)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_PROCESS_CREATE)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
+
+    STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+}
+
+TEST_FUNCTION(ProcessCreationCollector_GeneratePayload_HashMissed_ExpectEmptyHashWithoutAuditTrailScan)
+{
+    SyncQueue mockedQueue;
+    isAggregationEnabled = false;
+
+    STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, "/var/tmp/processCreationCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
+    STRICT_EXPECTED_CALL(EventAggregator_IsAggregationEnabled(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, PROCESS_CREATION_NAME, EVENT_TYPE_SECURITY_VALUE, PROCESS_CREATION_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG,IGNORED_PTR_ARG,IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    VailidateCommandLine();
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "uid", PROCESS_CREATION_USER_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", PROCESS_CREATION_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "ppid", PROCESS_CREATION_PARENT_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_InterpretString(IGNORED_PTR_ARG, "hash", IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_FIELD_DOES_NOT_EXIST);
+    STRICT_EXPECTED_CALL(LruCache_Get(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(LRU_CACHE_NOT_FOUND);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, EXTRA_DETAILS_KEY)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, PROCESS_CREATION_EXECUTABLE_HASH_KEY, "")).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_PROCESS_CREATE)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
+
+    STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
+
+    STRICT_EXPECTED_CALL(EventAggregator_GetAggregatedEvents(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
+    STRICT_EXPECTED_CALL(AuditSearch_Deinit(IGNORED_PTR_ARG)); 
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_ChangeToRoot(IGNORED_PTR_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(LruCache_Save(IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ProcessInfoHandler_Reset(IGNORED_PTR_ARG)).SetReturn(true);
+
+    EventCollectorResult result = ProcessCreationCollector_GetEvents(&mockedQueue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+}
+
+TEST_FUNCTION(ProcessCreationCollector_SetAuditExclusions_ExpectExecveExclusionsReplaced)
+{
+    AuditControlExclusions exclusions = { "/usr/bin/noisy", NULL, NULL };
+
+    STRICT_EXPECTED_CALL(AuditControl_Init(IGNORED_PTR_ARG)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(AuditControl_SetExclusions(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 2, "azure_iot_process_exclusion", &exclusions)).SetReturn(AUDIT_CONTROL_OK);
+    STRICT_EXPECTED_CALL(AuditControl_Deinit(IGNORED_PTR_ARG));
+
+    EventCollectorResult result = ProcessCreationCollector_SetAuditExclusions(&exclusions);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+static void DummyAuditEventHandler(AuditSearch* auditSearch, void* context) {
+}
+
+TEST_FUNCTION(ProcessCreationCollector_AddAuditHandler_ExpectIntegrityEventsCached)
+{
+    AuditDispatcher dispatcher;
+    int context = 0;
+
+    STRICT_EXPECTED_CALL(AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 1, DummyAuditEventHandler, &context)).SetReturn(AUDIT_DISPATCHER_OK);
+    STRICT_EXPECTED_CALL(AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 1, IGNORED_PTR_ARG, NULL)).SetReturn(AUDIT_DISPATCHER_OK);
+
+    EventCollectorResult result = ProcessCreationCollector_AddAuditHandler(&dispatcher, DummyAuditEventHandler, &context);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(process_creation_collector_ut)
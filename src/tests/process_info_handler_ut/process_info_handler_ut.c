@@ -59,8 +59,15 @@ TEST_FUNCTION(ProcessInfoHandler_ChangeToRoot_ExpectSuccess)
     ProcessInfo info;
     bool result = ProcessInfoHandler_ChangeToRoot(&info);
     ASSERT_IS_TRUE(result);
+    ASSERT_IS_TRUE(info.wasSet);
     ASSERT_ARE_EQUAL(int, 2, info.effectiveUid);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(1);
+    result = ProcessInfoHandler_Reset(&info);
+    ASSERT_IS_TRUE(result);
+    ASSERT_IS_FALSE(info.wasSet);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(ProcessInfoHandler_ChangeToRoot_AlreadyRoot_ExpectSuccess)
@@ -71,6 +78,9 @@ TEST_FUNCTION(ProcessInfoHandler_ChangeToRoot_AlreadyRoot_ExpectSuccess)
     bool result = ProcessInfoHandler_ChangeToRoot(&info);
     ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(int, 0, info.effectiveUid);
+
+    result = ProcessInfoHandler_Reset(&info);
+    ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
@@ -82,31 +92,61 @@ TEST_FUNCTION(ProcessInfoHandler_ChangeToRoot_ExpectFailure)
     ProcessInfo info;
     bool result = ProcessInfoHandler_ChangeToRoot(&info);
     ASSERT_IS_FALSE(result);
+    ASSERT_IS_FALSE(info.wasSet);
+
+    // nothing to reset after a failure
+    result = ProcessInfoHandler_Reset(&info);
+    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the original user was kept
+    STRICT_EXPECTED_CALL(seteuid(0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(1);
+    ASSERT_IS_TRUE(ProcessInfoHandler_ChangeToRoot(&info));
+    ASSERT_IS_TRUE(ProcessInfoHandler_Reset(&info));
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(ProcessInfoHandler_Reset_ExpectSuccess)
+TEST_FUNCTION(ProcessInfoHandler_Reset_OtherHolders_ExpectPrivilegesKept)
 {
-    STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(1);
+    STRICT_EXPECTED_CALL(geteuid()).SetReturn(2);
+    STRICT_EXPECTED_CALL(seteuid(0)).SetReturn(1);
 
-    ProcessInfo info;
-    info.effectiveUid = 2;
-    info.wasSet = true;
-    bool result = ProcessInfoHandler_Reset(&info);
-    ASSERT_IS_TRUE(result);
+    ProcessInfo firstInfo;
+    ProcessInfo secondInfo;
+    ASSERT_IS_TRUE(ProcessInfoHandler_ChangeToRoot(&firstInfo));
+    ASSERT_IS_TRUE(ProcessInfoHandler_ChangeToRoot(&secondInfo));
+    ASSERT_ARE_EQUAL(int, 2, secondInfo.effectiveUid);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the second holder still works as root
+    ASSERT_IS_TRUE(ProcessInfoHandler_Reset(&firstInfo));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(1);
+    ASSERT_IS_TRUE(ProcessInfoHandler_Reset(&secondInfo));
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(ProcessInfoHandler_Reset_ExpectFailure)
 {
+    STRICT_EXPECTED_CALL(geteuid()).SetReturn(2);
+    STRICT_EXPECTED_CALL(seteuid(0)).SetReturn(1);
     STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(-1);
 
     ProcessInfo info;
-    info.effectiveUid = 2;
-    info.wasSet = true;
+    ASSERT_IS_TRUE(ProcessInfoHandler_ChangeToRoot(&info));
     bool result = ProcessInfoHandler_Reset(&info);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the original user is dropped back to by the next holder
+    STRICT_EXPECTED_CALL(seteuid(0)).SetReturn(1);
+    STRICT_EXPECTED_CALL(seteuid(2)).SetReturn(1);
+    ASSERT_IS_TRUE(ProcessInfoHandler_ChangeToRoot(&info));
+    ASSERT_ARE_EQUAL(int, 2, info.effectiveUid);
+    ASSERT_IS_TRUE(ProcessInfoHandler_Reset(&info));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(ProcessInfoHandler_Reset_IdWasNotSet_ExpectSuccess)
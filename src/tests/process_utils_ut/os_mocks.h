@@ -4,11 +4,18 @@
 #include "macro_utils.h"
 #include "umock_c_prod.h"
 
-#include <stdio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
-MOCKABLE_FUNCTION(, FILE* ,popen, const char*, command, const char*, type);
-MOCKABLE_FUNCTION(, int, pclose, FILE*, stream);
-MOCKABLE_FUNCTION(, void, clearerr, FILE*, stream);
-MOCKABLE_FUNCTION(, int, feof, FILE*, stream);
-MOCKABLE_FUNCTION(, int, ferror, FILE*, stream);
-MOCKABLE_FUNCTION(, size_t, fread, void*, ptr, size_t, size, size_t, nmemb, FILE*, stream);
+MOCKABLE_FUNCTION(, int, pipe2, int*, fds, int, flags);
+MOCKABLE_FUNCTION(, pid_t, fork);
+MOCKABLE_FUNCTION(, int, setpgid, pid_t, pid, pid_t, pgid);
+MOCKABLE_FUNCTION(, int, close, int, fd);
+MOCKABLE_FUNCTION(, ssize_t, read, int, fd, void*, buffer, size_t, size);
+MOCKABLE_FUNCTION(, int, poll, struct pollfd*, fds, nfds_t, nfds, int, timeout);
+MOCKABLE_FUNCTION(, int, kill, pid_t, pid, int, sig);
+MOCKABLE_FUNCTION(, pid_t, waitpid, pid_t, pid, int*, status, int, options);
@@ -5,12 +5,15 @@
 #include "macro_utils.h"
 
 #include "umock_c.h"
+#include "umocktypes_bool.h"
 #include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
+#include "cancellation.h"
 #include "os_mocks.h"
 #undef ENABLE_MOCKS
 
+#include <string.h>
 #include "os_utils/process_utils.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
@@ -24,6 +27,33 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL(temp_str);
 }
 
+static int mockedPipe[2] = { 3, 4 };
+static const pid_t mockedPid = 1234;
+static const char* command = "abc def";
+
+static void ExpectStart() {
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC)).CopyOutArgumentBuffer_fds(mockedPipe, sizeof(mockedPipe)).SetReturn(0);
+    STRICT_EXPECTED_CALL(fork()).SetReturn(mockedPid);
+    STRICT_EXPECTED_CALL(close(mockedPipe[1]));
+    STRICT_EXPECTED_CALL(setpgid(mockedPid, mockedPid));
+}
+
+static void ExpectOutput(const char* data, size_t requested, ssize_t dataSize) {
+    STRICT_EXPECTED_CALL(Cancellation_GetRemainingTime()).SetReturn(UINT32_MAX);
+    STRICT_EXPECTED_CALL(poll(IGNORED_PTR_ARG, 1, 500)).SetReturn(1);
+    if (dataSize > 0) {
+        STRICT_EXPECTED_CALL(read(mockedPipe[0], IGNORED_PTR_ARG, requested)).CopyOutArgumentBuffer_buffer(data, dataSize).SetReturn(dataSize);
+    } else {
+        STRICT_EXPECTED_CALL(read(mockedPipe[0], IGNORED_PTR_ARG, requested)).SetReturn(dataSize);
+    }
+}
+
+static void ExpectExit(int exitStatus) {
+    int status = exitStatus << 8;
+    STRICT_EXPECTED_CALL(close(mockedPipe[0]));
+    STRICT_EXPECTED_CALL(waitpid(mockedPid, IGNORED_PTR_ARG, 0)).CopyOutArgumentBuffer_status(&status, sizeof(status)).SetReturn(mockedPid);
+}
+
 BEGIN_TEST_SUITE(process_utils_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -35,7 +65,13 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     umock_c_init(on_umock_c_error);
 
+    umocktypes_bool_register_types();
     umocktypes_charptr_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(pid_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long long);
+    REGISTER_UMOCK_ALIAS_TYPE(nfds_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -52,82 +88,137 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
 TEST_FUNCTION(ProccesUtils_Execute_ExpectSuccess)
 {
-    FILE* mockedStream = (FILE*) 0x1;
-    const char* command = "abc def";
     uint32_t dataSize = 56;
     char buffer[56] = "";
 
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(feof(mockedStream)).SetReturn(1);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    ExpectStart();
+    ExpectOutput("abc", 56, 3);
+    ExpectOutput("def", 53, 3);
+    ExpectOutput(NULL, 50, 0);
+    ExpectExit(0);
 
     bool result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_TRUE(result);
-    ASSERT_ARE_EQUAL(int, 56, dataSize);
+    ASSERT_ARE_EQUAL(int, 6, dataSize);
+    ASSERT_IS_TRUE(memcmp(buffer, "abcdef", 6) == 0);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(10);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+TEST_FUNCTION(ProccesUtils_Execute_OutputFillsBuffer_ExpectSuccess)
+{
+    uint32_t dataSize = 3;
+    char buffer[3] = "";
 
-    result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ExpectStart();
+    ExpectOutput("abc", 3, 3);
+    // the buffer is full, a single byte is read to find out whether there is more output
+    ExpectOutput(NULL, 1, 0);
+    ExpectExit(0);
+
+    bool result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_TRUE(result);
-    ASSERT_ARE_EQUAL(int, 10, dataSize);
+    ASSERT_ARE_EQUAL(int, 3, dataSize);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
 TEST_FUNCTION(ProccesUtils_Execute_ExpectFailure)
 {
-    FILE* mockedStream = (FILE*) 0x1;
-    const char* command = "abc def";
     uint32_t dataSize = 56;
     char buffer[56] = "";
 
-    // popen failed
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(NULL);
+    // pipe failed
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC)).SetReturn(-1);
     bool result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // fork failed
+    STRICT_EXPECTED_CALL(pipe2(IGNORED_PTR_ARG, O_CLOEXEC)).CopyOutArgumentBuffer_fds(mockedPipe, sizeof(mockedPipe)).SetReturn(0);
+    STRICT_EXPECTED_CALL(fork()).SetReturn(-1);
+    STRICT_EXPECTED_CALL(close(mockedPipe[1]));
+    STRICT_EXPECTED_CALL(close(mockedPipe[0]));
+    result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // read failed
+    dataSize = 56;
+    ExpectStart();
+    ExpectOutput(NULL, 56, -1);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
+    ExpectExit(0);
+    result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
 
-    // fread failed - error is set
+    // more data to read
+    dataSize = 3;
+    ExpectStart();
+    ExpectOutput("abc", 3, 3);
+    ExpectOutput("d", 1, 1);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(false);
+    ExpectExit(0);
+    result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    // the command failed - not found
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(1);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    ExpectStart();
+    ExpectOutput(NULL, 56, 0);
+    ExpectExit(127);
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    
-    // fread failed - more data to read in file
+    umock_c_reset_all_calls();
+
+    // the command was killed by a signal
+    int signaledStatus = SIGPIPE;
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(dataSize);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(feof(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream));
+    ExpectStart();
+    ExpectOutput(NULL, 56, 0);
+    STRICT_EXPECTED_CALL(close(mockedPipe[0]));
+    STRICT_EXPECTED_CALL(waitpid(mockedPid, IGNORED_PTR_ARG, 0)).CopyOutArgumentBuffer_status(&signaledStatus, sizeof(signaledStatus)).SetReturn(mockedPid);
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    
-    // pclose failed - process not found
+    umock_c_reset_all_calls();
+
+    // waiting for the command failed
     dataSize = 56;
-    STRICT_EXPECTED_CALL(popen(command, "r")).SetReturn(mockedStream);
-    STRICT_EXPECTED_CALL(clearerr(mockedStream));
-    STRICT_EXPECTED_CALL(fread(IGNORED_PTR_ARG, 1, dataSize, mockedStream)).SetReturn(10);
-    STRICT_EXPECTED_CALL(ferror(mockedStream)).SetReturn(0);
-    STRICT_EXPECTED_CALL(pclose(mockedStream)).SetReturn(32512);
+    ExpectStart();
+    ExpectOutput(NULL, 56, 0);
+    STRICT_EXPECTED_CALL(close(mockedPipe[0]));
+    STRICT_EXPECTED_CALL(waitpid(mockedPid, IGNORED_PTR_ARG, 0)).SetReturn(-1);
     result = ProcessUtils_Execute(command, buffer, &dataSize);
     ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(ProccesUtils_Execute_Cancelled_ExpectChildKilled)
+{
+    uint32_t dataSize = 56;
+    char buffer[56] = "";
+    int killedStatus = SIGKILL;
+
+    ExpectStart();
+    // the output does not arrive before the deadline
+    STRICT_EXPECTED_CALL(Cancellation_GetRemainingTime()).SetReturn(200);
+    STRICT_EXPECTED_CALL(poll(IGNORED_PTR_ARG, 1, 200)).SetReturn(0);
+    STRICT_EXPECTED_CALL(Cancellation_GetRemainingTime()).SetReturn(0);
+    STRICT_EXPECTED_CALL(Cancellation_IsRequested()).SetReturn(true);
+    // the whole process group of the shell is killed
+    STRICT_EXPECTED_CALL(kill(-mockedPid, SIGKILL));
+    STRICT_EXPECTED_CALL(close(mockedPipe[0]));
+    STRICT_EXPECTED_CALL(waitpid(mockedPid, IGNORED_PTR_ARG, 0)).CopyOutArgumentBuffer_status(&killedStatus, sizeof(killedStatus)).SetReturn(mockedPid);
+
+    bool result = ProcessUtils_Execute(command, buffer, &dataSize);
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(process_utils_ut)
@@ -98,10 +98,10 @@ TEST_FUNCTION(Queue_PushBackAndPop_ExpectSuccess)
     char* secondMessage = strdup("second message");
     unsigned int size;
 
-    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1, 7);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
-    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1);
+    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
     Queue_GetSize(&queue, &size);
@@ -109,10 +109,12 @@ TEST_FUNCTION(Queue_PushBackAndPop_ExpectSuccess)
 
     char* output;
     unsigned int messageSize;
-    result = Queue_PopFront(&queue, (void**)&output, &messageSize);
+    uint32_t tag;
+    result = Queue_PopFront(&queue, (void**)&output, &messageSize, &tag);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
     ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, messageSize);
+    ASSERT_ARE_EQUAL(int, 7, tag);
 
     Queue_Deinit(&queue);
 
@@ -130,10 +132,10 @@ TEST_FUNCTION(Queue_PushBackAndPopIfConditionReutrnsTrue_ExpectSuccess)
     char* secondMessage = strdup("second message");
     unsigned int size;
 
-    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
-    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1);
+    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
     Queue_GetSize(&queue, &size);
@@ -162,10 +164,10 @@ TEST_FUNCTION(Queue_PushBackAndPopIfConditionReutrnsFalse_ExpectSuccess)
     char* secondMessage = strdup("second message");
     unsigned int size;
 
-    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1);
+    result = Queue_PushBack(&queue, firstMessage, strlen(firstMessage)+1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
-    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1);
+    result = Queue_PushBack(&queue, secondMessage, strlen(secondMessage)+1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
     Queue_GetSize(&queue, &size);
@@ -194,13 +196,13 @@ TEST_FUNCTION(Queue_MaxLocalCacheSizeExceeded_ExpectMaxMemoryExceeded)
     STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
-    result = Queue_PushBack(&queue, message, strlen(message) + 1);
+    result = Queue_PushBack(&queue, message, strlen(message) + 1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_OK).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
-    result = Queue_PushBack(&queue, message, strlen(message) + 1);
+    result = Queue_PushBack(&queue, message, strlen(message) + 1, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
 
     Queue_GetSize(&queue, &size);
@@ -219,7 +221,7 @@ TEST_FUNCTION(Queue_PopEmpty_ExpectQueueIsEmpty)
     unsigned int size;
     unsigned int messageSize;
 
-    result = Queue_PopFront(&queue, (void**)firstMessage, &messageSize);
+    result = Queue_PopFront(&queue, (void**)firstMessage, &messageSize, NULL);
     ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
 
     Queue_GetSize(&queue, &size);
@@ -243,7 +245,7 @@ TEST_FUNCTION(Queue_MemoryMonitorExcpetion_ExpectMemoryException)
     STRICT_EXPECTED_CALL(MemoryMonitor_Consume(0)).SetReturn(MEMORY_MONITOR_EXCEPTION).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true).IgnoreAllArguments();
 
-    result = Queue_PushBack(&queue, firstMessage, messageSize);
+    result = Queue_PushBack(&queue, firstMessage, messageSize, QUEUE_NO_TAG);
     ASSERT_ARE_EQUAL(int, QUEUE_MEMORY_EXCEPTION, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
@@ -258,4 +260,87 @@ TEST_FUNCTION(Queue_MemoryMonitorExcpetion_ExpectMemoryException)
 }
 
 
+TEST_FUNCTION(Queue_PopFrontBatch_ExpectItemsWithinBudget)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first");
+    char* secondMessage = strdup("second");
+    char* thirdMessage = strdup("third");
+    unsigned int size;
+
+    Queue_PushBack(&queue, firstMessage, strlen(firstMessage) + 1, QUEUE_NO_TAG);
+    Queue_PushBack(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_NO_TAG);
+    Queue_PushBack(&queue, thirdMessage, strlen(thirdMessage) + 1, QUEUE_NO_TAG);
+
+    QueueBatchItem items[3];
+    uint32_t itemsCount = 0;
+    // the budget fits only the first two messages
+    result = Queue_PopFrontBatch(&queue, strlen(firstMessage) + strlen(secondMessage) + 3, 0, 3, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, items[0].data);
+    ASSERT_ARE_EQUAL(char_ptr, secondMessage, items[1].data);
+    ASSERT_ARE_EQUAL(int, strlen(secondMessage) + 1, items[1].dataSize);
+
+    Queue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    // the budget does not fit the next message
+    result = Queue_PopFrontBatch(&queue, 1, 0, 3, items + 2, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 0, itemsCount);
+
+    // the number of items is bounded by maxItems
+    result = Queue_PopFrontBatch(&queue, 1000, 0, 1, items + 2, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, thirdMessage, items[2].data);
+    ASSERT_IS_NULL(queue.firstItem);
+    ASSERT_IS_NULL(queue.lastItem);
+
+    result = Queue_PopFrontBatch(&queue, 1000, 0, 3, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    Queue_Deinit(&queue);
+
+    free(firstMessage);
+    free(secondMessage);
+    free(thirdMessage);
+}
+
+TEST_FUNCTION(Queue_PopFrontBatch_WithItemOverhead_ExpectOverheadCountedInBudget)
+{
+    Queue queue;
+    int result = Queue_Init(&queue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first");
+    char* secondMessage = strdup("second");
+
+    Queue_PushBack(&queue, firstMessage, strlen(firstMessage) + 1, QUEUE_NO_TAG);
+    Queue_PushBack(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_NO_TAG);
+
+    QueueBatchItem items[2];
+    uint32_t itemsCount = 0;
+    // both messages fit the budget on their own, but not with a byte of overhead each
+    result = Queue_PopFrontBatch(&queue, strlen(firstMessage) + strlen(secondMessage) + 3, 1, 2, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, items[0].data);
+    ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, items[0].dataSize);
+
+    result = Queue_PopFrontBatch(&queue, strlen(secondMessage) + 3, 1, 2, items + 1, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, secondMessage, items[1].data);
+
+    Queue_Deinit(&queue);
+
+    free(firstMessage);
+    free(secondMessage);
+}
+
 END_TEST_SUITE(queue_ut)
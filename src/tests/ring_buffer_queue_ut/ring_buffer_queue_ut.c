@@ -0,0 +1,331 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umock_c_negative_tests.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+#include "umockalloc.h"
+
+#define ENABLE_MOCKS
+#include "twin_configuration.h"
+#include "memory_monitor.h"
+#include "local_config.h"
+#include "agent_telemetry_counters.h"
+#undef ENABLE_MOCKS
+
+#include "ring_buffer_queue.h"
+#include "logger.h"
+#include <stdint.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+bool alwaysTrueCondition(const void* data, uint32_t size, void* params) {
+    return true;
+}
+
+bool alwaysFalseCondition(const void* data, uint32_t size, void* params) {
+    return false;
+}
+
+BEGIN_TEST_SUITE(ring_buffer_queue_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
+
+    umock_c_reset_all_calls();
+
+    REGISTER_GLOBAL_MOCK_RETURN(AgentTelemetryCounter_Init, true);
+    REGISTER_GLOBAL_MOCK_RETURN(AgentTelemetryCounter_IncreaseBy, true);
+    REGISTER_GLOBAL_MOCK_RETURN(MemoryMonitor_Consume, MEMORY_MONITOR_OK);
+}
+
+TEST_FUNCTION(RingBufferQueue_Init_ExpectCapacityRoundedUp)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(int, 8, queue.capacity);
+    ASSERT_ARE_EQUAL(int, 7, queue.mask);
+    ASSERT_IS_NOT_NULL(queue.slots);
+
+    uint32_t size;
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingBufferQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingBufferQueue_Init_ZeroCapacity_ExpectFailure)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 0);
+    ASSERT_ARE_EQUAL(int, QUEUE_MEMORY_EXCEPTION, result);
+    ASSERT_IS_NULL(queue.slots);
+}
+
+TEST_FUNCTION(RingBufferQueue_PushBackAndPop_ExpectSuccess)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    char* secondMessage = strdup("second message");
+    uint32_t size;
+
+    result = RingBufferQueue_PushBack(&queue, firstMessage, strlen(firstMessage) + 1, 7);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    result = RingBufferQueue_PushBack(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_NO_TAG);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 2, size);
+
+    char* output;
+    uint32_t messageSize;
+    uint32_t tag;
+    result = RingBufferQueue_PopFront(&queue, (void**)&output, &messageSize, &tag);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, messageSize);
+    ASSERT_ARE_EQUAL(int, 7, tag);
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    RingBufferQueue_Deinit(&queue);
+
+    // free the message popped from the queue
+    free(output);
+}
+
+TEST_FUNCTION(RingBufferQueue_PopIfConditionReturnsFalse_ExpectItemKept)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = strdup("first message");
+    uint32_t size;
+
+    result = RingBufferQueue_PushBack(&queue, message, strlen(message) + 1, QUEUE_NO_TAG);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* output = NULL;
+    uint32_t messageSize;
+    result = RingBufferQueue_PopFrontIf(&queue, alwaysFalseCondition, NULL, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    result = RingBufferQueue_PopFrontIf(&queue, alwaysTrueCondition, NULL, (void**)&output, &messageSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, message, output);
+
+    RingBufferQueue_Deinit(&queue);
+    free(output);
+}
+
+TEST_FUNCTION(RingBufferQueue_PushWhenFull_ExpectMaxMemoryExceeded)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 2);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first message");
+    char* secondMessage = strdup("second message");
+    char* thirdMessage = strdup("third message");
+    uint32_t size;
+
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PushBack(&queue, firstMessage, strlen(firstMessage) + 1, QUEUE_NO_TAG));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PushBack(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_NO_TAG));
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(strlen(thirdMessage) + 1 + QUEUE_ITEM_MEMORY_OVERHEAD));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1)).IgnoreArgument(1).IgnoreArgument(2);
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(strlen(thirdMessage) + 1 + QUEUE_ITEM_MEMORY_OVERHEAD));
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, 1)).IgnoreArgument(1).IgnoreArgument(2);
+
+    result = RingBufferQueue_PushBack(&queue, thirdMessage, strlen(thirdMessage) + 1, QUEUE_NO_TAG);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 2, size);
+
+    // the slot of a popped item is reusable on the next lap
+    char* output;
+    uint32_t messageSize;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PopFront(&queue, (void**)&output, &messageSize, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    free(output);
+
+    result = RingBufferQueue_PushBack(&queue, thirdMessage, strlen(thirdMessage) + 1, QUEUE_NO_TAG);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PopFront(&queue, (void**)&output, &messageSize, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, secondMessage, output);
+    free(output);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PopFront(&queue, (void**)&output, &messageSize, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, thirdMessage, output);
+    free(output);
+
+    RingBufferQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingBufferQueue_MaxLocalCacheSizeExceeded_ExpectMaxMemoryExceeded)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = strdup("first message");
+    uint32_t size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(MemoryMonitor_Consume(IGNORED_NUM_ARG)).SetReturn(MEMORY_MONITOR_MEMORY_EXCEEDED).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).IgnoreAllArguments();
+    result = RingBufferQueue_PushBack(&queue, message, strlen(message) + 1, QUEUE_NO_TAG);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingBufferQueue_Deinit(&queue);
+
+    // free the message, as push to queue failed
+    free(message);
+}
+
+TEST_FUNCTION(RingBufferQueue_PopEmpty_ExpectQueueIsEmpty)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    void* output;
+    uint32_t messageSize;
+
+    result = RingBufferQueue_PopFront(&queue, &output, &messageSize, NULL);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    RingBufferQueue_Deinit(&queue);
+}
+
+TEST_FUNCTION(RingBufferQueue_PopFrontBatch_ExpectItemsWithinBudget)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* firstMessage = strdup("first");
+    char* secondMessage = strdup("second");
+    char* thirdMessage = strdup("third");
+    uint32_t size;
+
+    RingBufferQueue_PushBack(&queue, firstMessage, strlen(firstMessage) + 1, QUEUE_NO_TAG);
+    RingBufferQueue_PushBack(&queue, secondMessage, strlen(secondMessage) + 1, QUEUE_NO_TAG);
+    RingBufferQueue_PushBack(&queue, thirdMessage, strlen(thirdMessage) + 1, QUEUE_NO_TAG);
+
+    QueueBatchItem items[3];
+    uint32_t itemsCount = 0;
+    umock_c_reset_all_calls();
+    // the memory of the batch is released at once
+    STRICT_EXPECTED_CALL(MemoryMonitor_Release(strlen(firstMessage) + strlen(secondMessage) + 2 + 2 * QUEUE_ITEM_MEMORY_OVERHEAD));
+
+    // the budget fits only the first two messages
+    result = RingBufferQueue_PopFrontBatch(&queue, strlen(firstMessage) + strlen(secondMessage) + 3, 0, 3, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, items[0].data);
+    ASSERT_ARE_EQUAL(char_ptr, secondMessage, items[1].data);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    // the budget does not fit the next message
+    result = RingBufferQueue_PopFrontBatch(&queue, 1, 0, 3, items + 2, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 0, itemsCount);
+
+    result = RingBufferQueue_PopFrontBatch(&queue, 1000, 0, 3, items + 2, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, thirdMessage, items[2].data);
+
+    result = RingBufferQueue_PopFrontBatch(&queue, 1000, 0, 3, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_IS_EMPTY, result);
+
+    RingBufferQueue_Deinit(&queue);
+
+    free(firstMessage);
+    free(secondMessage);
+    free(thirdMessage);
+}
+
+TEST_FUNCTION(RingBufferQueue_GetSize_SlotClaimedNotPublished_ExpectNotCounted)
+{
+    RingBufferQueue queue;
+    int result = RingBufferQueue_Init(&queue, true, 4);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    char* message = strdup("first message");
+    uint32_t size;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PushBack(&queue, message, strlen(message) + 1, QUEUE_NO_TAG));
+
+    // a producer which claimed the next position but did not publish its item yet
+    queue.enqueuePosition++;
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 1, size);
+
+    char* output;
+    uint32_t messageSize;
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, RingBufferQueue_PopFront(&queue, (void**)&output, &messageSize, NULL));
+    free(output);
+
+    RingBufferQueue_GetSize(&queue, &size);
+    ASSERT_ARE_EQUAL(int, 0, size);
+
+    RingBufferQueue_Deinit(&queue);
+}
+
+END_TEST_SUITE(ring_buffer_queue_ut)
@@ -31,9 +31,10 @@ SchemaValidationResult validate_schema(SyncQueue* eventQueue)
 	SchemaValidationResult result = SCHEMA_VALIDATION_OK;
 
  	char* messageJsonString = NULL;
+	uint32_t messageJsonStringSize = 0;
 
     SyncQueue* queues[] = {eventQueue};
-    if(MESSAGE_SERIALIZER_OK != MessageSerializer_CreateSecurityMessage(queues, 1, (void**)&messageJsonString))
+    if(MESSAGE_SERIALIZER_OK != MessageSerializer_CreateSecurityMessage(queues, 1, MESSAGE_SERIALIZER_ENCODING_JSON, false, (void**)&messageJsonString, &messageJsonStringSize))
 	{
 		result = SCHEMA_VALIDATION_ERROR;
 		goto cleanup;
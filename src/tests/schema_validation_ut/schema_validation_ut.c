@@ -181,9 +181,12 @@ TEST_FUNCTION(SchemaValidation_Telemetry)
     counterData.failedMessages = 3;
     counterData.sentMessages = 4;
     counterData.smallMessages = 5;
+    counterData.sentBytes = 6;
+    counterData.billedBytes = 7;
 
     STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetQueueCounterData(IGNORED_NUM_ARG, IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counter, sizeof(counter));
     STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetMessageCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK).CopyOutArgumentBuffer_counterData(&counterData, sizeof(counterData));
+    STRICT_EXPECTED_CALL(AgentTelemetryProvider_GetEvictedEventsCounterData(IGNORED_PTR_ARG)).SetReturn(TELEMETRY_PROVIDER_OK);
 
     SyncQueue queue;
     ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_Init(&queue, false));
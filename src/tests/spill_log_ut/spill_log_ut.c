@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+#include "umocktypes_stdint.h"
+#include "umocktypes_bool.h"
+
+#include "spill_log.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static const char SPILL_LOG_DIRECTORY[] = "/tmp";
+static const char SPILL_LOG_NAME[] = "spill_log_ut";
+static const char SPILL_LOG_PATH[] = "/tmp/spill_log_ut.spill";
+
+BEGIN_TEST_SUITE(spill_log_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+    (void)umocktypes_bool_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(SpillLog_Init_ExpectFileReservedAndDeletedOnDeinit)
+{
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetCount(&spillLog));
+
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(SPILL_LOG_PATH, &fileStat));
+    ASSERT_ARE_EQUAL(int, 1024, fileStat.st_size);
+
+    SpillLog_Deinit(&spillLog);
+    ASSERT_ARE_NOT_EQUAL(int, 0, access(SPILL_LOG_PATH, F_OK));
+}
+
+TEST_FUNCTION(SpillLog_Init_MissingDirectory_ExpectFailure)
+{
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, "/tmp/spill_log_ut/missing", SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_EXCEPTION, result);
+    ASSERT_IS_NULL(spillLog.segment);
+}
+
+TEST_FUNCTION(SpillLog_Init_SymbolicLink_ExpectFailureAndTargetKept)
+{
+    static const char targetPath[] = "/tmp/spill_log_ut.target";
+    FILE* target = fopen(targetPath, "w");
+    ASSERT_IS_NOT_NULL(target);
+    fputs("target", target);
+    fclose(target);
+    ASSERT_ARE_EQUAL(int, 0, symlink(targetPath, SPILL_LOG_PATH));
+
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_EXCEPTION, result);
+
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, lstat(SPILL_LOG_PATH, &fileStat));
+    ASSERT_IS_TRUE(S_ISLNK(fileStat.st_mode));
+    ASSERT_ARE_EQUAL(int, 0, stat(targetPath, &fileStat));
+    ASSERT_ARE_EQUAL(int, strlen("target"), fileStat.st_size);
+
+    unlink(SPILL_LOG_PATH);
+    unlink(targetPath);
+}
+
+TEST_FUNCTION(SpillLog_Init_FileAccessibleByOthers_ExpectFailureAndFileKept)
+{
+    FILE* file = fopen(SPILL_LOG_PATH, "w");
+    ASSERT_IS_NOT_NULL(file);
+    fputs("planted", file);
+    fclose(file);
+    ASSERT_ARE_EQUAL(int, 0, chmod(SPILL_LOG_PATH, S_IRUSR | S_IWUSR | S_IWGRP | S_IWOTH));
+
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_EXCEPTION, result);
+
+    struct stat fileStat;
+    ASSERT_ARE_EQUAL(int, 0, stat(SPILL_LOG_PATH, &fileStat));
+    ASSERT_ARE_EQUAL(int, strlen("planted"), fileStat.st_size);
+
+    unlink(SPILL_LOG_PATH);
+}
+
+TEST_FUNCTION(SpillLog_Init_PrivateFileExists_ExpectFileTruncatedAndReused)
+{
+    FILE* file = fopen(SPILL_LOG_PATH, "w");
+    ASSERT_IS_NOT_NULL(file);
+    fputs("stale records", file);
+    fclose(file);
+    ASSERT_ARE_EQUAL(int, 0, chmod(SPILL_LOG_PATH, S_IRUSR | S_IWUSR));
+
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetCount(&spillLog));
+    ASSERT_ARE_EQUAL(int, 0, spillLog.segment[0]);
+
+    SpillLog_Deinit(&spillLog);
+    ASSERT_ARE_NOT_EQUAL(int, 0, access(SPILL_LOG_PATH, F_OK));
+}
+
+TEST_FUNCTION(SpillLog_AppendAndRead_ExpectFifoOrder)
+{
+    SpillLog spillLog;
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 1024);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+
+    const char* firstMessage = "first message";
+    const char* secondMessage = "second message";
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, firstMessage, strlen(firstMessage) + 1, 1));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, secondMessage, strlen(secondMessage) + 1, 2));
+    ASSERT_ARE_EQUAL(int, 2, SpillLog_GetCount(&spillLog));
+
+    char* output = NULL;
+    uint32_t outputSize = 0;
+    uint32_t tag = 0;
+    result = SpillLog_Peek(&spillLog, (void**)&output, &outputSize, &tag);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, firstMessage, output);
+    ASSERT_ARE_EQUAL(int, strlen(firstMessage) + 1, outputSize);
+    ASSERT_ARE_EQUAL(int, 1, tag);
+    free(output);
+
+    // peeking does not consume the record
+    ASSERT_ARE_EQUAL(int, 2, SpillLog_GetCount(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+
+    result = SpillLog_Peek(&spillLog, (void**)&output, &outputSize, &tag);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, secondMessage, output);
+    ASSERT_ARE_EQUAL(int, 2, tag);
+    free(output);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetCount(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_IS_EMPTY, SpillLog_Peek(&spillLog, (void**)&output, &outputSize, &tag));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_IS_EMPTY, SpillLog_Remove(&spillLog));
+
+    SpillLog_Deinit(&spillLog);
+}
+
+TEST_FUNCTION(SpillLog_Append_LogFull_ExpectFullUntilDrained)
+{
+    SpillLog spillLog;
+    // room for exactly two records of 12 bytes
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 40);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+
+    const char* message = "0123456789a";
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, message, 12, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, message, 12, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_FULL, SpillLog_Append(&spillLog, message, 1, 0));
+
+    // the space of a read record is reused while other records are pending
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, message, 12, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_FULL, SpillLog_Append(&spillLog, message, 1, 0));
+
+    // once drained the log rewinds
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, message, 12, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, message, 12, 0));
+    ASSERT_ARE_EQUAL(int, 2, SpillLog_GetCount(&spillLog));
+
+    SpillLog_Deinit(&spillLog);
+}
+
+TEST_FUNCTION(SpillLog_Append_EndOfFileReached_ExpectWrappedInFifoOrder)
+{
+    SpillLog spillLog;
+    // room for three records of 5 bytes along with their headers, the end of the file is too short for a fourth
+    SpillLogResultValues result = SpillLog_Init(&spillLog, SPILL_LOG_DIRECTORY, SPILL_LOG_NAME, 45);
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, result);
+
+    const char* messages[] = { "msg1", "msg2", "msg3", "msg4", "msg5" };
+    for (int i = 0; i < 3; i++) {
+        ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, messages[i], 5, 0));
+    }
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_FULL, SpillLog_Append(&spillLog, messages[3], 5, 0));
+
+    // the records which were read make room at the beginning of the file
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, messages[3], 5, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Append(&spillLog, messages[4], 5, 0));
+    ASSERT_ARE_EQUAL(int, SPILL_LOG_FULL, SpillLog_Append(&spillLog, messages[0], 5, 0));
+
+    for (int i = 2; i < 5; i++) {
+        char* output = NULL;
+        uint32_t outputSize = 0;
+        uint32_t tag = 0;
+        ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Peek(&spillLog, (void**)&output, &outputSize, &tag));
+        ASSERT_ARE_EQUAL(char_ptr, messages[i], output);
+        free(output);
+        ASSERT_ARE_EQUAL(int, SPILL_LOG_OK, SpillLog_Remove(&spillLog));
+    }
+    ASSERT_ARE_EQUAL(int, 0, SpillLog_GetCount(&spillLog));
+
+    SpillLog_Deinit(&spillLog);
+}
+
+END_TEST_SUITE(spill_log_ut)
@@ -8,7 +8,6 @@
 #include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
-#include "azure_c_shared_utility/lock.h"
 #include "internal/internal_memory_monitor.h"
 #undef ENABLE_MOCKS
 
@@ -41,8 +40,6 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
     REGISTER_UMOCK_ALIAS_TYPE(MemoryMonitorResultValues, int);
-    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -59,61 +56,49 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
 TEST_FUNCTION(SyncMemoryMonitor_Init_ExpectSuccess)
 {
-    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Init());
-    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
 
     bool result = MemoryMonitor_Init();
     ASSERT_IS_TRUE(result);
 
-    MemoryMonitor_Deinit();
-}
-
-TEST_FUNCTION(SyncMemoryMonitor_Init_LockFailed_ExpectFailure)
-{
-    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
-    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Init());
-    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(NULL);
-    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Deinit());
-
-    bool result = MemoryMonitor_Init();
-    ASSERT_IS_FALSE(result);
-
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     MemoryMonitor_Deinit();
 }
 
 TEST_FUNCTION(SyncMemoryMonitor_Deinit_ExpectSuccess)
 {
-    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Init());
-    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
 
     bool result = MemoryMonitor_Init();
     ASSERT_IS_TRUE(result);
 
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Deinit());
-    STRICT_EXPECTED_CALL(Lock_Deinit(mockLockHandle));
 
     MemoryMonitor_Deinit();
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-TEST_FUNCTION(SyncMemoryMonitor_Consume_ExpectSuccess)
+TEST_FUNCTION(SyncMemoryMonitor_UpdateLimit_ExpectSuccess)
+{
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_UpdateLimit()).SetReturn(MEMORY_MONITOR_EXCEPTION);
+
+    MemoryMonitorResultValues memoryResult = MemoryMonitor_UpdateLimit();
+    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, memoryResult);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncMemoryMonitor_Consume_ExpectNoLock)
 {
-    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Init());
-    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
 
     bool result = MemoryMonitor_Init();
     ASSERT_IS_TRUE(result);
 
     uint32_t size = 123;
-    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK);
     MemoryMonitorResultValues mockedConsumeResult = MEMORY_MONITOR_MEMORY_EXCEEDED; 
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Consume(size)).SetReturn(mockedConsumeResult);
-    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK);
 
     MemoryMonitorResultValues memoryResult = MemoryMonitor_Consume(size);   
     ASSERT_ARE_EQUAL(int, mockedConsumeResult, memoryResult);
@@ -122,63 +107,28 @@ TEST_FUNCTION(SyncMemoryMonitor_Consume_ExpectSuccess)
     MemoryMonitor_Deinit();
 }
 
-TEST_FUNCTION(SyncMemoryMonitor_Release_ExpectSuccess)
+TEST_FUNCTION(SyncMemoryMonitor_Release_ExpectNoLock)
 {
     uint32_t size = 123;
-    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_OK);
     MemoryMonitorResultValues mockedConsumeResult = MEMORY_MONITOR_OK; 
     STRICT_EXPECTED_CALL(InternalMemoryMonitor_Release(size)).SetReturn(mockedConsumeResult);
-    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG)).SetReturn(LOCK_OK);
 
     MemoryMonitorResultValues memoryResult = MemoryMonitor_Release(size);   
     ASSERT_ARE_EQUAL(int, mockedConsumeResult, memoryResult);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    MemoryMonitor_Deinit();
 }
 
-TEST_FUNCTION(SyncMemoryMonitor_CurrentConsumption_ExpectSuccess)
+TEST_FUNCTION(SyncMemoryMonitor_CurrentConsumption_ExpectNoLock)
 {
-    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_OK);
+    uint32_t size = 0;
     MemoryMonitorResultValues mockedConsumeResult = MEMORY_MONITOR_OK; 
-    STRICT_EXPECTED_CALL(InternalMemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG)).SetReturn(mockedConsumeResult);
-    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG)).SetReturn(LOCK_OK);
+    STRICT_EXPECTED_CALL(InternalMemoryMonitor_CurrentConsumption(&size)).SetReturn(mockedConsumeResult);
 
-    MemoryMonitorResultValues memoryResult = MemoryMonitor_CurrentConsumption(IGNORED_PTR_ARG);   
+    MemoryMonitorResultValues memoryResult = MemoryMonitor_CurrentConsumption(&size);   
     ASSERT_ARE_EQUAL(int, mockedConsumeResult, memoryResult);
 
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    MemoryMonitor_Deinit();
-}
-
-TEST_FUNCTION(SyncMemoryMonitor_Consume_LockError_ExpectFailure)
-{
-    uint32_t size = 123;
-    
-    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(!LOCK_OK);
-   
-    MemoryMonitorResultValues memoryResult = MemoryMonitor_Consume(size);   
-    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, memoryResult);
-
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    MemoryMonitor_Deinit();
-}
-
-TEST_FUNCTION(SyncMemoryMonitor_Consume_UnlockError_ExpectFailure)
-{
-    uint32_t size = 123;
-    
-    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_OK);
-    MemoryMonitorResultValues mockedConsumeResult = MEMORY_MONITOR_MEMORY_EXCEEDED; 
-    STRICT_EXPECTED_CALL(InternalMemoryMonitor_Consume(size)).SetReturn(mockedConsumeResult);
-    STRICT_EXPECTED_CALL(Unlock(IGNORED_PTR_ARG)).SetReturn(!LOCK_OK);
-
-    MemoryMonitorResultValues memoryResult = MemoryMonitor_Consume(size);   
-    ASSERT_ARE_EQUAL(int, MEMORY_MONITOR_EXCEPTION, memoryResult);
-
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    MemoryMonitor_Deinit();
 }
 
-
 END_TEST_SUITE(sync_memory_monitor_ut)
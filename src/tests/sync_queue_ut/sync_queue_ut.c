@@ -1,15 +1,20 @@
 // Copyright (c) Microsoft. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "testrunnerswitcher.h"
 #include "macro_utils.h"
 #include "umock_c.h"
 #include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
 #include "azure_c_shared_utility/lock.h"
 #include "queue.h"
+#include "ring_buffer_queue.h"
+#include "spill_log.h"
 #undef ENABLE_MOCKS
 
 #include "synchronized_queue.h"
@@ -28,6 +33,35 @@ bool alwaysTrueCondition(const void* data, uint32_t size, void* params) {
     return true;
 }
 
+static uint32_t notificationCount = 0;
+
+static const char SPILLED_DATA[] = "spilled";
+static char* spilledCopy = NULL;
+
+SpillLogResultValues Mocked_SpillLog_Peek(SpillLog* spillLog, void** data, uint32_t* dataSize, uint32_t* tag) {
+    spilledCopy = strdup(SPILLED_DATA);
+    *data = spilledCopy;
+    *dataSize = sizeof(SPILLED_DATA);
+    *tag = QUEUE_NO_TAG;
+    return SPILL_LOG_OK;
+}
+
+QueueResultValues Mocked_RingBufferQueue_PushBack(RingBufferQueue* queue, void* data, uint32_t dataSize, uint32_t tag) {
+    free(data);
+    return QUEUE_OK;
+}
+
+static void countingNotification(void* context) {
+    ++(*(uint32_t*)context);
+}
+
+static uint32_t lastEvictedTag = QUEUE_NO_TAG;
+
+static void countingEvictionCallback(void* context, const void* data, uint32_t dataSize, uint32_t tag) {
+    ++(*(uint32_t*)context);
+    lastEvictedTag = tag;
+}
+
 BEGIN_TEST_SUITE(sync_queue_ut)
 
 
@@ -41,12 +75,16 @@ TEST_SUITE_INITIALIZE(suite_init)
     umock_c_init(on_umock_c_error);
 
     umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
 
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(QueuePopCondition, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
     REGISTER_UMOCK_ALIAS_TYPE(QueueResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(SpillLogResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(uint32_t, unsigned int);
+
+    REGISTER_GLOBAL_MOCK_HOOK(SpillLog_Peek, Mocked_SpillLog_Peek);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -133,7 +171,7 @@ TEST_FUNCTION(SyncQueue_SyncQueue_PushBack_ExpectSuccess)
     STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
     //FIXME: do this to all return values?
     int queueReturnValue = QUEUE_MAX_MEMORY_EXCEEDED;
-    STRICT_EXPECTED_CALL(Queue_PushBack(&syncQueue.queue, data, dataSize)).SetReturn(queueReturnValue).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Queue_PushBack(&syncQueue.queue, data, dataSize, QUEUE_NO_TAG)).SetReturn(queueReturnValue).ValidateAllArguments();
     STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
 
     // test
@@ -159,7 +197,7 @@ TEST_FUNCTION(SyncQueue_SyncQueue_PopFront_ExpectSuccess)
     uint32_t dataSize = 0;
 
     STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
-    STRICT_EXPECTED_CALL(Queue_PopFront(&syncQueue.queue, &data, &dataSize)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Queue_PopFront(&syncQueue.queue, &data, &dataSize, NULL)).SetReturn(QUEUE_OK).ValidateAllArguments();
     STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
 
     // test
@@ -271,4 +309,540 @@ TEST_FUNCTION(SyncQueue_GetSize_UnlockFail_ExpectLockException)
     SyncQueue_Deinit(&syncQueue);
 }
 
+TEST_FUNCTION(SyncQueue_SyncQueue_PopFrontBatch_ExpectSingleLock)
+{
+    SyncQueue syncQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    STRICT_EXPECTED_CALL(Queue_Init(&syncQueue.queue, true)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+
+    int result = SyncQueue_Init(&syncQueue, true);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    QueueBatchItem items[4];
+    uint32_t itemsCount = 0;
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Queue_PopFrontBatch(&syncQueue.queue, 100, 1, 4, items, &itemsCount)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+
+    // test
+    result = SyncQueue_PopFrontBatch(&syncQueue, 100, 1, 4, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_InitRingBuffer_ExpectSuccess)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK).ValidateAllArguments();
+
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, SYNC_QUEUE_RING_BUFFER, syncQueue.type);
+    ASSERT_ARE_EQUAL(void_ptr, &syncQueue.ringBufferQueue.counter, SyncQueue_GetCounter(&syncQueue));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_RingBuffer_PushBackAndPopFront_ExpectNoLock)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    void* data = "abcde";
+    uint32_t dataSize = 5;
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 0;
+
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, dataSize, QUEUE_NO_TAG)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_Deinit(&syncQueue.ringBufferQueue)).ValidateAllArguments();
+
+    // test
+    result = SyncQueue_PushBack(&syncQueue, data, dataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    SyncQueue_Deinit(&syncQueue);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_PushFront_ExpectItemsPoppedBeforeBackendInOrder)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    QueueBatchItem returnedItems[] = { { strdup("first"), 5 }, { strdup("second"), 6 } };
+    QueueBatchItem items[4];
+    uint32_t itemsCount = 0;
+    uint32_t size = 0;
+    umock_c_reset_all_calls();
+
+    // the returned items are neither pushed to the backend nor charged again
+    result = SyncQueue_PushFront(&syncQueue, returnedItems, 2);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG)).CopyOutArgumentBuffer_size(&size, sizeof(size)).SetReturn(QUEUE_OK);
+    result = SyncQueue_GetSize(&syncQueue, &size);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, size);
+
+    // the backend is popped with what is left of the budget, behind the returned items
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFrontBatch(&syncQueue.ringBufferQueue, 100 - 13, 1, 2, items + 2, IGNORED_PTR_ARG)).SetReturn(QUEUE_IS_EMPTY);
+    result = SyncQueue_PopFrontBatch(&syncQueue, 100, 1, 4, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 2, itemsCount);
+    ASSERT_ARE_EQUAL(char_ptr, "first", items[0].data);
+    ASSERT_ARE_EQUAL(char_ptr, "second", items[1].data);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    free(items[0].data);
+    free(items[1].data);
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_PushFront_BudgetExceeded_ExpectBackendNotPopped)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK).ValidateAllArguments();
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    QueueBatchItem returnedItems[] = { { strdup("first"), 5 }, { strdup("second"), 6 } };
+    QueueBatchItem items[4];
+    uint32_t itemsCount = 0;
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 0;
+
+    result = SyncQueue_PushFront(&syncQueue, returnedItems, 2);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    // the first returned item does not fit the budget, the items behind it are not taken either
+    result = SyncQueue_PopFrontBatch(&syncQueue, 4, 0, 4, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_CONDITION_FAILED, result);
+    ASSERT_ARE_EQUAL(int, 0, itemsCount);
+
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "first", poppedData);
+    ASSERT_ARE_EQUAL(int, 5, poppedDataSize);
+    free(poppedData);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the returned item which is left is freed along with the queue
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_SetNotification_PushReachesWatermark_ExpectNotified)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    notificationCount = 0;
+    SyncQueue_SetNotification(&syncQueue, 8, countingNotification, &notificationCount);
+
+    void* data = "abcde";
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 5;
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+
+    // below the watermark
+    SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, 0, notificationCount);
+
+    // the watermark is reached
+    SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, 1, notificationCount);
+    ASSERT_ARE_EQUAL(int, 10, syncQueue.bytesInQueue);
+
+    // a failed push is not counted
+    SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, 1, notificationCount);
+    ASSERT_ARE_EQUAL(int, 10, syncQueue.bytesInQueue);
+
+    SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, 0, syncQueue.bytesInQueue);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_Spill_MemoryExceeded_ExpectSpilledAndRefilledInOrder)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    STRICT_EXPECTED_CALL(SpillLog_Init(&syncQueue.spillLog, "/tmp", "events", 1024)).SetReturn(SPILL_LOG_OK).ValidateAllArguments();
+    result = SyncQueue_EnableSpill(&syncQueue, "/tmp", "events", 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_IS_FALSE(syncQueue.ringBufferQueue.shouldCountDrops);
+
+    char* firstData = strdup("first");
+    char* secondData = strdup("second");
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 0;
+
+    // the backend is full, the first item is spilled
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(0);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, firstData, 6, QUEUE_NO_TAG)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&syncQueue.spillLog, firstData, 6, QUEUE_NO_TAG)).SetReturn(SPILL_LOG_OK);
+    // the second item follows it to keep the order
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(1);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&syncQueue.spillLog, secondData, 7, QUEUE_NO_TAG)).SetReturn(SPILL_LOG_OK);
+    // popping from the drained backend refills it from the spill log
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(2);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&syncQueue.spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG, sizeof(SPILLED_DATA), QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Remove(&syncQueue.spillLog)).SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&syncQueue.spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(SPILL_LOG_IS_EMPTY);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Deinit(&syncQueue.spillLog));
+    STRICT_EXPECTED_CALL(RingBufferQueue_Deinit(&syncQueue.ringBufferQueue));
+
+    // test
+    result = SyncQueue_PushBack(&syncQueue, firstData, 6);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    result = SyncQueue_PushBack(&syncQueue, secondData, 7);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 13, syncQueue.bytesInQueue);
+
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    SyncQueue_Deinit(&syncQueue);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the refilled copy was handed to the mocked backend
+    free(spilledCopy);
+}
+
+TEST_FUNCTION(SyncQueue_Spill_BackendBelowLowWatermark_ExpectRefilledBeforeDrained)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 1024)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    STRICT_EXPECTED_CALL(SpillLog_Init(&syncQueue.spillLog, "/tmp", "events", 1024)).SetReturn(SPILL_LOG_OK);
+    result = SyncQueue_EnableSpill(&syncQueue, "/tmp", "events", 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 0;
+    uint32_t aboveWatermark = 64;
+    uint32_t belowWatermark = 63;
+
+    // the backend holds enough items, the spilled item stays on disk
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(1);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_size(&aboveWatermark, sizeof(aboveWatermark));
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+    // the backend runs low, the spilled item is moved back though the backend did not drain
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(1);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_size(&belowWatermark, sizeof(belowWatermark));
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&syncQueue.spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG, sizeof(SPILLED_DATA), QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Remove(&syncQueue.spillLog)).SetReturn(SPILL_LOG_OK);
+    STRICT_EXPECTED_CALL(SpillLog_Peek(&syncQueue.spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(SPILL_LOG_IS_EMPTY);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+
+    // test
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the refilled copy was handed to the mocked backend
+    free(spilledCopy);
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_Spill_ManyItemsSpilled_ExpectRefilledInBatches)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 1024)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    STRICT_EXPECTED_CALL(SpillLog_Init(&syncQueue.spillLog, "/tmp", "events", 1024)).SetReturn(SPILL_LOG_OK);
+    result = SyncQueue_EnableSpill(&syncQueue, "/tmp", "events", 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+    REGISTER_GLOBAL_MOCK_HOOK(RingBufferQueue_PushBack, Mocked_RingBufferQueue_PushBack);
+
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 0;
+
+    // a single pop moves back no more than a batch of the spilled items
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(1000);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK);
+    for (int i = 0; i < 256; i++) {
+        STRICT_EXPECTED_CALL(SpillLog_Peek(&syncQueue.spillLog, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+        STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG, sizeof(SPILLED_DATA), QUEUE_NO_TAG));
+        STRICT_EXPECTED_CALL(SpillLog_Remove(&syncQueue.spillLog)).SetReturn(SPILL_LOG_OK);
+    }
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, &poppedData, &poppedDataSize, NULL)).SetReturn(QUEUE_OK);
+
+    // test
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    REGISTER_GLOBAL_MOCK_HOOK(RingBufferQueue_PushBack, NULL);
+    SyncQueue_Deinit(&syncQueue);
+}
+
+TEST_FUNCTION(SyncQueue_Spill_SpillLogFull_ExpectDropCounted)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    STRICT_EXPECTED_CALL(SpillLog_Init(&syncQueue.spillLog, "/tmp", "events", 1024)).SetReturn(SPILL_LOG_OK);
+    result = SyncQueue_EnableSpill(&syncQueue, "/tmp", "events", 1024);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    void* data = "abcde";
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&syncQueue.spillLog)).SetReturn(0);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&syncQueue.spillLog, data, 5, QUEUE_NO_TAG)).SetReturn(SPILL_LOG_FULL);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&syncQueue.ringBufferQueue.counter, &syncQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+
+    // test
+    result = SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(int, 0, syncQueue.bytesInQueue);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_Evict_MemoryExceeded_ExpectOldestLowPriorityItemEvicted)
+{
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    uint32_t evictedCount = 0;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&highPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&lowPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&highPriorityQueue, true, 16));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&lowPriorityQueue, true, 16));
+    highPriorityQueue.ringBufferQueue.capacity = 16;
+
+    // the pushing threads of the high priority queue become consumers of the low priority queue
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    int result = SyncQueue_SetEvictionQueue(&highPriorityQueue, &lowPriorityQueue, countingEvictionCallback, &evictedCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_IS_FALSE(highPriorityQueue.ringBufferQueue.shouldCountDrops);
+    SyncQueue_SetEvictionEnabled(&highPriorityQueue, true);
+
+    void* data = "abcde";
+    void* evictedData = strdup("evicted");
+    uint32_t evictedDataSize = 8;
+    uint32_t evictedTag = 2;
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&highPriorityQueue.ringBufferQueue, data, 5, 1)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&highPriorityQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&lowPriorityQueue.ringBufferQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_data(&evictedData, sizeof(evictedData))
+        .CopyOutArgumentBuffer_dataSize(&evictedDataSize, sizeof(evictedDataSize))
+        .CopyOutArgumentBuffer_tag(&evictedTag, sizeof(evictedTag));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&lowPriorityQueue.ringBufferQueue.counter, &lowPriorityQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&highPriorityQueue.ringBufferQueue, data, 5, 1)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_Deinit(&highPriorityQueue.ringBufferQueue));
+    STRICT_EXPECTED_CALL(RingBufferQueue_Deinit(&lowPriorityQueue.ringBufferQueue));
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockLockHandle)).ValidateAllArguments();
+
+    // test
+    result = SyncQueue_PushBackTagged(&highPriorityQueue, data, 5, 1);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 1, evictedCount);
+    // the callback gets the tag of the evicted item without looking into its data
+    ASSERT_ARE_EQUAL(int, 2, lastEvictedTag);
+    ASSERT_ARE_EQUAL(int, 5, highPriorityQueue.bytesInQueue);
+
+    SyncQueue_Deinit(&highPriorityQueue);
+    SyncQueue_Deinit(&lowPriorityQueue);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_Evict_Disabled_ExpectDropCounted)
+{
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&highPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&lowPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&highPriorityQueue, true, 16));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&lowPriorityQueue, true, 16));
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn((LOCK_HANDLE)0x1);
+    int result = SyncQueue_SetEvictionQueue(&highPriorityQueue, &lowPriorityQueue, NULL, NULL);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    umock_c_reset_all_calls();
+
+    void* data = "abcde";
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&highPriorityQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&highPriorityQueue.ringBufferQueue.counter, &highPriorityQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+
+    // test
+    result = SyncQueue_PushBack(&highPriorityQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_Evict_SpillEnabled_ExpectSpilledBeforeEvicting)
+{
+    SyncQueue highPriorityQueue;
+    SyncQueue lowPriorityQueue;
+    LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+    uint32_t evictedCount = 0;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&highPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&lowPriorityQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&highPriorityQueue, true, 16));
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_InitRingBuffer(&lowPriorityQueue, true, 16));
+    highPriorityQueue.ringBufferQueue.capacity = 16;
+
+    STRICT_EXPECTED_CALL(SpillLog_Init(&highPriorityQueue.spillLog, "/tmp", "events", 1024)).SetReturn(SPILL_LOG_OK);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_EnableSpill(&highPriorityQueue, "/tmp", "events", 1024));
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_SetEvictionQueue(&highPriorityQueue, &lowPriorityQueue, countingEvictionCallback, &evictedCount));
+    SyncQueue_SetEvictionEnabled(&highPriorityQueue, true);
+    umock_c_reset_all_calls();
+
+    // the first item does not fit the memory and is spilled, nothing is evicted for it
+    char* firstData = strdup("first");
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&highPriorityQueue.spillLog)).SetReturn(0);
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&highPriorityQueue.ringBufferQueue, firstData, 6, QUEUE_NO_TAG)).SetReturn(QUEUE_MAX_MEMORY_EXCEEDED);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&highPriorityQueue.spillLog, firstData, 6, QUEUE_NO_TAG)).SetReturn(SPILL_LOG_OK);
+
+    // the spill log is full by the second item, only then an item of the low priority queue is evicted
+    char* secondData = strdup("second");
+    void* evictedData = strdup("evicted");
+    uint32_t evictedDataSize = 8;
+    STRICT_EXPECTED_CALL(SpillLog_GetCount(&highPriorityQueue.spillLog)).SetReturn(1);
+    STRICT_EXPECTED_CALL(SpillLog_Append(&highPriorityQueue.spillLog, secondData, 7, QUEUE_NO_TAG)).SetReturn(SPILL_LOG_FULL);
+    STRICT_EXPECTED_CALL(RingBufferQueue_GetSize(&highPriorityQueue.ringBufferQueue, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&lowPriorityQueue.ringBufferQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_data(&evictedData, sizeof(evictedData))
+        .CopyOutArgumentBuffer_dataSize(&evictedDataSize, sizeof(evictedDataSize));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle)).SetReturn(LOCK_OK).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&lowPriorityQueue.ringBufferQueue.counter, &lowPriorityQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&highPriorityQueue.ringBufferQueue, secondData, 7, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+
+    // test
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(&highPriorityQueue, firstData, 6));
+    ASSERT_ARE_EQUAL(int, 0, evictedCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(&highPriorityQueue, secondData, 7));
+    ASSERT_ARE_EQUAL(int, 1, evictedCount);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    SyncQueue_Deinit(&highPriorityQueue);
+    SyncQueue_Deinit(&lowPriorityQueue);
+    free(secondData);
+}
+
+TEST_FUNCTION(SyncQueue_MemoryBudget_BudgetExceeded_ExpectDropCountedWithoutPush)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    syncQueue.ringBufferQueue.shouldCountDrops = true;
+    SyncQueue_SetMemoryBudget(&syncQueue, 8 + QUEUE_ITEM_MEMORY_OVERHEAD);
+
+    void* data = "abcde";
+    void* poppedData = NULL;
+    uint32_t poppedDataSize = 5;
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&syncQueue.ringBufferQueue.counter, &syncQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFront(&syncQueue.ringBufferQueue, IGNORED_PTR_ARG, IGNORED_PTR_ARG, NULL)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_dataSize(&poppedDataSize, sizeof(poppedDataSize));
+    STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 5, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+
+    // test
+    result = SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    // the second item does not fit the budget of the queue, the backend is not even tried
+    result = SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, result);
+    ASSERT_ARE_EQUAL(int, 5 + QUEUE_ITEM_MEMORY_OVERHEAD, syncQueue.memoryBudgetConsumed);
+
+    // popping returns the item size to the budget
+    result = SyncQueue_PopFront(&syncQueue, &poppedData, &poppedDataSize);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, syncQueue.memoryBudgetConsumed);
+    result = SyncQueue_PushBack(&syncQueue, data, 5);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(SyncQueue_MemoryBudget_ManySmallItems_ExpectItemOverheadCharged)
+{
+    SyncQueue syncQueue;
+    STRICT_EXPECTED_CALL(RingBufferQueue_Init(&syncQueue.ringBufferQueue, true, 16)).SetReturn(QUEUE_OK);
+    int result = SyncQueue_InitRingBuffer(&syncQueue, true, 16);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    syncQueue.ringBufferQueue.shouldCountDrops = true;
+    // charged by their data only, far more than 4 items of a single byte would fit
+    SyncQueue_SetMemoryBudget(&syncQueue, 4 * (1 + QUEUE_ITEM_MEMORY_OVERHEAD));
+
+    void* data = "a";
+    QueueBatchItem poppedItems[4] = { { data, 1 }, { data, 1 }, { data, 1 }, { data, 1 } };
+    QueueBatchItem items[4];
+    uint32_t poppedItemsCount = 4;
+    uint32_t itemsCount = 0;
+    for (int i = 0; i < 4; i++) {
+        STRICT_EXPECTED_CALL(RingBufferQueue_PushBack(&syncQueue.ringBufferQueue, data, 1, QUEUE_NO_TAG)).SetReturn(QUEUE_OK);
+    }
+    STRICT_EXPECTED_CALL(AgentTelemetryCounter_IncreaseBy(&syncQueue.ringBufferQueue.counter, &syncQueue.ringBufferQueue.counter.counter.queueCounter.dropped, 1)).ValidateAllArguments();
+    STRICT_EXPECTED_CALL(RingBufferQueue_PopFrontBatch(&syncQueue.ringBufferQueue, 100, 0, 4, items, IGNORED_PTR_ARG)).SetReturn(QUEUE_OK)
+        .CopyOutArgumentBuffer_items(poppedItems, sizeof(poppedItems))
+        .CopyOutArgumentBuffer_itemsCount(&poppedItemsCount, sizeof(poppedItemsCount));
+
+    // test
+    for (int i = 0; i < 4; i++) {
+        ASSERT_ARE_EQUAL(int, QUEUE_OK, SyncQueue_PushBack(&syncQueue, data, 1));
+    }
+    // the bookkeeping of every item is charged the same way the memory monitor charges it
+    ASSERT_ARE_EQUAL(int, QUEUE_MAX_MEMORY_EXCEEDED, SyncQueue_PushBack(&syncQueue, data, 1));
+    ASSERT_ARE_EQUAL(int, 4 * (1 + QUEUE_ITEM_MEMORY_OVERHEAD), syncQueue.memoryBudgetConsumed);
+
+    // popping a batch returns the bookkeeping of all of its items
+    result = SyncQueue_PopFrontBatch(&syncQueue, 100, 0, 4, items, &itemsCount);
+    ASSERT_ARE_EQUAL(int, QUEUE_OK, result);
+    ASSERT_ARE_EQUAL(int, 4, itemsCount);
+    ASSERT_ARE_EQUAL(int, 0, syncQueue.memoryBudgetConsumed);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(sync_queue_ut)
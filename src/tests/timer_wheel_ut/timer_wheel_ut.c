@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+
+#include "umock_c.h"
+#include "umocktypes_charptr.h"
+
+#include "timer_wheel.h"
+#include <stdint.h>
+#include <string.h>
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    char temp_str[256];
+    (void)snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+typedef struct _TestTimer {
+    TimerWheel* wheel;
+    TimerWheelEntry entry;
+    uint32_t firedCount;
+    uint32_t rescheduleDelay;
+    uint32_t* firingOrder;
+    uint32_t* firingOrderCount;
+    uint32_t id;
+} TestTimer;
+
+static void onTestTimerExpired(void* context) {
+    TestTimer* timer = (TestTimer*)context;
+    timer->firedCount++;
+    if (timer->firingOrder != NULL) {
+        timer->firingOrder[(*timer->firingOrderCount)++] = timer->id;
+    }
+    if (timer->rescheduleDelay > 0) {
+        TimerWheel_Schedule(timer->wheel, &timer->entry, timer->rescheduleDelay);
+    }
+}
+
+static void initTestTimer(TestTimer* timer, TimerWheel* wheel, uint32_t id) {
+    memset(timer, 0, sizeof(*timer));
+    timer->wheel = wheel;
+    timer->id = id;
+    TimerWheel_InitEntry(&timer->entry, onTestTimerExpired, timer);
+}
+
+BEGIN_TEST_SUITE(timer_wheel_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_charptr_register_types();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION(TimerWheel_Advance_ExpectFiredOnlyOnceExpired)
+{
+    TimerWheel wheel;
+    TestTimer timer;
+    TimerWheel_Init(&wheel, 100, 1000);
+    initTestTimer(&timer, &wheel, 1);
+
+    TimerWheel_Schedule(&wheel, &timer.entry, 250);
+    ASSERT_IS_TRUE(timer.entry.isScheduled);
+    // the delay is rounded up to a whole tick
+    ASSERT_ARE_EQUAL(int, 300, TimerWheel_GetTimeToNextExpiration(&wheel, 1000));
+
+    TimerWheel_Advance(&wheel, 1299);
+    ASSERT_ARE_EQUAL(int, 0, timer.firedCount);
+    ASSERT_ARE_EQUAL(int, 1, TimerWheel_GetTimeToNextExpiration(&wheel, 1299));
+
+    TimerWheel_Advance(&wheel, 1300);
+    ASSERT_ARE_EQUAL(int, 1, timer.firedCount);
+    ASSERT_IS_FALSE(timer.entry.isScheduled);
+    ASSERT_ARE_EQUAL(int, UINT32_MAX, TimerWheel_GetTimeToNextExpiration(&wheel, 1300));
+
+    TimerWheel_Advance(&wheel, 5000);
+    ASSERT_ARE_EQUAL(int, 1, timer.firedCount);
+}
+
+TEST_FUNCTION(TimerWheel_Advance_DelayLongerThanWheel_ExpectFiredOnLaterRound)
+{
+    TimerWheel wheel;
+    TestTimer timer;
+    TimerWheel_Init(&wheel, 10, 0);
+    initTestTimer(&timer, &wheel, 1);
+
+    // the entry shares its slot with the ticks of the earlier rounds
+    uint32_t delay = 3 * TIMER_WHEEL_NUMBER_OF_SLOTS * 10 + 50;
+    TimerWheel_Schedule(&wheel, &timer.entry, delay);
+
+    for (uint64_t now = 10; now < delay; now += 10) {
+        TimerWheel_Advance(&wheel, now);
+    }
+    ASSERT_ARE_EQUAL(int, 0, timer.firedCount);
+
+    TimerWheel_Advance(&wheel, delay);
+    ASSERT_ARE_EQUAL(int, 1, timer.firedCount);
+}
+
+TEST_FUNCTION(TimerWheel_Advance_LongStall_ExpectAllExpiredFiredOnce)
+{
+    TimerWheel wheel;
+    TestTimer first;
+    TestTimer second;
+    TestTimer notExpired;
+    TimerWheel_Init(&wheel, 10, 0);
+    initTestTimer(&first, &wheel, 1);
+    initTestTimer(&second, &wheel, 2);
+    initTestTimer(&notExpired, &wheel, 3);
+
+    TimerWheel_Schedule(&wheel, &first.entry, 20);
+    TimerWheel_Schedule(&wheel, &second.entry, 5000);
+    TimerWheel_Schedule(&wheel, &notExpired.entry, 50000);
+
+    // far more than a whole round of the wheel passed
+    TimerWheel_Advance(&wheel, 10000);
+    ASSERT_ARE_EQUAL(int, 1, first.firedCount);
+    ASSERT_ARE_EQUAL(int, 1, second.firedCount);
+    ASSERT_ARE_EQUAL(int, 0, notExpired.firedCount);
+    ASSERT_ARE_EQUAL(int, 40000, TimerWheel_GetTimeToNextExpiration(&wheel, 10000));
+}
+
+TEST_FUNCTION(TimerWheel_Advance_SameTick_ExpectSchedulingOrder)
+{
+    TimerWheel wheel;
+    TestTimer timers[3];
+    uint32_t firingOrder[3] = { 0 };
+    uint32_t firingOrderCount = 0;
+    TimerWheel_Init(&wheel, 100, 0);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        initTestTimer(&timers[i], &wheel, i + 1);
+        timers[i].firingOrder = firingOrder;
+        timers[i].firingOrderCount = &firingOrderCount;
+        TimerWheel_Schedule(&wheel, &timers[i].entry, 100);
+    }
+
+    TimerWheel_Advance(&wheel, 100);
+    ASSERT_ARE_EQUAL(int, 3, firingOrderCount);
+    ASSERT_ARE_EQUAL(int, 1, firingOrder[0]);
+    ASSERT_ARE_EQUAL(int, 2, firingOrder[1]);
+    ASSERT_ARE_EQUAL(int, 3, firingOrder[2]);
+}
+
+TEST_FUNCTION(TimerWheel_Advance_CallbackReschedules_ExpectPeriodicFiring)
+{
+    TimerWheel wheel;
+    TestTimer timer;
+    TimerWheel_Init(&wheel, 100, 0);
+    initTestTimer(&timer, &wheel, 1);
+    timer.rescheduleDelay = 1000;
+
+    TimerWheel_Schedule(&wheel, &timer.entry, 1000);
+    for (uint64_t now = 100; now <= 5000; now += 100) {
+        TimerWheel_Advance(&wheel, now);
+    }
+
+    ASSERT_ARE_EQUAL(int, 5, timer.firedCount);
+    ASSERT_IS_TRUE(timer.entry.isScheduled);
+}
+
+TEST_FUNCTION(TimerWheel_Cancel_ExpectNotFired)
+{
+    TimerWheel wheel;
+    TestTimer canceled;
+    TestTimer kept;
+    TimerWheel_Init(&wheel, 100, 0);
+    initTestTimer(&canceled, &wheel, 1);
+    initTestTimer(&kept, &wheel, 2);
+
+    TimerWheel_Schedule(&wheel, &canceled.entry, 100);
+    TimerWheel_Schedule(&wheel, &kept.entry, 100);
+    TimerWheel_Cancel(&wheel, &canceled.entry);
+    ASSERT_IS_FALSE(canceled.entry.isScheduled);
+
+    // canceling twice is harmless
+    TimerWheel_Cancel(&wheel, &canceled.entry);
+
+    TimerWheel_Advance(&wheel, 100);
+    ASSERT_ARE_EQUAL(int, 0, canceled.firedCount);
+    ASSERT_ARE_EQUAL(int, 1, kept.firedCount);
+}
+
+TEST_FUNCTION(TimerWheel_Schedule_AlreadyScheduled_ExpectRescheduled)
+{
+    TimerWheel wheel;
+    TestTimer timer;
+    TimerWheel_Init(&wheel, 100, 0);
+    initTestTimer(&timer, &wheel, 1);
+
+    TimerWheel_Schedule(&wheel, &timer.entry, 100);
+    TimerWheel_Schedule(&wheel, &timer.entry, 500);
+
+    TimerWheel_Advance(&wheel, 400);
+    ASSERT_ARE_EQUAL(int, 0, timer.firedCount);
+
+    TimerWheel_Advance(&wheel, 500);
+    ASSERT_ARE_EQUAL(int, 1, timer.firedCount);
+}
+
+TEST_FUNCTION(TimerWheel_Schedule_ZeroDelay_ExpectFiredOnNextTick)
+{
+    TimerWheel wheel;
+    TestTimer timer;
+    TimerWheel_Init(&wheel, 100, 250);
+    initTestTimer(&timer, &wheel, 1);
+
+    TimerWheel_Schedule(&wheel, &timer.entry, 0);
+    TimerWheel_Advance(&wheel, 299);
+    ASSERT_ARE_EQUAL(int, 0, timer.firedCount);
+
+    TimerWheel_Advance(&wheel, 300);
+    ASSERT_ARE_EQUAL(int, 1, timer.firedCount);
+}
+
+END_TEST_SUITE(timer_wheel_ut)
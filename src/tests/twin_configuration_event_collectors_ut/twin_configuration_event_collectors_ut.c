@@ -36,8 +36,11 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 static char* HIGH_PRIORITY = "High";
 static char* LOW_PRIORITY = "Low";
 static char* OFF_PRIORITY = "Off";
+static char* AGGREGATION_KEY_FIELDS = "Executable, CommandLine";
+static char* AGGREGATION_KEY_NORMALIZERS = "stripNumericArguments, collapseTempPaths, maskPortsAbove:32767";
 
 static bool isMalformed;
+static char* aggregationKeyNormalizers;
 
 TwinConfigurationResult Mocked_TwinConfigurationUtils_GetConfigurationStringValueFromJson(JsonObjectReaderHandle handle, const char* key, char** output) {
     if (isMalformed) {
@@ -54,6 +57,14 @@ TwinConfigurationResult Mocked_TwinConfigurationUtils_GetConfigurationStringValu
         || strcmp(key, DIAGNOSTIC_PRIORITY_KEY) == 0 ) 
     {
         *output = LOW_PRIORITY;
+    } else if (strcmp(key, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY) == 0
+        || strcmp(key, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY) == 0 )
+    {
+        *output = AGGREGATION_KEY_FIELDS;
+    } else if (strcmp(key, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY) == 0
+        || strcmp(key, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY) == 0 )
+    {
+        *output = aggregationKeyNormalizers;
     } else {
         *output = OFF_PRIORITY;
     }
@@ -79,6 +90,15 @@ TwinConfigurationResult Mocked_TwinConfigurationUtils_GetConfigurationTimeValueF
     return JSON_READER_OK;
 }
 
+TwinConfigurationResult Mocked_TwinConfigurationUtils_GetConfigurationUintValueFromJson(JsonObjectReaderHandle handle, const char* key, uint32_t* output) {
+    if (strcmp(key, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY) == 0 
+        || strcmp(key, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY) == 0 )
+    {
+        *output = 100;
+    }
+    return JSON_READER_OK;
+}
+
 static void ValidateMockedPriorities() {
     TwinConfigurationResult result;
     TwinConfigurationEventPriority priority;
@@ -140,6 +160,30 @@ static void ValidateMockedPriorities() {
     result = TwinConfigurationEventCollectors_GetAggregationInterval(EVENT_TYPE_CONNECTION_CREATE, &interval);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_AN_HOUR, interval);
+
+    uint32_t maxEntries = 0;
+    result = TwinConfigurationEventCollectors_GetAggregationMaxEntries(EVENT_TYPE_PROCESS_CREATE, &maxEntries);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 100, maxEntries);
+
+    result = TwinConfigurationEventCollectors_GetAggregationMaxEntries(EVENT_TYPE_CONNECTION_CREATE, &maxEntries);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 100, maxEntries);
+
+    TwinConfigurationAggregationKey aggregationKey;
+    result = TwinConfigurationEventCollectors_GetAggregationKey(EVENT_TYPE_PROCESS_CREATE, &aggregationKey);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "Executable,CommandLine", aggregationKey.fields);
+    ASSERT_IS_TRUE(aggregationKey.stripNumericArguments);
+    ASSERT_IS_TRUE(aggregationKey.collapseTempPaths);
+    ASSERT_ARE_EQUAL(int, 32767, aggregationKey.maskPortsAbove);
+
+    result = TwinConfigurationEventCollectors_GetAggregationKey(EVENT_TYPE_CONNECTION_CREATE, &aggregationKey);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "Executable,CommandLine", aggregationKey.fields);
+    ASSERT_IS_TRUE(aggregationKey.stripNumericArguments);
+    ASSERT_IS_TRUE(aggregationKey.collapseTempPaths);
+    ASSERT_ARE_EQUAL(int, 32767, aggregationKey.maskPortsAbove);
 }
 
 static void ValidateDefaultPriorities() {
@@ -199,6 +243,30 @@ static void ValidateDefaultPriorities() {
     result = TwinConfigurationEventCollectors_GetAggregationInterval(EVENT_TYPE_CONNECTION_CREATE, &interval);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, MILLISECONDS_IN_AN_HOUR, interval);
+
+    uint32_t maxEntries = 0;
+    result = TwinConfigurationEventCollectors_GetAggregationMaxEntries(EVENT_TYPE_PROCESS_CREATE, &maxEntries);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 500, maxEntries);
+
+    result = TwinConfigurationEventCollectors_GetAggregationMaxEntries(EVENT_TYPE_CONNECTION_CREATE, &maxEntries);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, 500, maxEntries);
+
+    TwinConfigurationAggregationKey aggregationKey;
+    result = TwinConfigurationEventCollectors_GetAggregationKey(EVENT_TYPE_PROCESS_CREATE, &aggregationKey);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "", aggregationKey.fields);
+    ASSERT_IS_FALSE(aggregationKey.stripNumericArguments);
+    ASSERT_IS_FALSE(aggregationKey.collapseTempPaths);
+    ASSERT_ARE_EQUAL(int, 0, aggregationKey.maskPortsAbove);
+
+    result = TwinConfigurationEventCollectors_GetAggregationKey(EVENT_TYPE_CONNECTION_CREATE, &aggregationKey);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, "", aggregationKey.fields);
+    ASSERT_IS_FALSE(aggregationKey.stripNumericArguments);
+    ASSERT_IS_FALSE(aggregationKey.collapseTempPaths);
+    ASSERT_ARE_EQUAL(int, 0, aggregationKey.maskPortsAbove);
 }
 
 static LOCK_HANDLE testLockHadnle = (LOCK_HANDLE)0x1;
@@ -235,6 +303,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationStringValueFromJson, Mocked_TwinConfigurationUtils_GetConfigurationStringValueFromJson);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationBoolValueFromJson, Mocked_TwinConfigurationUtils_GetConfigurationBoolValueFromJson);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationTimeValueFromJson, Mocked_TwinConfigurationUtils_GetConfigurationTimeValueFromJson);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationUintValueFromJson, Mocked_TwinConfigurationUtils_GetConfigurationUintValueFromJson);
 
 
 }
@@ -244,6 +313,7 @@ TEST_SUITE_CLEANUP(suite_cleanup)
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationStringValueFromJson, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationBoolValueFromJson, NULL);
     REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationTimeValueFromJson, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(TwinConfigurationUtils_GetConfigurationUintValueFromJson, NULL);
     umock_c_deinit();
     TEST_MUTEX_DESTROY(test_serialize_mutex);
      
@@ -252,6 +322,7 @@ TEST_SUITE_CLEANUP(suite_cleanup)
 TEST_FUNCTION_INITIALIZE(method_init)
 {
     isMalformed = false;
+    aggregationKeyNormalizers = AGGREGATION_KEY_NORMALIZERS;
     umock_c_reset_all_calls();
 }
 
@@ -304,8 +375,14 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, OPERATIONAL_EVENT_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
@@ -335,8 +412,14 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_KeyMissing_ExpectSuccess)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, OPERATIONAL_EVENT_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_KEY_MISSING);
     
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
@@ -365,6 +448,25 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_ReaderError_ExpectFailure)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(TwinConfigurationEventCollectors_Update_InvalidAggregationNormalizers_ExpectFailure)
+{
+    STRICT_EXPECTED_CALL(Lock_Init());
+    TwinConfigurationResult result = TwinConfigurationEventCollectors_Init();
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    JsonObjectReaderHandle readerHandle = (JsonObjectReaderHandle)0x10;
+
+    aggregationKeyNormalizers = "maskPortsAbove:high";
+    result = TwinConfigurationEventCollectors_Update(readerHandle);
+    ASSERT_ARE_EQUAL(int, TWIN_PARSE_EXCEPTION, result);
+
+    aggregationKeyNormalizers = "stripNumericArguments, collapseAllPaths";
+    result = TwinConfigurationEventCollectors_Update(readerHandle);
+    ASSERT_ARE_EQUAL(int, TWIN_PARSE_EXCEPTION, result);
+
+    // configuration should stay intact
+    ValidateDefaultPriorities();
+}
+
 TEST_FUNCTION(TwinConfigurationEventCollectors_GetPrioritiesJsonExpectSuccess){
     STRICT_EXPECTED_CALL(Lock_Init());
     TwinConfigurationResult result = TwinConfigurationEventCollectors_Init();
@@ -388,9 +490,15 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_GetPrioritiesJsonExpectSuccess){
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(objectWriter, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, true));
     STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_AN_HOUR, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteUintConfigurationToJson(objectWriter, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, 100));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, "Executable,CommandLine"));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, "stripNumericArguments,collapseTempPaths,maskPortsAbove:32767"));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, true));
     STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(MILLISECONDS_IN_AN_HOUR, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteUintConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, 100));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, "Executable,CommandLine"));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(objectWriter, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, "stripNumericArguments,collapseTempPaths,maskPortsAbove:32767"));
 
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
     
@@ -458,8 +566,14 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_SetBackToDeafultValues_Exp
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, OPERATIONAL_EVENT_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
@@ -482,8 +596,14 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_SetBackToDeafultValues_Exp
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, OPERATIONAL_EVENT_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
     
@@ -515,8 +635,14 @@ TEST_FUNCTION(TwinConfigurationEventCollectors_Update_MalformedJson_ConfigStayIn
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, OPERATIONAL_EVENT_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, PROCESS_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_ENABLED_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_INTERVAL_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_MAX_ENTRIES_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_FIELDS_KEY, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(readerHandle, CONNECTION_CREATE_AGGREGATION_KEY_NORMALIZERS_KEY, IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(Unlock(testLockHadnle));
 
     result = TwinConfigurationEventCollectors_Update(readerHandle);
@@ -32,6 +32,8 @@ static int dummyTime = 10000;
 #include "twin_configuration.h"
 #include "consts.h"
 
+#include <stdlib.h>
+
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
  MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
@@ -99,6 +101,26 @@ static void ValidateDefaultTwinConfigurationParameters() {
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, DEFAULT_SNAPSHOT_FREQUENCY, num);
 
+    result = TwinConfiguration_GetEvictLowPriorityEvents(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_EVICT_LOW_PRIORITY_EVENTS, boolean);
+
+    result = TwinConfiguration_GetCollectorTimeBudget(&num);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_COLLECTOR_TIME_BUDGET, num);
+
+    result = TwinConfiguration_GetMaxPublishedBytesPerCycle(&num);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_MAX_PUBLISHED_BYTES_PER_CYCLE, num);
+
+    result = TwinConfiguration_GetCompressMessages(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_COMPRESS_MESSAGES, boolean);
+
+    result = TwinConfiguration_GetEncodeMessagesAsCbor(&boolean);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, DEFAULT_ENCODE_MESSAGES_AS_CBOR, boolean);
+
     result = TwinConfiguration_GetBaselineCustomChecksEnabled(&boolean);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, DEFAULT_BASELINE_CUSTOM_CHECKS_ENABLED, boolean);
@@ -110,6 +132,18 @@ static void ValidateDefaultTwinConfigurationParameters() {
     result = TwinConfiguration_GetBaselineCustomChecksFileHash(&str);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, DEFAULT_BASELINE_CUSTOM_CHECKS_FILE_HASH, str);
+
+    result = TwinConfiguration_GetAuditExcludedExecutables(&str);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_IS_NULL(str);
+
+    result = TwinConfiguration_GetAuditExcludedUids(&str);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_IS_NULL(str);
+
+    result = TwinConfiguration_GetAuditExcludedAuidRanges(&str);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_IS_NULL(str);
 }
 
 /**
@@ -125,9 +159,17 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     const uint32_t mockHighPriorityMessageFrequency = 15;
     const uint32_t mockLowPriorityMessageFrequency = 17;
     const uint32_t mockSnapshotFrequency = 19;
+    const bool mockEvictLowPriorityEvents = false;
+    const uint32_t mockCollectorTimeBudget = 21;
+    const uint32_t mockMaxPublishedBytesPerCycle = 23;
+    const bool mockCompressMessages = true;
+    const bool mockEncodeMessagesAsCbor = true;
     const bool mockBaselineCustomChecksEnabled = true;
     const char* mockBaselineCustomChecksFilePath = "/file/path";
     const char* mockBaselineCustomChecksFileHash = "#filehash!";
+    const char* mockAuditExcludedExecutables = "/usr/bin/noisy";
+    const char* mockAuditExcludedUids = "0";
+    const char* mockAuditExcludedAuidRanges = "1000-1999";
 
     TwinConfigurationResult result, expectedResult = TWIN_OK;
 
@@ -144,10 +186,18 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockHighPriorityMessageFrequency, sizeof(mockHighPriorityMessageFrequency));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, LOW_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockLowPriorityMessageFrequency, sizeof(mockLowPriorityMessageFrequency));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, SNAPSHOT_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockSnapshotFrequency, sizeof(mockSnapshotFrequency));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, EVICT_LOW_PRIORITY_EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockEvictLowPriorityEvents, sizeof(mockEvictLowPriorityEvents));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, COLLECTOR_TIME_BUDGET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockCollectorTimeBudget, sizeof(mockCollectorTimeBudget));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockMaxPublishedBytesPerCycle, sizeof(mockMaxPublishedBytesPerCycle));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COMPRESS_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockCompressMessages, sizeof(mockCompressMessages));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, ENCODE_MESSAGES_AS_CBOR_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockEncodeMessagesAsCbor, sizeof(mockEncodeMessagesAsCbor));
 
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksEnabled, sizeof(mockBaselineCustomChecksEnabled));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksFilePath, sizeof(mockBaselineCustomChecksFilePath));
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockBaselineCustomChecksFileHash, sizeof(mockBaselineCustomChecksFileHash));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_EXECUTABLES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockAuditExcludedExecutables, sizeof(mockAuditExcludedExecutables));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_UIDS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockAuditExcludedUids, sizeof(mockAuditExcludedUids));
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_AUID_RANGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_OK).CopyOutArgumentBuffer_value(&mockAuditExcludedAuidRanges, sizeof(mockAuditExcludedAuidRanges));
 
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_Update(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
@@ -194,6 +244,31 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(int, mockSnapshotFrequency, snapshotFrequency);
 
+    bool evictLowPriorityEvents;
+    result = TwinConfiguration_GetEvictLowPriorityEvents(&evictLowPriorityEvents);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockEvictLowPriorityEvents, evictLowPriorityEvents);
+
+    uint32_t collectorTimeBudget;
+    result = TwinConfiguration_GetCollectorTimeBudget(&collectorTimeBudget);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockCollectorTimeBudget, collectorTimeBudget);
+
+    uint32_t maxPublishedBytesPerCycle;
+    result = TwinConfiguration_GetMaxPublishedBytesPerCycle(&maxPublishedBytesPerCycle);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockMaxPublishedBytesPerCycle, maxPublishedBytesPerCycle);
+
+    bool compressMessages;
+    result = TwinConfiguration_GetCompressMessages(&compressMessages);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockCompressMessages, compressMessages);
+
+    bool encodeMessagesAsCbor;
+    result = TwinConfiguration_GetEncodeMessagesAsCbor(&encodeMessagesAsCbor);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(int, mockEncodeMessagesAsCbor, encodeMessagesAsCbor);
+
     bool baseLineCustomChecksEnabled;
     result = TwinConfiguration_GetBaselineCustomChecksEnabled(&baseLineCustomChecksEnabled);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
@@ -208,6 +283,24 @@ static void ValidateTwinConfigurationUpdate(bool isComplete, bool injectUnlockEr
     result = TwinConfiguration_GetBaselineCustomChecksFileHash(&baseLineCustomChecksFileHash);
     ASSERT_ARE_EQUAL(int, TWIN_OK, result);
     ASSERT_ARE_EQUAL(char_ptr, mockBaselineCustomChecksFileHash, baseLineCustomChecksFileHash);
+
+    char* auditExcludedExecutables;
+    result = TwinConfiguration_GetAuditExcludedExecutables(&auditExcludedExecutables);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, mockAuditExcludedExecutables, auditExcludedExecutables);
+    free(auditExcludedExecutables);
+
+    char* auditExcludedUids;
+    result = TwinConfiguration_GetAuditExcludedUids(&auditExcludedUids);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, mockAuditExcludedUids, auditExcludedUids);
+    free(auditExcludedUids);
+
+    char* auditExcludedAuidRanges;
+    result = TwinConfiguration_GetAuditExcludedAuidRanges(&auditExcludedAuidRanges);
+    ASSERT_ARE_EQUAL(int, TWIN_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, mockAuditExcludedAuidRanges, auditExcludedAuidRanges);
+    free(auditExcludedAuidRanges);
 }
 
 BEGIN_TEST_SUITE(twin_configuration_ut)
@@ -333,9 +426,17 @@ TEST_FUNCTION(TwinConfiguration_AllJsonKeysMissing_ExpectDefaultValuesFallback)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, LOW_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, SNAPSHOT_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, EVICT_LOW_PRIORITY_EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, COLLECTOR_TIME_BUDGET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COMPRESS_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, ENCODE_MESSAGES_AS_CBOR_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_EXECUTABLES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_UIDS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_AUID_RANGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG));
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_Update(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(0);
@@ -438,6 +539,18 @@ TEST_FUNCTION(TwinConfiguration_GetBaselineCustomChecksFileHashWithLockError_Exp
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+TEST_FUNCTION(TwinConfiguration_GetAuditExcludedUidsWithLockError_ExpectLockException)
+{
+    char* str = NULL;
+    int result;
+
+    STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
+    result = TwinConfiguration_GetAuditExcludedUids(&str);
+    ASSERT_ARE_EQUAL(int, TWIN_LOCK_EXCEPTION, result);
+    ASSERT_IS_NULL(str);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 TEST_FUNCTION(TwinConfiguration_UpdateWithLockError_ExpectLockException)
 {
     unsigned int num;
@@ -452,9 +565,17 @@ TEST_FUNCTION(TwinConfiguration_UpdateWithLockError_ExpectLockException)
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, LOW_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, SNAPSHOT_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, EVICT_LOW_PRIORITY_EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationTimeValueFromJson(mockedReader, COLLECTOR_TIME_BUDGET_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationUintValueFromJson(mockedReader, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, COMPRESS_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, ENCODE_MESSAGES_AS_CBOR_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationBoolValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_EXECUTABLES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_UIDS_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_GetConfigurationStringValueFromJson(mockedReader, AUDIT_EXCLUDED_AUID_RANGES_KEY, IGNORED_PTR_ARG)).SetReturn(TWIN_CONF_NOT_EXIST);
     STRICT_EXPECTED_CALL(Lock(IGNORED_PTR_ARG)).SetReturn(LOCK_ERROR).IgnoreAllArguments();
     STRICT_EXPECTED_CALL(TimeUtils_GetCurrentTime()).SetReturn(0);
     STRICT_EXPECTED_CALL(JsonObjectReader_Deinit(mockedReader));
@@ -482,9 +603,17 @@ TEST_FUNCTION(TwinConfiguration_GetLastTwinUpdateData_ExpectSuccess){
     ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.maxLocalCacheSize);
     ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.maxMessageSize);
     ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.snapshotFrequency);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.evictLowPriorityEvents);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.collectorTimeBudget);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.maxPublishedBytesPerCycle);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.compressMessages);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.encodeMessagesAsCbor);
     ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksEnabled);
     ASSERT_ARE_EQUAL(char_ptr, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksFilePath);
     ASSERT_ARE_EQUAL(char_ptr, CONFIGURATION_OK, result.configurationBundleStatus.baselineCustomChecksFileHash);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.auditExcludedExecutables);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.auditExcludedUids);
+    ASSERT_ARE_EQUAL(int, CONFIGURATION_OK, result.configurationBundleStatus.auditExcludedAuidRanges);
 }
 
 TEST_FUNCTION(TwinConfiguration_GetSerializedTwinConfiguration_ExpectSuccess) {
@@ -503,9 +632,18 @@ TEST_FUNCTION(TwinConfiguration_GetSerializedTwinConfiguration_ExpectSuccess) {
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, LOW_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, SNAPSHOT_FREQUENCY_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, EVICT_LOW_PRIORITY_EVENTS_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TimeUtils_MillisecondsToISO8601DurationString(IGNORED_NUM_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(true);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, COLLECTOR_TIME_BUDGET_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteUintConfigurationToJson(IGNORED_PTR_ARG, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, COMPRESS_MESSAGES_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, ENCODE_MESSAGES_AS_CBOR_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteBoolConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, AUDIT_EXCLUDED_EXECUTABLES_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, AUDIT_EXCLUDED_UIDS_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
+    STRICT_EXPECTED_CALL(TwinConfigurationUtils_WriteStringConfigurationToJson(IGNORED_PTR_ARG, AUDIT_EXCLUDED_AUID_RANGES_KEY, IGNORED_NUM_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(TwinConfigurationEventCollectors_GetPrioritiesJson(IGNORED_PTR_ARG)).SetReturn(TWIN_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_WriteObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, &out, &outSize));
@@ -576,6 +714,11 @@ TEST_FUNCTION(TwinConfiguration_Update_MalformedJson_ConfigStayIntact){
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, HIGH_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, LOW_PRIORITY_MESSAGE_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, SNAPSHOT_FREQUENCY_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, EVICT_LOW_PRIORITY_EVENTS_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, COLLECTOR_TIME_BUDGET_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadInt(readerHandle, MAX_PUBLISHED_BYTES_PER_CYCLE_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, COMPRESS_MESSAGES_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
+    STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, ENCODE_MESSAGES_AS_CBOR_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, BASELINE_CUSTOM_CHECKS_ENABLED_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, BASELINE_CUSTOM_CHECKS_FILE_PATH_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
     STRICT_EXPECTED_CALL(JsonObjectReader_ReadString(readerHandle, BASELINE_CUSTOM_CHECKS_FILE_HASH_KEY, IGNORED_PTR_ARG)).SetReturn(JSON_READER_PARSE_ERROR);
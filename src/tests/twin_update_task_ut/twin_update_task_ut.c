@@ -51,6 +51,12 @@ int Mocked_SyncQueue_PopFront(SyncQueue* syncQueue, void** data, uint32_t* dataS
     return mockedSyncQueuePopFrontReturnValue;
 }
 
+static uint32_t configurationChangedCount = 0;
+
+static void countingConfigurationListener(void* context) {
+    ++(*(uint32_t*)context);
+}
+
 BEGIN_TEST_SUITE(twin_update_task_ut)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -242,4 +248,40 @@ TEST_FUNCTION(UpdateTwinTask_InitUpdateTwinTaskItem_ExpectSuccess)
     ASSERT_IS_NULL(twinTaskItem);
 }
 
+TEST_FUNCTION(UpdateTwinTask_ExecuteWithConfigurationListener_ExpectListenerCalled)
+{
+    UpdateTwinTask task;
+    SyncQueue queue;
+    IoTHubAdapter client;
+
+    bool result = UpdateTwinTask_Init(&task, &queue, &client);
+    ASSERT_IS_TRUE(result);
+    configurationChangedCount = 0;
+    UpdateTwinTask_SetConfigurationListener(&task, countingConfigurationListener, &configurationChangedCount);
+
+    mockedSyncQueueGetSizeSize = 1;
+    mockedSyncQueueGetSizeReturnValue = QUEUE_OK;
+    mockedSyncQueuePopFrontReturnValue = QUEUE_OK;
+    mockedSyncQueuePopFrontTwinState = TWIN_COMPLETE;
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&queue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&queue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_Update(DUMMY_JSON, true));
+    STRICT_EXPECTED_CALL(TwinConfiguration_GetSerializedTwinConfiguration(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(IoTHubAdapter_SetReportedPropertiesAsync(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_NUM_ARG));
+
+    UpdateTwinTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(int, 1, configurationChangedCount);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // a failed update does not notify the listener
+    STRICT_EXPECTED_CALL(SyncQueue_GetSize(&queue, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(SyncQueue_PopFront(&queue, IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(TwinConfiguration_Update(DUMMY_JSON, true)).SetReturn(TWIN_EXCEPTION);
+
+    UpdateTwinTask_Execute(&task);
+
+    ASSERT_ARE_EQUAL(int, 1, configurationChangedCount);
+}
+
 END_TEST_SUITE(twin_update_task_ut)
@@ -13,13 +13,14 @@
 #include "collectors/generic_event.h"
 #include "os_utils/linux/audit/audit_search.h"
 #include "collectors/linux/generic_audit_event.h"
-#include "json/json_array_writer.h"
 #include "json/json_object_writer.h"
+#include "json/json_stream_writer.h"
 #include "synchronized_queue.h"
 #undef ENABLE_MOCKS
 
 #include "collectors/user_login_collector.h"
 #include "message_schema_consts.h"
+#include "twin_configuration_defs.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static TEST_MUTEX_HANDLE g_dllByDll;
@@ -51,10 +52,12 @@ AuditSearchResultValues Mocked_AuditSearch_ReadString(AuditSearch* auditSearch,
 void ValidateGetEvents(SyncQueue* mockedQueue, bool shouldValidateRemoteAddress, bool shouldValiadteOptional) {
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, "/var/tmp/userLoginCheckpoint")).SetReturn(AUDIT_SEARCH_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetReturn(JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetReturn(JSON_WRITER_OK);
 
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", USER_LOGIN_PROCESS_ID_KEY, false)).SetReturn(EVENT_COLLECTOR_OK);
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "id", USER_LOGIN_USER_ID_KEY, true)).SetReturn(EVENT_COLLECTOR_OK);
@@ -64,22 +67,23 @@ void ValidateGetEvents(SyncQueue* mockedQueue, bool shouldValidateRemoteAddress,
     if (shouldValiadteOptional) {
         STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "addr", IGNORED_PTR_ARG));
         if (shouldValidateRemoteAddress) {
-            STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, USER_LOGIN_REMOTE_ADDRESS_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+            STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, USER_LOGIN_REMOTE_ADDRESS_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
         }
     } else {
         STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "addr", IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_FIELD_DOES_NOT_EXIST);
     }
     
     STRICT_EXPECTED_CALL(AuditSearch_ReadString(IGNORED_PTR_ARG, "res", IGNORED_PTR_ARG));
-    STRICT_EXPECTED_CALL(JsonObjectWriter_WriteString(IGNORED_PTR_ARG, USER_LOGIN_RESULT_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_WriteString(IGNORED_PTR_ARG, USER_LOGIN_RESULT_KEY, IGNORED_NUM_ARG)).SetReturn(JSON_WRITER_OK);
  
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleStringValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "op", USER_LOGIN_OPERATION_KEY, true)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
     
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetReturn(EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetReturn(JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_USER_LOGIN)).SetReturn(QUEUE_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
     STRICT_EXPECTED_CALL(AuditSearch_SetCheckpoint(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_OK);
@@ -106,8 +110,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(JsonWriterResult, int);
     REGISTER_UMOCK_ALIAS_TYPE(QueueResultValues, int);
     REGISTER_UMOCK_ALIAS_TYPE(JsonObjectWriterHandle, void*);
-    REGISTER_UMOCK_ALIAS_TYPE(JsonArrayWriterHandle, void*);
     REGISTER_UMOCK_ALIAS_TYPE(AuditSearchCriteria, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherResultValues, int);
+    REGISTER_UMOCK_ALIAS_TYPE(AuditDispatcherEventHandler, void*);
 
     REGISTER_GLOBAL_MOCK_HOOK(AuditSearch_ReadString, Mocked_AuditSearch_ReadString);
 }
@@ -165,19 +170,22 @@ TEST_FUNCTION(UserLoginCollector_GetEvents_ExpectFailure)
     STRICT_EXPECTED_CALL(AuditSearch_InitMultipleSearchCriteria(IGNORED_PTR_ARG, AUDIT_SEARCH_CRITERIA_TYPE, loginTypes, 2, "/var/tmp/userLoginCheckpoint")).SetFailReturn(!AUDIT_SEARCH_OK);
     // This does not have a fail valie since it is importatn for the flow. Skip this on negative tests
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_HAS_MORE_DATA);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Init(IGNORED_PTR_ARG, GENERIC_EVENT_INITIAL_BUFFER_SIZE)).SetFailReturn(!JSON_WRITER_OK);
     STRICT_EXPECTED_CALL(AuditSearch_GetEventTime(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!AUDIT_SEARCH_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_WriteMetadataWithTimes(IGNORED_PTR_ARG, EVENT_TRIGGERED_CATEGORY, USER_LOGIN_NAME, EVENT_TYPE_SECURITY_VALUE, USER_LOGIN_PAYLOAD_SCHEMA_VERSION, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_BeginPayload(IGNORED_PTR_ARG, false)).SetFailReturn(!EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_BeginObject(IGNORED_PTR_ARG, NULL)).SetFailReturn(!JSON_WRITER_OK);
 
     // we can't have a fail return to all fields since the negative tests count on the fact that 0 is the value of success
     STRICT_EXPECTED_CALL(GenericAuditEvent_HandleIntValue(IGNORED_PTR_ARG, IGNORED_PTR_ARG, "pid", USER_LOGIN_PROCESS_ID_KEY, false)).SetFailReturn(EVENT_COLLECTOR_EXCEPTION);
 
-    STRICT_EXPECTED_CALL(JsonArrayWriter_Init(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(JsonArrayWriter_AddObject(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(GenericEvent_AddPayload(IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
-    STRICT_EXPECTED_CALL(JsonObjectWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
-    STRICT_EXPECTED_CALL(SyncQueue_PushBack(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG)).SetFailReturn(!QUEUE_OK);
+    STRICT_EXPECTED_CALL(GenericEvent_EndPayload(IGNORED_PTR_ARG)).SetFailReturn(!EVENT_COLLECTOR_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_EndObject(IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Serialize(IGNORED_PTR_ARG, IGNORED_PTR_ARG, IGNORED_PTR_ARG)).SetFailReturn(!JSON_WRITER_OK);
+    STRICT_EXPECTED_CALL(SyncQueue_PushBackTagged(&mockedQueue, IGNORED_PTR_ARG, IGNORED_NUM_ARG, EVENT_TYPE_USER_LOGIN)).SetFailReturn(!QUEUE_OK);
+    // This does not have a fail valie since it is importatn for the flow. Skip this on negative tests
+    STRICT_EXPECTED_CALL(JsonStreamWriter_Deinit(IGNORED_PTR_ARG));
 
     // This does not have a fail valie since it is importatn for the flow. Skip this on negative tests
     STRICT_EXPECTED_CALL(AuditSearch_GetNext(IGNORED_PTR_ARG)).SetReturn(AUDIT_SEARCH_NO_MORE_DATA);
@@ -191,7 +199,7 @@ TEST_FUNCTION(UserLoginCollector_GetEvents_ExpectFailure)
         umock_c_negative_tests_reset();
         umock_c_negative_tests_fail_call(i);
 
-        if (i == 1 || i == 13 || i == 15) {
+        if (i == 1 || i == 13 || i == 14 || i == 16) {
             // skip on the non-SetFailReturn calls
             continue;
         }
@@ -204,4 +212,20 @@ TEST_FUNCTION(UserLoginCollector_GetEvents_ExpectFailure)
 
 }
 
+static void MockedHandler(AuditSearch* auditSearch, void* context) { }
+
+TEST_FUNCTION(UserLoginCollector_AddAuditHandler_ExpectLoginTypesRegistered)
+{
+    AuditDispatcher dispatcher;
+    int context = 0;
+
+    STRICT_EXPECTED_CALL(AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, MockedHandler, &context)).SetReturn(AUDIT_DISPATCHER_OK);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_OK, UserLoginCollector_AddAuditHandler(&dispatcher, MockedHandler, &context));
+
+    STRICT_EXPECTED_CALL(AuditDispatcher_AddHandler(&dispatcher, AUDIT_SEARCH_CRITERIA_TYPE, IGNORED_PTR_ARG, 2, MockedHandler, &context)).SetReturn(AUDIT_DISPATCHER_EXCEPTION);
+    ASSERT_ARE_EQUAL(int, EVENT_COLLECTOR_EXCEPTION, UserLoginCollector_AddAuditHandler(&dispatcher, MockedHandler, &context));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(user_login_collector_ut)
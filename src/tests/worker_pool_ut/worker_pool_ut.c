@@ -0,0 +1,253 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "testrunnerswitcher.h"
+#include "macro_utils.h"
+#include "umock_c.h"
+#include "umocktypes_bool.h"
+#include "umocktypes_charptr.h"
+
+#define ENABLE_MOCKS
+#include "azure_c_shared_utility/condition.h"
+#include "azure_c_shared_utility/lock.h"
+#include "azure_c_shared_utility/threadapi.h"
+#undef ENABLE_MOCKS
+
+#include "worker_pool.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static TEST_MUTEX_HANDLE g_dllByDll;
+ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code) {
+    char temp_str[256];
+    snprintf(temp_str, sizeof(temp_str), "umock_c reported error :%s",  MU_ENUM_TO_STRING(UMOCK_C_ERROR_CODE, error_code));
+    ASSERT_FAIL(temp_str);
+}
+
+static LOCK_HANDLE mockLockHandle = (LOCK_HANDLE)0x1;
+static COND_HANDLE mockConditionHandle = (COND_HANDLE)0x2;
+
+static THREAD_START_FUNC workerMainFunc = NULL;
+static void* workerArg = NULL;
+
+THREADAPI_RESULT Mocked_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg) {
+    *threadHandle = (THREAD_HANDLE)0x3;
+    workerMainFunc = func;
+    workerArg = arg;
+    return THREADAPI_OK;
+}
+
+COND_RESULT Mocked_Condition_Wait(COND_HANDLE handle, LOCK_HANDLE lock, int timeout_milliseconds) {
+    // nothing else will be submitted, let the worker exit
+    ((WorkerPool*)workerArg)->continueRunning = false;
+    return COND_OK;
+}
+
+static uint32_t runOrder[WORKER_POOL_MAX_PENDING_WORK];
+static uint32_t runCount = 0;
+
+static void recordingWork(void* context) {
+    runOrder[runCount++] = (uint32_t)(uintptr_t)context;
+}
+
+static void InitPool(WorkerPool* pool, uint32_t workersCount) {
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    STRICT_EXPECTED_CALL(Condition_Init()).SetReturn(mockConditionHandle);
+    for (uint32_t i = 0; i < workersCount; i++) {
+        STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, pool));
+    }
+
+    ASSERT_IS_TRUE(WorkerPool_Init(pool, workersCount));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+}
+
+BEGIN_TEST_SUITE(worker_pool_ut)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    umock_c_init(on_umock_c_error);
+
+    umocktypes_bool_register_types();
+    umocktypes_charptr_register_types();
+
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(COND_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_START_FUNC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LOCK_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(COND_RESULT, int);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADAPI_RESULT, int);
+
+    REGISTER_GLOBAL_MOCK_RETURN(Lock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Unlock, LOCK_OK);
+    REGISTER_GLOBAL_MOCK_RETURN(Condition_Post, COND_OK);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, Mocked_ThreadAPI_Create);
+    REGISTER_GLOBAL_MOCK_HOOK(Condition_Wait, Mocked_Condition_Wait);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(Condition_Wait, NULL);
+
+    umock_c_deinit();
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    workerMainFunc = NULL;
+    workerArg = NULL;
+    runCount = 0;
+}
+
+TEST_FUNCTION(WorkerPool_Init_ExpectSuccess)
+{
+    WorkerPool pool;
+
+    InitPool(&pool, 2);
+
+    ASSERT_ARE_EQUAL(int, 2, pool.workersCount);
+    ASSERT_ARE_EQUAL(int, 0, pool.pendingWorkCount);
+    ASSERT_IS_TRUE(pool.continueRunning);
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_Init_InvalidWorkersCount_ExpectFailure)
+{
+    WorkerPool pool;
+
+    ASSERT_IS_FALSE(WorkerPool_Init(&pool, 0));
+    ASSERT_IS_FALSE(WorkerPool_Init(&pool, WORKER_POOL_MAX_WORKERS + 1));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(WorkerPool_Init_ThreadCreateFailed_ExpectStartedWorkersJoined)
+{
+    WorkerPool pool;
+
+    STRICT_EXPECTED_CALL(Lock_Init()).SetReturn(mockLockHandle);
+    STRICT_EXPECTED_CALL(Condition_Init()).SetReturn(mockConditionHandle);
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, &pool));
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_PTR_ARG, IGNORED_PTR_ARG, &pool)).SetReturn(THREADAPI_ERROR);
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle));
+    STRICT_EXPECTED_CALL(Condition_Post(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Condition_Deinit(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockLockHandle));
+
+    ASSERT_IS_FALSE(WorkerPool_Init(&pool, 2));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(WorkerPool_Deinit_ExpectWorkersWokenAndJoined)
+{
+    WorkerPool pool;
+    InitPool(&pool, 2);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle));
+    STRICT_EXPECTED_CALL(Condition_Post(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Condition_Post(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(IGNORED_PTR_ARG, IGNORED_PTR_ARG));
+    STRICT_EXPECTED_CALL(Condition_Deinit(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Lock_Deinit(mockLockHandle));
+
+    WorkerPool_Deinit(&pool);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+TEST_FUNCTION(WorkerPool_Submit_ExpectWorkerWoken)
+{
+    WorkerPool pool;
+    InitPool(&pool, 1);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle));
+    STRICT_EXPECTED_CALL(Condition_Post(mockConditionHandle));
+    STRICT_EXPECTED_CALL(Unlock(mockLockHandle));
+
+    ASSERT_IS_TRUE(WorkerPool_Submit(&pool, recordingWork, (void*)1));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 1, pool.pendingWorkCount);
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_Submit_PoolFull_ExpectFailure)
+{
+    WorkerPool pool;
+    InitPool(&pool, 1);
+
+    for (uint32_t i = 0; i < WORKER_POOL_MAX_PENDING_WORK; i++) {
+        ASSERT_IS_TRUE(WorkerPool_Submit(&pool, recordingWork, (void*)(uintptr_t)i));
+    }
+    ASSERT_IS_FALSE(WorkerPool_Submit(&pool, recordingWork, NULL));
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_MAX_PENDING_WORK, pool.pendingWorkCount);
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_Submit_LockFailed_ExpectFailure)
+{
+    WorkerPool pool;
+    InitPool(&pool, 1);
+
+    STRICT_EXPECTED_CALL(Lock(mockLockHandle)).SetReturn(LOCK_ERROR);
+
+    ASSERT_IS_FALSE(WorkerPool_Submit(&pool, recordingWork, NULL));
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, pool.pendingWorkCount);
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_Worker_ExpectPendingWorkRunInSubmissionOrder)
+{
+    WorkerPool pool;
+    InitPool(&pool, 1);
+    ASSERT_IS_NOT_NULL(workerMainFunc);
+
+    ASSERT_IS_TRUE(WorkerPool_Submit(&pool, recordingWork, (void*)1));
+    ASSERT_IS_TRUE(WorkerPool_Submit(&pool, recordingWork, (void*)2));
+    ASSERT_IS_TRUE(WorkerPool_Submit(&pool, recordingWork, (void*)3));
+
+    // runs the worker on this thread, it exits once it has to wait for work
+    ASSERT_ARE_EQUAL(int, 0, workerMainFunc(workerArg));
+
+    ASSERT_ARE_EQUAL(int, 3, runCount);
+    ASSERT_ARE_EQUAL(int, 1, runOrder[0]);
+    ASSERT_ARE_EQUAL(int, 2, runOrder[1]);
+    ASSERT_ARE_EQUAL(int, 3, runOrder[2]);
+    ASSERT_ARE_EQUAL(int, 0, pool.pendingWorkCount);
+
+    WorkerPool_Deinit(&pool);
+}
+
+TEST_FUNCTION(WorkerPool_Submit_AfterDeinitStarted_ExpectFailure)
+{
+    WorkerPool pool;
+    InitPool(&pool, 1);
+    pool.continueRunning = false;
+
+    ASSERT_IS_FALSE(WorkerPool_Submit(&pool, recordingWork, NULL));
+
+    WorkerPool_Deinit(&pool);
+}
+
+END_TEST_SUITE(worker_pool_ut)
@@ -0,0 +1,459 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+/**
+ * Decodes a security message as sent to the hub back into json, for verification.
+ * The message may be gzip compressed and may be encoded as json or as CBOR.
+ *
+ * Usage: message_decoder <message file>
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "json/json_stream_writer.h"
+
+#define DECODER_GZIP_WINDOW_BITS (15 + 16)
+#define DECODER_INITIAL_CAPACITY 4096
+#define DECODER_MAX_NUMBER_LENGTH 32
+
+#define CBOR_MAJOR_TYPE_UNSIGNED 0
+#define CBOR_MAJOR_TYPE_NEGATIVE 1
+#define CBOR_MAJOR_TYPE_BYTES 2
+#define CBOR_MAJOR_TYPE_TEXT 3
+#define CBOR_MAJOR_TYPE_ARRAY 4
+#define CBOR_MAJOR_TYPE_MAP 5
+#define CBOR_MAJOR_TYPE_TAG 6
+#define CBOR_MAJOR_TYPE_SIMPLE 7
+
+#define CBOR_INDEFINITE_LENGTH 31
+#define CBOR_BREAK 0xFF
+
+typedef struct _CborCursor {
+
+    const unsigned char* current;
+    const unsigned char* end;
+
+} CborCursor;
+
+/**
+ * @brief Reads the whole file.
+ *
+ * @param   path    The path of the file.
+ * @param   data    Out param. The content of the file, the caller is responsible for freeing it.
+ * @param   size    Out param. The size of the content.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool Decoder_ReadFile(const char* path, unsigned char** data, uint32_t* size);
+
+/**
+ * @brief Decompresses a gzip stream.
+ *
+ * @param   data            The compressed data.
+ * @param   size            The size of the compressed data.
+ * @param   output          Out param. The decompressed data, the caller is responsible for freeing it.
+ * @param   outputSize      Out param. The size of the decompressed data.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool Decoder_Inflate(const unsigned char* data, uint32_t size, unsigned char** output, uint32_t* outputSize);
+
+/**
+ * @brief Reads the head of the CBOR data item at the cursor.
+ *
+ * @param   cursor          The cursor, advanced past the head.
+ * @param   majorType       Out param. The major type of the data item.
+ * @param   additionalInfo  Out param. The additional information of the initial byte.
+ * @param   argument        Out param. The argument of the data item, 0 for an indefinite length.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool Decoder_ReadHead(CborCursor* cursor, uint8_t* majorType, uint8_t* additionalInfo, uint64_t* argument);
+
+/**
+ * @brief Reads a CBOR text string into a newly allocated null terminated string.
+ *
+ * @param   cursor  The cursor, advanced past the string.
+ * @param   text    Out param. The string, the caller is responsible for freeing it.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool Decoder_ReadText(CborCursor* cursor, char** text);
+
+/**
+ * @brief Checks for the break which ends a container of an indefinite length, consuming it.
+ *
+ * @param   cursor  The cursor.
+ *
+ * @return true if the container ends, false otherwise.
+ */
+static bool Decoder_IsBreak(CborCursor* cursor);
+
+/**
+ * @brief Converts the CBOR data item at the cursor to json.
+ *
+ * @param   cursor  The cursor, advanced past the data item.
+ * @param   writer  The json writer.
+ * @param   key     The key of the value, NULL for the root and for array elements.
+ *
+ * @return true on success, false otherwise.
+ */
+static bool Decoder_ConvertItem(CborCursor* cursor, JsonStreamWriter* writer, const char* key);
+
+/**
+ * @brief Converts a CBOR floating point number to a double.
+ *
+ * @param   additionalInfo  The additional information of the initial byte, which determines the precision.
+ * @param   bits            The bits of the number.
+ *
+ * @return the number.
+ */
+static double Decoder_ToDouble(uint8_t additionalInfo, uint64_t bits);
+
+static bool Decoder_ReadFile(const char* path, unsigned char** data, uint32_t* size) {
+    bool success = false;
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    uint32_t capacity = DECODER_INITIAL_CAPACITY;
+    *data = malloc(capacity);
+    *size = 0;
+    if (*data == NULL) {
+        goto cleanup;
+    }
+
+    while (true) {
+        if (*size == capacity) {
+            capacity *= 2;
+            unsigned char* newData = realloc(*data, capacity);
+            if (newData == NULL) {
+                goto cleanup;
+            }
+            *data = newData;
+        }
+
+        size_t readSize = fread(*data + *size, 1, capacity - *size, file);
+        if (readSize == 0) {
+            break;
+        }
+        *size += (uint32_t)readSize;
+    }
+
+    success = ferror(file) == 0;
+
+cleanup:
+    if (!success && *data != NULL) {
+        free(*data);
+        *data = NULL;
+    }
+    fclose(file);
+
+    return success;
+}
+
+static bool Decoder_Inflate(const unsigned char* data, uint32_t size, unsigned char** output, uint32_t* outputSize) {
+    bool success = false;
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, DECODER_GZIP_WINDOW_BITS) != Z_OK) {
+        return false;
+    }
+
+    uint32_t capacity = DECODER_INITIAL_CAPACITY;
+    *output = malloc(capacity);
+    if (*output == NULL) {
+        goto cleanup;
+    }
+
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = size;
+    while (true) {
+        stream.next_out = *output + stream.total_out;
+        stream.avail_out = capacity - (uint32_t)stream.total_out;
+
+        int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            break;
+        } else if (result != Z_OK && result != Z_BUF_ERROR) {
+            goto cleanup;
+        } else if (stream.avail_out > 0) {
+            // the stream is truncated
+            goto cleanup;
+        }
+
+        capacity *= 2;
+        unsigned char* newOutput = realloc(*output, capacity);
+        if (newOutput == NULL) {
+            goto cleanup;
+        }
+        *output = newOutput;
+    }
+
+    *outputSize = (uint32_t)stream.total_out;
+    success = true;
+
+cleanup:
+    if (!success && *output != NULL) {
+        free(*output);
+        *output = NULL;
+    }
+    inflateEnd(&stream);
+
+    return success;
+}
+
+static bool Decoder_ReadHead(CborCursor* cursor, uint8_t* majorType, uint8_t* additionalInfo, uint64_t* argument) {
+    if (cursor->current >= cursor->end) {
+        return false;
+    }
+
+    *majorType = *cursor->current >> 5;
+    *additionalInfo = *cursor->current & 0x1F;
+    ++cursor->current;
+
+    uint32_t argumentSize = 0;
+    if (*additionalInfo < 24) {
+        *argument = *additionalInfo;
+        return true;
+    } else if (*additionalInfo == CBOR_INDEFINITE_LENGTH) {
+        *argument = 0;
+        return true;
+    } else if (*additionalInfo > 27) {
+        return false;
+    }
+
+    argumentSize = 1u << (*additionalInfo - 24);
+    if ((uint32_t)(cursor->end - cursor->current) < argumentSize) {
+        return false;
+    }
+
+    *argument = 0;
+    for (uint32_t i = 0; i < argumentSize; ++i) {
+        *argument = (*argument << 8) | *cursor->current++;
+    }
+
+    return true;
+}
+
+static bool Decoder_ReadText(CborCursor* cursor, char** text) {
+    uint8_t majorType = 0;
+    uint8_t additionalInfo = 0;
+    uint64_t length = 0;
+
+    // the agent never writes chunked strings
+    if (!Decoder_ReadHead(cursor, &majorType, &additionalInfo, &length) || majorType != CBOR_MAJOR_TYPE_TEXT ||
+        additionalInfo == CBOR_INDEFINITE_LENGTH || length > (uint64_t)(cursor->end - cursor->current)) {
+        return false;
+    }
+
+    *text = malloc((size_t)length + 1);
+    if (*text == NULL) {
+        return false;
+    }
+    memcpy(*text, cursor->current, (size_t)length);
+    (*text)[length] = '\0';
+    cursor->current += length;
+
+    return true;
+}
+
+static bool Decoder_IsBreak(CborCursor* cursor) {
+    if (cursor->current < cursor->end && *cursor->current == CBOR_BREAK) {
+        ++cursor->current;
+        return true;
+    }
+
+    return false;
+}
+
+static bool Decoder_ConvertItem(CborCursor* cursor, JsonStreamWriter* writer, const char* key) {
+    const unsigned char* start = cursor->current;
+    uint8_t majorType = 0;
+    uint8_t additionalInfo = 0;
+    uint64_t argument = 0;
+    char number[DECODER_MAX_NUMBER_LENGTH];
+    int numberLength = 0;
+
+    if (!Decoder_ReadHead(cursor, &majorType, &additionalInfo, &argument)) {
+        return false;
+    }
+    bool isIndefinite = additionalInfo == CBOR_INDEFINITE_LENGTH;
+
+    switch (majorType) {
+        case CBOR_MAJOR_TYPE_UNSIGNED:
+            numberLength = snprintf(number, sizeof(number), "%llu", (unsigned long long)argument);
+            return JsonStreamWriter_WriteRaw(writer, key, number, (uint32_t)numberLength) == JSON_WRITER_OK;
+
+        case CBOR_MAJOR_TYPE_NEGATIVE:
+            // -1 - n, printed as the magnitude so that it does not overflow
+            if (argument == UINT64_MAX) {
+                return false;
+            }
+            numberLength = snprintf(number, sizeof(number), "-%llu", (unsigned long long)argument + 1);
+            return JsonStreamWriter_WriteRaw(writer, key, number, (uint32_t)numberLength) == JSON_WRITER_OK;
+
+        case CBOR_MAJOR_TYPE_TEXT: {
+            char* text = NULL;
+            cursor->current = start;
+            if (!Decoder_ReadText(cursor, &text)) {
+                return false;
+            }
+            bool success = JsonStreamWriter_WriteString(writer, key, text) == JSON_WRITER_OK;
+            free(text);
+            return success;
+        }
+
+        case CBOR_MAJOR_TYPE_ARRAY:
+            if (JsonStreamWriter_BeginArray(writer, key) != JSON_WRITER_OK) {
+                return false;
+            }
+            for (uint64_t i = 0; isIndefinite ? !Decoder_IsBreak(cursor) : i < argument; ++i) {
+                if (!Decoder_ConvertItem(cursor, writer, NULL)) {
+                    return false;
+                }
+            }
+            return JsonStreamWriter_EndArray(writer) == JSON_WRITER_OK;
+
+        case CBOR_MAJOR_TYPE_MAP:
+            if (JsonStreamWriter_BeginObject(writer, key) != JSON_WRITER_OK) {
+                return false;
+            }
+            for (uint64_t i = 0; isIndefinite ? !Decoder_IsBreak(cursor) : i < argument; ++i) {
+                char* itemKey = NULL;
+                if (!Decoder_ReadText(cursor, &itemKey)) {
+                    return false;
+                }
+                bool success = Decoder_ConvertItem(cursor, writer, itemKey);
+                free(itemKey);
+                if (!success) {
+                    return false;
+                }
+            }
+            return JsonStreamWriter_EndObject(writer) == JSON_WRITER_OK;
+
+        case CBOR_MAJOR_TYPE_TAG:
+            // tags carry no meaning in json, the tagged item is converted as is
+            return Decoder_ConvertItem(cursor, writer, key);
+
+        case CBOR_MAJOR_TYPE_SIMPLE:
+            if (additionalInfo == 20 || additionalInfo == 21) {
+                return JsonStreamWriter_WriteBool(writer, key, additionalInfo == 21) == JSON_WRITER_OK;
+            } else if (additionalInfo == 22 || additionalInfo == 23) {
+                // null and undefined
+                return JsonStreamWriter_WriteRaw(writer, key, "null", 4) == JSON_WRITER_OK;
+            } else if (additionalInfo >= 25 && additionalInfo <= 27) {
+                numberLength = snprintf(number, sizeof(number), "%.17g", Decoder_ToDouble(additionalInfo, argument));
+                return JsonStreamWriter_WriteRaw(writer, key, number, (uint32_t)numberLength) == JSON_WRITER_OK;
+            }
+            return false;
+
+        default:
+            // byte strings have no json representation and are never written by the agent
+            return false;
+    }
+}
+
+static double Decoder_ToDouble(uint8_t additionalInfo, uint64_t bits) {
+    if (additionalInfo == 27) {
+        double value = 0;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    } else if (additionalInfo == 26) {
+        float value = 0;
+        uint32_t singleBits = (uint32_t)bits;
+        memcpy(&value, &singleBits, sizeof(value));
+        return value;
+    }
+
+    // half precision
+    int exponent = (int)((bits >> 10) & 0x1F);
+    double mantissa = (double)(bits & 0x3FF);
+    double value = 0;
+    if (exponent == 0) {
+        value = ldexp(mantissa, -24);
+    } else if (exponent != 31) {
+        value = ldexp(mantissa + 1024, exponent - 25);
+    } else {
+        value = (mantissa == 0) ? INFINITY : NAN;
+    }
+
+    return (bits & 0x8000) ? -value : value;
+}
+
+int main(int argc, char* argv[]) {
+    int result = EXIT_FAILURE;
+    unsigned char* file = NULL;
+    uint32_t fileSize = 0;
+    unsigned char* decompressed = NULL;
+    uint32_t decompressedSize = 0;
+    JsonStreamWriter writer;
+    bool isWriterInitialized = false;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <message file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!Decoder_ReadFile(argv[1], &file, &fileSize) || fileSize == 0) {
+        fprintf(stderr, "Failed reading %s\n", argv[1]);
+        goto cleanup;
+    }
+
+    const unsigned char* message = file;
+    uint32_t messageSize = fileSize;
+    if (fileSize >= 2 && file[0] == 0x1F && file[1] == 0x8B) {
+        if (!Decoder_Inflate(file, fileSize, &decompressed, &decompressedSize)) {
+            fprintf(stderr, "Failed decompressing the message\n");
+            goto cleanup;
+        }
+        message = decompressed;
+        messageSize = decompressedSize;
+    }
+
+    if (messageSize > 0 && message[0] == '{') {
+        fwrite(message, 1, messageSize, stdout);
+        printf("\n");
+        result = EXIT_SUCCESS;
+        goto cleanup;
+    }
+
+    if (JsonStreamWriter_Init(&writer, messageSize + 1) != JSON_WRITER_OK) {
+        goto cleanup;
+    }
+    isWriterInitialized = true;
+
+    CborCursor cursor = { message, message + messageSize };
+    if (!Decoder_ConvertItem(&cursor, &writer, NULL) || cursor.current != cursor.end) {
+        fprintf(stderr, "Failed decoding the message, it is not a valid CBOR message\n");
+        goto cleanup;
+    }
+
+    const char* json = NULL;
+    uint32_t jsonSize = 0;
+    if (JsonStreamWriter_GetOutput(&writer, &json, &jsonSize) != JSON_WRITER_OK) {
+        goto cleanup;
+    }
+    printf("%s\n", json);
+    result = EXIT_SUCCESS;
+
+cleanup:
+    if (isWriterInitialized) {
+        JsonStreamWriter_Deinit(&writer);
+    }
+    if (decompressed != NULL) {
+        free(decompressed);
+    }
+    if (file != NULL) {
+        free(file);
+    }
+
+    return result;
+}